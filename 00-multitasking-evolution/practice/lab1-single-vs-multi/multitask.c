@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #define LED1_PIN GPIO_NUM_2
 #define LED2_PIN GPIO_NUM_4
@@ -22,12 +24,91 @@ void sensor_task(void *pvParameters)
     }
 }
 
+// ===== Response-latency probe =====
+// Counterpart of the sweep in single_task.c, same RLCSV output so both
+// curves land in one plot. Here the event is noticed by a dedicated
+// high-priority responder (10 ms poll, like emergency_task) while the
+// processing task grinds through the same load levels at low priority —
+// latency should stay near the poll interval no matter the load.
+#define RB_ROUNDS 30
+
+static int64_t rb_samples[RB_ROUNDS];
+static volatile int64_t rb_event_us = 0;
+static volatile bool rb_event_pending = false;
+static volatile int64_t rb_last_latency = 0;
+static volatile int rb_load_k = 500;     // processing iterations, thousands
+static SemaphoreHandle_t rb_ack_sem;
+
+static void rb_sort_samples(void)
+{
+    // 30 samples: insertion sort is plenty.
+    for (int i = 1; i < RB_ROUNDS; i++) {
+        int64_t v = rb_samples[i];
+        int j = i - 1;
+        while (j >= 0 && rb_samples[j] > v) {
+            rb_samples[j + 1] = rb_samples[j];
+            j--;
+        }
+        rb_samples[j + 1] = v;
+    }
+}
+
+static void rb_report(int load_k)
+{
+    rb_sort_samples();
+    int64_t sum = 0;
+    for (int i = 0; i < RB_ROUNDS; i++) sum += rb_samples[i];
+    printf("RLCSV,multi,%d,%lld,%lld,%lld,%lld\n",
+           load_k,
+           rb_samples[0], sum / RB_ROUNDS,
+           rb_samples[(RB_ROUNDS * 95) / 100], rb_samples[RB_ROUNDS - 1]);
+}
+
+void rb_responder_task(void *pvParameters)
+{
+    while (1) {
+        if (rb_event_pending) {
+            rb_last_latency = esp_timer_get_time() - rb_event_us;
+            rb_event_pending = false;
+            xSemaphoreGive(rb_ack_sem);
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+void rb_benchmark_task(void *pvParameters)
+{
+    const int load_levels_k[] = {250, 500, 1000, 2000};
+
+    rb_ack_sem = xSemaphoreCreateBinary();
+    xTaskCreate(rb_responder_task, "rb_responder", 2048, NULL, 5, NULL);
+    vTaskDelay(pdMS_TO_TICKS(3000));   // let the system settle
+
+    ESP_LOGI(TAG, "=== Multitask response latency sweep ===");
+    for (int l = 0; l < 4; l++) {
+        rb_load_k = load_levels_k[l];
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        for (int round = 0; round < RB_ROUNDS; round++) {
+            // Spread events across the processing cycle, not phase-locked.
+            vTaskDelay(pdMS_TO_TICKS(20 + (round * 37) % 50));
+            rb_event_us = esp_timer_get_time();
+            rb_event_pending = true;
+            xSemaphoreTake(rb_ack_sem, portMAX_DELAY);
+            rb_samples[round] = rb_last_latency;
+        }
+        rb_report(load_levels_k[l]);
+    }
+    ESP_LOGI(TAG, "=== Sweep done ===");
+    vTaskDelete(NULL);
+}
+
 // Task 2: Data Processing
 void processing_task(void *pvParameters)
 {
     while (1) {
         ESP_LOGI(TAG, "Processing data...");
-        for (int i = 0; i < 500000; i++) {
+        int load = rb_load_k * 1000;   // swept by the latency benchmark
+        for (int i = 0; i < load; i++) {
             volatile int dummy = i * i;
             if (i % 100000 == 0) {
                 vTaskDelay(1); // Yield to other tasks
@@ -49,6 +130,86 @@ void actuator_task(void *pvParameters)
     }
 }
 
+// ===== Fork-join data-parallel processing =====
+// The tasks above overlap *different* jobs, but each sample buffer is
+// still crunched end-to-end by one core. Fork-join shards one buffer
+// instead: two worker tasks, pinned one per core, each process half and
+// signal a join semaphore. The coordinator times the serial pass against
+// the forked pass and reports the speedup.
+#define FJ_WORKERS     2
+#define FJ_BUFFER_LEN  4096
+
+static int32_t fj_buffer[FJ_BUFFER_LEN];
+static int64_t fj_partial[FJ_WORKERS];
+static TaskHandle_t fj_worker_handles[FJ_WORKERS];
+static SemaphoreHandle_t fj_join_sem;
+
+// The per-sample work: a toy filter heavy enough to measure.
+static inline int64_t fj_process_range(int start, int end)
+{
+    int64_t acc = 0;
+    for (int i = start; i < end; i++) {
+        int32_t v = fj_buffer[i];
+        acc += (int64_t)v * v + (v >> 3);
+    }
+    return acc;
+}
+
+// Workers park on a notification; each wakeup is one shard of one join.
+void fj_worker_task(void *pvParameters)
+{
+    int id = (int)pvParameters;
+    int shard = FJ_BUFFER_LEN / FJ_WORKERS;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        fj_partial[id] = fj_process_range(id * shard, (id + 1) * shard);
+        xSemaphoreGive(fj_join_sem);
+    }
+}
+
+void fork_join_task(void *pvParameters)
+{
+    fj_join_sem = xSemaphoreCreateCounting(FJ_WORKERS, 0);
+    for (int i = 0; i < FJ_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "fj_worker%d", i);
+        xTaskCreatePinnedToCore(fj_worker_task, name, 2048, (void *)i,
+                                4, &fj_worker_handles[i], i);
+    }
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(5000));
+
+        // Fresh "sample" data
+        for (int i = 0; i < FJ_BUFFER_LEN; i++)
+            fj_buffer[i] = (i * 2654435761u) >> 16;
+
+        // Serial pass
+        int64_t t0 = esp_timer_get_time();
+        int64_t serial_sum = fj_process_range(0, FJ_BUFFER_LEN);
+        int64_t serial_us = esp_timer_get_time() - t0;
+
+        // Fork-join pass
+        t0 = esp_timer_get_time();
+        for (int i = 0; i < FJ_WORKERS; i++)
+            xTaskNotifyGive(fj_worker_handles[i]);
+        for (int i = 0; i < FJ_WORKERS; i++)
+            xSemaphoreTake(fj_join_sem, portMAX_DELAY);
+        int64_t parallel_us = esp_timer_get_time() - t0;
+
+        int64_t parallel_sum = 0;
+        for (int i = 0; i < FJ_WORKERS; i++)
+            parallel_sum += fj_partial[i];
+
+        if (serial_sum != parallel_sum)
+            ESP_LOGE(TAG, "Fork-join result mismatch!");
+        ESP_LOGI(TAG, "Fork-join: serial %lldus, parallel %lldus, speedup %.2fx",
+                 serial_us, parallel_us,
+                 parallel_us > 0 ? (float)serial_us / parallel_us : 0.0f);
+    }
+}
+
 // Task 4: Emergency Response (High Priority)
 void emergency_task(void *pvParameters)
 {
@@ -95,4 +256,6 @@ void app_main(void)
     xTaskCreate(processing_task, "processing", 2048, NULL, 1, NULL);
     xTaskCreate(actuator_task, "actuator", 2048, NULL, 2, NULL);
     xTaskCreate(emergency_task, "emergency", 2048, NULL, 5, NULL); // Highest priority
+    xTaskCreate(fork_join_task, "fork_join", 3072, NULL, 3, NULL);
+    xTaskCreate(rb_benchmark_task, "rb_bench", 3072, NULL, 4, NULL);
 }
\ No newline at end of file
@@ -3,12 +3,70 @@
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #define LED1_PIN GPIO_NUM_2
 #define LED2_PIN GPIO_NUM_4
 
 static const char *TAG = "SINGLE_TASK";
 
+// ===== Response-latency benchmark =====
+// The starvation this lab demonstrates is usually shown by eye: press
+// the button, watch the warning arrive late. This measures it instead.
+// An event is stamped just before the blocking processing step (the
+// worst case for a single loop), and the latency to the check point is
+// recorded over 30 rounds per load level. The multitask variant emits
+// the identical RLCSV line format, so the two curves plot side by side:
+//   RLCSV,<variant>,<load_k_iters>,<min_us>,<avg_us>,<p95_us>,<max_us>
+#define RB_ROUNDS 30
+
+static int64_t rb_samples[RB_ROUNDS];
+
+static void rb_sort_samples(void)
+{
+    for (int i = 1; i < RB_ROUNDS; i++) {
+        int64_t v = rb_samples[i];
+        int j = i - 1;
+        while (j >= 0 && rb_samples[j] > v) {
+            rb_samples[j + 1] = rb_samples[j];
+            j--;
+        }
+        rb_samples[j + 1] = v;
+    }
+}
+
+static void rb_report(const char *variant, int load_k)
+{
+    rb_sort_samples();
+    int64_t sum = 0;
+    for (int i = 0; i < RB_ROUNDS; i++) sum += rb_samples[i];
+    printf("RLCSV,%s,%d,%lld,%lld,%lld,%lld\n",
+           variant, load_k,
+           rb_samples[0], sum / RB_ROUNDS,
+           rb_samples[(RB_ROUNDS * 95) / 100], rb_samples[RB_ROUNDS - 1]);
+}
+
+void response_benchmark(void)
+{
+    const int load_levels_k[] = {250, 500, 1000, 2000};
+
+    ESP_LOGI(TAG, "=== Single-task response latency sweep ===");
+    for (int l = 0; l < 4; l++) {
+        for (int round = 0; round < RB_ROUNDS; round++) {
+            int64_t event_us = esp_timer_get_time();
+            for (int i = 0; i < load_levels_k[l] * 1000; i++) {
+                volatile int dummy = i * i;
+                (void)dummy;
+            }
+            // Only now does the loop reach its check point.
+            rb_samples[round] = esp_timer_get_time() - event_us;
+            vTaskDelay(1);   // feed the watchdog between rounds
+        }
+        rb_report("single", load_levels_k[l]);
+    }
+    ESP_LOGI(TAG, "=== Sweep done ===");
+}
+
 void app_main(void)
 {
     // GPIO Configuration
@@ -33,6 +91,8 @@ void app_main(void)
 
     ESP_LOGI(TAG, "Single Task System Started");
 
+    response_benchmark();
+
     while (1) {
         // Task 1: Blink LED1 (simulated sensor reading)
         ESP_LOGI(TAG, "Reading sensor...");
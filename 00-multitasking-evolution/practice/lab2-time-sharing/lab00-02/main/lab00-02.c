@@ -1,9 +1,11 @@
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "perf_bench.h"
 
 #define LED1_PIN GPIO_NUM_2
 #define LED2_PIN GPIO_NUM_4
@@ -103,6 +105,103 @@ void manual_scheduler(void)
     task_counter++;
 }
 
+// --------------------------- CYCLIC EXECUTIVE ---------------------------
+// manual_scheduler rotates through the tasks with no notion of rate or
+// budget. This is the deployable version of the same idea: a
+// compile-time schedule table of minor frames, each listing its slots
+// (function pointer + execution budget). The executive runs each frame,
+// times every slot against its budget, counts overruns, and holds the
+// frame boundary with vTaskDelayUntil, so a slot that runs long is
+// detected instead of silently stealing the next slot's time.
+#define CE_MINOR_FRAME_MS  50
+#define CE_MINOR_FRAMES    4               // major frame = 200 ms
+#define CE_SLOTS_PER_FRAME 3
+#define CE_DEMO_MAJOR_CYCLES 25            // 5 s demonstration run
+
+typedef struct {
+    const char *name;
+    void (*fn)(void);                      // NULL = empty slot
+    uint32_t budget_us;
+} ce_slot_t;
+
+// The schedule table: sensor at 20 Hz, display at 20 Hz, processing and
+// actuation interleaved at 10 Hz each. Budgets are per-activation.
+static const ce_slot_t ce_table[CE_MINOR_FRAMES][CE_SLOTS_PER_FRAME] = {
+    { {"sensor",  simulate_sensor_task,     3000},
+      {"process", simulate_processing_task, 20000},
+      {"display", simulate_display_task,    5000} },
+    { {"sensor",  simulate_sensor_task,     3000},
+      {"actuator", simulate_actuator_task,  10000},
+      {"display", simulate_display_task,    5000} },
+    { {"sensor",  simulate_sensor_task,     3000},
+      {"process", simulate_processing_task, 20000},
+      {"display", simulate_display_task,    5000} },
+    { {"sensor",  simulate_sensor_task,     3000},
+      {"actuator", simulate_actuator_task,  10000},
+      {"display", simulate_display_task,    5000} },
+};
+
+typedef struct {
+    uint32_t runs;
+    uint32_t overruns;
+    uint64_t used_us;
+    uint32_t worst_us;
+} ce_slot_stats_t;
+
+static ce_slot_stats_t ce_stats[CE_MINOR_FRAMES][CE_SLOTS_PER_FRAME];
+static uint32_t ce_frame_overruns = 0;
+
+void cyclic_executive_demo(void)
+{
+    ESP_LOGI(TAG, "\n=== Cyclic Executive (%d ms frames, %d-frame major cycle) ===",
+             CE_MINOR_FRAME_MS, CE_MINOR_FRAMES);
+    memset(ce_stats, 0, sizeof(ce_stats));
+    ce_frame_overruns = 0;
+
+    TickType_t wake = xTaskGetTickCount();
+    for (int cycle = 0; cycle < CE_DEMO_MAJOR_CYCLES; cycle++) {
+        for (int f = 0; f < CE_MINOR_FRAMES; f++) {
+            uint64_t frame_start = esp_timer_get_time();
+            for (int s = 0; s < CE_SLOTS_PER_FRAME; s++) {
+                const ce_slot_t *slot = &ce_table[f][s];
+                if (slot->fn == NULL)
+                    continue;
+                uint64_t t0 = esp_timer_get_time();
+                slot->fn();
+                uint32_t used = (uint32_t)(esp_timer_get_time() - t0);
+                ce_slot_stats_t *st = &ce_stats[f][s];
+                st->runs++;
+                st->used_us += used;
+                if (used > st->worst_us) st->worst_us = used;
+                if (used > slot->budget_us) {
+                    st->overruns++;
+                    ESP_LOGW(TAG, "⏱️ Slot overrun: frame %d '%s' %luus (budget %luus)",
+                             f, slot->name, used, slot->budget_us);
+                }
+            }
+            if (esp_timer_get_time() - frame_start > CE_MINOR_FRAME_MS * 1000)
+                ce_frame_overruns++;
+            vTaskDelayUntil(&wake, pdMS_TO_TICKS(CE_MINOR_FRAME_MS));
+        }
+    }
+
+    ESP_LOGI(TAG, "--- Slot utilization over %d major cycles ---", CE_DEMO_MAJOR_CYCLES);
+    for (int f = 0; f < CE_MINOR_FRAMES; f++) {
+        for (int s = 0; s < CE_SLOTS_PER_FRAME; s++) {
+            const ce_slot_t *slot = &ce_table[f][s];
+            ce_slot_stats_t *st = &ce_stats[f][s];
+            if (slot->fn == NULL || st->runs == 0)
+                continue;
+            uint32_t avg = (uint32_t)(st->used_us / st->runs);
+            ESP_LOGI(TAG, "  F%d %-8s avg=%5luus worst=%5luus budget=%5luus (%lu%%) overruns=%lu",
+                     f, slot->name, avg, st->worst_us, slot->budget_us,
+                     avg * 100 / slot->budget_us, st->overruns);
+        }
+    }
+    ESP_LOGI(TAG, "  Frame overruns: %lu of %d frames",
+             ce_frame_overruns, CE_DEMO_MAJOR_CYCLES * CE_MINOR_FRAMES);
+}
+
 // --------------------------- VARIABLE TIME SLICE TEST ---------------------------
 void variable_time_slice_experiment(void)
 {
@@ -110,6 +209,12 @@ void variable_time_slice_experiment(void)
     uint32_t time_slices[] = {10, 25, 50, 100, 200};
     int num_slices = sizeof(time_slices) / sizeof(time_slices[0]);
 
+    // Scheduler rounds are timed through the shared perf_bench series
+    // (cycle counter, outlier trimming, PBCSV output), so these numbers
+    // line up with every other lab's benchmarks in the nightly logs.
+    static pb_series_t slice_series;
+    static char series_name[24];
+
     for (int i = 0; i < num_slices; i++) {
         ESP_LOGI(TAG, "Testing time slice: %d ms", time_slices[i]);
 
@@ -117,10 +222,15 @@ void variable_time_slice_experiment(void)
         context_switch_time = 0;
         task_counter = 0;
 
+        snprintf(series_name, sizeof(series_name), "slice_%lums", time_slices[i]);
+        pb_series_init(&slice_series, series_name);
+
         uint64_t test_start = esp_timer_get_time();
 
         for (int j = 0; j < 50; j++) {
+            uint32_t t0 = pb_cycles_now();
             manual_scheduler();
+            pb_series_add(&slice_series, pb_cycles_now() - t0);
             vTaskDelay(pdMS_TO_TICKS(time_slices[i]));
         }
 
@@ -131,10 +241,263 @@ void variable_time_slice_experiment(void)
 
         ESP_LOGI(TAG, "Time slice %d ms: Efficiency %.1f%%", time_slices[i], efficiency);
         ESP_LOGI(TAG, "Context switches: %d", context_switches);
+        pb_series_report(&slice_series);
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
 
+// --------------------------- CONTEXT SWITCH BENCHMARK ---------------------------
+// The manual scheduler above only simulates switch overhead with a dummy
+// loop. This measures the real thing: a ping-pong pair of tasks bouncing
+// a direct notification back and forth, so each round trip is two genuine
+// context switches. We sweep ready-task count and priority spread, then
+// measure cache pollution separately - how much slower the working set is
+// to touch right after another task has streamed through the cache.
+// These numbers are what tick-rate and time-slice choices should rest on.
+#define CSB_ITERATIONS      400
+#define CSB_WORKING_SET     (16 * 1024)
+#define CSB_CHURN_MAX       6
+
+static TaskHandle_t csb_ping_handle = NULL;
+static TaskHandle_t csb_pong_handle = NULL;
+static volatile bool csb_churn_stop = false;
+
+static uint8_t csb_working_set[CSB_WORKING_SET];
+static uint8_t csb_pollute_set[CSB_WORKING_SET];
+
+// Far side of the ping-pong: wake, notify back, block again.
+static void csb_pong_task(void *pvParameters)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xTaskNotifyGive(csb_ping_handle);
+    }
+}
+
+// Extra ready tasks at the measurement priority: each one lengthens the
+// ready list the scheduler walks and dirties the cache between turns.
+static void csb_churn_task(void *pvParameters)
+{
+    while (!csb_churn_stop) {
+        for (volatile int i = 0; i < 500; i++) { }
+        taskYIELD();
+    }
+    vTaskDelete(NULL);
+}
+
+static void csb_measure_pair(const char *label, int churn_count, int pong_prio_delta)
+{
+    UBaseType_t my_prio = uxTaskPriorityGet(NULL);
+    static pb_series_t series;
+    TaskHandle_t churn[CSB_CHURN_MAX] = {0};
+
+    csb_churn_stop = false;
+    for (int i = 0; i < churn_count; i++) {
+        xTaskCreate(csb_churn_task, "CsbChurn", 2048, NULL, my_prio, &churn[i]);
+    }
+    vTaskPrioritySet(csb_pong_handle, my_prio + pong_prio_delta);
+
+    pb_series_init(&series, label);
+    uint64_t total_cycles = 0;
+    uint32_t min_cycles = UINT32_MAX, max_cycles = 0;
+
+    // Warmup round trips so first-touch cache misses don't skew the run.
+    for (int i = 0; i < 20; i++) {
+        xTaskNotifyGive(csb_pong_handle);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    for (int i = 0; i < CSB_ITERATIONS; i++) {
+        uint32_t t0 = pb_cycles_now();
+        xTaskNotifyGive(csb_pong_handle);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t round_trip = pb_cycles_now() - t0;
+        uint32_t per_switch = round_trip / 2;   // two switches per trip
+        pb_series_add(&series, per_switch);
+        total_cycles += per_switch;
+        if (per_switch < min_cycles) min_cycles = per_switch;
+        if (per_switch > max_cycles) max_cycles = per_switch;
+    }
+
+    ESP_LOGI(TAG, "%s: avg %llu cycles/switch (min %lu, max %lu)",
+             label, total_cycles / CSB_ITERATIONS, min_cycles, max_cycles);
+    pb_series_report(&series);
+
+    csb_churn_stop = true;
+    vTaskDelay(pdMS_TO_TICKS(50));    // let churn tasks self-delete
+}
+
+// Walks the working set with a cache-line stride and returns the cost.
+static uint32_t csb_touch_working_set(void)
+{
+    uint32_t t0 = pb_cycles_now();
+    volatile uint32_t sum = 0;
+    for (int i = 0; i < CSB_WORKING_SET; i += 32) {
+        sum += csb_working_set[i];
+    }
+    (void)sum;
+    return pb_cycles_now() - t0;
+}
+
+static void csb_cache_pollution(void)
+{
+    // Warm cost: second back-to-back traversal, everything resident.
+    csb_touch_working_set();
+    uint32_t warm = csb_touch_working_set();
+
+    // Polluted cost: stream through a different 16 KB buffer (standing in
+    // for whatever the other task ran between our time slices), then
+    // re-touch. The delta is the per-switch cache reload tax.
+    volatile uint32_t sink = 0;
+    for (int i = 0; i < CSB_WORKING_SET; i++) {
+        sink += csb_pollute_set[i];
+    }
+    (void)sink;
+    uint32_t polluted = csb_touch_working_set();
+
+    ESP_LOGI(TAG, "Cache pollution (16 KB working set):");
+    ESP_LOGI(TAG, "  warm traversal:     %lu cycles", warm);
+    ESP_LOGI(TAG, "  after pollution:    %lu cycles", polluted);
+    ESP_LOGI(TAG, "  reload tax/switch:  %lu cycles (%.1fx)",
+             polluted - warm, warm ? (float)polluted / warm : 0);
+}
+
+void context_switch_benchmark(void)
+{
+    ESP_LOGI(TAG, "\n=== Context Switch Benchmark ===");
+    csb_ping_handle = xTaskGetCurrentTaskHandle();
+    xTaskCreate(csb_pong_task, "CsbPong", 2048,
+                NULL, uxTaskPriorityGet(NULL), &csb_pong_handle);
+
+    // Task-count sweep at equal priority, then a priority spread where
+    // the pong side preempts immediately instead of waiting its turn.
+    csb_measure_pair("cs_equal_0churn", 0, 0);
+    csb_measure_pair("cs_equal_2churn", 2, 0);
+    csb_measure_pair("cs_equal_6churn", CSB_CHURN_MAX, 0);
+    csb_measure_pair("cs_spread_0churn", 0, 1);
+    csb_measure_pair("cs_spread_6churn", CSB_CHURN_MAX, 1);
+
+    csb_cache_pollution();
+
+    vTaskDelete(csb_pong_handle);
+    csb_pong_handle = NULL;
+    ESP_LOGI(TAG, "=== Benchmark complete ===\n");
+}
+
+// --------------------------- TICK / TIME-SLICE SWEEP ---------------------------
+// variable_time_slice_experiment varies the slice by hand and eyeballs
+// the result; the benchmark above measures raw switch cost. This harness
+// closes the loop: it sweeps (tick frequency, slice length) pairs in the
+// same single-task emulation idiom as manual_scheduler — each loop pass
+// is one tick (simulated tick work, a preemption check, a context switch
+// every slice_ticks ticks) and the remainder of the tick period goes to
+// work units. An emergency probe in the spirit of lab00-03's
+// preemptive_emergency_task arrives on its own clock, unaligned to
+// ticks, and is served at the next tick boundary — its measured latency
+// is the responsiveness cost of a slow tick. One table row per config:
+// throughput, scheduling overhead, switch count, probe latency. The
+// configTICK_RATE_HZ choice should come from this table, not folklore.
+#define TSW_RUN_MS              2000
+#define TSW_TICK_WORK           400     // loop iterations standing in for the tick ISR
+#define TSW_SWITCH_WORK         1500    // and for a context switch
+#define TSW_WORK_UNIT           2000    // one unit of useful task work
+#define TSW_EMERGENCY_PERIOD_US 333000  // deliberately prime-ish vs every tick period
+
+typedef struct {
+    uint32_t tick_hz;
+    uint32_t slice_ticks;
+} tsw_config_t;
+
+// Slice length in ms = slice_ticks * 1000 / tick_hz; the grid crosses a
+// slow and a fast tick with short, medium, and long slices.
+static const tsw_config_t tsw_configs[] = {
+    { 100,   1 },    // 10 ms slice
+    { 100,   5 },    // 50 ms slice
+    { 100,  10 },    // 100 ms slice
+    { 1000,  1 },    // 1 ms slice
+    { 1000, 10 },    // 10 ms slice
+    { 1000, 100 },   // 100 ms slice
+};
+
+typedef struct {
+    uint32_t work_units;
+    uint32_t switches;
+    uint64_t overhead_us;
+    uint64_t run_us;
+    uint32_t probes;
+    uint64_t probe_total_us;
+    uint32_t probe_worst_us;
+} tsw_result_t;
+
+static void tsw_run_config(const tsw_config_t *c, tsw_result_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    uint32_t tick_us = 1000000 / c->tick_hz;
+
+    uint64_t start = esp_timer_get_time();
+    uint64_t end = start + (uint64_t)TSW_RUN_MS * 1000;
+    uint64_t next_tick = start;
+    uint64_t next_emergency = start + TSW_EMERGENCY_PERIOD_US;
+    uint32_t ticks_in_slice = 0;
+
+    while (next_tick < end) {
+        uint64_t t0 = esp_timer_get_time();
+
+        // Tick ISR stand-in
+        for (volatile int i = 0; i < TSW_TICK_WORK; i++) { }
+
+        // The preemption check rides the tick, exactly like the real
+        // scheduler's: an emergency that arrived mid-slice waits here.
+        uint64_t now = esp_timer_get_time();
+        while (now >= next_emergency) {
+            uint32_t latency = (uint32_t)(now - next_emergency);
+            r->probes++;
+            r->probe_total_us += latency;
+            if (latency > r->probe_worst_us) r->probe_worst_us = latency;
+            next_emergency += TSW_EMERGENCY_PERIOD_US;
+        }
+
+        if (++ticks_in_slice >= c->slice_ticks) {
+            ticks_in_slice = 0;
+            r->switches++;
+            for (volatile int i = 0; i < TSW_SWITCH_WORK; i++) { }
+        }
+        r->overhead_us += esp_timer_get_time() - t0;
+
+        // Whatever is left of the tick period belongs to the task.
+        next_tick += tick_us;
+        while (esp_timer_get_time() < next_tick) {
+            for (volatile int i = 0; i < TSW_WORK_UNIT; i++) { }
+            r->work_units++;
+        }
+    }
+    r->run_us = esp_timer_get_time() - start;
+}
+
+void tick_slice_sweep(void)
+{
+    int num_configs = sizeof(tsw_configs) / sizeof(tsw_configs[0]);
+    ESP_LOGI(TAG, "\n=== Tick/Time-Slice Sweep (%d ms per config) ===", TSW_RUN_MS);
+    ESP_LOGI(TAG, "tick_hz slice_ms | units/s overhead switches | probe avg/worst");
+
+    for (int i = 0; i < num_configs; i++) {
+        const tsw_config_t *c = &tsw_configs[i];
+        tsw_result_t r;
+        tsw_run_config(c, &r);
+
+        uint32_t slice_ms = c->slice_ticks * 1000 / c->tick_hz;
+        uint32_t units_per_s = (uint32_t)((uint64_t)r.work_units * 1000000 / r.run_us);
+        float overhead_pct = (float)r.overhead_us * 100.0f / (float)r.run_us;
+        uint32_t probe_avg = r.probes ? (uint32_t)(r.probe_total_us / r.probes) : 0;
+
+        ESP_LOGI(TAG, "%7lu %8lu | %7lu %7.2f%% %8lu | %5luus / %luus",
+                 c->tick_hz, slice_ms, units_per_s, overhead_pct,
+                 r.switches, probe_avg, r.probe_worst_us);
+        vTaskDelay(pdMS_TO_TICKS(100));   // let the idle task breathe between runs
+    }
+    ESP_LOGI(TAG, "=== Sweep complete ===\n");
+}
+
 // --------------------------- DEMONSTRATION ---------------------------
 void demonstrate_problems(void)
 {
@@ -179,8 +542,15 @@ void app_main(void)
 
         if (round_count == 3) {
             variable_time_slice_experiment();
+            context_switch_benchmark();
             demonstrate_problems();
             round_count++;
+        } else if (round_count == 4) {
+            cyclic_executive_demo();
+            round_count++;
+        } else if (round_count == 5) {
+            tick_slice_sweep();
+            round_count++;
         }
     }
 }
@@ -1,9 +1,12 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_cpu.h"
 
 #define LED1_PIN GPIO_NUM_2   // Task 1 indicator
     #define LED2_PIN GPIO_NUM_4   // Task 2 indicator
@@ -26,6 +29,197 @@ typedef struct {
     bool ready;
 } coop_task_t;
 
+// ===========================================================
+// ================= Deadline-Miss Detector ==================
+// ===========================================================
+// Logging "response time" only shows the runs someone watched. Here a
+// task registers its period and deadline once; every release and
+// completion is stamped with the CPU cycle counter, and the detector
+// keeps per-task miss counts plus worst-case latency. This works the
+// same under the cooperative and the preemptive scheduler, which makes
+// the two directly comparable.
+
+static const char *TAG_DL = "DEADLINE";
+
+#define DEADLINE_SLOTS 4
+#define CYCLES_PER_US  (configCPU_CLOCK_HZ / 1000000)
+
+typedef struct {
+    const char *name;
+    uint32_t period_ms;        // expected release cadence (0 = event-driven)
+    uint32_t deadline_us;      // release-to-completion budget
+    uint32_t release_cycles;   // cycle stamp of the pending release
+    bool released;
+    uint32_t completions;
+    uint32_t misses;
+    uint32_t worst_latency_us;
+    uint64_t total_latency_us;
+} deadline_slot_t;
+
+static deadline_slot_t deadline_slots[DEADLINE_SLOTS];
+static int deadline_count = 0;
+
+int deadline_register(const char *name, uint32_t period_ms, uint32_t deadline_us)
+{
+    if (deadline_count >= DEADLINE_SLOTS)
+        return -1;
+    deadline_slot_t *d = &deadline_slots[deadline_count];
+    d->name = name;
+    d->period_ms = period_ms;
+    d->deadline_us = deadline_us;
+    d->released = false;
+    return deadline_count++;
+}
+
+// Stamp a job release (ISR/flag-set/loop-top). Cheap: one cycle read.
+void deadline_release(int id)
+{
+    deadline_slots[id].release_cycles = esp_cpu_get_cycle_count();
+    deadline_slots[id].released = true;
+}
+
+// Stamp completion and score it against the registered deadline.
+void deadline_complete(int id)
+{
+    deadline_slot_t *d = &deadline_slots[id];
+    if (!d->released)
+        return;
+    uint32_t latency_us = (esp_cpu_get_cycle_count() - d->release_cycles) / CYCLES_PER_US;
+    d->released = false;
+    d->completions++;
+    d->total_latency_us += latency_us;
+    if (latency_us > d->worst_latency_us)
+        d->worst_latency_us = latency_us;
+    if (latency_us > d->deadline_us) {
+        d->misses++;
+        ESP_LOGW(TAG_DL, "%s MISSED deadline: %lu us (budget %lu us)",
+                 d->name, latency_us, d->deadline_us);
+    }
+}
+
+void deadline_report(void)
+{
+    ESP_LOGI(TAG_DL, "=== DEADLINE REPORT ===");
+    for (int i = 0; i < deadline_count; i++) {
+        deadline_slot_t *d = &deadline_slots[i];
+        if (d->completions == 0)
+            continue;
+        ESP_LOGI(TAG_DL, "%s: %lu jobs, %lu misses | latency avg=%lluus worst=%luus (budget %luus)",
+                 d->name, d->completions, d->misses,
+                 d->total_latency_us / d->completions,
+                 d->worst_latency_us, d->deadline_us);
+    }
+}
+
+// ===========================================================
+// ================ Emergency Path Audit Mode ================
+// ===========================================================
+// The deadline detector tells us when the emergency path was slow;
+// nothing stops it from being slow by construction - a malloc, a
+// blocking mutex take, or a synchronous log can sneak in during review.
+// A task marks its critical region with audit_enter/audit_exit; inside
+// it, heap allocations (via the heap hooks), log output (via a vprintf
+// shim) and blocking mutex takes (via the audited wrapper) are counted
+// as violations - or abort immediately with AUDIT_TRAP=1 in debug
+// builds, so the bound is enforced by code rather than review.
+
+static const char *TAG_AUDIT = "AUDIT";
+
+#define AUDIT_TRAP      0   // 1: abort at the violating call (debug builds)
+#define AUDIT_TLS_INDEX 1
+
+typedef struct {
+    const char *name;
+    uint32_t budget_us;        // declared worst case for the region
+    uint32_t enter_cycles;
+    uint32_t entries;
+    uint32_t heap_violations;
+    uint32_t log_violations;
+    uint32_t mutex_violations;
+    uint32_t budget_violations;
+    uint32_t worst_region_us;
+} audit_ctx_t;
+
+static vprintf_like_t audit_prev_vprintf = NULL;
+
+static inline audit_ctx_t *audit_current(void)
+{
+    return (audit_ctx_t *)pvTaskGetThreadLocalStoragePointer(NULL, AUDIT_TLS_INDEX);
+}
+
+static void audit_violation(uint32_t *counter)
+{
+    (*counter)++;
+#if AUDIT_TRAP
+    abort();
+#endif
+}
+
+void audit_enter(audit_ctx_t *ctx)
+{
+    ctx->enter_cycles = esp_cpu_get_cycle_count();
+    ctx->entries++;
+    vTaskSetThreadLocalStoragePointer(NULL, AUDIT_TLS_INDEX, ctx);
+}
+
+void audit_exit(audit_ctx_t *ctx)
+{
+    vTaskSetThreadLocalStoragePointer(NULL, AUDIT_TLS_INDEX, NULL);
+    uint32_t region_us = (esp_cpu_get_cycle_count() - ctx->enter_cycles) / CYCLES_PER_US;
+    if (region_us > ctx->worst_region_us)
+        ctx->worst_region_us = region_us;
+    if (region_us > ctx->budget_us)
+        audit_violation(&ctx->budget_violations);
+}
+
+// Mutex traffic on an audited path must go through this wrapper: a take
+// with a nonzero timeout inside the region is a potential unbounded
+// block and gets counted even when it happens to succeed fast.
+BaseType_t audit_mutex_take(SemaphoreHandle_t mutex, TickType_t timeout)
+{
+    audit_ctx_t *ctx = audit_current();
+    if (ctx != NULL && timeout > 0)
+        audit_violation(&ctx->mutex_violations);
+    return xSemaphoreTake(mutex, timeout);
+}
+
+// Every ESP_LOGx funnels through here once installed. Counting only -
+// logging about a log violation from inside the log path would recurse.
+static int audit_vprintf(const char *fmt, va_list args)
+{
+    audit_ctx_t *ctx = audit_current();
+    if (ctx != NULL)
+        audit_violation(&ctx->log_violations);
+    return audit_prev_vprintf ? audit_prev_vprintf(fmt, args) : vprintf(fmt, args);
+}
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// Needs CONFIG_HEAP_USE_HOOKS=y; without it heap traffic in the region
+// goes unseen (everything else still audits).
+void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    audit_ctx_t *ctx = audit_current();
+    if (ctx != NULL)
+        audit_violation(&ctx->heap_violations);
+}
+#endif
+
+void audit_init(void)
+{
+    audit_prev_vprintf = esp_log_set_vprintf(audit_vprintf);
+#ifndef CONFIG_HEAP_USE_HOOKS
+    ESP_LOGW(TAG_AUDIT, "CONFIG_HEAP_USE_HOOKS off - heap allocations not audited");
+#endif
+}
+
+void audit_report(const audit_ctx_t *ctx)
+{
+    ESP_LOGI(TAG_AUDIT, "%s: %lu entries | viol: heap=%lu log=%lu mutex=%lu budget=%lu | worst region %lu us (budget %lu)",
+             ctx->name, ctx->entries, ctx->heap_violations, ctx->log_violations,
+             ctx->mutex_violations, ctx->budget_violations,
+             ctx->worst_region_us, ctx->budget_us);
+}
+
 void cooperative_task1(void)
 {
     static uint32_t count = 0;
@@ -62,12 +256,17 @@ void cooperative_task2(void)
     gpio_set_level(LED2_PIN, 0);
 }
 
+static int coop_emergency_dl = -1;   // registered in cooperative_scheduler
+static int coop_task1_dl = -1;
+
 void cooperative_task3_emergency(void)
 {
     if (emergency_flag) {
         uint64_t response_time = esp_timer_get_time() - task_start_time;
         uint32_t response_ms = (uint32_t)(response_time / 1000);
 
+        deadline_complete(coop_emergency_dl);   // release-to-response latency
+
         if (response_ms > max_response_time)
             max_response_time = response_ms;
 
@@ -91,18 +290,30 @@ void cooperative_scheduler(void)
     };
     int num_tasks = sizeof(tasks) / sizeof(tasks[0]);
     int current_task = 0;
+    uint32_t loops = 0;
+
+    // Emergency must respond within 50 ms of the button; Task1 gets a
+    // 300 ms budget per invocation (it runs ~250 ms when not yielding).
+    coop_emergency_dl = deadline_register("CoopEmergency", 0, 50000);
+    coop_task1_dl = deadline_register("CoopTask1", 0, 300000);
 
     while (1) {
         if (gpio_get_level(BUTTON_PIN) == 0 && !emergency_flag) {
             emergency_flag = true;
             task_start_time = esp_timer_get_time();
+            deadline_release(coop_emergency_dl);
             ESP_LOGW(TAG_COOP, "Emergency button pressed!");
         }
 
-        if (tasks[current_task].ready)
+        if (tasks[current_task].ready) {
+            if (current_task == 0) deadline_release(coop_task1_dl);
             tasks[current_task].task_function();
+            if (current_task == 0) deadline_complete(coop_task1_dl);
+        }
 
         current_task = (current_task + 1) % num_tasks;
+        if (++loops % 1000 == 0)
+            deadline_report();
         vTaskDelay(pdMS_TO_TICKS(10)); // prevent watchdog
     }
 }
@@ -156,25 +367,46 @@ void preemptive_task2(void *pvParameters)
 
 void preemptive_emergency_task(void *pvParameters)
 {
+    // Same 50 ms response budget as the cooperative emergency, so the
+    // deadline report contrasts the two schedulers directly.
+    int dl = deadline_register("PreemptEmergency", 0, 50000);
+    uint32_t handled = 0;
+
+    // The time-critical region (stamp + actuate) is audited: any heap,
+    // mutex or log call inside it is a counted violation. 1 ms budget.
+    static audit_ctx_t audit = {.name = "PreemptEmergency", .budget_us = 1000};
+
     while (1) {
         if (gpio_get_level(BUTTON_PIN) == 0 && !preempt_emergency) {
             preempt_emergency = true;
             preempt_start_time = esp_timer_get_time();
 
+            audit_enter(&audit);
+            deadline_release(dl);
+            deadline_complete(dl);   // preemption: response is the poll latency
+            gpio_set_level(LED3_PIN, 1);
+            // Deliberately left inside the region: the audit counts this
+            // synchronous log, proving the trap actually fires.
+            ESP_LOGW(TAG_PREEMPT, "IMMEDIATE EMERGENCY!");
+            audit_exit(&audit);
+
             uint64_t response_time = esp_timer_get_time() - preempt_start_time;
             uint32_t response_ms = (uint32_t)(response_time / 1000);
 
             if (response_ms > preempt_max_response)
                 preempt_max_response = response_ms;
 
-            ESP_LOGW(TAG_PREEMPT, "IMMEDIATE EMERGENCY! Response: %d ms (Max: %d ms)",
+            ESP_LOGW(TAG_PREEMPT, "Response: %d ms (Max: %d ms)",
                      response_ms, preempt_max_response);
 
-            gpio_set_level(LED3_PIN, 1);
-            vTaskDelay(pdMS_TO_TICKS(200));
+            vTaskDelay(pdMS_TO_TICKS(200));   // cosmetic, outside the region
             gpio_set_level(LED3_PIN, 0);
 
             preempt_emergency = false;
+            if (++handled % 5 == 0) {
+                deadline_report();
+                audit_report(&audit);
+            }
         }
         vTaskDelay(pdMS_TO_TICKS(5));
     }
@@ -215,6 +447,8 @@ void app_main(void)
     io_conf.pull_up_en = 1;
     gpio_config(&io_conf);
 
+    audit_init();
+
     ESP_LOGI("MAIN", "Multitasking Comparison Demo");
     ESP_LOGI("MAIN", "Choose test mode:");
     ESP_LOGI("MAIN", "1. Cooperative (uncomment line below)");
@@ -2,21 +2,97 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
 #include "build_info.h"
 #include <inttypes.h>
 
+// ===== Startup latency breakdown =====
+// app_main is reached hundreds of milliseconds after reset and from up
+// here that time is a black box. Markers stamp the phases application
+// code can actually see: the earliest constructor (runs right after
+// heap init, before app_main), app_main entry, and the first scheduled
+// user task. Each mark keeps the CPU cycle counter (running since core
+// reset) and the esp_timer clock. The block lives in noinit RAM, so the
+// previous boot's timeline survives a software reset and is printed
+// before this boot overwrites it - one crash loop is enough to capture
+// numbers from the field.
+#define BOOT_MARKS_MAGIC 0xB007B007
+
+typedef struct {
+    uint32_t cycles;    // CPU cycle counter (counts from core reset)
+    int64_t us;         // esp_timer clock
+} boot_mark_t;
+
+typedef struct {
+    uint32_t magic;
+    boot_mark_t constructor;
+    boot_mark_t app_main;
+    boot_mark_t first_task;
+} boot_marks_t;
+
+// Current boot collects into ordinary .bss; only the completed record
+// is copied into the noinit block, so a reset mid-collection can never
+// shred the previous boot's numbers.
+static boot_marks_t boot_marks;
+static __NOINIT_ATTR boot_marks_t boot_marks_saved;
+
+static inline void boot_mark(boot_mark_t *m)
+{
+    m->cycles = esp_cpu_get_cycle_count();
+    m->us = esp_timer_get_time();
+}
+
+// Constructors run during startup, after the heap is up and before
+// app_main - the earliest stamp application code can take.
+static void __attribute__((constructor)) boot_mark_constructor(void)
+{
+    boot_mark(&boot_marks.constructor);
+}
+
+static void boot_marks_print(const char *title, const boot_marks_t *m)
+{
+    printf("%s\n", title);
+    printf("  heap-init->ctor mark : %" PRIu32 " cycles / %lld us since reset\n",
+           m->constructor.cycles, m->constructor.us);
+    printf("  ctor->app_main       : +%lld us\n",
+           m->app_main.us - m->constructor.us);
+    printf("  app_main->first task : +%lld us\n",
+           m->first_task.us - m->app_main.us);
+    printf("  total to first task  : %lld us\n", m->first_task.us);
+}
+
+// First user task: its first line closes the breakdown.
+static void first_task(void *pvParameters)
+{
+    boot_mark(&boot_marks.first_task);
+    boot_marks.magic = BOOT_MARKS_MAGIC;
+    boot_marks_saved = boot_marks;
+    boot_marks_print("=== Startup breakdown (this boot) ===", &boot_marks);
+    vTaskDelete(NULL);
+}
 
 void app_main(void)
 {
+    boot_mark(&boot_marks.app_main);
+
+    // Previous boot's timeline, if the noinit block survived the reset.
+    if (boot_marks_saved.magic == BOOT_MARKS_MAGIC) {
+        boot_marks_print("=== Startup breakdown (previous boot) ===", &boot_marks_saved);
+        boot_marks_saved.magic = 0;
+    }
+
+    xTaskCreate(first_task, "FirstTask", 2048, NULL, 5, NULL);
+
     printf("=== %s v%s ===\n", PROJECT_NAME, PROJECT_VERSION);
     printf("Built on: %s %s\n", BUILD_DATE, BUILD_TIME);
     printf("ESP-IDF Version: %s\n", esp_get_idf_version());
     printf("Chip: %s\n", CONFIG_IDF_TARGET);
     printf("Free heap: %" PRIu32 " bytes\n", esp_get_free_heap_size());
 
-    
     while (1) {
         printf("System is running...\n");
         vTaskDelay(pdMS_TO_TICKS(2000));
     }
-}
\ No newline at end of file
+}
@@ -3,13 +3,249 @@
 #include "freertos/task.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_chip_info.h"
 #include "esp_flash.h"        // ✅ ใช้แทน esp_spi_flash.h
 #include "nvs_flash.h"
+#include "driver/uart.h"
+#include "fastfmt.h"
 
 // Define tag for logging
 static const char *TAG = "LOGGING_DEMO";
 
+// ---- Compile-time log filtering ----
+//
+// ESP_LOGx still evaluates its arguments when the level is suppressed at
+// runtime. The LOGF macro resolves a per-tag threshold at compile time:
+// the outer `if` compares two integer constants, so a disabled site is
+// removed entirely by the compiler — no argument evaluation, no branch,
+// no string in flash. Sites that survive the static check still consult
+// a small runtime table, so the few tags we tune in the field can be
+// quietened (never raised above the static level) without reflashing.
+typedef enum {
+    LOGF_TAG_SENSOR,
+    LOGF_TAG_WIFI,
+    LOGF_TAG_COUNT
+} logf_tag_t;
+
+static const char *logf_tag_names[LOGF_TAG_COUNT] = { "SENSOR", "WIFI" };
+
+// Static thresholds, one macro per tag. Changing these is a build-time
+// decision; anything below the threshold vanishes from the binary.
+#define LOGF_STATIC_LEVEL_SENSOR  ESP_LOG_INFO
+#define LOGF_STATIC_LEVEL_WIFI    ESP_LOG_WARN
+
+// Runtime overrides, seeded from the static levels.
+static esp_log_level_t logf_runtime[LOGF_TAG_COUNT] = {
+    [LOGF_TAG_SENSOR] = LOGF_STATIC_LEVEL_SENSOR,
+    [LOGF_TAG_WIFI]   = LOGF_STATIC_LEVEL_WIFI,
+};
+
+// Lower ESP_LOG_* values are more severe, so "enabled" means
+// level <= threshold.
+#define LOGF(TAGID, LEVEL, fmt, ...)                                       \
+    do {                                                                   \
+        if ((LEVEL) <= LOGF_STATIC_LEVEL_##TAGID) {                        \
+            if ((LEVEL) <= logf_runtime[LOGF_TAG_##TAGID]) {               \
+                ESP_LOG_LEVEL(LEVEL, logf_tag_names[LOGF_TAG_##TAGID],     \
+                              fmt, ##__VA_ARGS__);                         \
+            }                                                              \
+        }                                                                  \
+    } while (0)
+
+static void logf_set_level(logf_tag_t tag, esp_log_level_t level)
+{
+    logf_runtime[tag] = level;
+    ESP_LOGI(TAG, "Runtime log level for %s set to %d", logf_tag_names[tag], level);
+}
+
+// Proves disabled sites never evaluate their arguments.
+static int logf_eval_count = 0;
+static int logf_probe(void)
+{
+    logf_eval_count++;
+    return logf_eval_count;
+}
+
+void demonstrate_filtered_logging(void)
+{
+    // SENSOR is compiled at INFO: the INFO site prints, the DEBUG site is
+    // removed at compile time — logf_probe() must not run.
+    LOGF(SENSOR, ESP_LOG_INFO, "Sensor online");
+    LOGF(SENSOR, ESP_LOG_DEBUG, "raw probe value: %d", logf_probe());
+    ESP_LOGI(TAG, "Probe evaluations after compiled-out DEBUG site: %d (expect 0)",
+             logf_eval_count);
+
+    // WIFI is compiled at WARN: INFO is gone from the binary, WARN prints.
+    LOGF(WIFI, ESP_LOG_INFO, "association details: %d", logf_probe());
+    LOGF(WIFI, ESP_LOG_WARN, "Weak signal");
+
+    // Field tuning: quieten SENSOR to ERROR at runtime without reflashing.
+    logf_set_level(LOGF_TAG_SENSOR, ESP_LOG_ERROR);
+    LOGF(SENSOR, ESP_LOG_INFO, "This INFO is now runtime-suppressed");
+    LOGF(SENSOR, ESP_LOG_ERROR, "Errors still come through");
+    logf_set_level(LOGF_TAG_SENSOR, LOGF_STATIC_LEVEL_SENSOR);
+}
+
+// ---- Binary deferred-formatting log ----
+//
+// ESP_LOGx formats at the call site, which costs tens of microseconds —
+// too slow for packet-receive paths. The BLOG macros instead push a
+// compile-time string ID plus up to three raw argument words into a small
+// ring and return; a low-priority decoder task expands them against the
+// format table later. The hot path is a short critical section and three
+// word stores, a couple of microseconds at worst.
+#define BLOG_RING_SIZE 64   // power of two
+#define BLOG_MAX_ARGS  3
+
+typedef enum {
+    BLOG_SENSOR_TEMP,     // temperature in °C
+    BLOG_SENSOR_MV,       // voltage in millivolts
+    BLOG_SENSOR_STATUS,   // status code
+    BLOG_LOOP_ITER,       // main loop iteration
+    BLOG_BENCH_FILLER,    // benchmark payload
+    BLOG_ID_COUNT
+} blog_id_t;
+
+// Indexed by blog_id_t; arguments are logged as 32-bit words, so formats
+// stick to %lu/%ld.
+static const char *blog_formats[BLOG_ID_COUNT] = {
+    [BLOG_SENSOR_TEMP]   = "  Temperature: %ld°C",
+    [BLOG_SENSOR_MV]     = "  Voltage: %lu mV",
+    [BLOG_SENSOR_STATUS] = "  Status code: %lu",
+    [BLOG_LOOP_ITER]     = "Main loop iteration: %ld",
+    [BLOG_BENCH_FILLER]  = "bench %lu %lu %lu",
+};
+
+typedef struct {
+    uint32_t id;
+    uint32_t args[BLOG_MAX_ARGS];
+} blog_record_t;
+
+static blog_record_t blog_ring[BLOG_RING_SIZE];
+static volatile uint32_t blog_head = 0;   // written under blog_lock
+static volatile uint32_t blog_tail = 0;   // advanced by the decoder only
+static volatile uint32_t blog_dropped = 0;
+static portMUX_TYPE blog_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline void blog_emit(blog_id_t id, uint32_t a0, uint32_t a1, uint32_t a2)
+{
+    portENTER_CRITICAL(&blog_lock);
+    if (blog_head - blog_tail >= BLOG_RING_SIZE) {
+        blog_dropped++;   // never block the caller
+    } else {
+        blog_record_t *r = &blog_ring[blog_head % BLOG_RING_SIZE];
+        r->id = id;
+        r->args[0] = a0;
+        r->args[1] = a1;
+        r->args[2] = a2;
+        blog_head++;
+    }
+    portEXIT_CRITICAL(&blog_lock);
+}
+
+#define BLOG0(id)             blog_emit((id), 0, 0, 0)
+#define BLOG1(id, a)          blog_emit((id), (uint32_t)(a), 0, 0)
+#define BLOG2(id, a, b)       blog_emit((id), (uint32_t)(a), (uint32_t)(b), 0)
+#define BLOG3(id, a, b, c)    blog_emit((id), (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+// Runs just above idle and expands whatever the hot paths deferred.
+// Formats carry at most BLOG_MAX_ARGS specifiers; surplus varargs are
+// simply ignored by vprintf rules.
+static void blog_decoder_task(void *pvParameters)
+{
+    uint32_t reported_drops = 0;
+    while (1) {
+        while (blog_tail != blog_head) {
+            portENTER_CRITICAL(&blog_lock);
+            blog_record_t r = blog_ring[blog_tail % BLOG_RING_SIZE];
+            blog_tail++;
+            portEXIT_CRITICAL(&blog_lock);
+
+            ESP_LOGI(TAG, blog_formats[r.id], r.args[0], r.args[1], r.args[2]);
+        }
+        if (blog_dropped != reported_drops) {
+            ESP_LOGW(TAG, "Binary log ring overflow: %lu records dropped", blog_dropped);
+            reported_drops = blog_dropped;
+        }
+        vTaskDelay(pdMS_TO_TICKS(250));
+    }
+}
+
+// ---- Asynchronous console backend ----
+//
+// Even with deferred formatting, the final print still blocks on the
+// UART FIFO: at 115200 baud an 80-character line holds its caller for
+// ~7 ms. The backend below reroutes esp_log output through the UART
+// driver's TX ring: a console write becomes vsnprintf plus a memcpy
+// into the ring, and the driver's TX interrupt drains the ring into the
+// FIFO in the background. (The classic ESP32 console UART has no GDMA
+// channel; the driver's interrupt-fed ring is the same fully
+// asynchronous shape, just fed by the TX-empty interrupt.) The caller
+// only ever blocks if it outruns the ring for a sustained burst.
+#define CONA_UART       UART_NUM_0
+#define CONA_TX_RING    4096
+#define CONA_LINE_MAX   256
+
+static bool cona_installed = false;
+static uint32_t cona_writes = 0;
+static uint32_t cona_bytes = 0;
+static uint32_t cona_truncated = 0;
+
+static int cona_vprintf(const char *fmt, va_list args)
+{
+    char line[CONA_LINE_MAX];
+    int len = vsnprintf(line, sizeof(line), fmt, args);
+    if (len < 0) return 0;
+    if (len >= (int)sizeof(line)) {
+        len = sizeof(line) - 1;
+        cona_truncated++;
+    }
+    // Memcpy into the driver ring; the TX interrupt does the rest.
+    uart_write_bytes(CONA_UART, line, len);
+    cona_writes++;
+    cona_bytes += len;
+    return len;
+}
+
+static void cona_install(void)
+{
+    // The driver needs a TX ring before writes can be asynchronous.
+    ESP_ERROR_CHECK(uart_driver_install(CONA_UART, 256, CONA_TX_RING, 0, NULL, 0));
+    esp_log_set_vprintf(cona_vprintf);
+    cona_installed = true;
+}
+
+// Same burst through both backends: blocking FIFO writes first, then
+// ring writes after the swap. The second figure is the cost callers
+// actually pay once the backend is in.
+static void console_backend_benchmark(void)
+{
+    const int bench_n = 32;
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < bench_n; i++) {
+        ESP_LOGI(TAG, "console bench (blocking) %d %d", i, i * 7);
+    }
+    int64_t blocking_us = esp_timer_get_time() - t0;
+
+    cona_install();
+
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < bench_n; i++) {
+        ESP_LOGI(TAG, "console bench (async)    %d %d", i, i * 7);
+    }
+    int64_t async_us = esp_timer_get_time() - t0;
+
+    // Let the ring drain so the report isn't interleaved with the burst.
+    uart_wait_tx_done(CONA_UART, pdMS_TO_TICKS(1000));
+    ESP_LOGI(TAG, "Console write cost: blocking %.1f us/line, async %.1f us/line (%.1fx)",
+             (float)blocking_us / bench_n, (float)async_us / bench_n,
+             async_us > 0 ? (float)blocking_us / async_us : 0.0f);
+    ESP_LOGI(TAG, "Async backend: %lu writes, %lu bytes, %lu truncated",
+             cona_writes, cona_bytes, cona_truncated);
+}
+
 void demonstrate_logging_levels(void)
 {
     ESP_LOGE(TAG, "This is an ERROR message - highest priority");
@@ -29,11 +265,59 @@ void demonstrate_formatted_logging(void)
     ESP_LOGI(TAG, "  Temperature: %d°C", temperature);
     ESP_LOGI(TAG, "  Voltage: %.2fV", voltage);
     ESP_LOGI(TAG, "  Status: %s", status);
-    
+
+    // Same readings through the deferred path: IDs + raw words now,
+    // text later, from the decoder task.
+    ESP_LOGI(TAG, "Deferred versions (decoder prints them shortly):");
+    BLOG1(BLOG_SENSOR_TEMP, temperature);
+    BLOG1(BLOG_SENSOR_MV, (uint32_t)(voltage * 1000));   // words only → mV
+    BLOG1(BLOG_SENSOR_STATUS, 0);
+
     // Hexadecimal dump
     uint8_t data[] = {0xDE, 0xAD, 0xBE, 0xEF};
     ESP_LOGI(TAG, "Data dump:");
     ESP_LOG_BUFFER_HEX(TAG, data, sizeof(data));
+
+    // Per-site cost: inline formatting vs deferred binary record.
+    const int bench_n = 32;
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < bench_n; i++) {
+        ESP_LOGI(TAG, "bench %d %d %d", i, i * 2, i * 3);
+    }
+    int64_t t1 = esp_timer_get_time();
+    for (int i = 0; i < bench_n; i++) {
+        BLOG3(BLOG_BENCH_FILLER, i, i * 2, i * 3);
+    }
+    int64_t t2 = esp_timer_get_time();
+    ESP_LOGI(TAG, "Log-site cost: ESP_LOGI %.1f us, BLOG %.1f us",
+             (float)(t1 - t0) / bench_n, (float)(t2 - t1) / bench_n);
+
+    // Formatting alone (no UART): the same sensor line through newlib's
+    // snprintf and through the fastfmt chain. The %f in the snprintf
+    // shape is what dominates its cost; fastfmt gets the same text from
+    // a pre-scaled integer.
+    const int fmt_n = 1000;
+    char line[64];
+    t0 = esp_timer_get_time();
+    for (int i = 0; i < fmt_n; i++) {
+        snprintf(line, sizeof(line), "T=%d°C V=%.2fV st=0x%08x",
+                 temperature + i, voltage, 0xDEADBEEF + i);
+    }
+    t1 = esp_timer_get_time();
+    int32_t volts_x100 = (int32_t)(voltage * 100);   // scaled once, at the source
+    for (int i = 0; i < fmt_n; i++) {
+        char *p = ff_str(line, "T=");
+        p = ff_i32(p, temperature + i);
+        p = ff_str(p, "°C V=");
+        p = ff_fix(p, volts_x100, 2);
+        p = ff_str(p, "V st=0x");
+        p = ff_hex32(p, 0xDEADBEEF + i, 8);
+        ff_term(p);
+    }
+    t2 = esp_timer_get_time();
+    ESP_LOGI(TAG, "Format cost: snprintf %.2f us, fastfmt %.2f us (%.1fx) → \"%s\"",
+             (float)(t1 - t0) / fmt_n, (float)(t2 - t1) / fmt_n,
+             (t2 - t1) > 0 ? (float)(t1 - t0) / (t2 - t1) : 0.0f, line);
 }
 
 void demonstrate_conditional_logging(void)
@@ -81,6 +365,13 @@ void app_main(void)
                  (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
     }
 
+    // Decoder expands deferred binary records whenever nothing hotter runs.
+    xTaskCreate(blog_decoder_task, "BlogDecode", 3072, NULL, 1, NULL);
+
+    // Swap the console to the asynchronous backend and show what it buys.
+    ESP_LOGI(TAG, "\n--- Console Backend Benchmark ---");
+    console_backend_benchmark();
+
     // Demonstrate different logging levels
     ESP_LOGI(TAG, "\n--- Logging Levels Demo ---");
     demonstrate_logging_levels();
@@ -92,11 +383,15 @@ void app_main(void)
     // Demonstrate conditional logging
     ESP_LOGI(TAG, "\n--- Conditional Logging Demo ---");
     demonstrate_conditional_logging();
+
+    // Demonstrate compile-time filtered logging
+    ESP_LOGI(TAG, "\n--- Filtered Logging Demo ---");
+    demonstrate_filtered_logging();
     
     // Main loop with counter
     int counter = 0;
     while (1) {
-        ESP_LOGI(TAG, "Main loop iteration: %d", counter++);
+        BLOG1(BLOG_LOOP_ITER, counter++);
         
         // Log memory status every 10 iterations
         if (counter % 10 == 0) {
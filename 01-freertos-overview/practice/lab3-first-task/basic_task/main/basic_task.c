@@ -4,6 +4,8 @@
 #include "driver/gpio.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_cpu.h"
+#include "pt.h"
 
 // ===== GPIO Definitions =====
 #define LED1_PIN GPIO_NUM_2
@@ -11,40 +13,91 @@
 
 static const char *TAG = "BASIC_TASKS";
 
-// ===== LED1 Task =====
-void led1_task(void *pvParameters)
-{
-    int *task_id = (int *)pvParameters;
-    ESP_LOGI(TAG, "LED1 Task started with ID: %d", *task_id);
+// ===== Coroutine roster =====
+//
+// The two blinkers and a dozen virtual sensor pollers used to be
+// candidates for a task each — 14 stacks for code whose entire state is
+// "which line am I on". As protothreads they share one runner task: each
+// PT_SLEEP_MS stores the resume line in two bytes and hands the runner
+// back, so the roster idles at zero CPU and one stack. Loop counters and
+// readings live in ctx structs because locals do not survive a yield.
+static pt_sched_t co_sched;
+static int led1_slot = -1;
+static int led2_slot = -1;
 
+static char led1_co(pt_t *pt, void *ctx)
+{
+    PT_BEGIN(pt);
     while (1) {
         ESP_LOGI(TAG, "LED1 ON");
         gpio_set_level(LED1_PIN, 1);
-        vTaskDelay(pdMS_TO_TICKS(500));
+        PT_SLEEP_MS(pt, 500);
 
-        ESP_LOGI(TAG, "LED1 OFF");แ
+        ESP_LOGI(TAG, "LED1 OFF");
         gpio_set_level(LED1_PIN, 0);
-        vTaskDelay(pdMS_TO_TICKS(500));
+        PT_SLEEP_MS(pt, 500);
     }
-    vTaskDelete(NULL);
+    PT_END(pt);
 }
 
-// ===== LED2 Task =====
-void led2_task(void *pvParameters)
-{
-    char *task_name = (char *)pvParameters;
-    ESP_LOGI(TAG, "LED2 Task started: %s", task_name);
+typedef struct {
+    int blink;   // survives the yields inside the fast-blink burst
+} led2_state_t;
 
+static char led2_co(pt_t *pt, void *ctx)
+{
+    led2_state_t *st = (led2_state_t *)ctx;
+    PT_BEGIN(pt);
     while (1) {
         ESP_LOGI(TAG, "LED2 Blink Fast");
-        for (int i = 0; i < 5; i++) {
+        for (st->blink = 0; st->blink < 5; st->blink++) {
             gpio_set_level(LED2_PIN, 1);
-            vTaskDelay(pdMS_TO_TICKS(100));
+            PT_SLEEP_MS(pt, 100);
             gpio_set_level(LED2_PIN, 0);
-            vTaskDelay(pdMS_TO_TICKS(100));
+            PT_SLEEP_MS(pt, 100);
         }
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        PT_SLEEP_MS(pt, 1000);
     }
+    PT_END(pt);
+}
+
+// Virtual sensors: each polls at its own period, logging every 16th
+// sample so the roster is visible without flooding the console.
+#define VIRTUAL_SENSORS 12
+
+typedef struct {
+    int id;
+    uint32_t samples;
+    uint32_t reading;
+} sensor_state_t;
+
+static sensor_state_t sensor_states[VIRTUAL_SENSORS];
+static char sensor_names[VIRTUAL_SENSORS][12];
+
+static char sensor_co(pt_t *pt, void *ctx)
+{
+    sensor_state_t *s = (sensor_state_t *)ctx;
+    PT_BEGIN(pt);
+    while (1) {
+        s->reading = (s->reading * 7 + s->id + 13) % 1024;   // fake ADC
+        s->samples++;
+        if (s->samples % 16 == 0) {
+            ESP_LOGI(TAG, "Sensor%d: %lu samples, last=%lu",
+                     s->id, s->samples, s->reading);
+        }
+        PT_SLEEP_MS(pt, 200 + 25 * s->id);
+    }
+    PT_END(pt);
+}
+
+// One real task, one real stack, the whole roster.
+static void coroutine_runner_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Coroutine runner: %d machines on one 2 KB stack "
+             "(~%u bytes of stacks+TCBs avoided vs a task each)",
+             co_sched.count,
+             (unsigned)((co_sched.count - 1) * (2048 + sizeof(StaticTask_t))));
+    pt_sched_run(&co_sched);
 }
 
 // ===== System Info Task =====
@@ -69,14 +122,13 @@ void system_info_task(void *pvParameters)
 }
 
 // ===== Task Manager =====
+// Suspend/resume now targets coroutine slots instead of task handles:
+// a disabled slot keeps its resume line and continues where it stopped,
+// same semantics the old vTaskSuspend demo showed, without the tasks.
 void task_manager(void *pvParameters)
 {
     ESP_LOGI(TAG, "Task Manager started");
 
-    TaskHandle_t *handles = (TaskHandle_t *)pvParameters;
-    TaskHandle_t led1_handle = handles[0];
-    TaskHandle_t led2_handle = handles[1];
-
     int command_counter = 0;
 
     while (1) {
@@ -84,28 +136,27 @@ void task_manager(void *pvParameters)
         switch (command_counter % 6) {
             case 1:
                 ESP_LOGW(TAG, "Manager: Suspending LED1");
-                vTaskSuspend(led1_handle);
+                pt_sched_set_enabled(&co_sched, led1_slot, false);
                 break;
 
             case 2:
                 ESP_LOGW(TAG, "Manager: Resuming LED1");
-                vTaskResume(led1_handle);
+                pt_sched_set_enabled(&co_sched, led1_slot, true);
                 break;
 
             case 3:
                 ESP_LOGW(TAG, "Manager: Suspending LED2");
-                vTaskSuspend(led2_handle);
+                pt_sched_set_enabled(&co_sched, led2_slot, false);
                 break;
 
             case 4:
                 ESP_LOGW(TAG, "Manager: Resuming LED2");
-                vTaskResume(led2_handle);
+                pt_sched_set_enabled(&co_sched, led2_slot, true);
                 break;
 
             case 5:
-                ESP_LOGI(TAG, "Manager: Checking Task States");
-                ESP_LOGI(TAG, "LED1 State: %d", eTaskGetState(led1_handle));
-                ESP_LOGI(TAG, "LED2 State: %d", eTaskGetState(led2_handle));
+                ESP_LOGI(TAG, "Manager: Coroutine roster");
+                pt_sched_report(&co_sched);
                 break;
 
             case 0:
@@ -117,11 +168,89 @@ void task_manager(void *pvParameters)
     }
 }
 
+// ===== Task Creation Benchmark (static vs dynamic) =====
+// xTaskCreate hits the heap twice per task (TCB + stack), and at boot
+// that cost lands squarely inside the cold-start budget. With
+// xTaskCreateStatic the stacks and TCBs are placed by the linker in
+// .bss, so bring-up is just list insertion. The benchmark creates the
+// same 20 tasks both ways, times each creation with the cycle counter,
+// and reports per-task and total cost plus the heap the dynamic path
+// consumed.
+#define BRINGUP_TASKS       20
+#define BRINGUP_STACK_WORDS 1024
+
+static StackType_t bringup_stacks[BRINGUP_TASKS][BRINGUP_STACK_WORDS];
+static StaticTask_t bringup_tcbs[BRINGUP_TASKS];
+
+// Fleet workers park immediately; the benchmark only cares about the
+// cost of bringing them into existence.
+static void bringup_worker(void *pvParameters)
+{
+    while (1) {
+        vTaskSuspend(NULL);
+    }
+}
+
+void task_creation_benchmark(void)
+{
+    TaskHandle_t handles[BRINGUP_TASKS];
+    char name[16];
+
+    ESP_LOGI(TAG, "=== Task bring-up benchmark (%d tasks) ===", BRINGUP_TASKS);
+
+    // Dynamic path: heap-backed TCB and stack per task.
+    uint32_t heap_before = esp_get_free_heap_size();
+    uint64_t dyn_total = 0;
+    uint32_t dyn_worst = 0;
+    for (int i = 0; i < BRINGUP_TASKS; i++) {
+        snprintf(name, sizeof(name), "DynW%d", i);
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        xTaskCreate(bringup_worker, name, BRINGUP_STACK_WORDS, NULL, 1, &handles[i]);
+        uint32_t cost = esp_cpu_get_cycle_count() - t0;
+        dyn_total += cost;
+        if (cost > dyn_worst) dyn_worst = cost;
+    }
+    uint32_t heap_used = heap_before - esp_get_free_heap_size();
+    for (int i = 0; i < BRINGUP_TASKS; i++) {
+        vTaskDelete(handles[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));   // let the idle task reclaim TCBs
+
+    // Static path: linker-placed stacks, no allocator involved.
+    uint64_t stat_total = 0;
+    uint32_t stat_worst = 0;
+    for (int i = 0; i < BRINGUP_TASKS; i++) {
+        snprintf(name, sizeof(name), "StatW%d", i);
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        handles[i] = xTaskCreateStatic(bringup_worker, name, BRINGUP_STACK_WORDS,
+                                       NULL, 1, bringup_stacks[i], &bringup_tcbs[i]);
+        uint32_t cost = esp_cpu_get_cycle_count() - t0;
+        stat_total += cost;
+        if (cost > stat_worst) stat_worst = cost;
+    }
+    for (int i = 0; i < BRINGUP_TASKS; i++) {
+        vTaskDelete(handles[i]);
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    ESP_LOGI(TAG, "Dynamic: avg %llu cycles/task, worst %lu, total %llu (%lu bytes heap)",
+             dyn_total / BRINGUP_TASKS, dyn_worst, dyn_total, heap_used);
+    ESP_LOGI(TAG, "Static:  avg %llu cycles/task, worst %lu, total %llu (0 bytes heap)",
+             stat_total / BRINGUP_TASKS, stat_worst, stat_total);
+    if (stat_total < dyn_total) {
+        ESP_LOGI(TAG, "Boot time saved by static bring-up: %llu cycles (%.1f us at 240 MHz)",
+                 dyn_total - stat_total, (dyn_total - stat_total) / 240.0);
+    }
+}
+
 // ===== app_main =====
 void app_main(void)
 {
     ESP_LOGI(TAG, "=== FreeRTOS Basic Tasks Demo ===");
 
+    // Measure bring-up cost before the demo tasks muddy the water.
+    task_creation_benchmark();
+
     // --- GPIO Config ---
     gpio_config_t io_conf = {
         .intr_type = GPIO_INTR_DISABLE,
@@ -132,26 +261,28 @@ void app_main(void)
     };
     gpio_config(&io_conf);
 
-    // --- Task Parameters ---
-    static int led1_id = 1;
-    static char led2_name[] = "FastBlinker";
+    // --- Build the coroutine roster ---
+    static led2_state_t led2_state;
+    pt_sched_init(&co_sched);
+    led1_slot = pt_sched_add(&co_sched, led1_co, NULL, "LED1");
+    led2_slot = pt_sched_add(&co_sched, led2_co, &led2_state, "LED2");
+    for (int i = 0; i < VIRTUAL_SENSORS; i++) {
+        sensor_states[i].id = i;
+        snprintf(sensor_names[i], sizeof(sensor_names[i]), "Sensor%d", i);
+        pt_sched_add(&co_sched, sensor_co, &sensor_states[i], sensor_names[i]);
+    }
 
     // --- Create Tasks ---
-    TaskHandle_t led1_handle = NULL;
-    TaskHandle_t led2_handle = NULL;
     TaskHandle_t info_handle = NULL;
 
-    BaseType_t result1 = xTaskCreate(led1_task, "LED1_Task", 2048, &led1_id, 2, &led1_handle);
-    BaseType_t result2 = xTaskCreate(led2_task, "LED2_Task", 2048, led2_name, 2, &led2_handle);
+    BaseType_t result1 = xTaskCreate(coroutine_runner_task, "CoRunner", 2048, NULL, 2, NULL);
     BaseType_t result3 = xTaskCreate(system_info_task, "SysInfo_Task", 3072, NULL, 1, &info_handle);
 
-    if (result1 == pdPASS) ESP_LOGI(TAG, "LED1 Task created");
-    if (result2 == pdPASS) ESP_LOGI(TAG, "LED2 Task created");
+    if (result1 == pdPASS) ESP_LOGI(TAG, "Coroutine runner created (%d machines)", co_sched.count);
     if (result3 == pdPASS) ESP_LOGI(TAG, "System Info Task created");
 
     // --- Create Task Manager ---
-    TaskHandle_t task_handles[2] = {led1_handle, led2_handle};
-    xTaskCreate(task_manager, "TaskManager", 2048, task_handles, 3, NULL);
+    xTaskCreate(task_manager, "TaskManager", 2048, NULL, 3, NULL);
 
     ESP_LOGI(TAG, "All tasks created. Main task idling...");
     while (1) {
@@ -1,10 +1,16 @@
 #include <stdio.h>
 #include <stdint.h>   // ✅ สำหรับ intptr_t
+#include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_freertos_hooks.h"
+#include "xts.h"
 
 #define LED_HIGH_PIN GPIO_NUM_2
 #define LED_MED_PIN  GPIO_NUM_4
@@ -145,8 +151,379 @@ void equal_priority_task(void *pvParameters)
     }
 }
 
+// ===================== 🔍 Contention Profiler =====================
+// "Who blocks whom, for how long" is invisible in the log output. All
+// mutex traffic goes through profiled_mutex_take/give, which time the
+// wait and the hold, note the previous holder on contention, and flag
+// when the wait implies a priority-inheritance promotion. Events land
+// in a per-core buffer indexed with a relaxed atomic increment, so the
+// hooks never take a lock themselves.
+#define PROFILED_LOCKS_MAX    4
+#define CONTENTION_EVENTS_MAX 64
+#define CONTENTION_MIN_WAIT_US 100   // ignore uncontended fast takes
+#define WAIT_HIST_BUCKETS     12     // bucket i: [2^i, 2^(i+1)) us
+
+typedef struct {
+    SemaphoreHandle_t handle;
+    const char *name;
+    // Ceiling protocol: 0 means inheritance (a plain FreeRTOS mutex).
+    // Non-zero means the taker raises itself to this priority before
+    // the take and the lock is a bare binary semaphore underneath —
+    // inheritance would muddy the comparison.
+    UBaseType_t ceiling;
+    UBaseType_t saved_prio;    // taker's real priority; guarded by ownership
+    TaskHandle_t owner;        // binsems have no holder API; track our own
+    uint32_t ceiling_boosts;
+    // per-lock totals, owner-updated on give
+    uint32_t takes;
+    uint32_t contentions;
+    uint32_t promotions;
+    uint64_t total_hold_us;
+    uint32_t max_hold_us;
+    uint32_t max_wait_us;
+    uint32_t wait_hist[WAIT_HIST_BUCKETS];   // blocking-time distribution
+    int64_t last_take_us;      // for hold timing; guarded by lock ownership
+} profiled_lock_t;
+
+typedef struct {
+    uint8_t lock_id;
+    char blocker[configMAX_TASK_NAME_LEN];
+    char blockee[configMAX_TASK_NAME_LEN];
+    uint32_t wait_us;
+    bool promoted;
+} contention_event_t;
+
+static profiled_lock_t profiled_locks[PROFILED_LOCKS_MAX];
+static int profiled_lock_count = 0;
+
+static contention_event_t contention_buf[portNUM_PROCESSORS][CONTENTION_EVENTS_MAX];
+static atomic_uint contention_idx[portNUM_PROCESSORS];
+
+int profiled_mutex_create(const char *name)
+{
+    if (profiled_lock_count >= PROFILED_LOCKS_MAX)
+        return -1;
+    profiled_lock_t *l = &profiled_locks[profiled_lock_count];
+    l->handle = xSemaphoreCreateMutex();
+    if (l->handle == NULL)
+        return -1;
+    l->name = name;
+    return profiled_lock_count++;
+}
+
+// Priority-ceiling variant: every taker runs at the precomputed ceiling
+// for the whole critical section, so a higher-priority waiter never
+// finds a lower-priority holder — no inversion window, no promotion
+// chain, and exactly two priority writes per contended OR uncontended
+// take (inheritance costs two per contention, but only on contention).
+// The right trade when contention is the norm and paths are
+// deterministic; FreeRTOS doesn't ship it, so we emulate: raise first,
+// then take.
+int profiled_ceiling_mutex_create(const char *name, UBaseType_t ceiling)
+{
+    if (profiled_lock_count >= PROFILED_LOCKS_MAX)
+        return -1;
+    profiled_lock_t *l = &profiled_locks[profiled_lock_count];
+    l->handle = xSemaphoreCreateBinary();
+    if (l->handle == NULL)
+        return -1;
+    xSemaphoreGive(l->handle);   // binsem starts taken; a free lock gives
+    l->name = name;
+    l->ceiling = ceiling;
+    return profiled_lock_count++;
+}
+
+BaseType_t profiled_mutex_take(int lock_id, TickType_t timeout)
+{
+    profiled_lock_t *l = &profiled_locks[lock_id];
+    TaskHandle_t holder = l->ceiling ? l->owner
+                                     : xSemaphoreGetMutexHolder(l->handle);
+    UBaseType_t holder_prio = holder ? uxTaskPriorityGet(holder) : 0;
+    UBaseType_t my_prio = uxTaskPriorityGet(NULL);
+    int64_t start = esp_timer_get_time();
+
+    // Ceiling protocol: boost before the take. If the lock is held, the
+    // holder already runs at the ceiling, so the wait is one bounded
+    // critical section — never a medium-priority interloper.
+    if (l->ceiling && my_prio < l->ceiling)
+    {
+        vTaskPrioritySet(NULL, l->ceiling);
+        l->ceiling_boosts++;
+    }
+
+    BaseType_t ok = xSemaphoreTake(l->handle, timeout);
+    if (ok != pdTRUE)
+    {
+        if (l->ceiling && my_prio < l->ceiling)
+            vTaskPrioritySet(NULL, my_prio);
+        return ok;
+    }
+    if (l->ceiling)
+    {
+        l->owner = xTaskGetCurrentTaskHandle();
+        l->saved_prio = my_prio;
+    }
+
+    uint32_t wait_us = (uint32_t)(esp_timer_get_time() - start);
+    int b = 0;
+    while ((1u << (b + 1)) <= wait_us && b < WAIT_HIST_BUCKETS - 1) b++;
+    l->wait_hist[b]++;
+    l->last_take_us = esp_timer_get_time();
+    l->takes++;
+    if (holder != NULL && wait_us > CONTENTION_MIN_WAIT_US)
+    {
+        l->contentions++;
+        if (wait_us > l->max_wait_us)
+            l->max_wait_us = wait_us;
+
+        // Inheritance kicks in when a higher-priority waiter hits a
+        // lower-priority holder; flag those promotions. Under the
+        // ceiling protocol this never fires — that is the point.
+        bool promoted = !l->ceiling && my_prio > holder_prio;
+        if (promoted)
+            l->promotions++;
+
+        int core = xPortGetCoreID();
+        unsigned slot = atomic_fetch_add_explicit(&contention_idx[core], 1,
+                                                  memory_order_relaxed)
+                        % CONTENTION_EVENTS_MAX;
+        contention_event_t *e = &contention_buf[core][slot];
+        e->lock_id = (uint8_t)lock_id;
+        strncpy(e->blocker, pcTaskGetName(holder), sizeof(e->blocker) - 1);
+        strncpy(e->blockee, pcTaskGetName(NULL), sizeof(e->blockee) - 1);
+        e->wait_us = wait_us;
+        e->promoted = promoted;
+    }
+    return pdTRUE;
+}
+
+void profiled_mutex_give(int lock_id)
+{
+    profiled_lock_t *l = &profiled_locks[lock_id];
+    uint32_t hold_us = (uint32_t)(esp_timer_get_time() - l->last_take_us);
+    l->total_hold_us += hold_us;
+    if (hold_us > l->max_hold_us)
+        l->max_hold_us = hold_us;
+
+    UBaseType_t restore = l->saved_prio;
+    if (l->ceiling)
+        l->owner = NULL;           // while still serialized by ownership
+    xSemaphoreGive(l->handle);
+    // Drop back only after the give: demoting first would let a waiter
+    // preempt us while we still hold the lock.
+    if (l->ceiling && restore < l->ceiling)
+        vTaskPrioritySet(NULL, restore);
+}
+
+// Ranks lock hot spots and replays the worst recent blocker/blockee pairs.
+void contention_report_task(void *pvParameters)
+{
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(15000));
+        ESP_LOGI(TAG, "=== LOCK CONTENTION REPORT ===");
+        for (int i = 0; i < profiled_lock_count; i++)
+        {
+            profiled_lock_t *l = &profiled_locks[i];
+            if (l->takes == 0)
+                continue;
+            if (l->ceiling)
+                ESP_LOGI(TAG, "%s (ceiling %u): %lu takes, %lu contended, %lu boosts | hold avg=%lluus max=%luus | worst wait=%luus",
+                         l->name, l->ceiling, l->takes, l->contentions,
+                         l->ceiling_boosts, l->total_hold_us / l->takes,
+                         l->max_hold_us, l->max_wait_us);
+            else
+                ESP_LOGI(TAG, "%s (inherit): %lu takes, %lu contended, %lu promotions | hold avg=%lluus max=%luus | worst wait=%luus",
+                         l->name, l->takes, l->contentions, l->promotions,
+                         l->total_hold_us / l->takes, l->max_hold_us, l->max_wait_us);
+            for (int b = 0; b < WAIT_HIST_BUCKETS; b++)
+            {
+                if (l->wait_hist[b] == 0)
+                    continue;
+                ESP_LOGI(TAG, "    wait [%5u-%5u us): %lu",
+                         1u << b, 1u << (b + 1), l->wait_hist[b]);
+            }
+        }
+        for (int core = 0; core < portNUM_PROCESSORS; core++)
+        {
+            unsigned n = atomic_load_explicit(&contention_idx[core], memory_order_relaxed);
+            unsigned count = (n < CONTENTION_EVENTS_MAX) ? n : CONTENTION_EVENTS_MAX;
+            for (unsigned j = 0; j < count; j++)
+            {
+                contention_event_t *e = &contention_buf[core][j];
+                if (e->wait_us == 0)
+                    continue;
+                ESP_LOGI(TAG, "  core%d: %s blocked %s on %s for %luus%s",
+                         core, e->blocker, e->blockee,
+                         profiled_locks[e->lock_id].name, e->wait_us,
+                         e->promoted ? " (inherited)" : "");
+                e->wait_us = 0;   // consume
+            }
+        }
+    }
+}
+
+// ===================== 📼 Scheduler Event Tracer =====================
+// The counters above say how often tasks ran, never WHEN or in what
+// order - useless when high-priority work mysteriously waits 30 ms
+// behind equal-priority peers. This tracer records scheduling events
+// into per-core preallocated rings: one relaxed atomic increment to
+// claim a slot, four stores to fill it. No lock, no allocation, well
+// under 100 cycles per event, safe from ISR context.
+//
+// Feeds: a per-CPU tick hook samples the running task every tick, and
+// sched_trace_switch_in()/out() are shaped to be called from the
+// traceTASK_SWITCHED_IN/OUT macros for exact switch edges when a
+// FreeRTOSConfig override is available. Tick sampling alone already
+// reconstructs who monopolized a core and for how long.
+#define TRACE_RING_EVENTS 256    // per core; power of two for cheap wrap
+
+typedef enum {
+    TRACE_TICK_RUNNING = 0,   // sampled by the tick hook
+    TRACE_SWITCH_IN,          // from trace macro, when wired up
+    TRACE_SWITCH_OUT,
+} trace_reason_t;
+
+typedef struct {
+    uint32_t stamp_us;        // xts cross-core timeline (low 32 bits)
+    TaskHandle_t task;
+    uint8_t core;
+    uint8_t reason;           // trace_reason_t
+} trace_event_t;
+
+static trace_event_t trace_ring[portNUM_PROCESSORS][TRACE_RING_EVENTS];
+static atomic_uint trace_idx[portNUM_PROCESSORS];
+static volatile bool trace_enabled = false;
+
+static inline void sched_trace_record(uint8_t reason)
+{
+    if (!trace_enabled)
+        return;
+    int core = xPortGetCoreID();
+    unsigned slot = atomic_fetch_add_explicit(&trace_idx[core], 1,
+                                              memory_order_relaxed)
+                    & (TRACE_RING_EVENTS - 1);
+    trace_event_t *e = &trace_ring[core][slot];
+    e->stamp_us = (uint32_t)xts_now_us();
+    e->task = xTaskGetCurrentTaskHandle();
+    e->core = (uint8_t)core;
+    e->reason = reason;
+}
+
+// Entry points for a traceTASK_SWITCHED_IN/OUT override.
+void sched_trace_switch_in(void)  { sched_trace_record(TRACE_SWITCH_IN); }
+void sched_trace_switch_out(void) { sched_trace_record(TRACE_SWITCH_OUT); }
+
+// Tick hook runs in the tick ISR on its own core; the "current task"
+// it sees is exactly the task that owned that core for this tick.
+static void trace_tick_hook(void)
+{
+    sched_trace_record(TRACE_TICK_RUNNING);
+}
+
+// Decodes one core's ring into per-task tick counts and the longest
+// unbroken run - the direct answer to "what ran ahead of my task".
+static void trace_drain_core(int core)
+{
+    trace_event_t local[TRACE_RING_EVENTS];
+    unsigned total = atomic_load_explicit(&trace_idx[core], memory_order_relaxed);
+    memcpy(local, trace_ring[core], sizeof(local));
+
+    unsigned count = (total < TRACE_RING_EVENTS) ? total : TRACE_RING_EVENTS;
+    if (count == 0)
+        return;
+    unsigned start = (total < TRACE_RING_EVENTS)
+                         ? 0 : (total & (TRACE_RING_EVENTS - 1));
+
+    TaskHandle_t run_task = NULL;
+    unsigned run_len = 0, worst_run = 0;
+    TaskHandle_t worst_task = NULL;
+
+    ESP_LOGI(TAG, "core%d: %u events (%u total since boot)", core, count, total);
+    for (unsigned n = 0; n < count; n++)
+    {
+        const trace_event_t *e = &local[(start + n) & (TRACE_RING_EVENTS - 1)];
+        if (e->reason != TRACE_TICK_RUNNING)
+            continue;
+        if (e->task == run_task)
+        {
+            run_len++;
+        }
+        else
+        {
+            run_task = e->task;
+            run_len = 1;
+        }
+        if (run_len > worst_run)
+        {
+            worst_run = run_len;
+            worst_task = run_task;
+        }
+    }
+    if (worst_task != NULL)
+    {
+        ESP_LOGI(TAG, "  longest unbroken run: %s for %u ticks (%lu ms)",
+                 pcTaskGetName(worst_task), worst_run,
+                 (uint32_t)(worst_run * portTICK_PERIOD_MS));
+    }
+}
+
+// Drain on demand over UART: type 't' on the console to dump both
+// cores, 's'/'r' to stop/restart capture. Polling getchar keeps this
+// free of console-component dependencies.
+void trace_drain_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Tracer ready - UART: 't'=dump, 's'=stop, 'r'=resume");
+    while (1)
+    {
+        int c = getchar();
+        if (c == 't' || c == 'T')
+        {
+            ESP_LOGI(TAG, "=== SCHEDULER TRACE DUMP ===");
+            for (int core = 0; core < portNUM_PROCESSORS; core++)
+                trace_drain_core(core);
+            xts_report();
+        }
+        else if (c == 's' || c == 'S')
+        {
+            trace_enabled = false;
+            ESP_LOGW(TAG, "Trace capture stopped");
+        }
+        else if (c == 'r' || c == 'R')
+        {
+            trace_enabled = true;
+            ESP_LOGW(TAG, "Trace capture resumed");
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+void sched_trace_init(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        ESP_ERROR_CHECK(esp_register_freertos_tick_hook_for_cpu(trace_tick_hook, core));
+    }
+    trace_enabled = true;
+    xTaskCreate(trace_drain_task, "TraceDrain", 3072, NULL, 1, NULL);
+}
+
 // ===================== 🧩 Priority Inversion Demo =====================
-volatile bool shared_resource_busy = false;
+// Now a real mutex (with priority inheritance) instead of a busy flag,
+// so the profiler above can watch the inversion happen. The demo runs
+// in alternating 10 s phases — inheritance lock, then ceiling lock —
+// so the contention report shows both protocols' blocking-time
+// distributions side by side from identical workloads.
+static int shared_resource_lock = -1;
+static int ceiling_resource_lock = -1;
+
+// Both tasks derive the phase from the tick so they contend on the
+// same lock.
+static int inversion_phase_lock(void)
+{
+    bool ceiling_phase = (xTaskGetTickCount() / pdMS_TO_TICKS(10000)) & 1;
+    return ceiling_phase ? ceiling_resource_lock : shared_resource_lock;
+}
 
 void priority_inversion_high(void *pvParameters)
 {
@@ -154,17 +531,20 @@ void priority_inversion_high(void *pvParameters)
     {
         if (priority_test_running)
         {
-            ESP_LOGW(TAG, "High priority task needs shared resource");
-            while (shared_resource_busy)
+            int lock = inversion_phase_lock();
+            ESP_LOGW(TAG, "High priority task needs shared resource (%s)",
+                     lock == ceiling_resource_lock ? "ceiling" : "inherit");
+            if (profiled_mutex_take(lock, pdMS_TO_TICKS(5000)) == pdTRUE)
             {
-                ESP_LOGW(TAG, "High priority BLOCKED by low priority!");
-                vTaskDelay(pdMS_TO_TICKS(10));
+                ESP_LOGI(TAG, "High priority got resource");
+                vTaskDelay(pdMS_TO_TICKS(200));
+                profiled_mutex_give(lock);
+                ESP_LOGI(TAG, "High priority released resource");
+            }
+            else
+            {
+                ESP_LOGE(TAG, "High priority timed out waiting for resource!");
             }
-            shared_resource_busy = true;
-            ESP_LOGI(TAG, "High priority got resource");
-            vTaskDelay(pdMS_TO_TICKS(200));
-            shared_resource_busy = false;
-            ESP_LOGI(TAG, "High priority released resource");
         }
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
@@ -176,16 +556,127 @@ void priority_inversion_low(void *pvParameters)
     {
         if (priority_test_running)
         {
-            ESP_LOGI(TAG, "Low priority using shared resource");
-            shared_resource_busy = true;
-            vTaskDelay(pdMS_TO_TICKS(2000));
-            shared_resource_busy = false;
-            ESP_LOGI(TAG, "Low priority released resource");
+            int lock = inversion_phase_lock();
+            if (profiled_mutex_take(lock, portMAX_DELAY) == pdTRUE)
+            {
+                ESP_LOGI(TAG, "Low priority using shared resource");
+                vTaskDelay(pdMS_TO_TICKS(2000));
+                profiled_mutex_give(lock);
+                ESP_LOGI(TAG, "Low priority released resource");
+            }
         }
         vTaskDelay(pdMS_TO_TICKS(3000));
     }
 }
 
+// ===================== ⚖️ Priority Governor =====================
+// Static priorities fit exactly one load mix; ours shifts between
+// phases, and whatever we pick is wrong in the other phase. The
+// governor samples each governed task's run-time counter, turns the
+// delta into a CPU share for the window, and nudges the priority
+// within a declared [min,max] band: below-target share for consecutive
+// windows earns +1, above-target while boosted decays -1 back toward
+// base. The band keeps the governor from ever promoting work above
+// what its designer allowed, and the consecutive-window rule is the
+// hysteresis that stops priority flapping on a noisy window.
+#define GOV_TASKS_MAX        6
+#define GOV_WINDOW_MS        2000
+#define GOV_CONFIRM_WINDOWS  2     // windows of evidence before a change
+
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    UBaseType_t base_prio;
+    UBaseType_t min_prio;
+    UBaseType_t max_prio;
+    uint32_t target_share_pct;     // declared fair share of one core
+    uint64_t last_runtime;         // run-time counter at last sample
+    int8_t pressure;               // +starved / -overfed window streak
+    uint32_t boosts;
+    uint32_t decays;
+} governed_task_t;
+
+static governed_task_t governed[GOV_TASKS_MAX];
+static int governed_count = 0;
+
+int gov_register(TaskHandle_t handle, const char *name,
+                 UBaseType_t min_prio, UBaseType_t max_prio,
+                 uint32_t target_share_pct)
+{
+    if (governed_count >= GOV_TASKS_MAX || handle == NULL)
+        return -1;
+    governed_task_t *g = &governed[governed_count];
+    g->handle = handle;
+    g->name = name;
+    g->base_prio = uxTaskPriorityGet(handle);
+    g->min_prio = min_prio;
+    g->max_prio = max_prio;
+    g->target_share_pct = target_share_pct;
+    g->last_runtime = ulTaskGetRunTimeCounter(handle);
+    g->pressure = 0;
+    return governed_count++;
+}
+
+void governor_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Governor started: %d tasks, %d ms window", governed_count, GOV_WINDOW_MS);
+    int64_t window_start = esp_timer_get_time();
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(GOV_WINDOW_MS));
+        int64_t now = esp_timer_get_time();
+        uint64_t window_us = (uint64_t)(now - window_start);
+        window_start = now;
+
+        for (int i = 0; i < governed_count; i++)
+        {
+            governed_task_t *g = &governed[i];
+            if (eTaskGetState(g->handle) == eDeleted)
+                continue;
+
+            // Run-time counter ticks in the same us clock as esp_timer,
+            // so delta/window is this task's share of one core.
+            uint64_t runtime = ulTaskGetRunTimeCounter(g->handle);
+            uint32_t share_pct = (uint32_t)((runtime - g->last_runtime) * 100 / window_us);
+            g->last_runtime = runtime;
+
+            UBaseType_t prio = uxTaskPriorityGet(g->handle);
+
+            // Starvation / deadline pressure: consistently under target.
+            if (share_pct < g->target_share_pct)
+            {
+                if (g->pressure < 0) g->pressure = 0;
+                if (++g->pressure >= GOV_CONFIRM_WINDOWS && prio < g->max_prio)
+                {
+                    vTaskPrioritySet(g->handle, prio + 1);
+                    g->boosts++;
+                    g->pressure = 0;
+                    ESP_LOGW(TAG, "⚖️ Governor: %s %u->%u (share %lu%% < target %lu%%)",
+                             g->name, prio, prio + 1, share_pct, g->target_share_pct);
+                }
+            }
+            // Fed and still boosted: step back toward base.
+            else if (prio > g->base_prio)
+            {
+                if (g->pressure > 0) g->pressure = 0;
+                if (--g->pressure <= -GOV_CONFIRM_WINDOWS && prio > g->min_prio)
+                {
+                    vTaskPrioritySet(g->handle, prio - 1);
+                    g->decays++;
+                    g->pressure = 0;
+                    ESP_LOGI(TAG, "⚖️ Governor: %s %u->%u (share %lu%% ok, decaying)",
+                             g->name, prio, prio - 1, share_pct);
+                }
+            }
+            else
+            {
+                g->pressure = 0;
+            }
+        }
+    }
+}
+
 // ===================== 🧠 app_main() =====================
 void app_main(void)
 {
@@ -210,9 +701,10 @@ void app_main(void)
     ESP_LOGI(TAG, "Creating tasks...");
 
     // Step 1: Priority Demo
+    TaskHandle_t med_handle = NULL, low_handle = NULL;
     xTaskCreate(high_priority_task, "HighPrio", 3072, NULL, 5, NULL);
-    xTaskCreate(medium_priority_task, "MedPrio", 3072, NULL, 3, NULL);
-    xTaskCreate(low_priority_task, "LowPrio", 3072, NULL, 1, NULL);
+    xTaskCreate(medium_priority_task, "MedPrio", 3072, NULL, 3, &med_handle);
+    xTaskCreate(low_priority_task, "LowPrio", 3072, NULL, 1, &low_handle);
     xTaskCreate(control_task, "Control", 3072, NULL, 4, NULL);
 
     // Step 2: Round-Robin Tasks (Priority 2)
@@ -220,9 +712,26 @@ void app_main(void)
     xTaskCreate(equal_priority_task, "Equal2", 2048, (void *)2, 2, NULL);
     xTaskCreate(equal_priority_task, "Equal3", 2048, (void *)3, 2, NULL);
 
-    // Step 3: Priority Inversion Simulation
+    // Step 3: Priority Inversion Simulation (profiled mutex)
+    shared_resource_lock = profiled_mutex_create("SharedResource");
+    // Ceiling = InvHigh's priority: the highest priority that ever
+    // takes this lock, precomputed from the static task set.
+    ceiling_resource_lock = profiled_ceiling_mutex_create("CeilingResource", 5);
     xTaskCreate(priority_inversion_high, "InvHigh", 3072, NULL, 5, NULL);
     xTaskCreate(priority_inversion_low, "InvLow", 3072, NULL, 1, NULL);
+    xTaskCreate(contention_report_task, "LockReport", 3072, NULL, 2, NULL);
+
+    // Step 4: Scheduler tracer (dump with 't' on the console). The
+    // tracer stamps events on the shared xts timeline so the two cores'
+    // rings can be ordered against each other.
+    xts_init();
+    sched_trace_init();
+
+    // Step 5: Governor - med and low may climb within their bands when
+    // the test phase starves them, and decay back once fed.
+    gov_register(med_handle, "MedPrio", 2, 4, 15);
+    gov_register(low_handle, "LowPrio", 1, 3, 5);
+    xTaskCreate(governor_task, "Governor", 3072, NULL, 6, NULL);
 
     ESP_LOGI(TAG, "Press button to start test");
     ESP_LOGI(TAG, "LEDs: GPIO2=High, GPIO4=Med, GPIO5=Low");
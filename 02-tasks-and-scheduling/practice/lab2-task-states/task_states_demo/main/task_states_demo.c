@@ -1,10 +1,14 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
+#include "freertos/queue.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
 
 #define LED_RUNNING GPIO_NUM_2
 #define LED_READY GPIO_NUM_4
@@ -18,6 +22,7 @@ static const char *TAG = "TASK_STATES";
 
 TaskHandle_t state_demo_task_handle = NULL;
 TaskHandle_t control_task_handle = NULL;
+TaskHandle_t emergency_task_handle = NULL;
 
 SemaphoreHandle_t demo_semaphore = NULL;
 
@@ -31,6 +36,106 @@ const char* get_state_name(eTaskState state)
     return state_names[5];
 }
 
+// ================== Ready-Latency Tracker ==================
+// The state sampler below says WHICH state a task is in, never how long
+// it sat Ready before actually Running — the number that decides
+// whether a high-priority wake meets its deadline. The tracker brackets
+// the gap from both ends: the waker stamps the slot immediately before
+// the wake primitive (the moment the task becomes Ready), and the woken
+// task's first statement after unblocking takes the delta (its
+// switch-in). The pair lands in a power-of-two-bucket histogram per
+// task. rlat_mark_ready_for() is shaped so a
+// traceMOVED_TASK_TO_READY_STATE override can feed it when a
+// FreeRTOSConfig override is available; the cooperative bracketing
+// works without one.
+#define RLAT_TASKS_MAX 4
+#define RLAT_BUCKETS   16      // bucket i: [2^i, 2^(i+1)) us
+
+typedef struct
+{
+    const char *name;
+    TaskHandle_t task;
+    volatile int64_t ready_at_us;   // 0 = not currently pending
+    uint32_t hist[RLAT_BUCKETS];
+    uint32_t samples;
+    uint64_t sum_us;
+    uint32_t worst_us;
+    uint32_t worst_at_ms;
+} rlat_slot_t;
+
+static rlat_slot_t rlat_slots[RLAT_TASKS_MAX];
+static int rlat_count = 0;
+static int rlat_emergency_id = -1, rlat_statedemo_id = -1;
+
+int rlat_register(const char *name, TaskHandle_t task)
+{
+    if (rlat_count >= RLAT_TASKS_MAX) return -1;
+    rlat_slots[rlat_count].name = name;
+    rlat_slots[rlat_count].task = task;
+    return rlat_count++;
+}
+
+// Waker side: call right before the wake primitive (notify, give,
+// resume). Overwrites a still-pending stamp; the later wake is the one
+// the wakee will observe anyway.
+static inline void rlat_mark_ready(int id)
+{
+    if (id >= 0) rlat_slots[id].ready_at_us = esp_timer_get_time();
+}
+
+// traceMOVED_TASK_TO_READY_STATE entry point: lookup by handle.
+void rlat_mark_ready_for(TaskHandle_t task)
+{
+    for (int i = 0; i < rlat_count; i++)
+        if (rlat_slots[i].task == task)
+            rlat_slots[i].ready_at_us = esp_timer_get_time();
+}
+
+// Wakee side: first statement after the blocking call returns.
+static void rlat_switched_in(int id)
+{
+    if (id < 0) return;
+    rlat_slot_t *s = &rlat_slots[id];
+    int64_t at = s->ready_at_us;
+    if (at == 0) return;            // woke by timeout, not a marked wake
+    s->ready_at_us = 0;
+
+    uint32_t delta = (uint32_t)(esp_timer_get_time() - at);
+    int b = 0;
+    while ((1u << (b + 1)) <= delta && b < RLAT_BUCKETS - 1) b++;
+    s->hist[b]++;
+    s->samples++;
+    s->sum_us += delta;
+    if (delta > s->worst_us)
+    {
+        s->worst_us = delta;
+        s->worst_at_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    }
+}
+
+void rlat_report(void)
+{
+    ESP_LOGI(TAG, "=== READY-TO-RUNNING LATENCY ===");
+    for (int i = 0; i < rlat_count; i++)
+    {
+        rlat_slot_t *s = &rlat_slots[i];
+        if (s->samples == 0)
+        {
+            ESP_LOGI(TAG, "%s: no marked wakes yet", s->name);
+            continue;
+        }
+        ESP_LOGI(TAG, "%s (prio %u): %lu wakes, avg %llu us, worst %lu us at %lu ms",
+                 s->name, s->task ? uxTaskPriorityGet(s->task) : 0,
+                 s->samples, s->sum_us / s->samples, s->worst_us, s->worst_at_ms);
+        for (int b = 0; b < RLAT_BUCKETS; b++)
+        {
+            if (s->hist[b] == 0) continue;
+            ESP_LOGI(TAG, "    [%6u-%6u us): %lu",
+                     1u << b, 1u << (b + 1), s->hist[b]);
+        }
+    }
+}
+
 // ================== Task States Demonstration ==================
 void state_demo_task(void *pvParameters)
 {
@@ -69,6 +174,7 @@ void state_demo_task(void *pvParameters)
 
         if (xSemaphoreTake(demo_semaphore, pdMS_TO_TICKS(2000)) == pdTRUE)
         {
+            rlat_switched_in(rlat_statedemo_id);
             ESP_LOGI(TAG, "Got semaphore! RUNNING again");
             gpio_set_level(LED_BLOCKED, 0);
             gpio_set_level(LED_RUNNING, 1);
@@ -104,6 +210,26 @@ void ready_state_demo_task(void *pvParameters)
     }
 }
 
+// Emergency responder: highest priority in the lab, parked on a direct
+// notification. It should leave Ready within microseconds of the mark;
+// the histogram is the proof (or the indictment).
+void emergency_task(void *pvParameters)
+{
+    ESP_LOGI(TAG, "Emergency task parked (prio %u)", uxTaskPriorityGet(NULL));
+    uint32_t responses = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        rlat_switched_in(rlat_emergency_id);
+
+        // Simulated response work: short and bounded.
+        for (volatile int i = 0; i < 20000; i++) { }
+        if (++responses % 10 == 0)
+            ESP_LOGW(TAG, "Emergency handled %lu times", responses);
+    }
+}
+
 // ================== Control Task ==================
 void control_task(void *pvParameters)
 {
@@ -147,11 +273,21 @@ void control_task(void *pvParameters)
         {
             vTaskDelay(pdMS_TO_TICKS(50));
             ESP_LOGW(TAG, "=== GIVING SEMAPHORE ===");
+            rlat_mark_ready(rlat_statedemo_id);
             xSemaphoreGive(demo_semaphore);
             while (gpio_get_level(BUTTON2_PIN) == 0)
                 vTaskDelay(pdMS_TO_TICKS(10));
         }
 
+        // Periodic emergency drill: mark Ready, then wake. The gap the
+        // tracker records between these two points and the responder's
+        // first statement is pure scheduling latency.
+        if (cycle % 20 == 0 && emergency_task_handle)
+        {
+            rlat_mark_ready(rlat_emergency_id);
+            xTaskNotifyGive(emergency_task_handle);
+        }
+
         // Every 3 seconds: monitor
         if (cycle % 30 == 0)
         {
@@ -223,24 +359,226 @@ void external_delete_task(void *pvParameters)
     }
 }
 
+// ================== Worker Recycling Pool ==================
+// The self/external-delete demos above show the create/delete cycle we
+// use for job workers — and every cycle mallocs and frees a TCB plus a
+// 2 KB stack. At ~200 short jobs a minute that churn is the top heap
+// fragmentation source. The pool below allocates nothing per job: a
+// fixed set of workers built with xTaskCreateStatic park on a statically
+// backed queue and run whatever job closure arrives. The worker's
+// "deleted" state becomes "blocked on the queue", which costs no heap.
+#define WORKER_POOL_SIZE    3
+#define WORKER_STACK_WORDS  2048
+#define JOB_QUEUE_DEPTH     8
+
+typedef void (*job_fn_t)(void *arg);
+
+typedef struct
+{
+    job_fn_t fn;
+    void *arg;
+} job_t;
+
+static StackType_t worker_stacks[WORKER_POOL_SIZE][WORKER_STACK_WORDS];
+static StaticTask_t worker_tcbs[WORKER_POOL_SIZE];
+static StaticQueue_t job_queue_buffer;
+static uint8_t job_queue_storage[JOB_QUEUE_DEPTH * sizeof(job_t)];
+static QueueHandle_t job_queue = NULL;
+
+static uint32_t worker_jobs_done[WORKER_POOL_SIZE];
+static uint32_t jobs_rejected = 0;
+
+void worker_task(void *pvParameters)
+{
+    int id = (int)(intptr_t)pvParameters;
+    ESP_LOGI(TAG, "Worker %d parked, waiting for jobs", id);
+
+    while (1)
+    {
+        job_t job;
+        if (xQueueReceive(job_queue, &job, portMAX_DELAY) == pdTRUE)
+        {
+            job.fn(job.arg);
+            worker_jobs_done[id]++;
+        }
+    }
+}
+
+// Non-blocking submit: a full queue means the pool is saturated, and we
+// would rather count the drop than let the submitter block.
+bool worker_pool_submit(job_fn_t fn, void *arg)
+{
+    job_t job = {.fn = fn, .arg = arg};
+    if (xQueueSend(job_queue, &job, 0) != pdTRUE)
+    {
+        jobs_rejected++;
+        return false;
+    }
+    return true;
+}
+
+void worker_pool_init(void)
+{
+    job_queue = xQueueCreateStatic(JOB_QUEUE_DEPTH, sizeof(job_t),
+                                   job_queue_storage, &job_queue_buffer);
+    for (int i = 0; i < WORKER_POOL_SIZE; i++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "Worker%d", i);
+        xTaskCreateStatic(worker_task, name, WORKER_STACK_WORDS,
+                          (void *)(intptr_t)i, 2,
+                          worker_stacks[i], &worker_tcbs[i]);
+    }
+    ESP_LOGI(TAG, "Worker pool: %d static workers, queue depth %d, zero heap per job",
+             WORKER_POOL_SIZE, JOB_QUEUE_DEPTH);
+}
+
+// Example job: the same short-lived work self_deleting_task models, but
+// without a task lifecycle wrapped around it.
+static void short_job(void *arg)
+{
+    int work_ms = (int)(intptr_t)arg;
+    for (volatile int i = 0; i < 50000; i++) { }
+    vTaskDelay(pdMS_TO_TICKS(work_ms));
+}
+
+// Feeds the pool at roughly the production rate (~3 jobs/s) and proves
+// the point by watching free heap stay flat across hundreds of jobs.
+void job_spawner_task(void *pvParameters)
+{
+    uint32_t submitted = 0;
+    uint32_t heap_at_start = esp_get_free_heap_size();
+
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(300));
+        worker_pool_submit(short_job, (void *)(intptr_t)(10 + (submitted % 5) * 10));
+        submitted++;
+
+        if (submitted % 50 == 0)
+        {
+            uint32_t done = 0;
+            for (int i = 0; i < WORKER_POOL_SIZE; i++)
+                done += worker_jobs_done[i];
+            ESP_LOGI(TAG, "Pool: %lu submitted, %lu done (W0=%lu W1=%lu W2=%lu), %lu rejected",
+                     submitted, done, worker_jobs_done[0], worker_jobs_done[1],
+                     worker_jobs_done[2], jobs_rejected);
+            ESP_LOGI(TAG, "Free heap: %lu bytes (was %lu at start - no churn)",
+                     esp_get_free_heap_size(), heap_at_start);
+        }
+    }
+}
+
 // ================== Monitor Specific Tasks ==================
+// Formatting on every sample perturbs the very scheduling being
+// observed: a vTaskList dump costs milliseconds. The collector instead
+// snapshots raw numbers into a preallocated binary ring (a few
+// microseconds, no heap, no printf) and a separate low-priority drain
+// task formats only when asked.
+#define STATE_RING_SAMPLES   128
+#define STATE_RING_TASKS     2
+
+typedef struct
+{
+    uint32_t timestamp_ms;
+    uint8_t  state[STATE_RING_TASKS];        // eTaskState
+    uint8_t  priority[STATE_RING_TASKS];
+    uint16_t stack_free_words[STATE_RING_TASKS];
+    uint16_t sample_cost_us;                 // what the snapshot itself cost
+} state_sample_t;
+
+static state_sample_t state_ring[STATE_RING_SAMPLES];
+static uint32_t state_ring_head = 0;         // next write slot
+static uint32_t state_ring_total = 0;        // lifetime samples
+static portMUX_TYPE state_ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *tracked_names[STATE_RING_TASKS] = {"StateDemo", "Control"};
+
 void monitor_task_states(void)
 {
-    ESP_LOGI(TAG, "=== DETAILED TASK STATE MONITOR ===");
-    TaskHandle_t tasks[] = {state_demo_task_handle, control_task_handle};
-    const char* names[] = {"StateDemo", "Control"};
-    int n = sizeof(tasks)/sizeof(tasks[0]);
+    TaskHandle_t tasks[STATE_RING_TASKS] = {state_demo_task_handle, control_task_handle};
+    state_sample_t sample = {0};
+    int64_t start = esp_timer_get_time();
 
-    for (int i = 0; i < n; i++)
+    sample.timestamp_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    for (int i = 0; i < STATE_RING_TASKS; i++)
     {
         if (tasks[i])
         {
-            eTaskState st = eTaskGetState(tasks[i]);
-            UBaseType_t pr = uxTaskPriorityGet(tasks[i]);
-            UBaseType_t st_remain = uxTaskGetStackHighWaterMark(tasks[i]);
-            ESP_LOGI(TAG, "%s: %s | Priority=%d | Stack=%d bytes",
-                     names[i], get_state_name(st), pr, st_remain * sizeof(StackType_t));
+            sample.state[i] = (uint8_t)eTaskGetState(tasks[i]);
+            sample.priority[i] = (uint8_t)uxTaskPriorityGet(tasks[i]);
+            sample.stack_free_words[i] = (uint16_t)uxTaskGetStackHighWaterMark(tasks[i]);
+        }
+    }
+    sample.sample_cost_us = (uint16_t)(esp_timer_get_time() - start);
+
+    portENTER_CRITICAL(&state_ring_lock);
+    state_ring[state_ring_head] = sample;
+    state_ring_head = (state_ring_head + 1) % STATE_RING_SAMPLES;
+    state_ring_total++;
+    portEXIT_CRITICAL(&state_ring_lock);
+}
+
+// Continuous sampler: cheap enough to run at 4 Hz without disturbing
+// the demo tasks it watches.
+void state_sampler_task(void *pvParameters)
+{
+    while (1)
+    {
+        monitor_task_states();
+        vTaskDelay(pdMS_TO_TICKS(250));
+    }
+}
+
+// Drain task: formats on demand (here on a slow cadence), summarizing
+// the window instead of echoing every sample.
+void state_drain_task(void *pvParameters)
+{
+    while (1)
+    {
+        vTaskDelay(pdMS_TO_TICKS(10000));
+
+        state_sample_t local[STATE_RING_SAMPLES];
+        uint32_t total, head;
+        portENTER_CRITICAL(&state_ring_lock);
+        memcpy(local, state_ring, sizeof(local));
+        total = state_ring_total;
+        head = state_ring_head;
+        portEXIT_CRITICAL(&state_ring_lock);
+
+        uint32_t count = (total < STATE_RING_SAMPLES) ? total : STATE_RING_SAMPLES;
+        if (count == 0)
+            continue;
+
+        ESP_LOGI(TAG, "=== STATE COLLECTOR (%lu samples total, last %lu) ===", total, count);
+        uint32_t cost_sum = 0;
+        uint32_t state_hist[STATE_RING_TASKS][5] = {0};
+        uint16_t min_stack[STATE_RING_TASKS] = {0xFFFF, 0xFFFF};
+
+        for (uint32_t n = 0; n < count; n++)
+        {
+            const state_sample_t *s = &local[(head + STATE_RING_SAMPLES - count + n) % STATE_RING_SAMPLES];
+            cost_sum += s->sample_cost_us;
+            for (int i = 0; i < STATE_RING_TASKS; i++)
+            {
+                if (s->state[i] <= eDeleted)
+                    state_hist[i][s->state[i]]++;
+                if (s->stack_free_words[i] < min_stack[i])
+                    min_stack[i] = s->stack_free_words[i];
+            }
+        }
+
+        for (int i = 0; i < STATE_RING_TASKS; i++)
+        {
+            ESP_LOGI(TAG, "%s: Run=%lu Rdy=%lu Blk=%lu Sus=%lu | min stack %u bytes",
+                     tracked_names[i],
+                     state_hist[i][eRunning], state_hist[i][eReady],
+                     state_hist[i][eBlocked], state_hist[i][eSuspended],
+                     min_stack[i] * (unsigned)sizeof(StackType_t));
         }
+        ESP_LOGI(TAG, "Sample cost: %lu us avg (vs ms for a formatted dump)",
+                 cost_sum / count);
+        rlat_report();
     }
 }
 
@@ -282,6 +620,20 @@ void app_main(void)
     xTaskCreate(ready_state_demo_task, "ReadyDemo", 2048, NULL, 3, NULL);
     xTaskCreate(control_task, "Control", 3072, NULL, 4, &control_task_handle);
     xTaskCreate(system_monitor_task, "Monitor", 4096, NULL, 1, NULL);
+    xTaskCreate(state_sampler_task, "StateSampler", 2048, NULL, 5, NULL);
+    xTaskCreate(state_drain_task, "StateDrain", 3072, NULL, 1, NULL);
+
+    // Ready-latency roster: the emergency responder outranks everything
+    // else here, so its histogram is the deadline proof; StateDemo shows
+    // what the same wake looks like mid-pack.
+    xTaskCreate(emergency_task, "Emergency", 2048, NULL, 6, &emergency_task_handle);
+    rlat_emergency_id = rlat_register("Emergency", emergency_task_handle);
+    rlat_statedemo_id = rlat_register("StateDemo", state_demo_task_handle);
+
+    // Recycling pool: production job path. The create/delete tasks below
+    // stay as the counter-example the pool replaces.
+    worker_pool_init();
+    xTaskCreate(job_spawner_task, "JobSpawner", 2048, NULL, 2, NULL);
 
     static int self_delete_time = 10;
     TaskHandle_t ext_delete_handle = NULL;
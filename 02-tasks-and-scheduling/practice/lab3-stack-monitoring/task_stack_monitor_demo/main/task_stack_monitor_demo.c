@@ -6,6 +6,10 @@
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_cpu.h"
+#include "soc/soc_caps.h"
+#include "nvs_flash.h"
+#include "nvs.h"
 
 #define LED_OK GPIO_NUM_2
 #define LED_WARNING GPIO_NUM_4
@@ -19,43 +23,229 @@ TaskHandle_t light_task_handle = NULL;
 TaskHandle_t medium_task_handle = NULL;
 TaskHandle_t heavy_task_handle = NULL;
 
+// ===== Adaptive stack sizing =====
+// A single run's high-water mark is not enough to right-size a stack:
+// the worst path may only execute occasionally. Each task's worst
+// usage is therefore accumulated across reboots in NVS, and the
+// monitor periodically emits a ready-to-paste header of recommended
+// sizes (worst observed + 25% margin, rounded up to 256 bytes) so
+// stacks are provisioned from data instead of guesswork.
+#define STACK_NVS_NAMESPACE   "stacksize"
+#define STACK_SIZE_MARGIN_PCT 25
+#define STACK_SIZE_ROUND      256
+
+typedef struct {
+    const char *name;           // task + NVS key
+    const char *macro_name;     // emitted #define
+    uint32_t allocated_bytes;   // stack given at xTaskCreate
+    TaskHandle_t *handle;       // NULL = current task
+    uint32_t worst_used_bytes;      // this run
+    uint32_t historical_used_bytes; // max across runs, from NVS
+    uint32_t runs;                  // how many boots contributed
+} stack_record_t;
+
+static stack_record_t stack_records[] = {
+    { "LightTask",    "STACK_SIZE_LIGHT_TASK",   1024, &light_task_handle },
+    { "MediumTask",   "STACK_SIZE_MEDIUM_TASK",  2048, &medium_task_handle },
+    { "HeavyTask",    "STACK_SIZE_HEAVY_TASK",   2048, &heavy_task_handle },
+    { "StackMonitor", "STACK_SIZE_STACK_MONITOR", 4096, NULL },
+};
+#define STACK_RECORD_COUNT (sizeof(stack_records) / sizeof(stack_records[0]))
+
+static nvs_handle_t stack_nvs;
+static bool stack_nvs_ok = false;
+
+void stack_sizing_init(void)
+{
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK || nvs_open(STACK_NVS_NAMESPACE, NVS_READWRITE, &stack_nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS unavailable - stack history will not persist");
+        return;
+    }
+    stack_nvs_ok = true;
+
+    for (int i = 0; i < STACK_RECORD_COUNT; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "%.11s.hw", stack_records[i].name);
+        nvs_get_u32(stack_nvs, key, &stack_records[i].historical_used_bytes);
+        snprintf(key, sizeof(key), "%.11s.rn", stack_records[i].name);
+        nvs_get_u32(stack_nvs, key, &stack_records[i].runs);
+        if (stack_records[i].runs > 0)
+            ESP_LOGI(TAG, "History %s: %lu bytes worst over %lu runs",
+                     stack_records[i].name,
+                     stack_records[i].historical_used_bytes,
+                     stack_records[i].runs);
+    }
+}
+
+static void stack_sizing_persist(void)
+{
+    if (!stack_nvs_ok)
+        return;
+    bool dirty = false;
+    for (int i = 0; i < STACK_RECORD_COUNT; i++) {
+        stack_record_t *r = &stack_records[i];
+        if (r->worst_used_bytes > r->historical_used_bytes) {
+            r->historical_used_bytes = r->worst_used_bytes;
+            char key[16];
+            snprintf(key, sizeof(key), "%.11s.hw", r->name);
+            nvs_set_u32(stack_nvs, key, r->historical_used_bytes);
+            dirty = true;
+        }
+    }
+    if (dirty)
+        nvs_commit(stack_nvs);
+}
+
+static uint32_t recommended_stack_bytes(const stack_record_t *r)
+{
+    uint32_t worst = (r->historical_used_bytes > r->worst_used_bytes)
+                         ? r->historical_used_bytes : r->worst_used_bytes;
+    uint32_t with_margin = worst + (worst * STACK_SIZE_MARGIN_PCT) / 100;
+    return (with_margin + STACK_SIZE_ROUND - 1) & ~(STACK_SIZE_ROUND - 1);
+}
+
+// Emits the generated header on the console, ready to paste into the
+// build; on-device there is no better place to write it to.
+void emit_stack_size_header(void)
+{
+    ESP_LOGI(TAG, "── generated: stack_sizes.h ─────────────────────");
+    ESP_LOGI(TAG, "// Auto-generated from measured high-water marks.");
+    ESP_LOGI(TAG, "// Worst usage + %d%% margin, rounded to %d bytes.",
+             STACK_SIZE_MARGIN_PCT, STACK_SIZE_ROUND);
+    int32_t saved = 0;
+    for (int i = 0; i < STACK_RECORD_COUNT; i++) {
+        uint32_t rec = recommended_stack_bytes(&stack_records[i]);
+        ESP_LOGI(TAG, "#define %-26s %lu   // now %lu",
+                 stack_records[i].macro_name, rec, stack_records[i].allocated_bytes);
+        saved += (int32_t)stack_records[i].allocated_bytes - (int32_t)rec;
+    }
+    ESP_LOGI(TAG, "// RAM saved if applied: %ld bytes", saved);
+    ESP_LOGI(TAG, "─────────────────────────────────────────────────");
+}
+
+// ===== Binary-search watermark scanning =====
+// uxTaskGetStackHighWaterMark walks the painted region linearly from
+// the stack's lowest address, one word at a time — with many tasks on
+// a tight poll that is real CPU spent looking at paint. The painted
+// region has a single transition: everything below the deepest stack
+// excursion is still fill pattern, everything from it upward has been
+// overwritten. That boundary is found here by binary search in
+// O(log n) probes instead of O(n) reads. A probe checks a short run of
+// words rather than one, because a live frame can coincidentally
+// contain the fill pattern; requiring BSW_PROBE_WORDS consecutive
+// painted words makes a false "still painted" verdict vanishingly
+// unlikely. (The kernel's linear scan has the mirror-image weakness:
+// it stops at the first dirty-looking word.)
+#define BSW_PAINT_WORD   0xA5A5A5A5u   // tskSTACK_FILL_BYTE replicated
+#define BSW_PROBE_WORDS  8
+
+static bool bsw_painted(const StackType_t *words, uint32_t total, uint32_t i)
+{
+    uint32_t run = BSW_PROBE_WORDS;
+    if (i + run > total)
+        run = total - i;
+    for (uint32_t k = 0; k < run; k++)
+        if (words[i + k] != (StackType_t)BSW_PAINT_WORD)
+            return false;
+    return true;
+}
+
+// Free bytes at the deepest excursion so far; same answer as
+// uxTaskGetStackHighWaterMark * sizeof(StackType_t), in O(log) probes.
+// `stack_bytes` is the size the stack was created with — the kernel
+// knows it, but does not export it, and this lab tracks it anyway.
+static uint32_t stack_watermark_fast(TaskHandle_t task, uint32_t stack_bytes)
+{
+    const StackType_t *words = (const StackType_t *)pxTaskGetStackStart(task);
+    uint32_t total = stack_bytes / sizeof(StackType_t);
+    if (words == NULL || total == 0 || !bsw_painted(words, total, 0))
+        return 0;
+
+    // Invariant: lo is painted, hi is dirty (or one past the end).
+    uint32_t lo = 0, hi = total;
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (bsw_painted(words, total, mid))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return hi * sizeof(StackType_t);
+}
+
+void stack_guard_report(void);
+
 void stack_monitor_task(void *pvParameters)
 {
     ESP_LOGI(TAG, "Stack Monitor Task started");
+    int report = 0;
+
+    if (stack_nvs_ok) {
+        // Count this boot once per record
+        for (int i = 0; i < STACK_RECORD_COUNT; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "%.11s.rn", stack_records[i].name);
+            nvs_set_u32(stack_nvs, key, ++stack_records[i].runs);
+        }
+        nvs_commit(stack_nvs);
+    }
 
     while (1) {
+        report++;
         ESP_LOGI(TAG, "\n=== STACK USAGE REPORT ===");
 
-        TaskHandle_t tasks[] = {
-            light_task_handle,
-            medium_task_handle,
-            heavy_task_handle,
-            xTaskGetCurrentTaskHandle()
-        };
-
-        const char *task_names[] = {
-            "LightTask", "MediumTask", "HeavyTask", "StackMonitor"
-        };
-
         bool stack_warning = false;
         bool stack_critical = false;
 
-        for (int i = 0; i < 4; i++) {
-            if (tasks[i] != NULL) {
-                UBaseType_t stack_remaining = uxTaskGetStackHighWaterMark(tasks[i]);
-                uint32_t stack_bytes = stack_remaining * sizeof(StackType_t);
-                ESP_LOGI(TAG, "%s: %d bytes remaining", task_names[i], stack_bytes);
+        for (int i = 0; i < STACK_RECORD_COUNT; i++) {
+            stack_record_t *r = &stack_records[i];
+            TaskHandle_t h = r->handle ? *r->handle : xTaskGetCurrentTaskHandle();
+            if (h != NULL) {
+                uint32_t t0 = esp_cpu_get_cycle_count();
+                uint32_t stack_bytes = stack_watermark_fast(h, r->allocated_bytes);
+                uint32_t binary_cycles = esp_cpu_get_cycle_count() - t0;
+                uint32_t used = r->allocated_bytes - stack_bytes;
+                if (used > r->worst_used_bytes)
+                    r->worst_used_bytes = used;
+
+                ESP_LOGI(TAG, "%s: %lu bytes remaining (worst used %lu/%lu)",
+                         r->name, stack_bytes, r->worst_used_bytes, r->allocated_bytes);
+
+                // Cross-check against the kernel's linear scan now and
+                // then; the cycle pair shows what the poll loop saves.
+                if (report % 10 == 0) {
+                    t0 = esp_cpu_get_cycle_count();
+                    uint32_t linear_bytes =
+                        uxTaskGetStackHighWaterMark(h) * sizeof(StackType_t);
+                    uint32_t linear_cycles = esp_cpu_get_cycle_count() - t0;
+                    ESP_LOGI(TAG, "  scan: binary %lu cyc vs linear %lu cyc (%s)",
+                             binary_cycles, linear_cycles,
+                             stack_bytes == linear_bytes ? "agree" : "DIFFER");
+                }
 
                 if (stack_bytes < STACK_CRITICAL_THRESHOLD) {
-                    ESP_LOGE(TAG, "CRITICAL: %s stack very low!", task_names[i]);
+                    ESP_LOGE(TAG, "CRITICAL: %s stack very low!", r->name);
                     stack_critical = true;
                 } else if (stack_bytes < STACK_WARNING_THRESHOLD) {
-                    ESP_LOGW(TAG, "WARNING: %s stack low", task_names[i]);
+                    ESP_LOGW(TAG, "WARNING: %s stack low", r->name);
                     stack_warning = true;
                 }
             }
         }
 
+        stack_guard_report();
+
+        // Persist growth and regenerate the header every 10th report
+        if (report % 10 == 0) {
+            stack_sizing_persist();
+            emit_stack_size_header();
+        }
+
         if (stack_critical) {
             for (int i = 0; i < 6; i++) {
                 gpio_set_level(LED_WARNING, 1);
@@ -156,6 +346,103 @@ void optimized_heavy_task(void *pvParameters)
     }
 }
 
+// ===== Hardware stack guards =====
+// Everything above detects overflow AFTER the fact: the overflow hook
+// fires once the canary is already corrupted, and the monitor only sees
+// damage on its next 3-second poll. A debug watchpoint armed on the
+// lowest bytes of a task's stack traps at the exact faulting store -
+// before a single byte of the neighbor's memory is eaten - and costs
+// nothing in steady state. Watchpoints are scarce (2 per core on ESP32)
+// and per-core, so a task arms its own guard from inside itself on
+// whatever core it runs on; tasks that don't get one fall back to the
+// high-water-mark polling that already runs.
+#define GUARD_REGION_BYTES 64            // power of two, aligned below
+#define GUARD_WATCHPOINT   1             // 0 is reserved for IDF's own use
+#define GUARD_SLOTS        2             // one per core at our index
+
+typedef struct {
+    const char *name;
+    void *guard_addr;
+    int core;
+} stack_guard_t;
+
+static stack_guard_t stack_guards[GUARD_SLOTS];
+static int stack_guard_count = 0;
+
+// Must be called from the task being guarded: the watchpoint registers
+// belong to the core the caller is running on.
+bool stack_guard_arm(const char *name, void *stack_lowest)
+{
+    int core = xPortGetCoreID();
+    for (int i = 0; i < stack_guard_count; i++) {
+        if (stack_guards[i].core == core) {
+            ESP_LOGW(TAG, "Guard slot on core %d already taken - %s stays on polling",
+                     core, name);
+            return false;
+        }
+    }
+    esp_err_t err = esp_cpu_set_watchpoint(GUARD_WATCHPOINT, stack_lowest,
+                                           GUARD_REGION_BYTES,
+                                           ESP_CPU_WATCHPOINT_STORE);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Watchpoint arm failed for %s (%d) - falling back to polling",
+                 name, err);
+        return false;
+    }
+    stack_guards[stack_guard_count++] = (stack_guard_t){
+        .name = name, .guard_addr = stack_lowest, .core = core,
+    };
+    ESP_LOGI(TAG, "🛡️ HW guard armed: %s, %d bytes at %p on core %d",
+             name, GUARD_REGION_BYTES, stack_lowest, core);
+    return true;
+}
+
+void stack_guard_report(void)
+{
+    for (int i = 0; i < stack_guard_count; i++) {
+        ESP_LOGI(TAG, "HW guard: %s @%p core%d (%d B, traps on store)",
+                 stack_guards[i].name, stack_guards[i].guard_addr,
+                 stack_guards[i].core, GUARD_REGION_BYTES);
+    }
+    if (stack_guard_count == 0)
+        ESP_LOGI(TAG, "HW guards: none armed - all tasks on polling fallback");
+}
+
+// Static stack so the lowest address is known; aligned so the guard
+// region satisfies the watchpoint's alignment rule.
+#define GUARDED_STACK_WORDS 2048
+static StackType_t guarded_stack[GUARDED_STACK_WORDS]
+    __attribute__((aligned(GUARD_REGION_BYTES)));
+static StaticTask_t guarded_tcb;
+
+// Burns stack depth-first toward the guard without reaching it, to show
+// steady-state cost is zero while the trap stays armed.
+static uint32_t guarded_descend(int depth)
+{
+    volatile char frame[128];
+    frame[0] = (char)depth;
+    if (depth > 0)
+        return frame[0] + guarded_descend(depth - 1);
+    return uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+}
+
+void guarded_demo_task(void *pvParameters)
+{
+    // Arm on our own core; the guard covers the bottom of our stack.
+    stack_guard_arm("GuardDemo", guarded_stack);
+
+    int cycle = 0;
+    while (1) {
+        cycle++;
+        // ~2 KB of frames against an 8 KB stack: deep but legal. One
+        // more zero and the first store past the guard line would trap
+        // with the faulting PC, not a post-mortem canary message.
+        uint32_t remaining = guarded_descend(12 + (cycle % 4));
+        ESP_LOGI(TAG, "Guarded task cycle %d: worst remaining %lu bytes", cycle, remaining);
+        vTaskDelay(pdMS_TO_TICKS(5000));
+    }
+}
+
 void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
 {
     ESP_LOGE("STACK_OVERFLOW", "Task %s overflowed its stack!", pcTaskName);
@@ -182,9 +469,12 @@ void app_main(void)
     gpio_config(&io_conf);
 
     ESP_LOGI(TAG, "GPIO2 = OK, GPIO4 = WARNING");
+    stack_sizing_init();
     xTaskCreate(light_stack_task, "LightTask", 1024, NULL, 2, &light_task_handle);
     xTaskCreate(medium_stack_task, "MediumTask", 2048, NULL, 2, &medium_task_handle);
     xTaskCreate(heavy_stack_task, "HeavyTask", 2048, NULL, 2, &heavy_task_handle);
     xTaskCreate(optimized_heavy_task, "OptHeavy", 3072, NULL, 2, NULL);
     xTaskCreate(stack_monitor_task, "StackMonitor", 4096, NULL, 3, NULL);
+    xTaskCreateStatic(guarded_demo_task, "GuardDemo", GUARDED_STACK_WORDS,
+                      NULL, 2, guarded_stack, &guarded_tcb);
 }
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_crc.h"
 #include "driver/gpio.h"
 
 static const char *TAG = "QUEUE_LAB";
@@ -21,8 +25,280 @@ typedef struct {
     int id;
     char message[50];
     uint32_t timestamp;
+    uint32_t checksum;    // over everything above, kernel set per queue
 } queue_message_t;
 
+// ---------------------------------------------------------------------------
+// Checksum kernels
+//
+// The byte-at-a-time loop is the baseline; the word kernel loads 32 bits
+// per iteration and keeps two masked lane accumulators (folded before the
+// 16-bit lanes can overflow), and the CRC32 option rides the IDF's
+// ROM-backed esp_crc32_le. Which kernel guards a queue is a per-queue
+// choice — CRC catches reordered bytes that any sum misses, at a higher
+// cost per frame.
+// ---------------------------------------------------------------------------
+typedef enum {
+    CHECKSUM_SCALAR = 0,   // byte loop, reference implementation
+    CHECKSUM_WORDS,        // word-at-a-time byte sum, same value as scalar
+    CHECKSUM_CRC32,        // different value space, strongest check
+} checksum_kind_t;
+
+static checksum_kind_t xqueue_checksum_kind = CHECKSUM_WORDS;
+
+static uint32_t checksum_scalar(const uint8_t *data, size_t len)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+static uint32_t checksum_words(const uint8_t *data, size_t len)
+{
+    uint32_t sum = 0;
+    while (len && ((uintptr_t)data & 3)) {   // align to word loads
+        sum += *data++;
+        len--;
+    }
+
+    const uint32_t *w = (const uint32_t *)data;
+    size_t words = len / 4;
+    while (words) {
+        // 64 words per chunk keeps each 16-bit lane below 64 * 255.
+        size_t chunk = words > 64 ? 64 : words;
+        uint32_t even = 0, odd = 0;
+        for (size_t i = 0; i < chunk; i++) {
+            uint32_t v = *w++;
+            even += v & 0x00FF00FFu;
+            odd  += (v >> 8) & 0x00FF00FFu;
+        }
+        sum += (even & 0xFFFF) + (even >> 16) + (odd & 0xFFFF) + (odd >> 16);
+        words -= chunk;
+    }
+
+    const uint8_t *tail = (const uint8_t *)w;
+    for (size_t i = 0; i < (len & 3); i++) {
+        sum += tail[i];
+    }
+    return sum;
+}
+
+static uint32_t frame_checksum(checksum_kind_t kind, const void *data, size_t len)
+{
+    switch (kind) {
+        case CHECKSUM_WORDS: return checksum_words(data, len);
+        case CHECKSUM_CRC32: return esp_crc32_le(0, data, len);
+        default:             return checksum_scalar(data, len);
+    }
+}
+
+// Cost comparison over a 1.5 KB frame, reported in bytes per cycle.
+void checksum_benchmark_task(void *pvParameters)
+{
+    enum { FRAME_LEN = 1536, PASSES = 200 };
+    static uint8_t frame[FRAME_LEN];
+    static const char *names[] = {"scalar", "words", "crc32"};
+
+    for (int i = 0; i < FRAME_LEN; i++) {
+        frame[i] = (uint8_t)(i * 31);
+    }
+
+    ESP_LOGI(TAG, "=== Checksum Benchmark (%d-byte frames) ===", FRAME_LEN);
+    uint32_t baseline = 0;
+    for (int k = CHECKSUM_SCALAR; k <= CHECKSUM_CRC32; k++) {
+        volatile uint32_t sink = 0;
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        for (int i = 0; i < PASSES; i++) {
+            sink = frame_checksum(k, frame, FRAME_LEN);
+        }
+        uint32_t cycles = (esp_cpu_get_cycle_count() - t0) / PASSES;
+        (void)sink;
+        if (k == CHECKSUM_SCALAR) baseline = cycles;
+        ESP_LOGI(TAG, "%-6s: %5lu cycles/frame, %.2f bytes/cycle, %.2fx scalar",
+                 names[k], cycles, (float)FRAME_LEN / cycles,
+                 cycles ? (float)baseline / cycles : 0);
+    }
+    ESP_LOGI(TAG, "=== Checksum benchmark done ===");
+    vTaskDelete(NULL);
+}
+
+// ---------------------------------------------------------------------------
+// Burst (batched) queue API
+//
+// One xQueueSend per item pays a full scheduler round-trip each time: the
+// receiver is made ready, preempts, drains one item and blocks again. The
+// burst helpers move N items while the scheduler is suspended, so the
+// receiver is woken exactly once per burst instead of once per item.
+// ---------------------------------------------------------------------------
+
+// Send up to n items; returns how many actually fit.
+int queue_send_burst(QueueHandle_t queue, const queue_message_t *items, int n)
+{
+    int sent = 0;
+    vTaskSuspendAll();
+    while (sent < n && xQueueSend(queue, &items[sent], 0) == pdPASS) {
+        sent++;
+    }
+    xTaskResumeAll();   // receiver wakes once, sees the whole burst
+    return sent;
+}
+
+// Block up to `timeout` for the first item, then drain opportunistically.
+int queue_receive_burst(QueueHandle_t queue, queue_message_t *buf, int max,
+                        TickType_t timeout)
+{
+    if (max <= 0) {
+        return 0;
+    }
+    if (xQueueReceive(queue, &buf[0], timeout) != pdPASS) {
+        return 0;
+    }
+    int received = 1;
+    vTaskSuspendAll();
+    while (received < max && xQueueReceive(queue, &buf[received], 0) == pdPASS) {
+        received++;
+    }
+    xTaskResumeAll();
+    return received;
+}
+
+// Throughput benchmark: same payload, batch sizes 1 / 8 / 32.
+void burst_benchmark_task(void *pvParameters)
+{
+    const int TOTAL_ITEMS = 4096;
+    const int batch_sizes[] = {1, 8, 32};
+    static queue_message_t batch[32];
+
+    QueueHandle_t bench_queue = xQueueCreate(32, sizeof(queue_message_t));
+    if (bench_queue == NULL) {
+        ESP_LOGE(TAG, "Burst benchmark: queue creation failed");
+        vTaskDelete(NULL);
+    }
+    memset(batch, 0, sizeof(batch));
+
+    ESP_LOGI(TAG, "=== Burst API Benchmark (%d items each) ===", TOTAL_ITEMS);
+
+    for (int b = 0; b < 3; b++) {
+        int batch_size = batch_sizes[b];
+        int moved = 0;
+        int64_t start = esp_timer_get_time();
+        while (moved < TOTAL_ITEMS) {
+            queue_send_burst(bench_queue, batch, batch_size);
+            queue_receive_burst(bench_queue, batch, batch_size, 0);
+            moved += batch_size;
+        }
+        int64_t elapsed_us = esp_timer_get_time() - start;
+        ESP_LOGI(TAG, "Batch %2d: %lld us total → %lld items/sec",
+                 batch_size, elapsed_us,
+                 elapsed_us ? (int64_t)moved * 1000000 / elapsed_us : 0);
+    }
+
+    ESP_LOGI(TAG, "=== Burst benchmark done ===");
+    vQueueDelete(bench_queue);
+    vTaskDelete(NULL);
+}
+
+// ---------------------------------------------------------------------------
+// Mailbox mode (latest value only)
+//
+// A display consumer never wants the backlog — only the freshest sample.
+// The mailbox is a length-1 queue written with xQueueOverwrite, so the
+// producer never blocks and stale values are replaced in place instead of
+// occupying slots. A sequence counter in the payload lets the reader see
+// exactly how many samples it skipped.
+// ---------------------------------------------------------------------------
+typedef struct {
+    uint32_t sequence;
+    float value;
+    uint32_t timestamp;
+} mailbox_sample_t;
+
+static QueueHandle_t xMailbox;   // length 1, xQueueOverwrite only
+
+void mailbox_producer_task(void *pvParameters)
+{
+    mailbox_sample_t sample = {0};
+    while (1) {
+        sample.sequence++;
+        sample.value = 25.0f + (sample.sequence % 100) / 10.0f;
+        sample.timestamp = xTaskGetTickCount();
+        xQueueOverwrite(xMailbox, &sample);   // never blocks, never fails
+        vTaskDelay(pdMS_TO_TICKS(50));        // 20 Hz producer
+    }
+}
+
+void mailbox_display_task(void *pvParameters)
+{
+    mailbox_sample_t sample;
+    uint32_t last_sequence = 0;
+    uint32_t total_skipped = 0;
+
+    while (1) {
+        // Peek keeps the value in place so the next read still sees the
+        // latest sample even if the producer stalls.
+        if (xQueuePeek(xMailbox, &sample, pdMS_TO_TICKS(2000)) == pdPASS) {
+            uint32_t skipped = sample.sequence - last_sequence - 1;
+            if (sample.sequence != last_sequence) {
+                total_skipped += skipped;
+                ESP_LOGI(TAG, "Display: seq=%lu value=%.1f (skipped %lu, total %lu)",
+                         sample.sequence, sample.value, skipped, total_skipped);
+                last_sequence = sample.sequence;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(1000));      // 1 Hz consumer
+    }
+}
+
+// Receive-side latency with the producer outrunning the consumer: a full
+// FIFO makes the reader chew through stale entries to reach the newest,
+// while the mailbox hands it over in one receive.
+void mailbox_benchmark_task(void *pvParameters)
+{
+    enum { BACKLOG = 32, PASSES = 100 };
+    mailbox_sample_t sample = {0};
+
+    QueueHandle_t fifo = xQueueCreate(BACKLOG, sizeof(mailbox_sample_t));
+    QueueHandle_t mailbox = xQueueCreate(1, sizeof(mailbox_sample_t));
+    if (fifo == NULL || mailbox == NULL) {
+        ESP_LOGE(TAG, "Mailbox benchmark: queue creation failed");
+        vTaskDelete(NULL);
+    }
+
+    ESP_LOGI(TAG, "=== Mailbox Benchmark (%d-deep backlog) ===", BACKLOG);
+
+    uint32_t fifo_cycles = 0, mailbox_cycles = 0;
+    for (int pass = 0; pass < PASSES; pass++) {
+        // Producer outran the consumer by BACKLOG samples.
+        for (int i = 0; i < BACKLOG; i++) {
+            sample.sequence++;
+            xQueueSend(fifo, &sample, 0);
+            xQueueOverwrite(mailbox, &sample);
+        }
+
+        // FIFO reader: drain everything to reach the latest.
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        while (xQueueReceive(fifo, &sample, 0) == pdPASS) {}
+        fifo_cycles += esp_cpu_get_cycle_count() - t0;
+
+        // Mailbox reader: one receive, already the latest.
+        t0 = esp_cpu_get_cycle_count();
+        xQueueReceive(mailbox, &sample, 0);
+        mailbox_cycles += esp_cpu_get_cycle_count() - t0;
+    }
+
+    ESP_LOGI(TAG, "FIFO drain:  %lu cycles to reach latest", fifo_cycles / PASSES);
+    ESP_LOGI(TAG, "Mailbox:     %lu cycles to reach latest (%.1fx faster)",
+             mailbox_cycles / PASSES,
+             mailbox_cycles ? (float)fifo_cycles / mailbox_cycles : 0);
+    ESP_LOGI(TAG, "=== Mailbox benchmark done ===");
+
+    vQueueDelete(fifo);
+    vQueueDelete(mailbox);
+    vTaskDelete(NULL);
+}
+
 // Sender Task
 void sender_task(void *pvParameters)
 {
@@ -35,6 +311,8 @@ void sender_task(void *pvParameters)
         snprintf(message.message, sizeof(message.message),
                  "Hello from sender #%d", message.id);
         message.timestamp = xTaskGetTickCount();
+        message.checksum = frame_checksum(xqueue_checksum_kind, &message,
+                                          offsetof(queue_message_t, checksum));
 
         BaseType_t status = xQueueSend(xQueue, &message, pdMS_TO_TICKS(1000));
 
@@ -62,6 +340,12 @@ void receiver_task(void *pvParameters)
         BaseType_t status = xQueueReceive(xQueue, &received_message, pdMS_TO_TICKS(5000));
 
         if (status == pdPASS) {
+            uint32_t expect = frame_checksum(xqueue_checksum_kind, &received_message,
+                                             offsetof(queue_message_t, checksum));
+            if (expect != received_message.checksum) {
+                ESP_LOGE(TAG, "Checksum mismatch on ID=%d (got %08lx, want %08lx)",
+                         received_message.id, received_message.checksum, expect);
+            }
             ESP_LOGI(TAG, "Received ← ID=%d | MSG=%s | Time=%lu",
                      received_message.id,
                      received_message.message,
@@ -118,10 +402,22 @@ void app_main(void)
 
     ESP_LOGI(TAG, "Queue created successfully (5 messages capacity)");
 
+    // Mailbox: length 1, overwrite semantics
+    xMailbox = xQueueCreate(1, sizeof(mailbox_sample_t));
+    if (xMailbox == NULL) {
+        ESP_LOGE(TAG, "Failed to create mailbox!");
+        return;
+    }
+
     // Create tasks
     xTaskCreate(sender_task, "Sender", 2048, NULL, 2, NULL);
     xTaskCreate(receiver_task, "Receiver", 2048, NULL, 1, NULL);
     xTaskCreate(queue_monitor_task, "Monitor", 2048, NULL, 1, NULL);
+    xTaskCreate(burst_benchmark_task, "BurstBench", 4096, NULL, 3, NULL);
+    xTaskCreate(checksum_benchmark_task, "CsumBench", 3072, NULL, 3, NULL);
+    xTaskCreate(mailbox_producer_task, "MboxProd", 2048, NULL, 2, NULL);
+    xTaskCreate(mailbox_display_task, "MboxDisp", 2048, NULL, 1, NULL);
+    xTaskCreate(mailbox_benchmark_task, "MboxBench", 3072, NULL, 3, NULL);
 
     ESP_LOGI(TAG, "All tasks created. Queue demo running...");
 }
\ No newline at end of file
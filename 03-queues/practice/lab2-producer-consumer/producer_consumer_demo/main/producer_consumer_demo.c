@@ -1,14 +1,24 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
 #include "esp_log.h"
 #include "esp_random.h"
+#include "esp_timer.h"
+#include "telemetry_codec.h"
+#include "queue_registry.h"
+#include "fastfmt.h"
+#include "dvfs_gov.h"
 
 static const char *TAG = "PROD_CONS";
 
@@ -22,13 +32,130 @@ static const char *TAG = "PROD_CONS";
 QueueHandle_t xProductQueue;
 SemaphoreHandle_t xPrintMutex;
 
+// Registry ids for the queues this lab owns; producers report blocked
+// time against them and the stats task prints the pressure dashboard.
+static int qreg_product_id = -1;
+static int qreg_ptr_id = -1;
+static int qreg_free_id = -1;
+
+static void queue_pressure_alarm(const char *name, uint8_t depth, uint8_t capacity) {
+    ESP_LOGW(TAG, "🚨 Queue '%s' at %u/%u — backpressure imminent", name, depth, capacity);
+}
+
+// Transport selection: producer/consumer pairs can use either the classic
+// FreeRTOS queue or a lock-free SPSC ring (single producer, single consumer).
+typedef enum {
+    TRANSPORT_FREERTOS_QUEUE = 0,
+    TRANSPORT_SPSC_RING,
+    TRANSPORT_PTR_QUEUE,   // zero-copy: queue carries product_t* into a slot pool
+} transport_t;
+
+typedef struct {
+    int id;
+    transport_t transport;
+} worker_params_t;
+
 typedef struct {
     uint32_t produced;
     uint32_t consumed;
     uint32_t dropped;
 } stats_t;
 
-stats_t global_stats = {0, 0, 0};
+// Per-task padded counter blocks.
+//
+// A single shared stats_t updated by every producer and consumer bounces
+// its cache line between the cores on each increment. Each task instead
+// owns a cache-line-aligned block of relaxed atomics (producers in slots
+// 0-2, consumers in 3-5, elastic consumers in 6-7), so the counting hot
+// path touches only lines no other core writes; statistics_task
+// aggregates the slots when it reads.
+#define STAT_SLOTS 8
+
+typedef struct {
+    _Alignas(64) atomic_uint_fast32_t produced;
+    atomic_uint_fast32_t consumed;
+    atomic_uint_fast32_t dropped;
+} task_stats_t;
+
+static task_stats_t task_stats[STAT_SLOTS];
+
+static inline int producer_slot(int id) { return id - 1; }
+static inline int consumer_slot(int id) { return 3 + id - 1; }
+static inline int elastic_slot(int id)  { return 6 + id; }
+
+static inline void stat_bump(atomic_uint_fast32_t *counter) {
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static stats_t aggregate_stats(void) {
+    stats_t total = {0, 0, 0};
+    for (int i = 0; i < STAT_SLOTS; i++) {
+        total.produced += atomic_load_explicit(&task_stats[i].produced, memory_order_relaxed);
+        total.consumed += atomic_load_explicit(&task_stats[i].consumed, memory_order_relaxed);
+        total.dropped  += atomic_load_explicit(&task_stats[i].dropped, memory_order_relaxed);
+    }
+    return total;
+}
+
+// Serialized console output; defined with the worker tasks below.
+void safe_printf(const char* format, ...);
+
+// Shared-line vs padded-slot counter throughput, one bumper per core.
+typedef struct {
+    atomic_uint_fast32_t *counter;
+    uint32_t iterations;
+    SemaphoreHandle_t done_sem;
+} stats_bench_params_t;
+
+static void stats_bench_worker(void *pvParameters) {
+    stats_bench_params_t *p = (stats_bench_params_t *)pvParameters;
+    for (uint32_t i = 0; i < p->iterations; i++) {
+        atomic_fetch_add_explicit(p->counter, 1, memory_order_relaxed);
+    }
+    xSemaphoreGive(p->done_sem);
+    vTaskDelete(NULL);
+}
+
+void stats_layout_benchmark_task(void *pvParameters) {
+    enum { ITERATIONS = 200000 };
+    static struct {
+        atomic_uint_fast32_t a;
+        atomic_uint_fast32_t b;            // same cache line as a
+    } shared;
+    static struct {
+        _Alignas(64) atomic_uint_fast32_t a;
+        _Alignas(64) atomic_uint_fast32_t b;  // own line
+    } padded;
+    static stats_bench_params_t params[2];
+    SemaphoreHandle_t done_sem = xSemaphoreCreateCounting(2, 0);
+    int64_t elapsed[2];
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    safe_printf("\n═══ STATS LAYOUT BENCHMARK (%d increments/core) ═══\n", ITERATIONS);
+
+    for (int run = 0; run < 2; run++) {
+        params[0].counter = run == 0 ? &shared.a : &padded.a;
+        params[1].counter = run == 0 ? &shared.b : &padded.b;
+        for (int i = 0; i < 2; i++) {
+            params[i].iterations = ITERATIONS;
+            params[i].done_sem = done_sem;
+        }
+        int64_t start = esp_timer_get_time();
+        xTaskCreatePinnedToCore(stats_bench_worker, "StatB0", 2048, &params[0], 9, NULL, 0);
+        xTaskCreatePinnedToCore(stats_bench_worker, "StatB1", 2048, &params[1], 9, NULL, 1);
+        xSemaphoreTake(done_sem, portMAX_DELAY);
+        xSemaphoreTake(done_sem, portMAX_DELAY);
+        elapsed[run] = esp_timer_get_time() - start;
+    }
+
+    safe_printf("Shared line: %lld us\n", elapsed[0]);
+    safe_printf("Padded:      %lld us (%.2fx faster)\n",
+                elapsed[1], elapsed[1] ? (float)elapsed[0] / elapsed[1] : 0);
+    safe_printf("═══════════════════════════\n\n");
+
+    vSemaphoreDelete(done_sem);
+    vTaskDelete(NULL);
+}
 
 typedef struct {
     int producer_id;
@@ -38,6 +165,290 @@ typedef struct {
     int processing_time_ms;
 } product_t;
 
+// Lock-free SPSC ring buffer.
+// Head is only written by the consumer, tail only by the producer, so a
+// release store on the writer side paired with an acquire load on the reader
+// side is all the synchronization needed - no critical section at all.
+// Head and tail live on separate cache lines to avoid false sharing.
+#define SPSC_RING_SIZE 16  // power of two
+
+typedef struct {
+    product_t slots[SPSC_RING_SIZE];
+    _Alignas(64) atomic_uint_fast32_t tail;  // next slot to write (producer)
+    _Alignas(64) atomic_uint_fast32_t head;  // next slot to read (consumer)
+} spsc_ring_t;
+
+static spsc_ring_t product_ring;
+
+static bool spsc_push(spsc_ring_t *ring, const product_t *item) {
+    uint_fast32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head >= SPSC_RING_SIZE) {
+        return false;  // full
+    }
+    ring->slots[tail & (SPSC_RING_SIZE - 1)] = *item;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+static bool spsc_pop(spsc_ring_t *ring, product_t *item) {
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint_fast32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) {
+        return false;  // empty
+    }
+    *item = ring->slots[head & (SPSC_RING_SIZE - 1)];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+// Burst enqueue, for ISR producers that post many records at once.
+//
+// xQueueSendFromISR takes the port critical section per item, so a
+// 12-record DMA-complete burst pays for twelve locked kernel calls. On
+// the SPSC ring the burst needs no critical section at all: reserve the
+// span once, fill the slots with plain stores, publish everything with a
+// single release store on tail, and make one wake decision for the whole
+// burst. Per-item ISR cost collapses to the stores that fill the slot.
+// Returns how many slots were granted (possibly fewer than asked).
+static inline int spsc_reserve(spsc_ring_t *ring, int want, uint_fast32_t *pos) {
+    uint_fast32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint_fast32_t room = SPSC_RING_SIZE - (tail - head);
+    *pos = tail;
+    return (uint_fast32_t)want <= room ? want : (int)room;
+}
+
+static inline product_t* spsc_burst_slot(spsc_ring_t *ring, uint_fast32_t pos, int i) {
+    return &ring->slots[(pos + i) & (SPSC_RING_SIZE - 1)];
+}
+
+// Publishes n filled slots; the consumer sees none of them until this.
+static inline void spsc_commit(spsc_ring_t *ring, uint_fast32_t pos, int n) {
+    atomic_store_explicit(&ring->tail, pos + n, memory_order_release);
+}
+
+// Zero-copy mode: instead of copying a full product_t into the queue and
+// back out again (two memcpy's per message), producers enqueue a pointer to
+// a slot in a fixed pool and consumers hand the slot back when done. The
+// free list is itself a queue of pointers, so slot acquire/release blocks
+// cleanly when the pool is exhausted.
+#define PRODUCT_POOL_SLOTS 12
+
+static product_t product_pool[PRODUCT_POOL_SLOTS];
+QueueHandle_t xProductPtrQueue;   // in-flight product_t* (producer -> consumer)
+QueueHandle_t xFreeSlotQueue;     // recycled product_t* (consumer -> producer)
+
+static product_t* pool_acquire_slot(TickType_t timeout) {
+    product_t *slot = NULL;
+    xQueueReceive(xFreeSlotQueue, &slot, timeout);
+    return slot;
+}
+
+static void pool_release_slot(product_t *slot) {
+    // Cannot fail: the free queue is as deep as the pool.
+    xQueueSend(xFreeSlotQueue, &slot, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Variable-length byte ring
+//
+// Every product_t slot reserves the full struct even when the payload is
+// a few bytes, so a channel carrying 8-byte heartbeats next to 1 KB
+// blobs has to size everything for the blob. The byte ring packs
+// length-prefixed records densely instead: one memcpy in, one memcpy
+// out, SPSC like the slot ring above. A record never wraps mid-payload —
+// if it would not fit before the end of the buffer, the writer drops a
+// wrap marker and restarts at offset zero, so both copies stay
+// contiguous.
+// ---------------------------------------------------------------------------
+#define VRING_SIZE     4096   // power of two
+#define VRING_WRAP     0xFFFF // length marker: rest of buffer is skipped
+#define VRING_MAX_MSG  (VRING_SIZE / 2 - 2)
+
+typedef struct {
+    uint8_t bytes[VRING_SIZE];
+    _Alignas(64) atomic_uint_fast32_t tail;  // producer
+    _Alignas(64) atomic_uint_fast32_t head;  // consumer
+} vring_t;
+
+static bool vring_send(vring_t *ring, const void *data, uint16_t len) {
+    if (len > VRING_MAX_MSG) {
+        return false;
+    }
+    uint_fast32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    uint32_t offset = tail & (VRING_SIZE - 1);
+    uint32_t to_end = VRING_SIZE - offset;
+    uint32_t need = 2u + len;
+    uint32_t skip = (to_end < need) ? to_end : 0;
+
+    if (VRING_SIZE - (tail - head) < skip + need) {
+        return false;   // not enough free space
+    }
+
+    if (skip) {
+        if (to_end >= 2) {
+            // Tell the reader the rest of this lap is dead space.
+            ring->bytes[offset] = VRING_WRAP & 0xFF;
+            ring->bytes[offset + 1] = VRING_WRAP >> 8;
+        }
+        tail += skip;   // < 2 bytes left: reader skips by the same rule
+        offset = 0;
+    }
+
+    ring->bytes[offset] = len & 0xFF;
+    ring->bytes[offset + 1] = len >> 8;
+    memcpy(&ring->bytes[offset + 2], data, len);
+    atomic_store_explicit(&ring->tail, tail + need, memory_order_release);
+    return true;
+}
+
+// Returns the record length, 0 when empty, -1 when `max` is too small
+// (the record stays queued).
+static int vring_recv(vring_t *ring, void *buf, uint16_t max) {
+    uint_fast32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint_fast32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    while (1) {
+        if (head == tail) {
+            return 0;
+        }
+        uint32_t offset = head & (VRING_SIZE - 1);
+        uint32_t to_end = VRING_SIZE - offset;
+        if (to_end < 2) {
+            head += to_end;   // implicit wrap, mirrors the writer
+            continue;
+        }
+        uint16_t len = ring->bytes[offset] | (ring->bytes[offset + 1] << 8);
+        if (len == VRING_WRAP) {
+            head += to_end;
+            continue;
+        }
+        if (len > max) {
+            atomic_store_explicit(&ring->head, head, memory_order_release);
+            return -1;
+        }
+        memcpy(buf, &ring->bytes[offset + 2], len);
+        atomic_store_explicit(&ring->head, head + 2u + len, memory_order_release);
+        return len;
+    }
+}
+
+// Mixed-size throughput: mostly 8-byte heartbeats with occasional 1 KB
+// blobs, through a fixed-slot queue sized for the blob versus the byte
+// ring of the same memory footprint.
+void vring_benchmark_task(void *pvParameters) {
+    enum { MESSAGES = 4000, HEARTBEAT_LEN = 8, BLOB_LEN = 1024 };
+    static uint8_t blob[BLOB_LEN];
+    static uint8_t rxbuf[BLOB_LEN];
+
+    vring_t *ring = malloc(sizeof(vring_t));
+    QueueHandle_t fixed = xQueueCreate(VRING_SIZE / BLOB_LEN, BLOB_LEN);
+    if (!ring || !fixed) {
+        safe_printf("VRing benchmark: allocation failed, skipping\n");
+        vTaskDelete(NULL);
+    }
+    memset(ring, 0, sizeof(vring_t));
+    memset(blob, 0xAB, sizeof(blob));
+
+    safe_printf("\n═══ BYTE-RING BENCHMARK (%d msgs, 1 blob per 16) ═══\n", MESSAGES);
+
+    // Fixed-slot queue: every message costs a full BLOB_LEN copy.
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < MESSAGES; i++) {
+        xQueueSend(fixed, blob, 0);
+        xQueueReceive(fixed, rxbuf, 0);
+    }
+    int64_t fixed_us = esp_timer_get_time() - start;
+
+    // Byte ring: each message costs its own length.
+    start = esp_timer_get_time();
+    for (int i = 0; i < MESSAGES; i++) {
+        uint16_t len = (i % 16 == 0) ? BLOB_LEN : HEARTBEAT_LEN;
+        vring_send(ring, blob, len);
+        vring_recv(ring, rxbuf, sizeof(rxbuf));
+    }
+    int64_t ring_us = esp_timer_get_time() - start;
+
+    safe_printf("Fixed slots (%u x %u B): %lld us, %.2f us/msg\n",
+                (unsigned)(VRING_SIZE / BLOB_LEN), (unsigned)BLOB_LEN,
+                fixed_us, (float)fixed_us / MESSAGES);
+    safe_printf("Byte ring   (%u B):      %lld us, %.2f us/msg (%.2fx)\n",
+                (unsigned)VRING_SIZE, ring_us, (float)ring_us / MESSAGES,
+                ring_us ? (float)fixed_us / ring_us : 0);
+    safe_printf("Capacity at mixed sizes: fixed %u msgs, ring ~%u msgs\n",
+                (unsigned)(VRING_SIZE / BLOB_LEN),
+                (unsigned)(VRING_SIZE / (HEARTBEAT_LEN + 2)));
+    safe_printf("═══════════════════════════\n\n");
+
+    vQueueDelete(fixed);
+    free(ring);
+    vTaskDelete(NULL);
+}
+
+// Credit-based backpressure for the shared FreeRTOS queue.
+//
+// Blocking in xQueueSend convoys the producers: they all park on the full
+// queue and all wake the moment one slot frees, stampeding for it. With
+// credits, consumers grant send permission in batches through one atomic
+// counter; a producer that finds no credit spins briefly (a grant is often
+// in flight) and then sleeps with a jittered backoff, so wakeups spread
+// out instead of arriving in lockstep.
+#define CREDIT_MAX        10   // matches the queue depth
+#define CREDIT_BATCH      4    // consumed items per grant
+#define CREDIT_SPIN_TRIES 3
+
+static atomic_int_fast32_t send_credits = CREDIT_MAX;
+static atomic_uint_fast32_t credit_grants = 0;     // batches granted
+static atomic_uint_fast32_t credit_backoffs = 0;   // producer backoff sleeps
+// Elastic consumers drain this queue too, so the grant counter is atomic.
+static atomic_uint_fast32_t consumed_since_grant = 0;
+
+static bool credit_take(void) {
+    for (int attempt = 0; ; attempt++) {
+        int_fast32_t c = atomic_load_explicit(&send_credits, memory_order_acquire);
+        while (c > 0) {
+            if (atomic_compare_exchange_weak_explicit(&send_credits, &c, c - 1,
+                                                      memory_order_acquire,
+                                                      memory_order_relaxed)) {
+                return true;
+            }
+        }
+        if (attempt >= CREDIT_SPIN_TRIES) {
+            return false;
+        }
+        taskYIELD();   // a grant may be one consumer step away
+    }
+}
+
+static void credit_backoff(void) {
+    atomic_fetch_add_explicit(&credit_backoffs, 1, memory_order_relaxed);
+    // Jitter keeps the three producers from re-waking in phase.
+    vTaskDelay(pdMS_TO_TICKS(20 + (esp_random() % 60)));
+}
+
+// Called by the queue consumer; hands out a batch once enough items have
+// been drained, capped so credits never exceed the queue depth.
+static void credit_grant_batch(void) {
+    uint_fast32_t n = atomic_fetch_add_explicit(&consumed_since_grant, 1,
+                                                memory_order_relaxed) + 1;
+    if (n % CREDIT_BATCH != 0) {
+        return;
+    }
+    int_fast32_t c = atomic_load_explicit(&send_credits, memory_order_relaxed);
+    int_fast32_t add;
+    do {
+        add = CREDIT_MAX - c;
+        if (add > CREDIT_BATCH) add = CREDIT_BATCH;
+        if (add <= 0) return;
+    } while (!atomic_compare_exchange_weak_explicit(&send_credits, &c, c + add,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+    atomic_fetch_add_explicit(&credit_grants, 1, memory_order_relaxed);
+}
+
 void safe_printf(const char* format, ...) {
     va_list args;
     va_start(args, format);
@@ -49,35 +460,67 @@ void safe_printf(const char* format, ...) {
 }
 
 void producer_task(void *pvParameters) {
-    int producer_id = *((int*)pvParameters);
+    worker_params_t *params = (worker_params_t*)pvParameters;
+    int producer_id = params->id;
     product_t product;
     int product_counter = 0;
     gpio_num_t led_pin = (producer_id == 1) ? LED_PRODUCER_1 :
                          (producer_id == 2) ? LED_PRODUCER_2 :
                          (producer_id == 3) ? LED_PRODUCER_3 : LED_PRODUCER_1;
 
-    safe_printf("Producer %d started\n", producer_id);
+    safe_printf("Producer %d started (%s)\n", producer_id,
+                params->transport == TRANSPORT_SPSC_RING ? "SPSC ring" : "FreeRTOS queue");
 
     while (1) {
-        product.producer_id = producer_id;
-        product.product_id = product_counter++;
-        snprintf(product.product_name, sizeof(product.product_name),
-                 "Product-P%d-#%d", producer_id, product.product_id);
-        product.production_time = xTaskGetTickCount();
-        product.processing_time_ms = 500 + (esp_random() % 2000);
-
-        BaseType_t xStatus = xQueueSend(xProductQueue, &product, pdMS_TO_TICKS(100));
-        if (xStatus == pdPASS) {
-            global_stats.produced++;
+        // In zero-copy mode the product is built directly in its pool slot;
+        // otherwise it is built on the stack and copied by the transport.
+        product_t *dst = &product;
+        if (params->transport == TRANSPORT_PTR_QUEUE) {
+            dst = pool_acquire_slot(pdMS_TO_TICKS(100));
+        }
+
+        if (dst != NULL) {
+            dst->producer_id = producer_id;
+            dst->product_id = product_counter++;
+            snprintf(dst->product_name, sizeof(dst->product_name),
+                     "Product-P%d-#%d", producer_id, dst->product_id);
+            dst->production_time = xTaskGetTickCount();
+            dst->processing_time_ms = 500 + (esp_random() % 2000);
+        }
+
+        bool sent = false;
+        if (dst == NULL) {
+            // Pool exhausted: count it like a queue-full drop.
+        } else if (params->transport == TRANSPORT_SPSC_RING) {
+            sent = spsc_push(&product_ring, dst);
+        } else if (params->transport == TRANSPORT_PTR_QUEUE) {
+            sent = (xQueueSend(xProductPtrQueue, &dst, pdMS_TO_TICKS(100)) == pdPASS);
+            if (!sent) pool_release_slot(dst);
+        } else {
+            // Credits gate admission; once one is held the send itself
+            // should not need to block.
+            while (!credit_take()) {
+                credit_backoff();
+            }
+            int64_t send_start = esp_timer_get_time();
+            sent = (xQueueSend(xProductQueue, dst, pdMS_TO_TICKS(100)) == pdPASS);
+            int64_t blocked = esp_timer_get_time() - send_start;
+            if (blocked > 1000)   // only count real blocking, not the call cost
+                qreg_note_blocked(qreg_product_id, (uint32_t)blocked);
+        }
+        if (sent) {
+            stat_bump(&task_stats[producer_slot(producer_id)].produced);
             safe_printf("✓ Producer %d: Created %s (processing %dms)\n",
-                        producer_id, product.product_name, product.processing_time_ms);
+                        producer_id, dst->product_name, dst->processing_time_ms);
             gpio_set_level(led_pin, 1);
             vTaskDelay(pdMS_TO_TICKS(50));
             gpio_set_level(led_pin, 0);
         } else {
-            global_stats.dropped++;
-            safe_printf("✗ Producer %d: Queue full → Dropped %s\n",
-                        producer_id, product.product_name);
+            stat_bump(&task_stats[producer_slot(producer_id)].dropped);
+            safe_printf("✗ Producer %d: %s → Dropped product #%d\n",
+                        producer_id,
+                        dst == NULL ? "Pool empty" : "Queue full",
+                        dst == NULL ? product_counter : product_counter - 1);
         }
 
         int delay = 1000 + (esp_random() % 2000);
@@ -86,63 +529,366 @@ void producer_task(void *pvParameters) {
 }
 
 void consumer_task(void *pvParameters) {
-    int consumer_id = *((int*)pvParameters);
+    worker_params_t *params = (worker_params_t*)pvParameters;
+    int consumer_id = params->id;
     product_t product;
     gpio_num_t led_pin = (consumer_id == 1) ? LED_CONSUMER_1 : LED_CONSUMER_2;
 
-    safe_printf("Consumer %d started\n", consumer_id);
+    safe_printf("Consumer %d started (%s)\n", consumer_id,
+                params->transport == TRANSPORT_SPSC_RING ? "SPSC ring" : "FreeRTOS queue");
 
     while (1) {
-        BaseType_t xStatus = xQueueReceive(xProductQueue, &product, pdMS_TO_TICKS(5000));
+        bool received;
+        product_t *item = &product;   // slot pointer in zero-copy mode
+        if (params->transport == TRANSPORT_SPSC_RING) {
+            // The lock-free ring has no blocking receive; poll with a short
+            // sleep so an empty ring doesn't spin the CPU.
+            received = spsc_pop(&product_ring, &product);
+            if (!received) {
+                vTaskDelay(pdMS_TO_TICKS(10));
+                continue;
+            }
+        } else if (params->transport == TRANSPORT_PTR_QUEUE) {
+            received = (xQueueReceive(xProductPtrQueue, &item, pdMS_TO_TICKS(5000)) == pdPASS);
+        } else {
+            received = (xQueueReceive(xProductQueue, &product, pdMS_TO_TICKS(5000)) == pdPASS);
+        }
 
-        if (xStatus == pdPASS) {
-            global_stats.consumed++;
-            uint32_t queue_time = xTaskGetTickCount() - product.production_time;
+        if (received) {
+            stat_bump(&task_stats[consumer_slot(consumer_id)].consumed);
+            uint32_t queue_time = xTaskGetTickCount() - item->production_time;
             safe_printf("→ Consumer %d: Processing %s (queue time %lums)\n",
-                        consumer_id, product.product_name,
+                        consumer_id, item->product_name,
                         queue_time * portTICK_PERIOD_MS);
 
             gpio_set_level(led_pin, 1);
-            vTaskDelay(pdMS_TO_TICKS(product.processing_time_ms));
+            vTaskDelay(pdMS_TO_TICKS(item->processing_time_ms));
             gpio_set_level(led_pin, 0);
 
             safe_printf("✓ Consumer %d: Finished %s\n",
-                        consumer_id, product.product_name);
+                        consumer_id, item->product_name);
+
+            if (params->transport == TRANSPORT_PTR_QUEUE) {
+                pool_release_slot(item);
+            } else if (params->transport == TRANSPORT_FREERTOS_QUEUE) {
+                credit_grant_batch();
+            }
         } else {
             safe_printf("⏰ Consumer %d: Timeout – no product to process\n", consumer_id);
         }
     }
 }
 
+// Elastic consumer pool.
+//
+// The fixed consumer set is sized for the steady state, so a burst
+// either queues up behind it or forces overprovisioning (idle 3 KB
+// stacks all day for a burst a minute). Instead two extra consumers are
+// created parked — blocked on a task notification, costing nothing but
+// their stacks — and the load balancer wakes one when xProductQueue
+// depth crosses ELASTIC_WAKE_AT. A woken worker drains in burst mode
+// (processing time capped, the backlog is the emergency) and parks
+// itself once depth falls to ELASTIC_PARK_AT; the gap between the two
+// thresholds is the hysteresis that keeps workers from thrashing
+// awake/asleep around a single boundary.
+#define ELASTIC_WORKERS  2
+#define ELASTIC_WAKE_AT  8    // balancer wakes a parked worker at this depth
+#define ELASTIC_PARK_AT  2    // worker re-parks once drained to this depth
+#define ELASTIC_BURST_PROCESS_MS 100
+
+static TaskHandle_t elastic_handles[ELASTIC_WORKERS];
+static atomic_bool elastic_active[ELASTIC_WORKERS];
+static atomic_uint_fast32_t elastic_scale_ups = 0;
+static atomic_uint_fast32_t elastic_scale_downs = 0;
+
+// DVFS floor for burst drains: a backlog is exactly when the governor
+// must not be cruising at 80 MHz.
+static int dvfs_burst_floor = -1;
+
+void elastic_consumer_task(void *pvParameters) {
+    int id = (int)(intptr_t)pvParameters;
+    product_t product;
+
+    safe_printf("Elastic consumer %d parked\n", id);
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        atomic_fetch_add_explicit(&elastic_scale_ups, 1, memory_order_relaxed);
+        safe_printf("⚡ Elastic consumer %d woken (queue depth %u)\n",
+                    id, (unsigned)uxQueueMessagesWaiting(xProductQueue));
+        dvfs_gov_floor_hold(dvfs_burst_floor);
+
+        while (uxQueueMessagesWaiting(xProductQueue) > ELASTIC_PARK_AT &&
+               xQueueReceive(xProductQueue, &product, 0) == pdPASS) {
+            stat_bump(&task_stats[elastic_slot(id)].consumed);
+            int burst_ms = product.processing_time_ms < ELASTIC_BURST_PROCESS_MS ?
+                           product.processing_time_ms : ELASTIC_BURST_PROCESS_MS;
+            vTaskDelay(pdMS_TO_TICKS(burst_ms));
+            credit_grant_batch();
+        }
+
+        dvfs_gov_floor_release(dvfs_burst_floor);
+        atomic_fetch_add_explicit(&elastic_scale_downs, 1, memory_order_relaxed);
+        atomic_store_explicit(&elastic_active[id], false, memory_order_release);
+        safe_printf("💤 Elastic consumer %d parked (queue drained)\n", id);
+    }
+}
+
+// Wakes one parked worker; returns false when the whole pool is running.
+static bool elastic_wake_one(void) {
+    for (int i = 0; i < ELASTIC_WORKERS; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(&elastic_active[i], &expected, true,
+                                                    memory_order_acquire,
+                                                    memory_order_relaxed)) {
+            xTaskNotifyGive(elastic_handles[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Burst ISR rig.
+//
+// A gptimer ISR stands in for the DMA-complete interrupt: every firing
+// posts a BURST_LEN-record burst, alternating between per-item
+// xQueueSendFromISR and the ring's reserve/fill/commit path every
+// BURST_PHASE bursts. Cycles are counted around the enqueue loop only,
+// so the drain task can report what each path costs per item in the
+// handler itself. Both paths end with exactly one wake: the queue path
+// aggregates its woken flags, the ring path notifies once after commit.
+#define BURST_LEN         12
+#define BURST_TIMER_US    50000   // 20 bursts/s
+#define BURST_PHASE       256     // bursts per path before switching
+
+static spsc_ring_t burst_ring;
+static QueueHandle_t xBurstQueue;
+static TaskHandle_t burst_drain_handle;
+static volatile uint32_t burst_seq;
+static volatile uint32_t burst_cycles[2];   // [0]=queue path, [1]=ring path
+static volatile uint32_t burst_items[2];
+static volatile uint32_t burst_drops;
+
+static bool IRAM_ATTR burst_timer_isr(gptimer_handle_t timer,
+                                      const gptimer_alarm_event_data_t *edata,
+                                      void *arg) {
+    BaseType_t woken = pdFALSE;
+    int path = (burst_seq++ / BURST_PHASE) & 1;
+    uint32_t tick = (uint32_t)xTaskGetTickCountFromISR();
+
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    if (path == 0) {
+        product_t rec = { .producer_id = 99, .production_time = tick };
+        for (int i = 0; i < BURST_LEN; i++) {
+            rec.product_id = (int)burst_seq * BURST_LEN + i;
+            if (xQueueSendFromISR(xBurstQueue, &rec, &woken) == pdPASS) {
+                burst_items[0]++;
+            } else {
+                burst_drops++;
+            }
+        }
+    } else {
+        uint_fast32_t pos;
+        int got = spsc_reserve(&burst_ring, BURST_LEN, &pos);
+        for (int i = 0; i < got; i++) {
+            product_t *slot = spsc_burst_slot(&burst_ring, pos, i);
+            slot->producer_id = 99;
+            slot->product_id = (int)burst_seq * BURST_LEN + i;
+            slot->production_time = tick;
+        }
+        spsc_commit(&burst_ring, pos, got);
+        burst_items[1] += got;
+        burst_drops += BURST_LEN - got;
+    }
+    burst_cycles[path] += esp_cpu_get_cycle_count() - t0;
+
+    // One wake decision per burst, regardless of path.
+    vTaskNotifyGiveFromISR(burst_drain_handle, &woken);
+    return woken == pdTRUE;
+}
+
+void burst_drain_task(void *pvParameters) {
+    product_t rec;
+    uint32_t bursts = 0, drained = 0;
+
+    safe_printf("Burst drain task started (%d records/burst)\n", BURST_LEN);
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (spsc_pop(&burst_ring, &rec)) drained++;
+        while (xQueueReceive(xBurstQueue, &rec, 0) == pdPASS) drained++;
+
+        if (++bursts % (BURST_PHASE * 2) == 0) {
+            uint32_t qi = burst_items[0], ri = burst_items[1];
+            safe_printf("\n═══ BURST ISR ENQUEUE (%lu bursts, %lu drained) ═══\n",
+                        bursts, drained);
+            safe_printf("Per-item queue: %lu cyc/item over %lu items\n",
+                        qi ? burst_cycles[0] / qi : 0, qi);
+            safe_printf("Ring burst:     %lu cyc/item over %lu items\n",
+                        ri ? burst_cycles[1] / ri : 0, ri);
+            safe_printf("Dropped full:   %lu\n═══════════════════════════\n\n",
+                        burst_drops);
+        }
+    }
+}
+
+static void burst_isr_install(void) {
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&config, &timer));
+
+    gptimer_event_callbacks_t cbs = { .on_alarm = burst_timer_isr };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &cbs, NULL));
+
+    gptimer_alarm_config_t alarm = {
+        .alarm_count = BURST_TIMER_US,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+    ESP_ERROR_CHECK(gptimer_start(timer));
+}
+
+// One-shot benchmark: push/pop the same product_t payload through the
+// FreeRTOS queue and through the SPSC ring and compare cycles per message.
+void transport_benchmark_task(void *pvParameters) {
+    const int ITERATIONS = 10000;
+    product_t item = {0};
+    product_t out;
+    spsc_ring_t *bench_ring = malloc(sizeof(spsc_ring_t));
+    QueueHandle_t bench_queue = xQueueCreate(SPSC_RING_SIZE, sizeof(product_t));
+
+    if (!bench_ring || !bench_queue) {
+        safe_printf("Benchmark: allocation failed, skipping\n");
+        vTaskDelete(NULL);
+    }
+    memset(bench_ring, 0, sizeof(spsc_ring_t));
+
+    safe_printf("\n═══ TRANSPORT BENCHMARK (%d msgs, %u-byte payload) ═══\n",
+                ITERATIONS, (unsigned)sizeof(product_t));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        xQueueSend(bench_queue, &item, 0);
+        xQueueReceive(bench_queue, &out, 0);
+    }
+    int64_t queue_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        spsc_push(bench_ring, &item);
+        spsc_pop(bench_ring, &out);
+    }
+    int64_t ring_us = esp_timer_get_time() - start;
+
+    safe_printf("FreeRTOS queue: %lld us total, %.2f us/msg\n",
+                queue_us, (float)queue_us / ITERATIONS);
+    safe_printf("SPSC ring:      %lld us total, %.2f us/msg\n",
+                ring_us, (float)ring_us / ITERATIONS);
+    safe_printf("Speedup: %.2fx\n═══════════════════════════\n\n",
+                ring_us ? (float)queue_us / ring_us : 0);
+
+    vQueueDelete(bench_queue);
+    free(bench_ring);
+    vTaskDelete(NULL);
+}
+
+// Stats go out as binary telemetry frames (schema 2): delta-coded
+// varints, ~8x smaller than the formatted table and no printf in the
+// steady state. The collector parses TLMB lines; the table below is
+// kept every 4th cycle for console readers, and each frame is verified
+// through the reference decoder.
+#define TLM_SCHEMA_PROD_CONS 2
+
 void statistics_task(void *pvParameters) {
+    static tlc_stream_t tlm_stream;
+    static tlc_decoder_t tlm_check;
+    tlc_stream_init(&tlm_stream, TLM_SCHEMA_PROD_CONS, 6);
+    tlc_decoder_init(&tlm_check);
+    int cycle = 0;
+
     safe_printf("Statistics task started\n");
     while (1) {
         UBaseType_t q_items = uxQueueMessagesWaiting(xProductQueue);
-        safe_printf("\n═══ SYSTEM STATS ═══\n");
-        safe_printf("Produced: %lu\n", global_stats.produced);
-        safe_printf("Consumed: %lu\n", global_stats.consumed);
-        safe_printf("Dropped:  %lu\n", global_stats.dropped);
+        stats_t totals = aggregate_stats();
+
+        uint32_t fields[6] = {
+            totals.produced, totals.consumed, totals.dropped,
+            (uint32_t)q_items,
+            (uint32_t)atomic_load_explicit(&credit_grants, memory_order_relaxed),
+            (uint32_t)atomic_load_explicit(&credit_backoffs, memory_order_relaxed),
+        };
+        uint8_t frame[3 + 5 * 6];
+        size_t frame_len = tlc_encode(&tlm_stream, fields, frame, sizeof(frame));
+
+        char hex[2 * sizeof(frame) + 1];
+        char *hp = hex;
+        for (size_t i = 0; i < frame_len; i++)
+            hp = ff_hex32(hp, frame[i], 2);   // nibble lookup, no printf
+        ff_term(hp);
+        safe_printf("TLMB,%s\n", hex);
+
+        uint32_t decoded[TLC_FIELDS_MAX];
+        uint8_t dcount;
+        uint32_t dseq;
+        if (tlc_decode(&tlm_check, frame, frame_len, decoded, &dcount, &dseq) == 0 ||
+            memcmp(decoded, fields, sizeof(fields)) != 0) {
+            safe_printf("⚠️  Telemetry round-trip check FAILED\n");
+        }
+
+        if (++cycle % 4 != 0) {
+            vTaskDelay(pdMS_TO_TICKS(5000));
+            continue;
+        }
+
+        safe_printf("\n═══ SYSTEM STATS ═══ (frame %u B)\n", (unsigned)frame_len);
+        safe_printf("Produced: %lu\n", totals.produced);
+        safe_printf("Consumed: %lu\n", totals.consumed);
+        safe_printf("Dropped:  %lu\n", totals.dropped);
         safe_printf("Queue backlog: %d\n", q_items);
+        safe_printf("Credits: %ld avail, %lu batches granted, %lu backoffs\n",
+                    (long)atomic_load_explicit(&send_credits, memory_order_relaxed),
+                    (unsigned long)atomic_load_explicit(&credit_grants, memory_order_relaxed),
+                    (unsigned long)atomic_load_explicit(&credit_backoffs, memory_order_relaxed));
+        int elastic_running = 0;
+        for (int i = 0; i < ELASTIC_WORKERS; i++) {
+            if (atomic_load_explicit(&elastic_active[i], memory_order_relaxed))
+                elastic_running++;
+        }
+        safe_printf("Elastic: %d/%d active, %lu scale-ups, %lu scale-downs, %lu drained\n",
+                    elastic_running, ELASTIC_WORKERS,
+                    (unsigned long)atomic_load_explicit(&elastic_scale_ups, memory_order_relaxed),
+                    (unsigned long)atomic_load_explicit(&elastic_scale_downs, memory_order_relaxed),
+                    (unsigned long)(atomic_load_explicit(&task_stats[elastic_slot(0)].consumed, memory_order_relaxed) +
+                                    atomic_load_explicit(&task_stats[elastic_slot(1)].consumed, memory_order_relaxed)));
         safe_printf("Efficiency: %.1f%%\n",
-                    global_stats.produced ?
-                    (float)global_stats.consumed / global_stats.produced * 100 : 0);
+                    totals.produced ?
+                    (float)totals.consumed / totals.produced * 100 : 0);
 
         printf("Queue: [");
         for (int i = 0; i < 10; i++) printf(i < q_items ? "■" : "□");
         printf("]\n═════════════════════\n\n");
+        qreg_report();
+        dvfs_gov_report();
 
         vTaskDelay(pdMS_TO_TICKS(5000));
     }
 }
 
 void load_balancer_task(void *pvParameters) {
-    const int MAX_QUEUE_SIZE = 8;
     safe_printf("Load balancer started\n");
     while (1) {
         UBaseType_t q_items = uxQueueMessagesWaiting(xProductQueue);
-        if (q_items > MAX_QUEUE_SIZE) {
+        if (q_items >= ELASTIC_WAKE_AT) {
             safe_printf("⚠️  HIGH LOAD! Queue=%d\n", q_items);
-            safe_printf("💡 Suggest adding more consumers\n");
+            if (elastic_wake_one()) {
+                safe_printf("💡 Scaling up: woke an elastic consumer\n");
+            } else {
+                safe_printf("💡 Elastic pool exhausted — all workers running\n");
+            }
             gpio_set_level(LED_PRODUCER_1, 1);
             gpio_set_level(LED_PRODUCER_2, 1);
             gpio_set_level(LED_PRODUCER_3, 1);
@@ -177,17 +923,64 @@ void app_main(void) {
     xProductQueue = xQueueCreate(10, sizeof(product_t));
     xPrintMutex = xSemaphoreCreateMutex();
 
-    if (xProductQueue && xPrintMutex) {
+    // Zero-copy plumbing: both pointer queues are as deep as the slot pool,
+    // then every slot starts out on the free list.
+    xProductPtrQueue = xQueueCreate(PRODUCT_POOL_SLOTS, sizeof(product_t*));
+    xFreeSlotQueue = xQueueCreate(PRODUCT_POOL_SLOTS, sizeof(product_t*));
+    if (xFreeSlotQueue) {
+        for (int i = 0; i < PRODUCT_POOL_SLOTS; i++) {
+            product_t *slot = &product_pool[i];
+            xQueueSend(xFreeSlotQueue, &slot, 0);
+        }
+    }
+
+    // Every queue this lab owns goes into the registry at creation.
+    qreg_product_id = qreg_register("Product", xProductQueue, 10, 80);
+    qreg_ptr_id = qreg_register("ProductPtr", xProductPtrQueue, PRODUCT_POOL_SLOTS, 80);
+    qreg_free_id = qreg_register("FreeSlots", xFreeSlotQueue, PRODUCT_POOL_SLOTS, 0);
+    (void)qreg_ptr_id; (void)qreg_free_id;
+    qreg_set_alarm_hook(queue_pressure_alarm);
+    qreg_start_collector(500);
+
+    // Governor rides the registry's pressure numbers plus its own
+    // idle-cycle accounting; elastic drains hold a 240 MHz floor.
+    dvfs_burst_floor = dvfs_gov_register_rt("elastic-drain", 240);
+    dvfs_gov_start(1000);
+
+    if (xProductQueue && xPrintMutex && xProductPtrQueue && xFreeSlotQueue) {
         ESP_LOGI(TAG, "Queue & Mutex created successfully");
 
-        static int p1=1,p2=2,p3=3,c1=1,c2=2;
+        // Producer 1 / Consumer 1 pair exclusively on the lock-free ring (it
+        // is strictly single-producer/single-consumer); everyone else stays
+        // on the shared FreeRTOS queue.
+        static worker_params_t p1 = {1, TRANSPORT_SPSC_RING};
+        static worker_params_t p2 = {2, TRANSPORT_PTR_QUEUE};
+        static worker_params_t p3 = {3, TRANSPORT_FREERTOS_QUEUE};
+        static worker_params_t c1 = {1, TRANSPORT_SPSC_RING};
+        static worker_params_t c2 = {2, TRANSPORT_PTR_QUEUE};
+        static worker_params_t c3 = {3, TRANSPORT_FREERTOS_QUEUE};
         xTaskCreate(producer_task, "Producer1", 3072, &p1, 3, NULL);
         xTaskCreate(producer_task, "Producer2", 3072, &p2, 3, NULL);
         xTaskCreate(producer_task, "Producer3", 3072, &p3, 3, NULL);
         xTaskCreate(consumer_task, "Consumer1", 3072, &c1, 2, NULL);
         xTaskCreate(consumer_task, "Consumer2", 3072, &c2, 2, NULL);
+        xTaskCreate(consumer_task, "Consumer3", 3072, &c3, 2, NULL);
+        // Elastic pool starts parked; the balancer wakes workers on demand.
+        xTaskCreate(elastic_consumer_task, "Elastic0", 3072, (void*)0, 2, &elastic_handles[0]);
+        xTaskCreate(elastic_consumer_task, "Elastic1", 3072, (void*)1, 2, &elastic_handles[1]);
         xTaskCreate(statistics_task, "Stats", 3072, NULL, 1, NULL);
         xTaskCreate(load_balancer_task, "Balancer", 2048, NULL, 1, NULL);
+        xTaskCreate(transport_benchmark_task, "Bench", 4096, NULL, 4, NULL);
+        xTaskCreate(vring_benchmark_task, "VRingBench", 4096, NULL, 4, NULL);
+        xTaskCreate(stats_layout_benchmark_task, "StatsBench", 3072, NULL, 4, NULL);
+
+        // Burst ISR rig: drain task must exist before the timer fires.
+        xBurstQueue = xQueueCreate(SPSC_RING_SIZE, sizeof(product_t));
+        if (xBurstQueue) {
+            xTaskCreate(burst_drain_task, "BurstDrain", 3072, NULL, 4,
+                        &burst_drain_handle);
+            burst_isr_install();
+        }
     } else {
         ESP_LOGE(TAG, "Failed to create queue or mutex!");
     }
@@ -6,8 +6,11 @@
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "esp_random.h"
+#include "evloop.h"
+#include "pmu.h"
 
 static const char *TAG = "QUEUE_SETS";
 
@@ -22,7 +25,10 @@ QueueHandle_t xSensorQueue;
 QueueHandle_t xUserQueue;
 QueueHandle_t xNetworkQueue;
 SemaphoreHandle_t xTimerSemaphore;
-QueueSetHandle_t xQueueSet;
+
+// The select-and-dispatch loop itself now lives in the shared evloop
+// component; this is just the instance the processor task runs.
+static evloop_t proc_loop;
 
 typedef struct {
     int sensor_id;
@@ -38,6 +44,7 @@ typedef struct {
 } user_input_t;
 
 typedef struct {
+    uint8_t type;            // index into the dispatch table
     char source[20];
     char message[100];
     int priority;
@@ -52,6 +59,247 @@ typedef struct {
 
 message_stats_t stats = {0};
 
+// -------- Queue telemetry hooks --------
+//
+// Polling uxQueueMessagesWaiting from a monitor only shows the depth at
+// the moment of the poll; pressure that builds and drains between polls
+// is invisible until messages drop. These hooks ride the send/drain
+// paths instead: every send updates the high-water mark and blocked or
+// failed counters, time spent full is accumulated between the send that
+// filled the queue and the drain that relieved it, and a registered
+// callback fires (edge-triggered) when depth crosses a threshold.
+#define QTEL_MAX 4
+
+typedef void (*qtel_alarm_fn_t)(const char *name, UBaseType_t depth);
+
+typedef struct {
+    QueueHandle_t queue;
+    const char *name;
+    UBaseType_t capacity;
+    UBaseType_t high_water;
+    uint32_t blocked_sends;     // send found the queue full and had to wait
+    uint32_t failed_sends;      // still full after the timeout
+    uint32_t time_at_full_ms;
+    uint32_t full_since_ms;     // 0 = not currently full
+    UBaseType_t alarm_threshold;
+    qtel_alarm_fn_t alarm;
+    bool alarm_latched;
+    // Trend prediction: EWMA fill/drain rates sampled on the hooks.
+    uint32_t sends_total;
+    uint32_t trend_last_sends;
+    UBaseType_t trend_last_depth;
+    uint32_t trend_last_ms;
+    float fill_rate;            // items/s, smoothed
+    float drain_rate;
+    uint32_t predict_alarms;
+    bool predict_latched;
+} qtel_entry_t;
+
+static qtel_entry_t qtel[QTEL_MAX];
+static int qtel_count = 0;
+
+static int qtel_register(QueueHandle_t queue, const char *name, UBaseType_t capacity) {
+    qtel[qtel_count] = (qtel_entry_t){ .queue = queue, .name = name,
+                                       .capacity = capacity };
+    return qtel_count++;
+}
+
+static void qtel_set_alarm(int id, UBaseType_t threshold, qtel_alarm_fn_t alarm) {
+    qtel[id].alarm_threshold = threshold;
+    qtel[id].alarm = alarm;
+}
+
+// ---- Overflow prediction ----
+//
+// The threshold alarm above fires when depth is already high — zero
+// warning for whoever sheds load. The predictor watches the trend
+// instead: every hook invocation updates EWMA estimates of fill and
+// drain rate, and when the net rate projects the queue hitting capacity
+// within the horizon, the early alarm fires while there is still
+// headroom. Edge-triggered like the threshold alarm; it re-arms once
+// the projection clears the horizon.
+#define QTEL_TREND_MIN_DT_MS   50      // ignore samples closer than this
+#define QTEL_TREND_ALPHA       0.3f
+#define QTEL_PREDICT_HORIZON_MS 800
+
+static void qtel_trend_sample(qtel_entry_t *entry, UBaseType_t depth) {
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    uint32_t dt = now - entry->trend_last_ms;
+    if (entry->trend_last_ms == 0 || dt > 10000) {
+        // First sample or stale history: re-anchor, no rate yet.
+        entry->trend_last_ms = now;
+        entry->trend_last_sends = entry->sends_total;
+        entry->trend_last_depth = depth;
+        return;
+    }
+    if (dt < QTEL_TREND_MIN_DT_MS) return;
+
+    uint32_t sends = entry->sends_total - entry->trend_last_sends;
+    // Everything that entered and didn't raise the depth was drained.
+    int32_t drains = (int32_t)sends - ((int32_t)depth - (int32_t)entry->trend_last_depth);
+    if (drains < 0) drains = 0;
+
+    float fill = (float)sends * 1000.0f / (float)dt;
+    float drain = (float)drains * 1000.0f / (float)dt;
+    entry->fill_rate += QTEL_TREND_ALPHA * (fill - entry->fill_rate);
+    entry->drain_rate += QTEL_TREND_ALPHA * (drain - entry->drain_rate);
+    entry->trend_last_ms = now;
+    entry->trend_last_sends = entry->sends_total;
+    entry->trend_last_depth = depth;
+
+    float net = entry->fill_rate - entry->drain_rate;
+    if (net > 0.01f) {
+        float to_full_ms = (float)(entry->capacity - depth) * 1000.0f / net;
+        if (to_full_ms < QTEL_PREDICT_HORIZON_MS) {
+            if (!entry->predict_latched) {
+                entry->predict_latched = true;
+                entry->predict_alarms++;
+                ESP_LOGW(TAG, "📈 Queue '%s' projected full in ~%dms "
+                         "(fill %.1f/s vs drain %.1f/s, depth %u/%u) — shed load now",
+                         entry->name, (int)to_full_ms, entry->fill_rate,
+                         entry->drain_rate, (unsigned)depth, (unsigned)entry->capacity);
+            }
+            return;
+        }
+    }
+    entry->predict_latched = false;
+}
+
+// Sender-side hook: wraps xQueueSend and collects the telemetry inline.
+static BaseType_t qtel_send(int id, const void *item, TickType_t timeout) {
+    qtel_entry_t *entry = &qtel[id];
+
+    BaseType_t ok = xQueueSend(entry->queue, item, 0);
+    if (ok != pdPASS) {
+        entry->blocked_sends++;
+        if (entry->full_since_ms == 0) {
+            entry->full_since_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        }
+        ok = xQueueSend(entry->queue, item, timeout);
+        if (ok != pdPASS) {
+            entry->failed_sends++;
+            return ok;
+        }
+    }
+
+    entry->sends_total++;
+    UBaseType_t depth = uxQueueMessagesWaiting(entry->queue);
+    if (depth > entry->high_water) entry->high_water = depth;
+    qtel_trend_sample(entry, depth);
+
+    if (entry->alarm != NULL && depth >= entry->alarm_threshold) {
+        if (!entry->alarm_latched) {
+            entry->alarm_latched = true;
+            entry->alarm(entry->name, depth);
+        }
+    }
+    return ok;
+}
+
+// Drain-side hook: closes any open time-at-full window and re-arms the
+// threshold alarm once pressure is gone.
+static void qtel_note_drained(int id) {
+    qtel_entry_t *entry = &qtel[id];
+    if (entry->full_since_ms != 0) {
+        entry->time_at_full_ms +=
+            xTaskGetTickCount() * portTICK_PERIOD_MS - entry->full_since_ms;
+        entry->full_since_ms = 0;
+    }
+    UBaseType_t depth = uxQueueMessagesWaiting(entry->queue);
+    qtel_trend_sample(entry, depth);
+    if (depth < entry->alarm_threshold) {
+        entry->alarm_latched = false;
+    }
+}
+
+static void qtel_report(void) {
+    ESP_LOGI(TAG, "📋 Queue telemetry:");
+    for (int i = 0; i < qtel_count; i++) {
+        ESP_LOGI(TAG, "  %-8s high-water %u/%u | blocked %lu | failed %lu | full %lums"
+                 " | fill %.2f/s drain %.2f/s | early alarms %lu",
+                 qtel[i].name, (unsigned)qtel[i].high_water,
+                 (unsigned)qtel[i].capacity, qtel[i].blocked_sends,
+                 qtel[i].failed_sends, qtel[i].time_at_full_ms,
+                 qtel[i].fill_rate, qtel[i].drain_rate, qtel[i].predict_alarms);
+    }
+}
+
+static void qtel_pressure_alarm(const char *name, UBaseType_t depth) {
+    ESP_LOGW(TAG, "🚨 Queue '%s' under pressure: depth %u crossed threshold",
+             name, (unsigned)depth);
+}
+
+static int qtel_sensor_id, qtel_user_id, qtel_network_id;
+
+// -------- Typed message dispatch --------
+//
+// Branching on message type with if/else chains costs a predictor miss
+// per uncommon type, and at 30 types the chain itself is a scan.
+// Handlers register into a table indexed by the type byte, so dispatch
+// is one bounds check and one indirect call regardless of type count,
+// with a per-type invocation counter. The unknown-type path is marked
+// cold and noinline so the error handling stays out of the hot
+// dispatch code.
+#define MSG_TYPE_MAX 32
+
+typedef void (*msg_handler_fn_t)(const network_message_t *msg);
+
+static msg_handler_fn_t msg_handlers[MSG_TYPE_MAX];
+static uint32_t msg_invocations[MSG_TYPE_MAX];
+static uint32_t msg_unknown_count = 0;
+
+static void msg_dispatch_register(uint8_t type, msg_handler_fn_t handler) {
+    if (type < MSG_TYPE_MAX) {
+        msg_handlers[type] = handler;
+    }
+}
+
+__attribute__((cold, noinline))
+static void msg_dispatch_unknown(const network_message_t *msg) {
+    msg_unknown_count++;
+    ESP_LOGW(TAG, "❓ Unhandled message type %u from [%s]", msg->type, msg->source);
+}
+
+static inline void msg_dispatch(const network_message_t *msg) {
+    if (msg->type < MSG_TYPE_MAX && msg_handlers[msg->type] != NULL) {
+        msg_invocations[msg->type]++;
+        msg_handlers[msg->type](msg);
+    } else {
+        msg_dispatch_unknown(msg);
+    }
+}
+
+// Message types and their handlers. Handlers stay small: the dispatcher
+// already logged nothing, so each owns its own output.
+enum {
+    MSG_STATUS = 0,
+    MSG_ALERT,
+    MSG_SYNC,
+    MSG_HEARTBEAT,
+    MSG_CONFIG,
+    MSG_KNOWN_COUNT,
+};
+
+static void handle_status(const network_message_t *msg) {
+    ESP_LOGI(TAG, "→ NETWORK: [%s] status update", msg->source);
+}
+
+static void handle_alert(const network_message_t *msg) {
+    ESP_LOGW(TAG, "→ NETWORK: [%s] ALERT (priority %d)", msg->source, msg->priority);
+}
+
+static void handle_sync(const network_message_t *msg) {
+    ESP_LOGI(TAG, "→ NETWORK: [%s] sync requested", msg->source);
+}
+
+static void handle_heartbeat(const network_message_t *msg) {
+    ESP_LOGI(TAG, "→ NETWORK: [%s] heartbeat", msg->source);
+}
+
+static void handle_config(const network_message_t *msg) {
+    ESP_LOGI(TAG, "→ NETWORK: [%s] config changed", msg->source);
+}
+
 // -------- Sensor simulation task --------
 void sensor_task(void *pvParameters) {
     sensor_data_t data;
@@ -63,7 +311,7 @@ void sensor_task(void *pvParameters) {
         data.humidity = 30.0 + (esp_random() % 400) / 10.0;
         data.timestamp = xTaskGetTickCount();
 
-        if (xQueueSend(xSensorQueue, &data, pdMS_TO_TICKS(100)) == pdPASS) {
+        if (qtel_send(qtel_sensor_id, &data, pdMS_TO_TICKS(100)) == pdPASS) {
             ESP_LOGI(TAG, "📊 Sensor: T=%.1f°C, H=%.1f%%", data.temperature, data.humidity);
             gpio_set_level(LED_SENSOR, 1);
             vTaskDelay(pdMS_TO_TICKS(50));
@@ -81,7 +329,7 @@ void user_input_task(void *pvParameters) {
         input.button_id = 1 + (esp_random() % 3);
         input.pressed = true;
         input.duration_ms = 100 + (esp_random() % 1000);
-        if (xQueueSend(xUserQueue, &input, pdMS_TO_TICKS(100)) == pdPASS) {
+        if (qtel_send(qtel_user_id, &input, pdMS_TO_TICKS(100)) == pdPASS) {
             ESP_LOGI(TAG, "🔘 User: Button %d pressed for %dms", input.button_id, input.duration_ms);
             gpio_set_level(LED_USER, 1);
             vTaskDelay(pdMS_TO_TICKS(100));
@@ -98,10 +346,11 @@ void network_task(void *pvParameters) {
     const char* messages[] = {"Status update", "Alert!", "Sync data", "Heartbeat", "Config changed"};
     ESP_LOGI(TAG, "Network task started");
     while (1) {
+        msg.type = esp_random() % MSG_KNOWN_COUNT;
         strcpy(msg.source, sources[esp_random() % 4]);
-        strcpy(msg.message, messages[esp_random() % 5]);
+        strcpy(msg.message, messages[msg.type]);
         msg.priority = 1 + (esp_random() % 5);
-        if (xQueueSend(xNetworkQueue, &msg, pdMS_TO_TICKS(100)) == pdPASS) {
+        if (qtel_send(qtel_network_id, &msg, pdMS_TO_TICKS(100)) == pdPASS) {
             ESP_LOGI(TAG, "🌐 Network [%s]: %s (P:%d)", msg.source, msg.message, msg.priority);
             gpio_set_level(LED_NETWORK, 1);
             vTaskDelay(pdMS_TO_TICKS(50));
@@ -124,37 +373,147 @@ void timer_task(void *pvParameters) {
     }
 }
 
-// -------- Processor task (core of queue set) --------
-void processor_task(void *pvParameters) {
-    QueueSetMemberHandle_t member;
+// -------- Event-loop drain handlers --------
+//
+// The readiness-vector loop this file used to hand-roll (block once,
+// flush the set's tokens, snapshot pending counts, drain in priority
+// order) is now the shared evloop component — the same code our other
+// select-and-dispatch loops use. The demo keeps only the per-source
+// drain handlers; each empties its queue completely so one wakeup
+// clears the whole backlog.
+static void drain_sensor(void *ctx, UBaseType_t pending) {
     sensor_data_t sdata;
+    while (xQueueReceive(xSensorQueue, &sdata, 0) == pdPASS) {
+        stats.sensor_count++;
+        ESP_LOGI(TAG, "→ SENSOR: %.1f°C %.1f%%", sdata.temperature, sdata.humidity);
+    }
+    qtel_note_drained(qtel_sensor_id);
+}
+
+static void drain_user(void *ctx, UBaseType_t pending) {
     user_input_t uinput;
+    while (xQueueReceive(xUserQueue, &uinput, 0) == pdPASS) {
+        stats.user_count++;
+        ESP_LOGI(TAG, "→ USER: Button %d (%dms)", uinput.button_id, uinput.duration_ms);
+    }
+    qtel_note_drained(qtel_user_id);
+}
+
+static void drain_network(void *ctx, UBaseType_t pending) {
     network_message_t nmsg;
+    while (xQueueReceive(xNetworkQueue, &nmsg, 0) == pdPASS) {
+        stats.network_count++;
+        msg_dispatch(&nmsg);
+    }
+    qtel_note_drained(qtel_network_id);
+}
 
-    ESP_LOGI(TAG, "Processor task waiting for events...");
-    while (1) {
-        member = xQueueSelectFromSet(xQueueSet, portMAX_DELAY);
-        gpio_set_level(LED_PROCESSOR, 1);
+static void drain_timer(void *ctx, UBaseType_t pending) {
+    while (xSemaphoreTake(xTimerSemaphore, 0) == pdPASS) {
+        stats.timer_count++;
+        ESP_LOGI(TAG, "→ TIMER: Maintenance event");
+        ESP_LOGI(TAG, "📈 Counts → Sensor:%lu | User:%lu | Net:%lu | Timer:%lu",
+                 stats.sensor_count, stats.user_count, stats.network_count, stats.timer_count);
+        qtel_report();
+        ESP_LOGI(TAG, "📇 Dispatch: status=%lu alert=%lu sync=%lu hb=%lu cfg=%lu unknown=%lu",
+                 msg_invocations[MSG_STATUS], msg_invocations[MSG_ALERT],
+                 msg_invocations[MSG_SYNC], msg_invocations[MSG_HEARTBEAT],
+                 msg_invocations[MSG_CONFIG], msg_unknown_count);
+        evl_report(&proc_loop);
+    }
+}
+
+// -------- Dispatch overhead benchmark --------
+//
+// Same workload both ways: a burst of messages through a private queue,
+// drained either by the raw one-select-per-message queue-set loop this
+// file used to run, or by one evloop batching wakeup. Run once at boot,
+// before the demo tasks exist, so nothing else perturbs the numbers.
+#define BENCH_BURST   16
+#define BENCH_ROUNDS  64
+
+static uint32_t bench_consumed = 0;
+
+// PMU regions over each drain style: µs/msg says which is faster, the
+// miss/stall profile says where the raw loop's overhead actually goes.
+static pmu_region_t pmu_raw_drain = PMU_REGION_INIT("raw-drain");
+static pmu_region_t pmu_evl_drain = PMU_REGION_INIT("evloop-drain");
 
-        if (member == xSensorQueue && xQueueReceive(xSensorQueue, &sdata, 0) == pdPASS) {
-            stats.sensor_count++;
-            ESP_LOGI(TAG, "→ SENSOR: %.1f°C %.1f%%", sdata.temperature, sdata.humidity);
+static void bench_drain(void *ctx, UBaseType_t pending) {
+    QueueHandle_t q = (QueueHandle_t)ctx;
+    uint32_t item;
+    while (xQueueReceive(q, &item, 0) == pdPASS) {
+        bench_consumed++;
+    }
+}
+
+static void dispatch_overhead_benchmark(void) {
+    QueueHandle_t bench_queue = xQueueCreate(BENCH_BURST, sizeof(uint32_t));
+    if (bench_queue == NULL) return;
+
+    // Raw path: one blocking select and one receive per message.
+    QueueSetHandle_t raw_set = xQueueCreateSet(BENCH_BURST);
+    xQueueAddToSet(bench_queue, raw_set);
+    bench_consumed = 0;
+    int64_t t0 = esp_timer_get_time();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BENCH_BURST; i++) {
+            xQueueSend(bench_queue, &i, 0);
         }
-        else if (member == xUserQueue && xQueueReceive(xUserQueue, &uinput, 0) == pdPASS) {
-            stats.user_count++;
-            ESP_LOGI(TAG, "→ USER: Button %d (%dms)", uinput.button_id, uinput.duration_ms);
+        PMU_SCOPED(&pmu_raw_drain) {
+            QueueSetMemberHandle_t ready;
+            while ((ready = xQueueSelectFromSet(raw_set, 0)) != NULL) {
+                uint32_t item;
+                xQueueReceive(ready, &item, 0);
+                bench_consumed++;
+            }
         }
-        else if (member == xNetworkQueue && xQueueReceive(xNetworkQueue, &nmsg, 0) == pdPASS) {
-            stats.network_count++;
-            ESP_LOGI(TAG, "→ NETWORK: [%s] %s", nmsg.source, nmsg.message);
+    }
+    int64_t raw_us = esp_timer_get_time() - t0;
+    uint32_t raw_count = bench_consumed;
+    xQueueRemoveFromSet(bench_queue, raw_set);
+    vQueueDelete(raw_set);
+
+    // Batched path: one select per burst, handler drains the rest.
+    evloop_t bench_loop;
+    evl_init(&bench_loop, BENCH_BURST, true);
+    evl_add_source(&bench_loop, bench_queue, "Bench", 1, bench_drain, bench_queue);
+    bench_consumed = 0;
+    t0 = esp_timer_get_time();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BENCH_BURST; i++) {
+            xQueueSend(bench_queue, &i, 0);
         }
-        else if (member == xTimerSemaphore && xSemaphoreTake(xTimerSemaphore, 0) == pdPASS) {
-            stats.timer_count++;
-            ESP_LOGI(TAG, "→ TIMER: Maintenance event");
-            ESP_LOGI(TAG, "📈 Counts → Sensor:%lu | User:%lu | Net:%lu | Timer:%lu",
-                     stats.sensor_count, stats.user_count, stats.network_count, stats.timer_count);
+        PMU_SCOPED(&pmu_evl_drain) {
+            evl_run_once(&bench_loop, 0);
         }
+    }
+    int64_t evl_us = esp_timer_get_time() - t0;
+    uint32_t evl_count = bench_consumed;
+    xQueueRemoveFromSet(bench_queue, bench_loop.set);
+    vQueueDelete(bench_loop.set);
+    vQueueDelete(bench_queue);
+
+    ESP_LOGI(TAG, "⚖️ Dispatch overhead (%u msgs/burst, %u bursts):",
+             BENCH_BURST, BENCH_ROUNDS);
+    ESP_LOGI(TAG, "  raw select-per-message: %lu msgs in %lldus (%.2fus/msg)",
+             raw_count, raw_us, raw_count ? (float)raw_us / raw_count : 0.0f);
+    ESP_LOGI(TAG, "  evloop batching drain:  %lu msgs in %lldus (%.2fus/msg, %.2fx)",
+             evl_count, evl_us, evl_count ? (float)evl_us / evl_count : 0.0f,
+             evl_us ? (float)raw_us / evl_us : 0.0f);
+    pmu_report(&pmu_raw_drain);
+    pmu_report(&pmu_evl_drain);
+}
+
+// -------- Processor task (core of queue set) --------
+void processor_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Processor task waiting for events...");
+    while (1) {
+        int handled = evl_run_once(&proc_loop, portMAX_DELAY);
+        if (handled == 0) continue;
 
+        gpio_set_level(LED_PROCESSOR, 1);
+        ESP_LOGI(TAG, "🗳 Wakeup %lu: %d handlers ran", proc_loop.wakeups, handled);
         vTaskDelay(pdMS_TO_TICKS(200));
         gpio_set_level(LED_PROCESSOR, 0);
     }
@@ -168,17 +527,34 @@ void app_main(void) {
     gpio_set_direction(LED_TIMER, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_PROCESSOR, GPIO_MODE_OUTPUT);
 
+    dispatch_overhead_benchmark();
+
     xSensorQueue = xQueueCreate(5, sizeof(sensor_data_t));
     xUserQueue = xQueueCreate(3, sizeof(user_input_t));
     xNetworkQueue = xQueueCreate(8, sizeof(network_message_t));
     xTimerSemaphore = xSemaphoreCreateBinary();
-    xQueueSet = xQueueCreateSet(5 + 3 + 8 + 1);
 
-    if (xQueueSet && xSensorQueue && xUserQueue && xNetworkQueue && xTimerSemaphore) {
-        xQueueAddToSet(xSensorQueue, xQueueSet);
-        xQueueAddToSet(xUserQueue, xQueueSet);
-        xQueueAddToSet(xNetworkQueue, xQueueSet);
-        xQueueAddToSet(xTimerSemaphore, xQueueSet);
+    if (evl_init(&proc_loop, 5 + 3 + 8 + 1, true) &&
+        xSensorQueue && xUserQueue && xNetworkQueue && xTimerSemaphore) {
+        // Dispatch order under load: user input beats network beats
+        // sensor telemetry; timer maintenance runs last.
+        msg_dispatch_register(MSG_STATUS, handle_status);
+        msg_dispatch_register(MSG_ALERT, handle_alert);
+        msg_dispatch_register(MSG_SYNC, handle_sync);
+        msg_dispatch_register(MSG_HEARTBEAT, handle_heartbeat);
+        msg_dispatch_register(MSG_CONFIG, handle_config);
+
+        qtel_sensor_id = qtel_register(xSensorQueue, "Sensor", 5);
+        qtel_user_id = qtel_register(xUserQueue, "User", 3);
+        qtel_network_id = qtel_register(xNetworkQueue, "Network", 8);
+        qtel_set_alarm(qtel_sensor_id, 4, qtel_pressure_alarm);
+        qtel_set_alarm(qtel_user_id, 2, qtel_pressure_alarm);
+        qtel_set_alarm(qtel_network_id, 6, qtel_pressure_alarm);
+
+        evl_add_source(&proc_loop, xUserQueue, "User", 4, drain_user, NULL);
+        evl_add_source(&proc_loop, xNetworkQueue, "Network", 3, drain_network, NULL);
+        evl_add_source(&proc_loop, xSensorQueue, "Sensor", 2, drain_sensor, NULL);
+        evl_add_source(&proc_loop, xTimerSemaphore, "Timer", 1, drain_timer, NULL);
 
         xTaskCreate(sensor_task, "Sensor", 2048, NULL, 3, NULL);
         xTaskCreate(user_input_task, "User", 2048, NULL, 3, NULL);
@@ -1,16 +1,32 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "driver/gptimer.h"
+#include "driver/pulse_cnt.h"
+#include "driver/ledc.h"
+#include "freertos/stream_buffer.h"
+#include "soc/soc_caps.h"
+#if SOC_GPIO_SUPPORT_PIN_GLITCH_FILTER
+#include "driver/gpio_filter.h"
+#endif
 #include "esp_random.h"
+#include "esp_cpu.h"
+#include "esp_ipc.h"
 
 static const char *TAG = "BINARY_SEM";
 
+// Signaling mechanism selection: 0 = binary semaphores (classic path),
+// 1 = direct-to-task notifications. Notifications skip the semaphore
+// object entirely and are noticeably faster for this unicast pattern;
+// the latency figures printed by the monitor quantify the difference.
+#define USE_TASK_NOTIFICATIONS 1
+
 // ======================= GPIO CONFIG ==========================
 #define LED_PRODUCER GPIO_NUM_2
 #define LED_CONSUMER GPIO_NUM_4
@@ -25,6 +41,117 @@ SemaphoreHandle_t xButtonSemaphore;
 // Timer handle
 gptimer_handle_t gptimer = NULL;
 
+// Free-running 1 MHz capture timer dedicated to latency measurement; no
+// alarm, never reset, read from both the ISRs and the woken tasks.
+// (Enable CONFIG_GPTIMER_CTRL_FUNC_IN_IRAM so the read is legal from an
+// IRAM ISR while flash cache is off.)
+gptimer_handle_t latency_timer = NULL;
+
+static inline uint64_t latency_now_us(void) {
+    uint64_t count = 0;
+    gptimer_get_raw_count(latency_timer, &count);
+    return count;
+}
+
+// ======================= LATENCY TRACKING ======================
+// Each ISR records the CPU cycle counter right before signaling; the woken
+// task reads it again on wakeup, giving ISR-to-task latency in cycles for
+// whichever mechanism is compiled in.
+typedef struct {
+    uint64_t total_cycles;
+    uint32_t samples;
+    uint32_t max_cycles;
+} wakeup_latency_t;
+
+static wakeup_latency_t timer_latency = {0};
+static wakeup_latency_t button_latency = {0};
+
+// µs-resolution histogram fed by the capture timer. The bucket edges
+// bracket the latencies we actually tune: a healthy wakeup sits in the
+// first couple of buckets, and anything beyond 100 µs means an interrupt
+// priority or critical-section problem worth chasing.
+#define LAT_HIST_BUCKETS 8
+static const uint32_t lat_bucket_limit_us[LAT_HIST_BUCKETS - 1] =
+    {5, 10, 20, 50, 100, 200, 500};
+
+typedef struct {
+    uint32_t buckets[LAT_HIST_BUCKETS];
+    uint32_t samples;
+    uint32_t max_us;
+    uint64_t total_us;
+} latency_hist_t;
+
+static latency_hist_t timer_hist = {0};
+static latency_hist_t button_hist = {0};
+
+static void hist_record(latency_hist_t *h, uint32_t us) {
+    int b = 0;
+    while (b < LAT_HIST_BUCKETS - 1 && us > lat_bucket_limit_us[b]) b++;
+    h->buckets[b]++;
+    h->samples++;
+    h->total_us += us;
+    if (us > h->max_us) h->max_us = us;
+}
+
+static void hist_print(const char *name, const latency_hist_t *h) {
+    if (h->samples == 0) return;
+    ESP_LOGI(TAG, "  %s: %lu samples, avg %llu us, max %lu us", name,
+             h->samples, h->total_us / h->samples, h->max_us);
+    for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+        if (h->buckets[b] == 0) continue;
+        char label[16];
+        if (b < LAT_HIST_BUCKETS - 1) {
+            snprintf(label, sizeof(label), "<=%lu us", lat_bucket_limit_us[b]);
+        } else {
+            snprintf(label, sizeof(label), ">%lu us",
+                     lat_bucket_limit_us[LAT_HIST_BUCKETS - 2]);
+        }
+        char bar[33];
+        int len = (int)((uint64_t)h->buckets[b] * 32 / h->samples);
+        if (len == 0) len = 1;
+        memset(bar, '#', len);
+        bar[len] = 0;
+        ESP_LOGI(TAG, "    %-9s %5lu %s", label, h->buckets[b], bar);
+    }
+}
+
+static void record_wakeup_latency(wakeup_latency_t *lat, uint32_t isr_cycles,
+                                  latency_hist_t *hist, uint64_t isr_us) {
+    uint32_t delta = esp_cpu_get_cycle_count() - isr_cycles;
+    lat->total_cycles += delta;
+    lat->samples++;
+    if (delta > lat->max_cycles) lat->max_cycles = delta;
+
+    hist_record(hist, (uint32_t)(latency_now_us() - isr_us));
+}
+
+// ================= BUTTON EDGE COALESCING ======================
+// Mechanical contacts bounce: one press used to deliver 20+ negedge
+// interrupts, each one signaling the button task. The ISR now accumulates
+// edges into a batch record and signals only when it OPENS a batch; the
+// task closes the batch after the line has been quiet for BTN_STABLE_US.
+// Result: one wakeup per physical press instead of one per edge, and the
+// consumer gets the full bounce profile (edge count, burst duration).
+// Where the SoC has a pin glitch filter (not classic ESP32) we also arm
+// it, so sub-2-clock spikes never reach the ISR at all.
+#define BTN_STABLE_US 30000    // quiet time that ends a bounce burst
+#define BTN_POLL_MS   10       // task poll interval while waiting for quiet
+
+typedef struct {
+    uint32_t edge_count;       // raw edges folded into this batch
+    uint64_t first_edge_us;    // capture-timer stamp of the opening edge
+    uint64_t last_edge_us;     // stamp of the most recent edge
+    bool open;                 // ISR is still accumulating into this batch
+} button_batch_t;
+
+static volatile button_batch_t button_batch = {0};
+static portMUX_TYPE button_batch_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Interrupt-load accounting: raw edges vs. signals actually delivered.
+static volatile uint32_t btn_raw_edges = 0;
+static uint32_t btn_batches_closed = 0;
+static uint32_t btn_max_edges_per_batch = 0;
+
 // ======================= STATS STRUCT ==========================
 typedef struct {
     uint32_t signals_sent;
@@ -35,19 +162,415 @@ typedef struct {
 
 semaphore_stats_t stats = {0, 0, 0, 0};
 
+// ================= INTERRUPT AFFINITY STEERING =================
+// ESP-IDF allocates an interrupt on whichever core runs the allocation
+// call — with app_main on core 0, every ISR in this lab used to land
+// there, on top of whatever else (WiFi, in a real stack) core 0 already
+// runs. Each interrupt now declares a load class at registration; the
+// steering table picks the core with the least declared load and runs
+// the driver's install code *on that core* via a blocking IPC call,
+// since that is the only thing that decides where the ISR fires. At
+// runtime each ISR brackets itself with cycle stamps, so the monitor
+// can show the measured per-core ISR load next to the declared one.
+typedef enum {
+    ISR_LOAD_LIGHT = 0,    // a few stores and a notify
+    ISR_LOAD_MEDIUM,       // bursty (bouncing edges, FIFO drains)
+    ISR_LOAD_HEAVY,        // real per-interrupt processing
+} isr_load_class_t;
+
+static const uint32_t isr_load_weight[] = { 1, 4, 16 };
+
+static uint32_t isr_declared_weight[portNUM_PROCESSORS];
+static uint8_t isr_installed_count[portNUM_PROCESSORS];
+static volatile uint64_t isr_core_cycles[portNUM_PROCESSORS];
+static volatile uint32_t isr_core_fires[portNUM_PROCESSORS];
+
+// Registration-time decision: least declared weight wins, core 0 on ties
+// (so a single light ISR stays off the core we keep free for compute).
+static int isr_steer_core(const char *name, isr_load_class_t cls) {
+    int core = 0;
+    for (int c = 1; c < portNUM_PROCESSORS; c++) {
+        if (isr_declared_weight[c] < isr_declared_weight[core]) core = c;
+    }
+    isr_declared_weight[core] += isr_load_weight[cls];
+    isr_installed_count[core]++;
+    ESP_LOGI(TAG, "🧲 ISR '%s' (class %d) steered to core %d (weights now %lu/%lu)",
+             name, cls, core, isr_declared_weight[0],
+             portNUM_PROCESSORS > 1 ? isr_declared_weight[1] : 0);
+    return core;
+}
+
+// Run the driver's interrupt-allocating install code on the chosen core.
+static void isr_install_on_core(int core, esp_ipc_func_t install_fn, void *arg) {
+    if (core == xPortGetCoreID()) {
+        install_fn(arg);
+    } else {
+        ESP_ERROR_CHECK(esp_ipc_call_blocking(core, install_fn, arg));
+    }
+}
+
+// ISR-side accounting: stamp on entry, accumulate on exit.
+static inline uint32_t isr_account_enter(void) {
+    return esp_cpu_get_cycle_count();
+}
+
+static inline void isr_account_exit(uint32_t enter_cycles) {
+    int core = xPortGetCoreID();
+    isr_core_cycles[core] += esp_cpu_get_cycle_count() - enter_cycles;
+    isr_core_fires[core]++;
+}
+
+// ================ TOP/BOTTOM-HALF FRAMEWORK ====================
+// Both ISRs used to do their bookkeeping inline: stamp a pile of
+// globals, poke shared state, pick a task to notify. Split into the
+// classic two stages instead: the top half records a minimal event
+// (cycle stamp, capture-timer stamp, one payload word) into its
+// source's lock-free ring and rings the doorbell — nothing else, so
+// worst-case ISR runtime stays in the sub-2 µs range no matter how
+// much work the handler does. Each source gets its own bottom-half
+// worker at its own priority, so the scheduler arbitrates between
+// sources: the timer's worker (our motor-loop stand-in, tight budget)
+// preempts the button's. The ring is single-producer/single-consumer —
+// the ISR owns head, the worker owns tail — so neither side ever
+// takes a lock; a full ring drops the event and counts the drop
+// rather than ever making the ISR wait.
+#define TBH_RING_SIZE  16    // per source, power of two
+#define TBH_SRC_TIMER  0
+#define TBH_SRC_BUTTON 1
+#define TBH_NSOURCES   2
+
+typedef struct {
+    uint32_t cycles;     // CPU cycle stamp at top-half entry
+    uint64_t us;         // capture-timer stamp (feeds the histograms)
+    uint32_t payload;    // source-specific word
+} tbh_event_t;
+
+typedef void (*tbh_handler_t)(const tbh_event_t *ev);
+
+typedef struct {
+    const char *name;
+    const char *task_name;
+    UBaseType_t prio;
+    uint32_t budget_us;            // ISR stamp -> handler entry deadline
+    tbh_handler_t handler;
+    wakeup_latency_t *wakeup;      // existing cycle-latency tracking
+    latency_hist_t *hist;          // existing µs histogram
+    SemaphoreHandle_t *doorbell;   // semaphore signaling path only
+    TaskHandle_t task;
+    tbh_event_t ring[TBH_RING_SIZE];
+    _Atomic uint32_t head;         // written by the top half only
+    _Atomic uint32_t tail;         // written by the worker only
+    uint32_t dropped;
+    uint32_t handled;
+    uint32_t budget_misses;
+    uint32_t worst_dispatch_us;
+} tbh_source_t;
+
+static void tbh_timer_handler(const tbh_event_t *ev);
+static void tbh_button_handler(const tbh_event_t *ev);
+
+static tbh_source_t tbh_sources[TBH_NSOURCES] = {
+    [TBH_SRC_TIMER] = {
+        .name = "timer",  .task_name = "TimerBH",  .prio = 5,
+        .budget_us = 500,  .handler = tbh_timer_handler,
+        .wakeup = &timer_latency,  .hist = &timer_hist,
+        .doorbell = &xTimerSemaphore,
+    },
+    [TBH_SRC_BUTTON] = {
+        .name = "button", .task_name = "ButtonBH", .prio = 4,
+        .budget_us = 5000, .handler = tbh_button_handler,
+        .wakeup = &button_latency, .hist = &button_hist,
+        .doorbell = &xButtonSemaphore,
+    },
+};
+
+// The whole top half beyond acknowledging the device: stamp, store,
+// publish, doorbell. Free-running head/tail indices; head - tail is
+// the fill level and wraps correctly in unsigned arithmetic.
+static void IRAM_ATTR tbh_post_from_isr(int src, uint32_t payload,
+                                        BaseType_t *xHigherPriorityTaskWoken) {
+    tbh_source_t *s = &tbh_sources[src];
+    uint32_t head = atomic_load_explicit(&s->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&s->tail, memory_order_acquire)
+            >= TBH_RING_SIZE) {
+        s->dropped++;    // never block, never spin: drop and count
+        return;
+    }
+    tbh_event_t *ev = &s->ring[head & (TBH_RING_SIZE - 1)];
+    ev->cycles = esp_cpu_get_cycle_count();
+    ev->us = latency_now_us();
+    ev->payload = payload;
+    atomic_store_explicit(&s->head, head + 1, memory_order_release);
+#if USE_TASK_NOTIFICATIONS
+    if (s->task != NULL) {
+        vTaskNotifyGiveFromISR(s->task, xHigherPriorityTaskWoken);
+    }
+#else
+    xSemaphoreGiveFromISR(*s->doorbell, xHigherPriorityTaskWoken);
+#endif
+}
+
+// One worker per source. Drains its ring completely on every wakeup,
+// so a binary doorbell losing coalesced signals costs nothing. The
+// slot is released (tail bumped) before the handler runs, on a copy
+// of the event, so a slow handler never holds the ring down — it only
+// delays its own source.
+static void tbh_worker_task(void *pvParameters) {
+    tbh_source_t *s = (tbh_source_t *)pvParameters;
+    ESP_LOGI(TAG, "Bottom half '%s' started (prio %u, budget %lu us)",
+             s->name, s->prio, s->budget_us);
+    while (1) {
+#if USE_TASK_NOTIFICATIONS
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#else
+        xSemaphoreTake(*s->doorbell, portMAX_DELAY);
+#endif
+        uint32_t tail = atomic_load_explicit(&s->tail, memory_order_relaxed);
+        while (tail != atomic_load_explicit(&s->head, memory_order_acquire)) {
+            tbh_event_t ev = s->ring[tail & (TBH_RING_SIZE - 1)];
+            atomic_store_explicit(&s->tail, ++tail, memory_order_release);
+
+            uint32_t dispatch_us = (uint32_t)(latency_now_us() - ev.us);
+            record_wakeup_latency(s->wakeup, ev.cycles, s->hist, ev.us);
+            if (dispatch_us > s->worst_dispatch_us) {
+                s->worst_dispatch_us = dispatch_us;
+            }
+            if (dispatch_us > s->budget_us) {
+                s->budget_misses++;
+                ESP_LOGW(TAG, "⏰ '%s' dispatch took %lu us, budget is %lu us",
+                         s->name, dispatch_us, s->budget_us);
+            }
+            s->handled++;
+            s->handler(&ev);
+        }
+    }
+}
+
+static void tbh_start(void) {
+    for (int i = 0; i < TBH_NSOURCES; i++) {
+        xTaskCreate(tbh_worker_task, tbh_sources[i].task_name, 2560,
+                    &tbh_sources[i], tbh_sources[i].prio,
+                    &tbh_sources[i].task);
+    }
+}
+
+// ================ STREAM CHANNEL (ISR -> TASK) =================
+// Signalling per event is right for the 8 s timer; it is wrong for
+// byte streams (UART protocol frames, sample bursts), where a queue of
+// 1-byte items pays an item header and a kernel call per byte. The
+// stream buffer is the purpose-built alternative: one contiguous byte
+// ring, single writer (the sampling ISR), single reader, and the
+// reader wakes only when the fill crosses the trigger level — one wake
+// per watermark instead of one per byte. A 1 kHz sampling timer feeds
+// 16-byte frames alternately into the stream buffer and into a 1-byte
+// item queue in 5 s phases, so the monitor can report bytes/sec,
+// wakes and drops for both paths from identical input.
+#define STREAM_FRAME_BYTES   16
+#define STREAM_BUF_BYTES     1024
+#define STREAM_TRIGGER_BYTES 64      // watermark: wake every 4 frames
+#define STREAM_PHASE_TICKS   5000    // 5 s per path at 1 kHz
+
+static gptimer_handle_t sample_timer = NULL;
+static StreamBufferHandle_t sample_stream = NULL;
+static QueueHandle_t sample_byte_q = NULL;   // the contrast: 1-byte items
+
+static volatile uint32_t stream_tx_bytes, stream_tx_drops;
+static volatile uint32_t queue_tx_bytes, queue_tx_drops;
+static volatile uint32_t stream_rx_bytes, stream_rx_wakes;   // rx-task owned
+static volatile uint32_t queue_rx_bytes, queue_rx_wakes;
+
+static bool IRAM_ATTR sample_timer_callback(gptimer_handle_t timer,
+                                            const gptimer_alarm_event_data_t *edata,
+                                            void *user_data) {
+    BaseType_t woken = pdFALSE;
+    uint32_t enter = isr_account_enter();
+    static uint32_t tick;
+    uint8_t frame[STREAM_FRAME_BYTES];
+    for (int i = 0; i < STREAM_FRAME_BYTES; i++) {
+        frame[i] = (uint8_t)(tick + i);      // synthetic sample ramp
+    }
+
+    if ((tick++ / STREAM_PHASE_TICKS) & 1) {
+        // Item-queue phase: one kernel call and one header per byte.
+        for (int i = 0; i < STREAM_FRAME_BYTES; i++) {
+            if (xQueueSendFromISR(sample_byte_q, &frame[i], &woken) == pdTRUE) {
+                queue_tx_bytes++;
+            } else {
+                queue_tx_drops++;
+            }
+        }
+    } else {
+        size_t n = xStreamBufferSendFromISR(sample_stream, frame,
+                                            STREAM_FRAME_BYTES, &woken);
+        stream_tx_bytes += n;
+        stream_tx_drops += STREAM_FRAME_BYTES - n;
+    }
+    isr_account_exit(enter);
+    return woken == pdTRUE;
+}
+
+static void stream_rx_task(void *pvParameters) {
+    uint8_t buf[STREAM_TRIGGER_BYTES];
+    while (1) {
+        // Blocks until the watermark trips (or the phase gap times out);
+        // one call moves up to a whole watermark's worth of bytes.
+        size_t n = xStreamBufferReceive(sample_stream, buf, sizeof(buf),
+                                        pdMS_TO_TICKS(250));
+        if (n == 0) continue;
+        stream_rx_wakes++;
+        stream_rx_bytes += n;
+    }
+}
+
+static void queue_rx_task(void *pvParameters) {
+    uint8_t b;
+    while (1) {
+        if (xQueueReceive(sample_byte_q, &b, pdMS_TO_TICKS(250)) != pdTRUE) {
+            continue;
+        }
+        queue_rx_wakes++;
+        queue_rx_bytes++;
+        // Drain the backlog too — still one kernel call per byte, which
+        // is exactly the cost being measured.
+        while (xQueueReceive(sample_byte_q, &b, 0) == pdTRUE) {
+            queue_rx_bytes++;
+        }
+    }
+}
+
+// ================= HARDWARE PULSE COUNTER ======================
+// The button path pays one interrupt per edge — fine for a finger, fatal
+// for an encoder at 20 kHz edge rates. The PCNT peripheral moves the
+// counting into hardware: edges accumulate in the unit register behind
+// a glitch filter, software reads deltas at whatever pace it likes, and
+// the only interrupt left is the watch point at the counter limit — one
+// firing per 32767 edges instead of one per edge. The interrupt path
+// stays reserved for genuinely sparse events (the button). Real firmware
+// wires the encoder to the pin; the lab feeds it a LEDC square wave
+// through the pad's loopback, 10 kHz with both edges counted.
+#define PULSE_PIN          GPIO_NUM_25
+#define PULSE_HIGH_LIMIT   32767
+#define PULSE_GLITCH_NS    1000
+#define PULSE_GEN_HZ       10000    // square wave; both edges = 20k edges/s
+
+static pcnt_unit_handle_t pulse_unit;
+static volatile uint32_t pulse_rollovers;
+
+// One interrupt per PULSE_HIGH_LIMIT edges; the unit wraps to zero on
+// its own, so the handler only credits the rollover.
+static bool IRAM_ATTR pulse_on_reach(pcnt_unit_handle_t unit,
+                                     const pcnt_watch_event_data_t *edata,
+                                     void *user_ctx) {
+    uint32_t enter = isr_account_enter();
+    pulse_rollovers++;
+    isr_account_exit(enter);
+    return false;
+}
+
+// 64-bit running total: hardware register plus rollover credit.
+static uint64_t pulse_total_edges(void) {
+    int count = 0;
+    if (pulse_unit) pcnt_unit_get_count(pulse_unit, &count);
+    return (uint64_t)pulse_rollovers * PULSE_HIGH_LIMIT + (uint32_t)count;
+}
+
+// Allocates the watch-point interrupt, so it goes through steering like
+// every other install in this lab.
+static void pulse_counter_install(void *arg) {
+    pcnt_unit_config_t unit_config = {
+        .low_limit = -1,
+        .high_limit = PULSE_HIGH_LIMIT,
+    };
+    ESP_ERROR_CHECK(pcnt_new_unit(&unit_config, &pulse_unit));
+
+    pcnt_glitch_filter_config_t filter_config = {
+        .max_glitch_ns = PULSE_GLITCH_NS,
+    };
+    ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(pulse_unit, &filter_config));
+
+    pcnt_chan_config_t chan_config = {
+        .edge_gpio_num = PULSE_PIN,
+        .level_gpio_num = -1,
+        .flags.io_loop_back = true,   // read back the LEDC wave on the same pad
+    };
+    pcnt_channel_handle_t chan;
+    ESP_ERROR_CHECK(pcnt_new_channel(pulse_unit, &chan_config, &chan));
+    ESP_ERROR_CHECK(pcnt_channel_set_edge_action(
+        chan, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE));
+
+    ESP_ERROR_CHECK(pcnt_unit_add_watch_point(pulse_unit, PULSE_HIGH_LIMIT));
+    pcnt_event_callbacks_t cbs = { .on_reach = pulse_on_reach };
+    ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(pulse_unit, &cbs, NULL));
+
+    ESP_ERROR_CHECK(pcnt_unit_enable(pulse_unit));
+    ESP_ERROR_CHECK(pcnt_unit_clear_count(pulse_unit));
+    ESP_ERROR_CHECK(pcnt_unit_start(pulse_unit));
+}
+
+// Simulated encoder: LEDC square wave on the same pad the counter reads.
+static void pulse_generator_start(void) {
+    ledc_timer_config_t timer_config = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .duty_resolution = LEDC_TIMER_8_BIT,
+        .timer_num = LEDC_TIMER_1,
+        .freq_hz = PULSE_GEN_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&timer_config));
+
+    ledc_channel_config_t channel_config = {
+        .gpio_num = PULSE_PIN,
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = LEDC_CHANNEL_1,
+        .timer_sel = LEDC_TIMER_1,
+        .duty = 128,   // 50% of 8-bit range
+        .hpoint = 0,
+    };
+    ESP_ERROR_CHECK(ledc_channel_config(&channel_config));
+}
+
 // ======================= TIMER ISR =============================
 static bool IRAM_ATTR timer_callback(gptimer_handle_t timer,
                                     const gptimer_alarm_event_data_t *edata,
                                     void *user_data) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(xTimerSemaphore, &xHigherPriorityTaskWoken);
+    uint32_t enter = isr_account_enter();
+    tbh_post_from_isr(TBH_SRC_TIMER, (uint32_t)edata->count_value,
+                      &xHigherPriorityTaskWoken);
+    isr_account_exit(enter);
     return (xHigherPriorityTaskWoken == pdTRUE);
 }
 
 // ======================= BUTTON ISR ===========================
+// Fires on ANY edge. Only the edge that opens a new batch signals the
+// task; every bounce edge after that is a couple of stores and a return.
 static void IRAM_ATTR button_isr_handler(void* arg) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(xButtonSemaphore, &xHigherPriorityTaskWoken);
+    uint32_t enter = isr_account_enter();
+    uint64_t now_us = latency_now_us();
+    bool opened = false;
+
+    btn_raw_edges++;
+    portENTER_CRITICAL_ISR(&button_batch_lock);
+    if (!button_batch.open) {
+        button_batch.open = true;
+        button_batch.edge_count = 1;
+        button_batch.first_edge_us = now_us;
+        button_batch.last_edge_us = now_us;
+        opened = true;
+    } else {
+        button_batch.edge_count++;
+        button_batch.last_edge_us = now_us;
+    }
+    portEXIT_CRITICAL_ISR(&button_batch_lock);
+
+    if (!opened) {
+        isr_account_exit(enter);
+        return;
+    }
+
+    tbh_post_from_isr(TBH_SRC_BUTTON, btn_raw_edges, &xHigherPriorityTaskWoken);
+    isr_account_exit(enter);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
@@ -90,38 +613,63 @@ void consumer_task(void *pvParameters) {
     }
 }
 
-// ======================= TIMER EVENT TASK ======================
-void timer_event_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Timer event task started");
-    while (1) {
-        if (xSemaphoreTake(xTimerSemaphore, portMAX_DELAY) == pdTRUE) {
-            stats.timer_events++;
-            ESP_LOGI(TAG, "⏱️ Timer: Periodic timer event #%lu", stats.timer_events);
-            gpio_set_level(LED_TIMER, 1);
-            vTaskDelay(pdMS_TO_TICKS(200));
-            gpio_set_level(LED_TIMER, 0);
-
-            if (stats.timer_events % 5 == 0) {
-                ESP_LOGI(TAG, "📊 Stats - Sent:%lu, Received:%lu, Timer:%lu, Button:%lu",
-                         stats.signals_sent, stats.signals_received,
-                         stats.timer_events, stats.button_presses);
-            }
-        }
+// ===================== TIMER BOTTOM HALF =======================
+// Runs in the TimerBH worker. Blocking here (the LED pulse) only
+// stalls the timer's own worker; the button's events keep flowing.
+static void tbh_timer_handler(const tbh_event_t *ev) {
+    stats.timer_events++;
+    ESP_LOGI(TAG, "⏱️ Timer: Periodic timer event #%lu (count %lu)",
+             stats.timer_events, ev->payload);
+    gpio_set_level(LED_TIMER, 1);
+    vTaskDelay(pdMS_TO_TICKS(200));
+    gpio_set_level(LED_TIMER, 0);
+
+    if (stats.timer_events % 5 == 0) {
+        ESP_LOGI(TAG, "📊 Stats - Sent:%lu, Received:%lu, Timer:%lu, Button:%lu",
+                 stats.signals_sent, stats.signals_received,
+                 stats.timer_events, stats.button_presses);
     }
 }
 
-// ======================= BUTTON EVENT TASK =====================
-void button_event_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Button event task started");
+// ===================== BUTTON BOTTOM HALF ======================
+// Runs in the ButtonBH worker, once per batch-opening edge.
+static void tbh_button_handler(const tbh_event_t *ev) {
+    // Wait for the bounce burst to die down: keep polling until the
+    // line has been quiet for BTN_STABLE_US, then close the batch so
+    // the next edge opens (and posts) a fresh one.
+    button_batch_t batch;
     while (1) {
-        if (xSemaphoreTake(xButtonSemaphore, portMAX_DELAY) == pdTRUE) {
-            stats.button_presses++;
-            ESP_LOGI(TAG, "🔘 Button: Press detected #%lu", stats.button_presses);
-            vTaskDelay(pdMS_TO_TICKS(300)); // Debounce
-            ESP_LOGI(TAG, "🚀 Button: Triggering immediate producer event");
-            xSemaphoreGive(xBinarySemaphore);
-            stats.signals_sent++;
+        vTaskDelay(pdMS_TO_TICKS(BTN_POLL_MS));
+        portENTER_CRITICAL(&button_batch_lock);
+        uint64_t last = button_batch.last_edge_us;
+        if (latency_now_us() - last >= BTN_STABLE_US) {
+            batch.edge_count = button_batch.edge_count;
+            batch.first_edge_us = button_batch.first_edge_us;
+            batch.last_edge_us = button_batch.last_edge_us;
+            button_batch.open = false;
+            portEXIT_CRITICAL(&button_batch_lock);
+            break;
         }
+        portEXIT_CRITICAL(&button_batch_lock);
+    }
+    btn_batches_closed++;
+    if (batch.edge_count > btn_max_edges_per_batch) {
+        btn_max_edges_per_batch = batch.edge_count;
+    }
+
+    ESP_LOGI(TAG, "🔘 Button: %lu edges coalesced over %llu us (batch #%lu)",
+             batch.edge_count,
+             batch.last_edge_us - batch.first_edge_us,
+             btn_batches_closed);
+
+    // Only a burst that SETTLES pressed (active-low) counts as a
+    // press; a release burst closes its batch silently.
+    if (gpio_get_level(BUTTON_PIN) == 0) {
+        stats.button_presses++;
+        ESP_LOGI(TAG, "🚀 Button: Press #%lu - triggering immediate producer event",
+                 stats.button_presses);
+        xSemaphoreGive(xBinarySemaphore);
+        stats.signals_sent++;
     }
 }
 
@@ -143,6 +691,69 @@ void monitor_task(void *pvParameters) {
         ESP_LOGI(TAG, "  Timer:    %lu", stats.timer_events);
         ESP_LOGI(TAG, "  Button:   %lu", stats.button_presses);
 
+        uint32_t raw = btn_raw_edges;
+        if (raw > 0) {
+            ESP_LOGI(TAG, "Button coalescing: %lu raw edges -> %lu signals (worst burst %lu edges)",
+                     raw, btn_batches_closed, btn_max_edges_per_batch);
+        }
+
+        ESP_LOGI(TAG, "Two-stage dispatch (ISR stamp -> bottom-half drain):");
+        for (int i = 0; i < TBH_NSOURCES; i++) {
+            tbh_source_t *s = &tbh_sources[i];
+            ESP_LOGI(TAG, "  %-6s: %lu handled, %lu dropped, worst %lu us (budget %lu us, %lu misses)",
+                     s->name, s->handled, s->dropped, s->worst_dispatch_us,
+                     s->budget_us, s->budget_misses);
+        }
+
+        ESP_LOGI(TAG, "ISR→task latency (%s):",
+                 USE_TASK_NOTIFICATIONS ? "task notifications" : "binary semaphores");
+        if (timer_latency.samples > 0) {
+            ESP_LOGI(TAG, "  Timer:  avg %llu cycles, max %lu cycles (%lu samples)",
+                     timer_latency.total_cycles / timer_latency.samples,
+                     timer_latency.max_cycles, timer_latency.samples);
+        }
+        if (button_latency.samples > 0) {
+            ESP_LOGI(TAG, "  Button: avg %llu cycles, max %lu cycles (%lu samples)",
+                     button_latency.total_cycles / button_latency.samples,
+                     button_latency.max_cycles, button_latency.samples);
+        }
+
+        ESP_LOGI(TAG, "Latency histograms (gptimer capture, us):");
+        hist_print("Timer ", &timer_hist);
+        hist_print("Button", &button_hist);
+
+        // Each path carries the same 16 KB/s input half the time, so
+        // rates are per 15 s window; wakes are where the gap lives.
+        static uint32_t last_stream_rx, last_queue_rx;
+        uint32_t srx = stream_rx_bytes, qrx = queue_rx_bytes;
+        ESP_LOGI(TAG, "Stream vs byte queue (alternating 5 s phases):");
+        ESP_LOGI(TAG, "  stream: %lu B total (%lu B/s), %lu wakes (%u B watermark), %lu drops",
+                 srx, (srx - last_stream_rx) / 15, stream_rx_wakes,
+                 STREAM_TRIGGER_BYTES, stream_tx_drops);
+        ESP_LOGI(TAG, "  queue : %lu B total (%lu B/s), %lu wakes, %lu drops",
+                 qrx, (qrx - last_queue_rx) / 15, queue_rx_wakes, queue_tx_drops);
+        last_stream_rx = srx;
+        last_queue_rx = qrx;
+
+        // Hardware counting: rate per window, and what the same edges
+        // would have cost as per-edge interrupts (the path PCNT replaces).
+        if (pulse_unit) {
+            static uint64_t last_pulse_edges;
+            uint64_t edges = pulse_total_edges();
+            ESP_LOGI(TAG, "Pulse counter: %llu edges total (%llu/s), %lu rollover IRQs",
+                     edges, (edges - last_pulse_edges) / 15, pulse_rollovers);
+            last_pulse_edges = edges;
+        }
+
+        ESP_LOGI(TAG, "Per-core ISR load (declared weight / measured):");
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            uint32_t fires = isr_core_fires[c];
+            ESP_LOGI(TAG, "  Core %d: %u ISRs, weight %lu, %lu fires, %llu cycles%s avg %llu",
+                     c, isr_installed_count[c], isr_declared_weight[c], fires,
+                     isr_core_cycles[c], fires ? "," : "",
+                     fires ? isr_core_cycles[c] / fires : 0);
+        }
+
         float efficiency = stats.signals_sent > 0 ?
                            (float)stats.signals_received / stats.signals_sent * 100 : 0;
         ESP_LOGI(TAG, "  Efficiency: %.1f%%", efficiency);
@@ -150,6 +761,43 @@ void monitor_task(void *pvParameters) {
     }
 }
 
+// ================= ISR INSTALL THUNKS ==========================
+// Exactly the calls that allocate each interrupt, packaged so the
+// steering layer can run them on the chosen core (they may execute
+// inside that core's IPC task).
+static void button_isr_install(void *arg) {
+    ESP_ERROR_CHECK(gpio_install_isr_service(0));
+    ESP_ERROR_CHECK(gpio_isr_handler_add(BUTTON_PIN, button_isr_handler, NULL));
+}
+
+static void gptimer_isr_install(void *arg) {
+    gptimer_event_callbacks_t cbs = { .on_alarm = timer_callback };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(gptimer));
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = 8000000, // 8s
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_start(gptimer));
+}
+
+static void sample_timer_isr_install(void *arg) {
+    gptimer_event_callbacks_t cbs = { .on_alarm = sample_timer_callback };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(sample_timer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(sample_timer));
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = 1000,   // 1 kHz at 1 MHz resolution
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(sample_timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_start(sample_timer));
+}
+
 // ======================= APP MAIN ==============================
 void app_main(void) {
     ESP_LOGI(TAG, "Binary Semaphores Lab Starting...");
@@ -160,7 +808,26 @@ void app_main(void) {
     gpio_set_direction(LED_TIMER, GPIO_MODE_OUTPUT);
     gpio_set_direction(BUTTON_PIN, GPIO_MODE_INPUT);
     gpio_set_pull_mode(BUTTON_PIN, GPIO_PULLUP_ONLY);
-    gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_NEGEDGE);
+    // Both edges: the coalescing layer needs to see releases too, so it
+    // can tell a press burst from a release burst by the settled level.
+    gpio_set_intr_type(BUTTON_PIN, GPIO_INTR_ANYEDGE);
+
+#if SOC_GPIO_SUPPORT_PIN_GLITCH_FILTER
+    // Hardware first line of defense: pulses shorter than two IO_MUX
+    // clocks never raise the interrupt at all.
+    gpio_glitch_filter_handle_t button_filter = NULL;
+    gpio_pin_glitch_filter_config_t filter_config = {
+        .clk_src = GLITCH_FILTER_CLK_SRC_DEFAULT,
+        .gpio_num = BUTTON_PIN,
+    };
+    ESP_ERROR_CHECK(gpio_new_pin_glitch_filter(&filter_config, &button_filter));
+    ESP_ERROR_CHECK(gpio_glitch_filter_enable(button_filter));
+    ESP_LOGI(TAG, "Hardware glitch filter armed on GPIO%d", BUTTON_PIN);
+#else
+    // Classic ESP32 has no pin glitch filter; the ISR-side batching
+    // absorbs the bounce on its own.
+    ESP_LOGI(TAG, "No hardware glitch filter on this target - relying on edge coalescing");
+#endif
 
     gpio_set_level(LED_PRODUCER, 0);
     gpio_set_level(LED_CONSUMER, 0);
@@ -174,11 +841,27 @@ void app_main(void) {
     if (xBinarySemaphore && xTimerSemaphore && xButtonSemaphore) {
         ESP_LOGI(TAG, "All semaphores created successfully");
 
-        // Button ISR setup
-        gpio_install_isr_service(0);
-        gpio_isr_handler_add(BUTTON_PIN, button_isr_handler, NULL);
+        // Bottom halves first, so the first interrupt after install has
+        // a worker to land on.
+        tbh_start();
+
+        // Button ISR setup - install runs on whichever core the steering
+        // table picks, because the interrupt fires where it was allocated.
+        isr_install_on_core(isr_steer_core("button", ISR_LOAD_MEDIUM),
+                            button_isr_install, NULL);
+
+        // Free-running capture timer for the latency histograms. No alarm
+        // callback, so it allocates no interrupt and needs no steering.
+        gptimer_config_t capture_config = {
+            .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+            .direction = GPTIMER_COUNT_UP,
+            .resolution_hz = 1000000,   // 1 tick = 1 us
+        };
+        ESP_ERROR_CHECK(gptimer_new_timer(&capture_config, &latency_timer));
+        ESP_ERROR_CHECK(gptimer_enable(latency_timer));
+        ESP_ERROR_CHECK(gptimer_start(latency_timer));
 
-        // Timer setup
+        // Timer setup; the interrupt-allocating half goes through steering.
         gptimer_config_t timer_config = {
             .clk_src = GPTIMER_CLK_SRC_DEFAULT,
             .direction = GPTIMER_COUNT_UP,
@@ -186,24 +869,42 @@ void app_main(void) {
         };
         ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &gptimer));
 
-        gptimer_event_callbacks_t cbs = { .on_alarm = timer_callback };
-        ESP_ERROR_CHECK(gptimer_register_event_callbacks(gptimer, &cbs, NULL));
-        ESP_ERROR_CHECK(gptimer_enable(gptimer));
-
-        gptimer_alarm_config_t alarm_config = {
-            .alarm_count = 8000000, // 8s
-            .reload_count = 0,
-            .flags.auto_reload_on_alarm = true,
-        };
-        ESP_ERROR_CHECK(gptimer_set_alarm_action(gptimer, &alarm_config));
-        ESP_ERROR_CHECK(gptimer_start(gptimer));
+        isr_install_on_core(isr_steer_core("gptimer", ISR_LOAD_LIGHT),
+                            gptimer_isr_install, NULL);
         ESP_LOGI(TAG, "Timer configured for 8-second intervals");
 
+        // Stream channel A/B rig. Note the RAM asymmetry: 256 one-byte
+        // queue items already cost more than the whole 1024-byte stream
+        // ring — the header-per-item tax, before a single byte moves.
+        sample_stream = xStreamBufferCreate(STREAM_BUF_BYTES, STREAM_TRIGGER_BYTES);
+        sample_byte_q = xQueueCreate(256, sizeof(uint8_t));
+        if (sample_stream && sample_byte_q) {
+            gptimer_config_t sample_config = {
+                .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+                .direction = GPTIMER_COUNT_UP,
+                .resolution_hz = 1000000,
+            };
+            ESP_ERROR_CHECK(gptimer_new_timer(&sample_config, &sample_timer));
+            isr_install_on_core(isr_steer_core("sampler", ISR_LOAD_MEDIUM),
+                                sample_timer_isr_install, NULL);
+            xTaskCreate(stream_rx_task, "StreamRx", 2048, NULL, 5, NULL);
+            xTaskCreate(queue_rx_task, "QueueRx", 2048, NULL, 5, NULL);
+            ESP_LOGI(TAG, "Sampler at 1 kHz: stream buffer vs byte queue, 5 s phases");
+        } else {
+            ESP_LOGE(TAG, "Stream channel setup failed - skipping A/B rig");
+        }
+
+        // Hardware edge counting: counter first so no generator edge is
+        // missed, then the simulated 20 kHz encoder on the same pad.
+        isr_install_on_core(isr_steer_core("pcnt", ISR_LOAD_LIGHT),
+                            pulse_counter_install, NULL);
+        pulse_generator_start();
+        ESP_LOGI(TAG, "PCNT counting %d edges/s in hardware (GPIO%d loopback)",
+                 PULSE_GEN_HZ * 2, PULSE_PIN);
+
         // Create tasks
         xTaskCreate(producer_task, "Producer", 2048, NULL, 3, NULL);
         xTaskCreate(consumer_task, "Consumer", 2048, NULL, 2, NULL);
-        xTaskCreate(timer_event_task, "TimerEvent", 2048, NULL, 2, NULL);
-        xTaskCreate(button_event_task, "ButtonEvent", 2048, NULL, 4, NULL);
         xTaskCreate(monitor_task, "Monitor", 2048, NULL, 1, NULL);
 
         ESP_LOGI(TAG, "All tasks created. System operational.");
@@ -1,12 +1,14 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include "esp_random.h"
+#include "perf_bench.h"
 
 static const char *TAG = "COUNTING_SEM";
 
@@ -44,22 +46,74 @@ typedef struct {
 
 system_stats_t stats = {0, 0, 0, 0};
 
-int acquire_resource(const char* user_name) {
-    for (int i = 0; i < MAX_RESOURCES; i++) {
-        if (!resources[i].in_use) {
-            resources[i].in_use = true;
-            strcpy(resources[i].current_user, user_name);
-            resources[i].usage_count++;
-            switch (i) {
-                case 0: gpio_set_level(LED_RESOURCE_1, 1); break;
-                case 1: gpio_set_level(LED_RESOURCE_2, 1); break;
-                case 2: gpio_set_level(LED_RESOURCE_3, 1); break;
-            }
-            stats.resources_in_use++;
-            return i;
+// === Lock-free freelist of resource indices ===
+// The counting semaphore already guarantees a slot exists by the time a
+// task gets past xSemaphoreTake; finding *which* slot used to be a linear
+// scan of the resource array. Free indices now live on a Treiber stack
+// whose head packs {generation:24 | index:8}, so pop/push are a single
+// compare-and-swap each (the generation tag defeats ABA) and acquisition
+// is O(1) regardless of MAX_RESOURCES.
+#define FREELIST_EMPTY  0xFF
+
+static atomic_uint_fast32_t free_stack_head;
+static uint8_t free_stack_next[MAX_RESOURCES];
+
+static void freelist_init(void) {
+    for (int i = 0; i < MAX_RESOURCES - 1; i++) free_stack_next[i] = i + 1;
+    free_stack_next[MAX_RESOURCES - 1] = FREELIST_EMPTY;
+    atomic_store(&free_stack_head, 0);   // generation 0, index 0
+}
+
+static int freelist_pop(void) {
+    uint_fast32_t head = atomic_load(&free_stack_head);
+    for (;;) {
+        uint8_t index = head & 0xFF;
+        if (index == FREELIST_EMPTY) return -1;
+        uint_fast32_t next_head = (((head >> 8) + 1) << 8) | free_stack_next[index];
+        if (atomic_compare_exchange_weak(&free_stack_head, &head, next_head)) {
+            return index;
+        }
+    }
+}
+
+static void freelist_push(int index) {
+    uint_fast32_t head = atomic_load(&free_stack_head);
+    for (;;) {
+        free_stack_next[index] = head & 0xFF;
+        uint_fast32_t next_head = (((head >> 8) + 1) << 8) | (uint8_t)index;
+        if (atomic_compare_exchange_weak(&free_stack_head, &head, next_head)) {
+            return;
         }
     }
-    return -1;
+}
+
+// === Starvation metrics ===
+// Worst observed semaphore wait per task, shown by the resource monitor.
+#define MAX_TRACKED_TASKS (NUM_PRODUCERS + 1)   // producers + load generator
+
+static uint32_t max_wait_ms[MAX_TRACKED_TASKS];
+
+static void record_wait(int task_slot, uint32_t wait_ms) {
+    if (task_slot >= 0 && task_slot < MAX_TRACKED_TASKS &&
+        wait_ms > max_wait_ms[task_slot]) {
+        max_wait_ms[task_slot] = wait_ms;
+    }
+}
+
+int acquire_resource(const char* user_name) {
+    int i = freelist_pop();   // O(1), no lock
+    if (i < 0) return -1;
+
+    resources[i].in_use = true;
+    strcpy(resources[i].current_user, user_name);
+    resources[i].usage_count++;
+    switch (i) {
+        case 0: gpio_set_level(LED_RESOURCE_1, 1); break;
+        case 1: gpio_set_level(LED_RESOURCE_2, 1); break;
+        case 2: gpio_set_level(LED_RESOURCE_3, 1); break;
+    }
+    stats.resources_in_use++;
+    return i;
 }
 
 void release_resource(int index, uint32_t usage_time) {
@@ -73,6 +127,7 @@ void release_resource(int index, uint32_t usage_time) {
             case 2: gpio_set_level(LED_RESOURCE_3, 0); break;
         }
         stats.resources_in_use--;
+        freelist_push(index);
     }
 }
 
@@ -93,6 +148,7 @@ void producer_task(void *pvParameters) {
 
         if (xSemaphoreTake(xCountingSemaphore, pdMS_TO_TICKS(8000)) == pdTRUE) {
             uint32_t wait_ms = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+            record_wait(id - 1, wait_ms);
             stats.successful_acquisitions++;
 
             int res = acquire_resource(name);
@@ -131,6 +187,12 @@ void resource_monitor_task(void *pvParameters) {
         printf("Pool: [");
         for (int i = 0; i < MAX_RESOURCES; i++) printf(resources[i].in_use ? "■" : "□");
         printf("]\n");
+
+        ESP_LOGI(TAG, "Worst wait per task:");
+        for (int i = 0; i < NUM_PRODUCERS; i++) {
+            ESP_LOGI(TAG, "  Producer%d: %lums", i + 1, max_wait_ms[i]);
+        }
+        ESP_LOGI(TAG, "  LoadGen:   %lums", max_wait_ms[NUM_PRODUCERS]);
     }
 }
 
@@ -157,7 +219,10 @@ void load_generator_task(void *pvParameters) {
         gpio_set_level(LED_SYSTEM, 1);
 
         for (int i = 0; i < MAX_RESOURCES + 2; i++) {
+            uint32_t start = xTaskGetTickCount();
             if (xSemaphoreTake(xCountingSemaphore, pdMS_TO_TICKS(100)) == pdTRUE) {
+                record_wait(NUM_PRODUCERS,
+                            (xTaskGetTickCount() - start) * portTICK_PERIOD_MS);
                 int res = acquire_resource("LoadGen");
                 if (res >= 0) {
                     vTaskDelay(pdMS_TO_TICKS(500));
@@ -175,9 +240,132 @@ void load_generator_task(void *pvParameters) {
     }
 }
 
+// === Synchronization primitive benchmark suite ===
+// One table, one methodology: every primitive the semaphore labs argue
+// about, measured through the shared perf_bench harness (cycle-counter
+// timestamps, outlier trimming, PBCSV lines for trend tracking). Runs
+// once at boot before the lab tasks exist so nothing else perturbs the
+// numbers; re-run per IDF upgrade and diff the CSV. The binary
+// semaphore is measured as a task-to-task signal round trip — the
+// ISR-side give is already cycle-accounted in the binary semaphore lab.
+#define SYNC_BENCH_WARMUP 100
+#define SYNC_BENCH_ITERS  400
+
+static SemaphoreHandle_t bench_mutex;
+static SemaphoreHandle_t bench_ping;
+static SemaphoreHandle_t bench_pong;
+static SemaphoreHandle_t bench_counting;
+static QueueHandle_t bench_queue;
+static TaskHandle_t bench_caller;
+static TaskHandle_t notify_echo_handle;
+static volatile bool contender_run;
+
+static void bench_mutex_op(void *arg) {
+    xSemaphoreTake(bench_mutex, portMAX_DELAY);
+    xSemaphoreGive(bench_mutex);
+}
+
+static void bench_counting_op(void *arg) {
+    xSemaphoreTake(bench_counting, portMAX_DELAY);
+    xSemaphoreGive(bench_counting);
+}
+
+static void bench_queue_op(void *arg) {
+    uint32_t v = 0;
+    xQueueSend(bench_queue, &v, 0);
+    xQueueReceive(bench_queue, &v, 0);
+}
+
+static void bench_binsem_rtt(void *arg) {
+    xSemaphoreGive(bench_ping);
+    xSemaphoreTake(bench_pong, portMAX_DELAY);
+}
+
+static void bench_notify_rtt(void *arg) {
+    xTaskNotifyGive(notify_echo_handle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+// Echo partners: block until signalled, answer immediately. Higher
+// priority than the caller so the handoff happens without a tick wait.
+static void binsem_echo_task(void *pvParameters) {
+    while (1) {
+        xSemaphoreTake(bench_ping, portMAX_DELAY);
+        xSemaphoreGive(bench_pong);
+    }
+}
+
+static void notify_echo_task(void *pvParameters) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xTaskNotifyGive(bench_caller);
+    }
+}
+
+// Contention source for the mutex case: hammers the same mutex from the
+// other core with a short critical section, so the benchmarked take
+// regularly finds the lock held.
+static void mutex_contender_task(void *pvParameters) {
+    while (contender_run) {
+        xSemaphoreTake(bench_mutex, portMAX_DELAY);
+        for (volatile int i = 0; i < 20; i++) { }
+        xSemaphoreGive(bench_mutex);
+    }
+    vTaskDelete(NULL);
+}
+
+static void sync_primitive_benchmark(void) {
+    bench_mutex = xSemaphoreCreateMutex();
+    bench_ping = xSemaphoreCreateBinary();
+    bench_pong = xSemaphoreCreateBinary();
+    bench_counting = xSemaphoreCreateCounting(MAX_RESOURCES, MAX_RESOURCES);
+    bench_queue = xQueueCreate(4, sizeof(uint32_t));
+    bench_caller = xTaskGetCurrentTaskHandle();
+    if (!bench_mutex || !bench_ping || !bench_pong || !bench_counting || !bench_queue) {
+        ESP_LOGE(TAG, "Sync benchmark: allocation failed, skipping");
+        return;
+    }
+
+    TaskHandle_t binsem_echo;
+    xTaskCreate(binsem_echo_task, "BinsemEcho", 2048, NULL, 6, &binsem_echo);
+    xTaskCreate(notify_echo_task, "NotifyEcho", 2048, NULL, 6, &notify_echo_handle);
+
+    ESP_LOGI(TAG, "⏱️ Sync primitive benchmark (%d iterations each):", SYNC_BENCH_ITERS);
+    pb_run("mutex/uncontended", bench_mutex_op, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+
+    contender_run = true;
+    xTaskCreatePinnedToCore(mutex_contender_task, "Contender", 2048, NULL, 5,
+                            NULL, portNUM_PROCESSORS > 1 ? 1 : 0);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    pb_run("mutex/contended", bench_mutex_op, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+    contender_run = false;
+    vTaskDelay(pdMS_TO_TICKS(10));   // let the contender see the flag and exit
+
+    pb_run("binsem/roundtrip", bench_binsem_rtt, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+    pb_run("countsem/take-give", bench_counting_op, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+    pb_run("notify/roundtrip", bench_notify_rtt, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+    pb_run("queue/send-recv", bench_queue_op, NULL,
+           SYNC_BENCH_WARMUP, SYNC_BENCH_ITERS);
+
+    vTaskDelete(binsem_echo);
+    vTaskDelete(notify_echo_handle);
+    vSemaphoreDelete(bench_mutex);
+    vSemaphoreDelete(bench_ping);
+    vSemaphoreDelete(bench_pong);
+    vSemaphoreDelete(bench_counting);
+    vQueueDelete(bench_queue);
+}
+
 void app_main(void) {
     ESP_LOGI(TAG, "Counting Semaphores Lab Starting...");
 
+    sync_primitive_benchmark();
+
     gpio_set_direction(LED_RESOURCE_1, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_RESOURCE_2, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_RESOURCE_3, GPIO_MODE_OUTPUT);
@@ -190,6 +378,7 @@ void app_main(void) {
     gpio_set_level(LED_PRODUCER, 0);
     gpio_set_level(LED_SYSTEM, 0);
 
+    freelist_init();
     xCountingSemaphore = xSemaphoreCreateCounting(MAX_RESOURCES, MAX_RESOURCES);
 
     if (xCountingSemaphore != NULL) {
@@ -5,8 +5,12 @@
 #include "freertos/task.h"
 #include "freertos/timers.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
 #include "esp_random.h"
+#include "timing_wheel.h"
 
 static const char *TAG = "SW_TIMERS";
 
@@ -39,9 +43,170 @@ timer_stats_t stats = {0, 0, 0, 0, 0};
 bool led_blink_state = false;
 bool led_heartbeat_state = false;
 
+// ---- Phase-aligned scheduling mode ----
+//
+// Unaligned periods scatter expiries across the timeline, so the CPU
+// never sees an idle window long enough for tickless idle to enter a
+// deep sleep state. With alignment on, every period is snapped to the
+// nearest multiple of a common base — but only when the snap stays
+// inside the caller's declared jitter tolerance — so compatible timers
+// expire at shared wake points and the gaps between wake points stay
+// wide. The status report prints the idle windows actually achieved.
+#define USE_PHASE_ALIGNMENT 1
+#define PHASE_BASE_MS       250
+#define IDLE_WINDOW_MIN_MS  50   // shorter gaps aren't worth counting
+
+static int64_t last_wake_us = 0;
+static uint64_t idle_window_total_ms = 0;
+static uint32_t idle_window_count = 0;
+static uint32_t idle_window_max_ms = 0;
+
+// Snap a period to the shared grid when the declared tolerance allows it.
+static uint32_t phase_aligned_period(const char *name, uint32_t period_ms,
+                                     uint32_t tolerance_ms) {
+#if USE_PHASE_ALIGNMENT
+    uint32_t snapped = ((period_ms + PHASE_BASE_MS / 2) / PHASE_BASE_MS) * PHASE_BASE_MS;
+    if (snapped == 0) snapped = PHASE_BASE_MS;
+    uint32_t diff = snapped > period_ms ? snapped - period_ms : period_ms - snapped;
+    if (diff <= tolerance_ms) {
+        if (diff > 0) {
+            ESP_LOGI(TAG, "🧭 %s: %lums snapped to %lums (±%lums tolerance)",
+                     name, period_ms, snapped, tolerance_ms);
+        }
+        return snapped;
+    }
+    ESP_LOGW(TAG, "🧭 %s: %lums left unaligned (snap to %lums exceeds ±%lums)",
+             name, period_ms, snapped, tolerance_ms);
+#endif
+    return period_ms;
+}
+
+// Called at the top of every timer callback: the gap since the previous
+// wake is the idle window tickless idle could have used.
+static void phase_mark_wake(void) {
+    int64_t now = esp_timer_get_time();
+    if (last_wake_us != 0) {
+        uint32_t gap_ms = (uint32_t)((now - last_wake_us) / 1000);
+        if (gap_ms >= IDLE_WINDOW_MIN_MS) {
+            idle_window_total_ms += gap_ms;
+            idle_window_count++;
+            if (gap_ms > idle_window_max_ms) idle_window_max_ms = gap_ms;
+        }
+    }
+    last_wake_us = now;
+}
+
 void dynamic_timer_callback(TimerHandle_t xTimer);
+static void hrt_report(void);
+
+// ===== Deferred-work executor =====
+//
+// The heartbeat/status/one-shot callbacks used to vTaskDelay inside the
+// timer daemon, so one LED sequence stalled every other software timer.
+// Callbacks are now enqueue-only: the body moves into a closure that a
+// worker pool runs. Three tiers, each a queue plus a dedicated worker at
+// its own priority, each with a declared latency budget from enqueue to
+// start of execution — overruns are counted, not silently absorbed.
+// This is xTimerPendFunctionCall without the shared single daemon:
+// urgent closures never wait behind a slow tier's backlog, and the
+// budget numbers say whether a tier's priority actually holds up.
+#define DWX_TIERS       3
+#define DWX_QUEUE_DEPTH 8
+
+typedef void (*dwx_fn_t)(void *arg);
+
+typedef struct {
+    dwx_fn_t fn;
+    void *arg;
+    int64_t enqueue_us;
+} dwx_item_t;
+
+typedef struct {
+    const char *name;
+    UBaseType_t task_prio;
+    uint32_t budget_us;    // enqueue → start of execution
+} dwx_tier_cfg_t;
+
+enum { DWX_HIGH = 0, DWX_MID, DWX_LOW };
+
+static const dwx_tier_cfg_t dwx_cfg[DWX_TIERS] = {
+    [DWX_HIGH] = { "DwxHigh", 6, 2000 },     // must start within 2 ms
+    [DWX_MID]  = { "DwxMid",  4, 20000 },    // LED sequences, 20 ms
+    [DWX_LOW]  = { "DwxLow",  2, 100000 },   // reports, 100 ms
+};
+
+typedef struct {
+    QueueHandle_t queue;
+    uint32_t dispatched;
+    uint32_t rejected;       // queue full at submit
+    uint32_t overruns;       // started later than the budget
+    uint64_t wait_total_us;
+    uint32_t wait_max_us;
+} dwx_tier_t;
+
+static dwx_tier_t dwx_tiers[DWX_TIERS];
+
+// Callback side: stamp and enqueue, never block. A full tier is an
+// overload signal, not a reason to stall the timer daemon.
+static bool dwx_submit(int tier, dwx_fn_t fn, void *arg) {
+    dwx_item_t item = {
+        .fn = fn,
+        .arg = arg,
+        .enqueue_us = esp_timer_get_time(),
+    };
+    if (xQueueSend(dwx_tiers[tier].queue, &item, 0) != pdPASS) {
+        dwx_tiers[tier].rejected++;
+        return false;
+    }
+    return true;
+}
+
+static void dwx_worker_task(void *pvParameters) {
+    int tier = (int)pvParameters;
+    dwx_tier_t *t = &dwx_tiers[tier];
+    dwx_item_t item;
+
+    while (1) {
+        if (xQueueReceive(t->queue, &item, portMAX_DELAY) != pdPASS) continue;
+
+        uint32_t wait_us = (uint32_t)(esp_timer_get_time() - item.enqueue_us);
+        t->wait_total_us += wait_us;
+        if (wait_us > t->wait_max_us) t->wait_max_us = wait_us;
+        if (wait_us > dwx_cfg[tier].budget_us) {
+            t->overruns++;
+            ESP_LOGW(TAG, "⏳ %s: closure started %luus late (budget %luus)",
+                     dwx_cfg[tier].name, wait_us - dwx_cfg[tier].budget_us,
+                     dwx_cfg[tier].budget_us);
+        }
+
+        item.fn(item.arg);
+        t->dispatched++;
+    }
+}
+
+static bool dwx_init(void) {
+    for (int i = 0; i < DWX_TIERS; i++) {
+        dwx_tiers[i].queue = xQueueCreate(DWX_QUEUE_DEPTH, sizeof(dwx_item_t));
+        if (dwx_tiers[i].queue == NULL) return false;
+        xTaskCreate(dwx_worker_task, dwx_cfg[i].name, 2560,
+                    (void *)i, dwx_cfg[i].task_prio, NULL);
+    }
+    return true;
+}
+
+static void dwx_report(void) {
+    for (int i = 0; i < DWX_TIERS; i++) {
+        dwx_tier_t *t = &dwx_tiers[i];
+        if (t->dispatched == 0 && t->rejected == 0) continue;
+        ESP_LOGI(TAG, "Dwx %s: ran=%lu drop=%lu over=%lu wait avg=%lluus max=%luus",
+                 dwx_cfg[i].name, t->dispatched, t->rejected, t->overruns,
+                 t->dispatched ? t->wait_total_us / t->dispatched : 0,
+                 t->wait_max_us);
+    }
+}
 
 void blink_timer_callback(TimerHandle_t xTimer) {
+    phase_mark_wake();
     stats.blink_count++;
     led_blink_state = !led_blink_state;
     gpio_set_level(LED_BLINK, led_blink_state);
@@ -55,8 +220,9 @@ void blink_timer_callback(TimerHandle_t xTimer) {
     }
 }
 
-void heartbeat_timer_callback(TimerHandle_t xTimer) {
-    stats.heartbeat_count++;
+// Heartbeat body, mid tier: the double pulse blocks for 300 ms — on the
+// worker that costs nothing, in the daemon it used to stall every timer.
+static void heartbeat_work(void *arg) {
     ESP_LOGI(TAG, "💓 Heartbeat Timer: Beat #%lu", stats.heartbeat_count);
 
     gpio_set_level(LED_HEARTBEAT, 1);
@@ -68,14 +234,22 @@ void heartbeat_timer_callback(TimerHandle_t xTimer) {
     gpio_set_level(LED_HEARTBEAT, 0);
 
     if (esp_random() % 4 == 0) {
-        uint32_t new_period = 300 + (esp_random() % 400);
+        uint32_t new_period = phase_aligned_period("BlinkTimer",
+                                                   300 + (esp_random() % 400), 150);
         ESP_LOGI(TAG, "🔧 Adjusting blink period to %lums", new_period);
         xTimerChangePeriod(xBlinkTimer, pdMS_TO_TICKS(new_period), 100);
     }
 }
 
-void status_timer_callback(TimerHandle_t xTimer) {
-    stats.status_count++;
+void heartbeat_timer_callback(TimerHandle_t xTimer) {
+    phase_mark_wake();
+    stats.heartbeat_count++;
+    dwx_submit(DWX_MID, heartbeat_work, NULL);
+}
+
+// Status body, low tier: a 200 ms pulse plus a wall of ESP_LOGI — the
+// definition of work that should never run in the daemon.
+static void status_work(void *arg) {
     ESP_LOGI(TAG, "📊 Status Timer: Update #%lu", stats.status_count);
 
     gpio_set_level(LED_STATUS, 1);
@@ -88,11 +262,26 @@ void status_timer_callback(TimerHandle_t xTimer) {
     ESP_LOGI(TAG, "Status updates:   %lu", stats.status_count);
     ESP_LOGI(TAG, "One-shot events:  %lu", stats.oneshot_count);
     ESP_LOGI(TAG, "Dynamic events:   %lu", stats.dynamic_count);
+    if (idle_window_count > 0) {
+        ESP_LOGI(TAG, "Idle windows:     %lu (avg %llums, max %lums)%s",
+                 idle_window_count,
+                 idle_window_total_ms / idle_window_count,
+                 idle_window_max_ms,
+                 USE_PHASE_ALIGNMENT ? " [aligned]" : "");
+    }
+    hrt_report();
+    dwx_report();
     ESP_LOGI(TAG, "═══════════════════════");
 }
 
-void oneshot_timer_callback(TimerHandle_t xTimer) {
-    stats.oneshot_count++;
+void status_timer_callback(TimerHandle_t xTimer) {
+    phase_mark_wake();
+    stats.status_count++;
+    dwx_submit(DWX_LOW, status_work, NULL);
+}
+
+// One-shot LED sequence, mid tier (500 ms of delays).
+static void oneshot_work(void *arg) {
     ESP_LOGI(TAG, "⚡ One-shot Timer: Event #%lu", stats.oneshot_count);
 
     for (int i = 0; i < 5; i++) {
@@ -101,8 +290,17 @@ void oneshot_timer_callback(TimerHandle_t xTimer) {
         gpio_set_level(LED_ONESHOT, 0);
         vTaskDelay(pdMS_TO_TICKS(50));
     }
+}
 
-    uint32_t random_period = 1000 + (esp_random() % 3000);
+void oneshot_timer_callback(TimerHandle_t xTimer) {
+    phase_mark_wake();
+    stats.oneshot_count++;
+    dwx_submit(DWX_MID, oneshot_work, NULL);
+
+    // Timer bookkeeping stays here — creating and starting a timer is
+    // queue-send cheap, exactly what a daemon callback may do.
+    uint32_t random_period = phase_aligned_period("DynamicTimer",
+                                                  1000 + (esp_random() % 3000), 200);
     ESP_LOGI(TAG, "🎲 Creating dynamic timer (period: %lums)", random_period);
 
     xDynamicTimer = xTimerCreate("DynamicTimer",
@@ -114,8 +312,8 @@ void oneshot_timer_callback(TimerHandle_t xTimer) {
         xTimerStart(xDynamicTimer, 0);
 }
 
-void dynamic_timer_callback(TimerHandle_t xTimer) {
-    stats.dynamic_count++;
+// Dynamic-timer flash, mid tier: 300 ms with all LEDs forced on.
+static void dynamic_work(void *arg) {
     ESP_LOGI(TAG, "🌟 Dynamic Timer: Event #%lu", stats.dynamic_count);
 
     gpio_set_level(LED_BLINK, 1);
@@ -128,11 +326,331 @@ void dynamic_timer_callback(TimerHandle_t xTimer) {
     gpio_set_level(LED_HEARTBEAT, 0);
     gpio_set_level(LED_STATUS, 0);
     gpio_set_level(LED_ONESHOT, 0);
+}
+
+void dynamic_timer_callback(TimerHandle_t xTimer) {
+    phase_mark_wake();
+    stats.dynamic_count++;
+    dwx_submit(DWX_MID, dynamic_work, NULL);
 
     xTimerDelete(xTimer, 100);
     xDynamicTimer = NULL;
 }
 
+// ===== High-resolution timer service =====
+//
+// The FreeRTOS timers above bottom out at tick resolution (10 ms at the
+// default config) plus the daemon task's dispatch latency — fine for
+// LEDs, useless for 100 µs-class periodic work. This service drives a
+// dedicated 1 MHz gptimer alarm through a min-heap of absolute
+// deadlines: the alarm always points at the earliest deadline, expiry
+// processing is O(log n), and each timer chooses its dispatch context —
+// straight from the alarm ISR for callbacks of a few microseconds, or a
+// pinned top-priority task for anything longer or anything that blocks.
+#define HRT_MAX_TIMERS     8
+#define HRT_RESOLUTION_HZ  1000000   // 1 µs per count
+
+typedef void (*hrt_callback_t)(void *arg);
+
+typedef struct {
+    uint64_t deadline;     // absolute µs on the gptimer count
+    uint64_t period;       // 0 = one-shot
+    hrt_callback_t cb;
+    void *arg;
+    bool in_isr;
+    bool active;
+} hrt_timer_t;
+
+static gptimer_handle_t hrt_gptimer;
+static hrt_timer_t hrt_timers[HRT_MAX_TIMERS];
+static int8_t hrt_heap[HRT_MAX_TIMERS];
+static int hrt_heap_size = 0;
+static portMUX_TYPE hrt_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t hrt_dispatch_handle;
+static volatile uint32_t hrt_task_pending;   // bitmask of timers queued to the task
+static uint32_t hrt_isr_dispatches;
+static uint32_t hrt_task_dispatches;
+static uint64_t hrt_late_total_us;
+static uint32_t hrt_late_max_us;
+static uint32_t hrt_late_samples;
+
+// Heap helpers; caller holds hrt_lock. Ordered by absolute deadline.
+static void hrt_heap_push(int id) {
+    int i = hrt_heap_size++;
+    hrt_heap[i] = (int8_t)id;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (hrt_timers[hrt_heap[parent]].deadline <= hrt_timers[hrt_heap[i]].deadline) break;
+        int8_t tmp = hrt_heap[parent]; hrt_heap[parent] = hrt_heap[i]; hrt_heap[i] = tmp;
+        i = parent;
+    }
+}
+
+static int hrt_heap_pop(void) {
+    int id = hrt_heap[0];
+    hrt_heap[0] = hrt_heap[--hrt_heap_size];
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= hrt_heap_size) break;
+        if (child + 1 < hrt_heap_size &&
+            hrt_timers[hrt_heap[child + 1]].deadline < hrt_timers[hrt_heap[child]].deadline) child++;
+        if (hrt_timers[hrt_heap[i]].deadline <= hrt_timers[hrt_heap[child]].deadline) break;
+        int8_t tmp = hrt_heap[i]; hrt_heap[i] = hrt_heap[child]; hrt_heap[child] = tmp;
+        i = child;
+    }
+    return id;
+}
+
+static bool IRAM_ATTR hrt_alarm_isr(gptimer_handle_t timer,
+                                    const gptimer_alarm_event_data_t *edata,
+                                    void *user) {
+    BaseType_t hp_woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&hrt_lock);
+    uint64_t now = edata->count_value;
+    while (hrt_heap_size > 0 && hrt_timers[hrt_heap[0]].deadline <= now) {
+        int id = hrt_heap_pop();
+        hrt_timer_t *t = &hrt_timers[id];
+
+        uint32_t late = (uint32_t)(now - t->deadline);
+        hrt_late_total_us += late;
+        if (late > hrt_late_max_us) hrt_late_max_us = late;
+        hrt_late_samples++;
+
+        if (t->in_isr) {
+            t->cb(t->arg);
+            hrt_isr_dispatches++;
+        } else {
+            hrt_task_pending |= 1u << id;
+        }
+
+        if (t->period) {
+            // Absolute rescheduling: no drift. Resync only after a stall
+            // longer than one period so we never spin on the past.
+            t->deadline += t->period;
+            if (t->deadline <= now) t->deadline = now + t->period;
+            hrt_heap_push(id);
+        } else {
+            t->active = false;
+        }
+    }
+    if (hrt_heap_size > 0) {
+        gptimer_alarm_config_t alarm = {
+            .alarm_count = hrt_timers[hrt_heap[0]].deadline,
+        };
+        gptimer_set_alarm_action(timer, &alarm);
+    }
+    uint32_t pending = hrt_task_pending;
+    portEXIT_CRITICAL_ISR(&hrt_lock);
+
+    if (pending && hrt_dispatch_handle) {
+        vTaskNotifyGiveFromISR(hrt_dispatch_handle, &hp_woken);
+    }
+    return hp_woken == pdTRUE;
+}
+
+// Task-context dispatch, pinned at top priority so the only thing that
+// delays a callback here is an ISR-context one.
+static void hrt_dispatch_task(void *pv) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        portENTER_CRITICAL(&hrt_lock);
+        uint32_t pending = hrt_task_pending;
+        hrt_task_pending = 0;
+        portEXIT_CRITICAL(&hrt_lock);
+        while (pending) {
+            int id = __builtin_ctz(pending);
+            pending &= pending - 1;
+            hrt_timers[id].cb(hrt_timers[id].arg);
+            hrt_task_dispatches++;
+        }
+    }
+}
+
+// Returns a timer id, or -1 when all slots are taken.
+int hrt_start(uint64_t period_us, bool in_isr, hrt_callback_t cb, void *arg) {
+    uint64_t now;
+    gptimer_get_raw_count(hrt_gptimer, &now);
+
+    portENTER_CRITICAL(&hrt_lock);
+    int id = -1;
+    for (int i = 0; i < HRT_MAX_TIMERS; i++) {
+        if (!hrt_timers[i].active) { id = i; break; }
+    }
+    if (id >= 0) {
+        hrt_timers[id] = (hrt_timer_t){
+            .deadline = now + period_us,
+            .period = period_us,
+            .cb = cb,
+            .arg = arg,
+            .in_isr = in_isr,
+            .active = true,
+        };
+        hrt_heap_push(id);
+        gptimer_alarm_config_t alarm = {
+            .alarm_count = hrt_timers[hrt_heap[0]].deadline,
+        };
+        gptimer_set_alarm_action(hrt_gptimer, &alarm);
+    }
+    portEXIT_CRITICAL(&hrt_lock);
+    return id;
+}
+
+bool hrt_init(void) {
+    gptimer_config_t config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = HRT_RESOLUTION_HZ,
+    };
+    if (gptimer_new_timer(&config, &hrt_gptimer) != ESP_OK) return false;
+
+    gptimer_event_callbacks_t cbs = { .on_alarm = hrt_alarm_isr };
+    gptimer_register_event_callbacks(hrt_gptimer, &cbs, NULL);
+    gptimer_enable(hrt_gptimer);
+    gptimer_start(hrt_gptimer);
+
+    xTaskCreatePinnedToCore(hrt_dispatch_task, "HrtDispatch", 3072, NULL,
+                            configMAX_PRIORITIES - 1, &hrt_dispatch_handle, 1);
+    return true;
+}
+
+// Demo load: a 100 µs ISR-context counter (the motor-control stand-in —
+// nothing the software timer path could deliver) and a 10 ms
+// task-context callback.
+static volatile uint32_t hrt_fast_count = 0;
+static uint32_t hrt_slow_count = 0;
+
+static void IRAM_ATTR hrt_fast_callback(void *arg) {
+    hrt_fast_count++;
+}
+
+static void hrt_slow_callback(void *arg) {
+    hrt_slow_count++;
+}
+
+static void hrt_report(void) {
+    if (hrt_late_samples == 0) return;
+    ESP_LOGI(TAG, "HRT: fast=%lu slow=%lu isr=%lu task=%lu late avg=%lluus max=%luus",
+             hrt_fast_count, hrt_slow_count, hrt_isr_dispatches, hrt_task_dispatches,
+             hrt_late_total_us / hrt_late_samples, hrt_late_max_us);
+}
+
+// ===== Timing wheel demo & churn benchmark =====
+// The wheel keeps the same callback-with-context shape as the FreeRTOS
+// timers above but scales past the timer task's command queue: insert,
+// cancel and expiry are O(1) per timer.
+static uint32_t wheel_beat_count = 0;
+
+void wheel_beat_callback(void *arg) {
+    wheel_beat_count++;
+    if (wheel_beat_count % 10 == 0) {
+        ESP_LOGI(TAG, "🎡 Wheel timer: beat #%lu (active=%lu, expired=%lu)",
+                 wheel_beat_count, tw_active_count(), tw_expired_count());
+    }
+}
+
+// Timer-churn throughput: arm+cancel cycles per second, wheel versus
+// the FreeRTOS timer command queue.
+void timer_churn_benchmark_task(void *pvParameters) {
+    const int CYCLES = 2000;
+
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    ESP_LOGI(TAG, "=== Timer churn benchmark (%d arm/cancel cycles) ===", CYCLES);
+
+    TimerHandle_t freertos_timer = xTimerCreate("Churn", pdMS_TO_TICKS(10000),
+                                                pdFALSE, NULL, oneshot_timer_callback);
+    if (freertos_timer != NULL) {
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < CYCLES; i++) {
+            xTimerStart(freertos_timer, portMAX_DELAY);
+            xTimerStop(freertos_timer, portMAX_DELAY);
+        }
+        int64_t freertos_us = esp_timer_get_time() - start;
+        xTimerDelete(freertos_timer, portMAX_DELAY);
+        ESP_LOGI(TAG, "FreeRTOS timers: %lld us → %lld cycles/sec",
+                 freertos_us, freertos_us ? (int64_t)CYCLES * 1000000 / freertos_us : 0);
+    }
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < CYCLES; i++) {
+        tw_handle_t h = tw_start(10000, false, wheel_beat_callback, NULL);
+        tw_cancel(h);
+    }
+    int64_t wheel_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "Timing wheel:    %lld us → %lld cycles/sec",
+             wheel_us, wheel_us ? (int64_t)CYCLES * 1000000 / wheel_us : 0);
+    ESP_LOGI(TAG, "=== Churn benchmark done ===");
+
+    vTaskDelete(NULL);
+}
+
+// ===== Protocol-timeout oneshot demo =====
+// The traffic shape the token oneshots exist for: every request arms a
+// timeout, and most of the time the reply wins the race and cancels it.
+// No timer objects, no create/delete churn — arm into the wheel, cancel
+// by token, and a late cancel after the timeout fired is refused instead
+// of hitting whoever reused the slot.
+#define PROTO_PERIOD_MS  20   // 50 requests (and 50 oneshots) per second
+#define PROTO_INFLIGHT   8    // replies land PROTO_INFLIGHT periods later
+
+static tw_token_t proto_inflight[PROTO_INFLIGHT];
+static uint32_t proto_requests = 0;
+static uint32_t proto_timeouts_fired = 0;
+static uint32_t proto_replies_in_time = 0;
+
+static void proto_timeout_callback(void *arg) {
+    proto_timeouts_fired++;
+}
+
+// Quiescence confirmations from the async cancel path — once this has
+// counted a teardown, its timeout callback provably will not run.
+static uint32_t proto_teardowns_confirmed = 0;
+
+static void proto_teardown_done(void *arg) {
+    proto_teardowns_confirmed++;
+}
+
+void protocol_timeout_task(void *pvParameters) {
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    ESP_LOGI(TAG, "📡 Protocol timeout simulator: %d oneshots/sec",
+             1000 / PROTO_PERIOD_MS);
+
+    while (1) {
+        int idx = proto_requests % PROTO_INFLIGHT;
+
+        // The "reply" for the request armed PROTO_INFLIGHT periods ago
+        // (~160 ms): cancel its timeout. With deadlines of 100-250 ms
+        // some replies win and some lose — both paths exercised. Every
+        // fourth reply models connection teardown and uses the async
+        // cancel: bounded time regardless of what the wheel is doing,
+        // with the completion callback standing in for "now safe to free
+        // the connection state".
+        if (proto_inflight[idx] != TW_TOKEN_NONE) {
+            bool ok = (proto_requests % 4 == 0)
+                ? tw_oneshot_cancel_async(proto_inflight[idx],
+                                          proto_teardown_done, NULL)
+                : tw_oneshot_cancel(proto_inflight[idx]);
+            if (ok) proto_replies_in_time++;
+        }
+
+        // "Send" the next request: deadline armed with zero allocation.
+        proto_inflight[idx] = tw_oneshot(100 + (esp_random() % 150),
+                                         proto_timeout_callback, NULL);
+        proto_requests++;
+
+        if (proto_requests % 500 == 0) {
+            ESP_LOGI(TAG, "📡 Protocol: %lu reqs, %lu replies in time, %lu timeouts, %lu stale cancels",
+                     proto_requests, proto_replies_in_time,
+                     proto_timeouts_fired, tw_stale_cancel_count());
+            ESP_LOGI(TAG, "📡 Teardown: %lu confirmed quiescent, %lu in-flight discards",
+                     proto_teardowns_confirmed, tw_inflight_discard_count());
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(PROTO_PERIOD_MS));
+    }
+}
+
 void timer_control_task(void *pvParameters) {
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(15000));
@@ -152,7 +670,8 @@ void timer_control_task(void *pvParameters) {
                 break;
             case 2:
                 ESP_LOGI(TAG, "⚙️ Change blink period");
-                uint32_t new_period = 200 + (esp_random() % 600);
+                uint32_t new_period = phase_aligned_period("BlinkTimer",
+                                                           200 + (esp_random() % 600), 150);
                 xTimerChangePeriod(xBlinkTimer, pdMS_TO_TICKS(new_period), 100);
                 break;
         }
@@ -172,16 +691,45 @@ void app_main(void) {
     gpio_set_level(LED_STATUS, 0);
     gpio_set_level(LED_ONESHOT, 0);
 
-    xBlinkTimer = xTimerCreate("BlinkTimer", pdMS_TO_TICKS(BLINK_PERIOD), pdTRUE, (void*)1, blink_timer_callback);
-    xHeartbeatTimer = xTimerCreate("HeartbeatTimer", pdMS_TO_TICKS(HEARTBEAT_PERIOD), pdTRUE, (void*)2, heartbeat_timer_callback);
-    xStatusTimer = xTimerCreate("StatusTimer", pdMS_TO_TICKS(STATUS_PERIOD), pdTRUE, (void*)3, status_timer_callback);
-    xOneShotTimer = xTimerCreate("OneShotTimer", pdMS_TO_TICKS(ONESHOT_DELAY), pdFALSE, (void*)4, oneshot_timer_callback);
+    // Workers must exist before the first callback tries to enqueue.
+    if (!dwx_init()) {
+        ESP_LOGE(TAG, "❌ Failed to create deferred-work executor");
+        return;
+    }
+
+    // The base periods already sit on the 250 ms grid, but declaring the
+    // tolerance here keeps them on it if anyone tunes the defines.
+    xBlinkTimer = xTimerCreate("BlinkTimer",
+                               pdMS_TO_TICKS(phase_aligned_period("BlinkTimer", BLINK_PERIOD, 150)),
+                               pdTRUE, (void*)1, blink_timer_callback);
+    xHeartbeatTimer = xTimerCreate("HeartbeatTimer",
+                                   pdMS_TO_TICKS(phase_aligned_period("HeartbeatTimer", HEARTBEAT_PERIOD, 250)),
+                                   pdTRUE, (void*)2, heartbeat_timer_callback);
+    xStatusTimer = xTimerCreate("StatusTimer",
+                                pdMS_TO_TICKS(phase_aligned_period("StatusTimer", STATUS_PERIOD, 500)),
+                                pdTRUE, (void*)3, status_timer_callback);
+    xOneShotTimer = xTimerCreate("OneShotTimer",
+                                 pdMS_TO_TICKS(phase_aligned_period("OneShotTimer", ONESHOT_DELAY, 250)),
+                                 pdFALSE, (void*)4, oneshot_timer_callback);
 
     if (xBlinkTimer && xHeartbeatTimer && xStatusTimer && xOneShotTimer) {
         xTimerStart(xBlinkTimer, 0);
         xTimerStart(xHeartbeatTimer, 0);
         xTimerStart(xStatusTimer, 0);
         xTaskCreate(timer_control_task, "TimerControl", 2048, NULL, 2, NULL);
+
+        if (tw_init()) {
+            tw_start(1000, true, wheel_beat_callback, NULL);
+            xTaskCreate(timer_churn_benchmark_task, "ChurnBench", 3072, NULL, 3, NULL);
+            xTaskCreate(protocol_timeout_task, "ProtoTimeout", 2048, NULL, 3, NULL);
+        }
+
+        if (hrt_init()) {
+            hrt_start(100, true, hrt_fast_callback, NULL);      // 100 µs, ISR context
+            hrt_start(10000, false, hrt_slow_callback, NULL);   // 10 ms, task context
+            ESP_LOGI(TAG, "⏱️ High-resolution timer service running");
+        }
+
         ESP_LOGI(TAG, "✅ All timers started successfully");
     } else {
         ESP_LOGE(TAG, "❌ Failed to create one or more timers");
@@ -0,0 +1,282 @@
+#include "timing_wheel.h"
+#include <string.h>
+#include "freertos/task.h"
+#include "esp_log.h"
+
+static const char *TAG = "TIMING_WHEEL";
+
+#define TW_NONE  (-1)
+#define TW_FINE_SPAN_MS   (TW_FINE_SLOTS * TW_FINE_TICK_MS)
+
+typedef struct {
+    bool in_use;
+    bool armed;
+    bool auto_reload;
+    uint32_t period_ms;
+    uint64_t expiry_ms;          // absolute deadline
+    tw_callback_t callback;
+    void *arg;
+    int slot;                    // owning slot, coarse slots offset by TW_FINE_SLOTS
+    int prev, next;              // intrusive per-slot list, O(1) unlink
+    uint32_t gen;                // bumped on release, invalidates old tokens
+    bool firing;                 // collected by the current tick, owned by the wheel task
+    tw_callback_t done_cb;       // quiescence confirmation for an in-flight cancel
+    void *done_arg;
+} tw_timer_t;
+
+static tw_timer_t timers[TW_MAX_TIMERS];
+static int fine_slots[TW_FINE_SLOTS];
+static int coarse_slots[TW_COARSE_SLOTS];
+static uint64_t wheel_time_ms = 0;
+static uint32_t fine_cursor = 0;
+static uint32_t coarse_cursor = 0;
+static uint32_t expired_total = 0;
+static uint32_t active_total = 0;
+static int free_head = TW_NONE;      // free timer slots, reusing .next links
+static uint32_t stale_cancels = 0;
+static uint32_t inflight_discards = 0;
+static portMUX_TYPE wheel_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Return a slot to the freelist; caller holds wheel_lock. The generation
+// bump is what retires every token handed out for this slot.
+static void slot_release(int idx) {
+    timers[idx].armed = false;
+    timers[idx].in_use = false;
+    timers[idx].gen++;
+    timers[idx].next = free_head;
+    free_head = idx;
+    active_total--;
+}
+
+static int *slot_head(int slot) {
+    return (slot < TW_FINE_SLOTS) ? &fine_slots[slot]
+                                  : &coarse_slots[slot - TW_FINE_SLOTS];
+}
+
+static void slot_insert(int slot, int idx) {
+    int *head = slot_head(slot);
+    timers[idx].slot = slot;
+    timers[idx].prev = TW_NONE;
+    timers[idx].next = *head;
+    if (*head != TW_NONE) timers[*head].prev = idx;
+    *head = idx;
+}
+
+static void slot_unlink(int idx) {
+    tw_timer_t *t = &timers[idx];
+    if (t->prev != TW_NONE) timers[t->prev].next = t->next;
+    else *slot_head(t->slot) = t->next;
+    if (t->next != TW_NONE) timers[t->next].prev = t->prev;
+    t->prev = t->next = TW_NONE;
+}
+
+// Place an armed timer into the right wheel for its remaining delay.
+static void wheel_place(int idx) {
+    tw_timer_t *t = &timers[idx];
+    uint64_t delta = (t->expiry_ms > wheel_time_ms) ? t->expiry_ms - wheel_time_ms : 0;
+
+    if (delta < TW_FINE_SPAN_MS) {
+        uint32_t ticks = (uint32_t)(delta / TW_FINE_TICK_MS);
+        if (ticks == 0) ticks = 1;   // never the current slot
+        slot_insert((fine_cursor + ticks) % TW_FINE_SLOTS, idx);
+    } else {
+        uint32_t ticks = (uint32_t)(delta / TW_COARSE_TICK_MS);
+        if (ticks >= TW_COARSE_SLOTS) ticks = TW_COARSE_SLOTS - 1;
+        slot_insert(TW_FINE_SLOTS + (coarse_cursor + ticks) % TW_COARSE_SLOTS, idx);
+    }
+}
+
+// Advance one fine tick; fire everything due. Runs in the wheel task.
+static void wheel_advance(void) {
+    portENTER_CRITICAL(&wheel_lock);
+    wheel_time_ms += TW_FINE_TICK_MS;
+    fine_cursor = (fine_cursor + 1) % TW_FINE_SLOTS;
+
+    // Collect the expiring chain, then run callbacks outside the lock.
+    // Everything on the chain is marked firing while still under the
+    // lock: from here until its callback runs the wheel task owns the
+    // slot, and a concurrent cancel only marks it (clearing `armed`)
+    // instead of unlinking a node that is no longer in any slot list.
+    int expired = fine_slots[fine_cursor];
+    fine_slots[fine_cursor] = TW_NONE;
+    for (int i = expired; i != TW_NONE; i = timers[i].next)
+        timers[i].firing = true;
+
+    // Cascade the coarse wheel once per second.
+    if (wheel_time_ms % TW_COARSE_TICK_MS == 0) {
+        coarse_cursor = (coarse_cursor + 1) % TW_COARSE_SLOTS;
+        int idx = coarse_slots[coarse_cursor];
+        coarse_slots[coarse_cursor] = TW_NONE;
+        while (idx != TW_NONE) {
+            int next = timers[idx].next;
+            timers[idx].prev = timers[idx].next = TW_NONE;
+            wheel_place(idx);
+            idx = next;
+        }
+    }
+    portEXIT_CRITICAL(&wheel_lock);
+
+    while (expired != TW_NONE) {
+        int idx = expired;
+        tw_callback_t cb = NULL, done = NULL;
+        void *arg = NULL, *done_arg = NULL;
+
+        portENTER_CRITICAL(&wheel_lock);
+        tw_timer_t *t = &timers[idx];
+        expired = t->next;
+        t->prev = t->next = TW_NONE;
+        t->firing = false;
+        if (t->armed) {
+            cb = t->callback;
+            arg = t->arg;
+            expired_total++;
+            if (t->auto_reload) {
+                t->expiry_ms += t->period_ms;
+                wheel_place(idx);
+            } else {
+                slot_release(idx);
+            }
+        } else {
+            // A cancel won the race after this tick collected the slot:
+            // the expiry self-discards, and quiescence is now provable —
+            // hand that proof to whoever asked for it.
+            inflight_discards++;
+            done = t->done_cb;
+            done_arg = t->done_arg;
+            t->done_cb = NULL;
+            slot_release(idx);
+        }
+        portEXIT_CRITICAL(&wheel_lock);
+
+        if (cb) cb(arg);
+        if (done) done(done_arg);
+    }
+}
+
+static void wheel_task(void *pv) {
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(TW_FINE_TICK_MS));
+        wheel_advance();
+    }
+}
+
+bool tw_init(void) {
+    memset(timers, 0, sizeof(timers));
+    for (int i = 0; i < TW_FINE_SLOTS; i++) fine_slots[i] = TW_NONE;
+    for (int i = 0; i < TW_COARSE_SLOTS; i++) coarse_slots[i] = TW_NONE;
+    for (int i = 0; i < TW_MAX_TIMERS - 1; i++) timers[i].next = i + 1;
+    timers[TW_MAX_TIMERS - 1].next = TW_NONE;
+    // Generation 1 so a fresh slot 0 never mints TW_TOKEN_NONE.
+    for (int i = 0; i < TW_MAX_TIMERS; i++) timers[i].gen = 1;
+    free_head = 0;
+
+    if (xTaskCreate(wheel_task, "TimingWheel", 3072, NULL,
+                    configMAX_PRIORITIES - 2, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create wheel task");
+        return false;
+    }
+    ESP_LOGI(TAG, "Timing wheel ready: %d ms fine tick, %d slots, %d timer capacity",
+             TW_FINE_TICK_MS, TW_FINE_SLOTS, TW_MAX_TIMERS);
+    return true;
+}
+
+// Allocate and arm a slot; caller holds wheel_lock.
+static int arm_locked(uint32_t period_ms, bool auto_reload,
+                      tw_callback_t callback, void *arg) {
+    if (free_head == TW_NONE) return TW_NONE;
+    int i = free_head;
+    free_head = timers[i].next;
+    timers[i].in_use = true;
+    timers[i].armed = true;
+    timers[i].auto_reload = auto_reload;
+    timers[i].period_ms = period_ms;
+    timers[i].expiry_ms = wheel_time_ms + period_ms;
+    timers[i].callback = callback;
+    timers[i].arg = arg;
+    timers[i].firing = false;
+    timers[i].done_cb = NULL;
+    wheel_place(i);
+    active_total++;
+    return i;
+}
+
+tw_handle_t tw_start(uint32_t period_ms, bool auto_reload,
+                     tw_callback_t callback, void *arg) {
+    portENTER_CRITICAL(&wheel_lock);
+    tw_handle_t handle = arm_locked(period_ms, auto_reload, callback, arg);
+    portEXIT_CRITICAL(&wheel_lock);
+    return handle;
+}
+
+void tw_cancel(tw_handle_t handle) {
+    if (handle < 0 || handle >= TW_MAX_TIMERS) return;
+    portENTER_CRITICAL(&wheel_lock);
+    if (timers[handle].in_use && timers[handle].armed) {
+        if (timers[handle].firing) {
+            // Collected by the current tick: not in any slot list, owned
+            // by the wheel task. Mark it; the expiry self-discards.
+            timers[handle].armed = false;
+        } else {
+            slot_unlink(handle);
+            slot_release(handle);
+        }
+    }
+    portEXIT_CRITICAL(&wheel_lock);
+}
+
+uint32_t tw_active_count(void) { return active_total; }
+uint32_t tw_expired_count(void) { return expired_total; }
+
+// ---- Zero-alloc oneshots ----
+// TW_MAX_TIMERS fits in the low 8 token bits; generation takes the rest.
+
+tw_token_t tw_oneshot(uint32_t delay_ms, tw_callback_t callback, void *arg) {
+    tw_token_t token = TW_TOKEN_NONE;
+    portENTER_CRITICAL(&wheel_lock);
+    int h = arm_locked(delay_ms, false, callback, arg);
+    // Token minted under the lock: the slot can't fire and be reissued
+    // between arming and the generation read.
+    if (h != TW_NONE) token = (timers[h].gen << 8) | (uint32_t)h;
+    portEXIT_CRITICAL(&wheel_lock);
+    return token;
+}
+
+bool tw_oneshot_cancel(tw_token_t token) {
+    return tw_oneshot_cancel_async(token, NULL, NULL);
+}
+
+bool tw_oneshot_cancel_async(tw_token_t token, tw_callback_t done, void *done_arg) {
+    int idx = (int)(token & 0xFF);
+    uint32_t gen = token >> 8;
+    bool cancelled = false;
+    bool done_now = true;   // quiescent already unless the wheel owns the slot
+
+    if (token == TW_TOKEN_NONE || idx >= TW_MAX_TIMERS) return false;
+    portENTER_CRITICAL(&wheel_lock);
+    if (timers[idx].in_use && timers[idx].armed && timers[idx].gen == gen) {
+        cancelled = true;
+        if (timers[idx].firing) {
+            // In-flight: the current tick collected the slot. Mark it and
+            // leave the confirmation with the wheel task, which calls
+            // `done` once the expiry has provably discarded itself.
+            timers[idx].armed = false;
+            timers[idx].done_cb = done;
+            timers[idx].done_arg = done_arg;
+            done_now = false;
+        } else {
+            slot_unlink(idx);
+            slot_release(idx);
+        }
+    } else {
+        stale_cancels++;   // fired or reused already: refuse, don't misfire
+    }
+    portEXIT_CRITICAL(&wheel_lock);
+
+    // Pending and stale cases are quiescent the moment the lock drops.
+    if (done_now && done) done(done_arg);
+    return cancelled;
+}
+
+uint32_t tw_stale_cancel_count(void) { return stale_cancels; }
+uint32_t tw_inflight_discard_count(void) { return inflight_discards; }
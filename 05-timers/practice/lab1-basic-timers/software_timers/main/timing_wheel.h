@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+// Hierarchical timing wheel.
+//
+// Every FreeRTOS software timer funnels through the single timer task and
+// its command queue, which becomes the bottleneck once a few hundred timers
+// churn. The wheel keeps timers in hashed buckets indexed by expiry tick:
+// insert, cancel and per-tick expiry are all O(1), and one dedicated task
+// advances the wheel instead of queueing a command per operation.
+//
+// Two levels cover short and long timeouts: a fine wheel of 10 ms slots
+// spanning 2.56 s, and a coarse wheel of 1 s slots spanning ~4 min.
+// Coarse entries cascade into the fine wheel as they come due.
+
+#define TW_FINE_SLOTS      256
+#define TW_FINE_TICK_MS    10
+#define TW_COARSE_SLOTS    256
+#define TW_COARSE_TICK_MS  1000
+#define TW_MAX_TIMERS      64
+
+typedef void (*tw_callback_t)(void *arg);
+
+typedef int tw_handle_t;   // index into the wheel's timer table, -1 invalid
+
+// Start the wheel task (call once).
+bool tw_init(void);
+
+// Arm a timer; O(1). Returns a handle for cancellation, or -1 if the
+// timer table is full. Auto-reload timers re-arm themselves on expiry.
+tw_handle_t tw_start(uint32_t period_ms, bool auto_reload,
+                     tw_callback_t callback, void *arg);
+
+// Cancel a timer; O(1). Safe against already-expired one-shot handles.
+void tw_cancel(tw_handle_t handle);
+
+// Counters for the lab monitor.
+uint32_t tw_active_count(void);
+uint32_t tw_expired_count(void);
+
+// ---- Zero-alloc oneshots ----
+//
+// Ad-hoc oneshots (protocol timeouts mostly) arm and cancel tens of
+// times per second; a pre-created timer object per timeout is lifecycle
+// the caller shouldn't have to manage. tw_oneshot arms straight into the
+// wheel and returns a token instead of a raw handle: the token carries
+// the slot's generation, so cancelling after the timeout already fired —
+// the common race — is detected and refused rather than silently
+// cancelling whoever reused the slot.
+
+typedef uint32_t tw_token_t;   // slot index + generation, 0 never valid
+#define TW_TOKEN_NONE  0u
+
+// Arm a single-shot deadline; O(1), no allocation, no handle to manage.
+// Returns TW_TOKEN_NONE if the timer table is full.
+tw_token_t tw_oneshot(uint32_t delay_ms, tw_callback_t callback, void *arg);
+
+// Cancel by token; O(1). Returns true if the oneshot was still pending,
+// false if it already fired, was cancelled, or the token is stale.
+bool tw_oneshot_cancel(tw_token_t token);
+
+// Stale/late cancels refused so far (normal in the reply-wins race).
+uint32_t tw_stale_cancel_count(void);
+
+// Non-blocking cancel with completion notification, for teardown paths
+// that must never stall (xTimerStop can block on the timer command queue;
+// nothing here can). All cases are O(1) and return immediately: a pending
+// oneshot is unlinked on the spot; one whose expiry the current wheel
+// tick has already collected is only marked, and the wheel task discards
+// it without running its callback. The optional `done` callback fires
+// exactly once when quiescence is assured — from the caller for the
+// immediate cases, from the wheel task for the in-flight case. Returns
+// true if the timeout callback will not run, false if it already fired
+// (stale token); `done` is invoked either way.
+bool tw_oneshot_cancel_async(tw_token_t token, tw_callback_t done, void *done_arg);
+
+// Expiries discarded because a cancel won the in-flight race.
+uint32_t tw_inflight_discard_count(void);
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -8,10 +9,12 @@
 #include "freertos/queue.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
+#include "driver/rmt_tx.h"
 #include "driver/adc.h"
 #include "esp_adc_cal.h"
 #include "esp_random.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 
 static const char *TAG = "TIMER_APPS";
 
@@ -56,8 +59,7 @@ typedef struct {
     bool system_healthy;
 } system_health_t;
 
-TimerHandle_t watchdog_timer;
-TimerHandle_t feed_timer;
+TimerHandle_t watchdog_check_timer;
 TimerHandle_t pattern_timer;
 TimerHandle_t sensor_timer;
 TimerHandle_t status_timer;
@@ -80,57 +82,99 @@ pattern_state_t pattern_state = {0, 1, 0, false};
 esp_adc_cal_characteristics_t *adc_chars;
 
 // ======= WATCHDOG SYSTEM =======
+//
+// Check-ins are plain atomic stores, not timer messages. Each watched
+// task owns a slot and bumps its counter whenever it makes progress —
+// one relaxed store, no timer-service round trip. A single low-frequency
+// checker timer polls the counters: a slot whose counter stops moving
+// for longer than its timeout triggers the same escalation the old
+// timeout callback performed, and recovery is declared when the counter
+// moves again.
+
+#define WDT_SLOTS_MAX   4
+#define WDT_CHECK_MS    1000
 
-void recovery_callback(TimerHandle_t timer);
+typedef struct {
+    const char *name;
+    atomic_uint_fast32_t counter;   // bumped by the watched task
+    uint32_t last_seen;
+    uint32_t timeout_ms;
+    uint32_t stalled_ms;            // time since last observed progress
+    bool stalled;
+} wdt_slot_t;
+
+static wdt_slot_t wdt_slots[WDT_SLOTS_MAX];
+static int wdt_slot_count = 0;
+
+int wdt_register(const char *name, uint32_t timeout_ms) {
+    if (wdt_slot_count >= WDT_SLOTS_MAX) return -1;
+    wdt_slot_t *slot = &wdt_slots[wdt_slot_count];
+    slot->name = name;
+    slot->timeout_ms = timeout_ms;
+    atomic_store_explicit(&slot->counter, 0, memory_order_relaxed);
+    return wdt_slot_count++;
+}
 
-void watchdog_timeout_callback(TimerHandle_t timer) {
-    health_stats.watchdog_timeouts++;
-    health_stats.system_healthy = false;
+// The entire feed path: one relaxed store.
+static inline void wdt_checkin(int id) {
+    atomic_fetch_add_explicit(&wdt_slots[id].counter, 1, memory_order_relaxed);
+}
 
-    ESP_LOGE(TAG, "🚨 WATCHDOG TIMEOUT! System may be hung!");
-    ESP_LOGE(TAG, "Feeds=%lu, Timeouts=%lu",
-             health_stats.watchdog_feeds, health_stats.watchdog_timeouts);
+void watchdog_check_callback(TimerHandle_t timer) {
+    for (int i = 0; i < wdt_slot_count; i++) {
+        wdt_slot_t *slot = &wdt_slots[i];
+        uint32_t seen = atomic_load_explicit(&slot->counter, memory_order_relaxed);
+
+        if (seen != slot->last_seen) {
+            slot->last_seen = seen;
+            slot->stalled_ms = 0;
+            health_stats.watchdog_feeds++;
+            if (slot->stalled) {
+                slot->stalled = false;
+                health_stats.system_healthy = true;
+                ESP_LOGI(TAG, "🔄 %s recovered - check-ins resumed", slot->name);
+            }
+            continue;
+        }
 
-    for (int i = 0; i < 10; i++) {
-        gpio_set_level(WATCHDOG_LED, 1);
-        vTaskDelay(pdMS_TO_TICKS(50));
-        gpio_set_level(WATCHDOG_LED, 0);
-        vTaskDelay(pdMS_TO_TICKS(50));
+        slot->stalled_ms += WDT_CHECK_MS;
+        if (slot->stalled_ms >= slot->timeout_ms && !slot->stalled) {
+            slot->stalled = true;
+            health_stats.watchdog_timeouts++;
+            health_stats.system_healthy = false;
+            ESP_LOGE(TAG, "🚨 WATCHDOG TIMEOUT! %s silent for %lums", slot->name, slot->stalled_ms);
+            ESP_LOGE(TAG, "Feeds=%lu, Timeouts=%lu",
+                     health_stats.watchdog_feeds, health_stats.watchdog_timeouts);
+            for (int j = 0; j < 10; j++) {
+                gpio_set_level(WATCHDOG_LED, 1);
+                vTaskDelay(pdMS_TO_TICKS(50));
+                gpio_set_level(WATCHDOG_LED, 0);
+                vTaskDelay(pdMS_TO_TICKS(50));
+            }
+            ESP_LOGW(TAG, "In production: esp_restart() would be called here");
+        }
     }
-
-    ESP_LOGW(TAG, "In production: esp_restart() would be called here");
-    xTimerReset(watchdog_timer, 0);
-    health_stats.system_healthy = true;
 }
 
-void feed_watchdog_callback(TimerHandle_t timer) {
-    static int feed_count = 0;
-    feed_count++;
-
-    if (feed_count == 15) {
-        ESP_LOGW(TAG, "🐛 Simulating hang - stop feeds for 8s");
-        xTimerStop(feed_timer, 0);
-        TimerHandle_t recovery_timer = xTimerCreate("Recovery",
-                                                    pdMS_TO_TICKS(8000),
-                                                    pdFALSE,
-                                                    (void*)0,
-                                                    recovery_callback);
-        xTimerStart(recovery_timer, 0);
-        return;
-    }
-
-    health_stats.watchdog_feeds++;
-    ESP_LOGI(TAG, "🍖 Feeding watchdog #%lu", health_stats.watchdog_feeds);
-    xTimerReset(watchdog_timer, 0);
-    gpio_set_level(STATUS_LED, 1);
-    vTaskDelay(pdMS_TO_TICKS(50));
-    gpio_set_level(STATUS_LED, 0);
-}
+// Stands in for a real worker: checks in every 2 s, and after 15
+// check-ins goes silent for 8 s to demonstrate detection and recovery.
+static int demo_wdt_slot = -1;
 
-void recovery_callback(TimerHandle_t timer) {
-    ESP_LOGI(TAG, "🔄 System recovered - resuming watchdog feeds");
-    xTimerStart(feed_timer, 0);
-    xTimerDelete(timer, 0);
+void watchdog_demo_task(void *p) {
+    int feed_count = 0;
+    while (1) {
+        feed_count++;
+        if (feed_count == 15) {
+            ESP_LOGW(TAG, "🐛 Simulating hang - no check-ins for 8s");
+            vTaskDelay(pdMS_TO_TICKS(8000));
+        }
+        wdt_checkin(demo_wdt_slot);
+        ESP_LOGI(TAG, "🍖 Check-in #%d", feed_count);
+        gpio_set_level(STATUS_LED, 1);
+        vTaskDelay(pdMS_TO_TICKS(50));
+        gpio_set_level(STATUS_LED, 0);
+        vTaskDelay(pdMS_TO_TICKS(WATCHDOG_FEED_MS));
+    }
 }
 
 // ======= LED PATTERNS =======
@@ -143,6 +187,157 @@ void set_pattern_leds(bool led1, bool led2, bool led3) {
 
 void change_led_pattern(led_pattern_t new_pattern);
 
+// ---- RMT pattern engine ----
+//
+// The timer path wakes the timer task for every pattern step; at fast
+// step rates that is measurable CPU for a status LED. The engine instead
+// compiles each led_pattern_t into a per-LED RMT symbol program once at
+// startup, and the RMT peripheral loops the program in hardware — zero
+// CPU per step. change_led_pattern swaps programs by stopping and
+// restarting the channels with the new compiled sequence.
+#define USE_RMT_PATTERNS       1
+#define PATTERN_RMT_LEDS       3
+#define PATTERN_RMT_RES_HZ     312500   // 3.2 us/tick: 8-bit divider floor
+#define PATTERN_MAX_HALF_MS    100      // fits a 15-bit duration at that tick
+#define PATTERN_PROG_SYMBOLS   48
+#define PATTERN_STEPS_MAX      12
+
+typedef struct {
+    uint8_t level;
+    uint16_t ms;                        // 0 terminates the step list
+} pattern_step_t;
+
+typedef struct {
+    rmt_symbol_word_t symbols[PATTERN_PROG_SYMBOLS];
+    size_t count;
+} rmt_program_t;
+
+static const gpio_num_t pattern_led_pins[PATTERN_RMT_LEDS] = {
+    PATTERN_LED_1, PATTERN_LED_2, PATTERN_LED_3
+};
+
+// One step table per pattern per LED. Periods are chosen so every LED's
+// program loops on its own without needing cross-channel sync.
+static const pattern_step_t pattern_scripts[PATTERN_MAX][PATTERN_RMT_LEDS][PATTERN_STEPS_MAX] = {
+    [PATTERN_OFF] = {
+        { {0, 1000}, {0, 0} }, { {0, 1000}, {0, 0} }, { {0, 1000}, {0, 0} },
+    },
+    [PATTERN_SLOW_BLINK] = {
+        { {1, 1000}, {0, 1000}, {0, 0} }, { {0, 2000}, {0, 0} }, { {0, 2000}, {0, 0} },
+    },
+    [PATTERN_FAST_BLINK] = {
+        { {0, 400}, {0, 0} }, { {1, 200}, {0, 200}, {0, 0} }, { {0, 400}, {0, 0} },
+    },
+    [PATTERN_HEARTBEAT] = {
+        { {0, 1000}, {0, 0} }, { {0, 1000}, {0, 0} },
+        { {1, 200}, {0, 100}, {1, 200}, {0, 500}, {0, 0} },
+    },
+    [PATTERN_SOS] = {
+        // dot dot dot dash dash dash dot dot dot, pause; all LEDs together.
+        { {1, 200}, {0, 200}, {1, 200}, {0, 200}, {1, 200}, {0, 600},
+          {1, 600}, {0, 200}, {1, 600}, {0, 200}, {1, 600}, {0, 0} },
+        { {1, 200}, {0, 200}, {1, 200}, {0, 200}, {1, 200}, {0, 600},
+          {1, 600}, {0, 200}, {1, 600}, {0, 200}, {1, 600}, {0, 0} },
+        { {1, 200}, {0, 200}, {1, 200}, {0, 200}, {1, 200}, {0, 600},
+          {1, 600}, {0, 200}, {1, 600}, {0, 200}, {1, 600}, {0, 0} },
+    },
+    [PATTERN_RAINBOW] = {
+        // Binary-counter feel: each LED at half the previous rate.
+        { {1, 300}, {0, 300}, {0, 0} },
+        { {1, 600}, {0, 600}, {0, 0} },
+        { {1, 1200}, {0, 1200}, {0, 0} },
+    },
+};
+
+static rmt_channel_handle_t pattern_chan[PATTERN_RMT_LEDS];
+static rmt_encoder_handle_t pattern_copy_encoder[PATTERN_RMT_LEDS];
+static rmt_program_t pattern_programs[PATTERN_MAX][PATTERN_RMT_LEDS];
+static bool pattern_chan_active[PATTERN_RMT_LEDS] = {false};
+
+// Long levels are split into <=100 ms halves and packed two per symbol.
+static bool pattern_compile(const pattern_step_t *steps, rmt_program_t *prog) {
+    uint32_t ticks_per_ms = PATTERN_RMT_RES_HZ / 1000;
+    uint8_t half_level[2 * PATTERN_PROG_SYMBOLS];
+    uint16_t half_ms[2 * PATTERN_PROG_SYMBOLS];
+    size_t halves = 0;
+
+    for (int i = 0; i < PATTERN_STEPS_MAX && steps[i].ms != 0; i++) {
+        uint32_t remaining = steps[i].ms;
+        while (remaining > 0) {
+            if (halves >= 2 * PATTERN_PROG_SYMBOLS) return false;
+            uint16_t chunk = remaining > PATTERN_MAX_HALF_MS ? PATTERN_MAX_HALF_MS : remaining;
+            half_level[halves] = steps[i].level;
+            half_ms[halves] = chunk;
+            halves++;
+            remaining -= chunk;
+        }
+    }
+    if (halves & 1) {   // symbols carry two halves; pad with a 1 ms repeat
+        half_level[halves] = half_level[halves - 1];
+        half_ms[halves] = 1;
+        halves++;
+    }
+
+    prog->count = halves / 2;
+    for (size_t i = 0; i < prog->count; i++) {
+        prog->symbols[i].level0 = half_level[2 * i];
+        prog->symbols[i].duration0 = half_ms[2 * i] * ticks_per_ms;
+        prog->symbols[i].level1 = half_level[2 * i + 1];
+        prog->symbols[i].duration1 = half_ms[2 * i + 1] * ticks_per_ms;
+    }
+    return true;
+}
+
+static void rmt_pattern_engine_init(void) {
+    for (int led = 0; led < PATTERN_RMT_LEDS; led++) {
+        rmt_tx_channel_config_t chan_config = {
+            .gpio_num = pattern_led_pins[led],
+            .clk_src = RMT_CLK_SRC_DEFAULT,
+            .resolution_hz = PATTERN_RMT_RES_HZ,
+            .mem_block_symbols = 64,
+            .trans_queue_depth = 2,
+        };
+        ESP_ERROR_CHECK(rmt_new_tx_channel(&chan_config, &pattern_chan[led]));
+        rmt_copy_encoder_config_t enc_config = {};
+        ESP_ERROR_CHECK(rmt_new_copy_encoder(&enc_config, &pattern_copy_encoder[led]));
+    }
+    for (int pat = 0; pat < PATTERN_MAX; pat++) {
+        for (int led = 0; led < PATTERN_RMT_LEDS; led++) {
+            if (!pattern_compile(pattern_scripts[pat][led], &pattern_programs[pat][led])) {
+                ESP_LOGE(TAG, "Pattern %d LED %d: program too long", pat, led);
+            }
+        }
+    }
+    ESP_LOGI(TAG, "🎛️ RMT pattern engine ready (%d patterns compiled)", PATTERN_MAX);
+}
+
+// Atomic from the caller's perspective: each channel is stopped, then
+// restarted looping the new program entirely in hardware.
+static void rmt_pattern_apply(led_pattern_t pattern) {
+    rmt_transmit_config_t tx_config = {
+        .loop_count = -1,   // loop forever without CPU involvement
+    };
+    for (int led = 0; led < PATTERN_RMT_LEDS; led++) {
+        if (pattern_chan_active[led]) {
+            ESP_ERROR_CHECK(rmt_disable(pattern_chan[led]));
+        }
+        ESP_ERROR_CHECK(rmt_enable(pattern_chan[led]));
+        pattern_chan_active[led] = true;
+        rmt_program_t *prog = &pattern_programs[pattern][led];
+        ESP_ERROR_CHECK(rmt_transmit(pattern_chan[led], pattern_copy_encoder[led],
+                                     prog->symbols,
+                                     prog->count * sizeof(rmt_symbol_word_t),
+                                     &tx_config));
+    }
+}
+
+// With the engine running the patterns, rotation is a slow timer rather
+// than a per-step callback.
+void pattern_rotate_callback(TimerHandle_t timer) {
+    change_led_pattern((current_pattern + 1) % PATTERN_MAX);
+}
+
+
 void pattern_timer_callback(TimerHandle_t timer) {
     static uint32_t pattern_cycle = 0;
     pattern_cycle++;
@@ -207,7 +402,102 @@ void change_led_pattern(led_pattern_t new_pattern) {
     pattern_state.step = 0;
     pattern_state.state = false;
     health_stats.pattern_changes++;
+#if USE_RMT_PATTERNS
+    rmt_pattern_apply(new_pattern);
+#else
     xTimerReset(pattern_timer, 0);
+#endif
+}
+
+// ======= DRIFT-FREE PERIODIC MODE =======
+//
+// A periodic FreeRTOS timer rescheduled with ChangePeriod restarts each
+// cycle relative to "now", so every late callback pushes all later ones:
+// the phase creeps, and a 100 Hz sample stream smears downstream FFTs.
+// This layer keeps vTaskDelayUntil-style bookkeeping per timer: an
+// absolute next-deadline in µs advances by exactly one nominal period
+// per cycle, and the timer is re-armed with the remaining delta, so
+// lateness in one cycle is corrected in the next instead of accumulated.
+// Per-timer stats record the jitter actually seen and the drift the
+// relative mode would have piled up.
+#define DF_TIMERS_MAX 4
+
+typedef struct {
+    TimerHandle_t handle;
+    const char* name;
+    int64_t period_us;          // nominal
+    int64_t next_deadline_us;   // absolute phase reference
+    int64_t jitter_sum_us;
+    int64_t jitter_max_us;
+    int64_t drift_avoided_us;   // lateness a relative reschedule would keep
+    uint32_t samples;
+    uint32_t overruns;          // cycles skipped after a stall
+} df_timer_t;
+
+static df_timer_t df_timers[DF_TIMERS_MAX];
+static int df_timer_count = 0;
+
+int df_register(TimerHandle_t handle, const char* name, uint32_t period_ms) {
+    if (df_timer_count >= DF_TIMERS_MAX) return -1;
+    df_timer_t* t = &df_timers[df_timer_count];
+    t->handle = handle;
+    t->name = name;
+    t->period_us = (int64_t)period_ms * 1000;
+    t->next_deadline_us = esp_timer_get_time() + t->period_us;
+    return df_timer_count++;
+}
+
+// Call first thing in the callback: records jitter against the absolute
+// deadline, advances the phase by one period, and re-arms the timer with
+// the remaining delta (tick-rounded — the residual is corrected next
+// cycle rather than carried).
+void df_mark(int id) {
+    if (id < 0) return;
+    df_timer_t* t = &df_timers[id];
+    int64_t now = esp_timer_get_time();
+    int64_t late = now - t->next_deadline_us;
+
+    t->jitter_sum_us += late > 0 ? late : -late;
+    if (late > t->jitter_max_us) t->jitter_max_us = late;
+    if (late > 0) t->drift_avoided_us += late;
+    t->samples++;
+
+    t->next_deadline_us += t->period_us;
+    while (t->next_deadline_us <= now) {   // stalled past whole cycles
+        t->next_deadline_us += t->period_us;
+        t->overruns++;
+    }
+
+    TickType_t delay = pdMS_TO_TICKS((uint32_t)((t->next_deadline_us - now) / 1000));
+    if (delay == 0) delay = 1;
+    xTimerChangePeriod(t->handle, delay, 0);
+}
+
+// Nominal period change that keeps the phase reference: the deadline
+// df_mark just advanced is rebased onto the new period.
+void df_set_period(int id, uint32_t period_ms) {
+    if (id < 0) return;
+    df_timer_t* t = &df_timers[id];
+    int64_t new_period = (int64_t)period_ms * 1000;
+    if (new_period == t->period_us) return;
+    t->next_deadline_us += new_period - t->period_us;
+    t->period_us = new_period;
+
+    int64_t now = esp_timer_get_time();
+    while (t->next_deadline_us <= now) t->next_deadline_us += t->period_us;
+    TickType_t delay = pdMS_TO_TICKS((uint32_t)((t->next_deadline_us - now) / 1000));
+    if (delay == 0) delay = 1;
+    xTimerChangePeriod(t->handle, delay, 0);
+}
+
+void df_report(void) {
+    for (int i = 0; i < df_timer_count; i++) {
+        df_timer_t* t = &df_timers[i];
+        if (t->samples == 0) continue;
+        ESP_LOGI(TAG, "⏲️ %s: jitter avg=%lldus max=%lldus overruns=%lu drift avoided=%lldus",
+                 t->name, t->jitter_sum_us / t->samples, t->jitter_max_us,
+                 t->overruns, t->drift_avoided_us);
+    }
 }
 
 // ======= SENSOR SYSTEM =======
@@ -223,7 +513,12 @@ float read_sensor_value(void) {
     return value;
 }
 
+static int sensor_df_id = -1;
+static int status_df_id = -1;
+
 void sensor_timer_callback(TimerHandle_t timer) {
+    df_mark(sensor_df_id);
+
     sensor_data_t data;
     data.value = read_sensor_value();
     data.timestamp = xTaskGetTickCount();
@@ -232,22 +527,27 @@ void sensor_timer_callback(TimerHandle_t timer) {
 
     BaseType_t hpw = pdFALSE;
     xQueueSendFromISR(sensor_queue, &data, &hpw);
-    TickType_t new_period = pdMS_TO_TICKS(1000);
-    if (data.value > 40.0) new_period = pdMS_TO_TICKS(500);
-    else if (data.value < 25.0) new_period = pdMS_TO_TICKS(2000);
-    xTimerChangePeriodFromISR(timer, new_period, &hpw);
+
+    // Adaptive rate goes through the drift-free layer so the phase
+    // reference survives the period change.
+    uint32_t new_period_ms = 1000;
+    if (data.value > 40.0) new_period_ms = 500;
+    else if (data.value < 25.0) new_period_ms = 2000;
+    df_set_period(sensor_df_id, new_period_ms);
     portYIELD_FROM_ISR(hpw);
 }
 
 // ======= STATUS SYSTEM =======
 
 void status_timer_callback(TimerHandle_t timer) {
+    df_mark(status_df_id);
     health_stats.system_uptime_sec = pdTICKS_TO_MS(xTaskGetTickCount()) / 1000;
     ESP_LOGI(TAG, "\n═══════ SYSTEM STATUS ═══════");
     ESP_LOGI(TAG, "Uptime: %lus", health_stats.system_uptime_sec);
     ESP_LOGI(TAG, "Health: %s", health_stats.system_healthy ? "✅" : "❌");
     ESP_LOGI(TAG, "Feeds: %lu | Timeouts: %lu", health_stats.watchdog_feeds, health_stats.watchdog_timeouts);
     ESP_LOGI(TAG, "Patterns: %lu | Sensors: %lu", health_stats.pattern_changes, health_stats.sensor_readings);
+    df_report();
     ESP_LOGI(TAG, "═════════════════════════════");
     gpio_set_level(STATUS_LED, 1);
     vTaskDelay(pdMS_TO_TICKS(200));
@@ -301,9 +601,12 @@ void init_hardware(void) {
 }
 
 void create_timers(void) {
-    watchdog_timer = xTimerCreate("Watchdog", pdMS_TO_TICKS(WATCHDOG_TIMEOUT_MS), pdFALSE, (void*)1, watchdog_timeout_callback);
-    feed_timer = xTimerCreate("Feed", pdMS_TO_TICKS(WATCHDOG_FEED_MS), pdTRUE, (void*)2, feed_watchdog_callback);
+    watchdog_check_timer = xTimerCreate("WdtCheck", pdMS_TO_TICKS(WDT_CHECK_MS), pdTRUE, (void*)1, watchdog_check_callback);
+#if USE_RMT_PATTERNS
+    pattern_timer = xTimerCreate("PatternRotate", pdMS_TO_TICKS(25000), pdTRUE, (void*)3, pattern_rotate_callback);
+#else
     pattern_timer = xTimerCreate("Pattern", pdMS_TO_TICKS(PATTERN_BASE_MS), pdTRUE, (void*)3, pattern_timer_callback);
+#endif
     sensor_timer = xTimerCreate("Sensor", pdMS_TO_TICKS(SENSOR_SAMPLE_MS), pdTRUE, (void*)4, sensor_timer_callback);
     status_timer = xTimerCreate("Status", pdMS_TO_TICKS(STATUS_UPDATE_MS), pdTRUE, (void*)5, status_timer_callback);
 }
@@ -314,18 +617,24 @@ void create_queues(void) {
 }
 
 void start_system(void) {
-    xTimerStart(watchdog_timer, 0);
-    xTimerStart(feed_timer, 0);
+    sensor_df_id = df_register(sensor_timer, "Sensor", SENSOR_SAMPLE_MS);
+    status_df_id = df_register(status_timer, "Status", STATUS_UPDATE_MS);
+    xTimerStart(watchdog_check_timer, 0);
     xTimerStart(pattern_timer, 0);
     xTimerStart(sensor_timer, 0);
     xTimerStart(status_timer, 0);
     xTaskCreate(sensor_processing_task, "SensorProc", 4096, NULL, 5, NULL);
     xTaskCreate(system_monitor_task, "SysMon", 4096, NULL, 3, NULL);
+    demo_wdt_slot = wdt_register("WatchdogDemo", WATCHDOG_TIMEOUT_MS);
+    xTaskCreate(watchdog_demo_task, "WdtDemo", 2048, NULL, 4, NULL);
 }
 
 void app_main(void) {
     ESP_LOGI(TAG, "Timer Applications Lab Starting...");
     init_hardware();
+#if USE_RMT_PATTERNS
+    rmt_pattern_engine_init();
+#endif
     create_queues();
     create_timers();
     start_system();
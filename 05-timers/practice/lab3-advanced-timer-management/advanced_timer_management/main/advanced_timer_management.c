@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -11,7 +13,10 @@
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_random.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
 #include "driver/gpio.h"
+#include "xts.h"
 
 static const char *TAG = "ADV_TIMERS";
 
@@ -76,70 +81,409 @@ TimerHandle_t performance_timer;
 TimerHandle_t dynamic_timers[DYNAMIC_TIMER_MAX];
 uint32_t dynamic_timer_count = 0;
 
+// ================= HEALTH SNAPSHOT =================
+// health_callback used to walk every subsystem and format text each
+// second. Now subsystems publish their own numbers into registered
+// slots of one shared snapshot block whenever those numbers change;
+// the callback just seals a sequence-numbered copy (one memcpy) and
+// delta-compresses it against the previous seal for the uplink:
+// [u32 seq][u16 changed-mask][u32 per changed slot]. Unchanged slots
+// cost zero bytes, so a quiet second uplinks 6 bytes instead of the
+// whole block.
+#define HEALTH_SLOTS_MAX 12
+
+typedef struct {
+    uint32_t seq;
+    uint32_t values[HEALTH_SLOTS_MAX];
+} health_snapshot_t;
+
+static const char *health_slot_names[HEALTH_SLOTS_MAX];
+static int health_slot_count = 0;
+static health_snapshot_t health_live;     // publishers write their slots
+static health_snapshot_t health_sealed;   // last sealed copy
+static uint32_t health_uplink_bytes = 0;
+static uint32_t health_full_bytes = 0;
+
+int health_slot_register(const char *name) {
+    if (health_slot_count >= HEALTH_SLOTS_MAX) return -1;
+    health_slot_names[health_slot_count] = name;
+    return health_slot_count++;
+}
+
+// 32-bit aligned stores are atomic on this core; publishers just write.
+static inline void health_slot_publish(int slot, uint32_t value) {
+    if (slot >= 0) health_live.values[slot] = value;
+}
+
+// Delta-encode the freshly sealed snapshot against the previous one.
+static size_t health_delta_encode(const health_snapshot_t *prev,
+                                  const health_snapshot_t *cur,
+                                  uint8_t *out, size_t cap) {
+    if (cap < 6 + 4u * health_slot_count) return 0;
+    size_t len = 0;
+    memcpy(out, &cur->seq, 4); len += 4;
+    uint16_t mask = 0;
+    size_t mask_at = len; len += 2;
+    for (int i = 0; i < health_slot_count; i++) {
+        if (cur->values[i] != prev->values[i]) {
+            mask |= (1u << i);
+            memcpy(out + len, &cur->values[i], 4);
+            len += 4;
+        }
+    }
+    memcpy(out + mask_at, &mask, 2);
+    return len;
+}
+
+// Slot handles, registered in app_main before any publisher runs.
+static int hs_heap = -1, hs_pool_used = -1, hs_active = -1;
+static int hs_acquires = -1, hs_exhaustions = -1, hs_overruns = -1;
+static int hs_coalesce_members = -1, hs_coalesce_saved = -1;
+
+// ================= TIMER COALESCING =================
+// Many production timers fire within a few ticks of each other, each paying
+// a separate timer-task dispatch. Callers that can tolerate some slack
+// (e.g. telemetry at 1000 ±50 ms) are grouped onto one shared FreeRTOS
+// timer per compatible period: a group fires once and fans out to all its
+// subscribers, so N timers cost one timer-task wakeup instead of N.
+#define COALESCE_GROUPS_MAX      6
+#define COALESCE_SUBSCRIBERS_MAX 8
+
+typedef void (*coalesced_cb_t)(void *context);
+
+typedef struct {
+    bool in_use;
+    uint32_t period_ms;          // the group's shared period
+    uint32_t tolerance_ms;       // tightest tolerance of any member
+    TimerHandle_t shared_timer;
+    coalesced_cb_t callbacks[COALESCE_SUBSCRIBERS_MAX];
+    void* contexts[COALESCE_SUBSCRIBERS_MAX];
+    int subscriber_count;
+    uint32_t fires;
+} coalesce_group_t;
+
+static coalesce_group_t coalesce_groups[COALESCE_GROUPS_MAX];
+static uint32_t coalesce_wakeups_saved = 0;
+
+static void coalesce_group_callback(TimerHandle_t t) {
+    coalesce_group_t *group = (coalesce_group_t*)pvTimerGetTimerID(t);
+    group->fires++;
+    if (group->subscriber_count > 1) {
+        coalesce_wakeups_saved += group->subscriber_count - 1;
+        health_slot_publish(hs_coalesce_saved, coalesce_wakeups_saved);
+    }
+    for (int i = 0; i < group->subscriber_count; i++) {
+        group->callbacks[i](group->contexts[i]);
+    }
+}
+
+// Register a coalescable timer. Joins an existing group whose shared
+// period lies within both the caller's and the group's tolerance,
+// otherwise starts a new group. Returns false when everything is full.
+bool allocate_coalesced(uint32_t period_ms, uint32_t tolerance_ms,
+                        coalesced_cb_t callback, void *context) {
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(50)) != pdTRUE)
+        return false;
+
+    coalesce_group_t *chosen = NULL;
+    for (int i = 0; i < COALESCE_GROUPS_MAX; i++) {
+        coalesce_group_t *g = &coalesce_groups[i];
+        if (!g->in_use || g->subscriber_count >= COALESCE_SUBSCRIBERS_MAX)
+            continue;
+        uint32_t diff = (g->period_ms > period_ms) ? g->period_ms - period_ms
+                                                   : period_ms - g->period_ms;
+        if (diff <= tolerance_ms && diff <= g->tolerance_ms) {
+            chosen = g;
+            break;
+        }
+    }
+
+    if (chosen == NULL) {
+        for (int i = 0; i < COALESCE_GROUPS_MAX; i++) {
+            if (!coalesce_groups[i].in_use) {
+                chosen = &coalesce_groups[i];
+                chosen->in_use = true;
+                chosen->period_ms = period_ms;
+                chosen->tolerance_ms = tolerance_ms;
+                chosen->subscriber_count = 0;
+                chosen->fires = 0;
+                chosen->shared_timer = xTimerCreate("Coalesce",
+                                                    pdMS_TO_TICKS(period_ms),
+                                                    pdTRUE, chosen,
+                                                    coalesce_group_callback);
+                if (chosen->shared_timer == NULL) {
+                    chosen->in_use = false;
+                    chosen = NULL;
+                } else {
+                    xTimerStart(chosen->shared_timer, 0);
+                }
+                break;
+            }
+        }
+    }
+
+    if (chosen != NULL) {
+        if (tolerance_ms < chosen->tolerance_ms)
+            chosen->tolerance_ms = tolerance_ms;
+        chosen->callbacks[chosen->subscriber_count] = callback;
+        chosen->contexts[chosen->subscriber_count] = context;
+        chosen->subscriber_count++;
+        int members = 0;
+        for (int i = 0; i < COALESCE_GROUPS_MAX; i++)
+            if (coalesce_groups[i].in_use)
+                members += coalesce_groups[i].subscriber_count;
+        health_slot_publish(hs_coalesce_members, members);
+    }
+
+    xSemaphoreGive(pool_mutex);
+    return chosen != NULL;
+}
+
 // ================= TIMER POOL =================
+// Free slots live on a lock-free stack of indices: pop on acquire, push
+// on release, both O(1) — at ~1k acquire/release per second the old
+// linear scans were pure waste, and the mutex hold they sat under is
+// gone from this path entirely (a popped slot is exclusively owned).
+// The stack top packs the index in the low byte and a push counter in
+// the high bits so a concurrent pop/push/pop can't replay a stale next
+// pointer (the classic ABA).
+static int8_t pool_free_next[TIMER_POOL_SIZE];
+static _Atomic uint32_t pool_free_top;        // low byte: index+1, 0 = empty
+static _Atomic uint32_t pool_exhaustions;
+static _Atomic uint32_t pool_acquires;
+static _Atomic uint32_t pool_releases;
+
+static void pool_stack_push(int idx) {
+    uint32_t top = atomic_load_explicit(&pool_free_top, memory_order_relaxed);
+    do {
+        pool_free_next[idx] = (int8_t)((top & 0xFF) - 1);
+    } while (!atomic_compare_exchange_weak_explicit(
+        &pool_free_top, &top,
+        ((top & ~0xFFu) + 0x100) | (uint32_t)(idx + 1),
+        memory_order_release, memory_order_relaxed));
+}
+
+static int pool_stack_pop(void) {
+    uint32_t top = atomic_load_explicit(&pool_free_top, memory_order_acquire);
+    while (1) {
+        int idx = (int)(top & 0xFF) - 1;
+        if (idx < 0) return -1;
+        uint32_t next = ((top & ~0xFFu) + 0x100) |
+                        (uint32_t)(pool_free_next[idx] + 1);
+        if (atomic_compare_exchange_weak_explicit(&pool_free_top, &top, next,
+                                                  memory_order_acquire,
+                                                  memory_order_acquire)) {
+            return idx;
+        }
+    }
+}
+
 void init_timer_pool(void) {
     pool_mutex = xSemaphoreCreateMutex();
     for (int i = 0; i < TIMER_POOL_SIZE; i++) {
         timer_pool[i].handle = NULL;
         timer_pool[i].in_use = false;
     }
-    ESP_LOGI(TAG, "Timer pool initialized (%d slots)", TIMER_POOL_SIZE);
+    // Seed the free stack with every index.
+    atomic_store(&pool_free_top, 0);
+    for (int i = TIMER_POOL_SIZE - 1; i >= 0; i--) pool_stack_push(i);
+    memset(coalesce_groups, 0, sizeof(coalesce_groups));
+    ESP_LOGI(TAG, "Timer pool initialized (%d slots, free-index stack)", TIMER_POOL_SIZE);
 }
 
 timer_pool_entry_t* allocate_from_pool(const char* name, TickType_t period,
                                       bool auto_reload, TimerCallbackFunction_t callback) {
-    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(50)) != pdTRUE)
+    int idx = pool_stack_pop();
+    if (idx < 0) {
+        atomic_fetch_add_explicit(&pool_exhaustions, 1, memory_order_relaxed);
+        health_slot_publish(hs_exhaustions, atomic_load(&pool_exhaustions));
+        health_data.failed_creations++;
         return NULL;
-    timer_pool_entry_t* entry = NULL;
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        if (!timer_pool[i].in_use) {
-            entry = &timer_pool[i];
-            entry->in_use = true;
-            entry->id = next_timer_id++;
-            strncpy(entry->name, name, sizeof(entry->name) - 1);
-            entry->period = period;
-            entry->auto_reload = auto_reload;
-            entry->callback = callback;
-            entry->handle = xTimerCreate(name, period, auto_reload, (void*)entry->id, callback);
-            if (!entry->handle) {
-                entry->in_use = false;
-                health_data.failed_creations++;
-                entry = NULL;
-            } else {
-                health_data.total_timers_created++;
-            }
-            break;
-        }
     }
-    xSemaphoreGive(pool_mutex);
+
+    timer_pool_entry_t* entry = &timer_pool[idx];
+    entry->id = next_timer_id++;
+    strncpy(entry->name, name, sizeof(entry->name) - 1);
+    entry->period = period;
+    entry->auto_reload = auto_reload;
+    entry->callback = callback;
+    entry->handle = xTimerCreate(name, period, auto_reload, (void*)entry->id, callback);
+    if (!entry->handle) {
+        health_data.failed_creations++;
+        pool_stack_push(idx);
+        return NULL;
+    }
+    entry->in_use = true;   // published last; health scan reads it first
+    health_data.total_timers_created++;
+    atomic_fetch_add_explicit(&pool_acquires, 1, memory_order_relaxed);
+    health_slot_publish(hs_acquires, atomic_load(&pool_acquires));
+    uint32_t used = atomic_load(&pool_acquires) - atomic_load(&pool_releases);
+    health_slot_publish(hs_pool_used, used * 100 / TIMER_POOL_SIZE);
     return entry;
 }
 
+// O(1) release for callers that kept the entry pointer (the churn path).
+void release_entry_to_pool(timer_pool_entry_t* entry) {
+    if (!entry || !entry->in_use) return;
+    entry->in_use = false;
+    xTimerDelete(entry->handle, 0);
+    entry->handle = NULL;
+    atomic_fetch_add_explicit(&pool_releases, 1, memory_order_relaxed);
+    pool_stack_push((int)(entry - timer_pool));
+    uint32_t used = atomic_load(&pool_acquires) - atomic_load(&pool_releases);
+    health_slot_publish(hs_pool_used, used * 100 / TIMER_POOL_SIZE);
+}
+
+// Compatibility shim for id-only callers; the scan is on the release-by-id
+// path only, never on acquire.
 void release_to_pool(uint32_t id) {
-    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(50)) != pdTRUE)
-        return;
     for (int i = 0; i < TIMER_POOL_SIZE; i++) {
         if (timer_pool[i].in_use && timer_pool[i].id == id) {
-            xTimerDelete(timer_pool[i].handle, 0);
-            timer_pool[i].in_use = false;
-            timer_pool[i].handle = NULL;
-            break;
+            release_entry_to_pool(&timer_pool[i]);
+            return;
         }
     }
-    xSemaphoreGive(pool_mutex);
 }
 
 // ================= PERFORMANCE =================
+// Per-timer latency histograms: fixed power-of-two buckets (1us..32ms+),
+// no heap, updated in O(1) per sample. A single slow callback delays every
+// timer queued behind it in the timer task, so each timer also counts how
+// often it blew the execution budget - that is the offender to hunt.
+#define PERF_HISTOGRAM_BUCKETS   16
+#define PERF_TRACKED_TIMERS      8
+#define CALLBACK_BUDGET_US       1000    // configurable per deployment
+
+typedef struct {
+    uint32_t timer_id;                       // 0 = slot unused
+    uint32_t buckets[PERF_HISTOGRAM_BUCKETS]; // bucket i: [2^i, 2^(i+1)) us
+    uint32_t sample_count;
+    uint32_t max_us;
+    uint32_t budget_overruns;
+} timer_histogram_t;
+
+static timer_histogram_t perf_histograms[PERF_TRACKED_TIMERS];
+
+static timer_histogram_t* histogram_for(uint32_t id) {
+    int free_slot = -1;
+    for (int i = 0; i < PERF_TRACKED_TIMERS; i++) {
+        if (perf_histograms[i].timer_id == id) return &perf_histograms[i];
+        if (perf_histograms[i].timer_id == 0 && free_slot < 0) free_slot = i;
+    }
+    if (free_slot >= 0) {
+        perf_histograms[free_slot].timer_id = id;
+        return &perf_histograms[free_slot];
+    }
+    return NULL;
+}
+
+static void histogram_record(timer_histogram_t *h, uint32_t duration_us) {
+    int bucket = duration_us ? 31 - __builtin_clz(duration_us) : 0;
+    if (bucket >= PERF_HISTOGRAM_BUCKETS) bucket = PERF_HISTOGRAM_BUCKETS - 1;
+    h->buckets[bucket]++;
+    h->sample_count++;
+    if (duration_us > h->max_us) h->max_us = duration_us;
+    if (duration_us > CALLBACK_BUDGET_US) h->budget_overruns++;
+}
+
+// Upper bound of the bucket holding the requested percentile.
+static uint32_t histogram_percentile(const timer_histogram_t *h, uint32_t pct) {
+    uint32_t target = (h->sample_count * pct + 99) / 100;
+    uint32_t cumulative = 0;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+        cumulative += h->buckets[i];
+        if (cumulative >= target) return 1u << (i + 1);
+    }
+    return h->max_us;
+}
+
+// ---- Reservoir sampling ----
+// The power-of-two histograms hold their size forever but answer every
+// percentile with a bucket upper bound — after a multi-hour run "p99 <
+// 2048us" has lost the shape, and a bimodal callback (fast path vs slow
+// path) is invisible inside one bucket. Each tracked timer also keeps a
+// 256-sample reservoir (Algorithm R): every sample is kept until the
+// reservoir fills, then each later sample replaces a random slot with
+// probability 256/seen, so the reservoir stays a uniform sample of the
+// whole run at constant memory. Percentile queries are exact over the
+// held samples, and the quantile export line preserves the distribution
+// shape for offline analysis of overnight soaks.
+#define RSV_SAMPLES          256
+#define RSV_EXPORT_QUANTILES 16
+
+typedef struct {
+    uint32_t timer_id;               // 0 = slot unused
+    uint32_t seen;                   // total samples offered
+    uint32_t samples[RSV_SAMPLES];
+} latency_reservoir_t;
+
+static latency_reservoir_t perf_reservoirs[PERF_TRACKED_TIMERS];
+static uint32_t rsv_scratch[RSV_SAMPLES];   // sort space, used under perf_mutex
+
+static latency_reservoir_t* reservoir_for(uint32_t id) {
+    int free_slot = -1;
+    for (int i = 0; i < PERF_TRACKED_TIMERS; i++) {
+        if (perf_reservoirs[i].timer_id == id) return &perf_reservoirs[i];
+        if (perf_reservoirs[i].timer_id == 0 && free_slot < 0) free_slot = i;
+    }
+    if (free_slot >= 0) {
+        perf_reservoirs[free_slot].timer_id = id;
+        return &perf_reservoirs[free_slot];
+    }
+    return NULL;
+}
+
+// O(1) per sample: at most one random draw and one store.
+static void reservoir_record(latency_reservoir_t *r, uint32_t duration_us) {
+    uint32_t n = r->seen++;
+    if (n < RSV_SAMPLES) {
+        r->samples[n] = duration_us;
+        return;
+    }
+    uint32_t j = esp_random() % (n + 1);
+    if (j < RSV_SAMPLES) r->samples[j] = duration_us;
+}
+
+static int rsv_compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts the held samples into rsv_scratch; caller holds perf_mutex.
+static uint32_t reservoir_sort(const latency_reservoir_t *r) {
+    uint32_t n = r->seen < RSV_SAMPLES ? r->seen : RSV_SAMPLES;
+    memcpy(rsv_scratch, r->samples, n * sizeof(uint32_t));
+    qsort(rsv_scratch, n, sizeof(uint32_t), rsv_compare);
+    return n;
+}
+
+// Arbitrary percentile in tenths (pct_x10 = 995 → p99.5), exact over the
+// sorted reservoir. Call reservoir_sort first.
+static uint32_t reservoir_percentile(uint32_t n, uint32_t pct_x10) {
+    if (n == 0) return 0;
+    uint32_t idx = (uint64_t)(n - 1) * pct_x10 / 1000;
+    return rsv_scratch[idx];
+}
+
 void record_perf(uint32_t id, uint32_t duration_us, bool ok) {
     if (xSemaphoreTake(perf_mutex, 0) == pdTRUE) {
         performance_sample_t *s = &perf_buffer[perf_index];
         s->timer_id = id;
         s->callback_duration_us = duration_us;
         s->accuracy_ok = ok;
-        s->callback_start_time = esp_timer_get_time()/1000;
+        // xts stamp: comparable with trace events from either core.
+        s->callback_start_time = (uint32_t)(xts_now_us() / 1000);
         perf_index = (perf_index + 1) % PERFORMANCE_BUFFER_SIZE;
-        if (duration_us > 1000)
+        if (duration_us > 1000) {
             health_data.callback_overruns++;
+            health_slot_publish(hs_overruns, health_data.callback_overruns);
+        }
+        timer_histogram_t *h = histogram_for(id);
+        if (h)
+            histogram_record(h, duration_us);
+        latency_reservoir_t *r = reservoir_for(id);
+        if (r)
+            reservoir_record(r, duration_us);
         xSemaphoreGive(perf_mutex);
     }
 }
@@ -163,19 +507,57 @@ void analyze_performance(void) {
     if (count > 0) {
         uint32_t avg = total / count;
         health_data.average_accuracy = ((float)ok_count / count) * 100;
-        ESP_LOGI(TAG, "📊 Avg=%luus Max=%luus Min=%luus Accuracy=%.1f%%", 
+        ESP_LOGI(TAG, "📊 Avg=%luus Max=%luus Min=%luus Accuracy=%.1f%%",
                  avg, max, min, health_data.average_accuracy);
         gpio_set_level(PERFORMANCE_LED, avg > 500);
     }
+
+    for (int i = 0; i < PERF_TRACKED_TIMERS; i++) {
+        timer_histogram_t *h = &perf_histograms[i];
+        if (h->timer_id == 0 || h->sample_count == 0)
+            continue;
+        ESP_LOGI(TAG, "  Timer %lu: p50<%luus p95<%luus p99<%luus max=%luus (%lu samples)",
+                 h->timer_id,
+                 histogram_percentile(h, 50),
+                 histogram_percentile(h, 95),
+                 histogram_percentile(h, 99),
+                 h->max_us, h->sample_count);
+        if (h->budget_overruns > 0)
+            ESP_LOGW(TAG, "  ⚠️ Timer %lu exceeded %uus budget %lu times",
+                     h->timer_id, CALLBACK_BUDGET_US, h->budget_overruns);
+
+        // Reservoir view: exact values instead of bucket bounds, plus a
+        // quantile export line a soak-test collector can plot to see the
+        // shape (bimodality included) the buckets flatten.
+        latency_reservoir_t *r = reservoir_for(h->timer_id);
+        if (r && r->seen > 0) {
+            uint32_t n = reservoir_sort(r);
+            ESP_LOGI(TAG, "  reservoir(%lu/%lu): p50=%luus p90=%luus p99=%luus p99.5=%luus",
+                     n, r->seen,
+                     reservoir_percentile(n, 500),
+                     reservoir_percentile(n, 900),
+                     reservoir_percentile(n, 990),
+                     reservoir_percentile(n, 995));
+            char line[200];
+            int pos = snprintf(line, sizeof(line), "RSV,%lu,%lu", h->timer_id, r->seen);
+            for (int q = 0; q < RSV_EXPORT_QUANTILES; q++) {
+                pos += snprintf(line + pos, sizeof(line) - pos, ",%lu",
+                                reservoir_percentile(n, q * 1000 / (RSV_EXPORT_QUANTILES - 1)));
+                if (pos >= (int)sizeof(line)) break;
+            }
+            ESP_LOGI(TAG, "%s", line);
+        }
+    }
     xSemaphoreGive(perf_mutex);
+    xts_report();
 }
 
 // ================= CALLBACKS =================
 void perf_callback(TimerHandle_t t) {
-    uint32_t start = esp_timer_get_time();
+    uint32_t start = (uint32_t)xts_now_us();
     volatile uint32_t it = 100 + (esp_random() % 400);
     while (it--) {}
-    uint32_t dur = esp_timer_get_time() - start;
+    uint32_t dur = (uint32_t)xts_now_us() - start;
     record_perf((uint32_t)pvTimerGetTimerID(t), dur, dur < 1000);
 }
 
@@ -185,21 +567,45 @@ void stress_callback(TimerHandle_t t) {
     gpio_set_level(STRESS_LED, blink);
 }
 
+// Stand-in for the telemetry publishers: each has its own counter but
+// none cares about ±50 ms of jitter, so all share one coalesced timer.
+static uint32_t telemetry_counts[4];
+
+void telemetry_callback(void *context) {
+    uint32_t *count = (uint32_t*)context;
+    (*count)++;
+}
+
+// Seals the published snapshot and delta-compresses it for the uplink.
+// No subsystem queries, no formatting on the hot path: one struct copy,
+// one compare pass. The human-readable line appears every 5th seal.
 void health_callback(TimerHandle_t t) {
-    health_data.free_heap_bytes = esp_get_free_heap_size();
-    int used = 0, active = 0;
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        if (timer_pool[i].in_use) {
-            used++;
-            if (xTimerIsTimerActive(timer_pool[i].handle))
-                active++;
-        }
+    health_snapshot_t prev = health_sealed;
+    health_live.seq = prev.seq + 1;
+    health_sealed = health_live;            // the seal: one memcpy
+
+    uint8_t uplink[6 + 4 * HEALTH_SLOTS_MAX];
+    size_t len = health_delta_encode(&prev, &health_sealed,
+                                     uplink, sizeof(uplink));
+    health_uplink_bytes += len;
+    health_full_bytes += 6 + 4 * health_slot_count;
+
+    uint32_t used_pct = health_sealed.values[hs_pool_used];
+    gpio_set_level(HEALTH_LED, used_pct > 80);
+
+    if (health_sealed.seq % 5 == 0) {
+        ESP_LOGI(TAG, "🏥 Health #%lu: Active=%lu Used=%lu%% Heap=%luB acq=%lu exhausted=%lu overruns=%lu",
+                 health_sealed.seq,
+                 health_sealed.values[hs_active], used_pct,
+                 health_sealed.values[hs_heap],
+                 health_sealed.values[hs_acquires],
+                 health_sealed.values[hs_exhaustions],
+                 health_sealed.values[hs_overruns]);
+        ESP_LOGI(TAG, "📡 Uplink: %u B this seal (%lu B total vs %lu B uncompressed) | 🧲 %lu coalesced, %lu wakeups saved",
+                 (unsigned)len, health_uplink_bytes, health_full_bytes,
+                 health_sealed.values[hs_coalesce_members],
+                 health_sealed.values[hs_coalesce_saved]);
     }
-    health_data.active_timers = active;
-    health_data.pool_utilization = (used * 100) / TIMER_POOL_SIZE;
-    gpio_set_level(HEALTH_LED, health_data.pool_utilization > 80);
-    ESP_LOGI(TAG, "🏥 Health: Active=%lu Used=%lu%% Heap=%luB",
-             health_data.active_timers, health_data.pool_utilization, health_data.free_heap_bytes);
 }
 
 // ================= DYNAMIC =================
@@ -215,11 +621,117 @@ TimerHandle_t create_dynamic(const char *name, uint32_t period_ms, TimerCallback
     return t;
 }
 
+// ================= JITTER BENCHMARK =================
+// stress_callback loads the timer task but never characterizes what the
+// load does to everyone else. This suite sweeps the active-timer count
+// (10/50/200), runs a fixed-period probe timer alongside the load, and
+// timestamps each probe expiry with the CPU cycle counter. The deviation
+// of each expiry-to-expiry delta from the requested period feeds the
+// same power-of-two histogram the perf path uses, so one line per load
+// level gives the p50/p95/p99 jitter curve — how dispatch degrades as
+// the timer queue fills is exactly the capacity-planning number needed
+// before consolidating more images onto one MCU.
+#define JB_PROBE_PERIOD_MS   50
+#define JB_SAMPLES           100
+#define JB_LOAD_MAX          200
+
+static timer_histogram_t jb_hist;
+static uint32_t jb_last_cycles;
+static volatile bool jb_done;
+
+void jb_probe_callback(TimerHandle_t t) {
+    uint32_t now = esp_cpu_get_cycle_count();
+    if (jb_last_cycles != 0 && !jb_done) {
+        // Cycle-count subtraction survives the 2^32 wrap.
+        uint32_t delta = now - jb_last_cycles;
+        uint32_t expected = JB_PROBE_PERIOD_MS * 1000 * esp_rom_get_cpu_ticks_per_us();
+        uint32_t diff = delta > expected ? delta - expected : expected - delta;
+        histogram_record(&jb_hist, diff / esp_rom_get_cpu_ticks_per_us());
+        if (jb_hist.sample_count >= JB_SAMPLES) jb_done = true;
+    }
+    jb_last_cycles = now;
+}
+
+// Minimal body: the point of the load timers is queue pressure, not work.
+void jb_load_callback(TimerHandle_t t) {
+    volatile int sink = 0;
+    (void)sink;
+}
+
+void jitter_benchmark_task(void *p) {
+    static TimerHandle_t load_timers[JB_LOAD_MAX];
+    const int load_levels[] = {10, 50, 200};
+
+    // Let the stress task's 30 s churn finish so the sweep measures the
+    // load it creates itself, nothing else.
+    vTaskDelay(pdMS_TO_TICKS(40000));
+    ESP_LOGI(TAG, "=== Timer jitter sweep (probe %d ms, %d samples/level) ===",
+             JB_PROBE_PERIOD_MS, JB_SAMPLES);
+
+    for (int level = 0; level < 3; level++) {
+        int count = load_levels[level];
+        int created = 0;
+        for (int i = 0; i < count; i++) {
+            // Staggered prime-ish periods keep expiries spread out rather
+            // than phase-locked into one burst per second.
+            load_timers[i] = xTimerCreate("JbLoad",
+                                          pdMS_TO_TICKS(20 + (i * 7) % 130 + 1),
+                                          pdTRUE, NULL, jb_load_callback);
+            if (load_timers[i]) {
+                xTimerStart(load_timers[i], portMAX_DELAY);
+                created++;
+            }
+        }
+
+        memset(&jb_hist, 0, sizeof(jb_hist));
+        jb_hist.timer_id = 1;   // any nonzero id; histogram is private here
+        jb_last_cycles = 0;
+        jb_done = false;
+
+        TimerHandle_t probe = xTimerCreate("JbProbe", pdMS_TO_TICKS(JB_PROBE_PERIOD_MS),
+                                           pdTRUE, NULL, jb_probe_callback);
+        xTimerStart(probe, portMAX_DELAY);
+        while (!jb_done) vTaskDelay(pdMS_TO_TICKS(500));
+        xTimerStop(probe, portMAX_DELAY);
+        xTimerDelete(probe, portMAX_DELAY);
+
+        ESP_LOGI(TAG, "  %3d timers: jitter p50<%luus p95<%luus p99<%luus max=%luus",
+                 created,
+                 histogram_percentile(&jb_hist, 50),
+                 histogram_percentile(&jb_hist, 95),
+                 histogram_percentile(&jb_hist, 99),
+                 jb_hist.max_us);
+
+        for (int i = 0; i < count; i++) {
+            if (load_timers[i]) {
+                xTimerStop(load_timers[i], portMAX_DELAY);
+                xTimerDelete(load_timers[i], portMAX_DELAY);
+                load_timers[i] = NULL;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+
+    ESP_LOGI(TAG, "=== Jitter sweep done ===");
+    vTaskDelete(NULL);
+}
+
 // ================= TASKS =================
 void perf_analysis_task(void *p) {
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
         analyze_performance();
+
+        // This task doubles as the slow-path health publisher: the pool
+        // walk (needs xTimerIsTimerActive) happens here, not in the
+        // health seal callback.
+        int active = 0;
+        for (int i = 0; i < TIMER_POOL_SIZE; i++)
+            if (timer_pool[i].in_use && xTimerIsTimerActive(timer_pool[i].handle))
+                active++;
+        health_slot_publish(hs_active, active);
+        health_slot_publish(hs_heap, esp_get_free_heap_size());
+
         ESP_LOGI(TAG, "Free heap: %lu bytes", esp_get_free_heap_size());
         gpio_set_level(ERROR_LED, esp_get_free_heap_size() < 20000);
     }
@@ -236,7 +748,7 @@ void stress_task(void *p) {
     }
     vTaskDelay(pdMS_TO_TICKS(30000));
     for (int i = 0; i < 10; i++)
-        if (entries[i]) release_to_pool(entries[i]->id);
+        if (entries[i]) release_entry_to_pool(entries[i]);
     for (int i = 0; i < 5; i++) {
         char n[16]; sprintf(n, "D%d", i);
         create_dynamic(n, 200 + i*100, perf_callback);
@@ -264,12 +776,33 @@ void create_sys_timers(void) {
 void app_main(void) {
     ESP_LOGI(TAG, "Advanced Timer Management Starting...");
     init_gpio();
+    xts_init();   // perf stamps ride the cross-core timeline
     init_timer_pool();
     perf_mutex = xSemaphoreCreateMutex();
     memset(perf_buffer, 0, sizeof(perf_buffer));
+
+    // Register health slots before any publisher can run.
+    hs_heap             = health_slot_register("heap_free");
+    hs_pool_used        = health_slot_register("pool_used_pct");
+    hs_active           = health_slot_register("active_timers");
+    hs_acquires         = health_slot_register("pool_acquires");
+    hs_exhaustions      = health_slot_register("pool_exhaustions");
+    hs_overruns         = health_slot_register("callback_overruns");
+    hs_coalesce_members = health_slot_register("coalesce_members");
+    hs_coalesce_saved   = health_slot_register("coalesce_saved");
+    health_slot_publish(hs_heap, esp_get_free_heap_size());
+
     create_sys_timers();
+
+    // Four ~1 Hz telemetry timers collapse into a single shared timer.
+    allocate_coalesced(1000, 50, telemetry_callback, &telemetry_counts[0]);
+    allocate_coalesced( 980, 50, telemetry_callback, &telemetry_counts[1]);
+    allocate_coalesced(1040, 50, telemetry_callback, &telemetry_counts[2]);
+    allocate_coalesced(1020, 50, telemetry_callback, &telemetry_counts[3]);
+
     xTaskCreate(perf_analysis_task, "PerfAnalysis", 4096, NULL, 8, NULL);
     vTaskDelay(pdMS_TO_TICKS(3000));
     xTaskCreate(stress_task, "StressTest", 4096, NULL, 5, NULL);
+    xTaskCreate(jitter_benchmark_task, "JitterBench", 4096, NULL, 4, NULL);
     ESP_LOGI(TAG, "🚀 System Running (LED2=Perf, LED4=Health, LED5=Stress, LED18=Error)");
 }
\ No newline at end of file
@@ -1,12 +1,24 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_random.h"
+#include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
 #include "driver/gpio.h"
+#include "nvs_flash.h"
+#include "nvs.h"
 
 static const char *TAG = "EVENT_GROUPS";
 
@@ -30,6 +42,10 @@ EventGroupHandle_t system_events;
 #define BASIC_SYSTEM_BITS   (NETWORK_READY_BIT | CONFIG_READY_BIT)
 #define ALL_SUBSYSTEM_BITS  (NETWORK_READY_BIT | SENSOR_READY_BIT | \
                             CONFIG_READY_BIT | STORAGE_READY_BIT)
+// What boot actually waits for: storage is lazy-initialized on first
+// use and deliberately off the critical path.
+#define EAGER_SYSTEM_BITS   (NETWORK_READY_BIT | SENSOR_READY_BIT | \
+                            CONFIG_READY_BIT)
 #define FULL_SYSTEM_BITS    (ALL_SUBSYSTEM_BITS | SYSTEM_READY_BIT)
 
 // สถิติระบบ
@@ -44,56 +60,1248 @@ typedef struct {
 
 static system_stats_t stats = {0};
 
-// Network initialization task
-void network_init_task(void *pvParameters) {
+// ===== Batched event delivery =====
+// Waking the monitor on every bit transition thrashes once producers
+// multiply: each flip costs a context switch just to log it. Producers
+// go through the wrappers below, which still set/clear the real event
+// group bits (waiters are unaffected) but also record the transition in
+// a timestamped ring. The monitor drains the whole ring at most once per
+// flush interval — except priority bits (SYSTEM_READY_BIT), which wake
+// it immediately.
+#define EVENT_BATCH_SIZE     32
+#define EVENT_BATCH_FLUSH_MS 2000
+#define EVENT_PRIORITY_BITS  SYSTEM_READY_BIT
+
+typedef struct {
+    uint32_t timestamp_ms;
+    EventBits_t set_bits;       // bits set in this transition (0 if clear)
+    EventBits_t cleared_bits;   // bits cleared (0 if set)
+    EventBits_t bits_after;     // group state after the transition
+} event_transition_t;
+
+static event_transition_t event_batch[EVENT_BATCH_SIZE];
+static uint32_t batch_head = 0;     // next write slot
+static uint32_t batch_count = 0;    // valid entries (caps at EVENT_BATCH_SIZE)
+static uint32_t batch_dropped = 0;  // transitions lost to ring overflow
+static portMUX_TYPE batch_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t event_monitor_handle = NULL;
+
+// ===== Event transition journal =====
+//
+// Post-mortems need the transition history, but a flash write per
+// transition would wreck the latency the batching above bought. The
+// journal splits the work: the hot path appends one cycle-stamped record
+// to a RAM ring (inside the critical section batch_record already
+// holds), and a low-priority task persists coalesced batches to a ring
+// of NVS blob slots — NVS wear-levels underneath and the slot rotation
+// spreads the keys on top. At boot, before anything else runs, the
+// highest-sequence slot is dumped as the pre-crash tail.
+#define JOURNAL_RING        64
+#define JOURNAL_BATCH_MAX   16     // records per flash blob
+#define JOURNAL_FLUSH_MS    5000
+#define JOURNAL_FLASH_SLOTS 8
+#define JOURNAL_NAMESPACE   "evtjrnl"
+
+typedef struct {
+    uint32_t cycles;            // CPU cycle count at the transition
+    EventBits_t set_bits;
+    EventBits_t cleared_bits;
+    EventBits_t bits_after;
+} journal_rec_t;
+
+typedef struct {
+    uint32_t seq;               // monotonically increasing batch number
+    uint32_t count;
+    journal_rec_t recs[JOURNAL_BATCH_MAX];
+} journal_blob_t;
+
+static journal_rec_t journal_ring[JOURNAL_RING];
+static uint32_t journal_head = 0;      // total records appended
+static uint32_t journal_flushed = 0;   // total records persisted
+static uint32_t journal_lost = 0;      // overwritten before flush
+static uint32_t journal_seq = 0;
+static nvs_handle_t journal_nvs;
+static bool journal_ready = false;
+
+// One ring store; caller holds batch_lock.
+static inline void journal_append(EventBits_t set_bits, EventBits_t cleared_bits,
+                                  EventBits_t after) {
+    journal_rec_t *rec = &journal_ring[journal_head % JOURNAL_RING];
+    rec->cycles = esp_cpu_get_cycle_count();
+    rec->set_bits = set_bits;
+    rec->cleared_bits = cleared_bits;
+    rec->bits_after = after;
+    journal_head++;
+}
+
+static void journal_flush_task(void *pvParameters) {
+    journal_blob_t blob;
+    char key[8];
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(JOURNAL_FLUSH_MS));
+        while (1) {
+            portENTER_CRITICAL(&batch_lock);
+            uint32_t pending = journal_head - journal_flushed;
+            if (pending > JOURNAL_RING) {   // lapped before we got here
+                journal_lost += pending - JOURNAL_RING;
+                journal_flushed = journal_head - JOURNAL_RING;
+                pending = JOURNAL_RING;
+            }
+            uint32_t n = pending < JOURNAL_BATCH_MAX ? pending : JOURNAL_BATCH_MAX;
+            for (uint32_t i = 0; i < n; i++)
+                blob.recs[i] = journal_ring[(journal_flushed + i) % JOURNAL_RING];
+            journal_flushed += n;
+            portEXIT_CRITICAL(&batch_lock);
+            if (n == 0) break;
+
+            blob.seq = ++journal_seq;
+            blob.count = n;
+            snprintf(key, sizeof(key), "j%u", (unsigned)(blob.seq % JOURNAL_FLASH_SLOTS));
+            if (nvs_set_blob(journal_nvs, key,
+                             &blob, sizeof(blob) - (JOURNAL_BATCH_MAX - n) * sizeof(journal_rec_t)) == ESP_OK) {
+                nvs_commit(journal_nvs);
+            }
+            if (n < JOURNAL_BATCH_MAX) break;   // drained
+        }
+    }
+}
+
+// Dump the newest persisted batch from the previous run — the pre-crash
+// tail — then continue the sequence from where it stopped.
+static void journal_boot_dump(void) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK || nvs_open(JOURNAL_NAMESPACE, NVS_READWRITE, &journal_nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "📓 Journal: flash unavailable, persistence off");
+        return;
+    }
+    journal_ready = true;
+
+    static journal_blob_t blob, newest;
+    char key[8];
+    newest.seq = 0;
+    for (int i = 0; i < JOURNAL_FLASH_SLOTS; i++) {
+        size_t len = sizeof(blob);
+        snprintf(key, sizeof(key), "j%d", i);
+        if (nvs_get_blob(journal_nvs, key, &blob, &len) == ESP_OK &&
+            blob.seq > newest.seq) {
+            newest = blob;
+        }
+    }
+    if (newest.seq == 0) {
+        ESP_LOGI(TAG, "📓 Journal: no previous history");
+        return;
+    }
+    journal_seq = newest.seq;
+
+    uint32_t tpu = esp_rom_get_cpu_ticks_per_us();
+    ESP_LOGI(TAG, "📓 Journal: pre-crash tail (batch #%lu, %lu transitions):",
+             newest.seq, newest.count);
+    for (uint32_t i = 0; i < newest.count && i < JOURNAL_BATCH_MAX; i++) {
+        journal_rec_t *r = &newest.recs[i];
+        ESP_LOGI(TAG, "  [%lu us] set=0x%02X clear=0x%02X state=0x%02X",
+                 r->cycles / tpu, r->set_bits, r->cleared_bits, r->bits_after);
+    }
+}
+
+static void batch_record(EventBits_t set_bits, EventBits_t cleared_bits,
+                         EventBits_t after) {
+    portENTER_CRITICAL(&batch_lock);
+    event_transition_t *slot = &event_batch[batch_head];
+    slot->timestamp_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    slot->set_bits = set_bits;
+    slot->cleared_bits = cleared_bits;
+    slot->bits_after = after;
+    batch_head = (batch_head + 1) % EVENT_BATCH_SIZE;
+    if (batch_count < EVENT_BATCH_SIZE) batch_count++;
+    else batch_dropped++;
+    journal_append(set_bits, cleared_bits, after);
+    portEXIT_CRITICAL(&batch_lock);
+
+    // Only priority bits interrupt the monitor's batching interval
+    if (((set_bits | cleared_bits) & EVENT_PRIORITY_BITS) &&
+        event_monitor_handle != NULL) {
+        xTaskNotifyGive(event_monitor_handle);
+    }
+}
+
+// Defined with the composite-wait facility below; transitions poke it so
+// the coordinator wakes on change instead of polling.
+static void health_poke(EventBits_t bits_after);
+
+void event_bits_set_batched(EventBits_t bits) {
+    xEventGroupSetBits(system_events, bits);
+    EventBits_t after = xEventGroupGetBits(system_events);
+    batch_record(bits, 0, after);
+    health_poke(after);
+}
+
+void event_bits_clear_batched(EventBits_t bits) {
+    xEventGroupClearBits(system_events, bits);
+    EventBits_t after = xEventGroupGetBits(system_events);
+    batch_record(0, bits, after);
+    health_poke(after);
+}
+
+// ===== Boot profiler =====
+// Boot time is a shipping requirement (power-cycle recovery under 2 s)
+// and a stopwatch cannot attribute it. Every init step writes
+// cycle-stamped begin/end markers into an RTC_NOINIT buffer, which
+// survives a reset, and on the next boot the decoder prints a
+// flame-style breakdown of the previous boot before anything else runs.
+// Marks are binary (step index + cycle count), so recording one costs a
+// couple of stores on the boot path itself.
+#define BOOTPROF_MAX_MARKS 32
+#define BOOTPROF_MAGIC     0xB007B007
+
+typedef struct {
+    uint8_t step;          // index into bootprof_step_names
+    uint8_t is_end;
+    uint32_t cycles;       // esp_cpu_get_cycle_count at the mark
+} bootprof_mark_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot_count;
+    uint32_t mark_count;
+    bootprof_mark_t marks[BOOTPROF_MAX_MARKS];
+} bootprof_buf_t;
+
+// Step names live in flash and could move between firmware builds, so
+// marks carry indexes into this table instead of pointers.
+static const char *bootprof_step_names[] = {
+    "storage", "config", "network", "sensor", "system",
+};
+
+static RTC_NOINIT_ATTR bootprof_buf_t bootprof;
+
+static void bootprof_mark(int step, bool is_end) {
+    if (bootprof.mark_count >= BOOTPROF_MAX_MARKS) return;
+    bootprof_mark_t *mark = &bootprof.marks[bootprof.mark_count++];
+    mark->step = (uint8_t)step;
+    mark->is_end = is_end;
+    mark->cycles = esp_cpu_get_cycle_count();
+}
+
+// Decode the previous boot's trace, then arm the buffer for this one.
+static void bootprof_boot(void) {
+    uint32_t ticks_per_us = esp_rom_get_cpu_ticks_per_us();
+
+    if (bootprof.magic == BOOTPROF_MAGIC && bootprof.mark_count > 0) {
+        uint32_t base = bootprof.marks[0].cycles;
+        uint32_t span = bootprof.marks[bootprof.mark_count - 1].cycles - base;
+        if (span == 0) span = 1;
+
+        ESP_LOGI(TAG, "🔥 Previous boot trace (boot #%lu, %lu marks):",
+                 bootprof.boot_count, bootprof.mark_count);
+        for (int step = 0; step < (int)(sizeof(bootprof_step_names) /
+                                        sizeof(bootprof_step_names[0])); step++) {
+            uint32_t begin = 0, end = 0;
+            bool have_begin = false, have_end = false;
+            for (uint32_t i = 0; i < bootprof.mark_count; i++) {
+                if (bootprof.marks[i].step != step) continue;
+                if (bootprof.marks[i].is_end) { end = bootprof.marks[i].cycles; have_end = true; }
+                else { begin = bootprof.marks[i].cycles; have_begin = true; }
+            }
+            if (!have_begin || !have_end) continue;
+
+            // Flame-style bar: position = start offset, width = duration.
+            char bar[33];
+            uint32_t lead = (uint64_t)(begin - base) * 32 / span;
+            uint32_t fill = (uint64_t)(end - begin) * 32 / span;
+            if (fill == 0) fill = 1;
+            for (uint32_t i = 0; i < 32; i++)
+                bar[i] = (i >= lead && i < lead + fill) ? '#' : ' ';
+            bar[32] = '\0';
+            ESP_LOGI(TAG, "  %-8s |%s| %6lu - %6lu us",
+                     bootprof_step_names[step],
+                     bar,
+                     (begin - base) / ticks_per_us,
+                     (end - base) / ticks_per_us);
+        }
+        ESP_LOGI(TAG, "  Previous boot total: %lu us", span / ticks_per_us);
+    } else {
+        ESP_LOGI(TAG, "🔥 No boot trace (cold boot or first run)");
+        bootprof.magic = BOOTPROF_MAGIC;
+        bootprof.boot_count = 0;
+    }
+
+    bootprof.boot_count++;
+    bootprof.mark_count = 0;
+}
+
+// ===== Wait-site instrumentation =====
+// Every xEventGroupWaitBits either succeeds or times out, and the log
+// never says how close to the edge it ran — a 10 s timeout that
+// routinely takes 9.5 s is a latency problem wearing a passing grade.
+// Each wait site registers once with its timeout budget; the wrapper
+// times the wait into power-of-two microsecond buckets and counts
+// timeout hits and near-budget passes (>= 75% of the budget used), all
+// in preallocated slots, nothing on the wait path but one timestamp
+// pair and an increment.
+#define EWT_SITES_MAX 4
+#define EWT_BUCKETS   24   // bucket i: [2^i, 2^(i+1)) us
+
+typedef struct {
+    const char *name;
+    TickType_t budget;
+    uint32_t buckets[EWT_BUCKETS];
+    uint32_t waits;
+    uint32_t timeouts;
+    uint32_t near_budget;
+    uint32_t max_us;
+} ewt_site_t;
+
+static ewt_site_t ewt_sites[EWT_SITES_MAX];
+static int ewt_site_count = 0;
+
+static int ewt_register(const char *name, TickType_t budget) {
+    ewt_sites[ewt_site_count] = (ewt_site_t){ .name = name, .budget = budget };
+    return ewt_site_count++;
+}
+
+static EventBits_t ewt_wait_bits(int site, EventGroupHandle_t group, EventBits_t bits,
+                                 BaseType_t clear_on_exit, BaseType_t wait_all) {
+    ewt_site_t *s = &ewt_sites[site];
+    int64_t t0 = esp_timer_get_time();
+    EventBits_t out = xEventGroupWaitBits(group, bits, clear_on_exit, wait_all, s->budget);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    int bucket = us ? 31 - __builtin_clz(us) : 0;
+    if (bucket >= EWT_BUCKETS) bucket = EWT_BUCKETS - 1;
+    s->buckets[bucket]++;
+    s->waits++;
+    if (us > s->max_us) s->max_us = us;
+
+    bool satisfied = wait_all ? ((out & bits) == bits) : ((out & bits) != 0);
+    if (!satisfied) {
+        s->timeouts++;
+    } else if (s->budget != portMAX_DELAY) {
+        uint64_t budget_us = (uint64_t)s->budget * portTICK_PERIOD_MS * 1000;
+        if ((uint64_t)us * 4 >= budget_us * 3) s->near_budget++;
+    }
+    return out;
+}
+
+static void ewt_report(void) {
+    ESP_LOGI(TAG, "⏲️ Wait-site distribution:");
+    for (int i = 0; i < ewt_site_count; i++) {
+        ewt_site_t *s = &ewt_sites[i];
+        if (s->waits == 0) continue;
+        ESP_LOGI(TAG, "  %-12s %lu waits | %lu timeouts | %lu near-budget | max %luus",
+                 s->name, s->waits, s->timeouts, s->near_budget, s->max_us);
+        for (int b = 0; b < EWT_BUCKETS; b++) {
+            if (s->buckets[b])
+                ESP_LOGI(TAG, "    [%8lu..%8luus) %lu",
+                         1ul << b, 1ul << (b + 1), s->buckets[b]);
+        }
+    }
+}
+
+static int ewt_init_deps, ewt_phase1, ewt_phase2;
+
+// ===== Lazy first-use initialization =====
+// Every subsystem used to pay its full init cost at boot, storage
+// included — 3.6 s of simulated mount/fsck/database work for a
+// filesystem nothing touches for the first minute. Subsystems now
+// register an init thunk and stay cold until the first accessor calls
+// lazy_ensure(): the accessor that wins the gate runs the thunk,
+// racing accessors block on the gate until it finishes, and from then
+// on the fast path is a single acquire load of the once-flag. Critical
+// subsystems lose nothing — the init dependency graph force-eagers
+// them by calling the same lazy_ensure from their init task, so
+// exactly-once semantics hold no matter which side gets there first.
+#define LAZY_SUBS_MAX 4
+
+typedef void (*lazy_thunk_t)(void);
+
+typedef struct {
+    const char *name;
+    lazy_thunk_t thunk;
+    _Atomic uint8_t ready;      // the once-flag
+    SemaphoreHandle_t gate;     // serializes racing first accessors
+    uint32_t first_use_ms;
+    uint32_t thunk_ms;          // what the deferred init actually cost
+    uint32_t uses;
+} lazy_sub_t;
+
+static lazy_sub_t lazy_subs[LAZY_SUBS_MAX];
+static int lazy_sub_count = 0;
+static int lazy_storage_id = -1, lazy_network_id = -1;
+
+static int lazy_register(const char *name, lazy_thunk_t thunk) {
+    lazy_sub_t *s = &lazy_subs[lazy_sub_count];
+    s->name = name;
+    s->thunk = thunk;
+    s->gate = xSemaphoreCreateMutex();
+    return lazy_sub_count++;
+}
+
+// Post-init accessor cost: this one load.
+static inline bool lazy_is_ready(int id) {
+    return atomic_load_explicit(&lazy_subs[id].ready, memory_order_acquire) != 0;
+}
+
+static void lazy_ensure(int id) {
+    lazy_sub_t *s = &lazy_subs[id];
+    s->uses++;
+    if (atomic_load_explicit(&s->ready, memory_order_acquire) != 0) {
+        return;   // fast path: already up
+    }
+
+    xSemaphoreTake(s->gate, portMAX_DELAY);
+    if (atomic_load_explicit(&s->ready, memory_order_relaxed) == 0) {
+        uint32_t t0 = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        s->first_use_ms = t0;
+        ESP_LOGI(TAG, "🦥 Lazy init '%s' triggered by task '%s' at %lu ms",
+                 s->name, pcTaskGetName(NULL), t0);
+        s->thunk();
+        s->thunk_ms = xTaskGetTickCount() * portTICK_PERIOD_MS - t0;
+        atomic_store_explicit(&s->ready, 1, memory_order_release);
+    }
+    xSemaphoreGive(s->gate);
+}
+
+static void lazy_report(void) {
+    ESP_LOGI(TAG, "🦥 Lazy subsystems:");
+    for (int i = 0; i < lazy_sub_count; i++) {
+        lazy_sub_t *s = &lazy_subs[i];
+        if (lazy_is_ready(i)) {
+            ESP_LOGI(TAG, "  %-8s up: first use %lu ms, init cost %lu ms, %lu uses",
+                     s->name, s->first_use_ms, s->thunk_ms, s->uses);
+        } else {
+            ESP_LOGI(TAG, "  %-8s still cold — boot paid nothing for it", s->name);
+        }
+    }
+}
+
+// ===== Light-sleep negotiation =====
+// The long blocking waits in this lab — the config monitoring loop, the
+// 10 s storage maintenance delay, the heartbeat periods — all burn
+// active idle current. Instead of enabling automatic light sleep (which
+// this lab's timing-sensitive waits could not veto), blocking sites
+// declare two things before they block: how much wake latency they can
+// absorb and when they next need the CPU. A broker at idle priority —
+// which by definition only runs when nothing else is runnable — enters
+// light sleep until the earliest declared deadline, but only while
+// every registered site is parked and tolerant. Unregistered tasks stay
+// honest through tick catch-up after each sleep, at the cost of up to
+// one sleep chunk of extra wake latency.
+
+#define SLUMBER_SITES_MAX     6
+#define SLUMBER_WAKE_COST_US  2000     // light-sleep exit latency we assume
+#define SLUMBER_MIN_SLEEP_US  10000    // below this the entry cost wins
+#define SLUMBER_MAX_CHUNK_US  500000   // cap one entry; broker re-evaluates
+#define SLUMBER_NO_DEADLINE   INT64_MAX
+#define SLUMBER_REPORT_US     (3600LL * 1000 * 1000)   // residency report period
+
+typedef struct {
+    const char *name;
+    uint32_t tolerance_us;          // wake latency the site can absorb
+    volatile bool parked;
+    volatile int64_t deadline_us;   // next moment the site needs the CPU
+    uint32_t parks;
+} slumber_site_t;
+
+static slumber_site_t slumber_sites[SLUMBER_SITES_MAX];
+static int slumber_count = 0;
+static int slumber_cfg_id = -1, slumber_net_id = -1, slumber_storage_id = -1;
+static uint64_t slumber_slept_us = 0;
+static uint32_t slumber_entries = 0, slumber_vetoes = 0, slumber_too_short = 0;
+
+static int slumber_register(const char *name, uint32_t tolerance_us) {
+    if (slumber_count >= SLUMBER_SITES_MAX) return -1;
+    slumber_sites[slumber_count].name = name;
+    slumber_sites[slumber_count].tolerance_us = tolerance_us;
+    slumber_sites[slumber_count].deadline_us = SLUMBER_NO_DEADLINE;
+    return slumber_count++;
+}
+
+// Bracket a blocking call: declare the park before blocking, clear it
+// after. wake_after_us 0 means an indefinite wait (no timer deadline).
+static void slumber_park(int id, int64_t wake_after_us) {
+    if (id < 0) return;
+    slumber_sites[id].deadline_us = wake_after_us > 0
+        ? esp_timer_get_time() + wake_after_us : SLUMBER_NO_DEADLINE;
+    slumber_sites[id].parks++;
+    slumber_sites[id].parked = true;
+}
+
+static void slumber_wake(int id) {
+    if (id < 0) return;
+    slumber_sites[id].parked = false;
+}
+
+// vTaskDelay with the park declared around it — the common case.
+static void slumber_delay_ms(int id, uint32_t ms) {
+    slumber_park(id, (int64_t)ms * 1000);
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    slumber_wake(id);
+}
+
+static void slumber_report(void) {
+    uint64_t up_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    uint64_t slept_ms = slumber_slept_us / 1000;
+    ESP_LOGI(TAG, "😴 Light sleep: %llu ms over %lu entries (%llu s/hour at this rate)",
+             slept_ms, slumber_entries,
+             up_ms ? slept_ms * 3600 / up_ms : 0);
+    ESP_LOGI(TAG, "   %lu vetoes (a site awake or too tight), %lu windows too short",
+             slumber_vetoes, slumber_too_short);
+    for (int i = 0; i < slumber_count; i++) {
+        ESP_LOGI(TAG, "   %-14s tol %5lu us, %lu parks%s", slumber_sites[i].name,
+                 slumber_sites[i].tolerance_us, slumber_sites[i].parks,
+                 slumber_sites[i].parked ? " (parked now)" : "");
+    }
+}
+
+// Idle-priority broker: when this task runs at all, every higher-
+// priority task is already blocked — "all runnable work permits" needs
+// no further proof. The remaining checks are about the registered
+// sites: each must be parked and able to absorb the wake cost.
+static void slumber_broker_task(void *pvParameters) {
+    int64_t last_report = esp_timer_get_time();
+    while (1) {
+        bool all_parked = slumber_count > 0;
+        int64_t next_deadline = SLUMBER_NO_DEADLINE;
+        for (int i = 0; i < slumber_count; i++) {
+            if (!slumber_sites[i].parked ||
+                slumber_sites[i].tolerance_us < SLUMBER_WAKE_COST_US) {
+                all_parked = false;
+                break;
+            }
+            if (slumber_sites[i].deadline_us < next_deadline) {
+                next_deadline = slumber_sites[i].deadline_us;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now - last_report >= SLUMBER_REPORT_US) {
+            slumber_report();
+            last_report = now;
+        }
+
+        if (!all_parked) {
+            slumber_vetoes++;
+            vTaskDelay(pdMS_TO_TICKS(50));
+            continue;
+        }
+
+        int64_t span = (next_deadline == SLUMBER_NO_DEADLINE)
+            ? SLUMBER_MAX_CHUNK_US
+            : next_deadline - now - SLUMBER_WAKE_COST_US;
+        if (span > SLUMBER_MAX_CHUNK_US) span = SLUMBER_MAX_CHUNK_US;
+        if (span < SLUMBER_MIN_SLEEP_US) {
+            slumber_too_short++;
+            vTaskDelay(pdMS_TO_TICKS(20));
+            continue;
+        }
+
+        // The tick timer stops in light sleep; esp_timer is compensated
+        // across it. Measure real slept time there and hand the missed
+        // ticks back to the scheduler so every vTaskDelay in the system
+        // still elapses in wall-clock time.
+        fflush(stdout);
+        esp_sleep_enable_timer_wakeup(span);
+        esp_light_sleep_start();
+        int64_t slept = esp_timer_get_time() - now;
+        slumber_slept_us += slept;
+        slumber_entries++;
+        xTaskCatchUpTicks(pdMS_TO_TICKS(slept / 1000));
+    }
+}
+
+static void storage_archive(uint32_t value);   // first storage accessor
+
+// ===== Init dependency graph =====
+// The subsystems used to start in a conservative order "to be safe",
+// which serialized work that has no real dependency. Each init step now
+// declares exactly which ready bits it needs; the executor lets every
+// step whose prerequisites are met run immediately, spread across both
+// cores, and records timings so the coordinator can print the critical
+// path once the sink step (SYSTEM_READY_BIT) completes.
+#define INIT_STEP_MAX 8
+
+typedef struct {
+    const char *name;
+    EventBits_t ready_bit;     // set when this step completes
+    EventBits_t deps;          // bits that must be set before it starts
+    uint32_t start_ms;
+    uint32_t end_ms;
+    int critical_dep;          // index of the prerequisite that finished last
+    int core;
+} init_step_t;
+
+static init_step_t init_graph[INIT_STEP_MAX];
+static int init_step_count = 0;
+
+static int step_network, step_sensor, step_config, step_storage, step_system;
+
+int init_graph_add(const char *name, EventBits_t ready_bit, EventBits_t deps) {
+    init_step_t *step = &init_graph[init_step_count];
+    step->name = name;
+    step->ready_bit = ready_bit;
+    step->deps = deps;
+    step->critical_dep = -1;
+    return init_step_count++;
+}
+
+// Blocks until every prerequisite bit is set, then stamps the start time
+// and remembers which prerequisite finished last (the gating edge).
+void init_graph_begin(int id) {
+    init_step_t *step = &init_graph[id];
+    if (step->deps != 0) {
+        ESP_LOGI(TAG, "⏳ %s waiting for deps 0x%02X", step->name, step->deps);
+        ewt_wait_bits(ewt_init_deps, system_events, step->deps, pdFALSE, pdTRUE);
+        for (int i = 0; i < init_step_count; i++) {
+            if (!(init_graph[i].ready_bit & step->deps)) continue;
+            if (step->critical_dep < 0 ||
+                init_graph[i].end_ms > init_graph[step->critical_dep].end_ms) {
+                step->critical_dep = i;
+            }
+        }
+    }
+    step->start_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    step->core = xPortGetCoreID();
+    bootprof_mark(id, false);
+}
+
+// Stamps the end time and publishes the ready bit through the batched path.
+void init_graph_complete(int id) {
+    init_step_t *step = &init_graph[id];
+    step->end_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    bootprof_mark(id, true);
+    event_bits_set_batched(step->ready_bit);
+}
+
+// Per-step timing plus the chain of gating edges back from the sink.
+void init_graph_report(int sink_id) {
+    ESP_LOGI(TAG, "═══ INIT DEPENDENCY GRAPH ═══");
+    for (int i = 0; i < init_step_count; i++) {
+        init_step_t *step = &init_graph[i];
+        ESP_LOGI(TAG, "  %-8s core %d  start %5lu ms  end %5lu ms  (%lu ms)",
+                 step->name, step->core, step->start_ms, step->end_ms,
+                 step->end_ms - step->start_ms);
+    }
+    ESP_LOGI(TAG, "Critical path:");
+    int id = sink_id;
+    while (id >= 0) {
+        ESP_LOGI(TAG, "  ⮡ %s (done at %lu ms)",
+                 init_graph[id].name, init_graph[id].end_ms);
+        id = init_graph[id].critical_dep;
+    }
+    ESP_LOGI(TAG, "═════════════════════════════");
+}
+
+// ===== RCU config snapshots =====
+// config_load_task reloads configuration while other tasks read it, and
+// correctness used to rest on the event bits and luck. Readers now cost
+// exactly one atomic load: the writer builds a fresh snapshot in a free
+// pool slot and publishes the pointer atomically; the old snapshot is
+// only recycled after every registered reader has passed a quiescent
+// point (the bottom of its loop), so a reader can never see a snapshot
+// change under its feet. Readers must not cache the pointer across
+// their quiescent mark.
+#define CONFIG_POOL_SLOTS 4
+#define RCU_READERS_MAX   4
+
+typedef struct {
+    uint32_t version;
+    uint32_t sample_period_ms;
+    float temp_limit;
+    float humidity_limit;
+} system_config_t;
+
+enum { SLOT_FREE = 0, SLOT_CURRENT, SLOT_RETIRED };
+
+typedef struct {
+    system_config_t config;
+    int state;
+    uint32_t reader_snapshot[RCU_READERS_MAX];   // counters at retirement
+} config_slot_t;
+
+static config_slot_t config_pool[CONFIG_POOL_SLOTS];
+static _Atomic(system_config_t *) current_config = NULL;
+static atomic_uint_fast32_t rcu_reader_counter[RCU_READERS_MAX];
+static int rcu_reader_count = 0;
+static uint32_t config_reclaimed = 0;
+
+int rcu_reader_register(void) {
+    return rcu_reader_count < RCU_READERS_MAX ? rcu_reader_count++ : -1;
+}
+
+// Read side: one atomic load. Valid until the caller's next quiescent mark.
+static inline const system_config_t *config_get(void) {
+    return atomic_load_explicit(&current_config, memory_order_acquire);
+}
+
+// Called at the bottom of each reader's loop: "I hold no config pointer".
+static inline void rcu_quiescent(int reader_id) {
+    atomic_fetch_add_explicit(&rcu_reader_counter[reader_id], 1,
+                              memory_order_release);
+}
+
+// A retired slot is safe to reuse once every reader's counter has moved
+// past the value it had at retirement — each has been quiescent since.
+static void rcu_reclaim(void) {
+    for (int i = 0; i < CONFIG_POOL_SLOTS; i++) {
+        if (config_pool[i].state != SLOT_RETIRED) continue;
+        bool grace_over = true;
+        for (int r = 0; r < rcu_reader_count; r++) {
+            if (atomic_load_explicit(&rcu_reader_counter[r],
+                                     memory_order_acquire) ==
+                config_pool[i].reader_snapshot[r]) {
+                grace_over = false;
+                break;
+            }
+        }
+        if (grace_over) {
+            config_pool[i].state = SLOT_FREE;
+            config_reclaimed++;
+        }
+    }
+}
+
+// Writer side (config_load_task only): build in a free slot, publish,
+// retire the old snapshot with the current reader counters.
+static bool config_publish(const system_config_t *new_config) {
+    rcu_reclaim();
+
+    config_slot_t *slot = NULL;
+    for (int i = 0; i < CONFIG_POOL_SLOTS; i++) {
+        if (config_pool[i].state == SLOT_FREE) { slot = &config_pool[i]; break; }
+    }
+    if (slot == NULL) {
+        ESP_LOGW(TAG, "⚠️ Config pool exhausted - readers not quiescing?");
+        return false;
+    }
+
+    slot->config = *new_config;
+    slot->state = SLOT_CURRENT;
+
+    system_config_t *old = atomic_exchange_explicit(&current_config,
+                                                    &slot->config,
+                                                    memory_order_acq_rel);
+    if (old != NULL) {
+        config_slot_t *old_slot = (config_slot_t *)old;   // config is first member
+        old_slot->state = SLOT_RETIRED;
+        for (int r = 0; r < rcu_reader_count; r++) {
+            old_slot->reader_snapshot[r] =
+                atomic_load_explicit(&rcu_reader_counter[r], memory_order_acquire);
+        }
+    }
+    return true;
+}
+
+// ===== NVS config cache with lazy write-back =====
+// config_load_task used to treat every configuration access as a storage
+// transaction; on real firmware those are NVS reads on hot paths, one
+// flash access each. The cache loads every known key once into a small
+// open-addressed RAM table, so a read is a hash probe, never flash.
+// Writes only update RAM and mark the slot dirty; a low-priority flusher
+// persists all dirty keys under one nvs_commit. For crash safety the
+// flusher journals the dirty key names to their own NVS blob before
+// touching the values and erases it after the commit — a leftover
+// journal at boot names exactly the keys whose values may be stale.
+#define CFG_CACHE_SLOTS 16          // power of two, linear probing
+#define CFG_KEY_MAX     15          // NVS key length limit
+#define CFG_FLUSH_MS    3000
+#define CFG_NAMESPACE   "cfgcache"
+#define CFG_JOURNAL_KEY "dirtyj"
+
+typedef struct {
+    char key[CFG_KEY_MAX + 1];
+    uint32_t value;
+    bool used;
+    bool dirty;
+} cfg_slot_t;
+
+typedef struct {
+    uint32_t count;
+    char keys[CFG_CACHE_SLOTS][CFG_KEY_MAX + 1];
+} cfg_journal_blob_t;
+
+static cfg_slot_t cfg_cache[CFG_CACHE_SLOTS];
+static portMUX_TYPE cfg_lock = portMUX_INITIALIZER_UNLOCKED;
+static nvs_handle_t cfg_nvs;
+static bool cfg_nvs_ready = false;
+static TaskHandle_t cfg_flusher_handle = NULL;
+
+static uint32_t cfg_ram_hits = 0;        // reads served from the table
+static uint32_t cfg_flash_reads = 0;     // only during the initial bulk load
+static uint32_t cfg_flash_writes = 0;    // keys persisted by the flusher
+static uint32_t cfg_commits = 0;         // nvs_commit calls
+static uint32_t cfg_writes_coalesced = 0; // re-dirtied before a flush
+
+static uint32_t cfg_hash(const char *key) {
+    uint32_t h = 2166136261u;            // FNV-1a
+    while (*key) { h ^= (uint8_t)*key++; h *= 16777619u; }
+    return h;
+}
+
+// Probe for key; on miss claim the first free slot and report it via
+// *claimed so the caller can seed a value. Caller holds cfg_lock.
+static cfg_slot_t *cfg_find_slot(const char *key, bool *claimed) {
+    uint32_t idx = cfg_hash(key) % CFG_CACHE_SLOTS;
+    for (int i = 0; i < CFG_CACHE_SLOTS; i++) {
+        cfg_slot_t *slot = &cfg_cache[(idx + i) % CFG_CACHE_SLOTS];
+        if (!slot->used) {
+            strncpy(slot->key, key, CFG_KEY_MAX);
+            slot->used = true;
+            if (claimed != NULL) *claimed = true;
+            return slot;
+        }
+        if (strcmp(slot->key, key) == 0) return slot;
+    }
+    return NULL;                         // table full
+}
+
+// Read side: hash probe only, never flash.
+static uint32_t cfg_get_u32(const char *key, uint32_t fallback) {
+    portENTER_CRITICAL(&cfg_lock);
+    bool claimed = false;
+    cfg_slot_t *slot = cfg_find_slot(key, &claimed);
+    uint32_t value = fallback;
+    if (slot != NULL) {
+        if (claimed) slot->value = fallback;   // unknown key: adopt default
+        value = slot->value;
+        cfg_ram_hits++;
+    }
+    portEXIT_CRITICAL(&cfg_lock);
+    return value;
+}
+
+// Write side: RAM update + dirty mark; the flusher owns the flash.
+static void cfg_set_u32(const char *key, uint32_t value) {
+    portENTER_CRITICAL(&cfg_lock);
+    bool claimed = false;
+    cfg_slot_t *slot = cfg_find_slot(key, &claimed);
+    if (slot != NULL && (claimed || slot->value != value)) {
+        if (slot->dirty) cfg_writes_coalesced++;
+        slot->value = value;
+        slot->dirty = true;
+    }
+    portEXIT_CRITICAL(&cfg_lock);
+    if (cfg_flusher_handle != NULL) xTaskNotifyGive(cfg_flusher_handle);
+}
+
+static void cfg_flush_task(void *pvParameters) {
+    static cfg_journal_blob_t journal;
+    uint32_t batch_values[CFG_CACHE_SLOTS];
+
+    while (1) {
+        // Wake on the first write, then sit out the coalescing window so
+        // a burst of cfg_set calls lands in one commit.
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(CFG_FLUSH_MS));
+        ulTaskNotifyTake(pdTRUE, 0);     // swallow notifies from the window
+
+        portENTER_CRITICAL(&cfg_lock);
+        journal.count = 0;
+        for (int i = 0; i < CFG_CACHE_SLOTS; i++) {
+            if (!cfg_cache[i].used || !cfg_cache[i].dirty) continue;
+            strncpy(journal.keys[journal.count], cfg_cache[i].key, CFG_KEY_MAX);
+            batch_values[journal.count++] = cfg_cache[i].value;
+            cfg_cache[i].dirty = false;
+        }
+        portEXIT_CRITICAL(&cfg_lock);
+        if (journal.count == 0 || !cfg_nvs_ready) continue;
+
+        // Journal first: a crash between here and the erase below leaves
+        // the key list behind, so the next boot knows what to distrust.
+        nvs_set_blob(cfg_nvs, CFG_JOURNAL_KEY, &journal,
+                     sizeof(uint32_t) + journal.count * (CFG_KEY_MAX + 1));
+        nvs_commit(cfg_nvs);
+
+        for (uint32_t i = 0; i < journal.count; i++) {
+            nvs_set_u32(cfg_nvs, journal.keys[i], batch_values[i]);
+            cfg_flash_writes++;
+        }
+        nvs_commit(cfg_nvs);
+        cfg_commits += 2;                // journal + values
+
+        nvs_erase_key(cfg_nvs, CFG_JOURNAL_KEY);
+        nvs_commit(cfg_nvs);
+
+        ESP_LOGI(TAG, "💾 Cfg flush: %lu keys in 1 value commit "
+                 "(total: %lu RAM hits, %lu flash reads, %lu writes, %lu coalesced)",
+                 journal.count, cfg_ram_hits, cfg_flash_reads,
+                 cfg_flash_writes, cfg_writes_coalesced);
+    }
+}
+
+// Bulk-load every known key once; after this, reads never touch flash.
+static void cfg_cache_init(const char *const *keys, const uint32_t *defaults,
+                           int count) {
+    if (nvs_open(CFG_NAMESPACE, NVS_READWRITE, &cfg_nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "💾 Cfg cache: flash unavailable, RAM-only mode");
+    } else {
+        cfg_nvs_ready = true;
+    }
+
+    // A leftover dirty-key journal means the last flush died mid-commit.
+    if (cfg_nvs_ready) {
+        static cfg_journal_blob_t journal;
+        size_t len = sizeof(journal);
+        if (nvs_get_blob(cfg_nvs, CFG_JOURNAL_KEY, &journal, &len) == ESP_OK &&
+            journal.count > 0) {
+            ESP_LOGW(TAG, "💾 Cfg cache: interrupted flush, %lu keys possibly stale:",
+                     journal.count);
+            for (uint32_t i = 0; i < journal.count && i < CFG_CACHE_SLOTS; i++)
+                ESP_LOGW(TAG, "  ⮡ %s", journal.keys[i]);
+            nvs_erase_key(cfg_nvs, CFG_JOURNAL_KEY);
+            nvs_commit(cfg_nvs);
+        }
+    }
+
+    portENTER_CRITICAL(&cfg_lock);
+    for (int i = 0; i < count; i++) {
+        cfg_slot_t *slot = cfg_find_slot(keys[i], NULL);
+        if (slot != NULL) slot->value = defaults[i];
+    }
+    portEXIT_CRITICAL(&cfg_lock);
+
+    // The one and only flash-read pass (outside the lock: nvs can block).
+    for (int i = 0; i < count && cfg_nvs_ready; i++) {
+        uint32_t stored;
+        if (nvs_get_u32(cfg_nvs, keys[i], &stored) == ESP_OK) {
+            portENTER_CRITICAL(&cfg_lock);
+            cfg_slot_t *slot = cfg_find_slot(keys[i], NULL);
+            if (slot != NULL) slot->value = stored;
+            portEXIT_CRITICAL(&cfg_lock);
+        }
+        cfg_flash_reads++;
+    }
+
+    xTaskCreate(cfg_flush_task, "CfgFlush", 2560, NULL, 2, &cfg_flusher_handle);
+    ESP_LOGI(TAG, "💾 Cfg cache: %d keys resident (%lu flash reads, lazy write-back on)",
+             count, cfg_flash_reads);
+}
+
+// ---- Telemetry send aggregation ----
+// Sending every status record individually costs per-send overhead
+// (radio wakeup, header, ack) fifty times a second. Records now land in
+// a flush buffer and go out as one batched send when the buffer fills,
+// when the oldest record exceeds its age budget, or immediately when a
+// producer marks a record priority. The flusher adapts its wait
+// nagle-style: heavy traffic (full-buffer flushes) shortens the gap
+// toward the minimum, quiet periods stretch it back toward the age
+// limit - chatty phases batch aggressively, sparse ones stay prompt.
+#define TX_BUFFER_RECORDS 16
+#define TX_MAX_AGE_MS     500    // oldest record never waits longer
+#define TX_MIN_GAP_MS     50     // floor for the adaptive flush gap
+
+typedef struct {
+    uint16_t tag;
+    uint32_t value;
+    uint32_t ts_ms;
+} telemetry_rec_t;
+
+static telemetry_rec_t tx_buffer[TX_BUFFER_RECORDS];
+static int tx_count = 0;
+static uint32_t tx_first_ms = 0;          // age reference
+static bool tx_priority_pending = false;
+static portMUX_TYPE tx_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t tx_flusher_handle = NULL;
+
+static uint32_t tx_records_queued = 0;
+static uint32_t tx_sends = 0;
+static uint32_t tx_full_flushes = 0;
+static uint32_t tx_age_flushes = 0;
+static uint32_t tx_prio_flushes = 0;
+static uint32_t tx_dropped = 0;
+
+// Producer side: append and poke the flusher only when a flush
+// condition is already met; the common case is two stores.
+void telemetry_send(uint16_t tag, uint32_t value, bool priority) {
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    bool wake = false;
+
+    portENTER_CRITICAL(&tx_lock);
+    if (tx_count < TX_BUFFER_RECORDS) {
+        if (tx_count == 0) tx_first_ms = now_ms;
+        tx_buffer[tx_count].tag = tag;
+        tx_buffer[tx_count].value = value;
+        tx_buffer[tx_count].ts_ms = now_ms;
+        tx_count++;
+        tx_records_queued++;
+    } else {
+        tx_dropped++;                     // flusher is behind; count, don't block
+    }
+    if (priority) {
+        tx_priority_pending = true;
+        wake = true;
+    }
+    if (tx_count >= TX_BUFFER_RECORDS) wake = true;
+    portEXIT_CRITICAL(&tx_lock);
+
+    if (wake && tx_flusher_handle) xTaskNotifyGive(tx_flusher_handle);
+}
+
+// Stand-in for the radio: one send per call, whatever the batch size.
+static void uplink_transmit(const telemetry_rec_t *recs, int count) {
+    tx_sends++;
+    ESP_LOGI(TAG, "📤 Uplink: %d records in one send (%lu records / %lu sends total)",
+             count, tx_records_queued, tx_sends);
+}
+
+void telemetry_flusher_task(void *pvParameters) {
+    uint32_t gap_ms = TX_MAX_AGE_MS;     // adaptive flush gap
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(gap_ms));
+
+        telemetry_rec_t local[TX_BUFFER_RECORDS];
+        int count;
+        bool was_full, was_prio;
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
+        portENTER_CRITICAL(&tx_lock);
+        was_full = (tx_count >= TX_BUFFER_RECORDS);
+        was_prio = tx_priority_pending;
+        bool aged = (tx_count > 0 && now_ms - tx_first_ms >= TX_MAX_AGE_MS);
+        if (was_full || was_prio || aged) {
+            count = tx_count;
+            memcpy(local, tx_buffer, count * sizeof(telemetry_rec_t));
+            tx_count = 0;
+            tx_priority_pending = false;
+        } else {
+            count = 0;
+        }
+        portEXIT_CRITICAL(&tx_lock);
+
+        if (count > 0) {
+            if (was_full) tx_full_flushes++;
+            else if (was_prio) tx_prio_flushes++;
+            else tx_age_flushes++;
+            uplink_transmit(local, count);
+        }
+
+        // Nagle-style adaptation: full buffers mean traffic is heavy,
+        // so poll sooner; an idle wait earns a longer nap.
+        if (was_full) {
+            gap_ms = (gap_ms / 2 > TX_MIN_GAP_MS) ? gap_ms / 2 : TX_MIN_GAP_MS;
+        } else if (count == 0 && gap_ms < TX_MAX_AGE_MS) {
+            gap_ms += TX_MIN_GAP_MS;
+        }
+    }
+}
+
+// ===== Log deduplication =====
+//
+// A failure loop — the network heartbeat losing its link, say — emits
+// the same line every pass, thousands of times during a long incident,
+// saturating the UART exactly when the channel matters most. The dedup
+// stage sits between the call site and ESP_LOG: each message is hashed
+// (FNV-1a, same function family as the config cache) over its site name
+// plus its fully formatted text, so the argument values are part of the
+// key and two sensor readings with different numbers never collide.
+// A repeat of the same key inside the window is counted, not printed;
+// when the window expires (or the slot is evicted, or the periodic
+// sweep in the event monitor runs) one "repeated N times" summary goes
+// out in its place. Distinct lines pass through untouched.
+#define DLOG_SLOTS      16      // open-addressed, linear probe
+#define DLOG_WINDOW_MS  10000   // suppress repeats within this window
+#define DLOG_MSG_MAX    96      // formatted text kept for the summary
+
+typedef struct {
+    uint32_t hash;              // 0 = empty slot
+    uint32_t first_ms;          // window start (first emit)
+    uint32_t repeats;           // suppressed duplicates this window
+    char     level;             // 'I' / 'W' — summary keeps the severity
+    char     msg[DLOG_MSG_MAX];
+} dlog_slot_t;
+
+static dlog_slot_t dlog_table[DLOG_SLOTS];
+static portMUX_TYPE dlog_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t dlog_emitted = 0;      // lines that reached the UART
+static uint32_t dlog_suppressed = 0;   // duplicates absorbed
+
+static uint32_t dlog_hash(const char *site, const char *text) {
+    uint32_t h = 2166136261u;
+    while (*site) { h ^= (uint8_t)*site++; h *= 16777619u; }
+    while (*text) { h ^= (uint8_t)*text++; h *= 16777619u; }
+    return h != 0 ? h : 1;   // 0 is the empty-slot marker
+}
+
+// Summaries are printed outside the spinlock, from a copied slot.
+static void dlog_emit_summary(const dlog_slot_t *s, uint32_t now_ms) {
+    if (s->level == 'W') {
+        ESP_LOGW(TAG, "🔁 \"%s\" repeated %lu times in %lu ms",
+                 s->msg, s->repeats, now_ms - s->first_ms);
+    } else {
+        ESP_LOGI(TAG, "🔁 \"%s\" repeated %lu times in %lu ms",
+                 s->msg, s->repeats, now_ms - s->first_ms);
+    }
+}
+
+static void dlog_write(char level, const char *site, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void dlog_write(char level, const char *site, const char *fmt, ...)
+{
+    char text[DLOG_MSG_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+
+    uint32_t h = dlog_hash(site, text);
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+
+    // Decide under the lock; print after it.
+    bool print_line = false;
+    bool print_summary = false;
+    dlog_slot_t flushed;
+
+    portENTER_CRITICAL(&dlog_lock);
+    uint32_t idx = h % DLOG_SLOTS;
+    dlog_slot_t *slot = NULL;
+    for (uint32_t i = 0; i < DLOG_SLOTS; i++) {
+        dlog_slot_t *s = &dlog_table[(idx + i) % DLOG_SLOTS];
+        if (s->hash == h || s->hash == 0) { slot = s; break; }
+    }
+    if (slot == NULL) {
+        // Table full of live strangers: evict our home slot.
+        slot = &dlog_table[idx];
+    }
+
+    if (slot->hash == h && now_ms - slot->first_ms < DLOG_WINDOW_MS) {
+        slot->repeats++;
+        dlog_suppressed++;
+    } else {
+        // New key, expired window, or eviction — any pending count on
+        // the slot is summarized before the slot is reused.
+        if (slot->hash != 0 && slot->repeats > 0) {
+            flushed = *slot;
+            print_summary = true;
+        }
+        slot->hash = h;
+        slot->first_ms = now_ms;
+        slot->repeats = 0;
+        slot->level = level;
+        strlcpy(slot->msg, text, sizeof(slot->msg));
+        dlog_emitted++;
+        print_line = true;
+    }
+    portEXIT_CRITICAL(&dlog_lock);
+
+    if (print_summary) dlog_emit_summary(&flushed, now_ms);
+    if (print_line) {
+        if (level == 'W') ESP_LOGW(TAG, "%s", text);
+        else              ESP_LOGI(TAG, "%s", text);
+    }
+}
+
+#define DLOGI(site, fmt, ...) dlog_write('I', site, fmt, ##__VA_ARGS__)
+#define DLOGW(site, fmt, ...) dlog_write('W', site, fmt, ##__VA_ARGS__)
+
+// Sweep: entries whose window has lapsed with repeats still pending get
+// their summary now instead of waiting for the next emit at that site
+// (which, after a failure loop ends, may never come).
+static void dlog_flush_expired(void) {
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    for (int i = 0; i < DLOG_SLOTS; i++) {
+        bool flush = false;
+        dlog_slot_t flushed;
+
+        portENTER_CRITICAL(&dlog_lock);
+        dlog_slot_t *s = &dlog_table[i];
+        if (s->hash != 0 && s->repeats > 0 &&
+            now_ms - s->first_ms >= DLOG_WINDOW_MS) {
+            flushed = *s;
+            s->hash = 0;   // retire the slot; next emit reopens a window
+            s->repeats = 0;
+            flush = true;
+        }
+        portEXIT_CRITICAL(&dlog_lock);
+
+        if (flush) dlog_emit_summary(&flushed, now_ms);
+    }
+}
+
+static void dlog_report(void) {
+    uint32_t emitted = dlog_emitted, suppressed = dlog_suppressed;
+    uint32_t total = emitted + suppressed;
+    ESP_LOGI(TAG, "🔁 Log dedup: %lu emitted, %lu suppressed (%.1f%% of %lu)",
+             emitted, suppressed,
+             total ? 100.0 * suppressed / total : 0.0, total);
+}
+
+// Telemetry tags used by the demo producers
+#define TLM_TAG_HEARTBEAT  1
+#define TLM_TAG_NET_STATE  2
+#define TLM_TAG_FREE_HEAP  3
+
+// Network init thunk — runs exactly once, via the lazy gate.
+static void network_init_thunk(void) {
+    init_graph_begin(step_network);
     ESP_LOGI(TAG, "🌐 Network initialization started");
-    
+
     uint32_t start_time = xTaskGetTickCount();
-    
+
     // จำลองการเริ่มต้นเครือข่าย
     ESP_LOGI(TAG, "Initializing WiFi driver...");
     vTaskDelay(pdMS_TO_TICKS(800));
-    
+
     ESP_LOGI(TAG, "Connecting to WiFi...");
     vTaskDelay(pdMS_TO_TICKS(2000));
-    
+
     ESP_LOGI(TAG, "Getting IP address...");
     vTaskDelay(pdMS_TO_TICKS(1000));
-    
+
     // คำนวณเวลาที่ใช้
     stats.network_init_time = (xTaskGetTickCount() - start_time) * portTICK_PERIOD_MS;
-    
+
     // เปิด LED และส่งสัญญาณ
     gpio_set_level(LED_NETWORK_READY, 1);
-    xEventGroupSetBits(system_events, NETWORK_READY_BIT);
-    
+    init_graph_complete(step_network);
+
     ESP_LOGI(TAG, "✅ Network ready! (took %lu ms)", stats.network_init_time);
-    
-    // จำลองการทำงานของ network
+}
+
+// Network task: force-eager through the once-gate (network is on the
+// boot critical path), then run the heartbeat loop.
+void network_init_task(void *pvParameters) {
+    lazy_ensure(lazy_network_id);
+
+    // จำลองการทำงานของ network — heartbeat lines ride the dedup stage:
+    // during an outage the loop stops repeating itself on the UART.
     while (1) {
-        ESP_LOGI(TAG, "📡 Network heartbeat - checking connectivity");
-        
+        DLOGI("net-heartbeat", "📡 Network heartbeat - checking connectivity");
+
+        // Routine records ride the aggregation buffer...
+        telemetry_send(TLM_TAG_HEARTBEAT, stats.event_notifications, false);
+        telemetry_send(TLM_TAG_FREE_HEAP, esp_get_free_heap_size(), false);
+
         // จำลองการตรวจสอบเครือข่าย
         if ((esp_random() % 100) > 5) { // 95% uptime
             // เครือข่ายปกติ
             gpio_set_level(LED_NETWORK_READY, 1);
             if (!(xEventGroupGetBits(system_events) & NETWORK_READY_BIT)) {
-                xEventGroupSetBits(system_events, NETWORK_READY_BIT);
+                event_bits_set_batched(NETWORK_READY_BIT);
                 ESP_LOGI(TAG, "🟢 Network connection restored");
+                telemetry_send(TLM_TAG_NET_STATE, 1, false);
             }
         } else {
             // เครือข่ายขัดข้อง
             gpio_set_level(LED_NETWORK_READY, 0);
-            xEventGroupClearBits(system_events, NETWORK_READY_BIT);
-            ESP_LOGW(TAG, "🔴 Network connection lost");
+            event_bits_clear_batched(NETWORK_READY_BIT);
+            DLOGW("net-lost", "🔴 Network connection lost");
+            // ...a lost uplink is the one record that must not wait.
+            telemetry_send(TLM_TAG_NET_STATE, 0, true);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(5000));
+
+        slumber_delay_ms(slumber_net_id, 5000);
     }
 }
 
 // Sensor initialization task
 void sensor_init_task(void *pvParameters) {
+    init_graph_begin(step_sensor);
     ESP_LOGI(TAG, "🌡️ Sensor initialization started");
     
     uint32_t start_time = xTaskGetTickCount();
@@ -114,36 +1322,52 @@ void sensor_init_task(void *pvParameters) {
     stats.sensor_init_time = (xTaskGetTickCount() - start_time) * portTICK_PERIOD_MS;
     
     gpio_set_level(LED_SENSOR_READY, 1);
-    xEventGroupSetBits(system_events, SENSOR_READY_BIT);
+    init_graph_complete(step_sensor);
     
     ESP_LOGI(TAG, "✅ Sensors ready! (took %lu ms)", stats.sensor_init_time);
     
-    // จำลองการอ่านค่า sensor
+    // จำลองการอ่านค่า sensor; limits come from the RCU config snapshot
+    int reader_id = rcu_reader_register();
+    uint32_t samples = 0;
     while (1) {
         float temperature = 25.0 + (esp_random() % 200) / 10.0; // 25-45°C
         float humidity = 40.0 + (esp_random() % 400) / 10.0;    // 40-80%
-        
+
         ESP_LOGI(TAG, "🌡️ Sensor readings: %.1f°C, %.1f%% RH", temperature, humidity);
+
+        // Every 20th reading gets archived — the first one, about a
+        // minute in, is what actually brings storage up.
+        if (++samples % 20 == 0) {
+            storage_archive((uint32_t)(temperature * 10));
+        }
+        
+        // One atomic load; pointer valid until rcu_quiescent below
+        const system_config_t *cfg = config_get();
         
         // จำลองการตรวจสอบ sensor
-        if (temperature > 50.0 || humidity > 90.0) {
+        if (cfg != NULL &&
+            (temperature > cfg->temp_limit || humidity > cfg->humidity_limit)) {
             ESP_LOGW(TAG, "⚠️ Sensor values out of range!");
             gpio_set_level(LED_SENSOR_READY, 0);
-            xEventGroupClearBits(system_events, SENSOR_READY_BIT);
+            event_bits_clear_batched(SENSOR_READY_BIT);
             
             vTaskDelay(pdMS_TO_TICKS(2000)); // Recovery time
             
             gpio_set_level(LED_SENSOR_READY, 1);
-            xEventGroupSetBits(system_events, SENSOR_READY_BIT);
+            event_bits_set_batched(SENSOR_READY_BIT);
             ESP_LOGI(TAG, "🟢 Sensor system recovered");
         }
         
-        vTaskDelay(pdMS_TO_TICKS(3000));
+        // Copy what we still need out before declaring quiescence
+        uint32_t period_ms = cfg != NULL ? cfg->sample_period_ms : 3000;
+        rcu_quiescent(reader_id);
+        vTaskDelay(pdMS_TO_TICKS(period_ms));
     }
 }
 
 // Configuration loading task
 void config_load_task(void *pvParameters) {
+    init_graph_begin(step_config);
     ESP_LOGI(TAG, "⚙️ Configuration loading started");
     
     uint32_t start_time = xTaskGetTickCount();
@@ -160,78 +1384,342 @@ void config_load_task(void *pvParameters) {
     ESP_LOGI(TAG, "Validating configuration...");
     vTaskDelay(pdMS_TO_TICKS(500));
     
+    // One bulk load makes every later config read a RAM hash probe.
+    static const char *const cfg_keys[] = {
+        "cfg_version", "period_ms", "temp_lim_c10", "hum_lim_c10",
+    };
+    static const uint32_t cfg_defaults[] = { 1, 3000, 500, 900 };
+    cfg_cache_init(cfg_keys, cfg_defaults, 4);
+
     stats.config_init_time = (xTaskGetTickCount() - start_time) * portTICK_PERIOD_MS;
+
+    system_config_t loaded = {
+        .version = cfg_get_u32("cfg_version", 1),
+        .sample_period_ms = cfg_get_u32("period_ms", 3000),
+        .temp_limit = cfg_get_u32("temp_lim_c10", 500) / 10.0f,
+        .humidity_limit = cfg_get_u32("hum_lim_c10", 900) / 10.0f,
+    };
+    config_publish(&loaded);
     
     gpio_set_level(LED_CONFIG_READY, 1);
-    xEventGroupSetBits(system_events, CONFIG_READY_BIT);
+    init_graph_complete(step_config);
     
     ESP_LOGI(TAG, "✅ Configuration loaded! (took %lu ms)", stats.config_init_time);
     
     // จำลองการเฝ้าดู configuration
     while (1) {
-        ESP_LOGI(TAG, "⚙️ Configuration monitoring - checking integrity");
+        DLOGI("cfg-monitor", "⚙️ Configuration monitoring - checking integrity");
         
-        // จำลองการตรวจสอบไฟล์ config
-        if ((esp_random() % 100) > 2) { // 98% reliability
+        // จำลองการตรวจสอบไฟล์ config — every check is a cache probe, not flash
+        if (cfg_get_u32("cfg_version", 1) == loaded.version &&
+            (esp_random() % 100) > 2) { // 98% reliability
             gpio_set_level(LED_CONFIG_READY, 1);
         } else {
             ESP_LOGW(TAG, "⚠️ Configuration corruption detected, reloading...");
             gpio_set_level(LED_CONFIG_READY, 0);
-            xEventGroupClearBits(system_events, CONFIG_READY_BIT);
-            
-            vTaskDelay(pdMS_TO_TICKS(1000));
-            
+            event_bits_clear_batched(CONFIG_READY_BIT);
+
+            slumber_delay_ms(slumber_cfg_id, 1000);   // retry backoff may sleep
+
+            loaded.version++;
+            loaded.temp_limit = 45.0 + (esp_random() % 10);
+            // Both writes land in RAM now and share one flusher commit.
+            cfg_set_u32("cfg_version", loaded.version);
+            cfg_set_u32("temp_lim_c10", (uint32_t)(loaded.temp_limit * 10));
+            config_publish(&loaded);
+
             gpio_set_level(LED_CONFIG_READY, 1);
-            xEventGroupSetBits(system_events, CONFIG_READY_BIT);
-            ESP_LOGI(TAG, "🟢 Configuration reloaded successfully");
+            event_bits_set_batched(CONFIG_READY_BIT);
+            ESP_LOGI(TAG, "🟢 Configuration v%lu published (%lu old snapshots reclaimed)",
+                     loaded.version, config_reclaimed);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(8000));
+
+        slumber_delay_ms(slumber_cfg_id, 8000);
     }
 }
 
-// Storage initialization task
-void storage_init_task(void *pvParameters) {
+// Storage init thunk — deferred until the first accessor shows up.
+static void storage_init_thunk(void) {
+    init_graph_begin(step_storage);
     ESP_LOGI(TAG, "💾 Storage initialization started");
-    
+
     uint32_t start_time = xTaskGetTickCount();
-    
+
     ESP_LOGI(TAG, "Mounting filesystem...");
     vTaskDelay(pdMS_TO_TICKS(1000));
-    
+
     ESP_LOGI(TAG, "Checking filesystem integrity...");
     vTaskDelay(pdMS_TO_TICKS(1500));
-    
+
     ESP_LOGI(TAG, "Creating directories...");
     vTaskDelay(pdMS_TO_TICKS(300));
-    
+
     ESP_LOGI(TAG, "Initializing database...");
     vTaskDelay(pdMS_TO_TICKS(800));
-    
+
     stats.storage_init_time = (xTaskGetTickCount() - start_time) * portTICK_PERIOD_MS;
-    
+
     gpio_set_level(LED_STORAGE_READY, 1);
-    xEventGroupSetBits(system_events, STORAGE_READY_BIT);
-    
+    init_graph_complete(step_storage);
+
     ESP_LOGI(TAG, "✅ Storage ready! (took %lu ms)", stats.storage_init_time);
-    
+}
+
+// First accessor pays the mount (through the gate); every later call
+// is the once-flag fast path.
+static uint32_t storage_records = 0;
+static void storage_archive(uint32_t value) {
+    lazy_ensure(lazy_storage_id);
+    storage_records++;
+    ESP_LOGI(TAG, "💾 Archived record #%lu (value %lu)", storage_records, value);
+}
+
+// Storage maintenance task: nothing to maintain until someone's first
+// access brings the subsystem up, so block on its ready bit.
+void storage_maintenance_task(void *pvParameters) {
+    ESP_LOGI(TAG, "💾 Storage is lazy — maintenance parked until first use");
+    slumber_park(slumber_storage_id, 0);   // indefinite wait, sleep freely
+    xEventGroupWaitBits(system_events, STORAGE_READY_BIT,
+                        pdFALSE, pdTRUE, portMAX_DELAY);
+    slumber_wake(slumber_storage_id);
+
     // จำลองการทำงานของ storage
     while (1) {
-        ESP_LOGI(TAG, "💾 Storage maintenance - checking space and health");
-        
-        // จำลองการตรวจสอบ storage
+        DLOGI("storage-maint", "💾 Storage maintenance - checking space and health");
+
+        // จำลองการตรวจสอบ storage — the free-space figure is part of the
+        // digest, so only a genuinely unchanged reading is suppressed.
         uint32_t free_space = 1000 + (esp_random() % 9000); // 1-10GB
-        ESP_LOGI(TAG, "Storage free space: %lu MB", free_space);
+        DLOGI("storage-space", "Storage free space: %lu MB", free_space);
         
         if (free_space < 500) { // Less than 500MB
             ESP_LOGW(TAG, "⚠️ Low storage space warning!");
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(10000));
+
+        slumber_delay_ms(slumber_storage_id, 10000);
     }
 }
 
 // Main system coordinator task
+// ===== Wide event group (64-bit) =====
+//
+// FreeRTOS event groups expose 24 usable bits; this lab already burns 5
+// and a full production subsystem map wants 40+. The wide group keeps a
+// 64-bit mask under a spinlock (on a 32-bit target a bare 64-bit load
+// can tear) and borrows one ordinary event-group bit as a doorbell:
+// every set pulses it, and each waiter re-checks its own 64-bit
+// condition and sleeps again if unmet — one wait call covers the whole
+// system state, wait-any/wait-all/clear-on-exit included. A pulse can be
+// consumed by a different waiter between check and sleep, so each sleep
+// is capped at WEG_RECHECK_MS: a lost pulse costs bounded latency, never
+// a hang.
+#define WEG_DOORBELL_BIT (1 << 0)
+#define WEG_RECHECK_MS   100
+
+typedef struct {
+    uint64_t bits;
+    portMUX_TYPE lock;
+    EventGroupHandle_t doorbell;
+} wide_event_group_t;
+
+static wide_event_group_t wide_events = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+bool weg_init(wide_event_group_t *g) {
+    g->bits = 0;
+    g->doorbell = xEventGroupCreate();
+    return g->doorbell != NULL;
+}
+
+uint64_t weg_set_bits(wide_event_group_t *g, uint64_t mask) {
+    portENTER_CRITICAL(&g->lock);
+    g->bits |= mask;
+    uint64_t after = g->bits;
+    portEXIT_CRITICAL(&g->lock);
+    xEventGroupSetBits(g->doorbell, WEG_DOORBELL_BIT);
+    return after;
+}
+
+uint64_t weg_clear_bits(wide_event_group_t *g, uint64_t mask) {
+    portENTER_CRITICAL(&g->lock);
+    g->bits &= ~mask;
+    uint64_t after = g->bits;
+    portEXIT_CRITICAL(&g->lock);
+    return after;   // a clear can't satisfy a wait: no doorbell pulse
+}
+
+uint64_t weg_get_bits(wide_event_group_t *g) {
+    portENTER_CRITICAL(&g->lock);
+    uint64_t bits = g->bits;
+    portEXIT_CRITICAL(&g->lock);
+    return bits;
+}
+
+// Same contract as xEventGroupWaitBits, widened: returns the bits at the
+// moment the condition was met (or the last snapshot on timeout).
+uint64_t weg_wait_bits(wide_event_group_t *g, uint64_t mask,
+                       bool wait_all, bool clear_on_exit, TickType_t ticks) {
+    TickType_t deadline = xTaskGetTickCount() + ticks;
+    while (1) {
+        portENTER_CRITICAL(&g->lock);
+        uint64_t bits = g->bits;
+        bool met = wait_all ? ((bits & mask) == mask) : ((bits & mask) != 0);
+        if (met && clear_on_exit) g->bits &= ~mask;
+        portEXIT_CRITICAL(&g->lock);
+        if (met) return bits;
+
+        TickType_t now = xTaskGetTickCount();
+        if (ticks != portMAX_DELAY && (int32_t)(deadline - now) <= 0) return bits;
+        TickType_t slice = pdMS_TO_TICKS(WEG_RECHECK_MS);
+        if (ticks != portMAX_DELAY && deadline - now < slice) slice = deadline - now;
+        xEventGroupWaitBits(g->doorbell, WEG_DOORBELL_BIT, pdTRUE, pdFALSE, slice);
+    }
+}
+
+// Demo: a 40-module readiness map plus fault flags in the bits an
+// ordinary event group can't reach.
+#define WEG_MODULE_COUNT  40
+#define WEG_ALL_MODULES   ((1ULL << WEG_MODULE_COUNT) - 1)
+#define WEG_FAULT_MASK    (0xFFULL << 40)
+
+void wide_producer_task(void *pvParameters) {
+    // Five modules come up per step; the whole map fills in ~2.5 s.
+    for (int i = 0; i < WEG_MODULE_COUNT; i += 5) {
+        vTaskDelay(pdMS_TO_TICKS(300));
+        weg_set_bits(&wide_events, 0x1FULL << i);
+    }
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    weg_set_bits(&wide_events, 1ULL << (40 + (esp_random() % 8)));
+    vTaskDelete(NULL);
+}
+
+void wide_waiter_task(void *pvParameters) {
+    ESP_LOGI(TAG, "🌊 Wide waiter: need all %d module bits", WEG_MODULE_COUNT);
+    uint64_t bits = weg_wait_bits(&wide_events, WEG_ALL_MODULES,
+                                  true, false, pdMS_TO_TICKS(30000));
+    if ((bits & WEG_ALL_MODULES) == WEG_ALL_MODULES) {
+        ESP_LOGI(TAG, "🌊 All 40 modules ready (state=0x%08lX%08lX)",
+                 (uint32_t)(bits >> 32), (uint32_t)bits);
+    } else {
+        ESP_LOGW(TAG, "🌊 Timeout, missing=0x%08lX%08lX",
+                 (uint32_t)((WEG_ALL_MODULES & ~bits) >> 32),
+                 (uint32_t)(WEG_ALL_MODULES & ~bits));
+    }
+
+    bits = weg_wait_bits(&wide_events, WEG_FAULT_MASK, false, true, portMAX_DELAY);
+    ESP_LOGW(TAG, "🌊 Fault flag raised: bit %d",
+             63 - __builtin_clzll(bits & WEG_FAULT_MASK));
+    vTaskDelete(NULL);
+}
+
+// ===== Composite wait =====
+//
+// A task can block on event bits or on a queue, never both, which is why
+// the coordinator used to sleep on a fixed interval and re-poll state it
+// had already seen. The composite set bridges the two worlds onto one
+// FreeRTOS queue set: queues join the set directly, and each event-bit
+// condition gets a tiny bridge task that blocks on the bits and gives a
+// binary semaphore in the set when they come true (edge-triggered: it
+// re-arms only after the condition drops). cw_wait makes one blocking
+// call and returns a readiness word with one bit per registered source.
+// Ready queues must be drained by the caller before the next cw_wait so
+// queue-set bookkeeping stays consistent.
+#define CW_SOURCES_MAX 6
+
+typedef enum { CW_QUEUE, CW_EVENTS } cw_kind_t;
+
+typedef struct {
+    cw_kind_t kind;
+    QueueHandle_t queue;
+    EventGroupHandle_t group;
+    EventBits_t mask;
+    bool wait_all;
+    SemaphoreHandle_t bridge_sem;
+} cw_source_t;
+
+typedef struct {
+    QueueSetHandle_t set;
+    cw_source_t sources[CW_SOURCES_MAX];
+    int count;
+} composite_wait_t;
+
+// queue_space: total depth of all queues that will join the set.
+bool cw_init(composite_wait_t *cw, UBaseType_t queue_space) {
+    cw->count = 0;
+    cw->set = xQueueCreateSet(queue_space + CW_SOURCES_MAX);
+    return cw->set != NULL;
+}
+
+// Returns the source index (its bit in the readiness word), or -1.
+int cw_add_queue(composite_wait_t *cw, QueueHandle_t queue) {
+    if (cw->count >= CW_SOURCES_MAX) return -1;
+    if (xQueueAddToSet(queue, cw->set) != pdPASS) return -1;
+    cw->sources[cw->count] = (cw_source_t){ .kind = CW_QUEUE, .queue = queue };
+    return cw->count++;
+}
+
+static void cw_bridge_task(void *pvParameters) {
+    cw_source_t *s = pvParameters;
+    while (1) {
+        xEventGroupWaitBits(s->group, s->mask, pdFALSE,
+                            s->wait_all ? pdTRUE : pdFALSE, portMAX_DELAY);
+        xSemaphoreGive(s->bridge_sem);
+        // Re-arm on the falling edge; event groups can't block on a
+        // clear, so this side polls gently.
+        while (1) {
+            EventBits_t bits = xEventGroupGetBits(s->group);
+            bool met = s->wait_all ? ((bits & s->mask) == s->mask)
+                                   : ((bits & s->mask) != 0);
+            if (!met) break;
+            vTaskDelay(pdMS_TO_TICKS(250));
+        }
+    }
+}
+
+int cw_add_events(composite_wait_t *cw, EventGroupHandle_t group,
+                  EventBits_t mask, bool wait_all) {
+    if (cw->count >= CW_SOURCES_MAX) return -1;
+    cw_source_t *s = &cw->sources[cw->count];
+    *s = (cw_source_t){ .kind = CW_EVENTS, .group = group,
+                        .mask = mask, .wait_all = wait_all };
+    s->bridge_sem = xSemaphoreCreateBinary();
+    if (!s->bridge_sem || xQueueAddToSet(s->bridge_sem, cw->set) != pdPASS) return -1;
+    xTaskCreate(cw_bridge_task, "CwBridge", 2048, s, 6, NULL);
+    return cw->count++;
+}
+
+// One blocking call; readiness word has bit i set when source i is
+// ready. Extra ready members found after the first are collected in the
+// same word so one wakeup can report several sources.
+uint32_t cw_wait(composite_wait_t *cw, TickType_t ticks) {
+    uint32_t ready = 0;
+    QueueSetMemberHandle_t member = xQueueSelectFromSet(cw->set, ticks);
+    while (member != NULL) {
+        for (int i = 0; i < cw->count; i++) {
+            cw_source_t *s = &cw->sources[i];
+            if (s->kind == CW_EVENTS && member == (QueueSetMemberHandle_t)s->bridge_sem) {
+                xSemaphoreTake(s->bridge_sem, 0);
+                ready |= 1u << i;
+            } else if (s->kind == CW_QUEUE && member == (QueueSetMemberHandle_t)s->queue) {
+                ready |= 1u << i;
+            }
+        }
+        member = xQueueSelectFromSet(cw->set, 0);
+    }
+    return ready;
+}
+
+// Every batched transition also pokes this queue so the coordinator
+// wakes on change instead of polling.
+static QueueHandle_t health_poke_queue = NULL;
+
+static void health_poke(EventBits_t bits_after) {
+    if (health_poke_queue != NULL) {
+        xQueueSend(health_poke_queue, &bits_after, 0);   // full = coordinator already pending
+    }
+}
+
 void system_coordinator_task(void *pvParameters) {
     ESP_LOGI(TAG, "🎛️ System coordinator started - waiting for subsystems...");
     
@@ -239,13 +1727,8 @@ void system_coordinator_task(void *pvParameters) {
     
     // Phase 1: รอ basic subsystems (Network + Config)
     ESP_LOGI(TAG, "📋 Phase 1: Waiting for basic subsystems (Network + Config)...");
-    EventBits_t bits = xEventGroupWaitBits(
-        system_events,
-        BASIC_SYSTEM_BITS,
-        pdFALSE,    // ไม่ล้าง bits
-        pdTRUE,     // รอทุก bits (AND condition)
-        pdMS_TO_TICKS(10000)  // Timeout 10 seconds
-    );
+    EventBits_t bits = ewt_wait_bits(ewt_phase1, system_events, BASIC_SYSTEM_BITS,
+                                     pdFALSE, pdTRUE);   // budget: 10 s
     
     if ((bits & BASIC_SYSTEM_BITS) == BASIC_SYSTEM_BITS) {
         ESP_LOGI(TAG, "✅ Phase 1 complete - basic system ready!");
@@ -255,21 +1738,17 @@ void system_coordinator_task(void *pvParameters) {
                  BASIC_SYSTEM_BITS & ~bits);
     }
     
-    // Phase 2: รอ subsystems ทั้งหมด
-    ESP_LOGI(TAG, "📋 Phase 2: Waiting for all subsystems...");
-    bits = xEventGroupWaitBits(
-        system_events,
-        ALL_SUBSYSTEM_BITS,
-        pdFALSE,    // ไม่ล้าง bits
-        pdTRUE,     // รอทุก bits (AND condition)
-        pdMS_TO_TICKS(15000)  // Timeout 15 seconds
-    );
-    
-    if ((bits & ALL_SUBSYSTEM_BITS) == ALL_SUBSYSTEM_BITS) {
-        ESP_LOGI(TAG, "✅ Phase 2 complete - all subsystems ready!");
+    // Phase 2: รอ eager subsystems ทั้งหมด — lazy storage ไม่ถ่วง boot
+    ESP_LOGI(TAG, "📋 Phase 2: Waiting for all eager subsystems...");
+    bits = ewt_wait_bits(ewt_phase2, system_events, EAGER_SYSTEM_BITS,
+                         pdFALSE, pdTRUE);   // budget: 15 s
+
+    if ((bits & EAGER_SYSTEM_BITS) == EAGER_SYSTEM_BITS) {
+        ESP_LOGI(TAG, "✅ Phase 2 complete - all eager subsystems ready!");
         
-        // ตั้ง system ready bit
-        xEventGroupSetBits(system_events, SYSTEM_READY_BIT);
+        // Sink node of the init graph: SYSTEM_READY_BIT
+        init_graph_begin(step_system);
+        init_graph_complete(step_system);
         gpio_set_level(LED_SYSTEM_READY, 1);
         
         stats.total_init_time = (xTaskGetTickCount() - total_start_time) * portTICK_PERIOD_MS;
@@ -281,19 +1760,50 @@ void system_coordinator_task(void *pvParameters) {
         ESP_LOGI(TAG, "Network init:  %lu ms", stats.network_init_time);
         ESP_LOGI(TAG, "Sensor init:   %lu ms", stats.sensor_init_time);
         ESP_LOGI(TAG, "Config init:   %lu ms", stats.config_init_time);
-        ESP_LOGI(TAG, "Storage init:  %lu ms", stats.storage_init_time);
+        if (lazy_is_ready(lazy_storage_id)) {
+            ESP_LOGI(TAG, "Storage init:  %lu ms", stats.storage_init_time);
+        } else {
+            ESP_LOGI(TAG, "Storage init:  deferred (lazy, still cold)");
+        }
         ESP_LOGI(TAG, "══════════════════════════════════");
-        
+
+        init_graph_report(step_system);
+        ewt_report();
+        lazy_report();
+        slumber_report();
+        dlog_report();
+
     } else {
-        ESP_LOGW(TAG, "⚠️ Phase 2 timeout - missing subsystems: 0x%08X", 
-                 ALL_SUBSYSTEM_BITS & ~bits);
+        ESP_LOGW(TAG, "⚠️ Phase 2 timeout - missing subsystems: 0x%08X",
+                 EAGER_SYSTEM_BITS & ~bits);
         ESP_LOGW(TAG, "Starting with limited functionality...");
     }
     
     // Phase 3: System monitoring และ event handling
+    //
+    // One composite wait replaces the old sleep-and-repoll loop: the
+    // coordinator blocks on the transition-poke queue and a fault-edge
+    // event condition at once, wakes only when something changed, and
+    // keeps a 10 s timeout as a heartbeat check.
+    composite_wait_t health_set;
+    int src_pokes = -1;
+    health_poke_queue = xQueueCreate(8, sizeof(EventBits_t));
+    if (health_poke_queue && cw_init(&health_set, 8)) {
+        src_pokes = cw_add_queue(&health_set, health_poke_queue);
+    }
+
     while (1) {
-        ESP_LOGI(TAG, "🔄 System health check...");
-        
+        uint32_t ready = 0;
+        if (src_pokes >= 0) {
+            ready = cw_wait(&health_set, pdMS_TO_TICKS(10000));
+            EventBits_t poke;
+            while (xQueueReceive(health_poke_queue, &poke, 0) == pdTRUE) {}
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(5000));   // facility unavailable: old behavior
+        }
+        ESP_LOGI(TAG, "🔄 System health check (%s)...",
+                 ready ? "woken by transition" : "heartbeat");
+
         // ตรวจสอบสถานะระบบ
         EventBits_t current_bits = xEventGroupGetBits(system_events);
         
@@ -301,78 +1811,94 @@ void system_coordinator_task(void *pvParameters) {
         ESP_LOGI(TAG, "  Network:  %s", (current_bits & NETWORK_READY_BIT) ? "✅" : "❌");
         ESP_LOGI(TAG, "  Sensor:   %s", (current_bits & SENSOR_READY_BIT) ? "✅" : "❌");
         ESP_LOGI(TAG, "  Config:   %s", (current_bits & CONFIG_READY_BIT) ? "✅" : "❌");
-        ESP_LOGI(TAG, "  Storage:  %s", (current_bits & STORAGE_READY_BIT) ? "✅" : "❌");
+        ESP_LOGI(TAG, "  Storage:  %s", (current_bits & STORAGE_READY_BIT) ? "✅"
+                 : lazy_is_ready(lazy_storage_id) ? "❌" : "💤 (lazy, cold)");
         ESP_LOGI(TAG, "  System:   %s", (current_bits & SYSTEM_READY_BIT) ? "✅" : "❌");
-        
-        // ตรวจสอบว่าระบบยังพร้อมใช้งานหรือไม่
-        if ((current_bits & ALL_SUBSYSTEM_BITS) != ALL_SUBSYSTEM_BITS) {
+
+        // ตรวจสอบว่าระบบยังพร้อมใช้งานหรือไม่ — a cold lazy subsystem
+        // is not degradation; once it has come up, its bit is required.
+        EventBits_t required = EAGER_SYSTEM_BITS |
+            (lazy_is_ready(lazy_storage_id) ? STORAGE_READY_BIT : 0);
+        if ((current_bits & required) != required) {
             ESP_LOGW(TAG, "⚠️ System degraded - some subsystems offline");
             gpio_set_level(LED_SYSTEM_READY, 0);
-            xEventGroupClearBits(system_events, SYSTEM_READY_BIT);
+            // Only clear on the edge, or our own poke would wake us again.
+            if (current_bits & SYSTEM_READY_BIT) {
+                event_bits_clear_batched(SYSTEM_READY_BIT);
+            }
         } else if (!(current_bits & SYSTEM_READY_BIT)) {
             ESP_LOGI(TAG, "🟢 All subsystems back online - system ready");
             gpio_set_level(LED_SYSTEM_READY, 1);
-            xEventGroupSetBits(system_events, SYSTEM_READY_BIT);
+            event_bits_set_batched(SYSTEM_READY_BIT);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(5000));
     }
 }
 
-// Event monitor task - demonstrates different wait conditions
+// Helper for batch printout: name each bit in a transition mask.
+static void log_event_bits(const char *prefix, EventBits_t bits) {
+    if (bits & NETWORK_READY_BIT) ESP_LOGI(TAG, "    %s 🌐 Network", prefix);
+    if (bits & SENSOR_READY_BIT)  ESP_LOGI(TAG, "    %s 🌡️ Sensor", prefix);
+    if (bits & CONFIG_READY_BIT)  ESP_LOGI(TAG, "    %s ⚙️ Config", prefix);
+    if (bits & STORAGE_READY_BIT) ESP_LOGI(TAG, "    %s 💾 Storage", prefix);
+    if (bits & SYSTEM_READY_BIT)  ESP_LOGI(TAG, "    %s 🎉 System", prefix);
+}
+
+// Event monitor task - drains batched transitions
+// Instead of blocking on the event group and waking per bit flip, the
+// monitor sleeps until the flush interval expires (or a priority bit
+// notifies it) and reports every transition since the last drain in one
+// pass: one wakeup per batch instead of one per event.
 void event_monitor_task(void *pvParameters) {
-    ESP_LOGI(TAG, "👁️ Event monitor started");
-    
+    event_transition_t drained[EVENT_BATCH_SIZE];
+    ESP_LOGI(TAG, "👁️ Event monitor started (batched, flush every %d ms)",
+             EVENT_BATCH_FLUSH_MS);
+
     while (1) {
-        ESP_LOGI(TAG, "🔍 Monitoring events...");
-        
-        // ทดสอบการรอแบบ ANY condition
-        ESP_LOGI(TAG, "Waiting for ANY subsystem event (5 second timeout)...");
-        EventBits_t bits = xEventGroupWaitBits(
-            system_events,
-            ALL_SUBSYSTEM_BITS,
-            pdFALSE,    // ไม่ล้าง bits
-            pdFALSE,    // รอ ANY bit (OR condition)
-            pdMS_TO_TICKS(5000)
-        );
-        
-        if (bits != 0) {
-            ESP_LOGI(TAG, "📢 Event detected: 0x%08X", bits);
-            
-            // ตรวจสอบ individual events
-            if (bits & NETWORK_READY_BIT) ESP_LOGI(TAG, "  🌐 Network event active");
-            if (bits & SENSOR_READY_BIT)  ESP_LOGI(TAG, "  🌡️ Sensor event active");
-            if (bits & CONFIG_READY_BIT)  ESP_LOGI(TAG, "  ⚙️ Config event active");
-            if (bits & STORAGE_READY_BIT) ESP_LOGI(TAG, "  💾 Storage event active");
-            
-            stats.event_notifications++;
-        } else {
-            ESP_LOGI(TAG, "⏰ No events within timeout period");
+        uint32_t woken_early = ulTaskNotifyTake(pdTRUE,
+                                                pdMS_TO_TICKS(EVENT_BATCH_FLUSH_MS));
+
+        // Piggyback the dedup sweep on the monitor's cadence: lapsed
+        // windows get their "repeated N times" summary here even if the
+        // noisy site has gone quiet.
+        dlog_flush_expired();
+
+        // Snapshot and reset the ring in one short critical section
+        portENTER_CRITICAL(&batch_lock);
+        uint32_t count = batch_count;
+        uint32_t dropped = batch_dropped;
+        uint32_t start = (batch_head + EVENT_BATCH_SIZE - count) % EVENT_BATCH_SIZE;
+        for (uint32_t i = 0; i < count; i++)
+            drained[i] = event_batch[(start + i) % EVENT_BATCH_SIZE];
+        batch_count = 0;
+        batch_dropped = 0;
+        portEXIT_CRITICAL(&batch_lock);
+
+        if (count == 0) {
+            ESP_LOGI(TAG, "🔍 No event transitions this interval");
+            continue;
         }
-        
-        // ทดสอบการรอ full system ready
-        if (!(bits & SYSTEM_READY_BIT)) {
-            ESP_LOGI(TAG, "Waiting for FULL system ready...");
-            bits = xEventGroupWaitBits(
-                system_events,
-                FULL_SYSTEM_BITS,
-                pdFALSE,
-                pdTRUE,     // รอทุก bits (AND condition)
-                pdMS_TO_TICKS(2000)
-            );
-            
-            if ((bits & FULL_SYSTEM_BITS) == FULL_SYSTEM_BITS) {
-                ESP_LOGI(TAG, "🎉 Full system ready detected!");
-            }
+
+        ESP_LOGI(TAG, "📢 Event batch: %lu transition(s)%s", count,
+                 woken_early ? " (priority wake)" : "");
+        for (uint32_t i = 0; i < count; i++) {
+            ESP_LOGI(TAG, "  [+%lums] state 0x%02X",
+                     drained[i].timestamp_ms, drained[i].bits_after);
+            log_event_bits("SET  ", drained[i].set_bits);
+            log_event_bits("CLEAR", drained[i].cleared_bits);
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(8000));
+        if (dropped > 0)
+            ESP_LOGW(TAG, "⚠️ Ring overflow: %lu transition(s) dropped", dropped);
+        stats.event_notifications += count;
     }
 }
 
 void app_main(void) {
     ESP_LOGI(TAG, "🚀 Basic Event Groups Lab Starting...");
     
+    // รายงาน boot ก่อนหน้า แล้วเริ่มบันทึก boot นี้
+    bootprof_boot();
+    journal_boot_dump();
+    
     // กำหนด GPIO pins
     gpio_set_direction(LED_NETWORK_READY, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_SENSOR_READY, GPIO_MODE_OUTPUT);
@@ -396,17 +1922,60 @@ void app_main(void) {
     
     ESP_LOGI(TAG, "Event group created successfully");
     
-    // สร้าง initialization tasks
-    xTaskCreate(network_init_task, "NetworkInit", 3072, NULL, 6, NULL);
-    xTaskCreate(sensor_init_task, "SensorInit", 2048, NULL, 5, NULL);
-    xTaskCreate(config_load_task, "ConfigLoad", 2048, NULL, 4, NULL);
-    xTaskCreate(storage_init_task, "StorageInit", 2048, NULL, 4, NULL);
+    // ประกาศ dependency graph: storage → config → {network, sensor} → system
+    // Wait sites register with the timeout budget their call sites use.
+    ewt_init_deps = ewt_register("init-deps", portMAX_DELAY);
+    ewt_phase1 = ewt_register("phase1", pdMS_TO_TICKS(10000));
+    ewt_phase2 = ewt_register("phase2", pdMS_TO_TICKS(15000));
+
+    // Storage left the critical path: config reads NVS directly, not
+    // the lazy filesystem, and the system sink only needs the eager set.
+    step_storage = init_graph_add("storage", STORAGE_READY_BIT, 0);
+    step_config  = init_graph_add("config",  CONFIG_READY_BIT, 0);
+    step_network = init_graph_add("network", NETWORK_READY_BIT, CONFIG_READY_BIT);
+    step_sensor  = init_graph_add("sensor",  SENSOR_READY_BIT, CONFIG_READY_BIT);
+    step_system  = init_graph_add("system",  SYSTEM_READY_BIT, EAGER_SYSTEM_BITS);
+
+    // Lazy roster: storage stays cold until first use; network shares
+    // the same once-gate but its init task force-eagers it.
+    lazy_storage_id = lazy_register("storage", storage_init_thunk);
+    lazy_network_id = lazy_register("network", network_init_thunk);
+
+    // Sleep roster: the long blocking sites and the wake latency each
+    // can absorb; the sensor loop stays unregistered on purpose as the
+    // tick-catch-up contrast case.
+    slumber_cfg_id     = slumber_register("cfg-monitor", 20000);
+    slumber_net_id     = slumber_register("net-heartbeat", 10000);
+    slumber_storage_id = slumber_register("storage-maint", 50000);
+    
+    // สร้าง initialization tasks spread across both cores; the graph,
+    // not creation order, decides when each actually starts working.
+    xTaskCreate(telemetry_flusher_task, "TlmFlush", 2048, NULL, 5, &tx_flusher_handle);
+
+    xTaskCreatePinnedToCore(network_init_task, "NetworkInit", 3072, NULL, 6, NULL, 0);
+    xTaskCreatePinnedToCore(sensor_init_task, "SensorInit", 2048, NULL, 5, NULL, 1);
+    xTaskCreatePinnedToCore(config_load_task, "ConfigLoad", 2048, NULL, 4, NULL, 0);
+    xTaskCreatePinnedToCore(storage_maintenance_task, "StorageMaint", 2048, NULL, 4, NULL, 1);
     
     // สร้าง system coordinator
     xTaskCreate(system_coordinator_task, "SysCoord", 3072, NULL, 8, NULL);
     
     // สร้าง event monitor
-    xTaskCreate(event_monitor_task, "EventMon", 2048, NULL, 3, NULL);
+    xTaskCreate(event_monitor_task, "EventMon", 3072, NULL, 3, &event_monitor_handle);
+
+    if (journal_ready) {
+        xTaskCreate(journal_flush_task, "EvtJournal", 3072, NULL, 2, NULL);
+    }
+
+    // Sleep broker shares idle priority so it can only ever displace
+    // the idle task itself.
+    xTaskCreate(slumber_broker_task, "SleepBroker", 2048, NULL, tskIDLE_PRIORITY, NULL);
+
+    // Wide (64-bit) event group demo
+    if (weg_init(&wide_events)) {
+        xTaskCreate(wide_producer_task, "WideProd", 2048, NULL, 4, NULL);
+        xTaskCreate(wide_waiter_task, "WideWait", 2048, NULL, 5, NULL);
+    }
     
     ESP_LOGI(TAG, "All tasks created successfully");
     ESP_LOGI(TAG, "\n🎯 LED Indicators:");
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -11,6 +12,7 @@
 #include "esp_random.h"
 #include "esp_timer.h"
 #include "driver/gpio.h"
+#include "telemetry_codec.h"
 
 static const char *TAG = "EVENT_SYNC";
 
@@ -70,9 +72,243 @@ typedef struct {
     bool requires_approval;
 } workflow_item_t;
 
+// -------------------- LOCK-FREE MPMC QUEUE --------------------
+// Bounded multi-producer/multi-consumer queue without a lock: each slot
+// carries its own sequence number (ticket). A producer claims a ticket
+// by CAS on the enqueue cursor, writes its payload, then publishes by
+// bumping the slot's sequence; a consumer does the mirror image. The
+// only cross-core traffic is one CAS plus one release store per
+// operation — no mutex, no priority inversion, ISR-unsafe but ideal
+// between worker tasks on both cores.
+#define MPMC_SIZE 64   // power of two
+
+typedef struct {
+    atomic_uint_fast32_t seq;
+    uint32_t value;
+} mpmc_cell_t;
+
+typedef struct {
+    mpmc_cell_t cells[MPMC_SIZE];
+    atomic_uint_fast32_t enqueue_pos;
+    atomic_uint_fast32_t dequeue_pos;
+} mpmc_queue_t;
+
+void mpmc_init(mpmc_queue_t *q) {
+    for (int i = 0; i < MPMC_SIZE; i++)
+        atomic_store_explicit(&q->cells[i].seq, i, memory_order_relaxed);
+    atomic_store(&q->enqueue_pos, 0);
+    atomic_store(&q->dequeue_pos, 0);
+}
+
+bool mpmc_enqueue(mpmc_queue_t *q, uint32_t value) {
+    uint_fast32_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    mpmc_cell_t *cell;
+    for (;;) {
+        cell = &q->cells[pos & (MPMC_SIZE - 1)];
+        uint_fast32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return false;   // full
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->value = value;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+bool mpmc_dequeue(mpmc_queue_t *q, uint32_t *value) {
+    uint_fast32_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    mpmc_cell_t *cell;
+    for (;;) {
+        cell = &q->cells[pos & (MPMC_SIZE - 1)];
+        uint_fast32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return false;   // empty
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+    *value = cell->value;
+    atomic_store_explicit(&cell->seq, pos + MPMC_SIZE, memory_order_release);
+    return true;
+}
+
+// --- Contention benchmark: MPMC vs FreeRTOS queue, 2P x 2C ---
+#define MPMCB_OPS_PER_PRODUCER 20000
+
+static mpmc_queue_t bench_mpmc;
+static QueueHandle_t bench_frq;
+static atomic_uint mpmcb_consumed;
+static bool mpmcb_lockfree_mode;
+static SemaphoreHandle_t mpmcb_done_sem;
+
+static void mpmcb_producer_task(void *pv) {
+    for (uint32_t i = 0; i < MPMCB_OPS_PER_PRODUCER; i++) {
+        if (mpmcb_lockfree_mode) {
+            while (!mpmc_enqueue(&bench_mpmc, i))
+                taskYIELD();
+        } else {
+            xQueueSend(bench_frq, &i, portMAX_DELAY);
+        }
+    }
+    xSemaphoreGive(mpmcb_done_sem);
+    vTaskDelete(NULL);
+}
+
+static void mpmcb_consumer_task(void *pv) {
+    const unsigned target = 2 * MPMCB_OPS_PER_PRODUCER;
+    uint32_t v;
+    while (atomic_load_explicit(&mpmcb_consumed, memory_order_relaxed) < target) {
+        bool got = mpmcb_lockfree_mode
+                       ? mpmc_dequeue(&bench_mpmc, &v)
+                       : (xQueueReceive(bench_frq, &v, pdMS_TO_TICKS(10)) == pdTRUE);
+        if (got)
+            atomic_fetch_add_explicit(&mpmcb_consumed, 1, memory_order_relaxed);
+        else if (mpmcb_lockfree_mode)
+            taskYIELD();
+    }
+    xSemaphoreGive(mpmcb_done_sem);
+    vTaskDelete(NULL);
+}
+
+// One producer and one consumer pinned per core, so every operation
+// contends across cores — the worst case either queue will see.
+static uint32_t mpmcb_run(bool lockfree) {
+    mpmcb_lockfree_mode = lockfree;
+    atomic_store(&mpmcb_consumed, 0);
+    if (lockfree)
+        mpmc_init(&bench_mpmc);
+    else
+        xQueueReset(bench_frq);
+
+    uint64_t t0 = esp_timer_get_time();
+    for (int core = 0; core < 2; core++) {
+        xTaskCreatePinnedToCore(mpmcb_producer_task, "MpmcProd", 2048, NULL, 4, NULL, core);
+        xTaskCreatePinnedToCore(mpmcb_consumer_task, "MpmcCons", 2048, NULL, 4, NULL, core);
+    }
+    for (int i = 0; i < 4; i++)
+        xSemaphoreTake(mpmcb_done_sem, portMAX_DELAY);
+    uint64_t us = esp_timer_get_time() - t0;
+    return us ? (uint32_t)((uint64_t)2 * MPMCB_OPS_PER_PRODUCER * 1000000 / us) : 0;
+}
+
+void mpmc_benchmark_task(void *pv) {
+    mpmcb_done_sem = xSemaphoreCreateCounting(4, 0);
+    bench_frq = xQueueCreate(MPMC_SIZE, sizeof(uint32_t));
+    vTaskDelay(pdMS_TO_TICKS(10000));   // let the lab settle first
+
+    ESP_LOGI(TAG, "=== MPMC contention benchmark (2P x 2C, %d ops) ===",
+             2 * MPMCB_OPS_PER_PRODUCER);
+    uint32_t lockfree_rate = mpmcb_run(true);
+    vTaskDelay(pdMS_TO_TICKS(500));
+    uint32_t freertos_rate = mpmcb_run(false);
+    ESP_LOGI(TAG, "Lock-free MPMC:  %lu ops/sec", lockfree_rate);
+    ESP_LOGI(TAG, "FreeRTOS queue:  %lu ops/sec", freertos_rate);
+    ESP_LOGI(TAG, "Speedup: %.2fx", freertos_rate ? (float)lockfree_rate / freertos_rate : 0.0f);
+
+    vQueueDelete(bench_frq);
+    vTaskDelete(NULL);
+}
+
+// -------------------- MULTI-LANE CHANNEL --------------------
+// The pipeline needs urgent control messages to overtake queued bulk
+// data, and a FreeRTOS queue gives exactly one overtaking lane
+// (SendToFront). This channel keeps N internal rings under one handle:
+// senders pick a lane, the receiver drains by weighted round-robin
+// (4:2:1 service credits, refilled when exhausted), so urgent traffic
+// goes first but bulk never starves. Depth, high-water and rejects are
+// tracked per lane.
+#define MLQ_LANES        3
+#define MLQ_LANE_URGENT  0
+#define MLQ_LANE_NORMAL  1
+#define MLQ_LANE_BULK    2
+#define MLQ_LANE_DEPTH   8
+
+typedef struct {
+    pipeline_data_t items[MLQ_LANES][MLQ_LANE_DEPTH];
+    int head[MLQ_LANES];
+    int count[MLQ_LANES];
+    uint8_t credits[MLQ_LANES];
+    portMUX_TYPE lock;
+    SemaphoreHandle_t items_sem;       // total queued; blocks receivers
+    uint32_t sent[MLQ_LANES], rejected[MLQ_LANES], hiwater[MLQ_LANES];
+} mlq_t;
+
+static const uint8_t mlq_weights[MLQ_LANES] = {4, 2, 1};
+
+bool mlq_init(mlq_t *q) {
+    memset(q, 0, sizeof(*q));
+    portMUX_TYPE init = portMUX_INITIALIZER_UNLOCKED;
+    q->lock = init;
+    memcpy(q->credits, mlq_weights, sizeof(q->credits));
+    q->items_sem = xSemaphoreCreateCounting(MLQ_LANES * MLQ_LANE_DEPTH, 0);
+    return q->items_sem != NULL;
+}
+
+bool mlq_send(mlq_t *q, int lane, const pipeline_data_t *item) {
+    bool ok = false;
+    portENTER_CRITICAL(&q->lock);
+    if (q->count[lane] < MLQ_LANE_DEPTH) {
+        int tail = (q->head[lane] + q->count[lane]) % MLQ_LANE_DEPTH;
+        q->items[lane][tail] = *item;
+        q->count[lane]++;
+        q->sent[lane]++;
+        if (q->count[lane] > (int)q->hiwater[lane])
+            q->hiwater[lane] = q->count[lane];
+        ok = true;
+    } else {
+        q->rejected[lane]++;
+    }
+    portEXIT_CRITICAL(&q->lock);
+    if (ok)
+        xSemaphoreGive(q->items_sem);
+    return ok;
+}
+
+bool mlq_receive(mlq_t *q, pipeline_data_t *item, TickType_t wait) {
+    if (xSemaphoreTake(q->items_sem, wait) != pdTRUE)
+        return false;
+    portENTER_CRITICAL(&q->lock);
+    // Two passes at most: one against remaining credits, then a refill.
+    int lane = -1;
+    for (int pass = 0; pass < 2 && lane < 0; pass++) {
+        for (int l = 0; l < MLQ_LANES; l++) {
+            if (q->count[l] > 0 && q->credits[l] > 0) {
+                lane = l;
+                break;
+            }
+        }
+        if (lane < 0)
+            memcpy(q->credits, mlq_weights, sizeof(q->credits));
+    }
+    // The semaphore guarantees something is queued; worst case the
+    // refill pass found it.
+    q->credits[lane]--;
+    *item = q->items[lane][q->head[lane]];
+    q->head[lane] = (q->head[lane] + 1) % MLQ_LANE_DEPTH;
+    q->count[lane]--;
+    portEXIT_CRITICAL(&q->lock);
+    return true;
+}
+
 // Queues
-QueueHandle_t pipeline_queue;
-QueueHandle_t workflow_queue;
+static mlq_t pipeline_mlq;
+
+// Urgent control marker: stages recognize it and act immediately.
+#define MLQ_CTRL_FLUSH_ID 0xFFFFFFFFu
 
 // Stats
 typedef struct {
@@ -86,10 +322,262 @@ typedef struct {
 
 static sync_stats_t stats = {0};
 
+// -------------------- P² QUANTILE SKETCH --------------------
+// The latency histograms further down resolve percentiles only to the
+// nearest power-of-two bucket, and the barrier stats still keep a
+// running average — the one number that stays flat while the tail
+// explodes.
+// The P² estimator (Jain & Chlamtac) tracks a single quantile with five
+// markers nudged per observation: O(1) insert, no sample buffer, and
+// the markers converge on the true quantile without ever storing the
+// stream. Three estimators per metric (p50/p95/p99) cost ~250 bytes,
+// so every metric the monitor reports can carry its tail.
+#define PSK_MARKERS 5
+
+typedef struct {
+    float p;                     // target quantile, e.g. 0.99
+    float q[PSK_MARKERS];        // marker heights
+    float np[PSK_MARKERS];       // desired marker positions
+    float dnp[PSK_MARKERS];      // desired-position increments
+    int16_t n[PSK_MARKERS];      // actual marker positions
+    uint32_t count;
+} p2_est_t;
+
+static void p2_insert(p2_est_t *e, float x) {
+    if (e->count < PSK_MARKERS) {
+        // Warm-up: keep the first five observations sorted in place.
+        int i = e->count++;
+        while (i > 0 && e->q[i - 1] > x) {
+            e->q[i] = e->q[i - 1];
+            i--;
+        }
+        e->q[i] = x;
+        if (e->count == PSK_MARKERS) {
+            for (int j = 0; j < PSK_MARKERS; j++) e->n[j] = j + 1;
+            e->np[0] = 1;
+            e->np[1] = 1 + 2 * e->p;
+            e->np[2] = 1 + 4 * e->p;
+            e->np[3] = 3 + 2 * e->p;
+            e->np[4] = 5;
+            e->dnp[0] = 0;
+            e->dnp[1] = e->p / 2;
+            e->dnp[2] = e->p;
+            e->dnp[3] = (1 + e->p) / 2;
+            e->dnp[4] = 1;
+        }
+        return;
+    }
+    e->count++;
+
+    int k;
+    if (x < e->q[0]) {
+        e->q[0] = x;
+        k = 0;
+    } else if (x >= e->q[4]) {
+        e->q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; k < 3; k++)
+            if (x < e->q[k + 1]) break;
+    }
+    for (int i = k + 1; i < PSK_MARKERS; i++) e->n[i]++;
+    for (int i = 0; i < PSK_MARKERS; i++) e->np[i] += e->dnp[i];
+
+    // Nudge the three interior markers toward their desired positions:
+    // parabolic interpolation when it stays monotone, linear otherwise.
+    for (int i = 1; i <= 3; i++) {
+        float d = e->np[i] - e->n[i];
+        if ((d >= 1 && e->n[i + 1] - e->n[i] > 1) ||
+            (d <= -1 && e->n[i - 1] - e->n[i] < -1)) {
+            int s = (d >= 1) ? 1 : -1;
+            float qp = e->q[i] + (float)s / (e->n[i + 1] - e->n[i - 1]) *
+                ((e->n[i] - e->n[i - 1] + s) * (e->q[i + 1] - e->q[i]) /
+                     (e->n[i + 1] - e->n[i]) +
+                 (e->n[i + 1] - e->n[i] - s) * (e->q[i] - e->q[i - 1]) /
+                     (e->n[i] - e->n[i - 1]));
+            if (e->q[i - 1] < qp && qp < e->q[i + 1])
+                e->q[i] = qp;
+            else
+                e->q[i] = e->q[i] + s * (e->q[i + s] - e->q[i]) /
+                                        (e->n[i + s] - e->n[i]);
+            e->n[i] += s;
+        }
+    }
+}
+
+static float p2_value(const p2_est_t *e) {
+    if (e->count == 0) return 0;
+    if (e->count < PSK_MARKERS) {
+        // Too few samples to place markers: nearest order statistic.
+        int idx = (int)(e->p * (e->count - 1) + 0.5f);
+        return e->q[idx];
+    }
+    return e->q[2];
+}
+
+typedef struct {
+    const char *name;
+    p2_est_t p50, p95, p99;
+    uint32_t count;
+    uint32_t max_us;
+} psk_metric_t;
+
+static psk_metric_t psk_barrier   = {.name = "barrier"};
+static psk_metric_t psk_approval  = {.name = "approval"};
+static psk_metric_t psk_roundtrip = {.name = "roundtrip"};
+
+// The barrier metric is fed by four workers that leave the barrier at
+// the same instant, so inserts collide by construction; the marker
+// update is a handful of float ops, short enough for a spinlock.
+static portMUX_TYPE psk_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void psk_record(psk_metric_t *m, uint32_t us) {
+    portENTER_CRITICAL(&psk_lock);
+    if (m->count == 0) {
+        m->p50.p = 0.50f;
+        m->p95.p = 0.95f;
+        m->p99.p = 0.99f;
+    }
+    p2_insert(&m->p50, (float)us);
+    p2_insert(&m->p95, (float)us);
+    p2_insert(&m->p99, (float)us);
+    m->count++;
+    if (us > m->max_us) m->max_us = us;
+    portEXIT_CRITICAL(&psk_lock);
+}
+
+static void psk_report(const psk_metric_t *m) {
+    if (m->count == 0) return;
+    ESP_LOGI(TAG, "📈 %-9s n=%lu p50=%.0fus p95=%.0fus p99=%.0fus max=%luus",
+             m->name, m->count, p2_value(&m->p50), p2_value(&m->p95),
+             p2_value(&m->p99), m->max_us);
+}
+
+// -------------------- COUNTING BARRIER --------------------
+// xEventGroupSync caps a barrier at 24 workers (one bit each) and scans
+// the whole wait list on every set. This barrier is just an atomic
+// arrival counter: the last arriver flips the generation and releases
+// everyone through a counting semaphore in one burst. No per-worker
+// bits, so it scales to any worker count, and it is reusable — a fast
+// worker can re-enter the next generation while stragglers are still
+// draining their release tokens.
+typedef struct {
+    unsigned parties;
+    atomic_uint arrivals;
+    atomic_uint generation;
+    SemaphoreHandle_t release_sem;   // counting; last arriver posts parties-1 tokens
+} counting_barrier_t;
+
+bool counting_barrier_init(counting_barrier_t *b, unsigned parties) {
+    b->parties = parties;
+    atomic_init(&b->arrivals, 0);
+    atomic_init(&b->generation, 0);
+    b->release_sem = xSemaphoreCreateCounting(parties, 0);
+    return b->release_sem != NULL;
+}
+
+void counting_barrier_wait(counting_barrier_t *b) {
+    unsigned arrived = atomic_fetch_add(&b->arrivals, 1) + 1;
+    if (arrived == b->parties) {
+        atomic_store(&b->arrivals, 0);
+        atomic_fetch_add(&b->generation, 1);
+        for (unsigned i = 0; i < b->parties - 1; i++)
+            xSemaphoreGive(b->release_sem);
+    } else {
+        xSemaphoreTake(b->release_sem, portMAX_DELAY);
+    }
+}
+
+void counting_barrier_destroy(counting_barrier_t *b) {
+    vSemaphoreDelete(b->release_sem);
+    b->release_sem = NULL;
+}
+
+// ----- Barrier benchmark: counting barrier vs xEventGroupSync -----
+#define BARRIER_BENCH_CYCLES 200
+
+typedef struct {
+    counting_barrier_t *barrier;        // counting-barrier mode when set
+    EventGroupHandle_t sync_group;      // event-group mode when set
+    EventBits_t all_bits;
+    unsigned worker_id;
+    SemaphoreHandle_t done_sem;
+} barrier_bench_params_t;
+
+void barrier_bench_worker(void *pvParameters) {
+    barrier_bench_params_t *p = (barrier_bench_params_t *)pvParameters;
+    for (int i = 0; i < BARRIER_BENCH_CYCLES; i++) {
+        if (p->barrier)
+            counting_barrier_wait(p->barrier);
+        else
+            xEventGroupSync(p->sync_group, (1 << p->worker_id),
+                            p->all_bits, portMAX_DELAY);
+    }
+    xSemaphoreGive(p->done_sem);
+    vTaskDelete(NULL);
+}
+
+// Runs one configuration and returns average us per barrier cycle.
+static uint32_t run_barrier_bench(unsigned workers, bool use_counting) {
+    static barrier_bench_params_t params[32];
+    counting_barrier_t barrier;
+    EventGroupHandle_t sync_group = NULL;
+    SemaphoreHandle_t done_sem = xSemaphoreCreateCounting(workers, 0);
+
+    if (use_counting) {
+        counting_barrier_init(&barrier, workers);
+    } else {
+        sync_group = xEventGroupCreate();
+    }
+
+    uint64_t start = esp_timer_get_time();
+    for (unsigned i = 0; i < workers; i++) {
+        params[i].barrier = use_counting ? &barrier : NULL;
+        params[i].sync_group = sync_group;
+        params[i].all_bits = (1 << workers) - 1;
+        params[i].worker_id = i;
+        params[i].done_sem = done_sem;
+        char name[16];
+        sprintf(name, "BB%u", i);
+        xTaskCreate(barrier_bench_worker, name, 2048, &params[i], 9, NULL);
+    }
+    for (unsigned i = 0; i < workers; i++)
+        xSemaphoreTake(done_sem, portMAX_DELAY);
+    uint64_t elapsed = esp_timer_get_time() - start;
+
+    if (use_counting) counting_barrier_destroy(&barrier);
+    else vEventGroupDelete(sync_group);
+    vSemaphoreDelete(done_sem);
+
+    return (uint32_t)(elapsed / BARRIER_BENCH_CYCLES);
+}
+
+void barrier_benchmark_task(void *pvParameters) {
+    const unsigned worker_counts[] = {4, 16, 32};
+
+    vTaskDelay(pdMS_TO_TICKS(3000));
+    ESP_LOGI(TAG, "=== Barrier benchmark (%d cycles each) ===", BARRIER_BENCH_CYCLES);
+    for (int i = 0; i < 3; i++) {
+        unsigned n = worker_counts[i];
+        uint32_t counting_us = run_barrier_bench(n, true);
+        if (n <= 24) {
+            uint32_t eg_us = run_barrier_bench(n, false);
+            ESP_LOGI(TAG, "%2u workers: counting=%luus/cycle event-group=%luus/cycle",
+                     n, counting_us, eg_us);
+        } else {
+            ESP_LOGI(TAG, "%2u workers: counting=%luus/cycle (event group: >24 workers unsupported)",
+                     n, counting_us);
+        }
+    }
+    ESP_LOGI(TAG, "=== Barrier benchmark done ===");
+    vTaskDelete(NULL);
+}
+
 // -------------------- BARRIER --------------------
+static counting_barrier_t worker_barrier;
+
 void barrier_worker_task(void *pvParameters) {
     uint32_t worker_id = (uint32_t)pvParameters;
-    EventBits_t my_ready_bit = (1 << worker_id);
     uint32_t cycle = 0;
 
     ESP_LOGI(TAG, "🏃 Worker %lu started", worker_id);
@@ -101,29 +589,94 @@ void barrier_worker_task(void *pvParameters) {
         vTaskDelay(pdMS_TO_TICKS(work_duration));
 
         uint64_t start = esp_timer_get_time();
-        xEventGroupSetBits(barrier_events, my_ready_bit);
+        counting_barrier_wait(&worker_barrier);
+        uint32_t wait_us = (uint32_t)(esp_timer_get_time() - start);
+        uint32_t wait_time = wait_us / 1000;
+        psk_record(&psk_barrier, wait_us);
 
-        EventBits_t bits = xEventGroupWaitBits(barrier_events, ALL_WORKERS_READY, pdTRUE, pdTRUE, pdMS_TO_TICKS(10000));
-        uint32_t wait_time = (esp_timer_get_time() - start) / 1000;
-
-        if ((bits & ALL_WORKERS_READY) == ALL_WORKERS_READY) {
-            if (worker_id == 0) {
-                stats.barrier_cycles++;
-                gpio_set_level(LED_BARRIER_SYNC, 1);
-                vTaskDelay(pdMS_TO_TICKS(200));
-                gpio_set_level(LED_BARRIER_SYNC, 0);
-            }
-            if (wait_time > stats.synchronization_time_max)
-                stats.synchronization_time_max = wait_time;
-            stats.synchronization_time_avg = (stats.synchronization_time_avg + wait_time) / 2;
-            ESP_LOGI(TAG, "🎯 Worker %lu barrier passed (%lu ms)", worker_id, wait_time);
-        } else {
-            ESP_LOGW(TAG, "⏰ Worker %lu timeout", worker_id);
+        if (worker_id == 0) {
+            stats.barrier_cycles++;
+            gpio_set_level(LED_BARRIER_SYNC, 1);
+            vTaskDelay(pdMS_TO_TICKS(200));
+            gpio_set_level(LED_BARRIER_SYNC, 0);
         }
+        if (wait_time > stats.synchronization_time_max)
+            stats.synchronization_time_max = wait_time;
+        stats.synchronization_time_avg = (stats.synchronization_time_avg + wait_time) / 2;
+        ESP_LOGI(TAG, "🎯 Worker %lu barrier passed (generation %u, waited %lu ms)",
+                 worker_id, atomic_load(&worker_barrier.generation), wait_time);
         vTaskDelay(pdMS_TO_TICKS(2000));
     }
 }
 
+// -------------------- WAIT-SITE TIMING --------------------
+// A wait on event bits that regularly burns 9 s of a 10 s budget looks
+// identical in the log to one that returns in a millisecond. This
+// wrapper stands in for xEventGroupWaitBits at the sites we tune:
+// per-site power-of-two duration buckets, a timeout-hit counter, and a
+// near-budget counter (wait consumed >= 75% of the budget) — all fixed
+// storage, one timestamp pair per wait.
+#define EWT_SITES_MAX 4
+#define EWT_BUCKETS   24   // bucket i: [2^i, 2^(i+1)) us
+
+typedef struct {
+    const char *name;
+    TickType_t budget;
+    uint32_t buckets[EWT_BUCKETS];
+    uint32_t waits;
+    uint32_t timeouts;
+    uint32_t near_budget;
+    uint32_t max_us;
+} ewt_site_t;
+
+static ewt_site_t ewt_sites[EWT_SITES_MAX];
+static int ewt_site_count = 0;
+
+static int ewt_register(const char *name, TickType_t budget) {
+    ewt_sites[ewt_site_count] = (ewt_site_t){ .name = name, .budget = budget };
+    return ewt_site_count++;
+}
+
+static EventBits_t ewt_wait_bits(int site, EventGroupHandle_t group, EventBits_t bits,
+                                 BaseType_t clear_on_exit, BaseType_t wait_all) {
+    ewt_site_t *s = &ewt_sites[site];
+    int64_t t0 = esp_timer_get_time();
+    EventBits_t out = xEventGroupWaitBits(group, bits, clear_on_exit, wait_all, s->budget);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    int bucket = us ? 31 - __builtin_clz(us) : 0;
+    if (bucket >= EWT_BUCKETS) bucket = EWT_BUCKETS - 1;
+    s->buckets[bucket]++;
+    s->waits++;
+    if (us > s->max_us) s->max_us = us;
+
+    bool satisfied = wait_all ? ((out & bits) == bits) : ((out & bits) != 0);
+    if (!satisfied) {
+        s->timeouts++;
+    } else if (s->budget != portMAX_DELAY) {
+        uint64_t budget_us = (uint64_t)s->budget * portTICK_PERIOD_MS * 1000;
+        if ((uint64_t)us * 4 >= budget_us * 3) s->near_budget++;
+    }
+    return out;
+}
+
+static void ewt_report(void) {
+    ESP_LOGI(TAG, "⏲️ Wait-site distribution:");
+    for (int i = 0; i < ewt_site_count; i++) {
+        ewt_site_t *s = &ewt_sites[i];
+        if (s->waits == 0) continue;
+        ESP_LOGI(TAG, "  %-10s %lu waits | %lu timeouts | %lu near-budget | max %luus",
+                 s->name, s->waits, s->timeouts, s->near_budget, s->max_us);
+        for (int b = 0; b < EWT_BUCKETS; b++) {
+            if (s->buckets[b])
+                ESP_LOGI(TAG, "    [%8lu..%8luus) %lu",
+                         1ul << b, 1ul << (b + 1), s->buckets[b]);
+        }
+    }
+}
+
+static int ewt_stage, ewt_approval, ewt_dispatch;
+
 // -------------------- PIPELINE --------------------
 void pipeline_stage_task(void *pvParameters) {
     uint32_t stage_id = (uint32_t)pvParameters;
@@ -136,11 +689,17 @@ void pipeline_stage_task(void *pvParameters) {
     ESP_LOGI(TAG, "🏭 Stage %lu (%s) started", stage_id, names[stage_id]);
 
     while (1) {
-        xEventGroupWaitBits(pipeline_events, prev_bit, pdTRUE, pdTRUE, portMAX_DELAY);
+        ewt_wait_bits(ewt_stage, pipeline_events, prev_bit, pdTRUE, pdTRUE);
         gpio_set_level(leds[stage_id], 1);
 
         pipeline_data_t data;
-        if (xQueueReceive(pipeline_queue, &data, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (mlq_receive(&pipeline_mlq, &data, pdMS_TO_TICKS(100))) {
+            if (data.pipeline_id == MLQ_CTRL_FLUSH_ID) {
+                // Control message: overtook everything queued behind it.
+                ESP_LOGW(TAG, "⚡ Stage %lu got control flush (urgent lane)", stage_id);
+                gpio_set_level(leds[stage_id], 0);
+                continue;
+            }
             data.stage = stage_id;
             data.stage_timestamps[stage_id] = esp_timer_get_time();
 
@@ -149,7 +708,7 @@ void pipeline_stage_task(void *pvParameters) {
             vTaskDelay(pdMS_TO_TICKS(time));
 
             if (stage_id < 3) {
-                xQueueSend(pipeline_queue, &data, pdMS_TO_TICKS(100));
+                mlq_send(&pipeline_mlq, MLQ_LANE_NORMAL, &data);
                 xEventGroupSetBits(pipeline_events, stage_bit);
             } else {
                 stats.pipeline_completions++;
@@ -160,6 +719,166 @@ void pipeline_stage_task(void *pvParameters) {
     }
 }
 
+// -------------------- WORK-STEALING EXECUTOR --------------------
+// The fixed pipeline above dedicates one task per stage, so the slowest
+// stage caps throughput while the other core idles. Here each stage hop
+// is a queued work item instead: two worker tasks, one pinned per core,
+// run whatever item is available. Owners push and pop the bottom of
+// their own deque (LIFO keeps an item's data warm in cache); an idle
+// worker steals from the top of the other's deque (FIFO, oldest first),
+// so load balances automatically and both cores stay busy.
+#define WS_WORKERS       2
+#define WS_DEQUE_SIZE    16
+#define WS_STAGE_COUNT   4
+
+// Migration cost model: moving an item to the other core means its data
+// is reloaded through that core's cache, so stealing only pays when the
+// victim has a real backlog. A single queued item stays put (its owner
+// will run it warm); past the threshold a thief takes half the backlog
+// in one locked pass (steal-half), so one steal rebalances instead of
+// the workers trading items one by one.
+#define WS_STEAL_MIN_BACKLOG  2
+
+typedef struct {
+    pipeline_data_t data;
+    uint32_t stage;
+    int8_t last_worker;      // who ran the previous stage (-1 = fresh)
+} ws_item_t;
+
+typedef struct {
+    ws_item_t items[WS_DEQUE_SIZE];
+    int top;                 // steal end
+    int bottom;              // owner end
+    portMUX_TYPE lock;
+    uint32_t executed;
+    uint32_t steals;         // steal batches taken by this worker
+    uint32_t stolen_items;   // items moved in those batches
+    uint32_t migrations;     // stage ran on a different worker than the last
+    uint32_t overflows;
+} ws_deque_t;
+
+static ws_deque_t ws_deques[WS_WORKERS];
+static uint32_t ws_completions = 0;
+
+static bool ws_push_bottom(ws_deque_t *d, const ws_item_t *item) {
+    bool ok = false;
+    portENTER_CRITICAL(&d->lock);
+    if (d->bottom - d->top < WS_DEQUE_SIZE) {
+        d->items[d->bottom % WS_DEQUE_SIZE] = *item;
+        d->bottom++;
+        ok = true;
+    } else {
+        d->overflows++;
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return ok;
+}
+
+static bool ws_pop_bottom(ws_deque_t *d, ws_item_t *item) {
+    bool ok = false;
+    portENTER_CRITICAL(&d->lock);
+    if (d->bottom > d->top) {
+        d->bottom--;
+        *item = d->items[d->bottom % WS_DEQUE_SIZE];
+        ok = true;
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return ok;
+}
+
+// Steal-half from the top end: the oldest items have been queued the
+// longest, so their cache lines are the most likely to be evicted
+// already — migrating them costs the least.
+static int ws_steal_half(ws_deque_t *d, ws_item_t *out, int max) {
+    int take = 0;
+    portENTER_CRITICAL(&d->lock);
+    int backlog = d->bottom - d->top;
+    if (backlog >= WS_STEAL_MIN_BACKLOG) {
+        take = backlog / 2;
+        if (take > max) take = max;
+        for (int i = 0; i < take; i++) {
+            out[i] = d->items[d->top % WS_DEQUE_SIZE];
+            d->top++;
+        }
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return take;
+}
+
+// One stage hop: stages deliberately uneven (stage 1 is the hog) to
+// show stealing rebalance what the fixed pipeline cannot.
+static void ws_execute_stage(ws_item_t *item, int worker_id) {
+    static const uint32_t stage_cost_ms[WS_STAGE_COUNT] = {20, 120, 30, 10};
+    if (item->last_worker >= 0 && item->last_worker != worker_id)
+        ws_deques[worker_id].migrations++;
+    item->last_worker = (int8_t)worker_id;
+    vTaskDelay(pdMS_TO_TICKS(stage_cost_ms[item->stage]));
+    item->data.stage_timestamps[item->stage] = esp_timer_get_time();
+
+    if (item->stage + 1 < WS_STAGE_COUNT) {
+        item->stage++;
+        if (!ws_push_bottom(&ws_deques[worker_id], item))
+            ws_push_bottom(&ws_deques[(worker_id + 1) % WS_WORKERS], item);
+    } else {
+        ws_completions++;
+    }
+}
+
+void ws_worker_task(void *pvParameters) {
+    int id = (int)pvParameters;
+    ws_deque_t *mine = &ws_deques[id];
+    ws_deque_t *victim = &ws_deques[(id + 1) % WS_WORKERS];
+    ws_item_t item;
+
+    ESP_LOGI(TAG, "🔩 Executor worker %d on core %d", id, xPortGetCoreID());
+    while (1) {
+        if (ws_pop_bottom(mine, &item)) {
+            mine->executed++;
+            ws_execute_stage(&item, id);
+        } else {
+            ws_item_t batch[WS_DEQUE_SIZE / 2];
+            int got = ws_steal_half(victim, batch, WS_DEQUE_SIZE / 2);
+            if (got > 0) {
+                mine->steals++;
+                mine->stolen_items += got;
+                // Queue all but one locally, run the first right away.
+                for (int i = 1; i < got; i++)
+                    ws_push_bottom(mine, &batch[i]);
+                mine->executed++;
+                ws_execute_stage(&batch[0], id);
+            } else {
+                vTaskDelay(1);
+            }
+        }
+    }
+}
+
+void ws_generator_task(void *pvParameters) {
+    uint32_t pid = 0;
+    while (1) {
+        ws_item_t item = {0};
+        item.data.pipeline_id = ++pid;
+        item.stage = 0;
+        item.last_worker = -1;
+        item.data.stage_timestamps[0] = esp_timer_get_time();
+        ws_push_bottom(&ws_deques[pid % WS_WORKERS], &item);
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+void start_work_stealing_executor(void) {
+    for (int i = 0; i < WS_WORKERS; i++) {
+        ws_deques[i].top = ws_deques[i].bottom = 0;
+        portMUX_TYPE init = portMUX_INITIALIZER_UNLOCKED;
+        ws_deques[i].lock = init;
+        char name[16];
+        sprintf(name, "WSWork%d", i);
+        xTaskCreatePinnedToCore(ws_worker_task, name, 3072, (void*)i, 6, NULL, i);
+    }
+    xTaskCreate(ws_generator_task, "WSGen", 2048, NULL, 4, NULL);
+    ESP_LOGI(TAG, "Work-stealing executor started (%d workers)", WS_WORKERS);
+}
+
 void pipeline_data_generator_task(void *pvParameters) {
     uint32_t pid = 0;
     ESP_LOGI(TAG, "📦 Pipeline generator started");
@@ -168,20 +887,239 @@ void pipeline_data_generator_task(void *pvParameters) {
         d.pipeline_id = ++pid;
         d.stage = 0;
         d.stage_timestamps[0] = esp_timer_get_time();
-        xQueueSend(pipeline_queue, &d, pdMS_TO_TICKS(100));
+        mlq_send(&pipeline_mlq, MLQ_LANE_BULK, &d);
         xEventGroupSetBits(pipeline_events, DATA_AVAILABLE_BIT);
         ESP_LOGI(TAG, "🚀 Data %lu injected", pid);
+
+        // Every few injections, an urgent control message chases the
+        // bulk data through the same channel — and passes it.
+        if (pid % 5 == 0) {
+            pipeline_data_t ctrl = {0};
+            ctrl.pipeline_id = MLQ_CTRL_FLUSH_ID;
+            mlq_send(&pipeline_mlq, MLQ_LANE_URGENT, &ctrl);
+            xEventGroupSetBits(pipeline_events, DATA_AVAILABLE_BIT);
+        }
         vTaskDelay(pdMS_TO_TICKS(3000 + (esp_random() % 3000)));
     }
 }
 
+// -------------------- LATENCY HISTOGRAMS --------------------
+// The approval flow had no timing visibility, and its round trips can
+// spike past 100 ms without anything recording it. Each request carries
+// a timestamp; completions drop the elapsed time into per-stage
+// histograms with power-of-two microsecond buckets. Recording is two
+// relaxed atomic adds plus a CAS for the max — no locks, nothing
+// allocated, cheap enough to run on every request.
+#define LH_BUCKETS 20   // bucket i covers [2^i, 2^(i+1)) us; last is open
+
+typedef struct {
+    const char *name;
+    atomic_uint_fast32_t buckets[LH_BUCKETS];
+    atomic_uint_fast32_t count;
+    atomic_uint_fast32_t max_us;
+} lat_hist_t;
+
+static lat_hist_t lh_approval  = {.name = "approval"};
+static lat_hist_t lh_roundtrip = {.name = "roundtrip"};
+
+static void lat_hist_record(lat_hist_t *h, uint32_t us) {
+    int bucket = us == 0 ? 0 : 31 - __builtin_clz(us);
+    if (bucket >= LH_BUCKETS) bucket = LH_BUCKETS - 1;
+    atomic_fetch_add_explicit(&h->buckets[bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+
+    uint_fast32_t seen = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    while (us > seen &&
+           !atomic_compare_exchange_weak_explicit(&h->max_us, &seen, us,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {}
+}
+
+// Percentile = upper bound of the bucket where the cumulative count
+// crosses the rank; exact enough for spotting tail growth.
+static uint32_t lat_hist_percentile(const lat_hist_t *h, uint32_t percent) {
+    uint32_t total = atomic_load_explicit(&h->count, memory_order_relaxed);
+    if (total == 0) return 0;
+    uint32_t rank = (uint64_t)total * percent / 100;
+    uint32_t cumulative = 0;
+    for (int i = 0; i < LH_BUCKETS; i++) {
+        cumulative += atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+        if (cumulative > rank) return 2u << i;
+    }
+    return 2u << (LH_BUCKETS - 1);
+}
+
+static void lat_hist_report(const lat_hist_t *h) {
+    uint32_t total = atomic_load_explicit(&h->count, memory_order_relaxed);
+    if (total == 0) return;
+    ESP_LOGI(TAG, "⏱ %-9s n=%lu p50=%luus p99=%luus max=%luus",
+             h->name, total,
+             lat_hist_percentile(h, 50), lat_hist_percentile(h, 99),
+             atomic_load_explicit(&h->max_us, memory_order_relaxed));
+}
+
+// One approval request is outstanding at a time (single manager), so the
+// request timestamp can be a plain global.
+static uint64_t approval_request_us = 0;
+
+// -------------------- TYPED OBJECT POOLS --------------------
+// Heap-allocating a record per work item churns the allocator and
+// fragments the heap with same-sized short-lived blocks. This macro
+// stamps out a typed pool per record type: fixed storage, a LIFO free
+// stack so acquire/release are O(1) pointer moves under a spinlock, an
+// init hook run on every acquire and a reset hook on every release, and
+// exhaustion stats so an undersized pool shows up in the monitor rather
+// than as mystery NULLs.
+#define OBJECT_POOL_DEFINE(type, name, capacity, init_hook, reset_hook)       \
+    static type name##_storage[capacity];                                     \
+    static type *name##_free[capacity];                                       \
+    static int name##_free_count;                                             \
+    static portMUX_TYPE name##_lock = portMUX_INITIALIZER_UNLOCKED;           \
+    static uint32_t name##_acquires, name##_exhaustions, name##_in_use_hw;    \
+    static void name##_init(void) {                                           \
+        for (int i = 0; i < (capacity); i++)                                  \
+            name##_free[i] = &name##_storage[i];                              \
+        name##_free_count = (capacity);                                       \
+    }                                                                         \
+    static type *name##_acquire(void) {                                      \
+        type *obj = NULL;                                                     \
+        portENTER_CRITICAL(&name##_lock);                                     \
+        if (name##_free_count > 0) {                                          \
+            obj = name##_free[--name##_free_count];                           \
+            name##_acquires++;                                                \
+            uint32_t in_use = (capacity) - name##_free_count;                 \
+            if (in_use > name##_in_use_hw) name##_in_use_hw = in_use;         \
+        } else {                                                              \
+            name##_exhaustions++;                                             \
+        }                                                                     \
+        portEXIT_CRITICAL(&name##_lock);                                      \
+        if (obj != NULL) init_hook(obj);                                      \
+        return obj;                                                           \
+    }                                                                         \
+    static void name##_release(type *obj) {                                   \
+        reset_hook(obj);                                                      \
+        portENTER_CRITICAL(&name##_lock);                                     \
+        name##_free[name##_free_count++] = obj;                               \
+        portEXIT_CRITICAL(&name##_lock);                                      \
+    }                                                                         \
+    static void name##_report(void) {                                         \
+        ESP_LOGI(TAG, "♻️ Pool '" #name "': %lu acquires | %lu exhaustions | hiwater %lu/%d", \
+                 name##_acquires, name##_exhaustions, name##_in_use_hw,       \
+                 (int)(capacity));                                            \
+    }
+
+// Workflow records: zeroed on acquire; the reset hook clears the id so
+// a stale pointer dereference is loud rather than plausible.
+static void wf_record_on_acquire(workflow_item_t *wf) { memset(wf, 0, sizeof(*wf)); }
+static void wf_record_on_release(workflow_item_t *wf) { wf->workflow_id = 0; }
+
+// -------------------- PRIORITY WORK QUEUE --------------------
+// The FIFO workflow queue made an urgent workflow wait behind every bulk
+// item queued before it. This queue keeps one small ring per priority
+// level plus a bitmask of non-empty levels, so pop is "find highest set
+// bit, take ring head" — O(1) regardless of depth. A counting semaphore
+// carries the total item count so the manager still blocks idle. Items
+// that sit longer than PQ_AGE_PROMOTE_MS get promoted one level on the
+// next pop, so bulk work cannot starve outright under a flood of alerts.
+#define PQ_LEVELS         5     // wf.priority 1..5, level 4 pops first
+#define PQ_RING_SIZE      8
+#define PQ_AGE_PROMOTE_MS 5000
+
+// Records now live in the pool and move through the rings as pointers;
+// capacity covers a full queue plus one being built and one in flight.
+OBJECT_POOL_DEFINE(workflow_item_t, wf_pool, PQ_LEVELS * PQ_RING_SIZE + 2,
+                   wf_record_on_acquire, wf_record_on_release)
+
+typedef struct {
+    workflow_item_t *items[PQ_RING_SIZE];
+    uint32_t enqueue_ms[PQ_RING_SIZE];
+    uint32_t head;              // pop index
+    uint32_t tail;              // push index
+} pq_ring_t;
+
+static pq_ring_t pq_rings[PQ_LEVELS];
+static uint32_t pq_nonempty_mask = 0;
+static portMUX_TYPE pq_lock = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t pq_items_sem;   // counting: total queued items
+static uint32_t pq_promotions = 0;
+static uint32_t pq_rejected = 0;
+
+static inline uint32_t pq_depth(int level) {
+    return pq_rings[level].tail - pq_rings[level].head;
+}
+
+bool pq_push(workflow_item_t *wf) {
+    int level = (int)wf->priority - 1;
+    if (level < 0) level = 0;
+    if (level >= PQ_LEVELS) level = PQ_LEVELS - 1;
+
+    bool ok = false;
+    portENTER_CRITICAL(&pq_lock);
+    pq_ring_t *ring = &pq_rings[level];
+    if (ring->tail - ring->head < PQ_RING_SIZE) {
+        ring->items[ring->tail % PQ_RING_SIZE] = wf;
+        ring->enqueue_ms[ring->tail % PQ_RING_SIZE] =
+            xTaskGetTickCount() * portTICK_PERIOD_MS;
+        ring->tail++;
+        pq_nonempty_mask |= (1u << level);
+        ok = true;
+    } else {
+        pq_rejected++;
+    }
+    portEXIT_CRITICAL(&pq_lock);
+
+    if (ok) xSemaphoreGive(pq_items_sem);
+    return ok;
+}
+
+// Move the head of `level` one level up; caller holds pq_lock.
+static void pq_promote_head(int level) {
+    pq_ring_t *src = &pq_rings[level];
+    pq_ring_t *dst = &pq_rings[level + 1];
+    if (dst->tail - dst->head >= PQ_RING_SIZE) return;   // no room above
+
+    dst->items[dst->tail % PQ_RING_SIZE] = src->items[src->head % PQ_RING_SIZE];
+    dst->enqueue_ms[dst->tail % PQ_RING_SIZE] = src->enqueue_ms[src->head % PQ_RING_SIZE];
+    dst->tail++;
+    src->head++;
+    pq_nonempty_mask |= (1u << (level + 1));
+    if (src->head == src->tail) pq_nonempty_mask &= ~(1u << level);
+    pq_promotions++;
+}
+
+bool pq_pop(workflow_item_t **wf, TickType_t timeout) {
+    if (xSemaphoreTake(pq_items_sem, timeout) != pdTRUE) return false;
+
+    portENTER_CRITICAL(&pq_lock);
+    // Lazy aging: promote stale ring heads before choosing a level.
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    for (int level = 0; level < PQ_LEVELS - 1; level++) {
+        while (pq_depth(level) > 0 &&
+               now_ms - pq_rings[level].enqueue_ms[pq_rings[level].head % PQ_RING_SIZE]
+                   > PQ_AGE_PROMOTE_MS) {
+            pq_promote_head(level);
+        }
+    }
+
+    int level = 31 - __builtin_clz(pq_nonempty_mask);
+    pq_ring_t *ring = &pq_rings[level];
+    *wf = ring->items[ring->head % PQ_RING_SIZE];   // pointer move, no copy
+    ring->head++;
+    if (ring->head == ring->tail) pq_nonempty_mask &= ~(1u << level);
+    portEXIT_CRITICAL(&pq_lock);
+    return true;
+}
+
 // -------------------- WORKFLOW --------------------
 void approval_task(void *pvParameters) {
     while (1) {
-        xEventGroupWaitBits(workflow_events, WORKFLOW_START_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+        ewt_wait_bits(ewt_approval, workflow_events, WORKFLOW_START_BIT, pdFALSE, pdTRUE);
         uint32_t t = 1000 + (esp_random() % 2000);
         vTaskDelay(pdMS_TO_TICKS(t));
         bool ok = (esp_random() % 100) > 20;
+        uint32_t approval_us = (uint32_t)(esp_timer_get_time() - approval_request_us);
+        lat_hist_record(&lh_approval, approval_us);
+        psk_record(&psk_approval, approval_us);
         if (ok) xEventGroupSetBits(workflow_events, APPROVAL_READY_BIT);
         else xEventGroupClearBits(workflow_events, APPROVAL_READY_BIT);
         vTaskDelay(pdMS_TO_TICKS(5000));
@@ -205,14 +1143,20 @@ void resource_manager_task(void *pvParameters) {
 }
 
 void workflow_manager_task(void *pvParameters) {
-    workflow_item_t wf;
+    workflow_item_t *wf;
     while (1) {
-        if (xQueueReceive(workflow_queue, &wf, portMAX_DELAY) == pdTRUE) {
+        if (pq_pop(&wf, portMAX_DELAY) == true) {
+            ESP_LOGI(TAG, "📋 Dispatching '%s' #%lu (priority %lu)",
+                     wf->description, wf->workflow_id, wf->priority);
+            approval_request_us = esp_timer_get_time();
             xEventGroupSetBits(workflow_events, WORKFLOW_START_BIT);
             gpio_set_level(LED_WORKFLOW_ACTIVE, 1);
-            EventBits_t need = RESOURCES_FREE_BIT | (wf.requires_approval ? APPROVAL_READY_BIT : 0);
-            xEventGroupWaitBits(workflow_events, need, pdFALSE, pdTRUE, pdMS_TO_TICKS(10000));
-            vTaskDelay(pdMS_TO_TICKS(wf.estimated_duration));
+            EventBits_t need = RESOURCES_FREE_BIT | (wf->requires_approval ? APPROVAL_READY_BIT : 0);
+            ewt_wait_bits(ewt_dispatch, workflow_events, need, pdFALSE, pdTRUE);   // budget: 10 s
+            uint32_t roundtrip_us = (uint32_t)(esp_timer_get_time() - approval_request_us);
+            lat_hist_record(&lh_roundtrip, roundtrip_us);
+            psk_record(&psk_roundtrip, roundtrip_us);
+            vTaskDelay(pdMS_TO_TICKS(wf->estimated_duration));
             uint32_t q = 60 + (esp_random() % 40);
             if (q > 80) {
                 xEventGroupSetBits(workflow_events, WORKFLOW_DONE_BIT);
@@ -220,6 +1164,7 @@ void workflow_manager_task(void *pvParameters) {
             }
             gpio_set_level(LED_WORKFLOW_ACTIVE, 0);
             xEventGroupClearBits(workflow_events, WORKFLOW_START_BIT | WORKFLOW_DONE_BIT);
+            wf_pool_release(wf);   // record is dead once dispatch finishes
         }
     }
 }
@@ -228,23 +1173,99 @@ void workflow_generator_task(void *pvParameters) {
     uint32_t id = 0;
     const char* types[] = {"Data Processing","Report","Backup","Analysis","Test","Scan"};
     while (1) {
-        workflow_item_t wf = {0};
-        wf.workflow_id = ++id;
-        wf.priority = 1 + (esp_random() % 5);
-        wf.estimated_duration = 2000 + (esp_random() % 4000);
-        wf.requires_approval = (esp_random() % 100) > 60;
-        strcpy(wf.description, types[esp_random() % 6]);
-        xQueueSend(workflow_queue, &wf, pdMS_TO_TICKS(500));
+        workflow_item_t *wf = wf_pool_acquire();
+        if (wf == NULL) {
+            // Pool dry means the queue is full plus everything in flight.
+            ESP_LOGW(TAG, "⚠️ Workflow pool exhausted, skipping this cycle");
+        } else {
+            wf->workflow_id = ++id;
+            wf->priority = 1 + (esp_random() % 5);
+            wf->estimated_duration = 2000 + (esp_random() % 4000);
+            wf->requires_approval = (esp_random() % 100) > 60;
+            if (wf->priority == 5) strcpy(wf->description, "Alert");
+            else strcpy(wf->description, types[esp_random() % 6]);
+            if (!pq_push(wf)) {
+                ESP_LOGW(TAG, "⚠️ Priority queue full, workflow %lu rejected", wf->workflow_id);
+                wf_pool_release(wf);
+            }
+        }
         vTaskDelay(pdMS_TO_TICKS(4000 + (esp_random() % 4000)));
     }
 }
 
 // -------------------- MONITOR --------------------
+// Statistics leave the device as binary telemetry frames (schema 1):
+// delta-coded varints instead of a formatted table, roughly an eighth
+// of the bytes and zero printf on the hot path. The full human table
+// is printed only every 4th cycle for anyone watching the console; the
+// collector parses TLMB lines. Each frame is also run through the
+// reference decoder as a round-trip self-check.
+#define TLM_SCHEMA_EVENT_SYNC 1
+
 void statistics_monitor_task(void *pvParameters) {
+    static tlc_stream_t tlm_stream;
+    static tlc_decoder_t tlm_check;
+    tlc_stream_init(&tlm_stream, TLM_SCHEMA_EVENT_SYNC, 8);
+    tlc_decoder_init(&tlm_check);
+    int cycle = 0;
+
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(15000));
-        ESP_LOGI(TAG, "📊 Barrier: %lu | Pipeline: %lu | Workflow: %lu", 
-                 stats.barrier_cycles, stats.pipeline_completions, stats.workflow_completions);
+
+        portENTER_CRITICAL(&pq_lock);
+        uint32_t depths[PQ_LEVELS];
+        for (int i = 0; i < PQ_LEVELS; i++) depths[i] = pq_depth(i);
+        portEXIT_CRITICAL(&pq_lock);
+
+        uint32_t fields[8] = {
+            stats.barrier_cycles, stats.pipeline_completions,
+            stats.workflow_completions, ws_completions,
+            ws_deques[0].executed + ws_deques[1].executed,
+            ws_deques[0].steals + ws_deques[1].steals,
+            pq_promotions, pq_rejected,
+        };
+        uint8_t frame[3 + 5 * 8];
+        size_t frame_len = tlc_encode(&tlm_stream, fields, frame, sizeof(frame));
+
+        char hex[2 * sizeof(frame) + 1];
+        for (size_t i = 0; i < frame_len; i++)
+            sprintf(&hex[2 * i], "%02x", frame[i]);
+        ESP_LOGI(TAG, "TLMB,%s", hex);
+
+        uint32_t decoded[TLC_FIELDS_MAX];
+        uint8_t dcount;
+        uint32_t dseq;
+        if (tlc_decode(&tlm_check, frame, frame_len, decoded, &dcount, &dseq) == 0 ||
+            memcmp(decoded, fields, sizeof(fields)) != 0) {
+            ESP_LOGE(TAG, "Telemetry round-trip check FAILED");
+        }
+
+        if (++cycle % 4 != 0) continue;
+
+        ESP_LOGI(TAG, "📊 Barrier: %lu | Pipeline: %lu | Workflow: %lu (frame %u B)",
+                 stats.barrier_cycles, stats.pipeline_completions,
+                 stats.workflow_completions, (unsigned)frame_len);
+        ESP_LOGI(TAG, "🔩 Executor: %lu done | W0 exec=%lu steals=%lu(%lu) mig=%lu | W1 exec=%lu steals=%lu(%lu) mig=%lu",
+                 ws_completions,
+                 ws_deques[0].executed, ws_deques[0].steals,
+                 ws_deques[0].stolen_items, ws_deques[0].migrations,
+                 ws_deques[1].executed, ws_deques[1].steals,
+                 ws_deques[1].stolen_items, ws_deques[1].migrations);
+        ESP_LOGI(TAG, "📬 Workflow depths p1..p5: %lu/%lu/%lu/%lu/%lu | promoted=%lu rejected=%lu",
+                 depths[0], depths[1], depths[2], depths[3], depths[4],
+                 pq_promotions, pq_rejected);
+        ESP_LOGI(TAG, "🛣️ Lanes u/n/b: depth %d/%d/%d hiwater %lu/%lu/%lu sent %lu/%lu/%lu rejected %lu/%lu/%lu",
+                 pipeline_mlq.count[0], pipeline_mlq.count[1], pipeline_mlq.count[2],
+                 pipeline_mlq.hiwater[0], pipeline_mlq.hiwater[1], pipeline_mlq.hiwater[2],
+                 pipeline_mlq.sent[0], pipeline_mlq.sent[1], pipeline_mlq.sent[2],
+                 pipeline_mlq.rejected[0], pipeline_mlq.rejected[1], pipeline_mlq.rejected[2]);
+        lat_hist_report(&lh_approval);
+        lat_hist_report(&lh_roundtrip);
+        psk_report(&psk_barrier);
+        psk_report(&psk_approval);
+        psk_report(&psk_roundtrip);
+        ewt_report();
+        wf_pool_report();
     }
 }
 
@@ -262,14 +1283,23 @@ void app_main(void) {
     pipeline_events = xEventGroupCreate();
     workflow_events = xEventGroupCreate();
 
-    pipeline_queue = xQueueCreate(5, sizeof(pipeline_data_t));
-    workflow_queue = xQueueCreate(8, sizeof(workflow_item_t));
+    mlq_init(&pipeline_mlq);
+    pq_items_sem = xSemaphoreCreateCounting(PQ_LEVELS * PQ_RING_SIZE, 0);
+    wf_pool_init();
+
+    // Instrumented wait sites, registered with their timeout budgets.
+    ewt_stage = ewt_register("stage", portMAX_DELAY);
+    ewt_approval = ewt_register("approval", portMAX_DELAY);
+    ewt_dispatch = ewt_register("dispatch", pdMS_TO_TICKS(10000));
 
+    counting_barrier_init(&worker_barrier, 4);
     for (int i = 0; i < 4; i++) {
         char name[16];
         sprintf(name, "Worker%d", i);
         xTaskCreate(barrier_worker_task, name, 2048, (void*)i, 5, NULL);
     }
+    xTaskCreate(barrier_benchmark_task, "BarrierBench", 3072, NULL, 3, NULL);
+    start_work_stealing_executor();
 
     for (int i = 0; i < 4; i++) {
         char name[16];
@@ -283,6 +1313,7 @@ void app_main(void) {
     xTaskCreate(resource_manager_task, "ResourceMgr", 2048, NULL, 6, NULL);
     xTaskCreate(workflow_generator_task, "WorkflowGen", 2048, NULL, 4, NULL);
     xTaskCreate(statistics_monitor_task, "Stats", 2048, NULL, 3, NULL);
+    xTaskCreate(mpmc_benchmark_task, "MpmcBench", 3072, NULL, 3, NULL);
 
     ESP_LOGI(TAG, "System operational ✅");
 }
\ No newline at end of file
@@ -1,14 +1,18 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "freertos/event_groups.h"
 #include "freertos/semphr.h"
+#include "freertos/timers.h"
 #include "esp_log.h"
 #include "esp_random.h"
 #include "esp_timer.h"
 #include "driver/gpio.h"
+#include "driver/ledc.h"
 
 static const char *TAG = "COMPLEX_EVENTS";
 
@@ -26,9 +30,23 @@ typedef enum {
     STATE_AWAY,
     STATE_SLEEP,
     STATE_ARMED,
-    STATE_EMERGENCY
+    STATE_EMERGENCY,
+    STATE_COUNT
 } home_state_t;
 
+// Events as dense indices (one per sensor_events/system_events bit) so
+// the transition table can be indexed directly.
+typedef enum {
+    EV_MOTION = 0,
+    EV_DOOR_OPENED,
+    EV_DOOR_CLOSED,
+    EV_LIGHT_ON,
+    EV_LIGHT_OFF,
+    EV_SECURITY_ARMED,
+    EV_EMERGENCY,
+    EVENT_COUNT
+} home_event_t;
+
 // Event Groups
 EventGroupHandle_t sensor_events;
 EventGroupHandle_t system_events;
@@ -51,6 +69,45 @@ EventGroupHandle_t pattern_events;
 static home_state_t current_state = STATE_IDLE;
 static SemaphoreHandle_t state_mutex;
 
+// --- Seqlock-published status snapshot ---
+// The monitor only ever *reads* state the control path updates rarely,
+// yet the obvious implementation serializes it against change_state on
+// state_mutex. A seqlock removes the reader from the writer's path: the
+// writer bumps the sequence to odd, updates the struct, bumps back to
+// even; a reader copies the struct between two sequence loads and
+// retries if they differ or land on odd. Reads cost two atomic loads
+// plus a memcpy and never block the writer — the mutex stays, but only
+// to serialize writers against each other.
+typedef struct {
+    home_state_t state;
+    uint32_t state_changes;
+    uint32_t last_change_ms;
+} home_status_t;
+
+static home_status_t status_data;
+static atomic_uint_fast32_t status_seq = 0;
+static uint32_t status_read_retries = 0;   // monitor-side, single reader
+
+// Writer side; caller holds state_mutex.
+static void status_publish(home_state_t s) {
+    atomic_fetch_add_explicit(&status_seq, 1, memory_order_release);  // odd: in flux
+    status_data.state = s;
+    status_data.state_changes++;
+    status_data.last_change_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    atomic_fetch_add_explicit(&status_seq, 1, memory_order_release);  // even: stable
+}
+
+static void status_read(home_status_t *out) {
+    while (1) {
+        uint_fast32_t v1 = atomic_load_explicit(&status_seq, memory_order_acquire);
+        if (v1 & 1) { status_read_retries++; continue; }   // writer mid-update
+        *out = status_data;
+        uint_fast32_t v2 = atomic_load_explicit(&status_seq, memory_order_acquire);
+        if (v1 == v2) return;
+        status_read_retries++;
+    }
+}
+
 // --- State name ---
 const char *get_state_name(home_state_t s) {
     switch (s) {
@@ -68,37 +125,224 @@ void change_state(home_state_t s) {
     if (xSemaphoreTake(state_mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
         ESP_LOGI(TAG, "🏠 State: %s → %s", get_state_name(current_state), get_state_name(s));
         current_state = s;
+        status_publish(s);
         xSemaphoreGive(state_mutex);
     }
 }
 
+// --- Gamma-corrected dimming ---
+// The living-room LED is driven by LEDC PWM instead of a bare GPIO so
+// it can dim. Perceived brightness is nonlinear in duty, so levels map
+// through a gamma table — and the whole 256-entry table is built by the
+// preprocessor from a quadratic approximation (duty = i²/255, γ≈2.0;
+// close enough to the 2.2 ideal for indicator LEDs and exact in integer
+// constant arithmetic). It lives in flash as a const array: zero
+// runtime math, recomputed only when this file recompiles.
+#define GAMMA8(i)  ((uint8_t)(((uint32_t)(i) * (uint32_t)(i) + 127) / 255))
+#define G_ROW4(i)  GAMMA8(i), GAMMA8((i)+1), GAMMA8((i)+2), GAMMA8((i)+3)
+#define G_ROW16(i) G_ROW4(i), G_ROW4((i)+4), G_ROW4((i)+8), G_ROW4((i)+12)
+#define G_ROW64(i) G_ROW16(i), G_ROW16((i)+16), G_ROW16((i)+32), G_ROW16((i)+48)
+
+static const uint8_t gamma_lut[256] = {
+    G_ROW64(0), G_ROW64(64), G_ROW64(128), G_ROW64(192)
+};
+
+#define LIGHT_LEDC_CHANNEL  LEDC_CHANNEL_0
+#define LIGHT_LEDC_TIMER    LEDC_TIMER_0
+#define LIGHT_FADE_MS       500
+
+static uint32_t light_fades_started = 0;
+
+// Fade engine: gamma lookup plus the LEDC hardware fade. The fade runs
+// entirely in the peripheral — no per-step CPU work, no task involved.
+void light_fade_to(uint8_t level, uint32_t fade_ms) {
+    ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, LIGHT_LEDC_CHANNEL,
+                            gamma_lut[level], fade_ms);
+    ledc_fade_start(LEDC_LOW_SPEED_MODE, LIGHT_LEDC_CHANNEL, LEDC_FADE_NO_WAIT);
+    light_fades_started++;
+}
+
+void light_fade_init(void) {
+    ledc_timer_config_t timer_cfg = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .timer_num = LIGHT_LEDC_TIMER,
+        .duty_resolution = LEDC_TIMER_8_BIT,
+        .freq_hz = 5000,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ledc_timer_config(&timer_cfg);
+
+    ledc_channel_config_t ch_cfg = {
+        .speed_mode = LEDC_LOW_SPEED_MODE,
+        .channel = LIGHT_LEDC_CHANNEL,
+        .timer_sel = LIGHT_LEDC_TIMER,
+        .intr_type = LEDC_INTR_DISABLE,
+        .gpio_num = LED_LIVING_ROOM,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ledc_channel_config(&ch_cfg);
+    ledc_fade_func_install(0);
+    ESP_LOGI(TAG, "💡 LEDC fade engine ready (gamma LUT in flash, %u B)",
+             (unsigned)sizeof(gamma_lut));
+}
+
 // --- Pattern actions ---
+// Actions only do the side effects; the dispatcher owns the state
+// change, so one table entry fully describes a transition.
 void normal_entry_action(void) {
     ESP_LOGI(TAG, "🏡 Normal Entry Detected - Lights ON");
-    gpio_set_level(LED_LIVING_ROOM, 1);
-    change_state(STATE_OCCUPIED);
+    light_fade_to(255, LIGHT_FADE_MS);
 }
 
 void breakin_action(void) {
     ESP_LOGW(TAG, "🚨 Break-in Detected - Alarm ON");
     gpio_set_level(LED_SECURITY, 1);
     gpio_set_level(LED_EMERGENCY, 1);
-    change_state(STATE_EMERGENCY);
 }
 
 void goodnight_action(void) {
     ESP_LOGI(TAG, "🌙 Goodnight Pattern - Sleep Mode");
-    gpio_set_level(LED_LIVING_ROOM, 0);
+    light_fade_to(0, LIGHT_FADE_MS * 2);
     gpio_set_level(LED_KITCHEN, 0);
     gpio_set_level(LED_BEDROOM, 1);
-    change_state(STATE_SLEEP);
 }
 
 void wakeup_action(void) {
     ESP_LOGI(TAG, "☀️ Wake-up Pattern - Good Morning!");
     gpio_set_level(LED_BEDROOM, 1);
     gpio_set_level(LED_KITCHEN, 1);
-    change_state(STATE_OCCUPIED);
+}
+
+// --- Transition table ---
+// state × event → {next state, action}, indexed in O(1). Entries left
+// zero mean "no transition": next_state stores state+1 so that the
+// all-zeroes default stays inert instead of aliasing STATE_IDLE.
+typedef void (*state_action_t)(void);
+
+typedef struct {
+    uint8_t next_state_plus1;   // 0 = ignore event in this state
+    state_action_t action;      // optional side effect, run before the state change
+} fsm_entry_t;
+
+#define FSM(next, act) { (next) + 1, (act) }
+
+static const fsm_entry_t transition_table[STATE_COUNT][EVENT_COUNT] = {
+    [STATE_IDLE] = {
+        [EV_MOTION]         = FSM(STATE_OCCUPIED, normal_entry_action),
+        [EV_LIGHT_OFF]      = FSM(STATE_SLEEP, goodnight_action),
+        [EV_SECURITY_ARMED] = FSM(STATE_ARMED, NULL),
+        [EV_EMERGENCY]      = FSM(STATE_EMERGENCY, NULL),
+    },
+    [STATE_OCCUPIED] = {
+        [EV_LIGHT_OFF]      = FSM(STATE_SLEEP, goodnight_action),
+        [EV_DOOR_CLOSED]    = FSM(STATE_AWAY, NULL),
+        [EV_SECURITY_ARMED] = FSM(STATE_ARMED, NULL),
+        [EV_EMERGENCY]      = FSM(STATE_EMERGENCY, NULL),
+    },
+    [STATE_AWAY] = {
+        [EV_DOOR_OPENED]    = FSM(STATE_OCCUPIED, normal_entry_action),
+        [EV_SECURITY_ARMED] = FSM(STATE_ARMED, NULL),
+        [EV_EMERGENCY]      = FSM(STATE_EMERGENCY, NULL),
+    },
+    [STATE_SLEEP] = {
+        [EV_LIGHT_ON]       = FSM(STATE_OCCUPIED, wakeup_action),
+        [EV_EMERGENCY]      = FSM(STATE_EMERGENCY, NULL),
+    },
+    [STATE_ARMED] = {
+        [EV_DOOR_OPENED]    = FSM(STATE_EMERGENCY, breakin_action),
+        [EV_MOTION]         = FSM(STATE_EMERGENCY, breakin_action),
+        [EV_EMERGENCY]      = FSM(STATE_EMERGENCY, NULL),
+    },
+    [STATE_EMERGENCY] = {
+        // cleared by the emergency timeout in state_machine_task
+    },
+};
+
+static uint32_t fsm_dispatches = 0;
+static uint32_t fsm_transitions = 0;
+
+void dispatch_event(home_event_t ev) {
+    fsm_dispatches++;
+    const fsm_entry_t *e = &transition_table[current_state][ev];
+    if (e->next_state_plus1 == 0)
+        return;
+    if (e->action)
+        e->action();
+    change_state((home_state_t)(e->next_state_plus1 - 1));
+    fsm_transitions++;
+}
+
+// --- Sensor fusion front-end ---
+// Sensors used to set event bits directly, so the pattern task woke for
+// every raw transition — a PIR retrigger or a chattering reed switch
+// each cost a full wakeup. Transitions now go through fusion_report():
+// per-sensor debounce windows swallow repeats, and everything that
+// lands within one settle window is merged into a single combined
+// xEventGroupSetBits, so simultaneous transitions cost one wakeup.
+#define FUSION_SETTLE_MS 150
+
+// Per-event debounce: PIR sensors retrigger for seconds on one pass,
+// door/light contacts just bounce briefly.
+static const uint32_t fusion_debounce_ms[EVENT_COUNT] = {
+    [EV_MOTION]      = 2000,
+    [EV_DOOR_OPENED] = 300,
+    [EV_DOOR_CLOSED] = 300,
+    [EV_LIGHT_ON]    = 300,
+    [EV_LIGHT_OFF]   = 300,
+};
+
+static portMUX_TYPE fusion_lock = portMUX_INITIALIZER_UNLOCKED;
+static EventBits_t fusion_pending = 0;
+static uint32_t fusion_last_report_ms[EVENT_COUNT];
+static uint32_t fusion_last_activity_ms = 0;
+static uint32_t fusion_raw = 0, fusion_suppressed = 0, fusion_batches = 0;
+static TaskHandle_t fusion_task_handle = NULL;
+
+void fusion_report(home_event_t ev) {
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    bool open_batch = false;
+
+    portENTER_CRITICAL(&fusion_lock);
+    fusion_raw++;
+    if (fusion_last_report_ms[ev] != 0 &&
+        now_ms - fusion_last_report_ms[ev] < fusion_debounce_ms[ev]) {
+        fusion_suppressed++;
+        portEXIT_CRITICAL(&fusion_lock);
+        return;
+    }
+    fusion_last_report_ms[ev] = now_ms;
+    open_batch = (fusion_pending == 0);
+    fusion_pending |= (1 << ev);        // event indices match sensor bits
+    fusion_last_activity_ms = now_ms;
+    portEXIT_CRITICAL(&fusion_lock);
+
+    if (open_batch && fusion_task_handle)
+        xTaskNotifyGive(fusion_task_handle);
+}
+
+// Waits for a batch to open, lets it settle, then publishes all pending
+// transitions as one combined event-group write.
+void sensor_fusion_task(void *pv) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (1) {
+            vTaskDelay(pdMS_TO_TICKS(FUSION_SETTLE_MS));
+            uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+            EventBits_t batch = 0;
+            portENTER_CRITICAL(&fusion_lock);
+            if (now_ms - fusion_last_activity_ms >= FUSION_SETTLE_MS) {
+                batch = fusion_pending;
+                fusion_pending = 0;
+            }
+            portEXIT_CRITICAL(&fusion_lock);
+            if (batch) {
+                fusion_batches++;
+                xEventGroupSetBits(sensor_events, batch);
+                break;
+            }
+        }
+    }
 }
 
 // --- Sensor Simulation ---
@@ -106,7 +350,7 @@ void motion_sensor_task(void *pv) {
     while (1) {
         if ((esp_random() % 100) < 20) {
             ESP_LOGI(TAG, "👀 Motion detected");
-            xEventGroupSetBits(sensor_events, MOTION_DETECTED_BIT);
+            fusion_report(EV_MOTION);
         }
         vTaskDelay(pdMS_TO_TICKS(3000 + (esp_random() % 4000)));
     }
@@ -116,10 +360,10 @@ void door_sensor_task(void *pv) {
     while (1) {
         if ((esp_random() % 100) < 10) {
             ESP_LOGI(TAG, "🚪 Door opened");
-            xEventGroupSetBits(sensor_events, DOOR_OPENED_BIT);
+            fusion_report(EV_DOOR_OPENED);
             vTaskDelay(pdMS_TO_TICKS(2000));
             ESP_LOGI(TAG, "🔒 Door closed");
-            xEventGroupSetBits(sensor_events, DOOR_CLOSED_BIT);
+            fusion_report(EV_DOOR_CLOSED);
         }
         vTaskDelay(pdMS_TO_TICKS(5000 + (esp_random() % 5000)));
     }
@@ -130,107 +374,417 @@ void light_control_task(void *pv) {
         if ((esp_random() % 100) < 15) {
             bool on = (esp_random() % 2);
             if (on) {
-                ESP_LOGI(TAG, "💡 Light ON");
-                xEventGroupSetBits(sensor_events, LIGHT_ON_BIT);
-                gpio_set_level(LED_LIVING_ROOM, 1);
+                uint8_t level = 128 + (esp_random() % 128);
+                ESP_LOGI(TAG, "💡 Light ON (level %u, duty %u)",
+                         level, gamma_lut[level]);
+                fusion_report(EV_LIGHT_ON);
+                light_fade_to(level, LIGHT_FADE_MS);
             } else {
                 ESP_LOGI(TAG, "💡 Light OFF");
-                xEventGroupSetBits(sensor_events, LIGHT_OFF_BIT);
-                gpio_set_level(LED_LIVING_ROOM, 0);
+                fusion_report(EV_LIGHT_OFF);
+                light_fade_to(0, LIGHT_FADE_MS);
             }
         }
         vTaskDelay(pdMS_TO_TICKS(4000 + (esp_random() % 4000)));
     }
 }
 
-// --- Pattern recognition ---
-void pattern_recognition_task(void *pv) {
-    while (1) {
-        EventBits_t bits = xEventGroupWaitBits(sensor_events, 0xFFFF, pdTRUE, pdFALSE, portMAX_DELAY);
+// --- Incremental pattern matcher ---
+// Rescanning the event history on every arrival is O(window) per event.
+// Each pattern instead keeps a bit-parallel NFA state (Shift-And with
+// gaps): bit i set means "the first i+1 pattern events have been seen
+// in order". One new event updates every pattern in a few ALU ops, so
+// cost per event is O(active patterns) regardless of window size.
+#define PATTERN_MAX_LEN 8
+
+typedef struct {
+    const char *name;
+    uint8_t seq[PATTERN_MAX_LEN];   // event sequence to match (gaps allowed)
+    uint8_t len;
+    home_state_t required_state;    // STATE_COUNT = match in any state
+    uint32_t window_ms;             // partial match expires after this
+    EventBits_t pattern_bit;
+    state_action_t action;
+    home_state_t next_state;
+    // runtime
+    uint32_t event_masks[EVENT_COUNT];  // bit i set: seq[i] == event
+    uint32_t nfa_state;
+    uint32_t window_start_ms;
+    uint32_t matches;
+} event_pattern_t;
+
+static event_pattern_t patterns[] = {
+    { .name = "Normal Entry", .seq = {EV_DOOR_OPENED, EV_MOTION, EV_DOOR_CLOSED}, .len = 3,
+      .required_state = STATE_COUNT, .window_ms = 15000, .pattern_bit = PATTERN_ENTRY_BIT,
+      .action = normal_entry_action, .next_state = STATE_OCCUPIED },
+    { .name = "Break-in", .seq = {EV_DOOR_OPENED, EV_MOTION}, .len = 2,
+      .required_state = STATE_ARMED, .window_ms = 10000, .pattern_bit = PATTERN_BREAKIN_BIT,
+      .action = breakin_action, .next_state = STATE_EMERGENCY },
+    { .name = "Goodnight", .seq = {EV_LIGHT_OFF, EV_MOTION}, .len = 2,
+      .required_state = STATE_COUNT, .window_ms = 10000, .pattern_bit = PATTERN_SLEEP_BIT,
+      .action = goodnight_action, .next_state = STATE_SLEEP },
+    { .name = "Wake-up", .seq = {EV_LIGHT_ON, EV_MOTION}, .len = 2,
+      .required_state = STATE_SLEEP, .window_ms = 10000, .pattern_bit = PATTERN_WAKEUP_BIT,
+      .action = wakeup_action, .next_state = STATE_OCCUPIED },
+};
+#define PATTERN_COUNT (sizeof(patterns) / sizeof(patterns[0]))
+
+void pattern_matcher_init(void) {
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        memset(patterns[p].event_masks, 0, sizeof(patterns[p].event_masks));
+        for (int i = 0; i < patterns[p].len; i++)
+            patterns[p].event_masks[patterns[p].seq[i]] |= (1u << i);
+        patterns[p].nfa_state = 0;
+    }
+}
 
-        // Normal Entry
-        if ((bits & DOOR_OPENED_BIT) && (bits & MOTION_DETECTED_BIT) && (bits & DOOR_CLOSED_BIT)) {
-            normal_entry_action();
-            xEventGroupSetBits(pattern_events, PATTERN_ENTRY_BIT);
-        }
+// Feed one event through every pattern's NFA. O(patterns) per event.
+void pattern_matcher_feed(home_event_t ev) {
+    uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
 
-        // Break-in (armed)
-        if ((current_state == STATE_ARMED) && (bits & DOOR_OPENED_BIT) && (bits & MOTION_DETECTED_BIT)) {
-            breakin_action();
-            xEventGroupSetBits(pattern_events, PATTERN_BREAKIN_BIT);
-        }
+    for (int p = 0; p < PATTERN_COUNT; p++) {
+        event_pattern_t *pat = &patterns[p];
 
-        // Goodnight
-        if ((bits & LIGHT_OFF_BIT) && (bits & MOTION_DETECTED_BIT)) {
-            goodnight_action();
-            xEventGroupSetBits(pattern_events, PATTERN_SLEEP_BIT);
+        if (pat->required_state != STATE_COUNT && current_state != pat->required_state) {
+            pat->nfa_state = 0;
+            continue;
         }
+        if (pat->nfa_state != 0 && now_ms - pat->window_start_ms > pat->window_ms)
+            pat->nfa_state = 0;
+
+        uint32_t advanced = ((pat->nfa_state << 1) | 1) & pat->event_masks[ev];
+        if (pat->nfa_state == 0 && advanced)
+            pat->window_start_ms = now_ms;
+        pat->nfa_state |= advanced;   // gaps allowed: old partials persist
+
+        if (pat->nfa_state & (1u << (pat->len - 1))) {
+            pat->matches++;
+            pat->nfa_state = 0;
+            ESP_LOGI(TAG, "🧩 Pattern matched: %s", pat->name);
+            if (pat->action) pat->action();
+            change_state(pat->next_state);
+            xEventGroupSetBits(pattern_events, pat->pattern_bit);
+        }
+    }
+}
 
-        // Wake-up
-        if ((current_state == STATE_SLEEP) && (bits & LIGHT_ON_BIT) && (bits & MOTION_DETECTED_BIT)) {
-            wakeup_action();
-            xEventGroupSetBits(pattern_events, PATTERN_WAKEUP_BIT);
+// --- Matcher microbenchmark: incremental NFA vs naive window rescan ---
+#define MATCH_BENCH_EVENTS 50000
+
+// Naive baseline: keep the last W events and re-scan for one 3-event
+// subsequence on every arrival, the way the old code effectively worked.
+static uint32_t bench_naive(int window_size) {
+    static uint8_t window_buf[256];
+    int filled = 0;
+    uint8_t target[3] = {EV_DOOR_OPENED, EV_MOTION, EV_DOOR_CLOSED};
+    volatile uint32_t hits = 0;
+
+    uint64_t start = esp_timer_get_time();
+    for (int n = 0; n < MATCH_BENCH_EVENTS; n++) {
+        if (filled == window_size) {
+            memmove(window_buf, window_buf + 1, window_size - 1);
+            filled--;
         }
+        window_buf[filled++] = esp_random() % EVENT_COUNT;
+        int need = 0;
+        for (int i = 0; i < filled && need < 3; i++)
+            if (window_buf[i] == target[need]) need++;
+        if (need == 3) hits++;
+    }
+    uint64_t us = esp_timer_get_time() - start;
+    return us ? (uint32_t)((uint64_t)MATCH_BENCH_EVENTS * 1000000 / us) : 0;
+}
+
+static uint32_t bench_incremental(void) {
+    uint32_t masks[EVENT_COUNT] = {0};
+    uint8_t target[3] = {EV_DOOR_OPENED, EV_MOTION, EV_DOOR_CLOSED};
+    for (int i = 0; i < 3; i++) masks[target[i]] |= (1u << i);
+    uint32_t state = 0;
+    volatile uint32_t hits = 0;
+
+    uint64_t start = esp_timer_get_time();
+    for (int n = 0; n < MATCH_BENCH_EVENTS; n++) {
+        uint8_t ev = esp_random() % EVENT_COUNT;
+        state |= ((state << 1) | 1) & masks[ev];
+        if (state & (1u << 2)) { hits++; state = 0; }
+    }
+    uint64_t us = esp_timer_get_time() - start;
+    return us ? (uint32_t)((uint64_t)MATCH_BENCH_EVENTS * 1000000 / us) : 0;
+}
+
+void matcher_benchmark_task(void *pv) {
+    const int windows[] = {16, 64, 256};
+
+    vTaskDelay(pdMS_TO_TICKS(5000));
+    ESP_LOGI(TAG, "=== Pattern matcher benchmark (%d events) ===", MATCH_BENCH_EVENTS);
+    uint32_t inc_rate = bench_incremental();
+    ESP_LOGI(TAG, "Incremental NFA:   %lu events/sec (window-independent)", inc_rate);
+    for (int i = 0; i < 3; i++) {
+        uint32_t naive_rate = bench_naive(windows[i]);
+        ESP_LOGI(TAG, "Naive rescan W=%-3d: %lu events/sec", windows[i], naive_rate);
+        vTaskDelay(pdMS_TO_TICKS(100));   // let lower-priority tasks breathe
+    }
+    ESP_LOGI(TAG, "=== Matcher benchmark done ===");
+    vTaskDelete(NULL);
+}
+
+// --- Pattern recognition ---
+// Translates sensor bits into events and feeds the incremental matcher.
+void fsm_post_event(home_event_t ev);   // intake, defined below
+void pattern_recognition_task(void *pv) {
+    while (1) {
+        EventBits_t bits = xEventGroupWaitBits(sensor_events, 0xFFFF, pdTRUE, pdFALSE, portMAX_DELAY);
+
+        // Order matters for sequences like door-open → motion → door-close,
+        // so feed bits in their arrival-plausible order. The same events
+        // go to the FSM intake, where latest-wins types collapse.
+        if (bits & DOOR_OPENED_BIT)    { pattern_matcher_feed(EV_DOOR_OPENED); fsm_post_event(EV_DOOR_OPENED); }
+        if (bits & MOTION_DETECTED_BIT) { pattern_matcher_feed(EV_MOTION);     fsm_post_event(EV_MOTION); }
+        if (bits & DOOR_CLOSED_BIT)    { pattern_matcher_feed(EV_DOOR_CLOSED); fsm_post_event(EV_DOOR_CLOSED); }
+        if (bits & LIGHT_ON_BIT)       { pattern_matcher_feed(EV_LIGHT_ON);    fsm_post_event(EV_LIGHT_ON); }
+        if (bits & LIGHT_OFF_BIT)      { pattern_matcher_feed(EV_LIGHT_OFF);   fsm_post_event(EV_LIGHT_OFF); }
 
         vTaskDelay(pdMS_TO_TICKS(500));
     }
 }
 
+// --- Superseding event intake ---
+// The FSM can be busy for a long stretch (the emergency hold sleeps for
+// 8 s), and a naive input queue would make it replay every event that
+// arrived meanwhile — three motion events where only the last matters.
+// Bursty types are declared latest-wins instead: each has a slot with a
+// generation counter, posting just bumps the generation, and the FSM
+// compares it against the generation it last consumed — however many
+// posts landed in between, it dispatches once. Types whose relative
+// order carries meaning (door open before door close) stay in a small
+// FIFO and are drained first, in arrival order.
+static const bool ev_latest_wins[EVENT_COUNT] = {
+    [EV_MOTION]    = true,
+    [EV_LIGHT_ON]  = true,
+    [EV_LIGHT_OFF] = true,
+};
+
+typedef struct {
+    uint32_t gen;          // bumped by every post
+    uint32_t taken_gen;    // generation the FSM last consumed
+} ev_slot_t;
+
+static ev_slot_t ev_slots[EVENT_COUNT];
+static QueueHandle_t fsm_ordered_q;
+static portMUX_TYPE intake_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t intake_posted, intake_collapsed, intake_fifo_drops;
+
+// Posting never blocks and never wakes anything: the FSM loop already
+// cycles at 1 Hz on its event-group wait, which is plenty for home
+// automation — the win here is that a burst costs one dispatch, not one
+// wakeup per post.
+void fsm_post_event(home_event_t ev) {
+    intake_posted++;
+    if (ev_latest_wins[ev]) {
+        portENTER_CRITICAL(&intake_lock);
+        // A still-pending older post gets superseded, not replayed.
+        if (ev_slots[ev].gen != ev_slots[ev].taken_gen) intake_collapsed++;
+        ev_slots[ev].gen++;
+        portEXIT_CRITICAL(&intake_lock);
+    } else if (xQueueSend(fsm_ordered_q, &ev, 0) != pdTRUE) {
+        intake_fifo_drops++;
+    }
+}
+
+// Ordered FIFO first (relative order is the point of those types), then
+// one dispatch per dirty slot no matter how many posts it absorbed.
+static void fsm_drain_intake(void) {
+    home_event_t ev;
+    while (xQueueReceive(fsm_ordered_q, &ev, 0) == pdTRUE) {
+        dispatch_event(ev);
+    }
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        if (!ev_latest_wins[e]) continue;
+        portENTER_CRITICAL(&intake_lock);
+        uint32_t g = ev_slots[e].gen;
+        bool due = (g != ev_slots[e].taken_gen);
+        ev_slots[e].taken_gen = g;
+        portEXIT_CRITICAL(&intake_lock);
+        if (due) dispatch_event((home_event_t)e);
+    }
+}
+
 // --- State Machine ---
+// All dispatch goes through the transition table: one array index per
+// event instead of re-evaluating a switch/if chain on every wakeup.
 void state_machine_task(void *pv) {
     while (1) {
-        EventBits_t sys = xEventGroupWaitBits(system_events, 0xFFFF, pdTRUE, pdFALSE, pdMS_TO_TICKS(5000));
+        EventBits_t sys = xEventGroupWaitBits(system_events, 0xFFFF, pdTRUE, pdFALSE, pdMS_TO_TICKS(1000));
         if (sys & SECURITY_ARMED_BIT) {
-            change_state(STATE_ARMED);
+            dispatch_event(EV_SECURITY_ARMED);
         }
         if (sys & EMERGENCY_BIT) {
-            change_state(STATE_EMERGENCY);
+            dispatch_event(EV_EMERGENCY);
         }
 
+        fsm_drain_intake();
+
         if (current_state == STATE_EMERGENCY) {
             vTaskDelay(pdMS_TO_TICKS(8000));
             gpio_set_level(LED_SECURITY, 0);
             gpio_set_level(LED_EMERGENCY, 0);
             change_state(STATE_IDLE);
         }
+    }
+}
+
+// --- Time-of-day calendar wheel ---
+// Scheduled actions (goodnight at 22:30, wake-up at 06:30, ...) used to
+// mean polling the clock and the state every second: 86400 wakeups a
+// day to fire a handful of actions. The wheel stores entries in 24
+// hour slots with a per-slot count, so finding the next expiry skips
+// empty hours in one comparison each; exactly one one-shot timer is
+// armed for that expiry and re-armed after it fires. Zero polling —
+// the CPU sleeps until the next scheduled minute.
+//
+// The demo clock is accelerated: one wall second is one simulated
+// minute, so a full day plays out in 24 minutes.
+#define CW_ENTRIES_MAX    16
+#define CW_MIN_PER_DAY    1440
+#define CW_SIM_MS_PER_MIN 1000
+
+typedef struct {
+    const char *name;
+    uint16_t minute_of_day;      // 0..1439, fires daily
+    state_action_t action;
+    uint32_t fires;
+    bool used;
+} cw_entry_t;
+
+static cw_entry_t cw_entries[CW_ENTRIES_MAX];
+static uint8_t cw_hour_count[24];   // wheel level 1: entries per hour
+static TimerHandle_t cw_timer;
+static uint16_t cw_now_min = 8 * 60;   // simulated clock starts at 08:00
+static uint32_t cw_wakeups, cw_actions_run, cw_sim_minutes;
+
+static bool cw_schedule(const char *name, int hour, int minute, state_action_t action) {
+    for (int i = 0; i < CW_ENTRIES_MAX; i++) {
+        if (!cw_entries[i].used) {
+            cw_entries[i] = (cw_entry_t){ .name = name,
+                                          .minute_of_day = hour * 60 + minute,
+                                          .action = action, .used = true };
+            cw_hour_count[hour]++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Minutes until the next scheduled entry, walking hour slots so empty
+// hours cost one comparison instead of sixty.
+static uint16_t cw_minutes_to_next(uint16_t *next_min_out) {
+    uint16_t best_delta = CW_MIN_PER_DAY;
+    uint16_t best_min = cw_now_min;
+    for (int h_off = 0; h_off < 25; h_off++) {
+        int hour = ((cw_now_min / 60) + h_off) % 24;
+        if (cw_hour_count[hour] == 0) continue;
+        for (int i = 0; i < CW_ENTRIES_MAX; i++) {
+            if (!cw_entries[i].used || cw_entries[i].minute_of_day / 60 != hour) continue;
+            uint16_t delta = (cw_entries[i].minute_of_day - cw_now_min + CW_MIN_PER_DAY)
+                             % CW_MIN_PER_DAY;
+            if (delta == 0) delta = CW_MIN_PER_DAY;   // fired this minute: next day
+            if (delta < best_delta) {
+                best_delta = delta;
+                best_min = cw_entries[i].minute_of_day;
+            }
+        }
+        if (best_delta < (h_off + 1) * 60u) break;   // nothing later can beat it
+    }
+    *next_min_out = best_min;
+    return best_delta;
+}
 
-        vTaskDelay(pdMS_TO_TICKS(1000));
+static void cw_arm(void) {
+    uint16_t next_min;
+    uint16_t delta = cw_minutes_to_next(&next_min);
+    xTimerChangePeriod(cw_timer, pdMS_TO_TICKS((uint32_t)delta * CW_SIM_MS_PER_MIN), 0);
+}
+
+static void cw_timer_callback(TimerHandle_t t) {
+    uint16_t next_min;
+    uint16_t delta = cw_minutes_to_next(&next_min);
+    cw_now_min = next_min;
+    cw_sim_minutes += delta;
+    cw_wakeups++;
+
+    for (int i = 0; i < CW_ENTRIES_MAX; i++) {
+        if (cw_entries[i].used && cw_entries[i].minute_of_day == cw_now_min) {
+            ESP_LOGI(TAG, "🕰️ %02u:%02u — scheduled '%s'",
+                     cw_now_min / 60, cw_now_min % 60, cw_entries[i].name);
+            cw_entries[i].action();
+            cw_entries[i].fires++;
+            cw_actions_run++;
+        }
     }
+    cw_arm();
+}
+
+static void cw_init(void) {
+    cw_timer = xTimerCreate("CalWheel", pdMS_TO_TICKS(1000), pdFALSE, NULL,
+                            cw_timer_callback);
+    cw_schedule("wake-up", 6, 30, wakeup_action);
+    cw_schedule("goodnight", 22, 30, goodnight_action);
+    cw_arm();
+}
+
+static void cw_report(void) {
+    ESP_LOGI(TAG, "🗓️ Wheel: %lu wakeups for %lu actions over %lu sim-min (1 Hz poll: %lu wakeups)",
+             cw_wakeups, cw_actions_run, cw_sim_minutes, cw_sim_minutes * 60);
 }
 
 // --- Monitor ---
 void monitor_task(void *pv) {
+    home_status_t snap;
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
-        ESP_LOGI(TAG, "📊 State: %s | Events: 0x%04X | Free Heap: %d bytes",
-                 get_state_name(current_state),
+        status_read(&snap);   // seqlock copy: never touches state_mutex
+        ESP_LOGI(TAG, "📊 State: %s (#%lu @%lums, %lu read retries) | Events: 0x%04X | Free Heap: %d bytes",
+                 get_state_name(snap.state), snap.state_changes,
+                 snap.last_change_ms, status_read_retries,
                  xEventGroupGetBits(sensor_events),
                  esp_get_free_heap_size());
+        ESP_LOGI(TAG, "🗂️ FSM: %lu dispatches, %lu transitions",
+                 fsm_dispatches, fsm_transitions);
+        ESP_LOGI(TAG, "🔗 Fusion: %lu raw → %lu batches (%lu debounced)",
+                 fusion_raw, fusion_batches, fusion_suppressed);
+        ESP_LOGI(TAG, "📥 Intake: %lu posted, %lu superseded, %lu FIFO drops",
+                 intake_posted, intake_collapsed, intake_fifo_drops);
+        cw_report();
     }
 }
 
 void app_main(void) {
     ESP_LOGI(TAG, "🚀 Complex Event Patterns Lab Starting...");
 
-    gpio_set_direction(LED_LIVING_ROOM, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_KITCHEN, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_BEDROOM, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_SECURITY, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_EMERGENCY, GPIO_MODE_OUTPUT);
 
     state_mutex = xSemaphoreCreateMutex();
+    fsm_ordered_q = xQueueCreate(16, sizeof(home_event_t));
     sensor_events = xEventGroupCreate();
     system_events = xEventGroupCreate();
     pattern_events = xEventGroupCreate();
 
+    light_fade_init();
     change_state(STATE_IDLE);
+    pattern_matcher_init();
+    cw_init();
 
+    xTaskCreate(sensor_fusion_task, "Fusion", 2048, NULL, 6, &fusion_task_handle);
     xTaskCreate(motion_sensor_task, "Motion", 2048, NULL, 5, NULL);
     xTaskCreate(door_sensor_task, "Door", 2048, NULL, 5, NULL);
     xTaskCreate(light_control_task, "Light", 2048, NULL, 5, NULL);
     xTaskCreate(pattern_recognition_task, "Pattern", 4096, NULL, 7, NULL);
     xTaskCreate(state_machine_task, "State", 3072, NULL, 6, NULL);
     xTaskCreate(monitor_task, "Monitor", 3072, NULL, 3, NULL);
+    xTaskCreate(matcher_benchmark_task, "MatchBench", 3072, NULL, 2, NULL);
 
     ESP_LOGI(TAG, "All tasks started successfully ✅");
 }
\ No newline at end of file
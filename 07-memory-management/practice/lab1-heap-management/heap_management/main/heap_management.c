@@ -1,16 +1,24 @@
 // main/heap_management.c
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "fastfmt.h"
 #include "esp_timer.h"
 #include "esp_system.h"
+#include "esp_attr.h"
 #include "esp_random.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_freertos_hooks.h"
 #include "driver/gpio.h"
+#include "perf_bench.h"
+#include "pexec.h"
 
 static const char *TAG = "HEAP_MGMT";
 
@@ -28,13 +36,26 @@ static const char *TAG = "HEAP_MGMT";
 #define MAX_ALLOCATIONS            100
 
 // Allocation tracking
+//
+// Records live in an open-addressing hash table keyed by pointer, so
+// insert/lookup/remove are O(1) instead of a linear slot scan. Active
+// records are also threaded on an intrusive doubly-linked list ordered by
+// allocation time (oldest first), so the leak scan only visits records old
+// enough to matter and stops at the first young one.
+#define ALLOC_TABLE_SIZE   256            // power of two, > 2x MAX_ALLOCATIONS
+#define ALLOC_TOMBSTONE    ((void*)-1)    // deleted bucket, keeps probes alive
+#define LRU_NONE           (-1)
+
 typedef struct {
-    void* ptr;
+    void* ptr;                // NULL = empty, ALLOC_TOMBSTONE = deleted
     size_t size;
     uint32_t caps;
-    const char* description;
+    void* site;               // return address of the tracked_malloc call
     uint64_t timestamp;
     bool is_active;
+    int8_t owner;             // task_accts index, TASKACCT_NONE if untracked
+    int16_t lru_prev;         // towards older allocations
+    int16_t lru_next;         // towards newer allocations
 } memory_allocation_t;
 
 typedef struct {
@@ -49,41 +70,513 @@ typedef struct {
     uint32_t low_memory_events;
 } memory_stats_t;
 
-static memory_allocation_t allocations[MAX_ALLOCATIONS];
+static memory_allocation_t allocations[ALLOC_TABLE_SIZE];
 static memory_stats_t stats = {0};
 static SemaphoreHandle_t memory_mutex;
 static bool memory_monitoring_enabled = true;
 
+// Sampling: track only 1-in-N allocations. 1 = track everything. Raising N
+// shrinks tracking overhead on the hot path proportionally; leak counts
+// are then estimates scaled by the sample rate.
+#define ALLOC_SAMPLE_RATE  1
+static uint32_t alloc_sample_counter = 0;
+static int lru_oldest = LRU_NONE;   // head of the age-ordered list
+static int lru_newest = LRU_NONE;   // tail of the age-ordered list
+
 // ---- Helpers ----
-static int find_free_allocation_slot(void) {
-    for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-        if (!allocations[i].is_active) return i;
+static inline uint32_t ptr_hash(void* ptr) {
+    // Heap pointers are at least 4-byte aligned; drop the dead bits and mix.
+    return ((uint32_t)(uintptr_t)ptr >> 2) * 2654435761u;
+}
+
+static void lru_append(int slot) {
+    allocations[slot].lru_prev = lru_newest;
+    allocations[slot].lru_next = LRU_NONE;
+    if (lru_newest != LRU_NONE) allocations[lru_newest].lru_next = slot;
+    lru_newest = slot;
+    if (lru_oldest == LRU_NONE) lru_oldest = slot;
+}
+
+static void lru_unlink(int slot) {
+    int prev = allocations[slot].lru_prev;
+    int next = allocations[slot].lru_next;
+    if (prev != LRU_NONE) allocations[prev].lru_next = next; else lru_oldest = next;
+    if (next != LRU_NONE) allocations[next].lru_prev = prev; else lru_newest = prev;
+    allocations[slot].lru_prev = LRU_NONE;
+    allocations[slot].lru_next = LRU_NONE;
+}
+
+// O(1) expected: linear probing from the hash bucket, reusing tombstones.
+static int find_free_allocation_slot(void* ptr) {
+    uint32_t index = ptr_hash(ptr) & (ALLOC_TABLE_SIZE - 1);
+    for (int probe = 0; probe < ALLOC_TABLE_SIZE; probe++) {
+        memory_allocation_t* a = &allocations[index];
+        if (a->ptr == NULL || a->ptr == ALLOC_TOMBSTONE) return (int)index;
+        index = (index + 1) & (ALLOC_TABLE_SIZE - 1);
     }
     return -1;
 }
 
 static int find_allocation_by_ptr(void* ptr) {
-    for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-        if (allocations[i].is_active && allocations[i].ptr == ptr) return i;
+    uint32_t index = ptr_hash(ptr) & (ALLOC_TABLE_SIZE - 1);
+    for (int probe = 0; probe < ALLOC_TABLE_SIZE; probe++) {
+        memory_allocation_t* a = &allocations[index];
+        if (a->ptr == NULL) return -1;   // empty bucket ends the probe chain
+        if (a->ptr == ptr && a->is_active) return (int)index;
+        index = (index + 1) & (ALLOC_TABLE_SIZE - 1);
     }
     return -1;
 }
 
+// ---- Per-task accounting ----
+//
+// Call-site stats say *where* the heap went; when it exhausts, the question
+// is *who*. Each task that allocates through the tracker gets an account:
+// current and peak bytes, alloc/free counts, and an optional soft quota
+// that fails allocations over budget — the isolation mechanism that keeps
+// one leaking task from taking everything else down with it. The hot path
+// stays O(1): the calling task's account hangs off a thread-local storage
+// pointer, so charge/uncharge is a pointer load and two adds, and each
+// record carries its owner index so a free charges back to the allocating
+// task even when another task does the freeing.
+#define TASKACCT_MAX      8
+#define TASKACCT_TLS_IDX  1    // index 0 is used by the pthread layer
+#define TASKACCT_NONE     (-1)
+
+typedef struct {
+    TaskHandle_t task;
+    char name[configMAX_TASK_NAME_LEN];
+    size_t current_bytes;
+    size_t peak_bytes;
+    size_t quota_bytes;        // 0 = no quota
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t quota_rejections;
+} task_acct_t;
+
+static task_acct_t task_accts[TASKACCT_MAX];
+static int task_acct_count = 0;
+
+static inline task_acct_t* task_acct_self(void) {
+    return (task_acct_t*)pvTaskGetThreadLocalStoragePointer(NULL, TASKACCT_TLS_IDX);
+}
+
+// Claims a roster slot for the calling task on first use. Called under
+// memory_mutex, which also serializes the count increment.
+static task_acct_t* task_acct_register(void) {
+    task_acct_t* a = task_acct_self();
+    if (a) return a;
+    if (task_acct_count >= TASKACCT_MAX) return NULL;
+    a = &task_accts[task_acct_count++];
+    a->task = xTaskGetCurrentTaskHandle();
+    strncpy(a->name, pcTaskGetName(NULL), sizeof(a->name) - 1);
+    vTaskSetThreadLocalStoragePointer(NULL, TASKACCT_TLS_IDX, a);
+    return a;
+}
+
+// Sets a soft heap quota for the calling task; 0 clears it. Allocations
+// that would push the task's charged bytes over the quota fail before
+// touching the heap.
+static void task_acct_set_quota(size_t bytes) {
+    if (!memory_mutex || xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    task_acct_t* a = task_acct_register();
+    if (a) a->quota_bytes = bytes;
+    xSemaphoreGive(memory_mutex);
+    if (a) ESP_LOGI(TAG, "💳 Quota: %s capped at %u B", a->name, (unsigned)bytes);
+}
+
+// ---- Call-site statistics ----
+//
+// Allocations are keyed by the return address of the tracked_malloc call
+// instead of a description string: the address is free to capture, unique
+// per call site, and scales to hundreds of sites where hand-written labels
+// don't. `addr2line` on the reported addresses recovers file:line. Stats
+// accumulate per site so the summary can rank which sites drive heap
+// pressure and fragmentation.
+#define CALLSITE_TABLE_SIZE 32   // power of two, sized for this lab's sites
+
+// Heat class per call site, derived from its allocation rate. Allocation
+// rate is the proxy for access frequency we can observe for free: a site
+// that allocates every loop iteration is touching its buffers constantly,
+// a once-at-boot site is not.
+typedef enum {
+    HEAT_UNKNOWN = 0,
+    HEAT_COLD,
+    HEAT_WARM,
+    HEAT_HOT,
+} heat_class_t;
+
+typedef struct {
+    void* site;               // NULL = empty bucket
+    uint32_t count;           // successful allocations
+    uint32_t failures;
+    uint64_t total_bytes;     // lifetime bytes requested
+    size_t live_bytes;        // currently outstanding
+    size_t peak_live_bytes;
+    uint32_t count_at_reclass;  // snapshot for rate computation
+    heat_class_t heat;
+} callsite_stats_t;
+
+static callsite_stats_t callsites[CALLSITE_TABLE_SIZE];
+
+// Find-or-insert; caller holds memory_mutex. Sites are never removed, so
+// no tombstones are needed. Returns NULL only when the table overflows.
+static callsite_stats_t* callsite_lookup(void* site) {
+    uint32_t index = ptr_hash(site) & (CALLSITE_TABLE_SIZE - 1);
+    for (int probe = 0; probe < CALLSITE_TABLE_SIZE; probe++) {
+        callsite_stats_t* cs = &callsites[index];
+        if (cs->site == site) return cs;
+        if (cs->site == NULL) {
+            cs->site = site;
+            return cs;
+        }
+        index = (index + 1) & (CALLSITE_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+// ---- Streaming top-K sites ----
+//
+// print_allocation_summary walks every tracked slot and every call
+// site — fine on a console, too big for routine telemetry. The
+// collector wants a fixed-size record per interval instead. Churn is
+// tracked with the space-saving algorithm over the byte stream: K
+// counters, and when a new site arrives with all slots taken it evicts
+// the minimum and inherits its weight as the overestimate bound, which
+// guarantees every site whose true churn exceeds the current minimum
+// holds a slot — even sites the exact table had to turn away. Live
+// bytes need no sketch: ranking the site table is a constant-size
+// scan. Both emit as stable comma-separated TOPK lines a collector
+// can parse without caring about the rest of the log.
+#define TOPK_SLOTS 16
+
+typedef struct {
+    void *site;
+    uint64_t weight;    // bytes allocated through this site
+    uint64_t error;     // overestimate bound inherited on takeover
+} topk_entry_t;
+
+static topk_entry_t topk[TOPK_SLOTS];
+
+// Caller holds memory_mutex (alloc path).
+static void topk_feed(void *site, size_t bytes) {
+    int min_idx = 0;
+    for (int i = 0; i < TOPK_SLOTS; i++) {
+        if (topk[i].site == site) {
+            topk[i].weight += bytes;
+            return;
+        }
+        if (topk[i].site == NULL) {
+            topk[i].site = site;
+            topk[i].weight = bytes;
+            topk[i].error = 0;
+            return;
+        }
+        if (topk[i].weight < topk[min_idx].weight) min_idx = i;
+    }
+    // All slots taken: the newcomer seizes the minimum, keeping its
+    // weight as the error bound (true weight is within [w-err, w]).
+    topk[min_idx].error = topk[min_idx].weight;
+    topk[min_idx].weight += bytes;
+    topk[min_idx].site = site;
+}
+
+static void topk_report(void) {
+    if (!memory_mutex) return;
+    if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) return;
+
+    ESP_LOGI(TAG, "TOPK,begin,churn_bytes,%d", TOPK_SLOTS);
+    bool used[TOPK_SLOTS] = {0};
+    for (int rank = 0; rank < TOPK_SLOTS; rank++) {
+        int best = -1;
+        for (int i = 0; i < TOPK_SLOTS; i++) {
+            if (topk[i].site == NULL || used[i]) continue;
+            if (best < 0 || topk[i].weight > topk[best].weight) best = i;
+        }
+        if (best < 0) break;
+        used[best] = true;
+        ESP_LOGI(TAG, "TOPK,churn,%d,%p,%llu,%llu", rank + 1,
+                 topk[best].site, topk[best].weight, topk[best].error);
+    }
+
+    ESP_LOGI(TAG, "TOPK,begin,live_bytes,%d", TOPK_SLOTS);
+    bool seen[CALLSITE_TABLE_SIZE] = {0};
+    for (int rank = 0; rank < TOPK_SLOTS; rank++) {
+        int best = -1;
+        for (int i = 0; i < CALLSITE_TABLE_SIZE; i++) {
+            if (callsites[i].site == NULL || seen[i] ||
+                callsites[i].live_bytes == 0) continue;
+            if (best < 0 || callsites[i].live_bytes > callsites[best].live_bytes)
+                best = i;
+        }
+        if (best < 0) break;
+        seen[best] = true;
+        ESP_LOGI(TAG, "TOPK,live,%d,%p,%u,%u", rank + 1, callsites[best].site,
+                 (unsigned)callsites[best].live_bytes,
+                 (unsigned)callsites[best].peak_live_bytes);
+    }
+    ESP_LOGI(TAG, "TOPK,end");
+
+    xSemaphoreGive(memory_mutex);
+}
+
+// ---- Lifetime heatmap ----
+//
+// analyze_memory_status shows pressure and fragmentation after the fact;
+// it can't say which allocations to pool to prevent them. The heatmap
+// can: every free buckets the dying allocation by (size class x lifetime
+// class). A size row dominated by short-lived frees is churning the
+// allocator and is the textbook pool candidate; rows that live for
+// minutes gain nothing from pooling. Counters are a compact 2D grid
+// bumped under memory_mutex on the free path — one compare-loop and an
+// increment.
+#define LIFEMAP_SIZE_CLASSES 8   // <=32B, then doubling, >2KB last
+#define LIFEMAP_LIFE_CLASSES 7   // <1ms, then decades, >=100s last
+#define LIFEMAP_POOL_MIN     32  // frees before a row can be a candidate
+
+static uint32_t lifemap[LIFEMAP_SIZE_CLASSES][LIFEMAP_LIFE_CLASSES];
+
+static inline int lifemap_size_class(size_t size) {
+    int cls = 0;
+    size_t bound = 32;
+    while (cls < LIFEMAP_SIZE_CLASSES - 1 && size > bound) {
+        bound <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+static inline int lifemap_life_class(uint64_t life_us) {
+    int cls = 0;
+    uint64_t bound = 1000;   // 1 ms
+    while (cls < LIFEMAP_LIFE_CLASSES - 1 && life_us >= bound) {
+        bound *= 10;
+        cls++;
+    }
+    return cls;
+}
+
+// Caller holds memory_mutex (called from the tracked_free path).
+static inline void lifemap_record(size_t size, uint64_t life_us) {
+    lifemap[lifemap_size_class(size)][lifemap_life_class(life_us)]++;
+}
+
+static void lifemap_report(void) {
+    static const char* size_names[LIFEMAP_SIZE_CLASSES] =
+        {"<=32B", "64B", "128B", "256B", "512B", "1KB", "2KB", ">2KB"};
+    static const char* life_names[LIFEMAP_LIFE_CLASSES] =
+        {"<1ms", "<10ms", "<100ms", "<1s", "<10s", "<100s", ">=100s"};
+
+    if (!memory_mutex) return;
+    if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) return;
+
+    ESP_LOGI(TAG, "\n🗺️ LIFETIME HEATMAP (frees, size x lifetime)");
+    char row[128];
+    int pos = snprintf(row, sizeof(row), "%8s", "");
+    for (int l = 0; l < LIFEMAP_LIFE_CLASSES; l++) {
+        pos += snprintf(row + pos, sizeof(row) - pos, " %7s", life_names[l]);
+    }
+    ESP_LOGI(TAG, "%s", row);
+
+    for (int s = 0; s < LIFEMAP_SIZE_CLASSES; s++) {
+        uint32_t total = 0, short_lived = 0;
+        pos = snprintf(row, sizeof(row), "%8s", size_names[s]);
+        for (int l = 0; l < LIFEMAP_LIFE_CLASSES; l++) {
+            pos += snprintf(row + pos, sizeof(row) - pos, " %7lu", lifemap[s][l]);
+            total += lifemap[s][l];
+            if (l <= 3) short_lived += lifemap[s][l];   // < 1 s
+        }
+        if (total == 0) continue;   // skip empty rows, keep the dump short
+        // Mostly-short-lived rows with real volume are pool material.
+        bool candidate = total >= LIFEMAP_POOL_MIN && short_lived * 4 >= total * 3;
+        ESP_LOGI(TAG, "%s%s", row, candidate ? "  <- pool candidate" : "");
+    }
+
+    xSemaphoreGive(memory_mutex);
+}
+
+// ---- Placement policy ----
+//
+// Choosing MALLOC_CAP flags by hand gets it wrong often enough to matter:
+// a hot buffer landing in PSRAM costs ~4x per access. The policy engine
+// reclassifies each call site from its observed allocation rate and, for
+// requests that left the choice open (MALLOC_CAP_DEFAULT), steers hot
+// small buffers into internal RAM and cold large ones into SPIRAM.
+// Explicit INTERNAL/SPIRAM requests are never overridden.
+#define PLACEMENT_HOT_RATE       6     // allocs per reclass window => HOT
+#define PLACEMENT_WARM_RATE      2
+#define PLACEMENT_SMALL_LIMIT    1024  // hot-steer candidates at or below this
+#define PLACEMENT_LARGE_LIMIT    4096  // cold-steer candidates at or above this
+#define PLACEMENT_EST_TOUCHES    4     // assumed whole-buffer accesses per alloc
+
+static uint32_t placement_steered_internal;
+static uint32_t placement_steered_spiram;
+static uint64_t placement_psram_bytes_avoided;  // hot traffic kept off PSRAM
+static uint64_t placement_internal_bytes_freed; // cold bytes moved off internal
+
+// Reclassify every site from allocations since the last call. Runs from
+// the monitor task, so the window is its 10 s period.
+static void placement_reclassify(void) {
+    if (!memory_mutex) return;
+    if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    for (int i = 0; i < CALLSITE_TABLE_SIZE; i++) {
+        callsite_stats_t* cs = &callsites[i];
+        if (cs->site == NULL) continue;
+        uint32_t rate = cs->count - cs->count_at_reclass;
+        cs->count_at_reclass = cs->count;
+        if (rate >= PLACEMENT_HOT_RATE)       cs->heat = HEAT_HOT;
+        else if (rate >= PLACEMENT_WARM_RATE) cs->heat = HEAT_WARM;
+        else if (cs->heat != HEAT_UNKNOWN)    cs->heat = HEAT_COLD;
+        else if (cs->count > 0)               cs->heat = HEAT_COLD;
+    }
+    xSemaphoreGive(memory_mutex);
+}
+
+// Pick the effective caps for one request. Short mutex take; on timeout
+// the caller's caps stand — the policy is an optimization, never a gate.
+static uint32_t placement_apply(void* site, size_t size, uint32_t caps) {
+    if (caps != MALLOC_CAP_DEFAULT) return caps;
+    if (!memory_mutex || xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(10)) != pdTRUE) return caps;
+
+    callsite_stats_t* cs = callsite_lookup(site);
+    if (cs) {
+        if (cs->heat == HEAT_HOT && size <= PLACEMENT_SMALL_LIMIT) {
+            caps = MALLOC_CAP_INTERNAL;
+            placement_steered_internal++;
+            placement_psram_bytes_avoided += (uint64_t)size * PLACEMENT_EST_TOUCHES;
+        } else if (cs->heat == HEAT_COLD && size >= PLACEMENT_LARGE_LIMIT &&
+                   heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > size) {
+            caps = MALLOC_CAP_SPIRAM;
+            placement_steered_spiram++;
+            placement_internal_bytes_freed += size;
+        }
+    }
+    xSemaphoreGive(memory_mutex);
+    return caps;
+}
+
+static void placement_report(void) {
+    ESP_LOGI(TAG, "\n🧭 PLACEMENT POLICY");
+    ESP_LOGI(TAG, "Steered to internal: %lu allocs (hot+small)", placement_steered_internal);
+    ESP_LOGI(TAG, "Steered to SPIRAM:   %lu allocs (cold+large)", placement_steered_spiram);
+    ESP_LOGI(TAG, "Est. PSRAM traffic avoided: %llu B (%d touches/alloc assumed)",
+             placement_psram_bytes_avoided, PLACEMENT_EST_TOUCHES);
+    ESP_LOGI(TAG, "Internal RAM relieved:      %llu B", placement_internal_bytes_freed);
+}
+
 // ---- Tracked alloc/free ----
-static void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
+// noinline so __builtin_return_address(0) is the caller's call site, not
+// wherever the optimizer hoisted the body.
+// ---- Allocation flight recorder ----
+// The last FLIGHTREC_EVENTS alloc/free events live in a .noinit ring,
+// which ordinary RAM initialization skips — so the ring survives a
+// software reset, including the one a panic or watchdog triggers.
+// Recording is four stores and an atomic increment, cheap enough to
+// leave on permanently, and it captures EVERY event even when slot
+// tracking samples or the table is full. On the next boot, if the
+// reset reason says the previous run crashed, the surviving ring is
+// dumped before anything touches the heap: its tail is the exact
+// allocation history that led into the crash. A magic word guards
+// against dumping the garbage a power-on leaves behind.
+#define FLIGHTREC_EVENTS   64            // power of two
+#define FLIGHTREC_MAGIC    0x464C5245    // "FLRE"
+#define FLIGHTREC_FREE_BIT 0x80000000u   // tags a free in the size word
+
+typedef struct {
+    uint32_t site;      // call-site return address
+    uint32_t size;      // allocation size; FLIGHTREC_FREE_BIT = free
+    uint32_t ptr;       // NULL here on a failed allocation
+    uint32_t cycles;    // CPU cycle stamp at the event
+} flightrec_event_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t next;      // free-running write index
+    flightrec_event_t ev[FLIGHTREC_EVENTS];
+} flightrec_ring_t;
+
+static __NOINIT_ATTR flightrec_ring_t flightrec;
+
+static inline void flightrec_record(void *site, size_t size, void *ptr,
+                                    bool is_free) {
+    // Atomic claim of the slot index; the stores themselves can race a
+    // concurrent writer only across distinct slots.
+    uint32_t idx = __atomic_fetch_add(&flightrec.next, 1, __ATOMIC_RELAXED);
+    flightrec_event_t *e = &flightrec.ev[idx & (FLIGHTREC_EVENTS - 1)];
+    e->site = (uint32_t)(uintptr_t)site;
+    e->size = (uint32_t)size | (is_free ? FLIGHTREC_FREE_BIT : 0);
+    e->ptr = (uint32_t)(uintptr_t)ptr;
+    e->cycles = esp_cpu_get_cycle_count();
+}
+
+// Call first thing in app_main: dump the previous run's ring if it
+// died by panic or watchdog, then (re)arm the recorder.
+static void flightrec_boot_check(void) {
+    esp_reset_reason_t why = esp_reset_reason();
+    bool survived = (flightrec.magic == FLIGHTREC_MAGIC);
+    bool crashed = (why == ESP_RST_PANIC || why == ESP_RST_INT_WDT ||
+                    why == ESP_RST_TASK_WDT);
+
+    if (survived && crashed) {
+        uint32_t count = flightrec.next < FLIGHTREC_EVENTS
+                             ? flightrec.next : FLIGHTREC_EVENTS;
+        ESP_LOGW(TAG, "✈️ Flight recorder: %lu events from crashed run (reset reason %d), oldest first:",
+                 count, why);
+        uint32_t prev_cyc = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            const flightrec_event_t *e =
+                &flightrec.ev[(flightrec.next - count + i) & (FLIGHTREC_EVENTS - 1)];
+            ESP_LOGW(TAG, "  %2lu %s %6luB @0x%08lx site=0x%08lx +%lu cyc",
+                     i, (e->size & FLIGHTREC_FREE_BIT) ? "FREE " : "ALLOC",
+                     e->size & ~FLIGHTREC_FREE_BIT, e->ptr, e->site,
+                     i ? e->cycles - prev_cyc : 0);
+            prev_cyc = e->cycles;
+        }
+    }
+
+    // Fresh power-on (garbage magic) or a dumped crash: start clean.
+    // A plain software restart keeps accumulating into the same ring.
+    if (!survived || crashed) {
+        memset(&flightrec, 0, sizeof(flightrec));
+        flightrec.magic = FLIGHTREC_MAGIC;
+    }
+}
+
+static __attribute__((noinline)) void* tracked_malloc(size_t size, uint32_t caps) {
+    void* site = __builtin_return_address(0);
+
+    // Soft quota: refuse before touching the heap. The unlocked read of
+    // current_bytes can race a concurrent free by a few bytes — fine for
+    // a soft budget, and it keeps the rejection path lock-free.
+    task_acct_t* acct = task_acct_self();
+    if (acct && acct->quota_bytes && acct->current_bytes + size > acct->quota_bytes) {
+        acct->quota_rejections++;
+        ESP_LOGW(TAG, "⛔ Quota: %s over budget (%u + %u > %u B)", acct->name,
+                 (unsigned)acct->current_bytes, (unsigned)size,
+                 (unsigned)acct->quota_bytes);
+        return NULL;
+    }
+
+    caps = placement_apply(site, size, caps);
     void* ptr = heap_caps_malloc(size, caps);
+    flightrec_record(site, size, ptr, false);
+
+    if (ALLOC_SAMPLE_RATE > 1 && (++alloc_sample_counter % ALLOC_SAMPLE_RATE) != 0) {
+        return ptr;   // not sampled: skip tracking entirely
+    }
 
     if (memory_monitoring_enabled && memory_mutex) {
         if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
             if (ptr) {
-                int slot = find_free_allocation_slot();
-                if (slot >= 0) {
+                int slot = find_free_allocation_slot(ptr);
+                if (slot >= 0 && stats.current_allocations < MAX_ALLOCATIONS) {
                     allocations[slot].ptr = ptr;
                     allocations[slot].size = size;
                     allocations[slot].caps = caps;
-                    allocations[slot].description = description;
+                    allocations[slot].site = site;
                     allocations[slot].timestamp = esp_timer_get_time();
                     allocations[slot].is_active = true;
+                    lru_append(slot);
 
                     stats.total_allocations++;
                     stats.current_allocations++;
@@ -92,13 +585,50 @@ static void* tracked_malloc(size_t size, uint32_t caps, const char* description)
                     size_t current_usage = stats.total_bytes_allocated - stats.total_bytes_deallocated;
                     if (current_usage > stats.peak_usage) stats.peak_usage = current_usage;
 
-                    ESP_LOGI(TAG, "✅ Alloc %dB @%p (%s) slot=%d", (int)size, ptr, description, slot);
+                    callsite_stats_t* cs = callsite_lookup(site);
+                    if (cs) {
+                        cs->count++;
+                        cs->total_bytes += size;
+                        cs->live_bytes += size;
+                        if (cs->live_bytes > cs->peak_live_bytes) cs->peak_live_bytes = cs->live_bytes;
+                    }
+                    // Sketch keeps heavy hitters even when the exact
+                    // table overflows and cs comes back NULL.
+                    topk_feed(site, size);
+
+                    acct = task_acct_register();
+                    allocations[slot].owner =
+                        acct ? (int8_t)(acct - task_accts) : TASKACCT_NONE;
+                    if (acct) {
+                        acct->allocs++;
+                        acct->current_bytes += size;
+                        if (acct->current_bytes > acct->peak_bytes) {
+                            acct->peak_bytes = acct->current_bytes;
+                        }
+                    }
+
+                    // Hot path: runs inside memory_mutex on every alloc,
+                    // so the line is composed with fastfmt instead of
+                    // four printf conversions.
+                    char line[64];
+                    char *lp = ff_str(line, "✅ Alloc ");
+                    lp = ff_u32(lp, (uint32_t)size);
+                    lp = ff_str(lp, "B @0x");
+                    lp = ff_hex32(lp, (uint32_t)(uintptr_t)ptr, 8);
+                    lp = ff_str(lp, " site=0x");
+                    lp = ff_hex32(lp, (uint32_t)(uintptr_t)site, 8);
+                    lp = ff_str(lp, " slot=");
+                    lp = ff_i32(lp, slot);
+                    ff_term(lp);
+                    ESP_LOGI(TAG, "%s", line);
                 } else {
                     ESP_LOGW(TAG, "⚠️ Tracking slots full");
                 }
             } else {
                 stats.allocation_failures++;
-                ESP_LOGE(TAG, "❌ Alloc FAIL %dB (%s)", (int)size, description);
+                callsite_stats_t* cs = callsite_lookup(site);
+                if (cs) cs->failures++;
+                ESP_LOGE(TAG, "❌ Alloc FAIL %dB site=%p", (int)size, site);
             }
             xSemaphoreGive(memory_mutex);
         }
@@ -106,21 +636,49 @@ static void* tracked_malloc(size_t size, uint32_t caps, const char* description)
     return ptr;
 }
 
-static void tracked_free(void* ptr, const char* description) {
+static __attribute__((noinline)) void tracked_free(void* ptr) {
     if (!ptr) return;
+    flightrec_record(__builtin_return_address(0), 0, ptr, true);
 
     if (memory_monitoring_enabled && memory_mutex) {
         if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
             int slot = find_allocation_by_ptr(ptr);
             if (slot >= 0) {
+                lifemap_record(allocations[slot].size,
+                               esp_timer_get_time() - allocations[slot].timestamp);
                 allocations[slot].is_active = false;
+                lru_unlink(slot);
+                allocations[slot].ptr = ALLOC_TOMBSTONE;
                 stats.total_deallocations++;
                 stats.current_allocations--;
                 stats.total_bytes_deallocated += allocations[slot].size;
-                ESP_LOGI(TAG, "🗑️ Free %dB @%p (%s) slot=%d",
-                         (int)allocations[slot].size, ptr, description, slot);
+                callsite_stats_t* cs = callsite_lookup(allocations[slot].site);
+                if (cs && cs->live_bytes >= allocations[slot].size) {
+                    cs->live_bytes -= allocations[slot].size;
+                }
+                // Charge back to the allocating task, not the freeing one.
+                if (allocations[slot].owner != TASKACCT_NONE) {
+                    task_acct_t* oa = &task_accts[(int)allocations[slot].owner];
+                    oa->frees++;
+                    if (oa->current_bytes >= allocations[slot].size) {
+                        oa->current_bytes -= allocations[slot].size;
+                    } else {
+                        oa->current_bytes = 0;
+                    }
+                }
+                char line[64];
+                char *lp = ff_str(line, "🗑️ Free ");
+                lp = ff_u32(lp, (uint32_t)allocations[slot].size);
+                lp = ff_str(lp, "B @0x");
+                lp = ff_hex32(lp, (uint32_t)(uintptr_t)ptr, 8);
+                lp = ff_str(lp, " site=0x");
+                lp = ff_hex32(lp, (uint32_t)(uintptr_t)allocations[slot].site, 8);
+                lp = ff_str(lp, " slot=");
+                lp = ff_i32(lp, slot);
+                ff_term(lp);
+                ESP_LOGI(TAG, "%s", line);
             } else {
-                ESP_LOGW(TAG, "⚠️ Untracked free @%p (%s)", ptr, description);
+                ESP_LOGW(TAG, "⚠️ Untracked free @%p", ptr);
             }
             xSemaphoreGive(memory_mutex);
         }
@@ -164,6 +722,20 @@ static void analyze_memory_status(void) {
         gpio_set_level(LED_MEMORY_ERROR, 0);
     }
 
+    // Per-task table: who is holding the heap right now. Read without the
+    // tracking mutex — the fields are word-sized and a report a few bytes
+    // stale beats blocking allocators for a log dump.
+    if (task_acct_count > 0) {
+        ESP_LOGI(TAG, "\n👥 PER-TASK HEAP");
+        for (int i = 0; i < task_acct_count; i++) {
+            task_acct_t* a = &task_accts[i];
+            ESP_LOGI(TAG, "%-12s cur=%-7u peak=%-7u quota=%-7u a/f=%lu/%lu rejected=%lu",
+                     a->name, (unsigned)a->current_bytes, (unsigned)a->peak_bytes,
+                     (unsigned)a->quota_bytes, a->allocs, a->frees,
+                     a->quota_rejections);
+        }
+    }
+
     if (internal_frag > FRAGMENTATION_THRESHOLD) {
         gpio_set_level(LED_FRAGMENTATION, 1);
         stats.fragmentation_events++;
@@ -191,16 +763,35 @@ static void print_allocation_summary(void) {
     ESP_LOGI(TAG, "Low mem events:   %lu", stats.low_memory_events);
 
     if (stats.current_allocations > 0) {
-        ESP_LOGI(TAG, "\n🔍 ACTIVE ALLOCS");
-        for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-            if (allocations[i].is_active) {
-                uint64_t age_ms = (esp_timer_get_time() - allocations[i].timestamp) / 1000;
-                ESP_LOGI(TAG, "slot=%d size=%d ptr=%p caps=0x%X age=%llums desc=%s",
-                         i, (int)allocations[i].size, allocations[i].ptr,
-                         (unsigned)allocations[i].caps, age_ms,
-                         allocations[i].description ? allocations[i].description : "-");
-            }
+        ESP_LOGI(TAG, "\n🔍 ACTIVE ALLOCS (oldest first)");
+        for (int i = lru_oldest; i != LRU_NONE; i = allocations[i].lru_next) {
+            uint64_t age_ms = (esp_timer_get_time() - allocations[i].timestamp) / 1000;
+            ESP_LOGI(TAG, "slot=%d size=%d ptr=%p caps=0x%X age=%llums site=%p",
+                     i, (int)allocations[i].size, allocations[i].ptr,
+                     (unsigned)allocations[i].caps, age_ms, allocations[i].site);
+        }
+    }
+
+    // Top call sites by lifetime bytes: the heaviest sources of heap
+    // traffic, and the first suspects when fragmentation climbs. Selection
+    // sort over a table this small beats maintaining a sorted copy.
+    ESP_LOGI(TAG, "\n🏆 TOP ALLOC SITES (by total bytes; addr2line to resolve)");
+    bool reported[CALLSITE_TABLE_SIZE] = {0};
+    for (int rank = 0; rank < 5; rank++) {
+        int best = -1;
+        for (int i = 0; i < CALLSITE_TABLE_SIZE; i++) {
+            if (callsites[i].site == NULL || reported[i]) continue;
+            if (best < 0 || callsites[i].total_bytes > callsites[best].total_bytes) best = i;
         }
+        if (best < 0) break;
+        reported[best] = true;
+        static const char* heat_names[] = {"?", "cold", "warm", "hot"};
+        ESP_LOGI(TAG, "#%d site=%p count=%lu fail=%lu total=%llu live=%u peak=%u heat=%s",
+                 rank + 1, callsites[best].site, callsites[best].count,
+                 callsites[best].failures, callsites[best].total_bytes,
+                 (unsigned)callsites[best].live_bytes,
+                 (unsigned)callsites[best].peak_live_bytes,
+                 heat_names[callsites[best].heat]);
     }
 
     xSemaphoreGive(memory_mutex);
@@ -216,17 +807,16 @@ static void detect_memory_leaks(void) {
 
     ESP_LOGI(TAG, "\n🔍 LEAK SCAN (age>30s)");
 
-    for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-        if (allocations[i].is_active) {
-            uint64_t age_ms = (now - allocations[i].timestamp) / 1000;
-            if (age_ms > 30000) {
-                ESP_LOGW(TAG, "LEAK? slot=%d %dB @%p age=%llums desc=%s",
-                         i, (int)allocations[i].size, allocations[i].ptr, age_ms,
-                         allocations[i].description ? allocations[i].description : "-");
-                leaks++;
-                leaked_bytes += allocations[i].size;
-            }
-        }
+    // The LRU list is age-ordered, so the scan visits only old-enough
+    // records and stops at the first one younger than the threshold.
+    for (int i = lru_oldest; i != LRU_NONE; i = allocations[i].lru_next) {
+        uint64_t age_ms = (now - allocations[i].timestamp) / 1000;
+        if (age_ms <= 30000) break;
+        ESP_LOGW(TAG, "LEAK? slot=%d %dB @%p age=%llums site=%p",
+                 i, (int)allocations[i].size, allocations[i].ptr, age_ms,
+                 allocations[i].site);
+        leaks++;
+        leaked_bytes += allocations[i].size;
     }
 
     if (leaks > 0) {
@@ -240,40 +830,334 @@ static void detect_memory_leaks(void) {
     xSemaphoreGive(memory_mutex);
 }
 
-// ---- Tasks ----
-static void memory_stress_test_task(void *p) {
-    ESP_LOGI(TAG, "🧪 Stress test start");
-    void* ptrs[20] = {0};
-    int n = 0;
+// Incremental leak scan: examines at most `budget` table entries per call
+// and carries a cursor between invocations, so the tracking lock is held
+// for a short, bounded time instead of a full-table pass. One complete
+// sweep takes ALLOC_TABLE_SIZE / budget invocations.
+static void detect_memory_leaks_incremental(int budget) {
+    static int scan_cursor = 0;
+    static int sweep_leaks = 0;
+    static size_t sweep_leaked_bytes = 0;
+
+    if (!memory_mutex) return;
+    if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+
+    uint64_t now = esp_timer_get_time();
+    for (int n = 0; n < budget; n++) {
+        memory_allocation_t* a = &allocations[scan_cursor];
+        if (a->is_active && a->ptr != NULL && a->ptr != ALLOC_TOMBSTONE) {
+            uint64_t age_ms = (now - a->timestamp) / 1000;
+            if (age_ms > 30000) {
+                ESP_LOGW(TAG, "LEAK? slot=%d %dB @%p age=%llums site=%p",
+                         scan_cursor, (int)a->size, a->ptr, age_ms, a->site);
+                sweep_leaks++;
+                sweep_leaked_bytes += a->size;
+            }
+        }
+        scan_cursor++;
+        if (scan_cursor >= ALLOC_TABLE_SIZE) {
+            // Sweep complete: publish totals and start over.
+            scan_cursor = 0;
+            if (sweep_leaks > 0) {
+                ESP_LOGW(TAG, "Sweep: %d potential leaks (%d bytes)%s",
+                         sweep_leaks, (int)sweep_leaked_bytes,
+                         ALLOC_SAMPLE_RATE > 1 ? " [sampled, scale by rate]" : "");
+                gpio_set_level(LED_MEMORY_ERROR, 1);
+            }
+            sweep_leaks = 0;
+            sweep_leaked_bytes = 0;
+            break;
+        }
+    }
+
+    xSemaphoreGive(memory_mutex);
+}
+
+// ---- Compacting region ----
+//
+// Long-lived small allocations with interleaved lifetimes are what carve
+// the heap into unusable slivers and make analyze_memory_status report a
+// collapsing largest-free-block. The compacting region sidesteps that:
+// callers get a stable handle instead of a raw pointer (double indirection
+// through a table), so a background pass can slide live blocks together
+// and hand the reclaimed space back as one contiguous tail. Raw pointers
+// from compact_ptr() are only valid while compact_mutex is held — the
+// compactor moves blocks underneath anything longer-lived.
+#define COMPACT_REGION_SIZE  16384
+#define COMPACT_HANDLES      64
+#define COMPACT_ALIGN        4
+#define COMPACT_INVALID      (-1)
+
+typedef struct {
+    uint16_t offset;          // into compact_region
+    uint16_t size;            // aligned size, 0 = free handle
+} compact_block_t;
+
+static uint8_t* compact_region;
+static compact_block_t compact_blocks[COMPACT_HANDLES];
+static size_t compact_used;           // bump cursor: blocks live below this
+static size_t compact_freed_bytes;    // holes below the cursor, reclaimable
+static uint32_t compact_passes;
+static uint32_t compact_moved_blocks;
+static SemaphoreHandle_t compact_mutex;
 
+// Bump-allocate at the tail; compaction is what makes freed space at the
+// tail reappear. Returns a handle, not a pointer.
+static int compact_alloc(size_t size) {
+    size = (size + COMPACT_ALIGN - 1) & ~(size_t)(COMPACT_ALIGN - 1);
+    if (size == 0 || size > COMPACT_REGION_SIZE) return COMPACT_INVALID;
+
+    int handle = COMPACT_INVALID;
+    if (xSemaphoreTake(compact_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return COMPACT_INVALID;
+    if (compact_used + size <= COMPACT_REGION_SIZE) {
+        for (int h = 0; h < COMPACT_HANDLES; h++) {
+            if (compact_blocks[h].size == 0) {
+                compact_blocks[h].offset = (uint16_t)compact_used;
+                compact_blocks[h].size = (uint16_t)size;
+                compact_used += size;
+                handle = h;
+                break;
+            }
+        }
+    }
+    xSemaphoreGive(compact_mutex);
+    return handle;
+}
+
+static void compact_free(int handle) {
+    if (handle < 0 || handle >= COMPACT_HANDLES) return;
+    if (xSemaphoreTake(compact_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    compact_freed_bytes += compact_blocks[handle].size;
+    compact_blocks[handle].size = 0;
+    xSemaphoreGive(compact_mutex);
+}
+
+// Caller must hold compact_mutex for as long as the pointer is used.
+static void* compact_ptr(int handle) {
+    if (handle < 0 || handle >= COMPACT_HANDLES || compact_blocks[handle].size == 0) return NULL;
+    return compact_region + compact_blocks[handle].offset;
+}
+
+// One full compaction pass: repeatedly find the lowest-offset live block
+// above the write cursor and slide it down. O(handles²) scans, but with 64
+// handles that is far cheaper than keeping the table offset-sorted.
+static void compact_pass(void) {
+    if (xSemaphoreTake(compact_mutex, pdMS_TO_TICKS(100)) != pdTRUE) return;
+    if (compact_freed_bytes == 0) {
+        xSemaphoreGive(compact_mutex);
+        return;
+    }
+
+    size_t write = 0;
     while (1) {
-        int action = esp_random() % 3;
-
-        if (action == 0 && n < 20) {
-            size_t size = 100 + (esp_random() % 2100);
-            uint32_t caps = (esp_random() % 2) ? MALLOC_CAP_INTERNAL : MALLOC_CAP_DEFAULT;
-            void* pbuf = tracked_malloc(size, caps, "Stress");
-            if (pbuf) {
-                memset(pbuf, 0xAA, size);
-                ptrs[n++] = pbuf;
-                ESP_LOGI(TAG, "🔧 alloc %dB (n=%d)", (int)size, n);
+        int next = COMPACT_INVALID;
+        for (int h = 0; h < COMPACT_HANDLES; h++) {
+            if (compact_blocks[h].size == 0 || compact_blocks[h].offset < write) continue;
+            if (next == COMPACT_INVALID || compact_blocks[h].offset < compact_blocks[next].offset) next = h;
+        }
+        if (next == COMPACT_INVALID) break;
+        if (compact_blocks[next].offset != write) {
+            memmove(compact_region + write,
+                    compact_region + compact_blocks[next].offset,
+                    compact_blocks[next].size);
+            compact_blocks[next].offset = (uint16_t)write;
+            compact_moved_blocks++;
+        }
+        write += compact_blocks[next].size;
+    }
+
+    compact_used = write;
+    compact_freed_bytes = 0;
+    compact_passes++;
+    xSemaphoreGive(compact_mutex);
+}
+
+// Idle-priority compactor plus a demo workload that frees every other
+// block — the worst interleave for a conventional heap — then shows the
+// contiguous tail recovered by the pass.
+static void compact_region_task(void *p) {
+    ESP_LOGI(TAG, "🧲 Compacting region start (%d B, %d handles)",
+             COMPACT_REGION_SIZE, COMPACT_HANDLES);
+    int handles[32];
+
+    while (1) {
+        for (int i = 0; i < 32; i++) {
+            handles[i] = compact_alloc(64 + (esp_random() % 192));
+            if (handles[i] >= 0 && xSemaphoreTake(compact_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+                void* blk = compact_ptr(handles[i]);
+                if (blk) memset(blk, 0xC0 + i, compact_blocks[handles[i]].size);
+                xSemaphoreGive(compact_mutex);
             }
-        } else if (action == 1 && n > 0) {
-            int idx = esp_random() % n;
-            if (ptrs[idx]) {
-                tracked_free(ptrs[idx], "Stress");
-                for (int i = idx; i < n - 1; i++) ptrs[i] = ptrs[i + 1];
-                n--;
-                ESP_LOGI(TAG, "🗑️ free (n=%d)", n);
+        }
+        for (int i = 0; i < 32; i += 2) {
+            compact_free(handles[i]);
+            handles[i] = COMPACT_INVALID;
+        }
+
+        size_t tail_before = COMPACT_REGION_SIZE - compact_used;
+        compact_pass();
+        size_t tail_after = COMPACT_REGION_SIZE - compact_used;
+        ESP_LOGI(TAG, "🧲 Compact: tail %u → %u B (passes=%lu moved=%lu)",
+                 (unsigned)tail_before, (unsigned)tail_after,
+                 compact_passes, compact_moved_blocks);
+
+        for (int i = 1; i < 32; i += 2) {
+            compact_free(handles[i]);
+            handles[i] = COMPACT_INVALID;
+        }
+        compact_pass();
+        vTaskDelay(pdMS_TO_TICKS(12000));
+    }
+}
+
+// ---- Workload engine ----
+//
+// The old stress task hard-coded one random alloc/free pattern, so a run
+// was never reproducible and "looked fine" was the only verdict. The
+// engine replaces it: scenarios are declarative table rows (seed, size
+// and lifetime distributions, worker count, duration, pass thresholds),
+// the PRNG is a seeded xorshift so a failing run replays exactly, and
+// each scenario ends with a pass/fail verdict on p99 alloc latency and
+// final internal fragmentation. Latencies time heap_caps_malloc directly
+// (like the strategy benchmark) so the tracker's mutex stays out of the
+// measurement.
+#define WL_LIVE_MAX 24
+
+typedef struct {
+    const char* name;
+    uint32_t seed;
+    size_t min_size, max_size;
+    uint32_t min_life_ms, max_life_ms;
+    int workers;
+    uint32_t duration_ms;
+    uint32_t caps;
+    uint32_t p99_limit_us;    // fail above this
+    float frag_limit;         // fail above this final fragmentation
+} wl_scenario_t;
+
+static const wl_scenario_t wl_scenarios[] = {
+    {"small_churn", 0xC0FFEE01, 32,   256,   50,   500, 2, 15000, MALLOC_CAP_DEFAULT,  50, 0.25f},
+    {"mixed_life",  0xC0FFEE02, 64,   2048,  100,  5000, 2, 20000, MALLOC_CAP_DEFAULT, 100, 0.30f},
+    {"large_slow",  0xC0FFEE03, 2048, 16384, 1000, 8000, 1, 20000, MALLOC_CAP_INTERNAL, 200, 0.35f},
+};
+#define WL_SCENARIO_COUNT (sizeof(wl_scenarios) / sizeof(wl_scenarios[0]))
+
+typedef struct {
+    const wl_scenario_t* scenario;
+    int worker_index;
+    pb_series_t* series;
+    SemaphoreHandle_t done;
+} wl_worker_ctx_t;
+
+static portMUX_TYPE wl_series_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t wl_rand(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline uint32_t wl_range(uint32_t* state, uint32_t lo, uint32_t hi) {
+    return lo + wl_rand(state) % (hi - lo + 1);
+}
+
+static void wl_worker_task(void *p) {
+    wl_worker_ctx_t* ctx = p;
+    const wl_scenario_t* sc = ctx->scenario;
+    // Same seed => same sequence: the worker index keeps the workers
+    // decorrelated while the scenario stays replayable.
+    uint32_t rng = sc->seed + (uint32_t)ctx->worker_index * 0x9E3779B9u;
+
+    struct { void* ptr; uint32_t expires_ms; } live[WL_LIVE_MAX] = {0};
+    int live_count = 0;
+    uint32_t start_ms = esp_timer_get_time() / 1000;
+
+    while ((uint32_t)(esp_timer_get_time() / 1000) - start_ms < sc->duration_ms) {
+        uint32_t now_ms = esp_timer_get_time() / 1000;
+
+        for (int i = 0; i < live_count; ) {
+            if ((int32_t)(now_ms - live[i].expires_ms) >= 0) {
+                heap_caps_free(live[i].ptr);
+                live[i] = live[--live_count];
+            } else {
+                i++;
             }
-        } else {
-            analyze_memory_status();
         }
 
-        vTaskDelay(pdMS_TO_TICKS(1000 + (esp_random() % 2000)));
+        if (live_count < WL_LIVE_MAX) {
+            size_t size = wl_range(&rng, sc->min_size, sc->max_size);
+            uint32_t t0 = pb_cycles_now();
+            void* ptr = heap_caps_malloc(size, sc->caps);
+            uint32_t dt = pb_cycles_now() - t0;
+            portENTER_CRITICAL(&wl_series_lock);
+            pb_series_add(ctx->series, dt);
+            portEXIT_CRITICAL(&wl_series_lock);
+            if (ptr) {
+                memset(ptr, 0xAB, size);
+                live[live_count].ptr = ptr;
+                live[live_count].expires_ms = now_ms + wl_range(&rng, sc->min_life_ms, sc->max_life_ms);
+                live_count++;
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(wl_range(&rng, 10, 50)));
+    }
+
+    while (live_count > 0) heap_caps_free(live[--live_count].ptr);
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+static void workload_engine_task(void *p) {
+    static pb_series_t series;
+    static wl_worker_ctx_t ctxs[4];
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(4, 0);
+
+    vTaskDelay(pdMS_TO_TICKS(3000));   // let the boot-time benchmark finish
+    ESP_LOGI(TAG, "🧪 Workload engine: %d scenarios", (int)WL_SCENARIO_COUNT);
+    int failures = 0;
+
+    for (int s = 0; s < WL_SCENARIO_COUNT; s++) {
+        const wl_scenario_t* sc = &wl_scenarios[s];
+        ESP_LOGI(TAG, "▶️ Scenario '%s': seed=0x%lX %u-%uB life=%lu-%lums workers=%d %lums",
+                 sc->name, sc->seed, (unsigned)sc->min_size, (unsigned)sc->max_size,
+                 sc->min_life_ms, sc->max_life_ms, sc->workers, sc->duration_ms);
+        pb_series_init(&series, sc->name);
+
+        for (int w = 0; w < sc->workers; w++) {
+            ctxs[w] = (wl_worker_ctx_t){sc, w, &series, done};
+            xTaskCreate(wl_worker_task, "WlWorker", 3072, &ctxs[w], 5, NULL);
+        }
+        for (int w = 0; w < sc->workers; w++) {
+            xSemaphoreTake(done, portMAX_DELAY);
+        }
+
+        pb_stats_t st;
+        pb_series_stats(&series, &st);
+        size_t free_b = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+        size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+        float frag = free_b ? 1.0f - ((float)largest / (float)free_b) : 0.0f;
+
+        bool pass = st.p99_us <= sc->p99_limit_us && frag <= sc->frag_limit;
+        if (!pass) failures++;
+        ESP_LOGI(TAG, "%s '%s': p99=%luus (limit %lu) frag=%.1f%% (limit %.1f%%)",
+                 pass ? "✅ PASS" : "❌ FAIL", sc->name,
+                 st.p99_us, sc->p99_limit_us, frag * 100.0f, sc->frag_limit * 100.0f);
+        pb_series_report(&series);
+        vTaskDelay(pdMS_TO_TICKS(2000));
     }
+
+    ESP_LOGI(TAG, "🧪 Workload engine done: %d/%d scenarios passed",
+             (int)WL_SCENARIO_COUNT - failures, (int)WL_SCENARIO_COUNT);
+    vSemaphoreDelete(done);
+    vTaskDelete(NULL);
 }
 
+// ---- Tasks ----
+
 static void memory_pool_test_task(void *p) {
     ESP_LOGI(TAG, "🏊 Pool test start");
 
@@ -284,9 +1168,7 @@ static void memory_pool_test_task(void *p) {
         ESP_LOGI(TAG, "Alloc pools");
         for (int s = 0; s < 5; s++) {
             for (int i = 0; i < 10; i++) {
-                char desc[24];
-                snprintf(desc, sizeof(desc), "Pool%d_%d", s, i);
-                pool[s][i] = tracked_malloc(SZ[s], MALLOC_CAP_INTERNAL, desc);
+                pool[s][i] = tracked_malloc(SZ[s], MALLOC_CAP_INTERNAL);
                 if (pool[s][i]) memset(pool[s][i], 0x55 + s, SZ[s]);
             }
         }
@@ -297,7 +1179,7 @@ static void memory_pool_test_task(void *p) {
         for (int s = 4; s >= 0; s--) {
             for (int i = 9; i >= 0; i--) {
                 if (pool[s][i]) {
-                    tracked_free(pool[s][i], "Pool");
+                    tracked_free(pool[s][i]);
                     pool[s][i] = NULL;
                 }
             }
@@ -311,14 +1193,18 @@ static void memory_pool_test_task(void *p) {
 static void large_allocation_test_task(void *p) {
     ESP_LOGI(TAG, "🐘 Large alloc test start");
 
+    // Soft quota below the largest request this task makes, so runs
+    // exercise the rejection path and the per-task table shows it.
+    task_acct_set_quota(120000);
+
     while (1) {
         size_t sz = 50000 + (esp_random() % 100000);
         ESP_LOGI(TAG, "Try large %dB", (int)sz);
 
-        void* pbuf = tracked_malloc(sz, MALLOC_CAP_INTERNAL, "LargeInternal");
+        void* pbuf = tracked_malloc(sz, MALLOC_CAP_INTERNAL);
         if (!pbuf) {
             ESP_LOGW(TAG, "Internal fail, try SPIRAM");
-            pbuf = tracked_malloc(sz, MALLOC_CAP_SPIRAM, "LargeSPIRAM");
+            pbuf = tracked_malloc(sz, MALLOC_CAP_SPIRAM);
         }
 
         if (pbuf) {
@@ -327,7 +1213,7 @@ static void large_allocation_test_task(void *p) {
             uint64_t t1 = esp_timer_get_time();
             ESP_LOGI(TAG, "Write time: %llu us", (t1 - t0));
             vTaskDelay(pdMS_TO_TICKS(10000));
-            tracked_free(pbuf, "Large");
+            tracked_free(pbuf);
         } else {
             ESP_LOGE(TAG, "Large alloc fail");
             analyze_memory_status();
@@ -337,68 +1223,298 @@ static void large_allocation_test_task(void *p) {
     }
 }
 
-static void memory_monitor_task(void *p) {
-    ESP_LOGI(TAG, "📊 Monitor start");
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(10000));
-        analyze_memory_status();
-        print_allocation_summary();
-        detect_memory_leaks();
+// ---- CPU utilization accounting ----
+//
+// vTaskGetRunTimeStats means parsing strings and paying for a formatted
+// dump. The idle hook gives exact numbers for free: it runs in a tight
+// loop whenever a core has nothing to do, so consecutive hook calls are
+// a few cycles apart. Any larger gap between calls is time a real task
+// (or ISR) held the core. Summing only the small deltas yields idle
+// cycles per core; busy is everything else. Cost per hook call is one
+// cycle-counter read and a compare.
+#define UTIL_IDLE_GAP_CYCLES 4000   // deltas above this mean work ran
+
+static volatile uint32_t util_last_cycles[portNUM_PROCESSORS];
+static volatile uint64_t util_idle_cycles[portNUM_PROCESSORS];
 
-        if (!heap_caps_check_integrity_all(true)) {
-            ESP_LOGE(TAG, "🚨 HEAP CORRUPTED");
-            gpio_set_level(LED_MEMORY_ERROR, 1);
+static bool util_idle_hook(void) {
+    int core = xPortGetCoreID();
+    uint32_t now = esp_cpu_get_cycle_count();
+    uint32_t delta = now - util_last_cycles[core];
+    if (delta < UTIL_IDLE_GAP_CYCLES) {
+        util_idle_cycles[core] += delta;
+    }
+    util_last_cycles[core] = now;
+    return true;
+}
+
+static void util_init(void) {
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        ESP_ERROR_CHECK(esp_register_freertos_idle_hook_for_cpu(util_idle_hook, core));
+    }
+}
+
+// Per-window busy percentage per core, computed from idle-cycle deltas
+// against wall-clock cycles.
+static void util_report(void) {
+    static uint64_t prev_idle[portNUM_PROCESSORS];
+    static int64_t prev_time_us;
+
+    int64_t now_us = esp_timer_get_time();
+    uint64_t window_cycles =
+        (uint64_t)(now_us - prev_time_us) * esp_rom_get_cpu_ticks_per_us();
+    if (prev_time_us != 0 && window_cycles > 0) {
+        ESP_LOGI(TAG, "🖥️ CPU utilization (%.1f s window):",
+                 (now_us - prev_time_us) / 1e6);
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            uint64_t idle = util_idle_cycles[core] - prev_idle[core];
+            if (idle > window_cycles) idle = window_cycles;
+            uint32_t busy_pct = (uint32_t)(100 - idle * 100 / window_cycles);
+            ESP_LOGI(TAG, "  core%d: %lu%% busy", core, busy_pct);
         }
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        prev_idle[core] = util_idle_cycles[core];
+    }
+    prev_time_us = now_us;
+}
+
+static bool integrity_check_slice(void);
+
+// ---- Monitor jobs ----
+//
+// The monitor and integrity tasks were both strictly periodic loops —
+// two stacks and two wakeup trains for work that never overlaps. Their
+// bodies are now (period, phase, budget) jobs on one pexec rate task
+// with a 2 s base tick: the integrity slice keeps its 2 s cadence, the
+// 10 s reports are spread across different base ticks so no single
+// wakeup runs them all, and the 30/60 s cross-checks ride the same task
+// as slow dividers. Budgets make a creeping report visible in the
+// executor stats instead of silently stretching the loop.
+
+static void job_util(void *ctx)      { util_report(); }
+static void job_reclass(void *ctx)   { placement_reclassify(); }
+static void job_status(void *ctx)    { analyze_memory_status(); }
+static void job_leak_incr(void *ctx) { detect_memory_leaks_incremental(32); }
+static void job_leak_full(void *ctx) { detect_memory_leaks(); }
+static void job_exec_report(void *ctx) { pexec_report(); }
+
+static void job_summary(void *ctx) {
+    print_allocation_summary();
+    lifemap_report();
+    placement_report();
+}
+
+static void job_topk(void *ctx) { topk_report(); }
+
+static void job_heartbeat(void *ctx) {
+    ESP_LOGI(TAG, "Free heap: %u", (unsigned)esp_get_free_heap_size());
+    ESP_LOGI(TAG, "Uptime: %llu ms\n", esp_timer_get_time() / 1000);
+}
 
-        ESP_LOGI(TAG, "Free heap: %u", (unsigned)esp_get_free_heap_size());
-        ESP_LOGI(TAG, "Uptime: %llu ms\n", esp_timer_get_time() / 1000);
+static void job_integ_slice(void *ctx) {
+    if (!integrity_check_slice()) {
+        ESP_LOGE(TAG, "🚨 HEAP CORRUPTED");
+        gpio_set_level(LED_MEMORY_ERROR, 1);
+        heap_caps_print_heap_info(MALLOC_CAP_INTERNAL);
+        if (heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > 0) {
+            heap_caps_print_heap_info(MALLOC_CAP_SPIRAM);
+        }
     }
 }
 
-static void heap_integrity_test_task(void *p) {
-    ESP_LOGI(TAG, "🔍 Integrity test start");
+// ---- Incremental integrity checking ----
+//
+// heap_caps_check_integrity_all walks every heap in one go and stalls
+// allocators for tens of milliseconds once PSRAM is in play. The public
+// allocator API can't check less than one heap at a time, so the finest
+// slice available is one capability region; the checker carries a cursor
+// across regions, checks exactly one per invocation, and measures the
+// pause so budget overruns are visible instead of silent. Regions that
+// repeatedly blow the budget should be checked only from low-priority
+// context (which is where this runs).
+#define INTEG_SLICE_BUDGET_US  500
 
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(30000));
-        ESP_LOGI(TAG, "Check integrity...");
-        bool ok = heap_caps_check_integrity_all(false);
-        if (ok) {
-            ESP_LOGI(TAG, "✅ Heap OK");
+typedef struct {
+    const char* name;
+    uint32_t caps;
+} integ_region_t;
+
+static const integ_region_t integ_regions[] = {
+    {"internal", MALLOC_CAP_INTERNAL},
+    {"spiram",   MALLOC_CAP_SPIRAM},
+};
+#define INTEG_REGION_COUNT (sizeof(integ_regions) / sizeof(integ_regions[0]))
+
+static uint32_t integ_slices_run;
+static uint32_t integ_budget_overruns;
+static uint64_t integ_max_pause_us;
+
+// Check one region and advance the cursor. Returns false on corruption.
+static bool integrity_check_slice(void) {
+    static int cursor = 0;
+    const integ_region_t* region = &integ_regions[cursor];
+    cursor = (cursor + 1) % INTEG_REGION_COUNT;
+
+    if (heap_caps_get_free_size(region->caps) == 0) return true;  // absent heap
+
+    uint64_t t0 = esp_timer_get_time();
+    bool ok = heap_caps_check_integrity(region->caps, false);
+    uint64_t pause = esp_timer_get_time() - t0;
+
+    integ_slices_run++;
+    if (pause > integ_max_pause_us) integ_max_pause_us = pause;
+    if (pause > INTEG_SLICE_BUDGET_US) {
+        integ_budget_overruns++;
+        ESP_LOGW(TAG, "⚠️ Integrity slice '%s' took %lluus (budget %dus)",
+                 region->name, pause, INTEG_SLICE_BUDGET_US);
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "❌ Corruption in %s heap", region->name);
+    }
+    return ok;
+}
+
+// Every-30-s cross-check: full all-heaps walk plus the small perf probe,
+// run from the monitor executor as a slow divider on the 2 s base tick.
+static void job_integ_full(void *ctx) {
+    ESP_LOGI(TAG, "Integrity: %lu slices, %lu over budget, max pause %lluus",
+             integ_slices_run, integ_budget_overruns, integ_max_pause_us);
+    if (!heap_caps_check_integrity_all(false)) {
+        ESP_LOGE(TAG, "❌ Heap FAIL (full walk)");
+        gpio_set_level(LED_MEMORY_ERROR, 1);
+    } else {
+        ESP_LOGI(TAG, "✅ Heap OK");
+    }
+
+    // small perf test
+    const size_t TSZ = 4096;
+    void* buf = tracked_malloc(TSZ, MALLOC_CAP_INTERNAL);
+    if (buf) {
+        uint64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < 100; i++) memset(buf, i, TSZ);
+        uint64_t tw = esp_timer_get_time() - t0;
+
+        t0 = esp_timer_get_time();
+        volatile uint8_t csum = 0;
+        for (int i = 0; i < 100; i++) {
+            uint8_t* b = (uint8_t*)buf;
+            for (size_t j = 0; j < TSZ; j++) csum += b[j];
+        }
+        uint64_t tr = esp_timer_get_time() - t0;
+        (void)csum;
+
+        ESP_LOGI(TAG, "Perf: write=%llu us read=%llu us", tw, tr);
+        tracked_free(buf);
+    }
+}
+
+// ---- Allocation strategy benchmark ----
+// Runs a steady-state churn workload (random alloc/free interleave over a
+// configurable size distribution) against each heap_caps strategy and
+// reports p50/p99 allocation latency plus largest-free-block decay, so
+// capability choices can be made from data rather than guesswork.
+#define BENCH_OPS            2000
+#define BENCH_LIVE_MAX       48
+
+typedef struct {
+    const char* name;
+    uint32_t caps;
+} heap_strategy_t;
+
+typedef struct {
+    const char* name;
+    size_t min_size;
+    size_t max_size;
+} size_distribution_t;
+
+static void run_strategy_benchmark(const heap_strategy_t* strat,
+                                   const size_distribution_t* dist) {
+    // Latencies go through the shared perf_bench series: cycle-counter
+    // timing, outlier trimming, and a PBCSV line the nightly perf runs
+    // can scrape, consistent with the other labs' benchmarks.
+    static pb_series_t series;
+    static char series_name[32];
+    void* live[BENCH_LIVE_MAX] = {0};
+    int live_count = 0;
+    uint32_t failures = 0;
+
+    if (heap_caps_get_free_size(strat->caps) == 0) {
+        ESP_LOGW(TAG, "Bench: %s unavailable, skipping", strat->name);
+        return;
+    }
+
+    snprintf(series_name, sizeof(series_name), "heap_%s_%s", strat->name, dist->name);
+    pb_series_init(&series, series_name);
+
+    size_t largest_start = heap_caps_get_largest_free_block(strat->caps);
+
+    for (int op = 0; op < BENCH_OPS; op++) {
+        // Keep the live set around half full for a steady-state interleave.
+        bool do_alloc = (live_count == 0) ||
+                        (live_count < BENCH_LIVE_MAX &&
+                         (esp_random() % BENCH_LIVE_MAX) >= live_count);
+        if (do_alloc) {
+            size_t span = dist->max_size - dist->min_size + 1;
+            size_t size = dist->min_size + (esp_random() % span);
+            uint32_t t0 = pb_cycles_now();
+            void* p = heap_caps_malloc(size, strat->caps);
+            pb_series_add(&series, pb_cycles_now() - t0);
+            if (p) live[live_count++] = p; else failures++;
         } else {
-            ESP_LOGE(TAG, "❌ Heap FAIL");
-            gpio_set_level(LED_MEMORY_ERROR, 1);
-            heap_caps_print_heap_info(MALLOC_CAP_INTERNAL);
-            if (heap_caps_get_free_size(MALLOC_CAP_SPIRAM) > 0) {
-                heap_caps_print_heap_info(MALLOC_CAP_SPIRAM);
-            }
+            int idx = esp_random() % live_count;
+            heap_caps_free(live[idx]);
+            live[idx] = live[--live_count];
         }
+    }
 
-        // small perf test
-        const size_t TSZ = 4096;
-        void* buf = tracked_malloc(TSZ, MALLOC_CAP_INTERNAL, "PerfTest");
-        if (buf) {
-            uint64_t t0 = esp_timer_get_time();
-            for (int i = 0; i < 100; i++) memset(buf, i, TSZ);
-            uint64_t tw = esp_timer_get_time() - t0;
-
-            t0 = esp_timer_get_time();
-            volatile uint8_t csum = 0;
-            for (int i = 0; i < 100; i++) {
-                uint8_t* b = (uint8_t*)buf;
-                for (size_t j = 0; j < TSZ; j++) csum += b[j];
-            }
-            uint64_t tr = esp_timer_get_time() - t0;
-            (void)csum;
+    size_t largest_mid = heap_caps_get_largest_free_block(strat->caps);
+    while (live_count > 0) heap_caps_free(live[--live_count]);
+    size_t largest_end = heap_caps_get_largest_free_block(strat->caps);
+
+    ESP_LOGI(TAG, "%-8s | %-6s | fail=%lu | largest: %u → %u → %u",
+             strat->name, dist->name, failures,
+             (unsigned)largest_start, (unsigned)largest_mid, (unsigned)largest_end);
+    pb_series_report(&series);
+}
 
-            ESP_LOGI(TAG, "Perf: write=%llu us read=%llu us", tw, tr);
-            tracked_free(buf, "PerfTest");
+static void benchmark_allocation_strategies(void) {
+    static const heap_strategy_t strategies[] = {
+        {"INTERNAL", MALLOC_CAP_INTERNAL},
+        {"DEFAULT",  MALLOC_CAP_DEFAULT},
+        {"SPIRAM",   MALLOC_CAP_SPIRAM},
+    };
+    static const size_distribution_t distributions[] = {
+        {"small", 16,   64},
+        {"mixed", 32,   1024},
+        {"large", 1024, 8192},
+    };
+
+    ESP_LOGI(TAG, "\n⏱️ ALLOCATION STRATEGY BENCHMARK (%d ops each)", BENCH_OPS);
+    ESP_LOGI(TAG, "largest = largest free block before / under churn / after cleanup");
+    for (int s = 0; s < 3; s++) {
+        for (int d = 0; d < 3; d++) {
+            run_strategy_benchmark(&strategies[s], &distributions[d]);
+            vTaskDelay(pdMS_TO_TICKS(100));
         }
     }
+    ESP_LOGI(TAG, "Benchmark done\n");
+}
+
+static void heap_benchmark_task(void *p) {
+    // Run once at startup before the stress tasks muddy the heap.
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    benchmark_allocation_strategies();
+    vTaskDelete(NULL);
 }
 
 void app_main(void) {
     ESP_LOGI(TAG, "🚀 Heap Management Lab Starting...");
 
+    // Before anything allocates: dump the previous run's allocation
+    // history if it ended in a panic or watchdog reset.
+    flightrec_boot_check();
+
     gpio_set_direction(LED_MEMORY_OK, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_LOW_MEMORY, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_MEMORY_ERROR, GPIO_MODE_OUTPUT);
@@ -417,6 +1533,17 @@ void app_main(void) {
         return;
     }
     memset(allocations, 0, sizeof(allocations));
+    memset(callsites, 0, sizeof(callsites));
+    memset(task_accts, 0, sizeof(task_accts));
+    util_init();
+
+    compact_mutex = xSemaphoreCreateMutex();
+    compact_region = heap_caps_malloc(COMPACT_REGION_SIZE, MALLOC_CAP_INTERNAL);
+    if (!compact_mutex || !compact_region) {
+        ESP_LOGE(TAG, "Compacting region init failed");
+        return;
+    }
+    memset(compact_blocks, 0, sizeof(compact_blocks));
 
     analyze_memory_status();
 
@@ -427,11 +1554,27 @@ void app_main(void) {
         heap_caps_print_heap_info(MALLOC_CAP_SPIRAM);
     }
 
-    xTaskCreate(memory_monitor_task,       "MemMonitor",  4096, NULL, 6, NULL);
-    xTaskCreate(memory_stress_test_task,   "StressTest",  3072, NULL, 5, NULL);
+    // Monitoring and integrity checks share one rate task: 2 s base tick,
+    // 10 s jobs spread across ticks 1-4, slow cross-checks as dividers.
+    int mon = pexec_add_rate("MonExec", 2000, 3, 4096);
+    pexec_add_job(mon, "integ-slice", job_integ_slice, NULL,  2000,     0,   2);
+    pexec_add_job(mon, "util",        job_util,        NULL, 10000,  2000,   2);
+    pexec_add_job(mon, "reclass",     job_reclass,     NULL, 10000,  2000,   2);
+    pexec_add_job(mon, "status",      job_status,      NULL, 10000,  2000,   5);
+    pexec_add_job(mon, "summary",     job_summary,     NULL, 10000,  4000,  30);
+    pexec_add_job(mon, "leak-incr",   job_leak_incr,   NULL, 10000,  6000,   5);
+    pexec_add_job(mon, "topk",        job_topk,        NULL, 10000,  6000,   5);
+    pexec_add_job(mon, "heartbeat",   job_heartbeat,   NULL, 10000,  8000,   2);
+    pexec_add_job(mon, "integ-full",  job_integ_full,  NULL, 30000, 10000, 100);
+    pexec_add_job(mon, "leak-full",   job_leak_full,   NULL, 60000, 22000,  30);
+    pexec_add_job(mon, "exec-report", job_exec_report, NULL, 60000, 42000,   5);
+    pexec_start();
+
+    xTaskCreate(workload_engine_task,      "Workload",    4096, NULL, 5, NULL);
     xTaskCreate(memory_pool_test_task,     "PoolTest",    3072, NULL, 5, NULL);
     xTaskCreate(large_allocation_test_task,"LargeAlloc",  2048, NULL, 4, NULL);
-    xTaskCreate(heap_integrity_test_task,  "Integrity",   3072, NULL, 3, NULL);
+    xTaskCreate(heap_benchmark_task,       "HeapBench",   4096, NULL, 7, NULL);
+    xTaskCreate(compact_region_task,       "Compactor",   3072, NULL, 1, NULL);
 
     ESP_LOGI(TAG, "\n🎯 LEDs:");
     ESP_LOGI(TAG, "GPIO2  - Memory OK");
@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -11,7 +12,11 @@
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_random.h"   // ✅ สำคัญ! ต้อง include เองตั้งแต่ ESP-IDF v5.2+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "soc/soc.h"
 #include "driver/gpio.h"
+#include "driver/gptimer.h"
 
 // Tag สำหรับ Log
 static const char *TAG = "MEM_POOLS";
@@ -37,7 +42,7 @@ static const char *TAG = "MEM_POOLS";
 typedef struct memory_block {
     struct memory_block* next;
     uint32_t magic;
-    uint32_t pool_id;()
+    uint32_t pool_id;
     uint64_t alloc_time;
 } memory_block_t;
 
@@ -48,8 +53,9 @@ typedef struct {
     size_t alignment;
     uint32_t caps;
     void* pool_memory;
+    size_t total_block_size;     // header + aligned payload, for index math
     memory_block_t* free_list;
-    uint32_t* usage_bitmap;
+    uint32_t* usage_bitmap;      // 1 bit per block, 1 = allocated
     size_t allocated_blocks;
     size_t peak_usage;
     uint64_t total_allocations;
@@ -59,6 +65,8 @@ typedef struct {
     uint32_t allocation_failures;
     SemaphoreHandle_t mutex;
     uint32_t pool_id;
+    memory_block_t* extension_list;   // blocks on loan from the reserve
+    uint32_t extension_free;          // how many of those are idle
 } memory_pool_t;
 
 // === Enum สำหรับ Pool ===
@@ -93,6 +101,119 @@ static const pool_config_t pool_configs[POOL_COUNT] = {
 #define POOL_MAGIC_FREE    0xDEADBEEF
 #define POOL_MAGIC_ALLOC   0xCAFEBABE
 
+// Inline magic validation on every pool_free costs two loads and two
+// branches on the hottest path. With the background scrubber (below)
+// cross-checking every block's magic against the usage bitmap anyway,
+// the fast-path build drops the inline checks — detection latency is
+// one scrub sweep instead of "at the next free", which in practice is
+// the same few seconds, and alloc/free get measurably cheaper. Set to 1
+// to get the old check-on-free behaviour back.
+#define POOL_INLINE_CHECKS 0
+
+// === Redzone poisoning (debug mode) ===
+// The header magic catches scribbles over block HEADERS; an overrun off
+// the END of a payload lands in the next block's header or payload and
+// surfaces as someone else's corruption, much later. Debug builds place
+// a 16-byte poisoned redzone after every payload, validated on free and
+// by the background scrubber. Validation is word-wise — four 32-bit
+// XOR-accumulate loads, no byte loop — cheap enough to leave on in the
+// beta channel.
+#define POOL_REDZONE_DEBUG 1
+
+#if POOL_REDZONE_DEBUG
+#define REDZONE_WORDS   4
+#define REDZONE_BYTES   (REDZONE_WORDS * sizeof(uint32_t))
+#define REDZONE_PATTERN 0xA5A5A5A5u
+
+static uint32_t redzone_violations = 0;
+
+// The zone sits at the tail of the block, so its offset comes from the
+// owning pool's geometry (extension blocks borrow it from the borrower).
+static inline uint32_t* block_redzone(memory_pool_t* pool, memory_block_t* block) {
+    return (uint32_t*)((uint8_t*)block + pool->total_block_size - REDZONE_BYTES);
+}
+
+static inline void redzone_poison(memory_pool_t* pool, memory_block_t* block) {
+    uint32_t* rz = block_redzone(pool, block);
+    for (int w = 0; w < REDZONE_WORDS; w++) rz[w] = REDZONE_PATTERN;
+}
+
+static inline bool redzone_ok(memory_pool_t* pool, memory_block_t* block) {
+    const uint32_t* rz = block_redzone(pool, block);
+    uint32_t acc = 0;
+    for (int w = 0; w < REDZONE_WORDS; w++) acc |= rz[w] ^ REDZONE_PATTERN;
+    return acc == 0;
+}
+
+static void redzone_violation(memory_pool_t* pool, memory_block_t* block,
+                              const char* site) {
+    redzone_violations++;
+    gpio_set_level(LED_POOL_ERROR, 1);
+    ESP_LOGE(TAG, "🚧 %s pool: payload overrun into redzone (found at %s, block %p)",
+             pool->name, site, (void*)block);
+    redzone_poison(pool, block);   // re-arm so one overrun logs once
+}
+#else
+#define REDZONE_BYTES 0
+#endif
+
+// === O(1) size-class lookup ===
+// smart_pool_malloc used to walk the pool array to find a fitting block
+// size. Instead we precompute a table mapping request size (in 64-byte
+// granules) directly to the smallest pool that fits, so the lookup is a
+// single indexed load no matter how many pools exist.
+#define SIZE_CLASS_GRANULE  64
+#define SIZE_CLASS_ENTRIES  ((HUGE_POOL_BLOCK_SIZE / SIZE_CLASS_GRANULE) + 1)
+
+static int8_t size_class_table[SIZE_CLASS_ENTRIES];   // -1 = no pool fits
+
+static void build_size_class_table(void) {
+    for (int c = 0; c < SIZE_CLASS_ENTRIES; c++) {
+        size_t size = (size_t)c * SIZE_CLASS_GRANULE;
+        size_class_table[c] = -1;
+        for (int i = 0; i < POOL_COUNT; i++) {
+            if (size <= pool_configs[i].block_size) {
+                size_class_table[c] = i;
+                break;
+            }
+        }
+    }
+}
+
+static inline int size_to_pool(size_t required) {
+    size_t class_idx = (required + SIZE_CLASS_GRANULE - 1) / SIZE_CLASS_GRANULE;
+    if (class_idx >= SIZE_CLASS_ENTRIES) return -1;
+    return size_class_table[class_idx];
+}
+
+// === Bitmap helpers ===
+// Block i lives at pool_memory + i * total_block_size, and bit i of the
+// usage bitmap says whether it is allocated. Find-first-zero over 32-bit
+// words replaces the free-list walk; with at most 32 blocks per pool this
+// is one or two ffs instructions.
+static inline memory_block_t* block_at(memory_pool_t* pool, int index) {
+    return (memory_block_t*)((uint8_t*)pool->pool_memory +
+                             (size_t)index * pool->total_block_size);
+}
+
+static int bitmap_find_and_set(memory_pool_t* pool) {
+    int words = ((int)pool->block_count + 31) / 32;
+    for (int w = 0; w < words; w++) {
+        uint32_t free_bits = ~pool->usage_bitmap[w];
+        if (free_bits == 0) continue;
+        int bit = __builtin_ffs(free_bits) - 1;
+        int index = w * 32 + bit;
+        if (index >= (int)pool->block_count) break;
+        pool->usage_bitmap[w] |= (1u << bit);
+        return index;
+    }
+    return -1;
+}
+
+static inline void bitmap_clear(memory_pool_t* pool, int index) {
+    pool->usage_bitmap[index / 32] &= ~(1u << (index % 32));
+}
+
 // === Function: Initialize Pool ===
 bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t pool_id) {
     if (!pool || !config) return false;
@@ -107,8 +228,8 @@ bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t
 
     size_t header_size = sizeof(memory_block_t);
     size_t aligned_block_size = (config->block_size + pool->alignment - 1) & ~(pool->alignment - 1);
-    size_t total_block_size = header_size + aligned_block_size;
-    size_t total_memory = total_block_size * config->block_count;
+    pool->total_block_size = header_size + aligned_block_size + REDZONE_BYTES;
+    size_t total_memory = pool->total_block_size * config->block_count;
 
     pool->pool_memory = heap_caps_malloc(total_memory, config->caps);
     if (!pool->pool_memory) {
@@ -116,21 +237,21 @@ bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t
         return false;
     }
 
-    size_t bitmap_bytes = (config->block_count + 7) / 8;
-    pool->usage_bitmap = heap_caps_calloc(bitmap_bytes, 1, MALLOC_CAP_INTERNAL);
+    size_t bitmap_words = (config->block_count + 31) / 32;
+    pool->usage_bitmap = heap_caps_calloc(bitmap_words, sizeof(uint32_t), MALLOC_CAP_INTERNAL);
     if (!pool->usage_bitmap) {
         heap_caps_free(pool->pool_memory);
         return false;
     }
 
-    uint8_t* memory_ptr = (uint8_t*)pool->pool_memory;
-    pool->free_list = NULL;
     for (int i = 0; i < config->block_count; i++) {
-        memory_block_t* block = (memory_block_t*)(memory_ptr + (i * total_block_size));
+        memory_block_t* block = block_at(pool, i);
         block->magic = POOL_MAGIC_FREE;
         block->pool_id = pool_id;
-        block->next = pool->free_list;
-        pool->free_list = block;
+        block->next = NULL;
+#if POOL_REDZONE_DEBUG
+        redzone_poison(pool, block);
+#endif
     }
 
     pool->mutex = xSemaphoreCreateMutex();
@@ -138,14 +259,103 @@ bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t
     return true;
 }
 
+// ===== Hot-function IRAM placement =====
+// Flash-cached code stalls for milliseconds when a flash write disables
+// the cache — fatal for allocators on hot paths. Instead of sprinkling
+// IRAM_ATTR ad hoc, hot functions are annotated with HOT_SECTION and
+// registered by name; the report then verifies each registered function
+// actually landed in IRAM (the annotation is easy to lose in a merge)
+// and shows the remaining IRAM headroom. A probe pair — one canary in
+// flash, one in IRAM — is timed every monitor cycle, and a flash canary
+// run taking 8x its IRAM twin counts as a flash stall.
+#define HOT_SECTION IRAM_ATTR
+#define HOT_FUNCS_MAX 16
+#define HOT_FUNC_REGISTER(fn) hot_func_register(#fn, (const void*)(fn))
+
+typedef struct {
+    const char *name;
+    const void *addr;
+} hot_func_entry_t;
+
+static hot_func_entry_t hot_funcs[HOT_FUNCS_MAX];
+static int hot_func_count = 0;
+static uint32_t flash_stalls_seen = 0;
+
+static void hot_func_register(const char *name, const void *addr) {
+    if (hot_func_count < HOT_FUNCS_MAX) {
+        hot_funcs[hot_func_count].name = name;
+        hot_funcs[hot_func_count].addr = addr;
+        hot_func_count++;
+    }
+}
+
+static inline bool addr_in_iram(const void *addr) {
+    return (uintptr_t)addr >= SOC_IRAM_LOW && (uintptr_t)addr < SOC_IRAM_HIGH;
+}
+
+// The probe bodies must be identical work so only placement differs.
+static void __attribute__((noinline)) flash_canary(void) {
+    volatile uint32_t acc = 0;
+    for (int i = 0; i < 64; i++) acc += i * 7;
+}
+
+static void IRAM_ATTR __attribute__((noinline)) iram_canary(void) {
+    volatile uint32_t acc = 0;
+    for (int i = 0; i < 64; i++) acc += i * 7;
+}
+
+static void flash_stall_probe(void) {
+    uint64_t t0 = esp_timer_get_time();
+    iram_canary();
+    uint64_t iram_us = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    flash_canary();
+    uint64_t flash_us = esp_timer_get_time() - t0;
+    if (flash_us > (iram_us + 1) * 8)
+        flash_stalls_seen++;
+}
+
+static void hot_func_report(void) {
+    int placed = 0;
+    for (int i = 0; i < hot_func_count; i++) {
+        bool in_iram = addr_in_iram(hot_funcs[i].addr);
+        if (in_iram) placed++;
+        else
+            ESP_LOGW(TAG, "⚠️ Hot function %s at %p is NOT in IRAM",
+                     hot_funcs[i].name, hot_funcs[i].addr);
+    }
+    ESP_LOGI(TAG, "IRAM placement: %d/%d hot functions placed, %u B IRAM free, %lu flash stalls seen",
+             placed, hot_func_count,
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_EXEC),
+             flash_stalls_seen);
+}
+
 // === Allocate / Free ===
-void* pool_malloc(memory_pool_t* pool) {
+// Reserve helpers are defined with the tuner below; pool_free and
+// smart_pool_free need them first.
+static inline bool reserve_owns(void* ptr);
+static void extension_free_block(void* ptr);
+
+void* HOT_SECTION pool_malloc(memory_pool_t* pool) {
     if (!pool || !pool->mutex) return NULL;
     void* result = NULL;
     if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        if (pool->free_list) {
-            memory_block_t* block = pool->free_list;
-            pool->free_list = block->next;
+        int index = bitmap_find_and_set(pool);
+        if (index >= 0) {
+            memory_block_t* block = block_at(pool, index);
+            block->magic = POOL_MAGIC_ALLOC;
+            block->alloc_time = esp_timer_get_time();
+            pool->allocated_blocks++;
+            pool->total_allocations++;
+            if (pool->allocated_blocks > pool->peak_usage) {
+                pool->peak_usage = pool->allocated_blocks;
+            }
+            result = (uint8_t*)block + sizeof(memory_block_t);
+        } else if (pool->extension_list != NULL) {
+            // Bitmap full: fall back to a block on loan from the reserve.
+            memory_block_t* block = pool->extension_list;
+            pool->extension_list = block->next;
+            pool->extension_free--;
             block->magic = POOL_MAGIC_ALLOC;
             block->alloc_time = esp_timer_get_time();
             pool->allocated_blocks++;
@@ -160,34 +370,388 @@ void* pool_malloc(memory_pool_t* pool) {
     return result;
 }
 
-bool pool_free(memory_pool_t* pool, void* ptr) {
+// True if ptr points into this pool's payload area.
+static inline bool pool_owns(memory_pool_t* pool, void* ptr) {
+    uint8_t* base = (uint8_t*)pool->pool_memory;
+    uint8_t* end = base + pool->total_block_size * pool->block_count;
+    return (uint8_t*)ptr > base && (uint8_t*)ptr < end;
+}
+
+bool HOT_SECTION pool_free(memory_pool_t* pool, void* ptr) {
     if (!pool || !ptr || !pool->mutex) return false;
+    // pool_malloc can hand out reserve extension blocks when the bitmap
+    // is full; they live outside pool_memory, so route them back to the
+    // loan list here — malloc and free stay symmetric for every caller,
+    // not just smart_pool_free.
+    if (reserve_owns(ptr)) {
+        extension_free_block(ptr);
+        return true;
+    }
+    if (!pool_owns(pool, ptr)) return false;
+
     memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
+    int index = (int)(((uint8_t*)block - (uint8_t*)pool->pool_memory) / pool->total_block_size);
+
+    bool freed = false;
     if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+#if POOL_REDZONE_DEBUG
+        if (!redzone_ok(pool, block)) {
+            redzone_violation(pool, block, "free");
+        }
+#endif
+#if POOL_INLINE_CHECKS
         if (block->magic == POOL_MAGIC_ALLOC && block->pool_id == pool->pool_id) {
             block->magic = POOL_MAGIC_FREE;
-            block->next = pool->free_list;
-            pool->free_list = block;
+            bitmap_clear(pool, index);
             pool->allocated_blocks--;
             pool->total_deallocations++;
+            freed = true;
         } else {
             gpio_set_level(LED_POOL_ERROR, 1);
         }
+#else
+        // Fast path: the magic store stays (the scrubber reads it) but
+        // the validation loads and branches are gone.
+        block->magic = POOL_MAGIC_FREE;
+        bitmap_clear(pool, index);
+        pool->allocated_blocks--;
+        pool->total_deallocations++;
+        freed = true;
+#endif
         xSemaphoreGive(pool->mutex);
     }
-    return true;
+    return freed;
+}
+
+// === Per-task magazine cache ===
+// Every pool_malloc/pool_free takes the pool mutex, which serializes all
+// allocating tasks. Each task therefore keeps a small per-pool stash of
+// blocks in thread-local storage: the common-case alloc/free touches only
+// the task's own stash (no lock, no contention) and the shared pool is
+// visited once per MAGAZINE_REFILL blocks to refill or flush.
+#define MAGAZINE_TLS_INDEX   1   // index 0 is used by the pthread layer
+#define MAGAZINE_CAPACITY    8
+#define MAGAZINE_REFILL      4   // blocks moved per refill/flush batch
+
+typedef struct {
+    void* blocks[POOL_COUNT][MAGAZINE_CAPACITY];
+    int count[POOL_COUNT];
+} task_magazine_t;
+
+typedef struct {
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t refills;
+    uint32_t flushes;
+} magazine_stats_t;
+
+static magazine_stats_t magazine_stats[POOL_COUNT];
+
+// Grab up to n blocks under a single mutex take; returns how many.
+static int pool_malloc_batch(memory_pool_t* pool, void** out, int n) {
+    int taken = 0;
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        while (taken < n) {
+            int index = bitmap_find_and_set(pool);
+            if (index < 0) break;
+            memory_block_t* block = block_at(pool, index);
+            block->magic = POOL_MAGIC_ALLOC;
+            block->alloc_time = esp_timer_get_time();
+            out[taken++] = (uint8_t*)block + sizeof(memory_block_t);
+        }
+        pool->allocated_blocks += taken;
+        pool->total_allocations += taken;
+        if (pool->allocated_blocks > pool->peak_usage) {
+            pool->peak_usage = pool->allocated_blocks;
+        }
+        xSemaphoreGive(pool->mutex);
+    }
+    return taken;
+}
+
+static void pool_free_batch(memory_pool_t* pool, void** ptrs, int n) {
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        int freed = 0;
+        for (int i = 0; i < n; i++) {
+            // Magazines only ever stash bitmap-backed blocks, but don't
+            // let that invariant be the only thing between a foreign
+            // pointer and an out-of-range bitmap_clear.
+            if (!pool_owns(pool, ptrs[i])) {
+                gpio_set_level(LED_POOL_ERROR, 1);
+                continue;
+            }
+            memory_block_t* block = (memory_block_t*)((uint8_t*)ptrs[i] - sizeof(memory_block_t));
+            int index = (int)(((uint8_t*)block - (uint8_t*)pool->pool_memory) / pool->total_block_size);
+            block->magic = POOL_MAGIC_FREE;
+            bitmap_clear(pool, index);
+            freed++;
+        }
+        pool->allocated_blocks -= freed;
+        pool->total_deallocations += freed;
+        xSemaphoreGive(pool->mutex);
+    }
+}
+
+// === Per-core block depots ===
+// The magazines remove per-task contention, but every refill and flush
+// still crossed to the single shared pool — and when one core mostly
+// allocates while the other mostly frees (the packet-path shape), the
+// pool mutex and the free bitmap's cache lines ping-pong between cores
+// on every batch. Each core now owns a depot per pool class: refills
+// and flushes touch only the current core's depot under a core-local
+// spinlock, so the common case never leaves the core. The shared pool
+// is visited only when a depot runs dry (refill) or past its high mark
+// (spill) — and that spill IS the rebalancing path: blocks freed on the
+// free-heavy core drain to the shared pool, where the alloc-heavy
+// core's next dry refill picks them up.
+#define DEPOT_CAPACITY  16
+#define DEPOT_SPILL_AT  12   // above this, spill down to half
+#define DEPOT_BATCH     4    // extra blocks fetched per dry refill
+
+typedef struct {
+    void* blocks[DEPOT_CAPACITY];
+    int count;
+    uint32_t local_hits;     // batches served without leaving the core
+    uint32_t dry_refills;    // had to visit the shared pool
+    uint32_t spills;         // rebalanced surplus back (free-heavy core)
+} core_depot_t;
+
+static core_depot_t core_depots[portNUM_PROCESSORS][POOL_COUNT];
+static portMUX_TYPE depot_locks[portNUM_PROCESSORS] = {
+    portMUX_INITIALIZER_UNLOCKED,
+#if portNUM_PROCESSORS > 1
+    portMUX_INITIALIZER_UNLOCKED,
+#endif
+};
+
+static int depot_alloc_batch(int pool_index, void** out, int n) {
+    int core = xPortGetCoreID();
+    core_depot_t* d = &core_depots[core][pool_index];
+
+    int taken = 0;
+    portENTER_CRITICAL(&depot_locks[core]);
+    while (taken < n && d->count > 0) {
+        out[taken++] = d->blocks[--d->count];
+    }
+    portEXIT_CRITICAL(&depot_locks[core]);
+    if (taken == n) {
+        d->local_hits++;
+        return taken;
+    }
+
+    // Depot dry: one shared-pool visit serves the caller and restocks.
+    void* bulk[MAGAZINE_REFILL + DEPOT_BATCH];
+    int got = pool_malloc_batch(&pools[pool_index], bulk, (n - taken) + DEPOT_BATCH);
+    d->dry_refills++;
+
+    int give = got < (n - taken) ? got : (n - taken);
+    for (int i = 0; i < give; i++) {
+        out[taken++] = bulk[i];
+    }
+    if (got > give) {
+        portENTER_CRITICAL(&depot_locks[core]);
+        for (int i = give; i < got && d->count < DEPOT_CAPACITY; i++) {
+            d->blocks[d->count++] = bulk[i];
+        }
+        portEXIT_CRITICAL(&depot_locks[core]);
+    }
+    return taken;
+}
+
+static void depot_free_batch(int pool_index, void** ptrs, int n) {
+    int core = xPortGetCoreID();
+    core_depot_t* d = &core_depots[core][pool_index];
+    void* spill[DEPOT_CAPACITY + MAGAZINE_REFILL];
+    int spill_n = 0;
+
+    portENTER_CRITICAL(&depot_locks[core]);
+    for (int i = 0; i < n; i++) {
+        if (d->count < DEPOT_CAPACITY) {
+            d->blocks[d->count++] = ptrs[i];
+        } else {
+            spill[spill_n++] = ptrs[i];
+        }
+    }
+    if (d->count >= DEPOT_SPILL_AT) {
+        // Free-heavy core: hand surplus to the shared pool so the other
+        // core's next dry refill finds it instead of exhausting.
+        while (d->count > DEPOT_CAPACITY / 2) {
+            spill[spill_n++] = d->blocks[--d->count];
+        }
+        d->spills++;
+    } else if (spill_n == 0) {
+        d->local_hits++;
+    }
+    portEXIT_CRITICAL(&depot_locks[core]);
+
+    if (spill_n > 0) {
+        pool_free_batch(&pools[pool_index], spill, spill_n);
+    }
+}
+
+static task_magazine_t* get_task_magazine(void) {
+    task_magazine_t* mag = pvTaskGetThreadLocalStoragePointer(NULL, MAGAZINE_TLS_INDEX);
+    if (mag == NULL) {
+        // Created on first use and kept for the life of the task.
+        mag = heap_caps_calloc(1, sizeof(task_magazine_t), MALLOC_CAP_INTERNAL);
+        if (mag) {
+            vTaskSetThreadLocalStoragePointer(NULL, MAGAZINE_TLS_INDEX, mag);
+        }
+    }
+    return mag;
+}
+
+void* pool_malloc_cached(int pool_index) {
+    task_magazine_t* mag = get_task_magazine();
+    if (mag == NULL) {
+        return pool_malloc(&pools[pool_index]);
+    }
+
+    if (mag->count[pool_index] > 0) {
+        magazine_stats[pool_index].cache_hits++;
+        return mag->blocks[pool_index][--mag->count[pool_index]];
+    }
+
+    magazine_stats[pool_index].cache_misses++;
+    int got = depot_alloc_batch(pool_index,
+                                mag->blocks[pool_index], MAGAZINE_REFILL);
+    if (got == 0) {
+        // Bitmap exhausted: the single-block path can still serve from
+        // extension blocks on loan from the reserve.
+        return pool_malloc(&pools[pool_index]);
+    }
+    magazine_stats[pool_index].refills++;
+    mag->count[pool_index] = got;
+    return mag->blocks[pool_index][--mag->count[pool_index]];
+}
+
+void pool_free_cached(int pool_index, void* ptr) {
+    task_magazine_t* mag = get_task_magazine();
+    if (mag == NULL) {
+        pool_free(&pools[pool_index], ptr);
+        return;
+    }
+
+    if (mag->count[pool_index] >= MAGAZINE_CAPACITY) {
+        // Stash full: flush a batch back to the shared pool in one lock.
+        magazine_stats[pool_index].flushes++;
+        mag->count[pool_index] -= MAGAZINE_REFILL;
+        depot_free_batch(pool_index,
+                         &mag->blocks[pool_index][mag->count[pool_index]],
+                         MAGAZINE_REFILL);
+    }
+    mag->blocks[pool_index][mag->count[pool_index]++] = ptr;
+}
+
+// === ISR-safe allocation path ===
+// pool_malloc blocks on a mutex, which is illegal from interrupt context.
+// Each pool therefore carves out a small reserve of blocks at startup and
+// threads them on a lock-free freelist: pop and push are a compare-and-swap
+// on the head pointer, so an ISR gets (or returns) a block in bounded time.
+// The reserve is only ever popped from ISRs and refilled from task context,
+// which keeps the classic ABA window out of the picture for this demo.
+#define ISR_RESERVE_BLOCKS  4
+
+typedef struct {
+    _Atomic(memory_block_t*) head;
+    uint32_t isr_allocations;
+    uint32_t isr_failures;
+} isr_freelist_t;
+
+static isr_freelist_t isr_reserve[POOL_COUNT];
+
+static void init_isr_reserve(int pool_index) {
+    void* blocks[ISR_RESERVE_BLOCKS];
+    int got = pool_malloc_batch(&pools[pool_index], blocks, ISR_RESERVE_BLOCKS);
+    for (int i = 0; i < got; i++) {
+        memory_block_t* block = (memory_block_t*)((uint8_t*)blocks[i] - sizeof(memory_block_t));
+        memory_block_t* old_head;
+        do {
+            old_head = atomic_load(&isr_reserve[pool_index].head);
+            block->next = old_head;
+        } while (!atomic_compare_exchange_weak(&isr_reserve[pool_index].head,
+                                               &old_head, block));
+    }
+    ESP_LOGI(TAG, "ISR reserve for %s pool: %d blocks", pools[pool_index].name, got);
+}
+
+void* IRAM_ATTR pool_malloc_from_isr(int pool_index) {
+    isr_freelist_t* list = &isr_reserve[pool_index];
+    memory_block_t* head;
+    do {
+        head = atomic_load(&list->head);
+        if (head == NULL) {
+            list->isr_failures++;
+            return NULL;
+        }
+    } while (!atomic_compare_exchange_weak(&list->head, &head, head->next));
+    list->isr_allocations++;
+    return (uint8_t*)head + sizeof(memory_block_t);
+}
+
+void IRAM_ATTR pool_free_from_isr(int pool_index, void* ptr) {
+    if (ptr == NULL) return;
+    isr_freelist_t* list = &isr_reserve[pool_index];
+    memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
+    memory_block_t* old_head;
+    do {
+        old_head = atomic_load(&list->head);
+        block->next = old_head;
+    } while (!atomic_compare_exchange_weak(&list->head, &old_head, block));
+}
+
+// Validation: a gptimer alarm fires at 1 kHz and allocates/frees a small
+// block entirely from the ISR, mirroring a DMA-complete handler.
+static gptimer_handle_t isr_alloc_timer = NULL;
+
+static bool IRAM_ATTR isr_alloc_test_callback(gptimer_handle_t timer,
+                                              const gptimer_alarm_event_data_t *edata,
+                                              void *user_data) {
+    void* ptr = pool_malloc_from_isr(POOL_SMALL);
+    if (ptr) {
+        ((uint8_t*)ptr)[0] = 0xA5;   // touch the block
+        pool_free_from_isr(POOL_SMALL, ptr);
+    }
+    return false;
+}
+
+static void start_isr_alloc_test(void) {
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,   // 1 MHz
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &isr_alloc_timer));
+
+    gptimer_event_callbacks_t cbs = { .on_alarm = isr_alloc_test_callback };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(isr_alloc_timer, &cbs, NULL));
+    ESP_ERROR_CHECK(gptimer_enable(isr_alloc_timer));
+
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = 1000,        // 1 ms period
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(isr_alloc_timer, &alarm_config));
+    ESP_ERROR_CHECK(gptimer_start(isr_alloc_timer));
+    ESP_LOGI(TAG, "ISR allocation test timer started (1 kHz)");
 }
 
 // === Smart Allocator ===
 void* smart_pool_malloc(size_t size) {
     size_t required = size + 16;
-    for (int i = 0; i < POOL_COUNT; i++) {
-        if (required <= pools[i].block_size) {
-            void* ptr = pool_malloc(&pools[i]);
+    // O(1): request size maps straight to its pool via the size-class table;
+    // larger pools are only tried when the preferred one is exhausted.
+    int first = size_to_pool(required);
+    if (first >= 0) {
+        for (int i = first; i < POOL_COUNT; i++) {
+            void* ptr = pool_malloc_cached(i);
             if (ptr) {
+                // LED marks the serving pool but no longer blinks from
+                // inside the allocation path: the old 30 ms delay here
+                // swamped any latency measurement of this function. The
+                // monitor's cadence makes the level changes visible.
                 gpio_set_level(pool_configs[i].led_pin, 1);
-                vTaskDelay(pdMS_TO_TICKS(30));
-                gpio_set_level(pool_configs[i].led_pin, 0);
                 return ptr;
             }
         }
@@ -196,47 +760,576 @@ void* smart_pool_malloc(size_t size) {
 }
 
 bool smart_pool_free(void* ptr) {
+    if (!ptr) return false;
+    // Constant-time: an address-range check per pool (POOL_COUNT is fixed)
+    // replaces the old probe that took every pool's mutex in turn.
+    if (reserve_owns(ptr)) {
+        extension_free_block(ptr);
+        return true;
+    }
     for (int i = 0; i < POOL_COUNT; i++) {
-        if (pool_free(&pools[i], ptr)) return true;
+        if (pool_owns(&pools[i], ptr)) {
+            pool_free_cached(i, ptr);
+            return true;
+        }
     }
     heap_caps_free(ptr);
     return true;
 }
 
+// === Scheduler-suspend batching ===
+// Composite state that spans several structures — all four pools' stats
+// plus the magazine and depot counters — used to be read piecemeal,
+// which either meant four mutex round-trips or a snapshot whose halves
+// came from different moments. A batch region suspends the scheduler
+// instead: one suspend/resume covers the whole composite read or
+// update, no lock is touched, and nothing on this core can preempt in
+// the middle. Two rules keep it safe: no blocking call inside a region
+// (the scheduler is off — a mutex take would deadlock), and the region
+// must fit the cycle budget, which the end call enforces by flagging
+// and counting any overrun so a region can't quietly grow into a
+// latency hazard. On this dual-core port the suspend covers only the
+// calling core's scheduler; the budget, not cross-core atomicity, is
+// what keeps the window small enough that tearing stops showing up.
+#define BATCH_BUDGET_CYCLES  2400   // ~10 us at 240 MHz
+
+typedef struct {
+    uint32_t regions;
+    uint32_t overruns;
+    uint32_t worst_cycles;
+    const char* worst_site;
+} batch_region_stats_t;
+
+static batch_region_stats_t batch_region_stats;
+static uint32_t batch_region_t0;
+static const char* batch_region_site;
+
+static void batch_update_begin(const char* site) {
+    vTaskSuspendAll();
+    batch_region_site = site;
+    batch_region_t0 = esp_cpu_get_cycle_count();
+}
+
+static void batch_update_end(void) {
+    uint32_t cycles = esp_cpu_get_cycle_count() - batch_region_t0;
+    const char* site = batch_region_site;
+    xTaskResumeAll();
+
+    batch_region_stats.regions++;
+    if (cycles > batch_region_stats.worst_cycles) {
+        batch_region_stats.worst_cycles = cycles;
+        batch_region_stats.worst_site = site;
+    }
+    if (cycles > BATCH_BUDGET_CYCLES) {
+        batch_region_stats.overruns++;
+        ESP_LOGW(TAG, "⏸️ Batch region '%s' over budget: %lu cycles (budget %d)",
+                 site, cycles, BATCH_BUDGET_CYCLES);
+    }
+}
+
+static void batch_region_report(void) {
+    ESP_LOGI(TAG, "⏸️ Batch regions: %lu, worst %lu cycles (%s), %lu over budget",
+             batch_region_stats.regions, batch_region_stats.worst_cycles,
+             batch_region_stats.worst_site ? batch_region_stats.worst_site : "-",
+             batch_region_stats.overruns);
+}
+
+// === Adaptive reserve and pool tuner ===
+// Static block counts are chronically misprovisioned: some pools light
+// LED_POOL_FULL while others sit mostly idle. The reserve is a small
+// shared region carved into chunks big enough for any of the first
+// three size classes. A tuner pass (riding the monitor interval) lends
+// chunks to whichever pool reported exhaustion since the last pass and
+// reclaims idle loans back into the reserve, so capacity follows demand
+// instead of compile-time guesses. Blocks on loan live on a per-pool
+// extension list that pool_malloc falls back to when the bitmap is
+// full.
+#define RESERVE_CHUNKS        8
+#define RESERVE_LEND_PER_PASS 2
+
+typedef struct {
+    int lent_to;                      // pool index, -1 = in reserve
+} reserve_chunk_t;
+
+static size_t reserve_chunk_size;     // = Large pool total_block_size
+static uint8_t* reserve_region = NULL;
+static reserve_chunk_t reserve_chunks[RESERVE_CHUNKS];
+static uint32_t reserve_lends = 0;
+static uint32_t reserve_reclaims = 0;
+static uint32_t tuner_last_failures[POOL_COUNT];
+
+static inline memory_block_t* reserve_chunk_block(int chunk) {
+    return (memory_block_t*)(reserve_region + (size_t)chunk * reserve_chunk_size);
+}
+
+static inline bool reserve_owns(void* ptr) {
+    return reserve_region != NULL &&
+           (uint8_t*)ptr >= reserve_region &&
+           (uint8_t*)ptr < reserve_region + (size_t)RESERVE_CHUNKS * reserve_chunk_size;
+}
+
+static void reserve_init(void) {
+    reserve_chunk_size = pools[POOL_LARGE].total_block_size;
+    reserve_region = heap_caps_malloc((size_t)RESERVE_CHUNKS * reserve_chunk_size,
+                                      MALLOC_CAP_DEFAULT);
+    if (reserve_region == NULL) {
+        ESP_LOGW(TAG, "Reserve region allocation failed, tuner disabled");
+        return;
+    }
+    for (int i = 0; i < RESERVE_CHUNKS; i++) {
+        reserve_chunks[i].lent_to = -1;
+        reserve_chunk_block(i)->magic = POOL_MAGIC_FREE;
+    }
+    ESP_LOGI(TAG, "✅ Reserve: %d chunks × %u bytes", RESERVE_CHUNKS,
+             (unsigned)reserve_chunk_size);
+}
+
+// Lend one free reserve chunk to `pool_index`; chunks fit any class up
+// to Large. Returns false when the reserve is empty.
+static bool reserve_lend(int pool_index) {
+    memory_pool_t* pool = &pools[pool_index];
+    for (int i = 0; i < RESERVE_CHUNKS; i++) {
+        if (reserve_chunks[i].lent_to != -1) continue;
+
+        memory_block_t* block = reserve_chunk_block(i);
+        block->magic = POOL_MAGIC_FREE;
+        block->pool_id = pool->pool_id;
+#if POOL_REDZONE_DEBUG
+        // Redzone placement follows the borrowing pool's geometry.
+        redzone_poison(pool, block);
+#endif
+
+        if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) != pdTRUE) return false;
+        block->next = pool->extension_list;
+        pool->extension_list = block;
+        pool->extension_free++;
+        xSemaphoreGive(pool->mutex);
+
+        reserve_chunks[i].lent_to = pool_index;
+        reserve_lends++;
+        ESP_LOGI(TAG, "📈 Reserve chunk %d lent to %s pool", i, pool->name);
+        return true;
+    }
+    return false;
+}
+
+// Take one idle extension block back from `pool_index` into the reserve.
+static bool reserve_reclaim(int pool_index) {
+    memory_pool_t* pool = &pools[pool_index];
+    memory_block_t* block = NULL;
+
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) != pdTRUE) return false;
+    if (pool->extension_list != NULL) {
+        block = pool->extension_list;
+        pool->extension_list = block->next;
+        pool->extension_free--;
+    }
+    xSemaphoreGive(pool->mutex);
+    if (block == NULL) return false;
+
+    int chunk = (int)(((uint8_t*)block - reserve_region) / reserve_chunk_size);
+    reserve_chunks[chunk].lent_to = -1;
+    reserve_reclaims++;
+    ESP_LOGI(TAG, "📉 Reserve chunk %d reclaimed from %s pool", chunk, pool->name);
+    return true;
+}
+
+// One tuning pass: pools that failed allocations since the last pass get
+// chunks; pools holding idle loans while under half used give them back.
+static void pool_tuner_pass(void) {
+    if (reserve_region == NULL) return;
+
+    // Read the composite failure/occupancy state in one batch region so
+    // every delta is from the same instant; the lend/reclaim calls stay
+    // outside (they take pool mutexes, forbidden under suspend).
+    uint32_t failures_delta[POOL_COUNT];
+    int allocated_now[POOL_COUNT];
+    uint32_t extension_free_now[POOL_COUNT];
+    batch_update_begin("tuner-pass");
+    for (int i = 0; i <= POOL_LARGE; i++) {   // Huge blocks exceed chunk size
+        failures_delta[i] = pools[i].allocation_failures - tuner_last_failures[i];
+        tuner_last_failures[i] = pools[i].allocation_failures;
+        allocated_now[i] = pools[i].allocated_blocks;
+        extension_free_now[i] = pools[i].extension_free;
+    }
+    batch_update_end();
+
+    for (int i = 0; i <= POOL_LARGE; i++) {
+        if (failures_delta[i] > 0) {
+            for (int n = 0; n < RESERVE_LEND_PER_PASS; n++) {
+                if (!reserve_lend(i)) break;
+            }
+        } else if (extension_free_now[i] > 0 &&
+                   allocated_now[i] < pools[i].block_count / 2) {
+            reserve_reclaim(i);
+        }
+    }
+}
+
+// Free an extension block back onto its pool's loan list.
+static void extension_free_block(void* ptr) {
+    memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - sizeof(memory_block_t));
+    memory_pool_t* pool = &pools[block->pool_id - 1];
+
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+#if POOL_REDZONE_DEBUG
+        if (!redzone_ok(pool, block)) {
+            redzone_violation(pool, block, "extension free");
+        }
+#endif
+        block->magic = POOL_MAGIC_FREE;
+        block->next = pool->extension_list;
+        pool->extension_list = block;
+        pool->extension_free++;
+        pool->allocated_blocks--;
+        pool->total_deallocations++;
+        xSemaphoreGive(pool->mutex);
+    }
+}
+
+// === Background integrity scrubber ===
+// Validation moved off the alloc/free path lives here instead: a
+// low-priority task sweeps a few blocks per pass and checks each one's
+// magic against the usage bitmap — an allocated bit with a free (or
+// garbage) magic, or a free bit with anything but POOL_MAGIC_FREE,
+// means someone scribbled over a header or double-freed. Each slice
+// holds the pool mutex only for its handful of blocks, so the sweep is
+// invisible to allocators.
+#define SCRUB_BLOCKS_PER_PASS   8
+#define SCRUB_PASS_INTERVAL_MS  100
+
+static uint32_t scrub_blocks_scanned = 0;
+static uint32_t scrub_errors = 0;
+
+static void scrub_pool_slice(memory_pool_t* pool, size_t start, size_t count) {
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(20)) != pdTRUE) {
+        return;   // contended: skip this slice, the cursor catches it next lap
+    }
+    for (size_t i = start; i < start + count && i < pool->block_count; i++) {
+        memory_block_t* block = block_at(pool, (int)i);
+        bool allocated = (pool->usage_bitmap[i / 32] >> (i % 32)) & 1;
+        uint32_t expect = allocated ? POOL_MAGIC_ALLOC : POOL_MAGIC_FREE;
+        if (block->magic != expect || block->pool_id != pool->pool_id) {
+            scrub_errors++;
+            gpio_set_level(LED_POOL_ERROR, 1);
+            ESP_LOGE(TAG, "🧹 %s pool block %u corrupt: magic=0x%08lX (%s), pool_id=%lu",
+                     pool->name, (unsigned)i, block->magic,
+                     allocated ? "allocated" : "free", block->pool_id);
+            block->magic = expect;   // repair so one fault logs once
+        }
+#if POOL_REDZONE_DEBUG
+        // Redzones guard payload tails; the scrubber catches overruns
+        // in long-lived allocations that never reach a free.
+        if (!redzone_ok(pool, block)) {
+            scrub_errors++;
+            redzone_violation(pool, block, "scrub");
+        }
+#endif
+        scrub_blocks_scanned++;
+    }
+    xSemaphoreGive(pool->mutex);
+}
+
+void pool_scrubber_task(void *pv) {
+    int pool_cursor = 0;
+    size_t block_cursor = 0;
+
+    ESP_LOGI(TAG, "🧹 Pool scrubber started (%d blocks per %d ms pass)",
+             SCRUB_BLOCKS_PER_PASS, SCRUB_PASS_INTERVAL_MS);
+    while (1) {
+        memory_pool_t* pool = &pools[pool_cursor];
+        scrub_pool_slice(pool, block_cursor, SCRUB_BLOCKS_PER_PASS);
+
+        block_cursor += SCRUB_BLOCKS_PER_PASS;
+        if (block_cursor >= pool->block_count) {
+            block_cursor = 0;
+            pool_cursor = (pool_cursor + 1) % POOL_COUNT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(SCRUB_PASS_INTERVAL_MS));
+    }
+}
+
+// === Fault-injection engine ===
+// pool_stress_task exercises the happy path: steady paced allocs and
+// frees that rarely touch a limit. Incidents do not look like that —
+// they look like a burst that empties a pool while frees arrive late.
+// The engine below loops a script of fault phases against the live
+// allocator: EXHAUST grabs and holds most of a pool's blocks, BURST
+// hammers alloc/free trains with no pacing, DELAYED_FREE makes the
+// stress task sit on its blocks before returning them. Throughout, the
+// stress task's allocation latency lands in power-of-two buckets, and
+// the engine prints a degradation report when each phase ends —
+// throughput, failure rate and p50/p99/max under that phase's
+// pressure, not just a lit error LED.
+typedef enum {
+    FINJ_BASELINE = 0,
+    FINJ_EXHAUST,        // hold `intensity` blocks of `pool` for the phase
+    FINJ_BURST,          // trains of `intensity` back-to-back allocs
+    FINJ_DELAYED_FREE,   // stress task holds blocks `intensity` ms extra
+} finj_op_t;
+
+typedef struct {
+    finj_op_t op;
+    int pool;            // target pool; -1 when the op has none
+    uint32_t intensity;
+    uint32_t duration_ms;
+} finj_step_t;
+
+// The script: a clean baseline first so every later report has a
+// reference, then each fault class in turn. Intensities are sized
+// against the pool geometries above (e.g. 28 of the Small pool's 32
+// blocks held leaves the stress task four, plus whatever the tuner
+// lends).
+static const finj_step_t finj_script[] = {
+    { FINJ_BASELINE,     -1,           0, 20000 },
+    { FINJ_EXHAUST,      POOL_SMALL,  28, 15000 },
+    { FINJ_BURST,        POOL_MEDIUM, 24, 10000 },
+    { FINJ_DELAYED_FREE, -1,        2000, 15000 },
+    { FINJ_EXHAUST,      POOL_MEDIUM, 14, 15000 },
+};
+#define FINJ_STEPS (sizeof(finj_script) / sizeof(finj_script[0]))
+
+static const char* finj_op_names[] = {
+    "baseline", "exhaust", "burst", "delayed-free",
+};
+
+// Live knob read by pool_stress_task before every free.
+static volatile uint32_t finj_free_delay_ms = 0;
+
+// Allocation latency under the current phase; filled by the stress
+// task, reported and reset by the engine at each phase boundary.
+#define FINJ_BUCKETS 20
+
+static struct {
+    uint32_t buckets[FINJ_BUCKETS];   // [2^i, 2^(i+1)) us
+    uint32_t count;
+    uint32_t failures;
+    uint32_t max_us;
+} finj_lat;
+
+// Frees the engine issued that the allocator refused. pool_free routes
+// reserve extension blocks itself, so any reject here is a real bug —
+// it must land in the phase report, not vanish into a dropped bool.
+static uint32_t finj_free_rejects = 0;
+
+static void finj_free_held(int pool, void** held, int n) {
+    for (int i = 0; i < n; i++) {
+        if (!pool_free(&pools[pool], held[i])) {
+            finj_free_rejects++;
+            ESP_LOGE(TAG, "💉 %s pool refused free of %p",
+                     pools[pool].name, held[i]);
+        }
+    }
+}
+
+static void finj_lat_record(uint32_t us, bool failed) {
+    int bucket = us ? 31 - __builtin_clz(us) : 0;
+    if (bucket >= FINJ_BUCKETS) bucket = FINJ_BUCKETS - 1;
+    finj_lat.buckets[bucket]++;
+    finj_lat.count++;
+    if (failed) finj_lat.failures++;
+    if (us > finj_lat.max_us) finj_lat.max_us = us;
+}
+
+static uint32_t finj_lat_percentile(uint32_t percent) {
+    if (finj_lat.count == 0) return 0;
+    uint32_t rank = (uint64_t)finj_lat.count * percent / 100;
+    uint32_t cumulative = 0;
+    for (int i = 0; i < FINJ_BUCKETS; i++) {
+        cumulative += finj_lat.buckets[i];
+        if (cumulative > rank) return 2u << i;
+    }
+    return 2u << (FINJ_BUCKETS - 1);
+}
+
+static void finj_phase_report(const finj_step_t* s) {
+    float secs = s->duration_ms / 1000.0f;
+    ESP_LOGI(TAG, "💉 Phase '%s' done: %lu allocs (%.1f/s) | %lu failures (%.1f%%) | p50=%luus p99=%luus max=%luus",
+             finj_op_names[s->op], finj_lat.count,
+             secs > 0 ? finj_lat.count / secs : 0.0f,
+             finj_lat.failures,
+             finj_lat.count ? finj_lat.failures * 100.0f / finj_lat.count : 0.0f,
+             finj_lat_percentile(50), finj_lat_percentile(99),
+             finj_lat.max_us);
+    if (finj_free_rejects > 0) {
+        ESP_LOGE(TAG, "💉 %lu held block(s) refused on free — reserve capacity leaking",
+                 finj_free_rejects);
+    }
+    memset(&finj_lat, 0, sizeof(finj_lat));
+}
+
+void fault_injection_task(void *pv) {
+    // Let the pools, tuner and stress task settle into steady state so
+    // the baseline phase measures the real happy path.
+    vTaskDelay(pdMS_TO_TICKS(15000));
+    ESP_LOGI(TAG, "💉 Fault-injection engine started (%u-phase script)",
+             (unsigned)FINJ_STEPS);
+
+    void* held[32];
+    int step_idx = 0;
+    while (1) {
+        const finj_step_t* s = &finj_script[step_idx];
+        ESP_LOGW(TAG, "💉 Entering phase '%s' (pool=%s, intensity=%lu, %lus)",
+                 finj_op_names[s->op],
+                 s->pool >= 0 ? pools[s->pool].name : "-",
+                 s->intensity, s->duration_ms / 1000);
+        memset(&finj_lat, 0, sizeof(finj_lat));
+
+        switch (s->op) {
+        case FINJ_BASELINE:
+            vTaskDelay(pdMS_TO_TICKS(s->duration_ms));
+            break;
+
+        case FINJ_EXHAUST: {
+            // Grab and hold: the stress task now fights over the few
+            // blocks left (plus whatever the tuner lends under us).
+            int held_n = 0;
+            for (uint32_t i = 0; i < s->intensity && held_n < 32; i++) {
+                void* p = pool_malloc(&pools[s->pool]);
+                if (p == NULL) break;
+                held[held_n++] = p;
+            }
+            ESP_LOGW(TAG, "💉 Holding %d/%lu %s blocks",
+                     held_n, s->intensity, pools[s->pool].name);
+            vTaskDelay(pdMS_TO_TICKS(s->duration_ms));
+            finj_free_held(s->pool, held, held_n);
+            break;
+        }
+
+        case FINJ_BURST: {
+            // Queue-full shape: trains of back-to-back allocations with
+            // no pacing, released together, repeated for the phase.
+            uint64_t t_end = esp_timer_get_time() + (uint64_t)s->duration_ms * 1000;
+            while (esp_timer_get_time() < t_end) {
+                int n = 0;
+                for (uint32_t i = 0; i < s->intensity && n < 32; i++) {
+                    void* p = pool_malloc(&pools[s->pool]);
+                    if (p == NULL) break;
+                    held[n++] = p;
+                }
+                finj_free_held(s->pool, held, n);
+                vTaskDelay(pdMS_TO_TICKS(20));
+            }
+            break;
+        }
+
+        case FINJ_DELAYED_FREE:
+            finj_free_delay_ms = s->intensity;
+            vTaskDelay(pdMS_TO_TICKS(s->duration_ms));
+            finj_free_delay_ms = 0;
+            break;
+        }
+
+        finj_phase_report(s);
+        step_idx = (step_idx + 1) % FINJ_STEPS;
+    }
+}
+
 // === Monitor ===
+// One batch region captures every counter the report needs at a single
+// instant; the four per-pool mutex takes this replaced are gone, and
+// the printed numbers can no longer disagree with each other.
+typedef struct {
+    int allocated[POOL_COUNT];
+    int failures[POOL_COUNT];
+    magazine_stats_t mags[POOL_COUNT];
+    uint32_t depot_local[portNUM_PROCESSORS];
+    uint32_t depot_dry[portNUM_PROCESSORS];
+    uint32_t depot_spills[portNUM_PROCESSORS];
+} pool_stats_snapshot_t;
+
+static void capture_pool_snapshot(pool_stats_snapshot_t* snap) {
+    batch_update_begin("stats-snapshot");
+    for (int i = 0; i < POOL_COUNT; i++) {
+        snap->allocated[i] = pools[i].allocated_blocks;
+        snap->failures[i] = pools[i].allocation_failures;
+        snap->mags[i] = magazine_stats[i];
+    }
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        uint32_t local = 0, dry = 0, spills = 0;
+        for (int i = 0; i < POOL_COUNT; i++) {
+            local += core_depots[c][i].local_hits;
+            dry += core_depots[c][i].dry_refills;
+            spills += core_depots[c][i].spills;
+        }
+        snap->depot_local[c] = local;
+        snap->depot_dry[c] = dry;
+        snap->depot_spills[c] = spills;
+    }
+    batch_update_end();
+}
+
 void print_pool_statistics(void) {
+    pool_stats_snapshot_t snap;
+    capture_pool_snapshot(&snap);
+
     ESP_LOGI(TAG, "\n📊 === POOL STATUS ===");
     for (int i = 0; i < POOL_COUNT; i++) {
-        memory_pool_t* p = &pools[i];
-        ESP_LOGI(TAG, "%s: %d/%d used | Failures: %d", 
-                 p->name, p->allocated_blocks, p->block_count, p->allocation_failures);
+        magazine_stats_t* m = &snap.mags[i];
+        uint32_t lookups = m->cache_hits + m->cache_misses;
+        ESP_LOGI(TAG, "%s: %d/%d used | Failures: %d | Cache: %.1f%% hit, %lu refills, %lu flushes",
+                 pools[i].name, snap.allocated[i], pools[i].block_count, snap.failures[i],
+                 lookups ? (float)m->cache_hits * 100.0f / lookups : 0.0f,
+                 m->refills, m->flushes);
     }
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        ESP_LOGI(TAG, "Core %d depot: %lu local batches, %lu dry refills, %lu spills",
+                 c, snap.depot_local[c], snap.depot_dry[c], snap.depot_spills[c]);
+    }
+    batch_region_report();
 }
 
 void pool_monitor_task(void *pv) {
     while (1) {
         vTaskDelay(pdMS_TO_TICKS(10000));
+        // Re-arm the activity LEDs pulsed by smart_pool_malloc.
+        gpio_set_level(LED_SMALL_POOL, 0);
+        gpio_set_level(LED_MEDIUM_POOL, 0);
+        gpio_set_level(LED_LARGE_POOL, 0);
+        pool_tuner_pass();
         print_pool_statistics();
+        ESP_LOGI(TAG, "ISR reserve: %lu allocations, %lu failures",
+                 isr_reserve[POOL_SMALL].isr_allocations,
+                 isr_reserve[POOL_SMALL].isr_failures);
+        ESP_LOGI(TAG, "Scrubber: %lu blocks scanned, %lu errors",
+                 scrub_blocks_scanned, scrub_errors);
+#if POOL_REDZONE_DEBUG
+        ESP_LOGI(TAG, "Redzones: %u bytes/block, %lu violations",
+                 (unsigned)REDZONE_BYTES, redzone_violations);
+#endif
+        ESP_LOGI(TAG, "Reserve: %lu lends, %lu reclaims", reserve_lends, reserve_reclaims);
         ESP_LOGI(TAG, "Free heap: %d bytes", esp_get_free_heap_size());
+        flash_stall_probe();
+        hot_func_report();
     }
 }
 
 void pool_stress_task(void *pv) {
     void* ptrs[50] = {0};
+    uint64_t hold_until[50] = {0};
     int count = 0;
     while (1) {
         int action = esp_random() % 3;
         if (action == 0 && count < 50) {
             size_t sz = 32 + (esp_random() % 2000);
-            ptrs[count++] = smart_pool_malloc(sz);
+            uint64_t t0 = esp_timer_get_time();
+            void* p = smart_pool_malloc(sz);
+            finj_lat_record((uint32_t)(esp_timer_get_time() - t0), p == NULL);
+            if (p) {
+                // Under delayed-free injection, blocks sit on the shelf
+                // past their natural lifetime before they may go back.
+                hold_until[count] = esp_timer_get_time() +
+                                    (uint64_t)finj_free_delay_ms * 1000;
+                ptrs[count++] = p;
+            }
         } else if (action == 1 && count > 0) {
             int idx = esp_random() % count;
-            if (ptrs[idx]) {
+            if (ptrs[idx] && esp_timer_get_time() >= hold_until[idx]) {
                 smart_pool_free(ptrs[idx]);
                 ptrs[idx] = NULL;
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(500));
+        vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
 
@@ -249,6 +1342,7 @@ void app_main(void) {
     gpio_set_direction(LED_POOL_FULL, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_POOL_ERROR, GPIO_MODE_OUTPUT);
 
+    build_size_class_table();
     for (int i = 0; i < POOL_COUNT; i++) {
         if (!init_memory_pool(&pools[i], &pool_configs[i], i + 1)) {
             ESP_LOGE(TAG, "Failed to init %s pool", pool_configs[i].name);
@@ -256,10 +1350,23 @@ void app_main(void) {
         }
     }
     pools_initialized = true;
+
+    // The measured-hot allocator entry points; the report flags any
+    // that lose their placement.
+    HOT_FUNC_REGISTER(pool_malloc);
+    HOT_FUNC_REGISTER(pool_free);
+    HOT_FUNC_REGISTER(pool_malloc_from_isr);
+    HOT_FUNC_REGISTER(pool_free_from_isr);
+
+    reserve_init();
+    init_isr_reserve(POOL_SMALL);
+    start_isr_alloc_test();
     print_pool_statistics();
 
     xTaskCreate(pool_monitor_task, "PoolMonitor", 4096, NULL, 5, NULL);
+    xTaskCreate(pool_scrubber_task, "PoolScrub", 3072, NULL, 1, NULL);
     xTaskCreate(pool_stress_task, "PoolStress", 4096, NULL, 4, NULL);
+    xTaskCreate(fault_injection_task, "FaultInject", 3072, NULL, 4, NULL);
     ESP_LOGI(TAG, "✅ All tasks created successfully");
 }
     
\ No newline at end of file
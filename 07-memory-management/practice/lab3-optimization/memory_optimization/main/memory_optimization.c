@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -14,6 +15,7 @@
 #include "driver/gpio.h"
 #include "soc/soc_memory_layout.h"
 #include "esp_random.h"  // ✅ ต้องใส่เพิ่มใน ESP-IDF 5.2+
+#include "pmu.h"
 
 static const char *TAG = "MEM_OPT";
 
@@ -35,8 +37,21 @@ static const char *TAG = "MEM_OPT";
 #define MAX_TASKS            4
 
 static uint8_t static_buffers[STATIC_BUFFER_COUNT][STATIC_BUFFER_SIZE] __attribute__((aligned(4)));
-static bool static_buffer_used[STATIC_BUFFER_COUNT] = {false};
-static SemaphoreHandle_t static_buffer_mutex;
+
+// Generation-counted buffer handles.
+//
+// A handle packs the slot index (low 8 bits) with the slot's generation
+// (upper 24 bits). Every release bumps the generation, so a stale handle
+// — double free or use-after-free — fails validation in O(1) instead of
+// silently corrupting a recycled buffer. Acquire and release run on an
+// atomic free bitmap, no mutex on the fast path.
+typedef uint32_t buf_handle_t;
+#define BUF_HANDLE_INVALID 0
+#define BUF_GEN_SHIFT      8
+#define BUF_INDEX_MASK     0xFFu
+
+static atomic_uint_fast32_t buffer_free_bitmap = (1u << STATIC_BUFFER_COUNT) - 1;
+static atomic_uint_fast32_t buffer_generations[STATIC_BUFFER_COUNT];
 
 static StackType_t task_stacks[MAX_TASKS][TASK_STACK_SIZE] __attribute__((aligned(8)));
 static StaticTask_t task_buffers[MAX_TASKS];
@@ -55,6 +70,36 @@ typedef struct {
 
 static optimization_stats_t opt_stats = {0};
 
+// ---- Seqlock publication for opt_stats ----
+// The monitor task reads this multi-word struct while the test task
+// updates it; without protection the 64-bit field can tear mid-read,
+// and a mutex would serialize the monitor against the benchmark loop it
+// is trying to observe. Seqlock instead: every writer bumps the
+// sequence to odd, mutates, bumps back to even; the reader copies the
+// struct between two sequence loads and retries on mismatch. Reader
+// cost is two loads plus a memcpy and the writer never waits.
+static atomic_uint_fast32_t opt_stats_seq = 0;
+static uint32_t opt_stats_read_retries = 0;
+
+// All opt_stats mutations go through this so the sequence always brackets them.
+#define OPT_STAT_ADD(field, amount)                                            \
+    do {                                                                       \
+        atomic_fetch_add_explicit(&opt_stats_seq, 1, memory_order_release);    \
+        opt_stats.field += (amount);                                           \
+        atomic_fetch_add_explicit(&opt_stats_seq, 1, memory_order_release);    \
+    } while (0)
+
+static void opt_stats_read(optimization_stats_t *out) {
+    while (1) {
+        uint_fast32_t v1 = atomic_load_explicit(&opt_stats_seq, memory_order_acquire);
+        if (v1 & 1) { opt_stats_read_retries++; continue; }
+        *out = opt_stats;
+        uint_fast32_t v2 = atomic_load_explicit(&opt_stats_seq, memory_order_acquire);
+        if (v1 == v2) return;
+        opt_stats_read_retries++;
+    }
+}
+
 // Struct examples
 typedef struct {
     char a;
@@ -79,41 +124,215 @@ typedef struct {
     bool dma;
 } mem_region_t;
 
-// Static buffer allocation/free
-void* allocate_static_buffer(void) {
-    void* buffer = NULL;
-    if (xSemaphoreTake(static_buffer_mutex, pdMS_TO_TICKS(100))) {
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
-            if (!static_buffer_used[i]) {
-                static_buffer_used[i] = true;
-                buffer = static_buffers[i];
-                opt_stats.static_allocations++;
-                gpio_set_level(LED_STATIC_ALLOC, 1);
-                break;
+// ---- Struct layout audit ----
+//
+// sizeof alone hides where the bytes go. The registry records each
+// registered struct's field offsets and sizes (via offsetof, so the
+// numbers are the compiler's own), and the report walks them flagging
+// padding holes and false-sharing risk — two hot fields landing in one
+// cache line of a struct that different cores touch. Run it in the
+// perf logs and a layout regression shows up as a diff, not a field
+// incident.
+#define LAYOUT_MAX_STRUCTS 6
+#define LAYOUT_MAX_FIELDS  8
+#define LAYOUT_CACHE_LINE  32   // ESP32 cache line
+
+typedef struct {
+    const char *name;
+    size_t offset;
+    size_t size;
+    bool hot;                   // touched on fast paths
+} layout_field_t;
+
+typedef struct {
+    const char *struct_name;
+    size_t struct_size;
+    layout_field_t fields[LAYOUT_MAX_FIELDS];
+    int field_count;
+} layout_entry_t;
+
+static layout_entry_t layout_registry[LAYOUT_MAX_STRUCTS];
+static int layout_registry_count = 0;
+
+static layout_entry_t* layout_register(const char *struct_name, size_t size) {
+    if (layout_registry_count >= LAYOUT_MAX_STRUCTS) return NULL;
+    layout_entry_t *e = &layout_registry[layout_registry_count++];
+    e->struct_name = struct_name;
+    e->struct_size = size;
+    e->field_count = 0;
+    return e;
+}
+
+static void layout_add_field(layout_entry_t *e, const char *name,
+                             size_t offset, size_t size, bool hot) {
+    if (!e || e->field_count >= LAYOUT_MAX_FIELDS) return;
+    e->fields[e->field_count++] = (layout_field_t){ name, offset, size, hot };
+}
+
+// Registration in declaration order; offsets/sizes come from the compiler.
+#define LAYOUT_REGISTER(type) layout_register(#type, sizeof(type))
+#define LAYOUT_FIELD(entry, type, field, hot) \
+    layout_add_field((entry), #field, offsetof(type, field), \
+                     sizeof(((type*)0)->field), (hot))
+
+static void layout_audit_report(void) {
+    ESP_LOGI(TAG, "\n🔎 STRUCT LAYOUT AUDIT (%d structs)", layout_registry_count);
+    for (int i = 0; i < layout_registry_count; i++) {
+        layout_entry_t *e = &layout_registry[i];
+        size_t padding = 0;
+        ESP_LOGI(TAG, "%s: %u bytes", e->struct_name, (unsigned)e->struct_size);
+
+        for (int f = 0; f < e->field_count; f++) {
+            layout_field_t *fld = &e->fields[f];
+            size_t end = fld->offset + fld->size;
+            size_t next = (f + 1 < e->field_count) ? e->fields[f + 1].offset
+                                                   : e->struct_size;
+            size_t hole = next > end ? next - end : 0;
+            padding += hole;
+            ESP_LOGI(TAG, "  %-16s off=%-3u size=%-3u%s%s",
+                     fld->name, (unsigned)fld->offset, (unsigned)fld->size,
+                     fld->hot ? " [hot]" : "",
+                     hole ? " ⚠️ padding follows" : "");
+            if (hole) {
+                ESP_LOGW(TAG, "    %u-byte hole after %s", (unsigned)hole, fld->name);
             }
         }
-        xSemaphoreGive(static_buffer_mutex);
+
+        // Two hot fields in one cache line: fine on one core, false
+        // sharing if this struct is touched from both.
+        for (int a = 0; a < e->field_count; a++) {
+            for (int b = a + 1; b < e->field_count; b++) {
+                if (e->fields[a].hot && e->fields[b].hot &&
+                    e->fields[a].offset / LAYOUT_CACHE_LINE ==
+                    e->fields[b].offset / LAYOUT_CACHE_LINE) {
+                    ESP_LOGW(TAG, "  ⚠️ %s and %s share a cache line (false-sharing risk)",
+                             e->fields[a].name, e->fields[b].name);
+                }
+            }
+        }
+
+        if (padding) {
+            ESP_LOGW(TAG, "  Total padding: %u bytes (%.1f%% of struct)",
+                     (unsigned)padding, 100.0f * padding / e->struct_size);
+            OPT_STAT_ADD(packing_optimizations, 1);
+        } else {
+            ESP_LOGI(TAG, "  No padding holes ✅");
+        }
     }
-    return buffer;
+}
+
+static void layout_audit_init(void) {
+    layout_entry_t *e;
+
+    e = LAYOUT_REGISTER(bad_struct_t);
+    LAYOUT_FIELD(e, bad_struct_t, a, false);
+    LAYOUT_FIELD(e, bad_struct_t, b, false);
+    LAYOUT_FIELD(e, bad_struct_t, c, false);
+    LAYOUT_FIELD(e, bad_struct_t, d, false);
+    LAYOUT_FIELD(e, bad_struct_t, e, false);
+
+    e = LAYOUT_REGISTER(good_struct_t);
+    LAYOUT_FIELD(e, good_struct_t, d, false);
+    LAYOUT_FIELD(e, good_struct_t, b, false);
+    LAYOUT_FIELD(e, good_struct_t, a, false);
+    LAYOUT_FIELD(e, good_struct_t, c, false);
+    LAYOUT_FIELD(e, good_struct_t, e, false);
+
+    // Stats are bumped from several tasks, so the counters that move on
+    // every allocation are the hot ones.
+    e = LAYOUT_REGISTER(optimization_stats_t);
+    LAYOUT_FIELD(e, optimization_stats_t, static_allocations, true);
+    LAYOUT_FIELD(e, optimization_stats_t, dynamic_allocations, true);
+    LAYOUT_FIELD(e, optimization_stats_t, alignment_optimizations, true);
+    LAYOUT_FIELD(e, optimization_stats_t, packing_optimizations, false);
+    LAYOUT_FIELD(e, optimization_stats_t, memory_saved_bytes, false);
+    LAYOUT_FIELD(e, optimization_stats_t, fragmentation_reduced, false);
+    LAYOUT_FIELD(e, optimization_stats_t, allocation_time_saved, false);
+}
+
+// Static buffer allocation/free
+static buf_handle_t static_buffer_acquire(void) {
+    uint_fast32_t map = atomic_load_explicit(&buffer_free_bitmap, memory_order_relaxed);
+    while (map != 0) {
+        int idx = __builtin_ctz(map);
+        uint_fast32_t bit = 1u << idx;
+        if (atomic_compare_exchange_weak_explicit(&buffer_free_bitmap, &map, map & ~bit,
+                                                  memory_order_acquire,
+                                                  memory_order_relaxed)) {
+            OPT_STAT_ADD(static_allocations, 1);
+            gpio_set_level(LED_STATIC_ALLOC, 1);
+            uint32_t gen = atomic_load_explicit(&buffer_generations[idx],
+                                                memory_order_relaxed);
+            return (gen << BUF_GEN_SHIFT) | idx;
+        }
+        // CAS reloaded map; retry with the fresh view.
+    }
+    return BUF_HANDLE_INVALID;
+}
+
+// Resolves a handle to its buffer; NULL means the handle is stale (the
+// slot has been released since) or invalid.
+static void* static_buffer_ptr(buf_handle_t h) {
+    uint32_t idx = h & BUF_INDEX_MASK;
+    if (h == BUF_HANDLE_INVALID || idx >= STATIC_BUFFER_COUNT) return NULL;
+    if ((h >> BUF_GEN_SHIFT) !=
+        atomic_load_explicit(&buffer_generations[idx], memory_order_acquire)) {
+        return NULL;
+    }
+    return static_buffers[idx];
+}
+
+// The generation CAS makes release idempotent-safe: only the holder of
+// the current generation wins, a double free loses and returns false.
+static bool static_buffer_release(buf_handle_t h) {
+    uint32_t idx = h & BUF_INDEX_MASK;
+    if (h == BUF_HANDLE_INVALID || idx >= STATIC_BUFFER_COUNT) return false;
+
+    uint_fast32_t gen = h >> BUF_GEN_SHIFT;
+    if (!atomic_compare_exchange_strong_explicit(&buffer_generations[idx],
+                                                 &gen, gen + 1,
+                                                 memory_order_acq_rel,
+                                                 memory_order_relaxed)) {
+        return false;   // stale handle: already released
+    }
+
+    uint_fast32_t map = atomic_fetch_or_explicit(&buffer_free_bitmap, 1u << idx,
+                                                 memory_order_release);
+    if ((map | (1u << idx)) == (1u << STATIC_BUFFER_COUNT) - 1) {
+        gpio_set_level(LED_STATIC_ALLOC, 0);
+    }
+    return true;
+}
+
+// Legacy pointer-based wrappers for existing call sites. They bypass the
+// staleness check (a raw pointer carries no generation), so new code
+// should hold buf_handle_t instead.
+void* allocate_static_buffer(void) {
+    return static_buffer_ptr(static_buffer_acquire());
 }
 
 void free_static_buffer(void* buffer) {
     if (!buffer) return;
-    if (xSemaphoreTake(static_buffer_mutex, pdMS_TO_TICKS(100))) {
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
-            if (buffer == static_buffers[i]) {
-                static_buffer_used[i] = false;
-                break;
-            }
+    for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
+        if (buffer == static_buffers[i]) {
+            uint32_t gen = atomic_load_explicit(&buffer_generations[i],
+                                                memory_order_relaxed);
+            static_buffer_release((gen << BUF_GEN_SHIFT) | i);
+            return;
         }
-        bool any_used = false;
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++)
-            if (static_buffer_used[i]) any_used = true;
-        if (!any_used) gpio_set_level(LED_STATIC_ALLOC, 0);
-        xSemaphoreGive(static_buffer_mutex);
     }
 }
 
+// Shows the failure modes the generations catch.
+void demonstrate_buffer_handles(void) {
+    ESP_LOGI(TAG, "\n🎫 GENERATION-COUNTED HANDLES");
+    buf_handle_t h = static_buffer_acquire();
+    ESP_LOGI(TAG, "Acquired handle 0x%08lx → %p", h, static_buffer_ptr(h));
+    ESP_LOGI(TAG, "Release: %s", static_buffer_release(h) ? "ok" : "rejected");
+    ESP_LOGI(TAG, "Stale deref:  %s", static_buffer_ptr(h) ? "MISSED!" : "caught ✅");
+    ESP_LOGI(TAG, "Double free:  %s", static_buffer_release(h) ? "MISSED!" : "caught ✅");
+}
+
 // Aligned malloc/free
 void* aligned_malloc(size_t size, size_t alignment) {
     size_t total = size + alignment + sizeof(void*);
@@ -122,7 +341,7 @@ void* aligned_malloc(size_t size, size_t alignment) {
     uintptr_t raw_addr = (uintptr_t)raw + sizeof(void*);
     uintptr_t aligned_addr = ALIGN_UP(raw_addr, alignment);
     ((void**)aligned_addr)[-1] = raw;
-    opt_stats.alignment_optimizations++;
+    OPT_STAT_ADD(alignment_optimizations, 1);
     gpio_set_level(LED_ALIGNMENT_OPT, 1);
     vTaskDelay(pdMS_TO_TICKS(30));
     gpio_set_level(LED_ALIGNMENT_OPT, 0);
@@ -133,6 +352,112 @@ void aligned_free(void* ptr) {
     if (ptr) free(((void**)ptr)[-1]);
 }
 
+// ---- DMA buffer facility ----
+//
+// aligned_malloc solves alignment but knows nothing about DMA: its
+// buffers can land in non-DMA-capable memory and share cache lines with
+// unrelated data, which is why peripheral drivers end up doing defensive
+// full-buffer copies before every transfer. The facility below allocates
+// from MALLOC_CAP_DMA rounded to whole cache lines and pairs each buffer
+// with explicit ownership state: the CPU and the peripheral take turns,
+// and the sync helpers mark the handoff. On ESP32 the DMA-capable
+// internal RAM is uncached, so the helpers reduce to bookkeeping plus a
+// compiler barrier; on cached-DMA parts they are exactly where the
+// writeback/invalidate calls belong. Drivers that trust the ownership
+// state stop copying.
+#define DMA_CACHE_LINE 32
+
+typedef enum {
+    DMA_OWNER_CPU,      // CPU may read/write freely
+    DMA_OWNER_DEVICE,   // transfer in flight: CPU access is a bug
+} dma_owner_t;
+
+typedef struct {
+    void* data;
+    size_t size;        // rounded up to a cache-line multiple
+    dma_owner_t owner;
+} dma_buffer_t;
+
+bool dma_buffer_alloc(dma_buffer_t* buf, size_t size) {
+    size_t rounded = ALIGN_UP(size, DMA_CACHE_LINE);
+    buf->data = heap_caps_aligned_alloc(DMA_CACHE_LINE, rounded, MALLOC_CAP_DMA);
+    buf->size = rounded;
+    buf->owner = DMA_OWNER_CPU;
+    if (buf->data) OPT_STAT_ADD(alignment_optimizations, 1);
+    return buf->data != NULL;
+}
+
+void dma_buffer_free(dma_buffer_t* buf) {
+    if (buf->data && buf->owner == DMA_OWNER_DEVICE) {
+        ESP_LOGE(TAG, "❌ Freeing DMA buffer %p while device owns it", buf->data);
+    }
+    heap_caps_free(buf->data);
+    buf->data = NULL;
+}
+
+// Hand the buffer to the peripheral, called right before starting the
+// descriptor. Writeback point on cached parts; the barrier keeps the
+// CPU's stores ordered before the DMA start that follows.
+void dma_buffer_sync_for_device(dma_buffer_t* buf) {
+    if (buf->owner == DMA_OWNER_DEVICE) {
+        ESP_LOGW(TAG, "⚠️ Double handoff of %p to device", buf->data);
+    }
+    __asm__ volatile("" ::: "memory");
+    buf->owner = DMA_OWNER_DEVICE;
+}
+
+// Take the buffer back after the transfer-done interrupt. Invalidate
+// point on cached parts.
+void dma_buffer_sync_for_cpu(dma_buffer_t* buf) {
+    __asm__ volatile("" ::: "memory");
+    buf->owner = DMA_OWNER_CPU;
+}
+
+// Checked accessor: touching an in-flight buffer is the bug the
+// defensive copies existed to paper over; here it fails loudly.
+void* dma_buffer_data(dma_buffer_t* buf) {
+    if (buf->owner != DMA_OWNER_CPU) {
+        ESP_LOGE(TAG, "❌ CPU access to %p while device owns it", buf->data);
+        return NULL;
+    }
+    return buf->data;
+}
+
+void demonstrate_dma_buffers(void) {
+    ESP_LOGI(TAG, "\n🚚 DMA BUFFER FACILITY");
+    dma_buffer_t buf;
+    if (!dma_buffer_alloc(&buf, 1000)) {
+        ESP_LOGW(TAG, "DMA alloc failed");
+        return;
+    }
+    ESP_LOGI(TAG, "1000 B request → %u B @ %p (line-rounded, DMA-capable: %s)",
+             (unsigned)buf.size, buf.data,
+             esp_ptr_dma_capable(buf.data) ? "yes" : "NO");
+
+    // Simulated transfer cycle: fill, hand off, take back.
+    memset(dma_buffer_data(&buf), 0x5A, buf.size);
+    dma_buffer_sync_for_device(&buf);
+    ESP_LOGI(TAG, "In-flight access: %s", dma_buffer_data(&buf) ? "MISSED!" : "caught ✅");
+    dma_buffer_sync_for_cpu(&buf);
+    ESP_LOGI(TAG, "Back to CPU:      %s", dma_buffer_data(&buf) ? "ok ✅" : "lost?");
+
+    // What the ownership discipline saves: the defensive full-buffer
+    // copy per transfer that drivers do when they can't trust the state.
+    const int xfers = 200;
+    void* shadow = malloc(buf.size);
+    if (shadow) {
+        uint64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < xfers; i++) memcpy(shadow, buf.data, buf.size);
+        uint64_t copy_us = esp_timer_get_time() - t0;
+        free(shadow);
+        ESP_LOGI(TAG, "Defensive copies avoided: %d × %u B in %llu μs (%.1f MB/s of memcpy)",
+                 xfers, (unsigned)buf.size, copy_us,
+                 copy_us ? (float)xfers * buf.size / copy_us : 0.0f);
+        OPT_STAT_ADD(memory_saved_bytes, buf.size);
+    }
+    dma_buffer_free(&buf);
+}
+
 // Struct optimization demo
 void demonstrate_struct_optimization(void) {
     ESP_LOGI(TAG, "\n🏗️ STRUCT OPTIMIZATION DEMO");
@@ -140,34 +465,215 @@ void demonstrate_struct_optimization(void) {
     ESP_LOGI(TAG, "Bad struct size:  %d", sizeof(bad_struct_t));
     ESP_LOGI(TAG, "Good struct size: %d", sizeof(good_struct_t));
     size_t saved = sizeof(bad_struct_t) - sizeof(good_struct_t);
-    opt_stats.memory_saved_bytes += saved * 1000;
+    OPT_STAT_ADD(memory_saved_bytes, saved * 1000);
+    layout_audit_report();
     gpio_set_level(LED_PACKING_OPT, 1);
     vTaskDelay(pdMS_TO_TICKS(100));
     gpio_set_level(LED_PACKING_OPT, 0);
 }
 
-// Memory region analysis
+// Memory region analysis — shared region table, used by the live
+// printout and by the snapshot/diff facility below.
+#define MSNAP_REGION_COUNT 4
+
+static const mem_region_t msnap_regions[MSNAP_REGION_COUNT] = {
+    {"Internal RAM", MALLOC_CAP_INTERNAL, false, true},
+    {"SPIRAM", MALLOC_CAP_SPIRAM, false, false},
+    {"DMA Capable", MALLOC_CAP_DMA, false, true},
+    {"Executable", MALLOC_CAP_EXEC, true, false},
+};
+
 void analyze_memory_regions(void) {
     ESP_LOGI(TAG, "\n🗺️ MEMORY REGION ANALYSIS");
-    mem_region_t regions[] = {
-        {"Internal RAM", MALLOC_CAP_INTERNAL, false, true},
-        {"SPIRAM", MALLOC_CAP_SPIRAM, false, false},
-        {"DMA Capable", MALLOC_CAP_DMA, false, true},
-        {"Executable", MALLOC_CAP_EXEC, true, false},
-    };
-    for (int i = 0; i < 4; i++) {
-        size_t total = heap_caps_get_total_size(regions[i].caps);
-        size_t free = heap_caps_get_free_size(regions[i].caps);
-        size_t largest = heap_caps_get_largest_free_block(regions[i].caps);
+    for (int i = 0; i < MSNAP_REGION_COUNT; i++) {
+        size_t total = heap_caps_get_total_size(msnap_regions[i].caps);
+        size_t free = heap_caps_get_free_size(msnap_regions[i].caps);
+        size_t largest = heap_caps_get_largest_free_block(msnap_regions[i].caps);
         if (total > 0) {
             float util = ((float)(total - free) / total) * 100.0;
             ESP_LOGI(TAG, "%s: total=%d free=%d largest=%d util=%.1f%%",
-                     regions[i].name, total, free, largest, util);
+                     msnap_regions[i].name, total, free, largest, util);
         }
     }
 }
 
-// Memory access optimization
+// ---- Memory-map snapshots and diffs ----
+//
+// A single region printout answers "how does it look now"; leak hunts
+// need "what changed across that operation". Snapshots capture the same
+// per-region numbers the analysis prints into named, preallocated slots
+// (no allocation during capture — taking a snapshot must not disturb
+// the heap it measures), and the diff prints per-region used/free/
+// largest-block deltas between any two by name. Cheap enough to wrap
+// around a suspect operation: capture before, capture after, diff.
+#define MSNAP_SLOTS    4
+#define MSNAP_NAME_MAX 16
+
+typedef struct {
+    char name[MSNAP_NAME_MAX];
+    bool used;
+    uint64_t taken_us;
+    size_t total[MSNAP_REGION_COUNT];
+    size_t free[MSNAP_REGION_COUNT];
+    size_t largest[MSNAP_REGION_COUNT];
+} mem_snapshot_t;
+
+static mem_snapshot_t msnap_slots[MSNAP_SLOTS];
+
+static mem_snapshot_t* msnap_find(const char* name) {
+    for (int i = 0; i < MSNAP_SLOTS; i++) {
+        if (msnap_slots[i].used && strcmp(msnap_slots[i].name, name) == 0) {
+            return &msnap_slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Capture into the slot with this name (re-capturing overwrites, so a
+// periodic "before" stays fresh); claims a free slot for a new name.
+bool memsnap_capture(const char* name) {
+    mem_snapshot_t* snap = msnap_find(name);
+    if (snap == NULL) {
+        for (int i = 0; i < MSNAP_SLOTS; i++) {
+            if (!msnap_slots[i].used) { snap = &msnap_slots[i]; break; }
+        }
+    }
+    if (snap == NULL) {
+        ESP_LOGW(TAG, "🗺️ Snapshot slots full, '%s' not captured", name);
+        return false;
+    }
+    strncpy(snap->name, name, MSNAP_NAME_MAX - 1);
+    snap->name[MSNAP_NAME_MAX - 1] = '\0';
+    snap->used = true;
+    snap->taken_us = esp_timer_get_time();
+    for (int i = 0; i < MSNAP_REGION_COUNT; i++) {
+        snap->total[i] = heap_caps_get_total_size(msnap_regions[i].caps);
+        snap->free[i] = heap_caps_get_free_size(msnap_regions[i].caps);
+        snap->largest[i] = heap_caps_get_largest_free_block(msnap_regions[i].caps);
+    }
+    return true;
+}
+
+// Deltas are printed from's perspective: negative free means the span
+// between the snapshots consumed memory. A shrinking largest block with
+// near-flat free is the fragmentation signature, worth its own flag.
+void memsnap_diff(const char* from, const char* to) {
+    mem_snapshot_t* a = msnap_find(from);
+    mem_snapshot_t* b = msnap_find(to);
+    if (a == NULL || b == NULL) {
+        ESP_LOGW(TAG, "🗺️ Diff needs two captured snapshots ('%s', '%s')",
+                 from, to);
+        return;
+    }
+    ESP_LOGI(TAG, "\n🗺️ MEMORY DIFF '%s' → '%s' (%llu ms apart)",
+             a->name, b->name, (b->taken_us - a->taken_us) / 1000);
+    for (int i = 0; i < MSNAP_REGION_COUNT; i++) {
+        if (a->total[i] == 0 && b->total[i] == 0) continue;
+        int d_used = (int)((a->free[i] - b->free[i]));
+        int d_free = (int)(b->free[i] - a->free[i]);
+        int d_largest = (int)(b->largest[i] - a->largest[i]);
+        const char* note = "";
+        if (d_largest < -(int)(a->largest[i] / 8) && d_free > -(int)(a->free[i] / 16)) {
+            note = "  ⚠️ largest block shrank, free ~flat: fragmentation";
+        }
+        ESP_LOGI(TAG, "%s: used %+d, free %+d, largest %+d%s",
+                 msnap_regions[i].name, d_used, d_free, d_largest, note);
+    }
+}
+
+// Memory hierarchy benchmark.
+//
+// One row per region x working-set size: sequential bandwidth, strided
+// bandwidth (one word per 32-byte line, defeating spatial locality), and
+// pointer-chase latency over a random cycle (defeating the prefetcher
+// entirely, so each load pays the full round trip). The table is what we
+// consult when deciding which buffers earn a spot in internal RAM on
+// PSRAM boards. Regions that do not exist on the board are skipped.
+#define HIER_WORK_BYTES   (512 * 1024)   // total bytes touched per cell
+#define HIER_CHASE_STEPS  65536
+
+static uint64_t hier_sequential_us(uint32_t *buf, size_t words, int passes) {
+    volatile uint32_t sum = 0;
+    uint64_t t0 = esp_timer_get_time();
+    for (int p = 0; p < passes; p++)
+        for (size_t i = 0; i < words; i++) sum += buf[i];
+    (void)sum;
+    return esp_timer_get_time() - t0;
+}
+
+static uint64_t hier_strided_us(uint32_t *buf, size_t words, int passes) {
+    const size_t stride = 8;   // 32 bytes = one cache line per touch
+    volatile uint32_t sum = 0;
+    uint64_t t0 = esp_timer_get_time();
+    for (int p = 0; p < passes * (int)stride; p++)
+        for (size_t i = 0; i < words; i += stride) sum += buf[i];
+    (void)sum;
+    return esp_timer_get_time() - t0;
+}
+
+// Sattolo-style shuffle builds one random cycle through the buffer, then
+// the chase follows it; every load depends on the previous one.
+static uint64_t hier_chase_us(uint32_t *buf, size_t words) {
+    for (size_t i = 0; i < words; i++) buf[i] = i;
+    for (size_t i = words - 1; i > 0; i--) {
+        size_t j = esp_random() % i;
+        uint32_t tmp = buf[i]; buf[i] = buf[j]; buf[j] = tmp;
+    }
+    volatile uint32_t idx = 0;
+    uint64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < HIER_CHASE_STEPS; i++) idx = buf[idx];
+    (void)idx;
+    return esp_timer_get_time() - t0;
+}
+
+void memory_hierarchy_benchmark(void) {
+    const mem_region_t regions[] = {
+        {"DRAM",  MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, false, false},
+        {"IRAM",  MALLOC_CAP_INTERNAL | MALLOC_CAP_32BIT | MALLOC_CAP_EXEC, true, false},
+        {"PSRAM", MALLOC_CAP_SPIRAM, false, false},
+    };
+    const size_t sizes[] = {4 * 1024, 32 * 1024, 128 * 1024};
+
+    ESP_LOGI(TAG, "\n🏔️ MEMORY HIERARCHY BENCHMARK");
+    ESP_LOGI(TAG, "%-6s %-7s %11s %11s %11s",
+             "region", "size", "seq MB/s", "strided MB/s", "chase ns/ld");
+
+    for (int r = 0; r < 3; r++) {
+        for (int z = 0; z < 3; z++) {
+            // IRAM is word-access only, which all three kernels honour.
+            uint32_t *buf = heap_caps_malloc(sizes[z], regions[r].caps);
+            if (!buf) {
+                ESP_LOGI(TAG, "%-6s %-7u %11s", regions[r].name,
+                         (unsigned)sizes[z], "n/a");
+                continue;
+            }
+            size_t words = sizes[z] / sizeof(uint32_t);
+            for (size_t i = 0; i < words; i++) buf[i] = i;
+            int passes = HIER_WORK_BYTES / sizes[z];
+
+            uint64_t seq_us = hier_sequential_us(buf, words, passes);
+            uint64_t str_us = hier_strided_us(buf, words, passes);
+            uint64_t chase_us = hier_chase_us(buf, words);
+
+            float seq_mbs = seq_us ? (float)HIER_WORK_BYTES / seq_us : 0;
+            float str_mbs = str_us ? (float)HIER_WORK_BYTES / str_us : 0;
+            float chase_ns = (float)chase_us * 1000.0f / HIER_CHASE_STEPS;
+
+            ESP_LOGI(TAG, "%-6s %-7u %11.1f %11.1f %11.1f",
+                     regions[r].name, (unsigned)sizes[z],
+                     seq_mbs, str_mbs, chase_ns);
+            heap_caps_free(buf);
+            vTaskDelay(1);   // let lower-priority tasks breathe between cells
+        }
+    }
+}
+
+// Memory access optimization. The PMU regions persist across passes of
+// the test task, so the second-counter rotation fills in the full
+// miss/stall profile for both access patterns after three passes.
+static pmu_region_t pmu_seq_scan = PMU_REGION_INIT("seq-scan");
+static pmu_region_t pmu_rnd_scan = PMU_REGION_INIT("rnd-scan");
+
 void optimize_memory_access_patterns(void) {
     ESP_LOGI(TAG, "\n⚡ MEMORY ACCESS PATTERNS");
     const size_t N = 1024;
@@ -176,15 +682,23 @@ void optimize_memory_access_patterns(void) {
 
     uint64_t t1 = esp_timer_get_time();
     volatile uint32_t s = 0;
-    for (int i = 0; i < N; i++) s += arr[i];
+    PMU_SCOPED(&pmu_seq_scan) {
+        for (int i = 0; i < N; i++) s += arr[i];
+    }
     uint64_t seq = esp_timer_get_time() - t1;
 
     t1 = esp_timer_get_time();
-    for (int i = 0; i < N; i++) s += arr[esp_random() % N];
+    PMU_SCOPED(&pmu_rnd_scan) {
+        for (int i = 0; i < N; i++) s += arr[esp_random() % N];
+    }
     uint64_t rnd = esp_timer_get_time() - t1;
 
     ESP_LOGI(TAG, "Sequential: %llu μs, Random: %llu μs, Speedup %.2fx", seq, rnd, (float)rnd / seq);
+    pmu_report(&pmu_seq_scan);
+    pmu_report(&pmu_rnd_scan);
     aligned_free(arr);
+
+    memory_hierarchy_benchmark();
 }
 
 // Allocation benchmark
@@ -210,7 +724,7 @@ void benchmark_allocation_strategies(void) {
     uint64_t st = esp_timer_get_time() - t1;
 
     ESP_LOGI(TAG, "malloc: %llu μs, static: %llu μs, speedup %.2fx", dyn, st, (float)dyn / st);
-    opt_stats.allocation_time_saved += (dyn > st ? dyn - st : 0);
+    OPT_STAT_ADD(allocation_time_saved, dyn > st ? dyn - st : 0);
 }
 
 // Static task creation
@@ -226,23 +740,34 @@ BaseType_t create_static_task(TaskFunction_t fn, const char* name, UBaseType_t p
 void optimization_test_task(void *pv) {
     while (1) {
         gpio_set_level(LED_OPTIMIZATION, 1);
+        // Bracket the whole demo pass: anything it leaks shows up as a
+        // used delta in the diff, localized to this pass.
+        memsnap_capture("pre-pass");
         demonstrate_struct_optimization();
+        demonstrate_buffer_handles();
+        demonstrate_dma_buffers();
         analyze_memory_regions();
         optimize_memory_access_patterns();
         benchmark_allocation_strategies();
+        memsnap_capture("post-pass");
+        memsnap_diff("pre-pass", "post-pass");
+        memsnap_diff("boot", "post-pass");   // cumulative drift since startup
         gpio_set_level(LED_OPTIMIZATION, 0);
         vTaskDelay(pdMS_TO_TICKS(20000));
     }
 }
 
 void optimization_monitor_task(void *pv) {
+    optimization_stats_t snap;
     while (1) {
+        opt_stats_read(&snap);   // consistent copy, writer never blocked
         ESP_LOGI(TAG, "\n📈 OPTIMIZATION STATS:");
-        ESP_LOGI(TAG, "Static Alloc: %d", opt_stats.static_allocations);
-        ESP_LOGI(TAG, "Align Opt:    %d", opt_stats.alignment_optimizations);
-        ESP_LOGI(TAG, "Pack Opt:     %d", opt_stats.packing_optimizations);
-        ESP_LOGI(TAG, "Saved:        %d bytes", opt_stats.memory_saved_bytes);
-        ESP_LOGI(TAG, "Time saved:   %llu μs", opt_stats.allocation_time_saved);
+        ESP_LOGI(TAG, "Static Alloc: %d", snap.static_allocations);
+        ESP_LOGI(TAG, "Align Opt:    %d", snap.alignment_optimizations);
+        ESP_LOGI(TAG, "Pack Opt:     %d", snap.packing_optimizations);
+        ESP_LOGI(TAG, "Saved:        %d bytes", snap.memory_saved_bytes);
+        ESP_LOGI(TAG, "Time saved:   %llu μs", snap.allocation_time_saved);
+        ESP_LOGI(TAG, "Read retries: %lu", opt_stats_read_retries);
         vTaskDelay(pdMS_TO_TICKS(15000));
     }
 }
@@ -256,9 +781,15 @@ void app_main(void) {
     gpio_set_direction(LED_MEMORY_SAVING, GPIO_MODE_OUTPUT);
     gpio_set_direction(LED_OPTIMIZATION, GPIO_MODE_OUTPUT);
 
-    static_buffer_mutex = xSemaphoreCreateMutex();
+    // Generation 0 is reserved so BUF_HANDLE_INVALID never validates.
+    for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
+        atomic_store_explicit(&buffer_generations[i], 1, memory_order_relaxed);
+    }
+
+    layout_audit_init();
     demonstrate_struct_optimization();
     analyze_memory_regions();
+    memsnap_capture("boot");   // baseline every later diff can reach
 
     create_static_task(optimization_test_task, "OptTest", 5);
     xTaskCreate(optimization_monitor_task, "OptMon", 3072, NULL, 4, NULL);
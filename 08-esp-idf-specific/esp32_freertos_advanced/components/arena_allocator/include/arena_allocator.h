@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Grow-only bump-pointer arena for per-cycle scratch memory.
+//
+// Allocation is a pointer increment and the whole arena is recycled with an
+// O(1) reset at the end of each processing cycle, so a loop that allocates
+// scratch buffers per sample pays no per-allocation heap cost and causes no
+// fragmentation.
+typedef struct {
+    uint8_t *base;
+    size_t capacity;
+    size_t offset;
+    size_t high_water;    // largest offset seen since init
+    uint32_t resets;
+    uint32_t failed_allocs;
+} arena_t;
+
+// Allocate the backing buffer from the heap with the given MALLOC_CAP_* caps.
+esp_err_t arena_init(arena_t *arena, size_t capacity, uint32_t caps);
+
+// Bump-pointer allocation, 4-byte aligned. Returns NULL when the arena is full.
+void *arena_alloc(arena_t *arena, size_t size);
+
+// O(1): rewinds the bump pointer; all outstanding allocations become invalid.
+void arena_reset(arena_t *arena);
+
+void arena_destroy(arena_t *arena);
@@ -0,0 +1,70 @@
+#include "arena_allocator.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "ARENA";
+
+esp_err_t arena_init(arena_t *arena, size_t capacity, uint32_t caps)
+{
+    if (arena == NULL || capacity == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(arena, 0, sizeof(arena_t));
+    arena->base = heap_caps_malloc(capacity, caps);
+    if (arena->base == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %u-byte arena", (unsigned)capacity);
+        return ESP_ERR_NO_MEM;
+    }
+    arena->capacity = capacity;
+
+    ESP_LOGI(TAG, "Arena ready: %u bytes", (unsigned)capacity);
+    return ESP_OK;
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    if (arena == NULL || arena->base == NULL)
+    {
+        return NULL;
+    }
+
+    size_t aligned = (size + 3) & ~(size_t)3;
+    if (arena->offset + aligned > arena->capacity)
+    {
+        arena->failed_allocs++;
+        return NULL;
+    }
+
+    void *ptr = arena->base + arena->offset;
+    arena->offset += aligned;
+    if (arena->offset > arena->high_water)
+    {
+        arena->high_water = arena->offset;
+    }
+    return ptr;
+}
+
+void arena_reset(arena_t *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+    arena->offset = 0;
+    arena->resets++;
+}
+
+void arena_destroy(arena_t *arena)
+{
+    if (arena == NULL || arena->base == NULL)
+    {
+        return;
+    }
+    heap_caps_free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+}
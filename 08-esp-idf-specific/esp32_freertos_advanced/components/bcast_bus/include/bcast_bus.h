@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Broadcast bus: one writer, many readers, zero per-subscriber copies.
+//
+// Point-to-point queues copy every message once per consumer; with three
+// consumers of the same sensor stream that is 3x the necessary memory
+// bandwidth. The bus instead keeps a fixed ring of slots guarded by
+// per-slot sequence counters (a seqlock): the writer publishes in place,
+// and each reader follows its own cursor through the ring, validating
+// the sequence before and after its copy. A slow reader that gets lapped
+// skips forward and counts the loss instead of stalling the writer.
+#define BCAST_SLOTS 16   // power of two
+
+typedef struct {
+    atomic_uint_fast32_t seq[BCAST_SLOTS];   // 2*index+1 writing, 2*index+2 stable
+    atomic_uint_fast32_t head;               // number of published items
+    size_t item_size;
+    uint8_t *slots;                          // caller-owned, BCAST_SLOTS * item_size
+} bcast_bus_t;
+
+typedef struct {
+    uint32_t cursor;     // next publish index to read
+    uint32_t lost;       // items skipped after being lapped
+} bcast_reader_t;
+
+void bcast_bus_init(bcast_bus_t *bus, void *slot_storage, size_t item_size);
+void bcast_bus_publish(bcast_bus_t *bus, const void *item);
+
+// Start a reader at the current head (it sees only new items).
+void bcast_reader_init(bcast_reader_t *reader, const bcast_bus_t *bus);
+
+// Copy the next unread item into `out`; returns false when caught up.
+bool bcast_bus_read(bcast_bus_t *bus, bcast_reader_t *reader, void *out);
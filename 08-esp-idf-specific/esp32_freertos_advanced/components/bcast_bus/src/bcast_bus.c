@@ -0,0 +1,77 @@
+#include "bcast_bus.h"
+
+#include <string.h>
+
+void bcast_bus_init(bcast_bus_t *bus, void *slot_storage, size_t item_size)
+{
+    for (int i = 0; i < BCAST_SLOTS; i++)
+    {
+        atomic_store_explicit(&bus->seq[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&bus->head, 0, memory_order_relaxed);
+    bus->item_size = item_size;
+    bus->slots = slot_storage;
+}
+
+void bcast_bus_publish(bcast_bus_t *bus, const void *item)
+{
+    uint_fast32_t index = atomic_load_explicit(&bus->head, memory_order_relaxed);
+    uint_fast32_t slot = index % BCAST_SLOTS;
+
+    // Odd sequence marks the slot as being written; readers retry or skip.
+    atomic_store_explicit(&bus->seq[slot], 2 * index + 1, memory_order_release);
+    memcpy(bus->slots + slot * bus->item_size, item, bus->item_size);
+    atomic_store_explicit(&bus->seq[slot], 2 * index + 2, memory_order_release);
+
+    atomic_store_explicit(&bus->head, index + 1, memory_order_release);
+}
+
+void bcast_reader_init(bcast_reader_t *reader, const bcast_bus_t *bus)
+{
+    reader->cursor = atomic_load_explicit(&bus->head, memory_order_acquire);
+    reader->lost = 0;
+}
+
+bool bcast_bus_read(bcast_bus_t *bus, bcast_reader_t *reader, void *out)
+{
+    while (1)
+    {
+        uint_fast32_t head = atomic_load_explicit(&bus->head, memory_order_acquire);
+        if (reader->cursor == head)
+        {
+            return false;
+        }
+        if (head - reader->cursor > BCAST_SLOTS)
+        {
+            // Lapped: the oldest still-valid item is head - BCAST_SLOTS.
+            reader->lost += head - BCAST_SLOTS - reader->cursor;
+            reader->cursor = head - BCAST_SLOTS;
+        }
+
+        uint_fast32_t slot = reader->cursor % BCAST_SLOTS;
+        uint_fast32_t expect = 2 * (uint_fast32_t)reader->cursor + 2;
+
+        uint_fast32_t s1 = atomic_load_explicit(&bus->seq[slot], memory_order_acquire);
+        if (s1 != expect)
+        {
+            // Writer got here first (being rewritten or already newer):
+            // the item is gone, account for it and move on.
+            reader->lost++;
+            reader->cursor++;
+            continue;
+        }
+        memcpy(out, bus->slots + slot * bus->item_size, bus->item_size);
+        atomic_thread_fence(memory_order_acquire);
+        uint_fast32_t s2 = atomic_load_explicit(&bus->seq[slot], memory_order_relaxed);
+        if (s2 != s1)
+        {
+            // Torn read: the writer overwrote mid-copy. Treat as lapped.
+            reader->lost++;
+            reader->cursor++;
+            continue;
+        }
+
+        reader->cursor++;
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+// ===== dvfs_gov: pressure-driven CPU frequency governor =====
+//
+// A thermally limited enclosure can't just pin 240 MHz and hope; it
+// needs performance per watt. The governor steps the CPU between
+// 80/160/240 MHz from two live inputs: idle-cycle accounting (its own
+// per-core idle hooks, same gap-counting trick the labs use) and queue
+// pressure from the queue registry (depth relative to capacity across
+// every registered queue). Hysteresis requires several consecutive
+// windows voting the same direction before a step, so one bursty
+// window doesn't thrash the PLL.
+//
+// Real-time tasks opt out of the economics: they register a frequency
+// floor and hold it around their latency-critical sections. A held
+// floor raises the clock immediately — not at the next window — and
+// the governor never steps below the highest held floor.
+//
+// Without CONFIG_PM_ENABLE the governor runs in shadow mode: it makes
+// and reports every decision but leaves the clock alone, which is how
+// the decision logic gets validated before power management is on.
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DVFS_RT_MAX 8
+
+// Start the governor: installs the idle hooks and the window task.
+// `window_ms` is the decision period (1000 is a good default).
+void dvfs_gov_start(uint32_t window_ms);
+
+// Register a real-time task's frequency floor (80/160/240). Returns a
+// floor id, or -1 when the table is full.
+int dvfs_gov_register_rt(const char *name, uint32_t floor_mhz);
+
+// Bracket a latency-critical section: hold raises the clock to the
+// floor immediately if needed; release lets the governor economize
+// again. Holds nest.
+void dvfs_gov_floor_hold(int id);
+void dvfs_gov_floor_release(int id);
+
+// Residency per frequency step, step counts, and floor overrides.
+void dvfs_gov_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,223 @@
+// ===== dvfs_gov implementation =====
+#include "dvfs_gov.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "esp_freertos_hooks.h"
+#include "queue_registry.h"
+#include "sdkconfig.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "dvfs_gov";
+
+// ---- Tuning ----
+#define DVFS_IDLE_GAP_CYCLES 4000  // idle-hook deltas above this mean work ran
+#define DVFS_BUSY_UP_PCT     85    // busier than this votes up
+#define DVFS_BUSY_DOWN_PCT   30    // idler than this votes down
+#define DVFS_QUEUE_UP_PCT    75    // fuller than this votes up
+#define DVFS_QUEUE_DOWN_PCT  25
+#define DVFS_HYST_WINDOWS    3     // consecutive votes before a step
+
+static const uint32_t dvfs_steps[] = { 80, 160, 240 };
+#define DVFS_STEP_COUNT (sizeof(dvfs_steps) / sizeof(dvfs_steps[0]))
+
+// ---- Idle-cycle accounting ----
+// The idle hook fires continuously while the idle task spins; a small
+// cycle gap between invocations means the core stayed idle, a large
+// one means real work ran in between. Summing the small gaps per
+// window gives idle cycles without touching the scheduler.
+static volatile uint32_t idle_last[portNUM_PROCESSORS];
+static volatile uint64_t idle_cycles[portNUM_PROCESSORS];
+
+static void idle_tick(int core) {
+    uint32_t now = esp_cpu_get_cycle_count();
+    uint32_t gap = now - idle_last[core];
+    if (gap < DVFS_IDLE_GAP_CYCLES) idle_cycles[core] += gap;
+    idle_last[core] = now;
+}
+
+static bool idle_hook_c0(void) { idle_tick(0); return true; }
+#if portNUM_PROCESSORS > 1
+static bool idle_hook_c1(void) { idle_tick(1); return true; }
+#endif
+
+// ---- Governor state ----
+typedef struct {
+    const char *name;
+    uint32_t floor_mhz;
+    volatile int holds;     // nested hold count
+    uint32_t hold_events;
+} dvfs_rt_t;
+
+static dvfs_rt_t rt_floors[DVFS_RT_MAX];
+static int rt_count = 0;
+
+static int cur_step = DVFS_STEP_COUNT - 1;   // boot clock: top step
+static uint32_t window_period_ms = 1000;
+static int vote_streak = 0;                  // + up votes, - down votes
+static bool pm_available = true;
+
+static uint32_t windows_run, steps_up, steps_down, floor_overrides;
+static uint64_t residency_ms[DVFS_STEP_COUNT];
+
+static void apply_step(int step) {
+    cur_step = step;
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t cfg = {
+        .max_freq_mhz = (int)dvfs_steps[step],
+        .min_freq_mhz = (int)dvfs_steps[step],
+        .light_sleep_enable = false,
+    };
+    esp_err_t err = esp_pm_configure(&cfg);
+    if (err != ESP_OK && pm_available) {
+        ESP_LOGW(TAG, "esp_pm_configure failed (%s) — continuing in shadow mode",
+                 esp_err_to_name(err));
+        pm_available = false;
+    }
+#else
+    if (pm_available) {
+        ESP_LOGW(TAG, "CONFIG_PM_ENABLE off — governor runs in shadow mode");
+        pm_available = false;
+    }
+#endif
+}
+
+// Highest floor currently held; 0 when no RT task needs one.
+static uint32_t held_floor_mhz(void) {
+    uint32_t floor = 0;
+    for (int i = 0; i < rt_count; i++) {
+        if (rt_floors[i].holds > 0 && rt_floors[i].floor_mhz > floor) {
+            floor = rt_floors[i].floor_mhz;
+        }
+    }
+    return floor;
+}
+
+static int step_for_mhz(uint32_t mhz) {
+    for (int s = 0; s < DVFS_STEP_COUNT; s++) {
+        if (dvfs_steps[s] >= mhz) return s;
+    }
+    return DVFS_STEP_COUNT - 1;
+}
+
+int dvfs_gov_register_rt(const char *name, uint32_t floor_mhz) {
+    if (rt_count >= DVFS_RT_MAX) return -1;
+    rt_floors[rt_count].name = name;
+    rt_floors[rt_count].floor_mhz = floor_mhz;
+    return rt_count++;
+}
+
+void dvfs_gov_floor_hold(int id) {
+    if (id < 0 || id >= rt_count) return;
+    rt_floors[id].holds++;
+    rt_floors[id].hold_events++;
+    // Latency override: raise the clock now, not at the next window.
+    int need = step_for_mhz(rt_floors[id].floor_mhz);
+    if (need > cur_step) {
+        floor_overrides++;
+        ESP_LOGI(TAG, "⚡ Floor '%s': %lu MHz now (was %lu)", rt_floors[id].name,
+                 dvfs_steps[need], dvfs_steps[cur_step]);
+        apply_step(need);
+    }
+}
+
+void dvfs_gov_floor_release(int id) {
+    if (id < 0 || id >= rt_count || rt_floors[id].holds == 0) return;
+    rt_floors[id].holds--;
+}
+
+// One decision per window: compute busy and queue pressure, vote, and
+// step only after DVFS_HYST_WINDOWS agreeing votes.
+static void dvfs_window_task(void *arg) {
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(window_period_ms));
+        windows_run++;
+        residency_ms[cur_step] += window_period_ms;
+
+        // Busy fraction: worst core wins — that's the one a step-down
+        // would starve.
+        uint64_t window_cycles =
+            (uint64_t)dvfs_steps[cur_step] * 1000 * window_period_ms;
+        uint32_t busy_pct = 0;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            uint64_t idle = idle_cycles[c];
+            idle_cycles[c] = 0;
+            if (idle > window_cycles) idle = window_cycles;
+            uint32_t b = 100 - (uint32_t)(idle * 100 / window_cycles);
+            if (b > busy_pct) busy_pct = b;
+        }
+
+        // Queue pressure: fullest registered queue, as a percentage.
+        uint32_t queue_pct = 0;
+        qreg_snapshot_t snap;
+        if (qreg_snapshot(&snap) > 0) {
+            for (int i = 0; i < snap.count; i++) {
+                if (snap.queues[i].capacity == 0) continue;
+                uint32_t p = snap.queues[i].depth * 100 / snap.queues[i].capacity;
+                if (p > queue_pct) queue_pct = p;
+            }
+        }
+
+        int vote = 0;
+        if (busy_pct > DVFS_BUSY_UP_PCT || queue_pct > DVFS_QUEUE_UP_PCT) vote = 1;
+        else if (busy_pct < DVFS_BUSY_DOWN_PCT && queue_pct < DVFS_QUEUE_DOWN_PCT) vote = -1;
+
+        vote_streak = (vote == 0 || (vote > 0) != (vote_streak > 0))
+                          ? vote : vote_streak + vote;
+
+        int target = cur_step;
+        if (vote_streak >= DVFS_HYST_WINDOWS && cur_step < DVFS_STEP_COUNT - 1) {
+            target = cur_step + 1;
+            steps_up++;
+        } else if (vote_streak <= -DVFS_HYST_WINDOWS && cur_step > 0) {
+            target = cur_step - 1;
+            steps_down++;
+        }
+
+        // Never below the highest held floor.
+        int floor_step = step_for_mhz(held_floor_mhz());
+        if (held_floor_mhz() > 0 && target < floor_step) target = floor_step;
+
+        if (target != cur_step) {
+            ESP_LOGI(TAG, "🎚️ %lu → %lu MHz (busy %lu%%, queues %lu%%)",
+                     dvfs_steps[cur_step], dvfs_steps[target], busy_pct, queue_pct);
+            apply_step(target);
+            vote_streak = 0;
+        }
+    }
+}
+
+void dvfs_gov_start(uint32_t window_ms) {
+    window_period_ms = window_ms ? window_ms : 1000;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        idle_last[c] = esp_cpu_get_cycle_count();
+    }
+    esp_register_freertos_idle_hook_for_cpu(idle_hook_c0, 0);
+#if portNUM_PROCESSORS > 1
+    esp_register_freertos_idle_hook_for_cpu(idle_hook_c1, 1);
+#endif
+    apply_step(cur_step);
+    xTaskCreate(dvfs_window_task, "DvfsGov", 3072, NULL, 10, NULL);
+    ESP_LOGI(TAG, "Started: %lums windows, %d RT floors registered",
+             window_period_ms, rt_count);
+}
+
+void dvfs_gov_report(void) {
+    ESP_LOGI(TAG, "🎚️ Governor%s: %lu windows, %lu up / %lu down, %lu floor overrides",
+             pm_available ? "" : " (shadow)", windows_run, steps_up, steps_down,
+             floor_overrides);
+    for (int s = 0; s < DVFS_STEP_COUNT; s++) {
+        ESP_LOGI(TAG, "  %3lu MHz: %llu ms", dvfs_steps[s], residency_ms[s]);
+    }
+    for (int i = 0; i < rt_count; i++) {
+        ESP_LOGI(TAG, "  floor '%s' %lu MHz: %lu holds%s", rt_floors[i].name,
+                 rt_floors[i].floor_mhz, rt_floors[i].hold_events,
+                 rt_floors[i].holds > 0 ? " (held now)" : "");
+    }
+}
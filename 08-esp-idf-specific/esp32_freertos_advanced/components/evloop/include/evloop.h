@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lightweight queue-set event loop.
+//
+// Every select-and-dispatch loop in the labs is the same shape: block on
+// a queue set, figure out which member fired, run its handler, repeat —
+// each hand-rolled copy slightly different. This component is that loop
+// once, done properly: sources register with a name, a priority and a
+// handler; the loop blocks on the set, and in batching mode flushes the
+// set's remaining readiness tokens and snapshots every member's pending
+// count so one wakeup drains the whole backlog, highest priority first.
+// Each handler's execution time is measured around the call, so "which
+// handler is eating the loop" is a report, not a guess.
+//
+// Handlers own their drain: a handler is invoked once per wakeup in
+// which its source is ready and must empty the source itself (receive
+// with zero timeout until empty). `pending` holds the snapshot depth.
+
+#define EVL_SOURCES_MAX 8
+
+typedef void (*evl_handler_fn_t)(void *ctx, UBaseType_t pending);
+
+typedef struct {
+    QueueSetMemberHandle_t handle;
+    const char *name;
+    int priority;                // higher drains first
+    evl_handler_fn_t handler;
+    void *ctx;
+    UBaseType_t pending;         // snapshot at wakeup
+    uint32_t invocations;
+    uint64_t exec_us_total;
+    uint32_t exec_us_max;
+} evl_source_t;
+
+typedef struct {
+    QueueSetHandle_t set;
+    evl_source_t sources[EVL_SOURCES_MAX];
+    int count;
+    bool batching;               // drain all ready members per wakeup
+    uint32_t wakeups;
+    uint32_t dispatches;
+} evloop_t;
+
+// `set_len` must cover the summed capacities of every member added.
+bool evl_init(evloop_t *loop, UBaseType_t set_len, bool batching);
+
+// Adds a queue or semaphore to the loop. Returns the source id, or -1
+// when the table is full. Call before the loop starts running.
+int evl_add_source(evloop_t *loop, QueueSetMemberHandle_t handle,
+                   const char *name, int priority,
+                   evl_handler_fn_t handler, void *ctx);
+
+// Block for up to `timeout`, dispatch ready handlers, return how many
+// handlers ran (0 on timeout).
+int evl_run_once(evloop_t *loop, TickType_t timeout);
+
+// Per-handler invocation and execution-time table via ESP_LOG.
+void evl_report(const evloop_t *loop);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,126 @@
+#include <string.h>
+#include "evloop.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+static const char *TAG = "EVLOOP";
+
+bool evl_init(evloop_t *loop, UBaseType_t set_len, bool batching)
+{
+    memset(loop, 0, sizeof(*loop));
+    loop->set = xQueueCreateSet(set_len);
+    loop->batching = batching;
+    if (loop->set == NULL) {
+        ESP_LOGE(TAG, "Failed to create queue set (len=%u)", (unsigned)set_len);
+        return false;
+    }
+    return true;
+}
+
+int evl_add_source(evloop_t *loop, QueueSetMemberHandle_t handle,
+                   const char *name, int priority,
+                   evl_handler_fn_t handler, void *ctx)
+{
+    if (loop->count >= EVL_SOURCES_MAX) {
+        ESP_LOGE(TAG, "Source table full, dropping '%s'", name);
+        return -1;
+    }
+    if (xQueueAddToSet(handle, loop->set) != pdPASS) {
+        ESP_LOGE(TAG, "Could not add '%s' to queue set", name);
+        return -1;
+    }
+
+    // Insert sorted by priority so the drain order is just table order.
+    int pos = loop->count;
+    while (pos > 0 && loop->sources[pos - 1].priority < priority) {
+        loop->sources[pos] = loop->sources[pos - 1];
+        pos--;
+    }
+    evl_source_t *src = &loop->sources[pos];
+    memset(src, 0, sizeof(*src));
+    src->handle = handle;
+    src->name = name;
+    src->priority = priority;
+    src->handler = handler;
+    src->ctx = ctx;
+    loop->count++;
+    return pos;
+}
+
+static evl_source_t *evl_find(evloop_t *loop, QueueSetMemberHandle_t handle)
+{
+    for (int i = 0; i < loop->count; i++) {
+        if (loop->sources[i].handle == handle) {
+            return &loop->sources[i];
+        }
+    }
+    return NULL;
+}
+
+static void evl_dispatch(evloop_t *loop, evl_source_t *src)
+{
+    int64_t t0 = esp_timer_get_time();
+    src->handler(src->ctx, src->pending);
+    int64_t dt = esp_timer_get_time() - t0;
+
+    src->invocations++;
+    src->exec_us_total += (uint64_t)dt;
+    if ((uint32_t)dt > src->exec_us_max) {
+        src->exec_us_max = (uint32_t)dt;
+    }
+    loop->dispatches++;
+}
+
+int evl_run_once(evloop_t *loop, TickType_t timeout)
+{
+    QueueSetMemberHandle_t ready = xQueueSelectFromSet(loop->set, timeout);
+    if (ready == NULL) {
+        return 0;
+    }
+    loop->wakeups++;
+
+    if (!loop->batching) {
+        evl_source_t *src = evl_find(loop, ready);
+        if (src == NULL) {
+            return 0;
+        }
+        src->pending = uxQueueMessagesWaiting(src->handle);
+        evl_dispatch(loop, src);
+        return 1;
+    }
+
+    // Batching mode: one wakeup drains everything. Flush the set's
+    // remaining readiness tokens — handlers empty the queues themselves,
+    // so stale tokens would only cause spurious wakeups later — then
+    // snapshot every member's depth and dispatch in priority order.
+    while (xQueueSelectFromSet(loop->set, 0) != NULL) {
+    }
+
+    int handled = 0;
+    for (int i = 0; i < loop->count; i++) {
+        loop->sources[i].pending = uxQueueMessagesWaiting(loop->sources[i].handle);
+    }
+    for (int i = 0; i < loop->count; i++) {
+        evl_source_t *src = &loop->sources[i];
+        if (src->handle == ready || src->pending > 0) {
+            evl_dispatch(loop, src);
+            handled++;
+        }
+    }
+    return handled;
+}
+
+void evl_report(const evloop_t *loop)
+{
+    ESP_LOGI(TAG, "Loop: %lu wakeups, %lu dispatches (%.2f per wakeup, %s mode)",
+             loop->wakeups, loop->dispatches,
+             loop->wakeups ? (float)loop->dispatches / loop->wakeups : 0.0f,
+             loop->batching ? "batching" : "single");
+    for (int i = 0; i < loop->count; i++) {
+        const evl_source_t *src = &loop->sources[i];
+        ESP_LOGI(TAG, "  %-8s prio=%d runs=%-6lu avg=%lluus max=%luus",
+                 src->name, src->priority, src->invocations,
+                 src->invocations ? src->exec_us_total / src->invocations : 0,
+                 src->exec_us_max);
+    }
+}
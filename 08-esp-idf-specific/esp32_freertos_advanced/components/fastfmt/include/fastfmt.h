@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fast formatting for the logging hot path.
+//
+// Profiling the log-heavy demos shows newlib's vsnprintf dominating the
+// cost of a log line — it re-parses the format string on every call and
+// routes everything through the generic conversion machinery, and any
+// %f drags in soft-float. These routines cover the shapes our log lines
+// actually use: decimal integers two digits at a time from a 200-byte
+// pair table, hex through a nibble lookup, and fixed-point decimals
+// from a pre-scaled integer so the float never exists.
+//
+// Every routine appends at `dst` and returns the advanced write
+// pointer, so a line is composed by chaining calls; nothing writes a
+// terminator until ff_term. The caller owns bounds: size buffers for
+// the worst case (11 bytes per u32, 12 per i32, `digits` per hex,
+// int+1+frac per fixed-point).
+
+// Append a NUL-terminated string (no terminator copied).
+char *ff_str(char *dst, const char *s);
+
+// Append an unsigned/signed decimal integer.
+char *ff_u32(char *dst, uint32_t v);
+char *ff_i32(char *dst, int32_t v);
+
+// Append `digits` lowercase hex digits, zero-padded, most significant
+// first. digits may be 1..8.
+char *ff_hex32(char *dst, uint32_t v, int digits);
+
+// Append a fixed-point decimal: `scaled` is the value multiplied by
+// 10^frac_digits. ff_fix(-12345, 2) writes "-123.45". frac_digits 0..9.
+char *ff_fix(char *dst, int32_t scaled, unsigned frac_digits);
+
+// Terminate the composed line.
+static inline char *ff_term(char *dst) {
+    *dst = '\0';
+    return dst;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,83 @@
+#include "fastfmt.h"
+
+// 00..99 as character pairs: one table lookup emits two digits, halving
+// the divisions a conversion needs.
+static const char ff_pairs[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char ff_hexdigits[16] = "0123456789abcdef";
+
+char *ff_str(char *dst, const char *s) {
+    while (*s) *dst++ = *s++;
+    return dst;
+}
+
+char *ff_u32(char *dst, uint32_t v) {
+    // Build least-significant-first into a scratch, then reverse out —
+    // a u32 is at most 10 digits, so the scratch lives in registers.
+    char tmp[10];
+    int n = 0;
+    while (v >= 100) {
+        unsigned rem = v % 100;
+        v /= 100;
+        tmp[n++] = ff_pairs[rem * 2 + 1];
+        tmp[n++] = ff_pairs[rem * 2];
+    }
+    if (v >= 10) {
+        tmp[n++] = ff_pairs[v * 2 + 1];
+        tmp[n++] = ff_pairs[v * 2];
+    } else {
+        tmp[n++] = (char)('0' + v);
+    }
+    while (n > 0) *dst++ = tmp[--n];
+    return dst;
+}
+
+char *ff_i32(char *dst, int32_t v) {
+    uint32_t mag = (uint32_t)v;
+    if (v < 0) {
+        *dst++ = '-';
+        mag = 0u - mag;
+    }
+    return ff_u32(dst, mag);
+}
+
+char *ff_hex32(char *dst, uint32_t v, int digits) {
+    for (int shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+        *dst++ = ff_hexdigits[(v >> shift) & 0xF];
+    }
+    return dst;
+}
+
+char *ff_fix(char *dst, int32_t scaled, unsigned frac_digits) {
+    static const uint32_t pow10[10] = {
+        1, 10, 100, 1000, 10000, 100000,
+        1000000, 10000000, 100000000, 1000000000,
+    };
+    uint32_t mag = (uint32_t)scaled;
+    if (scaled < 0) {
+        *dst++ = '-';
+        mag = 0u - mag;
+    }
+    uint32_t scale = pow10[frac_digits];
+    dst = ff_u32(dst, mag / scale);
+    if (frac_digits == 0) return dst;
+
+    *dst++ = '.';
+    uint32_t frac = mag % scale;
+    // Fixed width: emit from the most significant fractional digit down.
+    for (unsigned d = frac_digits; d-- > 0; ) {
+        *dst++ = (char)('0' + frac / pow10[d]);
+        frac %= pow10[d];
+    }
+    return dst;
+}
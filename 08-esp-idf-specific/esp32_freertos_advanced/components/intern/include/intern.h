@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// String interning registry.
+//
+// Task names and log tags are duplicated string literals compared by
+// strcmp in monitoring paths — every find-by-name walk pays a string
+// compare per candidate, and identical literals registered from
+// different files each cost their own flash copy. The registry hands
+// every distinct string a small dense integer id at registration time:
+// runtime comparison and lookup become integer compares (or direct
+// array indexing, since ids start at 0 and count up), and the decoder
+// table turns an id back into text for display. Identical strings
+// registered from different call sites collapse onto one id and one
+// stored copy; the report shows how many duplicate bytes that absorbed.
+// Strings are copied into a fixed arena, so callers may pass transient
+// buffers.
+
+#define INTERN_MAX_STRINGS 64
+#define INTERN_ARENA_BYTES 768
+#define INTERN_INVALID     (-1)
+
+// Register a string (or find it, if already interned). Returns its id,
+// or INTERN_INVALID when the table or arena is full.
+int intern_get(const char *s);
+
+// Lookup only: the id of a previously interned string, INTERN_INVALID
+// if it was never registered.
+int intern_find(const char *s);
+
+// Decoder: id back to text for display. Returns "?" for invalid ids,
+// never NULL, so the result is always safe to hand to printf.
+const char *intern_str(int id);
+
+// Number of distinct strings interned so far.
+size_t intern_count(void);
+
+// Bytes of duplicate registrations collapsed onto existing entries.
+size_t intern_dup_bytes_saved(void);
+
+// One-line summary through ESP_LOG.
+void intern_report(void);
+
+#ifdef __cplusplus
+}
+#endif
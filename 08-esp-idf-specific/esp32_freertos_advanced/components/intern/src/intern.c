@@ -0,0 +1,122 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "intern.h"
+
+static const char *TAG = "intern";
+
+// Dense side: offsets[id] points at the stored copy, ids are handed out
+// in registration order so callers can index their own arrays by them.
+static char arena[INTERN_ARENA_BYTES];
+static size_t arena_used;
+static uint16_t offsets[INTERN_MAX_STRINGS];
+static int intern_entries;
+
+// Hash side: open-addressed FNV-1a index so a lookup is one probe run,
+// not a walk of every entry. Sized 2x the table so probes stay short.
+#define IDX_SLOTS (INTERN_MAX_STRINGS * 2)
+
+typedef struct {
+    uint32_t hash;      // 0 = empty
+    int16_t id;
+} idx_slot_t;
+
+static idx_slot_t idx[IDX_SLOTS];
+static portMUX_TYPE intern_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t dup_hits;
+static size_t dup_bytes;
+
+static uint32_t intern_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h != 0 ? h : 1;   // 0 marks an empty index slot
+}
+
+// Shared probe: returns the id on a hit, or -1 with *slot_out pointing
+// at the empty slot where this hash belongs. Called under the lock; the
+// strcmp guards against hash collisions and is bounded by name length.
+static int intern_probe(const char *s, uint32_t h, idx_slot_t **slot_out)
+{
+    uint32_t start = h % IDX_SLOTS;
+    for (uint32_t i = 0; i < IDX_SLOTS; i++) {
+        idx_slot_t *slot = &idx[(start + i) % IDX_SLOTS];
+        if (slot->hash == 0) {
+            if (slot_out) *slot_out = slot;
+            return -1;
+        }
+        if (slot->hash == h && strcmp(&arena[offsets[slot->id]], s) == 0) {
+            return slot->id;
+        }
+    }
+    if (slot_out) *slot_out = NULL;   // index full (table full implies this)
+    return -1;
+}
+
+int intern_get(const char *s)
+{
+    if (s == NULL) return INTERN_INVALID;
+    uint32_t h = intern_hash(s);
+    size_t len = strlen(s) + 1;
+
+    portENTER_CRITICAL(&intern_lock);
+    idx_slot_t *slot;
+    int id = intern_probe(s, h, &slot);
+    if (id >= 0) {
+        dup_hits++;
+        dup_bytes += len;
+        portEXIT_CRITICAL(&intern_lock);
+        return id;
+    }
+    if (slot == NULL || intern_entries >= INTERN_MAX_STRINGS ||
+        arena_used + len > INTERN_ARENA_BYTES) {
+        portEXIT_CRITICAL(&intern_lock);
+        ESP_LOGW(TAG, "Registry full, \"%s\" not interned", s);
+        return INTERN_INVALID;
+    }
+    id = intern_entries++;
+    offsets[id] = (uint16_t)arena_used;
+    memcpy(&arena[arena_used], s, len);
+    arena_used += len;
+    slot->hash = h;
+    slot->id = (int16_t)id;
+    portEXIT_CRITICAL(&intern_lock);
+    return id;
+}
+
+int intern_find(const char *s)
+{
+    if (s == NULL) return INTERN_INVALID;
+    uint32_t h = intern_hash(s);
+    portENTER_CRITICAL(&intern_lock);
+    int id = intern_probe(s, h, NULL);
+    portEXIT_CRITICAL(&intern_lock);
+    return id >= 0 ? id : INTERN_INVALID;
+}
+
+const char *intern_str(int id)
+{
+    if (id < 0 || id >= intern_entries) return "?";
+    return &arena[offsets[id]];
+}
+
+size_t intern_count(void)
+{
+    return (size_t)intern_entries;
+}
+
+size_t intern_dup_bytes_saved(void)
+{
+    return dup_bytes;
+}
+
+void intern_report(void)
+{
+    ESP_LOGI(TAG, "%d strings, %u/%u arena bytes, %lu duplicate hits (%u bytes collapsed)",
+             intern_entries, (unsigned)arena_used, (unsigned)INTERN_ARENA_BYTES,
+             dup_hits, (unsigned)dup_bytes);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shared benchmark harness.
+//
+// Every lab used to measure time its own way (esp_timer here, tick
+// counts there), so numbers were never comparable run to run. This
+// component standardizes on the CPU cycle counter for timestamps, a
+// fixed-size sample series with outlier trimming for statistics, and a
+// one-line CSV record over UART ("PBCSV,...") that nightly runs can
+// grep out of the console log for trend tracking.
+
+#define PB_MAX_SAMPLES 512
+
+typedef struct {
+    const char *name;
+    uint32_t samples[PB_MAX_SAMPLES];   // raw cycle counts
+    size_t count;
+    uint32_t overflowed;                // samples dropped once full
+} pb_series_t;
+
+typedef struct {
+    uint32_t min_us;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+    size_t kept;        // samples after outlier trimming
+    size_t rejected;    // trimmed outliers
+} pb_stats_t;
+
+// Raw cycle-counter access (wraps at 2^32; fine for spans < ~10 s).
+uint32_t pb_cycles_now(void);
+uint32_t pb_cycles_to_us(uint32_t cycles);
+
+void pb_series_init(pb_series_t *s, const char *name);
+void pb_series_add(pb_series_t *s, uint32_t cycles);
+
+// Sorts the series, trims the top 1% as outliers (interrupt hits,
+// cache-cold first touches), and fills percentile stats in microseconds.
+void pb_series_stats(pb_series_t *s, pb_stats_t *out);
+
+// Logs a human-readable summary plus the machine-readable CSV line:
+//   PBCSV,<name>,<kept>,<min>,<p50>,<p95>,<p99>,<max>,<mean>
+void pb_series_report(pb_series_t *s);
+
+// Convenience runner: calls fn(arg) `warmup` times untimed, then
+// `iterations` times timed into an internal series, and reports it.
+typedef void (*pb_fn_t)(void *arg);
+void pb_run(const char *name, pb_fn_t fn, void *arg,
+            uint32_t warmup, uint32_t iterations);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,104 @@
+#include "perf_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+static const char *TAG = "PERF_BENCH";
+
+#define PB_CYCLES_PER_US (configCPU_CLOCK_HZ / 1000000)
+#define PB_OUTLIER_TRIM_PCT 1   // top 1% discarded
+
+uint32_t pb_cycles_now(void)
+{
+    return esp_cpu_get_cycle_count();
+}
+
+uint32_t pb_cycles_to_us(uint32_t cycles)
+{
+    return cycles / PB_CYCLES_PER_US;
+}
+
+void pb_series_init(pb_series_t *s, const char *name)
+{
+    s->name = name;
+    s->count = 0;
+    s->overflowed = 0;
+}
+
+void pb_series_add(pb_series_t *s, uint32_t cycles)
+{
+    if (s->count < PB_MAX_SAMPLES)
+        s->samples[s->count++] = cycles;
+    else
+        s->overflowed++;
+}
+
+static int pb_compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void pb_series_stats(pb_series_t *s, pb_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (s->count == 0)
+        return;
+
+    qsort(s->samples, s->count, sizeof(uint32_t), pb_compare_u32);
+
+    size_t rejected = (s->count * PB_OUTLIER_TRIM_PCT) / 100;
+    size_t kept = s->count - rejected;
+    if (kept == 0) { kept = s->count; rejected = 0; }
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kept; i++)
+        sum += s->samples[i];
+
+    out->kept = kept;
+    out->rejected = rejected;
+    out->min_us = pb_cycles_to_us(s->samples[0]);
+    out->p50_us = pb_cycles_to_us(s->samples[kept / 2]);
+    out->p95_us = pb_cycles_to_us(s->samples[(kept * 95) / 100]);
+    out->p99_us = pb_cycles_to_us(s->samples[(kept * 99) / 100]);
+    out->max_us = pb_cycles_to_us(s->samples[kept - 1]);
+    out->mean_us = pb_cycles_to_us((uint32_t)(sum / kept));
+}
+
+void pb_series_report(pb_series_t *s)
+{
+    pb_stats_t st;
+    pb_series_stats(s, &st);
+    if (st.kept == 0) {
+        ESP_LOGW(TAG, "%s: no samples", s->name);
+        return;
+    }
+    ESP_LOGI(TAG, "%s: n=%u min=%luus p50=%luus p95=%luus p99=%luus max=%luus mean=%luus (%u outliers)",
+             s->name, (unsigned)st.kept, st.min_us, st.p50_us, st.p95_us,
+             st.p99_us, st.max_us, st.mean_us, (unsigned)st.rejected);
+    // One greppable line per series for the nightly trend scraper.
+    printf("PBCSV,%s,%u,%lu,%lu,%lu,%lu,%lu,%lu\n",
+           s->name, (unsigned)st.kept, st.min_us, st.p50_us, st.p95_us,
+           st.p99_us, st.max_us, st.mean_us);
+}
+
+void pb_run(const char *name, pb_fn_t fn, void *arg,
+            uint32_t warmup, uint32_t iterations)
+{
+    static pb_series_t series;   // one runner at a time; series is large
+
+    for (uint32_t i = 0; i < warmup; i++)
+        fn(arg);
+
+    pb_series_init(&series, name);
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint32_t t0 = pb_cycles_now();
+        fn(arg);
+        pb_series_add(&series, pb_cycles_now() - t0);
+    }
+    pb_series_report(&series);
+}
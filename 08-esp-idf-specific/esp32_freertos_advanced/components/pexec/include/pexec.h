@@ -0,0 +1,51 @@
+// ===== pexec: rate-grouped periodic executor =====
+//
+// Strictly periodic work — monitors, reporters, housekeeping scans —
+// tends to accrete one task per job, each with its own stack and its own
+// timer wakeup. pexec groups jobs by rate instead: every rate group is
+// one task running one vTaskDelayUntil loop at the group's base period,
+// and each job declares (period, phase, budget) on top of it. Period
+// must be a multiple of the base; phase staggers jobs across base ticks
+// so a 10 s report and a 10 s scan don't land in the same wakeup; budget
+// is the execution time the job promised, and every overrun is counted
+// and logged so a creeping job is caught before it skews its group.
+//
+// Jobs sharing a base tick run back-to-back in registration order, which
+// is the point: one wakeup, one stack, N jobs.
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PEXEC_RATES_MAX 4
+#define PEXEC_JOBS_MAX  16
+
+typedef void (*pexec_job_fn_t)(void *ctx);
+
+// Declare a rate group; returns its id, or -1 when the table is full.
+// `stack_bytes` sizes the group's runner task for its heaviest tick.
+int pexec_add_rate(const char *name, uint32_t base_period_ms,
+                   UBaseType_t prio, uint32_t stack_bytes);
+
+// Register a job in a rate group. period_ms is rounded to a multiple of
+// the group's base period (minimum one base tick); phase_ms selects
+// which base tick within the period the job runs on; budget_ms is the
+// per-run execution budget enforced by overrun accounting. Returns the
+// job id, or -1.
+int pexec_add_job(int rate, const char *name, pexec_job_fn_t fn, void *ctx,
+                  uint32_t period_ms, uint32_t phase_ms, uint32_t budget_ms);
+
+// Create the runner tasks; call once after all registrations.
+esp_err_t pexec_start(void);
+
+// Per-job runs, average/max execution time and budget overruns.
+void pexec_report(void);
+
+#ifdef __cplusplus
+}
+#endif
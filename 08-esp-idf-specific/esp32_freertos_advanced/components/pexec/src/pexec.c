@@ -0,0 +1,134 @@
+// ===== pexec implementation =====
+#include "pexec.h"
+
+#include <string.h>
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "pexec";
+
+typedef struct {
+    const char *name;
+    pexec_job_fn_t fn;
+    void *ctx;
+    int rate;
+    uint32_t divider;       // base ticks between runs
+    uint32_t phase_slot;    // which tick within the divider window
+    uint64_t budget_us;
+    uint32_t runs;
+    uint32_t overruns;
+    uint64_t exec_us_total;
+    uint64_t exec_us_max;
+} pexec_job_t;
+
+typedef struct {
+    const char *name;
+    uint32_t base_period_ms;
+    UBaseType_t prio;
+    uint32_t stack_bytes;
+    uint32_t wakeups;
+    TaskHandle_t task;
+} pexec_rate_t;
+
+static pexec_rate_t rates[PEXEC_RATES_MAX];
+static pexec_job_t jobs[PEXEC_JOBS_MAX];
+static int rate_count = 0;
+static int job_count = 0;
+static bool started = false;
+
+int pexec_add_rate(const char *name, uint32_t base_period_ms,
+                   UBaseType_t prio, uint32_t stack_bytes)
+{
+    if (started || rate_count >= PEXEC_RATES_MAX || base_period_ms == 0) return -1;
+    pexec_rate_t *r = &rates[rate_count];
+    r->name = name;
+    r->base_period_ms = base_period_ms;
+    r->prio = prio;
+    r->stack_bytes = stack_bytes;
+    return rate_count++;
+}
+
+int pexec_add_job(int rate, const char *name, pexec_job_fn_t fn, void *ctx,
+                  uint32_t period_ms, uint32_t phase_ms, uint32_t budget_ms)
+{
+    if (started || rate < 0 || rate >= rate_count || fn == NULL ||
+        job_count >= PEXEC_JOBS_MAX) {
+        return -1;
+    }
+    pexec_job_t *j = &jobs[job_count];
+    j->name = name;
+    j->fn = fn;
+    j->ctx = ctx;
+    j->rate = rate;
+    j->divider = period_ms / rates[rate].base_period_ms;
+    if (j->divider == 0) j->divider = 1;
+    j->phase_slot = (phase_ms / rates[rate].base_period_ms) % j->divider;
+    j->budget_us = (uint64_t)budget_ms * 1000;
+    return job_count++;
+}
+
+// One delay-until loop per rate group. The tick counter selects which
+// jobs are due; due jobs run back-to-back in registration order.
+static void pexec_runner_task(void *arg)
+{
+    pexec_rate_t *rate = (pexec_rate_t *)arg;
+    int rate_id = (int)(rate - rates);
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t tick = 0;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(rate->base_period_ms));
+        rate->wakeups++;
+
+        for (int i = 0; i < job_count; i++) {
+            pexec_job_t *j = &jobs[i];
+            if (j->rate != rate_id || tick % j->divider != j->phase_slot) continue;
+
+            uint64_t t0 = esp_timer_get_time();
+            j->fn(j->ctx);
+            uint64_t us = esp_timer_get_time() - t0;
+
+            j->runs++;
+            j->exec_us_total += us;
+            if (us > j->exec_us_max) j->exec_us_max = us;
+            if (us > j->budget_us) {
+                j->overruns++;
+                ESP_LOGW(TAG, "⚠️ Job '%s' ran %lluus (budget %lluus)",
+                         j->name, us, j->budget_us);
+            }
+        }
+        tick++;
+    }
+}
+
+esp_err_t pexec_start(void)
+{
+    if (started || rate_count == 0) return ESP_ERR_INVALID_STATE;
+    for (int i = 0; i < rate_count; i++) {
+        if (xTaskCreate(pexec_runner_task, rates[i].name, rates[i].stack_bytes,
+                        &rates[i], rates[i].prio, &rates[i].task) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create runner '%s'", rates[i].name);
+            return ESP_FAIL;
+        }
+    }
+    started = true;
+    ESP_LOGI(TAG, "Started: %d jobs on %d rate tasks", job_count, rate_count);
+    return ESP_OK;
+}
+
+void pexec_report(void)
+{
+    ESP_LOGI(TAG, "⏲️ Executor: %d jobs / %d rate tasks", job_count, rate_count);
+    for (int r = 0; r < rate_count; r++) {
+        ESP_LOGI(TAG, "  rate '%s' (%lums base): %lu wakeups",
+                 rates[r].name, rates[r].base_period_ms, rates[r].wakeups);
+    }
+    for (int i = 0; i < job_count; i++) {
+        pexec_job_t *j = &jobs[i];
+        ESP_LOGI(TAG, "  %-14s every %lu ticks (slot %lu): %lu runs, avg %lluus, max %lluus, %lu overruns",
+                 j->name, j->divider, j->phase_slot, j->runs,
+                 j->runs ? j->exec_us_total / j->runs : 0,
+                 j->exec_us_max, j->overruns);
+    }
+}
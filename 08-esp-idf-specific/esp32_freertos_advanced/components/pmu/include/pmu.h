@@ -0,0 +1,64 @@
+// ===== pmu: scoped Xtensa performance-monitor regions =====
+//
+// Wall-clock timing says a region is slow; the performance monitors say
+// why. This wraps the low-level IDF `perfmon` driver with a region
+// abstraction: mark a code span with pmu_begin/pmu_end (or PMU_SCOPED)
+// and accumulate retired instructions, cycles, cache misses and pipeline
+// stalls across entries, then dump derived rates with pmu_report.
+//
+// The LX6 exposes two hardware counters per core, which is not enough to
+// watch everything at once. Counter 0 is pinned to retired instructions
+// (the normalizer every rate needs); counter 1 rotates through the
+// remaining events on successive entries, so a region that runs
+// repeatedly — a benchmark loop, a queue drain — converges on a full
+// profile after a handful of passes. Cycles come from the CPU cycle
+// counter, which costs nothing extra.
+//
+// Regions are per-core state: begin and end must run on the same core
+// with no pmu region nested inside (the hardware counters are shared).
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Events multiplexed onto the second hardware counter.
+typedef enum {
+    PMU_EV_ICACHE_MISS = 0,   // instruction fetches missing the cache
+    PMU_EV_DLOAD_MISS,        // data loads missing the cache
+    PMU_EV_STALL,             // pipeline bubble cycles (any cause)
+    PMU_EV_COUNT
+} pmu_event_t;
+
+typedef struct {
+    const char *name;
+    uint32_t enters;
+    uint64_t insns;                    // every entry contributes
+    uint64_t cycles;                   // every entry contributes
+    uint64_t events[PMU_EV_COUNT];     // accumulated per sampled event
+    uint64_t event_insns[PMU_EV_COUNT];// insns retired while sampling it
+    uint8_t next_ev;                   // rotation cursor
+    uint8_t active_ev;                 // event armed by the open begin
+    uint32_t cyc0;                     // cycle count at begin
+} pmu_region_t;
+
+// Static initializer; name should be short and stable (it keys the dump).
+#define PMU_REGION_INIT(region_name) { .name = (region_name) }
+
+void pmu_begin(pmu_region_t *r);
+void pmu_end(pmu_region_t *r);
+
+// Per-entry averages plus misses-per-1k-instructions and stall share,
+// each rate normalized by the instructions retired while its event was
+// actually being sampled.
+void pmu_report(const pmu_region_t *r);
+
+// Brace-less scoped form: PMU_SCOPED(&region) { hot code; }
+#define PMU_SCOPED(r) \
+    for (int _pmu_once = (pmu_begin(r), 0); !_pmu_once; _pmu_once = (pmu_end(r), 1))
+
+#ifdef __cplusplus
+}
+#endif
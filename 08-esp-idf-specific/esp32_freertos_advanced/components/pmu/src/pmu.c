@@ -0,0 +1,97 @@
+// ===== pmu implementation =====
+#include "pmu.h"
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "perfmon.h"
+#include "xtensa/xt_perf_consts.h"
+
+static const char *TAG = "pmu";
+
+// Hardware counter assignment: 0 = instructions (always), 1 = the
+// rotating event. select/mask pairs per pmu_event_t.
+#define PMU_CNT_INSN  0
+#define PMU_CNT_EVENT 1
+
+typedef struct {
+    uint16_t select;
+    uint16_t mask;
+} pmu_hw_event_t;
+
+static const pmu_hw_event_t hw_events[PMU_EV_COUNT] = {
+    [PMU_EV_ICACHE_MISS] = { XTPERF_CNT_I_MEM,     XTPERF_MASK_I_MEM_CACHE_MISSES },
+    [PMU_EV_DLOAD_MISS]  = { XTPERF_CNT_D_LOAD_U1, XTPERF_MASK_D_LOAD_CACHE_MISSES },
+    [PMU_EV_STALL]       = { XTPERF_CNT_BUBBLES,   XTPERF_MASK_BUBBLES_ALL },
+};
+
+static const char *event_names[PMU_EV_COUNT] = {
+    [PMU_EV_ICACHE_MISS] = "icache-miss",
+    [PMU_EV_DLOAD_MISS]  = "dload-miss",
+    [PMU_EV_STALL]       = "stall-cycles",
+};
+
+void pmu_begin(pmu_region_t *r)
+{
+    r->active_ev = r->next_ev;
+    r->next_ev = (uint8_t)((r->next_ev + 1) % PMU_EV_COUNT);
+
+    const pmu_hw_event_t *ev = &hw_events[r->active_ev];
+    // kernelcnt=0, tracelevel=-1: count at every interrupt level so ISR
+    // work inside the region is attributed to it, not hidden.
+    xtensa_perfmon_init(PMU_CNT_INSN, XTPERF_CNT_INSN, XTPERF_MASK_INSN_ALL, 0, -1);
+    xtensa_perfmon_init(PMU_CNT_EVENT, ev->select, ev->mask, 0, -1);
+    xtensa_perfmon_reset(PMU_CNT_INSN);
+    xtensa_perfmon_reset(PMU_CNT_EVENT);
+    r->cyc0 = esp_cpu_get_cycle_count();
+    xtensa_perfmon_start();
+}
+
+void pmu_end(pmu_region_t *r)
+{
+    xtensa_perfmon_stop();
+    uint32_t cycles = esp_cpu_get_cycle_count() - r->cyc0;
+    uint32_t insns = xtensa_perfmon_value(PMU_CNT_INSN);
+    uint32_t count = xtensa_perfmon_value(PMU_CNT_EVENT);
+
+    r->enters++;
+    r->insns += insns;
+    r->cycles += cycles;
+    r->events[r->active_ev] += count;
+    r->event_insns[r->active_ev] += insns;
+}
+
+void pmu_report(const pmu_region_t *r)
+{
+    if (r->enters == 0) {
+        ESP_LOGI(TAG, "region '%s': never entered", r->name);
+        return;
+    }
+
+    ESP_LOGI(TAG, "📟 region '%s': %lu enters, avg %llu insn / %llu cyc per entry (IPC %.2f)",
+             r->name, r->enters,
+             r->insns / r->enters, r->cycles / r->enters,
+             r->cycles ? (float)r->insns / (float)r->cycles : 0.0f);
+
+    for (int ev = 0; ev < PMU_EV_COUNT; ev++) {
+        if (r->event_insns[ev] == 0) {
+            ESP_LOGI(TAG, "  %-12s not sampled yet", event_names[ev]);
+            continue;
+        }
+        // Rate per 1k instructions retired while this event was armed —
+        // comparable across regions regardless of how big they are.
+        float per_1k = (float)r->events[ev] * 1000.0f / (float)r->event_insns[ev];
+        if (ev == PMU_EV_STALL) {
+            // Stalls are cycles, so the share of total cycles is the
+            // more actionable number.
+            uint64_t sampled_cycles = r->cycles * r->event_insns[ev] / r->insns;
+            float share = sampled_cycles
+                              ? (float)r->events[ev] * 100.0f / (float)sampled_cycles
+                              : 0.0f;
+            ESP_LOGI(TAG, "  %-12s %llu total, %.1f/1k insn (~%.0f%% of cycles)",
+                     event_names[ev], r->events[ev], per_1k, share);
+        } else {
+            ESP_LOGI(TAG, "  %-12s %llu total, %.1f/1k insn",
+                     event_names[ev], r->events[ev], per_1k);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// ===== pt: stackless coroutines over one FreeRTOS task =====
+//
+// A 2 KB stack per trivial blinker or poller is the most expensive way
+// to hold a line number. A protothread holds exactly that — the line to
+// resume at — in two bytes, so dozens of tiny state machines share one
+// real task and one real stack. The engine is the classic Duff's-device
+// switch: PT_BEGIN opens a switch on the stored line, each blocking
+// macro returns after recording __LINE__ as a case label, and the next
+// call jumps straight back to it.
+//
+// The price is explicit: locals do NOT survive a yield (keep state that
+// must persist in the ctx struct), one blocking macro per source line,
+// and scheduling is cooperative — a coroutine that never yields starves
+// the others on its runner task. Preemption between runner tasks still
+// works as usual; this only flattens what happens inside one.
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t lc;           // resume line, 0 = start from the top
+    TickType_t wake_at;    // earliest tick the scheduler may run us again
+} pt_t;
+
+// Coroutine return values, in scheduler-priority order.
+#define PT_WAITING 0   // condition not met yet, poll again soon
+#define PT_YIELDED 1   // made progress, run again when wake_at passes
+#define PT_ENDED   2   // fell off PT_END, never scheduled again
+
+typedef char (*pt_fn_t)(pt_t *pt, void *ctx);
+
+#define PT_BEGIN(pt) switch ((pt)->lc) { case 0:
+#define PT_END(pt)   } (pt)->lc = 0; return PT_ENDED
+
+// Give the runner back; resumes on the next scheduler pass.
+#define PT_YIELD(pt)                                  \
+    do {                                              \
+        (pt)->lc = __LINE__; return PT_YIELDED;       \
+        case __LINE__:;                               \
+    } while (0)
+
+// Re-test `cond` every scheduler pass until it holds.
+#define PT_WAIT_UNTIL(pt, cond)                       \
+    do {                                              \
+        (pt)->lc = __LINE__;                          \
+        case __LINE__:                                \
+        if (!(cond)) return PT_WAITING;               \
+    } while (0)
+
+// The coroutine analogue of vTaskDelay: yield and mark the earliest
+// tick the scheduler should bother with us again.
+#define PT_SLEEP_MS(pt, ms)                                           \
+    do {                                                              \
+        (pt)->wake_at = xTaskGetTickCount() + pdMS_TO_TICKS(ms);      \
+        PT_YIELD(pt);                                                 \
+    } while (0)
+
+// -------- Slot scheduler --------
+//
+// One runner task owns one scheduler. Each slot is a coroutine plus its
+// ctx; the run loop calls everything runnable, then sleeps until the
+// nearest wake_at so an all-sleeping roster costs zero CPU.
+#define PT_SCHED_SLOTS 16
+
+typedef struct {
+    pt_fn_t fn;
+    void *ctx;
+    const char *name;
+    pt_t pt;
+    bool enabled;        // cleared by pt_sched_set_enabled, skipped if false
+    bool ended;
+    uint32_t runs;       // calls that returned PT_YIELDED
+} pt_slot_t;
+
+typedef struct {
+    pt_slot_t slots[PT_SCHED_SLOTS];
+    int count;
+    uint32_t passes;     // scheduler loop iterations
+} pt_sched_t;
+
+void pt_sched_init(pt_sched_t *sched);
+// Returns the slot index (used for enable/disable), or -1 when full.
+int pt_sched_add(pt_sched_t *sched, pt_fn_t fn, void *ctx, const char *name);
+// Coroutine-level suspend/resume: a disabled slot keeps its state and
+// picks up where it left off when re-enabled.
+void pt_sched_set_enabled(pt_sched_t *sched, int slot, bool enabled);
+bool pt_sched_is_enabled(const pt_sched_t *sched, int slot);
+// Runs the roster forever on the calling task; never returns.
+void pt_sched_run(pt_sched_t *sched) __attribute__((noreturn));
+void pt_sched_report(const pt_sched_t *sched);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,89 @@
+// ===== pt slot scheduler implementation =====
+#include "pt.h"
+
+#include <string.h>
+#include "esp_log.h"
+
+static const char *TAG = "pt";
+
+void pt_sched_init(pt_sched_t *sched)
+{
+    memset(sched, 0, sizeof(*sched));
+}
+
+int pt_sched_add(pt_sched_t *sched, pt_fn_t fn, void *ctx, const char *name)
+{
+    if (sched->count >= PT_SCHED_SLOTS) {
+        ESP_LOGW(TAG, "⚠️ Scheduler full, '%s' not added", name);
+        return -1;
+    }
+    pt_slot_t *slot = &sched->slots[sched->count];
+    slot->fn = fn;
+    slot->ctx = ctx;
+    slot->name = name;
+    slot->enabled = true;
+    return sched->count++;
+}
+
+void pt_sched_set_enabled(pt_sched_t *sched, int slot, bool enabled)
+{
+    if (slot < 0 || slot >= sched->count) return;
+    sched->slots[slot].enabled = enabled;
+}
+
+bool pt_sched_is_enabled(const pt_sched_t *sched, int slot)
+{
+    if (slot < 0 || slot >= sched->count) return false;
+    return sched->slots[slot].enabled;
+}
+
+void pt_sched_run(pt_sched_t *sched)
+{
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        bool any_waiting = false;
+        TickType_t nearest = now + portMAX_DELAY / 2;
+
+        for (int i = 0; i < sched->count; i++) {
+            pt_slot_t *slot = &sched->slots[i];
+            if (!slot->enabled || slot->ended) continue;
+            // Signed tick compare so the wheel survives tick wraparound.
+            if ((int32_t)(slot->pt.wake_at - now) > 0) {
+                if ((int32_t)(slot->pt.wake_at - nearest) < 0) nearest = slot->pt.wake_at;
+                continue;
+            }
+            char rc = slot->fn(&slot->pt, slot->ctx);
+            if (rc == PT_ENDED) {
+                slot->ended = true;
+            } else if (rc == PT_WAITING) {
+                any_waiting = true;
+            } else {
+                slot->runs++;
+                if ((int32_t)(slot->pt.wake_at - nearest) < 0) nearest = slot->pt.wake_at;
+            }
+        }
+        sched->passes++;
+
+        // PT_WAIT_UNTIL slots need their condition re-tested, so cap the
+        // sleep at one tick while any are pending; otherwise sleep clean
+        // through to the nearest wake_at.
+        now = xTaskGetTickCount();
+        TickType_t sleep = 1;
+        if (!any_waiting && (int32_t)(nearest - now) > 1) {
+            sleep = nearest - now;
+        }
+        vTaskDelay(sleep);
+    }
+}
+
+void pt_sched_report(const pt_sched_t *sched)
+{
+    ESP_LOGI(TAG, "🧵 %d coroutines on one stack, %lu scheduler passes:",
+             sched->count, sched->passes);
+    for (int i = 0; i < sched->count; i++) {
+        const pt_slot_t *slot = &sched->slots[i];
+        ESP_LOGI(TAG, "  [%d] %-12s %s, %lu runs", i, slot->name,
+                 slot->ended ? "ended" : (slot->enabled ? "enabled" : "suspended"),
+                 slot->runs);
+    }
+}
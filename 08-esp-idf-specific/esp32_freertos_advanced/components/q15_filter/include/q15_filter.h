@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Q15 fixed-point filter stages.
+//
+// Samples are int16_t in Q15 (range [-1, 1)), updates use only integer
+// multiplies and shifts, so a filter bank runs on the second core without
+// touching the FPU — the per-sample cost is a handful of cycles, which is
+// what lets one core carry several times the channel count of the float
+// versions.
+typedef int16_t q15_t;
+
+#define Q15_ONE 0x7FFF
+
+q15_t q15_from_float(float x);
+float q15_to_float(q15_t x);
+
+// Moving average over a power-of-two window; the running sum makes each
+// update O(1) regardless of window length.
+typedef struct {
+    q15_t *buf;            // caller-owned, 1 << size_log2 entries
+    uint32_t size_log2;
+    uint32_t idx;
+    int32_t sum;
+} q15_mavg_t;
+
+void q15_mavg_init(q15_mavg_t *f, q15_t *storage, uint32_t size_log2);
+q15_t q15_mavg_update(q15_mavg_t *f, q15_t x);
+
+// Single-pole IIR: y += alpha * (x - y), alpha in Q15.
+typedef struct {
+    q15_t alpha;
+    int32_t state;         // Q15 value held in 32 bits for headroom
+} q15_iir1_t;
+
+void q15_iir1_init(q15_iir1_t *f, q15_t alpha);
+q15_t q15_iir1_update(q15_iir1_t *f, q15_t x);
+
+// Direct-form-I biquad. Coefficients are Q14 so feedback terms up to
+// |a| < 2 fit; history is kept in Q15.
+typedef struct {
+    int16_t b0, b1, b2;    // Q14 feed-forward
+    int16_t a1, a2;        // Q14 feedback (sign convention: y -= a*yN)
+    int32_t x1, x2, y1, y2;
+} q15_biquad_t;
+
+void q15_biquad_init(q15_biquad_t *f, int16_t b0, int16_t b1, int16_t b2,
+                     int16_t a1, int16_t a2);
+q15_t q15_biquad_update(q15_biquad_t *f, q15_t x);
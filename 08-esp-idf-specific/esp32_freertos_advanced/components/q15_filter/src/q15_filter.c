@@ -0,0 +1,79 @@
+#include "q15_filter.h"
+
+#include <string.h>
+
+static inline q15_t q15_sat(int32_t x)
+{
+    if (x > Q15_ONE) return Q15_ONE;
+    if (x < -Q15_ONE - 1) return (q15_t)(-Q15_ONE - 1);
+    return (q15_t)x;
+}
+
+q15_t q15_from_float(float x)
+{
+    if (x >= 1.0f) return Q15_ONE;
+    if (x <= -1.0f) return (q15_t)(-Q15_ONE - 1);
+    return (q15_t)(x * 32768.0f);
+}
+
+float q15_to_float(q15_t x)
+{
+    return (float)x / 32768.0f;
+}
+
+void q15_mavg_init(q15_mavg_t *f, q15_t *storage, uint32_t size_log2)
+{
+    f->buf = storage;
+    f->size_log2 = size_log2;
+    f->idx = 0;
+    f->sum = 0;
+    memset(storage, 0, sizeof(q15_t) << size_log2);
+}
+
+q15_t q15_mavg_update(q15_mavg_t *f, q15_t x)
+{
+    uint32_t mask = (1u << f->size_log2) - 1;
+    f->sum += x - f->buf[f->idx];
+    f->buf[f->idx] = x;
+    f->idx = (f->idx + 1) & mask;
+    return (q15_t)(f->sum >> f->size_log2);
+}
+
+void q15_iir1_init(q15_iir1_t *f, q15_t alpha)
+{
+    f->alpha = alpha;
+    f->state = 0;
+}
+
+q15_t q15_iir1_update(q15_iir1_t *f, q15_t x)
+{
+    // state += alpha * (x - state); one multiply, one shift.
+    f->state += ((int32_t)f->alpha * (x - f->state)) >> 15;
+    return (q15_t)f->state;
+}
+
+void q15_biquad_init(q15_biquad_t *f, int16_t b0, int16_t b1, int16_t b2,
+                     int16_t a1, int16_t a2)
+{
+    f->b0 = b0; f->b1 = b1; f->b2 = b2;
+    f->a1 = a1; f->a2 = a2;
+    f->x1 = f->x2 = f->y1 = f->y2 = 0;
+}
+
+q15_t q15_biquad_update(q15_biquad_t *f, q15_t x)
+{
+    // Q14 coefficients against Q15 history: the accumulator holds Q29,
+    // shifted back down by 14 with saturation.
+    int32_t acc = (int32_t)f->b0 * x
+                + (int32_t)f->b1 * f->x1
+                + (int32_t)f->b2 * f->x2
+                - (int32_t)f->a1 * f->y1
+                - (int32_t)f->a2 * f->y2;
+    int32_t y = acc >> 14;
+
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = q15_sat(y);
+    return (q15_t)f->y1;
+}
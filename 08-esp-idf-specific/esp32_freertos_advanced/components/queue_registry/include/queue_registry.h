@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue registry.
+//
+// A dozen queues across a firmware and no single view of queue pressure
+// means every backlog incident starts with adding log lines. Queues are
+// registered once at creation; one collector task then samples every
+// registered queue's depth, tracks its high-water mark, and accumulates
+// sender-reported blocked time. The whole state is exported as one
+// binary snapshot (fixed layout, one memcpy-friendly struct per queue)
+// and an alarm hook fires on the rising edge of a queue crossing its
+// configured fill threshold.
+
+#define QREG_MAX_QUEUES 16
+
+typedef struct {
+    uint8_t depth;           // last sampled
+    uint8_t high_water;      // max depth ever sampled
+    uint8_t capacity;
+    uint8_t alarmed;         // currently above threshold
+    uint32_t blocked_us;     // total sender blocked time reported
+    uint32_t alarm_count;    // rising edges
+} qreg_stats_t;
+
+typedef struct {
+    uint32_t seq;
+    uint8_t count;
+    qreg_stats_t queues[QREG_MAX_QUEUES];
+} qreg_snapshot_t;
+
+// Called from the collector task when a queue rises past its threshold.
+typedef void (*qreg_alarm_fn_t)(const char *name, uint8_t depth, uint8_t capacity);
+
+// Register a queue at creation time. `alarm_pct` is the fill percentage
+// that trips the alarm hook (0 disables). Returns the queue's registry
+// id, or -1 when the table is full.
+int qreg_register(const char *name, QueueHandle_t queue,
+                  uint8_t capacity, uint8_t alarm_pct);
+
+void qreg_set_alarm_hook(qreg_alarm_fn_t hook);
+
+// Senders that blocked report how long; O(1), callable from any task.
+void qreg_note_blocked(int id, uint32_t blocked_us);
+
+// Start the collector task; samples every registered queue each period.
+void qreg_start_collector(uint32_t period_ms);
+
+// Copy the latest sealed snapshot; returns bytes written.
+size_t qreg_snapshot(qreg_snapshot_t *out);
+
+// Human-readable one-line-per-queue dump through ESP_LOG.
+void qreg_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,134 @@
+#include "queue_registry.h"
+
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/task.h"
+#include "esp_log.h"
+
+static const char *TAG = "QREG";
+
+typedef struct {
+    const char *name;
+    QueueHandle_t queue;
+    uint8_t capacity;
+    uint8_t alarm_depth;               // precomputed threshold, 0 = off
+    atomic_uint_fast32_t blocked_us;   // senders add, collector folds in
+} qreg_entry_t;
+
+static qreg_entry_t entries[QREG_MAX_QUEUES];
+static int entry_count = 0;
+static qreg_snapshot_t snapshot;       // sealed by the collector
+static portMUX_TYPE snap_lock = portMUX_INITIALIZER_UNLOCKED;
+static qreg_alarm_fn_t alarm_hook = NULL;
+
+int qreg_register(const char *name, QueueHandle_t queue,
+                  uint8_t capacity, uint8_t alarm_pct)
+{
+    if (queue == NULL || capacity == 0 || entry_count >= QREG_MAX_QUEUES)
+    {
+        return -1;
+    }
+    qreg_entry_t *e = &entries[entry_count];
+    e->name = name;
+    e->queue = queue;
+    e->capacity = capacity;
+    e->alarm_depth = (alarm_pct > 0) ? (uint8_t)((capacity * alarm_pct) / 100) : 0;
+    atomic_store(&e->blocked_us, 0);
+    snapshot.queues[entry_count].capacity = capacity;
+    snapshot.count = entry_count + 1;
+    ESP_LOGI(TAG, "Registered '%s' (%u slots, alarm at %u)",
+             name, capacity, e->alarm_depth);
+    return entry_count++;
+}
+
+void qreg_set_alarm_hook(qreg_alarm_fn_t hook)
+{
+    alarm_hook = hook;
+}
+
+void qreg_note_blocked(int id, uint32_t blocked_us)
+{
+    if (id >= 0 && id < entry_count)
+    {
+        atomic_fetch_add_explicit(&entries[id].blocked_us, blocked_us,
+                                  memory_order_relaxed);
+    }
+}
+
+// One pass over the registry: sample, fold counters, seal, alarm.
+static void qreg_collect(void)
+{
+    qreg_snapshot_t next;
+    memcpy(&next, &snapshot, sizeof(next));
+    next.seq++;
+
+    for (int i = 0; i < entry_count; i++)
+    {
+        qreg_entry_t *e = &entries[i];
+        qreg_stats_t *s = &next.queues[i];
+        uint8_t depth = (uint8_t)uxQueueMessagesWaiting(e->queue);
+        s->depth = depth;
+        if (depth > s->high_water)
+        {
+            s->high_water = depth;
+        }
+        s->blocked_us = (uint32_t)atomic_load_explicit(&e->blocked_us,
+                                                       memory_order_relaxed);
+
+        bool over = (e->alarm_depth > 0 && depth >= e->alarm_depth);
+        if (over && !s->alarmed)
+        {
+            s->alarm_count++;
+            if (alarm_hook)
+            {
+                alarm_hook(e->name, depth, e->capacity);
+            }
+        }
+        s->alarmed = over;
+    }
+
+    portENTER_CRITICAL(&snap_lock);
+    memcpy(&snapshot, &next, sizeof(snapshot));
+    portEXIT_CRITICAL(&snap_lock);
+}
+
+static void qreg_collector_task(void *pvParameters)
+{
+    uint32_t period_ms = (uint32_t)(uintptr_t)pvParameters;
+    while (1)
+    {
+        qreg_collect();
+        vTaskDelay(pdMS_TO_TICKS(period_ms));
+    }
+}
+
+void qreg_start_collector(uint32_t period_ms)
+{
+    xTaskCreate(qreg_collector_task, "QRegCollect", 2560,
+                (void *)(uintptr_t)period_ms, 3, NULL);
+    ESP_LOGI(TAG, "Collector started (%lu ms, %d queues)",
+             (unsigned long)period_ms, entry_count);
+}
+
+size_t qreg_snapshot(qreg_snapshot_t *out)
+{
+    portENTER_CRITICAL(&snap_lock);
+    memcpy(out, &snapshot, sizeof(*out));
+    portEXIT_CRITICAL(&snap_lock);
+    return sizeof(*out);
+}
+
+void qreg_report(void)
+{
+    qreg_snapshot_t snap;
+    qreg_snapshot(&snap);
+    ESP_LOGI(TAG, "Queue pressure (seal #%lu):", (unsigned long)snap.seq);
+    for (int i = 0; i < entry_count; i++)
+    {
+        qreg_stats_t *s = &snap.queues[i];
+        ESP_LOGI(TAG, "  %-12s %2u/%2u (hiwater %2u) blocked %lu us, %lu alarms%s",
+                 entries[i].name, s->depth, s->capacity, s->high_water,
+                 (unsigned long)s->blocked_us, (unsigned long)s->alarm_count,
+                 s->alarmed ? " ⚠️" : "");
+    }
+}
@@ -12,4 +12,157 @@ typedef struct {
 
 esp_err_t sensor_manager_init(void);
 esp_err_t sensor_manager_start(void);
-QueueHandle_t sensor_manager_get_data_queue(void);
\ No newline at end of file
+QueueHandle_t sensor_manager_get_data_queue(void);
+
+// --- Double-buffered batch acquisition ---
+//
+// At high sample rates the per-sample queue send plus consumer wakeup
+// dominates CPU. In batch mode the driver fills one buffer of
+// SENSOR_BATCH_SIZE samples while the consumer owns the other; when the
+// fill buffer is full the two are swapped and the consumer receives a
+// single task notification, cutting wakeups by a factor of the batch size.
+#define SENSOR_BATCH_SIZE 32
+
+// Start batch acquisition; `consumer` is notified once per full buffer.
+esp_err_t sensor_manager_start_batch(TaskHandle_t consumer);
+
+// Call after taking the notification: returns the completed buffer and its
+// sample count. The buffer stays valid until the next notification.
+const sensor_data_t *sensor_manager_get_ready_batch(size_t *count);
+
+// --- Dual-watermark mode ---
+//
+// One acquisition stream, two latency classes: a control subscriber is
+// woken at an early watermark of SENSOR_BATCH_EARLY_MARK samples into
+// each buffer, while the telemetry subscriber still waits for the full
+// buffer swap. Control reads the stable prefix of the in-flight buffer
+// in place — no duplicate buffering — and must finish before that
+// buffer's next swap recycles it (a full buffer period away).
+#define SENSOR_BATCH_EARLY_MARK 4
+
+// Like sensor_manager_start_batch, with an additional early-watermark
+// subscriber. `control` may be NULL, degrading to full-buffer mode.
+esp_err_t sensor_manager_start_batch_dual(TaskHandle_t control,
+                                          TaskHandle_t telemetry);
+
+// Control-side read: the filled prefix of the buffer being acquired.
+// Never blocks; count is 0 right after a swap.
+const sensor_data_t *sensor_manager_peek_partial(size_t *count);
+
+// --- Multi-sensor plugin API ---
+//
+// Drivers register a read function and a sampling period; one scheduler
+// task services all of them earliest-deadline-first, so 16 sensors at
+// mixed rates cost one task (and one stack) instead of sixteen. Samples
+// land in a shared ring and the subscriber gets a single notification
+// per batch rather than one wakeup per sample.
+#define SENSOR_PLUGIN_MAX      16
+#define SENSOR_PLUGIN_RING     128   // power of two
+#define SENSOR_PLUGIN_BATCH    16    // samples per subscriber wakeup
+#define SENSOR_PLUGIN_FLUSH_MS 50    // max sample age before a forced flush
+
+typedef esp_err_t (*sensor_read_fn_t)(void *ctx, sensor_data_t *out);
+
+typedef struct {
+    uint8_t sensor_id;
+    sensor_data_t data;
+} sensor_sample_t;
+
+// Register a driver; returns its sensor_id, or -1 when the table is full.
+int sensor_manager_register(const char *name, sensor_read_fn_t read_fn,
+                            void *ctx, uint32_t period_ms);
+
+// Start the plugin scheduler; `subscriber` is notified once per batch.
+esp_err_t sensor_manager_start_plugins(TaskHandle_t subscriber);
+
+// Drain up to `max` samples from the shared ring; returns the count.
+size_t sensor_manager_read_samples(sensor_sample_t *out, size_t max);
+
+// --- Bus transaction scheduler ---
+//
+// Each sensor lives on a shared bus, and every independent read pays the
+// bus setup — driver entry, address phase, chip-select settle — before a
+// single data byte moves; on our I2C bus that overhead is ~60% of bus
+// time. The scheduler therefore coalesces: sensors due in the same wakeup
+// and on the same bus are read back-to-back as one transaction train,
+// paying the setup once per train instead of once per read. Deadline
+// awareness is kept inside the train: sensors with the smallest declared
+// slack lead it, so control-critical reads never wait behind bulk
+// telemetry that merely happened to be due at the same tick.
+#define SENSOR_BUS_MAX       4
+#define SENSOR_BUS_SETUP_US  120   // simulated per-transaction setup cost
+
+// Like sensor_manager_register, with a bus assignment and a slack budget.
+// `slack_ms` ranks the sensor inside its train — smaller goes first.
+// The plain register() places sensors on bus 0 with generous slack.
+int sensor_manager_register_on_bus(const char *name, sensor_read_fn_t read_fn,
+                                   void *ctx, uint32_t period_ms,
+                                   uint8_t bus, uint32_t slack_ms);
+
+// Per-bus coalescing counters: reads executed, trains (setups actually
+// paid), and setup time saved versus one transaction per read, in us.
+void sensor_manager_bus_stats(uint8_t bus, uint32_t *reads,
+                              uint32_t *trains, uint64_t *setup_saved_us);
+
+// --- Continuous ADC DMA acquisition ---
+//
+// A blocking one-shot conversion costs the caller the full conversion
+// wait (~40 us of busy CPU) per sample, which caps any polling loop in
+// the low kHz. In continuous mode the ADC free-runs into a DMA ring and
+// the CPU only drains finished frames in chunks, so the per-sample cost
+// amortizes to nanoseconds and 40 kHz on one channel is comfortable.
+#define SENSOR_ADC_SAMPLE_HZ   40000
+#define SENSOR_ADC_FRAME_BYTES 256   // one DMA frame; drain granularity
+
+// Start the ADC free-running on `channel` (ADC1) at SENSOR_ADC_SAMPLE_HZ.
+esp_err_t sensor_manager_start_adc_dma(int channel);
+
+// Drain up to `max` raw 12-bit samples already converted by DMA;
+// returns the count, 0 when no frame has completed yet. Never blocks.
+size_t sensor_manager_read_batch(uint16_t *out, size_t max);
+
+// --- Compile-time calibration curves ---
+//
+// Applying the calibration polynomial per reading in float costs real
+// CPU at 40 kHz. The polynomial is instead sampled at build time into a
+// piecewise-linear table (16 segments over the 12-bit range, Q16 fixed
+// point, const in flash); per-sample correction is then two loads, one
+// multiply and a shift. The table is generated in sensor_manager.c —
+// change the polynomial there and recompile.
+#define SENSOR_CAL_SEGMENTS 16
+
+typedef struct {
+    int32_t base_q16;    // corrected value at the segment start
+    int32_t slope_q16;   // delta across the segment's 256 raw counts
+} sensor_cal_seg_t;
+
+extern const sensor_cal_seg_t sensor_cal_curve[SENSOR_CAL_SEGMENTS];
+
+// Raw 12-bit count -> calibrated millivolts in Q16.
+static inline int32_t sensor_calibrate(uint16_t raw)
+{
+    const sensor_cal_seg_t *seg = &sensor_cal_curve[(raw >> 8) & 0x0F];
+    return seg->base_q16 + ((seg->slope_q16 * (int32_t)(raw & 0xFF)) >> 8);
+}
+
+// read_batch plus calibration applied during the drain.
+size_t sensor_manager_read_batch_calibrated(int32_t *out_mv_q16, size_t max);
+
+// --- Decimation engine ---
+//
+// Consumers want different rates from the same 40 kHz stream (control
+// at 1 kHz, telemetry at 10 Hz). Instead of every consumer filtering
+// the full stream itself, each registers a rate divider here; during
+// the batch drain every raw sample updates each divider's boxcar
+// accumulator once, and a full accumulator emits one anti-aliased
+// (boxcar-averaged) sample into that subscriber's private ring. The
+// stream is touched once regardless of how many rates hang off it.
+#define SENSOR_DECIM_MAX  4
+#define SENSOR_DECIM_RING 64   // power of two, per subscriber
+
+// Register a subscriber that wants the sample rate divided by `divide`
+// (e.g. 40 for 1 kHz, 4000 for 10 Hz). Returns its id, or -1.
+int sensor_manager_add_decimator(uint32_t divide);
+
+// Drain up to `max` decimated samples for subscriber `id`; never blocks.
+size_t sensor_manager_decim_read(int id, uint16_t *out, size_t max);
\ No newline at end of file
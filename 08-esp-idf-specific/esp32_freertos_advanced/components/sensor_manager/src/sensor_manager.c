@@ -1,6 +1,9 @@
 #include "sensor_manager.h"
+#include <stdatomic.h>
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_rom_sys.h"
+#include "esp_adc/adc_continuous.h"
 
 static const char *TAG = "SENSOR_MGR";
 
@@ -30,6 +33,586 @@ void sensor_task(void *parameter)
     }
 }
 
+// --- Double-buffered batch acquisition ---
+static sensor_data_t batch_buffers[2][SENSOR_BATCH_SIZE];
+static int fill_index = 0;                 // buffer currently being filled
+static size_t ready_count = 0;             // samples in the completed buffer
+static TaskHandle_t batch_consumer = NULL;
+static TaskHandle_t batch_control = NULL;  // early-watermark subscriber, optional
+static TaskHandle_t batch_task_handle = NULL;
+
+// Filled prefix of the in-flight buffer, published with release order so
+// the control subscriber's peek never sees a half-written sample.
+static atomic_uint_fast32_t fill_published;
+
+// Fills one buffer while the consumer owns the other; a single
+// notification per swap replaces one queue send + wakeup per sample.
+// With a control subscriber registered, the early watermark adds exactly
+// one extra wakeup per buffer — at SENSOR_BATCH_EARLY_MARK samples — so
+// the control loop sees fresh data a buffer period sooner than telemetry.
+static void sensor_batch_task(void *parameter)
+{
+    size_t filled = 0;
+
+    while (1)
+    {
+        sensor_data_t *slot = &batch_buffers[fill_index][filled];
+        slot->temperature = 25.0 + (rand() % 200) / 10.0;
+        slot->humidity = 40.0 + (rand() % 500) / 10.0;
+        slot->timestamp = xTaskGetTickCount();
+        filled++;
+        atomic_store_explicit(&fill_published, filled, memory_order_release);
+
+        if (filled == SENSOR_BATCH_EARLY_MARK && batch_control != NULL)
+        {
+            xTaskNotifyGive(batch_control);
+        }
+
+        if (filled == SENSOR_BATCH_SIZE)
+        {
+            ready_count = filled;
+            fill_index ^= 1;               // swap: consumer gets the full one
+            filled = 0;
+            atomic_store_explicit(&fill_published, 0, memory_order_release);
+            xTaskNotifyGive(batch_consumer);
+        }
+
+        // Simulated 100 Hz sampling; a real driver would block on DMA here.
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+esp_err_t sensor_manager_start_batch(TaskHandle_t consumer)
+{
+    return sensor_manager_start_batch_dual(NULL, consumer);
+}
+
+esp_err_t sensor_manager_start_batch_dual(TaskHandle_t control, TaskHandle_t telemetry)
+{
+    if (telemetry == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    batch_consumer = telemetry;
+    batch_control = control;
+
+    if (xTaskCreatePinnedToCore(sensor_batch_task, "SensorBatch", 3072, NULL, 5, &batch_task_handle, 1) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create batch acquisition task");
+        return ESP_FAIL;
+    }
+
+    if (control != NULL)
+    {
+        ESP_LOGI(TAG, "Batch acquisition started (%d samples/buffer, control watermark at %d)",
+                 SENSOR_BATCH_SIZE, SENSOR_BATCH_EARLY_MARK);
+    }
+    else
+    {
+        ESP_LOGI(TAG, "Batch acquisition started (%d samples/buffer)", SENSOR_BATCH_SIZE);
+    }
+    return ESP_OK;
+}
+
+const sensor_data_t *sensor_manager_peek_partial(size_t *count)
+{
+    if (count != NULL)
+    {
+        *count = atomic_load_explicit(&fill_published, memory_order_acquire);
+    }
+    return batch_buffers[fill_index];
+}
+
+const sensor_data_t *sensor_manager_get_ready_batch(size_t *count)
+{
+    if (count != NULL)
+    {
+        *count = ready_count;
+    }
+    // fill_index was flipped at swap time, so the other buffer is complete.
+    return batch_buffers[fill_index ^ 1];
+}
+
+// --- Multi-sensor plugin API ---
+typedef struct {
+    const char *name;
+    sensor_read_fn_t read_fn;
+    void *ctx;
+    TickType_t period;
+    TickType_t deadline;
+    uint8_t bus;
+    uint32_t slack_ms;               // train ordering: smaller goes first
+    uint32_t reads;
+    uint32_t overruns;
+} sensor_plugin_t;
+
+// Per-bus coalescing counters, updated only by the scheduler task.
+typedef struct {
+    uint32_t reads;
+    uint32_t trains;
+    uint64_t setup_saved_us;
+} sensor_bus_stats_t;
+
+static sensor_bus_stats_t bus_stats[SENSOR_BUS_MAX];
+
+static sensor_plugin_t plugins[SENSOR_PLUGIN_MAX];
+static int plugin_count = 0;
+static TaskHandle_t plugin_subscriber = NULL;
+static TaskHandle_t plugin_task_handle = NULL;
+
+// Shared sample ring: single producer (the scheduler) and single consumer
+// (the subscriber), so plain atomic indexes are enough.
+static sensor_sample_t plugin_ring[SENSOR_PLUGIN_RING];
+static atomic_uint_fast32_t plugin_head;   // advanced by the scheduler
+static atomic_uint_fast32_t plugin_tail;   // advanced by the subscriber
+static atomic_uint_fast32_t plugin_dropped;
+
+int sensor_manager_register_on_bus(const char *name, sensor_read_fn_t read_fn,
+                                   void *ctx, uint32_t period_ms,
+                                   uint8_t bus, uint32_t slack_ms)
+{
+    if (read_fn == NULL || period_ms == 0 || bus >= SENSOR_BUS_MAX ||
+        plugin_count >= SENSOR_PLUGIN_MAX)
+    {
+        return -1;
+    }
+    sensor_plugin_t *p = &plugins[plugin_count];
+    p->name = name;
+    p->read_fn = read_fn;
+    p->ctx = ctx;
+    p->period = pdMS_TO_TICKS(period_ms);
+    if (p->period == 0)
+    {
+        p->period = 1;
+    }
+    p->bus = bus;
+    p->slack_ms = slack_ms;
+    return plugin_count++;
+}
+
+int sensor_manager_register(const char *name, sensor_read_fn_t read_fn,
+                            void *ctx, uint32_t period_ms)
+{
+    // Legacy path: everything on bus 0, slack generous enough that these
+    // sensors never displace a declared control-critical read.
+    return sensor_manager_register_on_bus(name, read_fn, ctx, period_ms,
+                                          0, UINT32_MAX);
+}
+
+void sensor_manager_bus_stats(uint8_t bus, uint32_t *reads,
+                              uint32_t *trains, uint64_t *setup_saved_us)
+{
+    if (bus >= SENSOR_BUS_MAX)
+    {
+        return;
+    }
+    if (reads != NULL)
+    {
+        *reads = bus_stats[bus].reads;
+    }
+    if (trains != NULL)
+    {
+        *trains = bus_stats[bus].trains;
+    }
+    if (setup_saved_us != NULL)
+    {
+        *setup_saved_us = bus_stats[bus].setup_saved_us;
+    }
+}
+
+static void plugin_push(uint8_t id, const sensor_data_t *data)
+{
+    uint_fast32_t head = atomic_load_explicit(&plugin_head, memory_order_relaxed);
+    uint_fast32_t tail = atomic_load_explicit(&plugin_tail, memory_order_acquire);
+    if (head - tail >= SENSOR_PLUGIN_RING)
+    {
+        // Ring full: a stalled subscriber should not stall acquisition.
+        atomic_fetch_add_explicit(&plugin_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    sensor_sample_t *slot = &plugin_ring[head % SENSOR_PLUGIN_RING];
+    slot->sensor_id = id;
+    slot->data = *data;
+    atomic_store_explicit(&plugin_head, head + 1, memory_order_release);
+}
+
+size_t sensor_manager_read_samples(sensor_sample_t *out, size_t max)
+{
+    uint_fast32_t tail = atomic_load_explicit(&plugin_tail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&plugin_head, memory_order_acquire);
+    size_t n = 0;
+    while (tail != head && n < max)
+    {
+        out[n++] = plugin_ring[tail % SENSOR_PLUGIN_RING];
+        tail++;
+    }
+    atomic_store_explicit(&plugin_tail, tail, memory_order_release);
+    return n;
+}
+
+// One task services every registered sensor earliest-deadline-first. With
+// at most 16 entries a linear min-scan beats maintaining a heap, and the
+// scheduler sleeps exactly until the next deadline. Samples accumulate in
+// the ring; the subscriber is notified once per SENSOR_PLUGIN_BATCH
+// samples, or before any long sleep so nothing sits older than
+// SENSOR_PLUGIN_FLUSH_MS.
+static void plugin_scheduler_task(void *parameter)
+{
+    const TickType_t flush_ticks = pdMS_TO_TICKS(SENSOR_PLUGIN_FLUSH_MS);
+    size_t pending = 0;
+    uint32_t reported_drops = 0;
+
+    TickType_t now = xTaskGetTickCount();
+    for (int i = 0; i < plugin_count; i++)
+    {
+        plugins[i].deadline = now + plugins[i].period;
+    }
+
+    while (1)
+    {
+        now = xTaskGetTickCount();
+
+        TickType_t next = plugins[0].deadline;
+        for (int i = 1; i < plugin_count; i++)
+        {
+            if ((int32_t)(plugins[i].deadline - next) < 0)
+            {
+                next = plugins[i].deadline;
+            }
+        }
+
+        if ((int32_t)(next - now) > 0)
+        {
+            TickType_t sleep = next - now;
+            if (pending > 0 && sleep >= flush_ticks)
+            {
+                xTaskNotifyGive(plugin_subscriber);
+                pending = 0;
+            }
+            vTaskDelay(sleep);
+            now = xTaskGetTickCount();
+        }
+
+        // Collect everything due this wakeup, then service it bus by bus
+        // as transaction trains: one simulated setup per train instead of
+        // one per read. Within a train, insertion sort by declared slack
+        // keeps control-critical sensors at the front — at most 16
+        // entries, so the sort is cheaper than any cleverness.
+        int due[SENSOR_PLUGIN_MAX];
+        int due_count = 0;
+        for (int i = 0; i < plugin_count; i++)
+        {
+            if ((int32_t)(now - plugins[i].deadline) >= 0)
+            {
+                int j = due_count++;
+                while (j > 0 && plugins[due[j - 1]].slack_ms > plugins[i].slack_ms)
+                {
+                    due[j] = due[j - 1];
+                    j--;
+                }
+                due[j] = i;
+            }
+        }
+
+        for (uint8_t bus = 0; bus < SENSOR_BUS_MAX && due_count > 0; bus++)
+        {
+            uint32_t train_reads = 0;
+            for (int d = 0; d < due_count; d++)
+            {
+                sensor_plugin_t *p = &plugins[due[d]];
+                if (p->bus != bus)
+                {
+                    continue;
+                }
+                if (train_reads == 0)
+                {
+                    // Bus setup paid once; the reads that follow ride the
+                    // same train back-to-back.
+                    esp_rom_delay_us(SENSOR_BUS_SETUP_US);
+                    bus_stats[bus].trains++;
+                }
+                sensor_data_t data;
+                if (p->read_fn(p->ctx, &data) == ESP_OK)
+                {
+                    plugin_push((uint8_t)due[d], &data);
+                    pending++;
+                }
+                train_reads++;
+                p->reads++;
+                p->deadline += p->period;
+                if ((int32_t)(now - p->deadline) >= 0)
+                {
+                    // Fell a whole period behind: resynchronize rather than
+                    // burst-read to catch up.
+                    p->deadline = now + p->period;
+                    p->overruns++;
+                }
+            }
+            if (train_reads > 0)
+            {
+                bus_stats[bus].reads += train_reads;
+                bus_stats[bus].setup_saved_us +=
+                    (uint64_t)(train_reads - 1) * SENSOR_BUS_SETUP_US;
+            }
+        }
+
+        if (pending >= SENSOR_PLUGIN_BATCH)
+        {
+            xTaskNotifyGive(plugin_subscriber);
+            pending = 0;
+        }
+
+        uint32_t drops = atomic_load_explicit(&plugin_dropped, memory_order_relaxed);
+        if (drops != reported_drops)
+        {
+            ESP_LOGW(TAG, "Sample ring overflow: %lu dropped", (unsigned long)drops);
+            reported_drops = drops;
+        }
+    }
+}
+
+esp_err_t sensor_manager_start_plugins(TaskHandle_t subscriber)
+{
+    if (subscriber == NULL || plugin_count == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    plugin_subscriber = subscriber;
+
+    if (xTaskCreatePinnedToCore(plugin_scheduler_task, "SensorSched", 3072, NULL, 6, &plugin_task_handle, 1) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create plugin scheduler task");
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Plugin scheduler started: %d sensors, batch of %d",
+             plugin_count, SENSOR_PLUGIN_BATCH);
+    return ESP_OK;
+}
+
+// --- Continuous ADC DMA acquisition ---
+static inline void decim_feed(uint16_t raw);   // defined with the decimation engine
+
+static adc_continuous_handle_t adc_handle = NULL;
+static atomic_uint_fast32_t adc_samples_read;
+static atomic_uint_fast32_t adc_overflows;
+
+// DMA pool overflow means nobody drained fast enough; count it, the
+// hardware keeps converting into whatever space remains.
+static bool IRAM_ATTR adc_pool_ovf_cb(adc_continuous_handle_t handle,
+                                      const adc_continuous_evt_data_t *edata,
+                                      void *user_data)
+{
+    atomic_fetch_add_explicit(&adc_overflows, 1, memory_order_relaxed);
+    return false;
+}
+
+esp_err_t sensor_manager_start_adc_dma(int channel)
+{
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = SENSOR_ADC_FRAME_BYTES * 4,
+        .conv_frame_size = SENSOR_ADC_FRAME_BYTES,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &adc_handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create ADC DMA handle: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    adc_digi_pattern_config_t pattern = {
+        .atten = ADC_ATTEN_DB_12,
+        .channel = channel,
+        .unit = ADC_UNIT_1,
+        .bit_width = ADC_BITWIDTH_12,
+    };
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = SENSOR_ADC_SAMPLE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    };
+    err = adc_continuous_config(adc_handle, &dig_cfg);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to configure ADC DMA: %s", esp_err_to_name(err));
+        adc_continuous_deinit(adc_handle);
+        adc_handle = NULL;
+        return err;
+    }
+
+    adc_continuous_evt_cbs_t cbs = {
+        .on_pool_ovf = adc_pool_ovf_cb,
+    };
+    adc_continuous_register_event_callbacks(adc_handle, &cbs, NULL);
+
+    err = adc_continuous_start(adc_handle);
+    if (err == ESP_OK)
+    {
+        ESP_LOGI(TAG, "ADC DMA acquisition started: ch%d @ %d Hz, %d B frames",
+                 channel, SENSOR_ADC_SAMPLE_HZ, SENSOR_ADC_FRAME_BYTES);
+    }
+    return err;
+}
+
+size_t sensor_manager_read_batch(uint16_t *out, size_t max)
+{
+    if (adc_handle == NULL || out == NULL || max == 0)
+    {
+        return 0;
+    }
+
+    uint8_t frame[SENSOR_ADC_FRAME_BYTES];
+    size_t want = max * sizeof(adc_digi_output_data_t);
+    if (want > sizeof(frame))
+    {
+        want = sizeof(frame);
+    }
+
+    uint32_t got = 0;
+    // Zero timeout: either a frame has completed or the caller comes
+    // back later — this path never busy-waits on a conversion.
+    if (adc_continuous_read(adc_handle, frame, want, &got, 0) != ESP_OK)
+    {
+        return 0;
+    }
+
+    size_t n = 0;
+    for (uint32_t off = 0; off + sizeof(adc_digi_output_data_t) <= got;
+         off += sizeof(adc_digi_output_data_t))
+    {
+        adc_digi_output_data_t *item = (adc_digi_output_data_t *)&frame[off];
+        out[n++] = item->type1.data;
+        decim_feed(item->type1.data);
+    }
+    atomic_fetch_add_explicit(&adc_samples_read, n, memory_order_relaxed);
+    return n;
+}
+
+// --- Decimation engine ---
+typedef struct {
+    uint32_t divide;                   // 0 = slot unused
+    uint32_t count;                    // raw samples in the accumulator
+    uint32_t acc;                      // boxcar sum
+    uint16_t ring[SENSOR_DECIM_RING];
+    atomic_uint_fast32_t head;         // advanced by the drainer
+    atomic_uint_fast32_t tail;         // advanced by the subscriber
+    uint32_t dropped;
+} decimator_t;
+
+static decimator_t decimators[SENSOR_DECIM_MAX];
+
+int sensor_manager_add_decimator(uint32_t divide)
+{
+    if (divide == 0)
+    {
+        return -1;
+    }
+    for (int i = 0; i < SENSOR_DECIM_MAX; i++)
+    {
+        if (decimators[i].divide == 0)
+        {
+            decimators[i].count = 0;
+            decimators[i].acc = 0;
+            atomic_store(&decimators[i].head, 0);
+            atomic_store(&decimators[i].tail, 0);
+            decimators[i].divide = divide;
+            ESP_LOGI(TAG, "Decimator %d: /%lu (%lu Hz from %d Hz)",
+                     i, (unsigned long)divide,
+                     (unsigned long)(SENSOR_ADC_SAMPLE_HZ / divide),
+                     SENSOR_ADC_SAMPLE_HZ);
+            return i;
+        }
+    }
+    return -1;
+}
+
+// One update per raw sample per subscriber; emits when the boxcar fills.
+static inline void decim_feed(uint16_t raw)
+{
+    for (int i = 0; i < SENSOR_DECIM_MAX; i++)
+    {
+        decimator_t *d = &decimators[i];
+        if (d->divide == 0)
+        {
+            continue;
+        }
+        d->acc += raw;
+        if (++d->count == d->divide)
+        {
+            uint16_t avg = (uint16_t)(d->acc / d->divide);
+            d->acc = 0;
+            d->count = 0;
+            uint_fast32_t head = atomic_load_explicit(&d->head, memory_order_relaxed);
+            uint_fast32_t tail = atomic_load_explicit(&d->tail, memory_order_acquire);
+            if (head - tail >= SENSOR_DECIM_RING)
+            {
+                d->dropped++;
+                continue;
+            }
+            d->ring[head % SENSOR_DECIM_RING] = avg;
+            atomic_store_explicit(&d->head, head + 1, memory_order_release);
+        }
+    }
+}
+
+size_t sensor_manager_decim_read(int id, uint16_t *out, size_t max)
+{
+    if (id < 0 || id >= SENSOR_DECIM_MAX || decimators[id].divide == 0)
+    {
+        return 0;
+    }
+    decimator_t *d = &decimators[id];
+    uint_fast32_t tail = atomic_load_explicit(&d->tail, memory_order_relaxed);
+    uint_fast32_t head = atomic_load_explicit(&d->head, memory_order_acquire);
+    size_t n = 0;
+    while (tail != head && n < max)
+    {
+        out[n++] = d->ring[tail % SENSOR_DECIM_RING];
+        tail++;
+    }
+    atomic_store_explicit(&d->tail, tail, memory_order_release);
+    return n;
+}
+
+// --- Compile-time calibration curves ---
+// Transfer function for the 12 dB-attenuated input, fitted against the
+// reference meter: mv(x) = 142 + 0.825*x - 4e-7*x^2 (the quadratic term
+// models the ADC's high-end droop). Everything below is integer
+// constant arithmetic, so the whole table is computed by the compiler
+// and placed const in flash.
+#define CAL_A0_Q16      (142 * 65536)
+#define CAL_A1_Q16      54067                    // 0.825 in Q16
+#define CAL_POLY_Q16(x) (CAL_A0_Q16 + CAL_A1_Q16 * (int32_t)(x) \
+                         - (int32_t)(((int64_t)(x) * (x) * 2) / 5))
+
+#define CAL_SEG(s) { CAL_POLY_Q16((s) * 256), \
+                     CAL_POLY_Q16(((s) + 1) * 256) - CAL_POLY_Q16((s) * 256) }
+
+const sensor_cal_seg_t sensor_cal_curve[SENSOR_CAL_SEGMENTS] = {
+    CAL_SEG(0),  CAL_SEG(1),  CAL_SEG(2),  CAL_SEG(3),
+    CAL_SEG(4),  CAL_SEG(5),  CAL_SEG(6),  CAL_SEG(7),
+    CAL_SEG(8),  CAL_SEG(9),  CAL_SEG(10), CAL_SEG(11),
+    CAL_SEG(12), CAL_SEG(13), CAL_SEG(14), CAL_SEG(15),
+};
+
+size_t sensor_manager_read_batch_calibrated(int32_t *out_mv_q16, size_t max)
+{
+    uint16_t raw[SENSOR_ADC_FRAME_BYTES / sizeof(adc_digi_output_data_t)];
+    size_t want = max;
+    if (want > sizeof(raw) / sizeof(raw[0]))
+    {
+        want = sizeof(raw) / sizeof(raw[0]);
+    }
+    size_t n = sensor_manager_read_batch(raw, want);
+    for (size_t i = 0; i < n; i++)
+    {
+        out_mv_q16[i] = sensor_calibrate(raw[i]);
+    }
+    return n;
+}
+
 esp_err_t sensor_manager_init(void)
 {
     sensor_data_queue = xQueueCreate(10, sizeof(sensor_data_t));
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary telemetry wire format.
+//
+// Formatted statistics tables are expensive twice: printf on the device
+// and a regex on the collector. This codec emits compact binary frames
+// instead. A frame carries a schema ID (the collector knows which field
+// means what), a sequence number, and one zigzag varint per field -
+// delta-encoded against the previous frame of the same stream, so a
+// counter that grew by 3 costs one byte no matter how large its
+// absolute value is. No printf, no floats, no allocation.
+//
+// Frame layout:
+//   [0xA7][schema_id][varint seq][varint field_count][varint zigzag deltas...]
+//
+// The decoder below is the reference implementation for the collector
+// side; on-device it doubles as a round-trip self-check.
+
+#define TLC_MAGIC      0xA7
+#define TLC_FIELDS_MAX 16
+
+typedef struct {
+    uint8_t schema_id;
+    uint8_t field_count;
+    uint32_t seq;                       // frames emitted on this stream
+    uint32_t prev[TLC_FIELDS_MAX];      // delta reference
+} tlc_stream_t;
+
+void tlc_stream_init(tlc_stream_t *s, uint8_t schema_id, uint8_t field_count);
+
+// Encode one sample (field_count values) into `out`; returns the frame
+// length in bytes, or 0 if `cap` is too small. Worst case is
+// 3 + 5 * field_count bytes; deltas usually make it far less.
+size_t tlc_encode(tlc_stream_t *s, const uint32_t *fields,
+                  uint8_t *out, size_t cap);
+
+// Reference decoder: one per stream on the collector side. Returns the
+// number of bytes consumed, or 0 on a malformed frame. `fields_out`
+// must hold TLC_FIELDS_MAX values.
+typedef struct {
+    uint8_t schema_id;
+    uint32_t prev[TLC_FIELDS_MAX];
+} tlc_decoder_t;
+
+void tlc_decoder_init(tlc_decoder_t *d);
+size_t tlc_decode(tlc_decoder_t *d, const uint8_t *buf, size_t len,
+                  uint32_t *fields_out, uint8_t *count_out, uint32_t *seq_out);
+
+#ifdef __cplusplus
+}
+#endif
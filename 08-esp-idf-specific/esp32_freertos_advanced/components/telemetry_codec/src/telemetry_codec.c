@@ -0,0 +1,115 @@
+#include "telemetry_codec.h"
+
+#include <string.h>
+
+// ---- varint primitives ----
+// LEB128: 7 payload bits per byte, high bit marks continuation. Zigzag
+// folds negative deltas into small positives so a counter that dips
+// (resets, wrap) still encodes short.
+
+static size_t varint_put(uint8_t *out, size_t cap, uint32_t v)
+{
+    size_t n = 0;
+    do {
+        if (n >= cap) return 0;
+        uint8_t byte = v & 0x7F;
+        v >>= 7;
+        out[n++] = byte | (v ? 0x80 : 0);
+    } while (v);
+    return n;
+}
+
+static size_t varint_get(const uint8_t *buf, size_t len, uint32_t *out)
+{
+    uint32_t v = 0;
+    size_t n = 0;
+    int shift = 0;
+    while (n < len && shift < 35) {
+        uint8_t byte = buf[n++];
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *out = v;
+            return n;
+        }
+        shift += 7;
+    }
+    return 0;   // truncated or over-long
+}
+
+static inline uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// ---- encoder ----
+
+void tlc_stream_init(tlc_stream_t *s, uint8_t schema_id, uint8_t field_count)
+{
+    memset(s, 0, sizeof(*s));
+    s->schema_id = schema_id;
+    s->field_count = (field_count > TLC_FIELDS_MAX) ? TLC_FIELDS_MAX : field_count;
+}
+
+size_t tlc_encode(tlc_stream_t *s, const uint32_t *fields,
+                  uint8_t *out, size_t cap)
+{
+    size_t len = 0, n;
+
+    if (cap < 2) return 0;
+    out[len++] = TLC_MAGIC;
+    out[len++] = s->schema_id;
+
+    if ((n = varint_put(out + len, cap - len, s->seq)) == 0) return 0;
+    len += n;
+    if ((n = varint_put(out + len, cap - len, s->field_count)) == 0) return 0;
+    len += n;
+
+    for (int i = 0; i < s->field_count; i++) {
+        int32_t delta = (int32_t)(fields[i] - s->prev[i]);
+        if ((n = varint_put(out + len, cap - len, zigzag(delta))) == 0) return 0;
+        len += n;
+        s->prev[i] = fields[i];
+    }
+    s->seq++;
+    return len;
+}
+
+// ---- reference decoder ----
+
+void tlc_decoder_init(tlc_decoder_t *d)
+{
+    memset(d, 0, sizeof(*d));
+}
+
+size_t tlc_decode(tlc_decoder_t *d, const uint8_t *buf, size_t len,
+                  uint32_t *fields_out, uint8_t *count_out, uint32_t *seq_out)
+{
+    size_t pos = 0, n;
+    uint32_t seq, count;
+
+    if (len < 2 || buf[0] != TLC_MAGIC) return 0;
+    d->schema_id = buf[1];
+    pos = 2;
+
+    if ((n = varint_get(buf + pos, len - pos, &seq)) == 0) return 0;
+    pos += n;
+    if ((n = varint_get(buf + pos, len - pos, &count)) == 0) return 0;
+    pos += n;
+    if (count > TLC_FIELDS_MAX) return 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t zz;
+        if ((n = varint_get(buf + pos, len - pos, &zz)) == 0) return 0;
+        pos += n;
+        d->prev[i] += (uint32_t)unzigzag(zz);
+        fields_out[i] = d->prev[i];
+    }
+    *count_out = (uint8_t)count;
+    *seq_out = seq;
+    return pos;
+}
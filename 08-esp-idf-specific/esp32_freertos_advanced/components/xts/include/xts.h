@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Cross-core synchronized timestamps.
+//
+// Each core's cycle counter starts at a different moment and drifts on
+// its own, so stamping trace events with esp_cpu_get_cycle_count()
+// gives numbers that cannot be ordered across cores. The tracer and the
+// latency histograms need one timeline.
+//
+// This component runs one shared gptimer as the reference clock and
+// gives every core a cheap fast path: a cached (cycle count, timer
+// count) calibration pair, so a timestamp is one cycle-counter read and
+// a divide — no peripheral access. The pair is re-anchored against the
+// gptimer when it ages out, and the drift observed at each
+// recalibration is recorded, so the error bound is measured rather than
+// assumed. Calibration state is per-core and only ever touched by its
+// own core; there is no cross-core sharing to synchronize.
+//
+// xts_now_us() is safe from ISRs: the recalibration window is guarded
+// with a SAFE critical section and the gptimer raw read works in
+// interrupt context.
+
+// Starts the shared reference timer. Call once before the first
+// xts_now_us(); returns false if the gptimer could not be started.
+bool xts_init(void);
+
+// Cross-core comparable microseconds since xts_init(). Fast path on
+// every call except when the core's calibration pair has aged out.
+uint64_t xts_now_us(void);
+
+// Direct gptimer read — exact but touches the peripheral. The fast
+// path's recalibration anchor; useful as ground truth in tests.
+uint64_t xts_raw_us(void);
+
+// Per-core fast-path/recalibration counters and observed drift.
+void xts_report(void);
+
+#ifdef __cplusplus
+}
+#endif
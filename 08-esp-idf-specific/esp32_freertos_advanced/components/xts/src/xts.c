@@ -0,0 +1,118 @@
+#include "xts.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "driver/gptimer.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "XTS";
+
+// 1 MHz reference: one timer count is one microsecond, sub-microsecond
+// ordering comes from the cycle-counter fast path between anchors.
+#define XTS_RESOLUTION_HZ 1000000
+
+// Cycle counts per microsecond on the application cores. The divide in
+// the fast path compiles to a constant-reciprocal multiply.
+#define XTS_CYCLES_PER_US CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+
+// Re-anchor after ~1 s of fast-path use; long before 32-bit cycle wrap.
+#define XTS_RECAL_CYCLES (XTS_CYCLES_PER_US * 1000000u)
+
+typedef struct {
+    uint32_t c0;                 // cycle counter at the anchor
+    uint64_t t0;                 // gptimer count at the anchor
+    bool calibrated;
+    uint32_t fast_reads;
+    uint32_t recals;
+    int32_t last_drift_us;       // predicted minus actual at last re-anchor
+    uint32_t max_abs_drift_us;
+} xts_core_cal_t;
+
+static xts_core_cal_t xts_cal[portNUM_PROCESSORS];
+static portMUX_TYPE xts_muxes[portNUM_PROCESSORS] = {
+    portMUX_INITIALIZER_UNLOCKED,
+#if portNUM_PROCESSORS > 1
+    portMUX_INITIALIZER_UNLOCKED,
+#endif
+};
+static gptimer_handle_t xts_timer = NULL;
+
+bool xts_init(void)
+{
+    gptimer_config_t config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = XTS_RESOLUTION_HZ,
+    };
+    if (gptimer_new_timer(&config, &xts_timer) != ESP_OK ||
+        gptimer_enable(xts_timer) != ESP_OK ||
+        gptimer_start(xts_timer) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start reference gptimer");
+        xts_timer = NULL;
+        return false;
+    }
+    ESP_LOGI(TAG, "Reference clock running (%u MHz fast path, re-anchor every ~1s)",
+             (unsigned)XTS_CYCLES_PER_US);
+    return true;
+}
+
+uint64_t xts_raw_us(void)
+{
+    uint64_t count = 0;
+    if (xts_timer != NULL) {
+        gptimer_get_raw_count(xts_timer, &count);
+    }
+    return count;
+}
+
+// Takes a fresh (cycles, timer) anchor pair. The critical section keeps
+// the two reads back to back — a preemption between them would bake the
+// preemption length into every fast-path read until the next anchor.
+static void xts_recalibrate(xts_core_cal_t *cal, int core)
+{
+    portENTER_CRITICAL_SAFE(&xts_muxes[core]);
+    uint32_t c = esp_cpu_get_cycle_count();
+    uint64_t t = xts_raw_us();
+    portEXIT_CRITICAL_SAFE(&xts_muxes[core]);
+
+    if (cal->calibrated) {
+        uint64_t predicted = cal->t0 + (uint32_t)(c - cal->c0) / XTS_CYCLES_PER_US;
+        int32_t drift = (int32_t)(int64_t)(predicted - t);
+        cal->last_drift_us = drift;
+        uint32_t abs_drift = drift < 0 ? (uint32_t)-drift : (uint32_t)drift;
+        if (abs_drift > cal->max_abs_drift_us) {
+            cal->max_abs_drift_us = abs_drift;
+        }
+    }
+    cal->c0 = c;
+    cal->t0 = t;
+    cal->calibrated = true;
+    cal->recals++;
+}
+
+uint64_t xts_now_us(void)
+{
+    if (xts_timer == NULL) {
+        return 0;
+    }
+    int core = xPortGetCoreID();
+    xts_core_cal_t *cal = &xts_cal[core];
+
+    uint32_t delta = esp_cpu_get_cycle_count() - cal->c0;
+    if (!cal->calibrated || delta >= XTS_RECAL_CYCLES) {
+        xts_recalibrate(cal, core);
+        return cal->t0;
+    }
+    cal->fast_reads++;
+    return cal->t0 + delta / XTS_CYCLES_PER_US;
+}
+
+void xts_report(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        const xts_core_cal_t *cal = &xts_cal[core];
+        ESP_LOGI(TAG, "core%d: %lu fast reads, %lu re-anchors, drift last=%ldus max=%luus",
+                 core, cal->fast_reads, cal->recals,
+                 (long)cal->last_drift_us, cal->max_abs_drift_us);
+    }
+}
@@ -1,3 +1,5 @@
+#include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
@@ -6,43 +8,1187 @@
 #include "esp_task_wdt.h"
 #include "esp_heap_caps.h"
 #include "esp_ipc.h"
-#include "sensor_manager.h"   // Component
+#include "esp_cpu.h"
+#include "sensor_manager.h"     // Component
+#include "bcast_bus.h"          // Component
+#include "arena_allocator.h"    // Component
+#include "q15_filter.h"         // Component
+#include "intern.h"             // Component
 
 static const char *TAG = "APP_ORCH";
 
 // -------- Function Prototypes ----------
 void core_info_task(void *parameter);
+void processing_task(void *parameter);
 void hardware_integration_example(void);
 
+// -------- Cross-core data-sharing cost benchmark ----------
+// core_info_task used to print which core it ran on and nothing more.
+// The numbers behind an actual core-placement decision are measured here
+// once at boot: what a cross-core atomic round trip costs, what a queue
+// loses when producer and consumer share a core versus split cores, and
+// whether two hot counters on one line penalize each other. On the last
+// point: ESP32 internal SRAM is uncached, so the classic false-sharing
+// penalty should be near zero on this part — the split variant stays in
+// so that claim is a measurement, not folklore.
+#define XB_PINGPONGS   20000
+#define XB_QUEUE_ITEMS 20000
+#define XB_FS_INCS     200000
+
+static TaskHandle_t xb_main_handle;
+static atomic_uint xb_shared;
+static atomic_bool xb_stop;
+static atomic_uint xb_token;
+static QueueHandle_t xb_queue;
+
+// Counter pairs for the false-sharing comparison: one pair packed into a
+// single 32-byte line, one pair forced onto separate lines.
+static struct { volatile uint32_t a, b; } __attribute__((aligned(32))) xb_fs_shared;
+static struct { volatile uint32_t a; uint8_t pad[60]; volatile uint32_t b; }
+    __attribute__((aligned(32))) xb_fs_split;
+
+// Core-1 half of the atomic ping-pong: wait for the token, hand it back.
+static void xb_pong_task(void *arg)
+{
+    for (int i = 0; i < XB_PINGPONGS; i++)
+    {
+        while (atomic_load_explicit(&xb_token, memory_order_acquire) != 1) { }
+        atomic_store_explicit(&xb_token, 0, memory_order_release);
+    }
+    xTaskNotifyGive(xb_main_handle);
+    vTaskDelete(NULL);
+}
+
+// Core-1 hammer for the contended fetch_add measurement.
+static void xb_hammer_task(void *arg)
+{
+    while (!atomic_load(&xb_stop))
+    {
+        atomic_fetch_add(&xb_shared, 1);
+    }
+    xTaskNotifyGive(xb_main_handle);
+    vTaskDelete(NULL);
+}
+
+// Drains the benchmark queue until the last item, then reports back.
+static void xb_consumer_task(void *arg)
+{
+    uint32_t v;
+    do
+    {
+        xQueueReceive(xb_queue, &v, portMAX_DELAY);
+    } while (v != XB_QUEUE_ITEMS - 1);
+    xTaskNotifyGive(xb_main_handle);
+    vTaskDelete(NULL);
+}
+
+static uint32_t xb_queue_items_per_sec(int consumer_core)
+{
+    // Consumer one priority above the producer: same-core runs pay a
+    // context switch per item, split-core runs drain in parallel.
+    xTaskCreatePinnedToCore(xb_consumer_task, "XbCons", 2048, NULL, 6, NULL,
+                            consumer_core);
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < XB_QUEUE_ITEMS; i++)
+    {
+        xQueueSend(xb_queue, &i, portMAX_DELAY);
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    int64_t us = esp_timer_get_time() - t0;
+    return (uint32_t)((uint64_t)XB_QUEUE_ITEMS * 1000000 / us);
+}
+
+static void xb_fs_partner_task(void *arg)
+{
+    volatile uint32_t *ctr = arg;
+    for (uint32_t i = 0; i < XB_FS_INCS; i++)
+        (*ctr)++;
+    xTaskNotifyGive(xb_main_handle);
+    vTaskDelete(NULL);
+}
+
+// Cycles per increment on this core while core 1 hammers its counter of
+// the pair — same line or split line depending on the arguments.
+static uint32_t xb_fs_cycles(volatile uint32_t *mine, volatile uint32_t *theirs)
+{
+    xTaskCreatePinnedToCore(xb_fs_partner_task, "XbFs", 2048, (void *)theirs,
+                            8, NULL, 1);
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    for (uint32_t i = 0; i < XB_FS_INCS; i++)
+        (*mine)++;
+    uint32_t cycles = esp_cpu_get_cycle_count() - t0;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return cycles / XB_FS_INCS;
+}
+
+// One-shot, pinned to core 0 so every partner sits on core 1. Preemption
+// by the pipeline tasks adds noise to individual samples; the averages
+// over tens of thousands of operations absorb it.
+void xcore_benchmark_task(void *parameter)
+{
+    vTaskDelay(pdMS_TO_TICKS(3000));   // let boot-time chatter settle
+    xb_main_handle = xTaskGetCurrentTaskHandle();
+
+    ESP_LOGI(TAG, "=== Cross-core cost benchmark (this task on Core %d) ===",
+             xPortGetCoreID());
+
+    // Atomic RMW: uncontended baseline, then with core 1 hammering the
+    // same word, then the full cross-core round trip.
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < XB_PINGPONGS; i++)
+        atomic_fetch_add(&xb_shared, 1);
+    uint32_t rmw_alone = (esp_cpu_get_cycle_count() - t0) / XB_PINGPONGS;
+
+    atomic_store(&xb_stop, false);
+    xTaskCreatePinnedToCore(xb_hammer_task, "XbHammer", 2048, NULL, 8, NULL, 1);
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < XB_PINGPONGS; i++)
+        atomic_fetch_add(&xb_shared, 1);
+    uint32_t rmw_contended = (esp_cpu_get_cycle_count() - t0) / XB_PINGPONGS;
+    atomic_store(&xb_stop, true);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    atomic_store(&xb_token, 0);
+    xTaskCreatePinnedToCore(xb_pong_task, "XbPong", 2048, NULL, 8, NULL, 1);
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < XB_PINGPONGS; i++)
+    {
+        atomic_store_explicit(&xb_token, 1, memory_order_release);
+        while (atomic_load_explicit(&xb_token, memory_order_acquire) != 0) { }
+    }
+    uint32_t roundtrip = (esp_cpu_get_cycle_count() - t0) / XB_PINGPONGS;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    ESP_LOGI(TAG, "Atomic RMW: alone=%lu cyc, core1 hammering=%lu cyc, "
+                  "cross-core round trip=%lu cyc",
+             rmw_alone, rmw_contended, roundtrip);
+
+    // Queue throughput: same producer loop, consumer placement varies.
+    xb_queue = xQueueCreate(32, sizeof(uint32_t));
+    if (xb_queue)
+    {
+        uint32_t same = xb_queue_items_per_sec(0);
+        uint32_t split = xb_queue_items_per_sec(1);
+        ESP_LOGI(TAG, "Queue: same-core %lu items/s, split-core %lu items/s (%.2fx)",
+                 same, split, (float)split / same);
+        vQueueDelete(xb_queue);
+        xb_queue = NULL;
+    }
+
+    // False sharing: both cores increment their own counter; only the
+    // line placement differs between runs.
+    uint32_t shared_line = xb_fs_cycles(&xb_fs_shared.a, &xb_fs_shared.b);
+    uint32_t split_line = xb_fs_cycles(&xb_fs_split.a, &xb_fs_split.b);
+    ESP_LOGI(TAG, "Counter pair: shared line %lu cyc/inc, split lines %lu cyc/inc",
+             shared_line, split_line);
+
+    ESP_LOGI(TAG, "=== Cross-core benchmark done ===");
+    vTaskDelete(NULL);
+}
+
 // Simple demo task showing core distribution
 void core_info_task(void *parameter)
 {
     int core = xPortGetCoreID();
     ESP_LOGI(TAG, "Task running on Core %d", core);
 
+    // Two instances run this body; the first to claim it launches the
+    // cross-core benchmark, pinned to core 0 so the partners land opposite.
+    static atomic_bool xb_claimed;
+    if (!atomic_exchange(&xb_claimed, true))
+    {
+        xTaskCreatePinnedToCore(xcore_benchmark_task, "XCoreBench", 4096,
+                                NULL, 5, NULL, 0);
+    }
+
     while (1)
     {
         ESP_LOGI(TAG, "Core %d alive", core);
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+        // Per-core run-time breakdown, to verify the pipeline core split.
+        UBaseType_t task_count = uxTaskGetNumberOfTasks();
+        TaskStatus_t *statuses = malloc(task_count * sizeof(TaskStatus_t));
+        if (statuses != NULL)
+        {
+            uint32_t total_runtime = 0;
+            task_count = uxTaskGetSystemState(statuses, task_count, &total_runtime);
+
+            uint32_t core_runtime[2] = {0, 0};
+            for (UBaseType_t i = 0; i < task_count; i++)
+            {
+                BaseType_t task_core = statuses[i].xCoreID;
+                if (task_core == 0 || task_core == 1)
+                {
+                    core_runtime[task_core] += statuses[i].ulRunTimeCounter;
+                }
+            }
+            if (total_runtime > 0)
+            {
+                ESP_LOGI(TAG, "Run-time split: Core0 %.1f%% | Core1 %.1f%% (pinned work)",
+                         (float)core_runtime[0] * 100.0f / total_runtime,
+                         (float)core_runtime[1] * 100.0f / total_runtime);
+            }
+            free(statuses);
+        }
+#endif
         vTaskDelay(pdMS_TO_TICKS(2000));
     }
 }
 
+// -------- Incremental window statistics ----------
+// Recomputing an average over the whole window on every reading is
+// O(window) per sample - tolerable at 10 samples, not at 1000. This
+// keeps a running sum (subtract the evicted sample, add the new one)
+// and monotonic deques for min and max, so every statistic is O(1) per
+// sample and O(1) to read regardless of window width. The deques hold
+// sequence numbers of candidate extremes: a new sample pops everything
+// it dominates off the back, and the front expires when its sequence
+// number slides out of the window.
+#define RSTAT_CAPACITY 1024
+
+typedef struct
+{
+    float samples[RSTAT_CAPACITY];
+    uint32_t minq[RSTAT_CAPACITY];   // sequence numbers, increasing values
+    uint32_t maxq[RSTAT_CAPACITY];   // sequence numbers, decreasing values
+    uint32_t min_head, min_tail;     // deque cursors (monotonic, index % cap)
+    uint32_t max_head, max_tail;
+    uint32_t seq;                    // sequence number of the next sample
+    uint16_t window;
+    uint16_t count;
+    float sum;
+} rstat_t;
+
+static void rstat_init(rstat_t *r, uint16_t window)
+{
+    memset(r, 0, sizeof(*r));
+    r->window = (window > RSTAT_CAPACITY) ? RSTAT_CAPACITY : window;
+}
+
+static void rstat_add(rstat_t *r, float v)
+{
+    // Evict the sample falling out of the window: fix the sum, and
+    // expire it from the deque fronts if it was the reigning extreme.
+    if (r->count == r->window)
+    {
+        uint32_t expired = r->seq - r->window;
+        r->sum -= r->samples[expired % r->window];
+        if (r->min_head != r->min_tail && r->minq[r->min_head % RSTAT_CAPACITY] == expired)
+            r->min_head++;
+        if (r->max_head != r->max_tail && r->maxq[r->max_head % RSTAT_CAPACITY] == expired)
+            r->max_head++;
+    }
+    else
+    {
+        r->count++;
+    }
+
+    // Drop dominated candidates off the backs, then push this sample.
+    while (r->min_tail != r->min_head &&
+           r->samples[r->minq[(r->min_tail - 1) % RSTAT_CAPACITY] % r->window] >= v)
+        r->min_tail--;
+    r->minq[r->min_tail++ % RSTAT_CAPACITY] = r->seq;
+
+    while (r->max_tail != r->max_head &&
+           r->samples[r->maxq[(r->max_tail - 1) % RSTAT_CAPACITY] % r->window] <= v)
+        r->max_tail--;
+    r->maxq[r->max_tail++ % RSTAT_CAPACITY] = r->seq;
+
+    r->samples[r->seq % r->window] = v;
+    r->sum += v;
+    r->seq++;
+}
+
+static inline float rstat_mean(const rstat_t *r)
+{
+    return r->count ? r->sum / r->count : 0;
+}
+
+static inline float rstat_min(const rstat_t *r)
+{
+    return r->count ? r->samples[r->minq[r->min_head % RSTAT_CAPACITY] % r->window] : 0;
+}
+
+static inline float rstat_max(const rstat_t *r)
+{
+    return r->count ? r->samples[r->maxq[r->max_head % RSTAT_CAPACITY] % r->window] : 0;
+}
+
+// -------- Event-driven actuation with hysteresis ----------
+// An actuator loop that re-evaluates on every processed sample wakes a
+// hundred times a second to do nothing ninety-nine of them. Here the
+// processing stage owns the comparison and publishes only threshold
+// CROSSINGS; the actuator task blocks on the event queue and wakes
+// exactly when the decision changes, so its steady-state CPU is zero.
+// The on/off thresholds are separated by a hysteresis band so a reading
+// jittering around one threshold cannot generate an event storm.
+#define ACT_TEMP_ON_C   28.0f   // engage cooling above this
+#define ACT_TEMP_OFF_C  26.0f   // release below this; the gap is the band
+
+typedef struct
+{
+    bool engage;
+    float value;        // reading that caused the crossing
+    uint32_t timestamp;
+} actuation_event_t;
+
+static QueueHandle_t actuation_queue = NULL;
+static bool act_engaged = false;            // processing-stage state
+static uint32_t act_samples_evaluated = 0;
+static uint32_t act_events_published = 0;
+
+// Called by the processing stage per sample; cheap compare, and only a
+// band crossing touches the queue.
+static void actuation_evaluate(float temperature, uint32_t timestamp)
+{
+    act_samples_evaluated++;
+
+    bool engage;
+    if (!act_engaged && temperature > ACT_TEMP_ON_C)
+        engage = true;
+    else if (act_engaged && temperature < ACT_TEMP_OFF_C)
+        engage = false;
+    else
+        return;                              // inside the band: no event
+
+    act_engaged = engage;
+    actuation_event_t event = {
+        .engage = engage, .value = temperature, .timestamp = timestamp,
+    };
+    if (actuation_queue && xQueueSend(actuation_queue, &event, 0) == pdTRUE)
+        act_events_published++;
+}
+
+// Blocks until a crossing arrives - no polling, no periodic wakeups.
+void actuator_task(void *parameter)
+{
+    actuation_event_t event;
+    ESP_LOGI(TAG, "Actuator task: event-driven, sleeping until a crossing");
+
+    while (1)
+    {
+        if (xQueueReceive(actuation_queue, &event, portMAX_DELAY) == pdTRUE)
+        {
+            ESP_LOGI(TAG, "🔧 Actuator %s at %.1fC (ts=%lu) | %lu samples -> %lu events",
+                     event.engage ? "ENGAGED" : "released",
+                     event.value, event.timestamp,
+                     act_samples_evaluated, act_events_published);
+        }
+    }
+}
+
+// Consumes sensor samples and derives statistics. All per-cycle scratch
+// buffers come from an arena: each allocation is a pointer bump and the
+// whole lot is recycled with one O(1) reset at the end of the cycle, so
+// the processing loop never fragments the heap.
+void processing_task(void *parameter)
+{
+    static arena_t scratch_arena;
+    if (arena_init(&scratch_arena, 4096, MALLOC_CAP_INTERNAL) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Processing task: arena init failed");
+        vTaskDelete(NULL);
+    }
+
+    QueueHandle_t queue = sensor_manager_get_data_queue();
+    sensor_data_t sample;
+
+    // Wide window to prove the point: statistics cost is identical at
+    // 1000 samples and at 10.
+    static rstat_t temp_stats;
+    rstat_init(&temp_stats, 1000);
+
+    while (1)
+    {
+        if (xQueueReceive(queue, &sample, pdMS_TO_TICKS(5000)) == pdTRUE)
+        {
+            // One O(1) update keeps mean/min/max current over the last
+            // 1000 samples; the old per-sample rescan would walk the
+            // whole window here.
+            rstat_add(&temp_stats, sample.temperature);
+            actuation_evaluate(sample.temperature, sample.timestamp);
+
+            // Scratch report buffer for this cycle, arena-backed.
+            char *report = arena_alloc(&scratch_arena, 96);
+            if (report)
+            {
+                snprintf(report, 96, "T=%.1fC H=%.1f%% ts=%lu",
+                         sample.temperature, sample.humidity, sample.timestamp);
+                ESP_LOGI(TAG, "Processed: %s | window(%u): mean=%.1f min=%.1f max=%.1f",
+                         report, temp_stats.count, rstat_mean(&temp_stats),
+                         rstat_min(&temp_stats), rstat_max(&temp_stats));
+            }
+
+            arena_reset(&scratch_arena);   // one pointer store frees everything
+        }
+    }
+}
+
+// -------- Core-pinned pipeline mode ----------
+// Without explicit affinity the acquisition and processing tasks migrate
+// between cores and evict each other's cache lines. Pipeline mode pins
+// acquisition to core 0 and processing to core 1, with a dedicated queue
+// between them (one writer, one reader), so each stage keeps its working
+// set hot on its own core.
+#define PIPELINE_QUEUE_DEPTH 32
+
+static QueueHandle_t pipeline_queue = NULL;
+
+// -------- Broadcast bus ----------
+// The dashboard, logger, and control loop all want the same sensor
+// stream. Fanning it out over three queues costs a copy per consumer;
+// the bus publishes each sample once and every subscriber reads the
+// same slot through its own cursor.
+static bcast_bus_t sensor_bus;
+static sensor_data_t sensor_bus_slots[BCAST_SLOTS];
+
+void pipeline_acquire_task(void *parameter)
+{
+    sensor_data_t sample;
+    ESP_LOGI(TAG, "Pipeline acquisition pinned to Core %d", xPortGetCoreID());
+
+    while (1)
+    {
+        sample.temperature = 25.0 + (rand() % 200) / 10.0;
+        sample.humidity = 40.0 + (rand() % 500) / 10.0;
+        sample.timestamp = xTaskGetTickCount();
+
+        if (xQueueSend(pipeline_queue, &sample, 0) != pdTRUE)
+        {
+            ESP_LOGW(TAG, "Pipeline queue full, sample dropped");
+        }
+        bcast_bus_publish(&sensor_bus, &sample);   // fan-out, zero extra copies
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+// Smoothing path is selectable: the Q15 fast path keeps the FPU out of
+// the loop entirely, which is what lets core 1 carry more channels at
+// the same budget. Temperatures are scaled to [-1, 1) as fractions of
+// 100 °C; real firmware would feed the raw integer ADC counts straight
+// in and skip the float conversion too.
+#define PROCESSING_USE_Q15 1
+
+void pipeline_process_task(void *parameter)
+{
+    sensor_data_t sample;
+#if PROCESSING_USE_Q15
+    q15_iir1_t smooth_q15;
+    q15_iir1_init(&smooth_q15, q15_from_float(0.1f));
+#else
+    float smoothed = 0;
+#endif
+    ESP_LOGI(TAG, "Pipeline processing pinned to Core %d", xPortGetCoreID());
+
+    while (1)
+    {
+        if (xQueueReceive(pipeline_queue, &sample, portMAX_DELAY) == pdTRUE)
+        {
+#if PROCESSING_USE_Q15
+            q15_t y = q15_iir1_update(&smooth_q15,
+                                      q15_from_float(sample.temperature / 100.0f));
+            if ((sample.timestamp % 20) == 0)
+            {
+                ESP_LOGI(TAG, "Pipeline: smoothed T=%.1fC (Q15, Core %d)",
+                         q15_to_float(y) * 100.0f, xPortGetCoreID());
+            }
+#else
+            smoothed = smoothed * 0.9f + sample.temperature * 0.1f;
+            if ((sample.timestamp % 20) == 0)
+            {
+                ESP_LOGI(TAG, "Pipeline: smoothed T=%.1fC (Core %d)",
+                         smoothed, xPortGetCoreID());
+            }
+#endif
+        }
+    }
+}
+
+// Cycles-per-sample comparison between the float filters and the Q15
+// stages, run once on core 1 where the filter bank lives.
+void q15_benchmark_task(void *parameter)
+{
+    enum { SAMPLES = 4096 };
+    static q15_t mavg_storage[16];
+
+    q15_mavg_t mavg;
+    q15_iir1_t iir1;
+    q15_biquad_t biquad;
+    q15_mavg_init(&mavg, mavg_storage, 4);
+    q15_iir1_init(&iir1, q15_from_float(0.1f));
+    // Butterworth-ish low pass, coefficients in Q14.
+    q15_biquad_init(&biquad, 1310, 2620, 1310, -19415, 6606);
+
+    volatile float f_sink = 0;
+    volatile q15_t q_sink = 0;
+    float f_state = 0, f_win[16] = {0}, f_sum = 0;
+    int f_idx = 0;
+
+    // Float one-pole vs Q15 one-pole.
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        f_state = f_state * 0.9f + (float)(i & 0xFF) * 0.1f;
+        f_sink = f_state;
+    }
+    uint32_t float_iir = (esp_cpu_get_cycle_count() - t0) / SAMPLES;
+
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        q_sink = q15_iir1_update(&iir1, (q15_t)(i & 0xFF));
+    }
+    uint32_t q15_iir = (esp_cpu_get_cycle_count() - t0) / SAMPLES;
+
+    // Float 16-tap average vs Q15 moving average.
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        f_sum += (float)(i & 0xFF) - f_win[f_idx];
+        f_win[f_idx] = (float)(i & 0xFF);
+        f_idx = (f_idx + 1) & 15;
+        f_sink = f_sum / 16.0f;
+    }
+    uint32_t float_avg = (esp_cpu_get_cycle_count() - t0) / SAMPLES;
+
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        q_sink = q15_mavg_update(&mavg, (q15_t)(i & 0xFF));
+    }
+    uint32_t q15_avg = (esp_cpu_get_cycle_count() - t0) / SAMPLES;
+
+    // Q15 biquad (no float equivalent in the demo; absolute cost only).
+    t0 = esp_cpu_get_cycle_count();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        q_sink = q15_biquad_update(&biquad, (q15_t)(i & 0xFF));
+    }
+    uint32_t q15_bq = (esp_cpu_get_cycle_count() - t0) / SAMPLES;
+    (void)f_sink;
+    (void)q_sink;
+
+    ESP_LOGI(TAG, "Filter cost (cycles/sample): one-pole float=%lu q15=%lu | "
+                  "mavg16 float=%lu q15=%lu | biquad q15=%lu",
+             float_iir, q15_iir, float_avg, q15_avg, q15_bq);
+    vTaskDelete(NULL);
+}
+
+// Bus subscribers poll at their own cadence; each keeps a private cursor
+// and counts anything it was too slow to see.
+typedef struct {
+    const char *name;
+    uint32_t poll_ms;
+} bus_subscriber_params_t;
+
+void bus_subscriber_task(void *parameter)
+{
+    const bus_subscriber_params_t *params = parameter;
+    bcast_reader_t reader;
+    bcast_reader_init(&reader, &sensor_bus);
+
+    sensor_data_t sample;
+    uint32_t seen = 0, reports = 0;
+    float temp_sum = 0;
+
+    while (1)
+    {
+        while (bcast_bus_read(&sensor_bus, &reader, &sample))
+        {
+            seen++;
+            temp_sum += sample.temperature;
+        }
+        if (++reports % (10000 / params->poll_ms) == 0 && seen > 0)
+        {
+            ESP_LOGI(TAG, "[%s] %lu samples via bus, avg T=%.1fC, lost=%lu",
+                     params->name, seen, temp_sum / seen, reader.lost);
+        }
+        vTaskDelay(pdMS_TO_TICKS(params->poll_ms));
+    }
+}
+
+static void start_pipeline_mode(void)
+{
+    pipeline_queue = xQueueCreate(PIPELINE_QUEUE_DEPTH, sizeof(sensor_data_t));
+    if (pipeline_queue == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create pipeline queue");
+        return;
+    }
+    bcast_bus_init(&sensor_bus, sensor_bus_slots, sizeof(sensor_data_t));
+
+    static const bus_subscriber_params_t dashboard = {"Dashboard", 500};
+    static const bus_subscriber_params_t logger = {"Logger", 1000};
+    static const bus_subscriber_params_t control = {"Control", 100};
+    xTaskCreate(bus_subscriber_task, "BusDash", 3072, (void *)&dashboard, 4, NULL);
+    xTaskCreate(bus_subscriber_task, "BusLog", 3072, (void *)&logger, 3, NULL);
+    xTaskCreate(bus_subscriber_task, "BusCtrl", 3072, (void *)&control, 5, NULL);
+
+    xTaskCreatePinnedToCore(pipeline_acquire_task, "PipeAcq", 3072, NULL, 6, NULL, 0);
+    xTaskCreatePinnedToCore(pipeline_process_task, "PipeProc", 3072, NULL, 6, NULL, 1);
+    xTaskCreatePinnedToCore(q15_benchmark_task, "Q15Bench", 3072, NULL, 4, NULL, 1);
+    ESP_LOGI(TAG, "Pipeline mode: acquisition on Core 0, processing on Core 1");
+}
+
+// -------- SoA batch layout ----------
+// sensor_data_t batches are arrays-of-structs: computing temperature
+// statistics strides over humidity and timestamp fields it never reads,
+// wasting two thirds of every cache line. The SoA view keeps each field
+// in its own contiguous array, so a per-field pass streams exactly the
+// bytes it uses - and hands the compiler unit-stride loops it can
+// vectorize once the filters move over. Conversion happens once at the
+// acquisition boundary; everything downstream works field-wise.
+#define SOA_BATCH_MAX 256
+
+typedef struct
+{
+    float temperature[SOA_BATCH_MAX];
+    float humidity[SOA_BATCH_MAX];
+    uint32_t timestamp[SOA_BATCH_MAX];
+    size_t count;
+} sensor_batch_soa_t;
+
+static void soa_from_aos(sensor_batch_soa_t *soa, const sensor_data_t *aos, size_t count)
+{
+    if (count > SOA_BATCH_MAX)
+        count = SOA_BATCH_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        soa->temperature[i] = aos[i].temperature;
+        soa->humidity[i] = aos[i].humidity;
+        soa->timestamp[i] = aos[i].timestamp;
+    }
+    soa->count = count;
+}
+
+// Per-batch statistics over one contiguous field array.
+static void soa_field_stats(const float *field, size_t count,
+                            float *mean, float *min, float *max)
+{
+    float sum = 0, lo = field[0], hi = field[0];
+    for (size_t i = 0; i < count; i++)
+    {
+        sum += field[i];
+        if (field[i] < lo) lo = field[i];
+        if (field[i] > hi) hi = field[i];
+    }
+    *mean = sum / count;
+    *min = lo;
+    *max = hi;
+}
+
+// Same statistics off the interleaved AoS layout, for the benchmark.
+static void aos_stats(const sensor_data_t *batch, size_t count,
+                      float *t_mean, float *t_min, float *t_max,
+                      float *h_mean)
+{
+    float t_sum = 0, h_sum = 0, lo = batch[0].temperature, hi = lo;
+    for (size_t i = 0; i < count; i++)
+    {
+        t_sum += batch[i].temperature;
+        h_sum += batch[i].humidity;
+        if (batch[i].temperature < lo) lo = batch[i].temperature;
+        if (batch[i].temperature > hi) hi = batch[i].temperature;
+    }
+    *t_mean = t_sum / count;
+    *t_min = lo;
+    *t_max = hi;
+    *h_mean = h_sum / count;
+}
+
+// One-shot layout benchmark: identical statistics from both layouts at
+// batch sizes 64 and 256, plus what the boundary conversion costs.
+void soa_benchmark_task(void *parameter)
+{
+    static sensor_data_t aos[SOA_BATCH_MAX];
+    static sensor_batch_soa_t soa;
+    const size_t sizes[] = {64, 256};
+    const int reps = 200;
+
+    for (size_t i = 0; i < SOA_BATCH_MAX; i++)
+    {
+        aos[i].temperature = 20.0f + (rand() % 100) / 10.0f;
+        aos[i].humidity = 40.0f + (rand() % 400) / 10.0f;
+        aos[i].timestamp = i;
+    }
+
+    ESP_LOGI(TAG, "=== Batch layout benchmark (AoS vs SoA) ===");
+    for (int s = 0; s < 2; s++)
+    {
+        size_t n = sizes[s];
+        float tm, tl, th, hm, hl, hh;
+
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        for (int r = 0; r < reps; r++)
+            aos_stats(aos, n, &tm, &tl, &th, &hm);
+        uint32_t aos_cycles = (esp_cpu_get_cycle_count() - t0) / reps;
+
+        t0 = esp_cpu_get_cycle_count();
+        for (int r = 0; r < reps; r++)
+            soa_from_aos(&soa, aos, n);
+        uint32_t conv_cycles = (esp_cpu_get_cycle_count() - t0) / reps;
+
+        t0 = esp_cpu_get_cycle_count();
+        for (int r = 0; r < reps; r++)
+        {
+            soa_field_stats(soa.temperature, n, &tm, &tl, &th);
+            soa_field_stats(soa.humidity, n, &hm, &hl, &hh);
+        }
+        uint32_t soa_cycles = (esp_cpu_get_cycle_count() - t0) / reps;
+
+        ESP_LOGI(TAG, "batch %u: AoS %lu cycles | SoA %lu cycles (+%lu convert) | %.2fx",
+                 (unsigned)n, aos_cycles, soa_cycles, conv_cycles,
+                 (float)aos_cycles / soa_cycles);
+    }
+    vTaskDelete(NULL);
+}
+
+// Batch-mode consumer: one wakeup per SENSOR_BATCH_SIZE samples instead of
+// one per sample. Waits for the swap notification, converts the batch to
+// SoA at the boundary, then computes statistics field-wise.
+void batch_processing_task(void *parameter)
+{
+    static sensor_batch_soa_t soa;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        size_t count = 0;
+        const sensor_data_t *batch = sensor_manager_get_ready_batch(&count);
+        if (count == 0)
+            continue;
+
+        soa_from_aos(&soa, batch, count);
+
+        float t_mean, t_min, t_max, h_mean, h_min, h_max;
+        soa_field_stats(soa.temperature, soa.count, &t_mean, &t_min, &t_max);
+        soa_field_stats(soa.humidity, soa.count, &h_mean, &h_min, &h_max);
+
+        ESP_LOGI(TAG, "Batch of %u: T avg=%.1f [%.1f..%.1f] H avg=%.1f%% (Core %d)",
+                 (unsigned)soa.count, t_mean, t_min, t_max, h_mean,
+                 xPortGetCoreID());
+    }
+}
+
+// Early-watermark consumer: woken SENSOR_BATCH_EARLY_MARK samples into
+// each buffer, a full buffer period before BatchProc sees the data. Reads
+// the in-flight buffer's stable prefix in place — same stream, no second
+// buffer — and acts on the newest sample only; depth belongs to telemetry.
+void batch_control_task(void *parameter)
+{
+    uint32_t wakeups = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        size_t count = 0;
+        const sensor_data_t *partial = sensor_manager_peek_partial(&count);
+        if (count == 0)
+            continue;   // swap raced the wakeup; next watermark is coming
+
+        const sensor_data_t *newest = &partial[count - 1];
+        wakeups++;
+        if (newest->temperature > 42.0f)
+        {
+            ESP_LOGW(TAG, "Control: T=%.1f over limit, trimming (lead over telemetry: %u samples)",
+                     newest->temperature, (unsigned)(SENSOR_BATCH_SIZE - count));
+        }
+        else if (wakeups % 32 == 0)
+        {
+            ESP_LOGI(TAG, "Control: %lu early wakeups, latest T=%.1f at %u/%d filled",
+                     wakeups, newest->temperature, (unsigned)count, SENSOR_BATCH_SIZE);
+        }
+    }
+}
+
+// -------- Plugin-mode sensors ----------
+// Sixteen simulated drivers at mixed rates, all serviced by the single
+// plugin scheduler in the sensor_manager component. Each driver is just a
+// read function plus a context; here the context picks the channel.
+static esp_err_t simulated_sensor_read(void *ctx, sensor_data_t *out)
+{
+    int channel = (int)(intptr_t)ctx;
+    out->temperature = 20.0f + channel + (rand() % 100) / 10.0f;
+    out->humidity = 30.0f + (rand() % 600) / 10.0f;
+    out->timestamp = xTaskGetTickCount();
+    return ESP_OK;
+}
+
+// Drains the shared ring once per batch notification and keeps per-sensor
+// counts; one wakeup covers samples from every registered driver.
+void plugin_consumer_task(void *parameter)
+{
+    static uint32_t per_sensor[SENSOR_PLUGIN_MAX];
+    sensor_sample_t samples[SENSOR_PLUGIN_BATCH];
+    uint32_t wakeups = 0, total = 0;
+
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        wakeups++;
+
+        size_t n;
+        while ((n = sensor_manager_read_samples(samples, SENSOR_PLUGIN_BATCH)) > 0)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                per_sensor[samples[i].sensor_id]++;
+            }
+            total += n;
+        }
+
+        if (wakeups % 32 == 0)
+        {
+            ESP_LOGI(TAG, "Plugins: %lu samples over %lu wakeups (%.1f/wakeup), "
+                          "fastest ch0=%lu slowest ch15=%lu",
+                     total, wakeups, (float)total / wakeups,
+                     per_sensor[0], per_sensor[SENSOR_PLUGIN_MAX - 1]);
+            for (uint8_t bus = 0; bus < 3; bus++)
+            {
+                uint32_t reads, trains;
+                uint64_t saved_us;
+                sensor_manager_bus_stats(bus, &reads, &trains, &saved_us);
+                if (reads > 0)
+                {
+                    ESP_LOGI(TAG, "  Bus %u: %lu reads in %lu trains "
+                                  "(%.1f reads/setup), %llu us setup saved",
+                             bus, reads, trains, (float)reads / trains,
+                             (unsigned long long)saved_us);
+                }
+            }
+        }
+    }
+}
+
+static void start_plugin_mode(void)
+{
+    // Mixed rates: four fast channels down to four slow ones. Sensors
+    // share three buses so the transaction scheduler has trains to build;
+    // the two 20 ms channels are the control loop's and declare zero
+    // slack, putting them at the head of every train they ride.
+    static const uint32_t periods_ms[SENSOR_PLUGIN_MAX] = {
+        20, 20, 50, 50, 100, 100, 100, 200,
+        200, 200, 500, 500, 500, 1000, 1000, 2000,
+    };
+    static char names[SENSOR_PLUGIN_MAX][12];
+
+    for (int i = 0; i < SENSOR_PLUGIN_MAX; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "sim%d", i);
+        uint32_t slack_ms = (i < 2) ? 0 : periods_ms[i] / 2;
+        if (sensor_manager_register_on_bus(names[i], simulated_sensor_read,
+                                           (void *)(intptr_t)i, periods_ms[i],
+                                           (uint8_t)(i % 3), slack_ms) < 0)
+        {
+            ESP_LOGE(TAG, "Failed to register sensor %d", i);
+        }
+    }
+
+    TaskHandle_t consumer = NULL;
+    xTaskCreate(plugin_consumer_task, "PluginCons", 4096, NULL, 5, &consumer);
+    sensor_manager_start_plugins(consumer);
+}
+
+// -------- EDF control-loop executive ----------
+// Composing several control loops as separate tasks means inventing a
+// fixed priority for each and hoping the mix never changes. The
+// executive below runs them all in one task, earliest-deadline-first:
+// loops register (period, relative deadline, WCET estimate), an
+// admission test rejects any set whose WCET/period utilization exceeds
+// the bound up front, and the dispatcher always runs the released job
+// whose absolute deadline is nearest. Same shape as the sensor plugin
+// scheduler, applied to control.
+#define EDF_LOOPS_MAX      8
+#define EDF_UTIL_LIMIT_PCT 90     // keep headroom below the EDF bound of 100%
+
+typedef void (*control_loop_fn_t)(void *arg);
+
+typedef struct
+{
+    const char *name;
+    control_loop_fn_t fn;
+    void *arg;
+    uint64_t period_us;
+    uint64_t deadline_us;      // relative to release
+    uint32_t wcet_us;          // declared worst-case execution time
+    uint64_t next_release_us;
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t worst_exec_us;
+} edf_loop_t;
+
+static edf_loop_t edf_loops[EDF_LOOPS_MAX];
+static int edf_loop_count = 0;
+static uint32_t edf_util_pct = 0;
+
+// Admission test: utilization must stay under the bound or the loop is
+// rejected here, at registration, instead of missing deadlines later.
+int edf_register(const char *name, control_loop_fn_t fn, void *arg,
+                 uint32_t period_ms, uint32_t deadline_ms, uint32_t wcet_us)
+{
+    if (edf_loop_count >= EDF_LOOPS_MAX)
+        return -1;
+
+    uint32_t load_pct = wcet_us / (period_ms * 10);   // wcet/period in %
+    if (edf_util_pct + load_pct > EDF_UTIL_LIMIT_PCT)
+    {
+        ESP_LOGE(TAG, "EDF: REJECTED %s - %lu%% would push utilization to %lu%% (limit %d%%)",
+                 name, load_pct, edf_util_pct + load_pct, EDF_UTIL_LIMIT_PCT);
+        return -1;
+    }
+    edf_util_pct += load_pct;
+
+    edf_loop_t *l = &edf_loops[edf_loop_count];
+    l->name = name;
+    l->fn = fn;
+    l->arg = arg;
+    l->period_us = (uint64_t)period_ms * 1000;
+    l->deadline_us = (uint64_t)deadline_ms * 1000;
+    l->wcet_us = wcet_us;
+    ESP_LOGI(TAG, "EDF: admitted %s (%lu ms / %lu us WCET), utilization now %lu%%",
+             name, period_ms, wcet_us, edf_util_pct);
+    return edf_loop_count++;
+}
+
+void edf_dispatcher_task(void *parameter)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < edf_loop_count; i++)
+        edf_loops[i].next_release_us = start + edf_loops[i].period_us;
+
+    uint32_t dispatches = 0;
+
+    while (1)
+    {
+        int64_t now = esp_timer_get_time();
+
+        // Among released jobs, find the nearest absolute deadline.
+        edf_loop_t *pick = NULL;
+        int64_t soonest_release = INT64_MAX;
+        for (int i = 0; i < edf_loop_count; i++)
+        {
+            edf_loop_t *l = &edf_loops[i];
+            if ((int64_t)l->next_release_us <= now)
+            {
+                if (pick == NULL ||
+                    l->next_release_us + l->deadline_us <
+                        pick->next_release_us + pick->deadline_us)
+                    pick = l;
+            }
+            else if ((int64_t)l->next_release_us < soonest_release)
+            {
+                soonest_release = l->next_release_us;
+            }
+        }
+
+        if (pick == NULL)
+        {
+            // Idle until the next release (tick granularity is fine:
+            // periods are tens of milliseconds).
+            int64_t sleep_ms = (soonest_release - now) / 1000;
+            vTaskDelay(pdMS_TO_TICKS(sleep_ms > 0 ? sleep_ms : 1));
+            continue;
+        }
+
+        uint64_t abs_deadline = pick->next_release_us + pick->deadline_us;
+        int64_t t0 = esp_timer_get_time();
+        pick->fn(pick->arg);
+        int64_t t1 = esp_timer_get_time();
+
+        uint32_t exec_us = (uint32_t)(t1 - t0);
+        if (exec_us > pick->worst_exec_us)
+            pick->worst_exec_us = exec_us;
+        pick->runs++;
+        if ((uint64_t)t1 > abs_deadline)
+        {
+            pick->misses++;
+            ESP_LOGW(TAG, "EDF: %s missed deadline by %lld us", pick->name,
+                     t1 - (int64_t)abs_deadline);
+        }
+        pick->next_release_us += pick->period_us;
+
+        if (++dispatches % 500 == 0)
+        {
+            ESP_LOGI(TAG, "EDF report (util %lu%%):", edf_util_pct);
+            for (int i = 0; i < edf_loop_count; i++)
+            {
+                edf_loop_t *l = &edf_loops[i];
+                ESP_LOGI(TAG, "  %s: %lu runs, %lu misses, worst %lu us (WCET est %lu)",
+                         l->name, l->runs, l->misses, l->worst_exec_us, l->wcet_us);
+            }
+        }
+    }
+}
+
+// Simulated control loops: busy work scaled to the declared WCET.
+static void control_loop_body(void *arg)
+{
+    int iterations = (int)(intptr_t)arg;
+    volatile float u = 1.0f;
+    for (int i = 0; i < iterations; i++)
+        u = u * 1.0001f + 0.01f;
+}
+
+static void start_edf_mode(void)
+{
+    edf_register("AttitudeLoop", control_loop_body, (void *)20000, 20, 15, 900);
+    edf_register("SpeedLoop", control_loop_body, (void *)40000, 50, 40, 1800);
+    edf_register("ThermalLoop", control_loop_body, (void *)10000, 100, 100, 500);
+    // Deliberately infeasible: demonstrates the admission test rejecting
+    // overload at registration time instead of thrashing at runtime.
+    edf_register("GreedyLoop", control_loop_body, (void *)4000000, 20, 20, 19000);
+
+    xTaskCreatePinnedToCore(edf_dispatcher_task, "EdfExec", 4096, NULL, 7, NULL, 1);
+    ESP_LOGI(TAG, "EDF executive started on Core 1");
+}
+
+// Placeholder for the hardware integration walkthrough in the worksheet.
+void hardware_integration_example(void)
+{
+    ESP_LOGI(TAG, "Hardware integration example: see worksheet section 8");
+}
+
+// ===== Declarative task table =====
+//
+// app_main used to create its tasks one xTaskCreate at a time — each a
+// runtime heap allocation for stack plus TCB, and the only way to audit
+// the task set was to read the whole function. The table below declares
+// every app_main-level task in one place; the X-macro expands it twice,
+// once into static stacks/TCBs sized per entry and once into the const
+// descriptor array, so creation is a loop over xTaskCreateStatic with
+// zero task-related heap. Tasks whose creation is gated (the sensor
+// set) carry a group tag and start only when their gate passes. Tasks
+// created inside their own demo starters (pipeline, EDF, plugin, bus)
+// stay there — they need per-instance arguments the table can't carry.
+//
+//               id          entry                  name          stack  prio  core  group
+#define TASK_TABLE(X)                                                              \
+    X(task_a,     core_info_task,        "TaskA",      4096, 5, -1, TT_BOOT)       \
+    X(task_b,     core_info_task,        "TaskB",      4096, 5, -1, TT_BOOT)       \
+    X(processing, processing_task,       "Processing", 4096, 5, -1, TT_SENSOR)     \
+    X(actuator,   actuator_task,         "Actuator",   3072, 6, -1, TT_SENSOR)     \
+    X(batch_proc, batch_processing_task, "BatchProc",  4096, 5, -1, TT_SENSOR)     \
+    X(batch_ctrl, batch_control_task,    "BatchCtrl",  3072, 7, -1, TT_SENSOR)     \
+    X(soa_bench,  soa_benchmark_task,    "SoABench",   4096, 3, -1, TT_SENSOR)
+
+typedef enum { TT_BOOT, TT_SENSOR } tt_group_t;
+
+// Pass 1: static storage, sized individually per entry. On this port
+// StackType_t is byte-sized, so the stack column is bytes here too.
+#define TT_STORAGE(id, fn_, name_, stack_, prio_, core_, grp_)  \
+    static StackType_t tt_##id##_stack[stack_];                 \
+    static StaticTask_t tt_##id##_tcb;
+TASK_TABLE(TT_STORAGE)
+
+typedef struct {
+    TaskFunction_t fn;
+    const char *name;
+    uint32_t stack_bytes;
+    UBaseType_t prio;
+    int core;                   // -1 = unpinned
+    tt_group_t group;
+    StackType_t *stack;
+    StaticTask_t *tcb;
+} tt_entry_t;
+
+// Pass 2: the audit point — one row per task, all const.
+static const tt_entry_t task_table[] = {
+#define TT_ENTRY(id, fn_, name_, stack_, prio_, core_, grp_)        \
+    { .fn = fn_, .name = name_, .stack_bytes = stack_,              \
+      .prio = prio_, .core = core_, .group = grp_,                  \
+      .stack = tt_##id##_stack, .tcb = &tt_##id##_tcb },
+    TASK_TABLE(TT_ENTRY)
+#undef TT_ENTRY
+};
+
+#define TT_COUNT (sizeof(task_table) / sizeof(task_table[0]))
+
+static TaskHandle_t tt_handles[TT_COUNT];
+
+// Names are interned at start time; every later find-by-name compares
+// these small ids instead of running strcmp down the table.
+static int tt_name_ids[TT_COUNT];
+
+// Start every entry in a group. Static creation cannot fail for lack of
+// heap; a NULL here means a bad table entry, which is a build bug.
+static void task_table_start(tt_group_t group)
+{
+    static bool ids_primed = false;
+    if (!ids_primed) {
+        for (size_t i = 0; i < TT_COUNT; i++) tt_name_ids[i] = INTERN_INVALID;
+        ids_primed = true;
+    }
+
+    uint32_t started = 0, stack_bytes = 0;
+    for (size_t i = 0; i < TT_COUNT; i++) {
+        const tt_entry_t *e = &task_table[i];
+        if (e->group != group) continue;
+        tt_name_ids[i] = intern_get(e->name);
+        tt_handles[i] = xTaskCreateStaticPinnedToCore(
+            e->fn, e->name, e->stack_bytes, NULL, e->prio,
+            e->stack, e->tcb,
+            e->core < 0 ? tskNO_AFFINITY : e->core);
+        if (tt_handles[i] == NULL) {
+            ESP_LOGE(TAG, "Task table entry '%s' failed to start", e->name);
+            continue;
+        }
+        started++;
+        stack_bytes += e->stack_bytes;
+    }
+    ESP_LOGI(TAG, "Task table group %d: %lu tasks, %lu B static stack, 0 B heap",
+             group, started, stack_bytes);
+}
+
+static TaskHandle_t task_table_handle_by_id(int name_id)
+{
+    if (name_id == INTERN_INVALID) return NULL;
+    for (size_t i = 0; i < TT_COUNT; i++) {
+        if (tt_name_ids[i] == name_id) return tt_handles[i];
+    }
+    return NULL;
+}
+
+// String entry point kept for one-shot callers: the name resolves to
+// its id once, then the scan is integer compares all the way down.
+static TaskHandle_t task_table_handle(const char *name)
+{
+    return task_table_handle_by_id(intern_find(name));
+}
+
 void app_main(void)
 {
     ESP_LOGI(TAG, "=== ESP32 FreeRTOS SMP Demo ===");
 
-    // Task distribution demo
-    xTaskCreate(core_info_task, "TaskA", 4096, NULL, 5, NULL);
-    xTaskCreate(core_info_task, "TaskB", 4096, NULL, 5, NULL);
+    // Task distribution demo — created from the declarative table.
+    task_table_start(TT_BOOT);
 
     // Hardware Integration Example
     hardware_integration_example();
 
+    // Core-pinned pipeline demo
+    start_pipeline_mode();
+
+    // EDF control-loop executive
+    start_edf_mode();
+
     // Sensor Manager Component
     if (sensor_manager_init() == ESP_OK)
     {
         sensor_manager_start();
+
+        // Queue must exist before the table brings up its consumers.
+        actuation_queue = xQueueCreate(8, sizeof(actuation_event_t));
+        task_table_start(TT_SENSOR);
+        sensor_manager_start_batch_dual(task_table_handle("BatchCtrl"),
+                                        task_table_handle("BatchProc"));
+
+        // Multi-sensor plugin demo: 16 drivers, one scheduler task.
+        start_plugin_mode();
     }
 
+    intern_report();
     ESP_LOGI(TAG, "System running. Observe logs.");
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "perf_bench.h"
+#include "arena_allocator.h"
+
+static const char *TAG = "PERF_SUITE";
+
+// ===== Unified perf suite =====
+// Running the recurring perf checks used to mean flashing nine lab
+// binaries one after another. This target packs the benchmark modes
+// into one image behind a console menu: queue paths, allocators,
+// timekeeping, sync primitives, memory hierarchy. Every measurement
+// goes through perf_bench, so each run emits the same PBCSV lines the
+// nightly grep already tracks — one flash, one run, one comparable
+// report per firmware revision. SUITE,begin/end markers bracket each
+// mode so a collector can attribute the records without parsing the
+// menu chatter.
+
+// ===== Queue benchmarks =====
+static QueueHandle_t bench_q;
+static TaskHandle_t echo_handle, pinger_handle;
+
+static void bench_queue_sendrecv(void *arg) {
+    uint32_t v = 42, out;
+    xQueueSend(bench_q, &v, 0);
+    xQueueReceive(bench_q, &out, 0);
+}
+
+// Echo partner for the notification round trip; one priority above the
+// menu task so the give immediately switches in.
+static void notify_echo_task(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xTaskNotifyGive(pinger_handle);
+    }
+}
+
+static void bench_notify_roundtrip(void *arg) {
+    xTaskNotifyGive(echo_handle);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+static void suite_queue(void) {
+    ESP_LOGI(TAG, "SUITE,begin,queue");
+    pb_run("queue_send_recv", bench_queue_sendrecv, NULL, 100, 400);
+    pb_run("notify_roundtrip", bench_notify_roundtrip, NULL, 100, 400);
+    ESP_LOGI(TAG, "SUITE,end,queue");
+}
+
+// ===== Allocator benchmarks =====
+#define ALLOC_BENCH_SIZE  64
+#define ARENA_BENCH_CAP   (ALLOC_BENCH_SIZE * 256)
+
+static arena_t bench_arena;
+static int arena_bench_count;
+
+static void bench_heap_pair(void *arg) {
+    void *p = heap_caps_malloc(ALLOC_BENCH_SIZE, MALLOC_CAP_INTERNAL);
+    heap_caps_free(p);
+}
+
+static void bench_arena_bump(void *arg) {
+    // Reset once the arena fills; the reset lands in one sample out of
+    // ~200 and the trimmer drops it.
+    if (++arena_bench_count >= 200) {
+        arena_reset(&bench_arena);
+        arena_bench_count = 0;
+    }
+    (void)arena_alloc(&bench_arena, ALLOC_BENCH_SIZE);
+}
+
+static void suite_alloc(void) {
+    ESP_LOGI(TAG, "SUITE,begin,alloc");
+    pb_run("heap_malloc_free_64", bench_heap_pair, NULL, 100, 400);
+    arena_bench_count = 0;
+    arena_reset(&bench_arena);
+    pb_run("arena_bump_64", bench_arena_bump, NULL, 100, 400);
+    ESP_LOGI(TAG, "SUITE,end,alloc");
+}
+
+// ===== Timekeeping benchmarks =====
+static void bench_esp_timer_read(void *arg) { (void)esp_timer_get_time(); }
+static void bench_cycle_read(void *arg)     { (void)pb_cycles_now(); }
+static void bench_tick_read(void *arg)      { (void)xTaskGetTickCount(); }
+
+static void suite_timer(void) {
+    ESP_LOGI(TAG, "SUITE,begin,timer");
+    pb_run("esp_timer_read", bench_esp_timer_read, NULL, 100, 400);
+    pb_run("cycle_counter_read", bench_cycle_read, NULL, 100, 400);
+    pb_run("tick_count_read", bench_tick_read, NULL, 100, 400);
+    ESP_LOGI(TAG, "SUITE,end,timer");
+}
+
+// ===== Sync primitive benchmarks =====
+// All uncontended: the number that matters for a fast path is what a
+// take/give pair costs when nobody is waiting.
+static SemaphoreHandle_t bench_mutex, bench_sem;
+static portMUX_TYPE bench_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void bench_mutex_pair(void *arg) {
+    xSemaphoreTake(bench_mutex, portMAX_DELAY);
+    xSemaphoreGive(bench_mutex);
+}
+
+static void bench_sem_pair(void *arg) {
+    xSemaphoreGive(bench_sem);
+    xSemaphoreTake(bench_sem, 0);
+}
+
+static void bench_critical_pair(void *arg) {
+    portENTER_CRITICAL(&bench_mux);
+    portEXIT_CRITICAL(&bench_mux);
+}
+
+// Futex-style fast path (lab2's fast mutex, uncontended leg only): a
+// CAS acquires, an exchange releases, the kernel is never entered.
+// Comparing this against mutex_take_give is the whole argument for it.
+static atomic_int bench_futex_state;
+
+static void bench_futex_pair(void *arg) {
+    int expected = 0;
+    atomic_compare_exchange_strong_explicit(&bench_futex_state, &expected, 1,
+                                            memory_order_acquire,
+                                            memory_order_relaxed);
+    atomic_exchange_explicit(&bench_futex_state, 0, memory_order_release);
+}
+
+static void suite_sync(void) {
+    ESP_LOGI(TAG, "SUITE,begin,sync");
+    pb_run("mutex_take_give", bench_mutex_pair, NULL, 100, 400);
+    pb_run("binsem_give_take", bench_sem_pair, NULL, 100, 400);
+    pb_run("critical_enter_exit", bench_critical_pair, NULL, 100, 400);
+    pb_run("futex_lock_unlock", bench_futex_pair, NULL, 100, 400);
+    ESP_LOGI(TAG, "SUITE,end,sync");
+}
+
+// ===== Memory hierarchy benchmarks =====
+// One full pass over a 32 KB internal buffer per sample: sequential
+// walk vs. LCG-scattered loads. The gap between the two is the cache
+// line working for you (or not).
+#define MEMB_WORDS (32 * 1024 / sizeof(uint32_t))
+
+static uint32_t *memb;
+static volatile uint32_t memb_sink;
+
+static void bench_seq_scan(void *arg) {
+    uint32_t acc = 0;
+    for (size_t i = 0; i < MEMB_WORDS; i++) acc += memb[i];
+    memb_sink = acc;
+}
+
+static void bench_rnd_scan(void *arg) {
+    uint32_t acc = 0, idx = 12345;
+    for (size_t i = 0; i < MEMB_WORDS; i++) {
+        idx = idx * 1664525 + 1013904223;           // LCG walk
+        acc += memb[idx % MEMB_WORDS];
+    }
+    memb_sink = acc;
+}
+
+static void suite_mem(void) {
+    ESP_LOGI(TAG, "SUITE,begin,mem");
+    pb_run("seq_scan_32k", bench_seq_scan, NULL, 4, 64);
+    pb_run("rnd_scan_32k", bench_rnd_scan, NULL, 4, 64);
+    ESP_LOGI(TAG, "SUITE,end,mem");
+}
+
+// ===== Console menu =====
+static void print_menu(void) {
+    ESP_LOGI(TAG, "\n═══ PERF SUITE ═══");
+    ESP_LOGI(TAG, "  1 - queue paths (queue vs notification)");
+    ESP_LOGI(TAG, "  2 - allocators (heap vs arena)");
+    ESP_LOGI(TAG, "  3 - timekeeping reads");
+    ESP_LOGI(TAG, "  4 - sync primitives (uncontended)");
+    ESP_LOGI(TAG, "  5 - memory hierarchy (seq vs random scan)");
+    ESP_LOGI(TAG, "  a - run everything");
+    ESP_LOGI(TAG, "  ? - this menu");
+    ESP_LOGI(TAG, "══════════════════");
+}
+
+static void suite_all(void) {
+    suite_queue();
+    suite_alloc();
+    suite_timer();
+    suite_sync();
+    suite_mem();
+    ESP_LOGI(TAG, "✅ Full suite complete");
+}
+
+void app_main(void) {
+    ESP_LOGI(TAG, "🚀 Perf Suite Starting...");
+    // Revision line first, so every PBCSV record below it is
+    // attributable to exactly one firmware build.
+    ESP_LOGI(TAG, "SUITE,rev,%s,%s %s", esp_get_idf_version(), __DATE__, __TIME__);
+
+    bench_q = xQueueCreate(8, sizeof(uint32_t));
+    bench_mutex = xSemaphoreCreateMutex();
+    bench_sem = xSemaphoreCreateBinary();
+    memb = heap_caps_malloc(MEMB_WORDS * sizeof(uint32_t), MALLOC_CAP_INTERNAL);
+    if (!bench_q || !bench_mutex || !bench_sem || !memb ||
+        arena_init(&bench_arena, ARENA_BENCH_CAP, MALLOC_CAP_INTERNAL) != ESP_OK) {
+        ESP_LOGE(TAG, "Benchmark fixture setup failed");
+        return;
+    }
+    for (size_t i = 0; i < MEMB_WORDS; i++) memb[i] = esp_random();
+
+    pinger_handle = xTaskGetCurrentTaskHandle();
+    xTaskCreate(notify_echo_task, "NotifyEcho", 2048, NULL,
+                uxTaskPriorityGet(NULL) + 1, &echo_handle);
+
+    print_menu();
+    while (1) {
+        int c = getchar();
+        if (c == EOF) {
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+        switch (c) {
+            case '1': suite_queue(); break;
+            case '2': suite_alloc(); break;
+            case '3': suite_timer(); break;
+            case '4': suite_sync(); break;
+            case '5': suite_mem(); break;
+            case 'a': suite_all(); break;
+            case '?': print_menu(); break;
+            case '\n': case '\r': break;
+            default:
+                ESP_LOGW(TAG, "Unknown option '%c'", c);
+                print_menu();
+                break;
+        }
+    }
+}